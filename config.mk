@@ -32,4 +32,14 @@ CFLAGS += -nostdlib
 CFLAGS += -fdata-sections
 CFLAGS += -ffunction-sections
 
+# Panels as aligned XRGB words instead of packed RGB, see color.h
+#CFLAGS += -DCOLOR_XRGB
+
+# USB audio sink next to the virtual COM port, feeds the audio animation
+#CFLAGS += -DUSB_AUDIO_SINK
+
+# Frame sequence animation from the FAT volume, needs a disk driver in
+# lib/fat_fs/src/diskio.c, which only reports that there is no drive yet
+#CFLAGS += -DWS2812_ANIM_SEQ
+
 CPPFLAGS = $(CFLAGS) -lgcc
@@ -1,6 +1,8 @@
 #ifndef INIT_H_
 #define INIT_H_
 
+#include <stdint.h>
+
 
 
 
@@ -12,6 +14,9 @@
 /* initialize usb */
 void init();
 
+/* get a seed from the hardware random generator */
+uint32_t init_random_seed(void);
+
 
 
 
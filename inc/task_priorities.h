@@ -21,6 +21,8 @@
 
 #define LED_TASK_PRIORITY               (3)
 
+#define WS2812_SEQ_TASK_PRIORITY        (1)
+
 
 
 #endif /* TASK_PRIORITIES_H_ */
@@ -0,0 +1,25 @@
+#ifndef USBD_COMPOSITE_H_
+#define USBD_COMPOSITE_H_
+
+#include "usbd_ioreq.h"
+
+
+/*  CDC virtual COM port and audio sink on one device
+
+    Built with USB_AUDIO_SINK, see config.mk. The CDC function keeps the
+    interfaces 0 and 1, the audio function gets the interfaces 2 (control)
+    and 3 (streaming) and the isochronous OUT endpoint AUDIO_OUT_EP. Both
+    functions are grouped by interface association descriptors, the device
+    descriptor announces them with class 0xEF.
+
+    The audio packets are fed to ws2812_audio_feed() when they arrive.
+*/
+
+
+/*! Class callbacks of the composite device */
+extern USBD_Class_cb_TypeDef USBD_COMPOSITE_cb;
+
+
+#endif /* USBD_COMPOSITE_H_ */
+
+/* eof */
@@ -27,7 +27,11 @@
   * @{
   */ 
 #define USBD_CFG_MAX_NUM                1
+#ifdef USB_AUDIO_SINK
+#define USBD_ITF_MAX_NUM                3     /* CDC 0 and 1, audio 2 and 3, see usbd_composite.h */
+#else
 #define USBD_ITF_MAX_NUM                1
+#endif /* USB_AUDIO_SINK */
 #define USB_MAX_STR_DESC_SIZ            50 
 
 /** @defgroup USB_VCP_Class_Layer_Parameter
@@ -55,6 +59,12 @@
 #endif /* USE_USB_OTG_HS */
 
 #define APP_FOPS                        VCP_fops
+
+/* Audio sink, only used with USB_AUDIO_SINK */
+#define USBD_AUDIO_FREQ                 48000 /* Sample rate, the analysis of ws2812_audio.h expects 48 kHz */
+#define DEFAULT_VOLUME                  70    /* Volume in % at start, not used */
+#define AUDIO_TOTAL_IF_NUM              0x02  /* Alternate settings of the streaming interface */
+#define AUDIO_OUT_EP                    0x03  /* EP3 for audio OUT */
 /**
   * @}
   */ 
@@ -2,8 +2,33 @@
 #define COLOR_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>     // size_t
+#include <string.h>     // memcpy
 
 
+#if defined(COLOR_XRGB)
+
+/*! This structure defines an RGB color, 8bit per color
+
+    XRGB layout, selected by COLOR_XRGB in config.mk: every color is an
+    aligned word 0x00RRGGBB on the little endian core, so kernels load,
+    store and compare a led with one instruction. It costs a byte per led.
+    The filler byte has no meaning, color_word() masks it.
+*/
+typedef struct __attribute__((aligned(4))) {
+    /*! Blue part of the color */
+    uint8_t B;
+    /*! Green part of the color */
+    uint8_t G;
+    /*! Red part of the color */
+    uint8_t R;
+    /*! Unused */
+    uint8_t X;
+} color;
+
+#else /* COLOR_XRGB */
+
 /*! This structure defines an RGB color, 8bit per color */
 typedef struct {
     /*! Red part of the color */
@@ -14,45 +39,151 @@ typedef struct {
     uint8_t B;
 } color;
 
+#endif /* COLOR_XRGB */
 
-/*! This structure defines an RGB color in float per color */
+
+/*! This structure defines an RGB color in fixed point 8.8 per color
+
+    0xFF00 is full intensity, so (c << 8) is the same color as the 8 bit c.
+    It is the working format to blend colors without rounding each step.
+*/
 typedef struct {
     /*! Red part of the color */
-    float R;
+    uint16_t R;
     /*! Green part of the color */
-    float G;
+    uint16_t G;
     /*! Blue part of the color */
-    float B;
-} color_f;
+    uint16_t B;
+} color16;
+
+
+
+
+/*! Get a color as 0x00RRGGBB
+
+    One load in the XRGB layout.
+*/
+static inline uint32_t color_word(const color * inColor) {
+
+#if defined(COLOR_XRGB)
+    uint32_t lWord;
+
+    memcpy(&lWord, inColor, sizeof(lWord));
+
+    return lWord & 0x00FFFFFFu;
+#else
+    return ((uint32_t)inColor->R << 16) | ((uint32_t)inColor->G << 8) | inColor->B;
+#endif
+}
+
+
+/*! Set a color from 0x00RRGGBB
 
+    One store in the XRGB layout.
+*/
+static inline void color_set_word(color * outColor, uint32_t inWord) {
 
+#if defined(COLOR_XRGB)
+    memcpy(outColor, &inWord, sizeof(inWord));
+#else
+    outColor->R = (uint8_t)(inWord >> 16);
+    outColor->G = (uint8_t)(inWord >> 8);
+    outColor->B = (uint8_t)inWord;
+#endif
+}
 
 
-static inline float uint8_to_float(uint8_t inColor) {
+/*! Check if two colors are the same */
+static inline bool color_equal(const color * inFirst, const color * inSecond) {
 
-    return inColor * 1.0f / 255.0f;
+    return color_word(inFirst) == color_word(inSecond);
 }
 
 
-static inline uint8_t float_to_uint8(float inColor) {
+static inline void color_to_color16(color16 * outColor, const color * inColor) {
 
-    return (uint8_t)((inColor * 255.0f) + 0.5f);
+    outColor->R = (uint16_t)(inColor->R << 8);
+    outColor->G = (uint16_t)(inColor->G << 8);
+    outColor->B = (uint16_t)(inColor->B << 8);
 }
 
 
-static inline void color_to_color_f(color_f * outColor, color * inColor) {
 
-    outColor->R = uint8_to_float(inColor->R);
-    outColor->G = uint8_to_float(inColor->G);
-    outColor->B = uint8_to_float(inColor->B);
+
+/*! Linear interpolation between two colors
+
+    \param[out] outColor    Interpolated color
+    \param[in]  inFrom      Color at amount 0
+    \param[in]  inTo        Color at amount 255
+    \param[in]  inAmount    Amount of inTo (0 - 255)
+*/
+static inline void color_lerp(color * outColor, const color * inFrom, const color * inTo, uint8_t inAmount) {
+
+    /* scale amount to 0 - 256 */
+    uint32_t lWeight  = inAmount + (inAmount >> 7);
+    uint32_t lInverse = 256 - lWeight;
+
+#if defined(COLOR_XRGB)
+    uint32_t lFrom = color_word(inFrom);
+    uint32_t lTo   = color_word(inTo);
+
+    /* red and blue in one word, each lane stays below 0xFF00 * 256 */
+    uint32_t lRedBlue = ((lFrom & 0x00FF00FFu) * lInverse + (lTo & 0x00FF00FFu) * lWeight) >> 8;
+    uint32_t lGreen   = ((lFrom & 0x0000FF00u) * lInverse + (lTo & 0x0000FF00u) * lWeight) >> 8;
+
+    color_set_word(outColor, (lRedBlue & 0x00FF00FFu) | (lGreen & 0x0000FF00u));
+#else
+    outColor->R = (uint8_t)((inFrom->R * lInverse + inTo->R * lWeight) >> 8);
+    outColor->G = (uint8_t)((inFrom->G * lInverse + inTo->G * lWeight) >> 8);
+    outColor->B = (uint8_t)((inFrom->B * lInverse + inTo->B * lWeight) >> 8);
+#endif
 }
 
 
-static inline void color_f_to_color(color * outColor, color_f * inColor) {
+/*! Fill colors with one color
+
+    \param[out] outColors   Colors to set
+    \param[in]  inCount     Number of colors
+    \param[in]  inColor     Color to set
+*/
+void color_fill(color * outColors, size_t inCount, const color * inColor);
+
+
+/*! Blend two rows of colors, see color_lerp()
+
+    \param[out] outColors   Blended colors, may be one of the inputs
+    \param[in]  inFrom      Colors at amount 0
+    \param[in]  inTo        Colors at amount 255
+    \param[in]  inCount     Number of colors
+    \param[in]  inAmount    Amount of inTo (0 - 255)
+*/
+void color_blend(color * outColors, const color * inFrom, const color * inTo, size_t inCount, uint8_t inAmount);
+
+
+/*! Convert packed RGB bytes, e.g. from a file, to colors
+
+    \param[out] outColors   Colors
+    \param[in]  inRgb       3 * inCount bytes, red first
+    \param[in]  inCount     Number of colors
+*/
+void color_unpack(color * outColors, const uint8_t * inRgb, size_t inCount);
+
+
+/*! Linear interpolation between two 16 bit colors
+
+    \param[out] outColor    Interpolated color
+    \param[in]  inFrom      Color at amount 0
+    \param[in]  inTo        Color at amount 65536
+    \param[in]  inAmount    Amount of inTo (0 - 65536)
+*/
+static inline void color16_lerp(color16 * outColor, const color16 * inFrom, const color16 * inTo, uint32_t inAmount) {
+
+    /* 0xFF00 * 65536 plus rounding still fits into 32 bit */
+    uint32_t lInverse = 65536 - inAmount;
 
-    outColor->R = float_to_uint8(inColor->R);
-    outColor->G = float_to_uint8(inColor->G);
-    outColor->B = float_to_uint8(inColor->B);
+    outColor->R = (uint16_t)((inFrom->R * lInverse + inTo->R * inAmount + 0x8000) >> 16);
+    outColor->G = (uint16_t)((inFrom->G * lInverse + inTo->G * inAmount + 0x8000) >> 16);
+    outColor->B = (uint16_t)((inFrom->B * lInverse + inTo->B * inAmount + 0x8000) >> 16);
 }
 
 
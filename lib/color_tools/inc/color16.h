@@ -0,0 +1,77 @@
+#ifndef COLOR16_H_
+#define COLOR16_H_
+
+#include <stdint.h>
+#include <stddef.h>     // size_t
+
+#include "color.h"
+
+
+/*! Thresholds of color16_quantize() which round to the nearest color */
+#define COLOR16_ROUND       (0x80808080u)
+
+
+/*! Convert a row of colors to 16 bit
+
+    \param[out] outColors   16 bit colors
+    \param[in]  inColors    8 bit colors
+    \param[in]  inCount     Number of colors
+*/
+void color16_expand(color16 * outColors, const color * inColors, size_t inCount);
+
+
+/*! Blend two rows of 16 bit colors, see color16_lerp()
+
+    \param[out] outColors   Blended colors, may be one of the inputs
+    \param[in]  inFrom      Colors at amount 0
+    \param[in]  inTo        Colors at amount 65536
+    \param[in]  inCount     Number of colors
+    \param[in]  inAmount    Amount of inTo (0 - 65536)
+*/
+void color16_blend(color16 * outColors, const color16 * inFrom, const color16 * inTo, size_t inCount, uint32_t inAmount);
+
+
+/*! Blend two rows of 8 bit colors into 16 bit
+
+    The result keeps the fraction color_lerp() drops.
+
+    \param[out] outColors   Blended colors
+    \param[in]  inFrom      Colors at amount 0
+    \param[in]  inTo        Colors at amount 65536
+    \param[in]  inCount     Number of colors
+    \param[in]  inAmount    Amount of inTo (0 - 65536)
+*/
+void color16_blend8(color16 * outColors, const color * inFrom, const color * inTo, size_t inCount, uint32_t inAmount);
+
+
+/*! Get the ordered dither thresholds of a row
+
+    The thresholds come from a 4x4 Bayer matrix. The frame moves the matrix
+    down by one row, so every led cycles through four thresholds and a
+    fraction shows as the average over four frames.
+
+    \param[in]  inRow       Row of the panel
+    \param[in]  inFrame     Frame counter
+
+    \return four thresholds for color16_quantize()
+*/
+uint32_t color16_dither_thresholds(uint32_t inRow, uint32_t inFrame);
+
+
+/*! Convert a row of 16 bit colors to 8 bit
+
+    A color is rounded up if its fraction plus the threshold of its column
+    overflows. The threshold of column n is byte (n % 4) of inThresholds.
+
+    \param[out] outColors   8 bit colors
+    \param[in]  inColors    16 bit colors
+    \param[in]  inCount     Number of colors
+    \param[in]  inThresholds COLOR16_ROUND or color16_dither_thresholds()
+*/
+void color16_quantize(color * outColors, const color16 * inColors, size_t inCount, uint32_t inThresholds);
+
+
+
+#endif /* COLOR16_H_ */
+
+/* eof */
@@ -0,0 +1,87 @@
+#ifndef COLOR_HSV_H_
+#define COLOR_HSV_H_
+
+#include <stdint.h>
+#include <stddef.h>     // size_t
+
+#include "color.h"
+
+
+/*! This structure defines a color by hue, saturation and value, 8bit each */
+typedef struct {
+    /*! Hue, 256 is a full circle starting at red */
+    uint8_t H;
+    /*! Saturation, 0 is white */
+    uint8_t S;
+    /*! Value, 0 is black */
+    uint8_t V;
+} color_hsv;
+
+
+/*! Convert to RGB with the hue split into six equal sections
+
+    This is the classic HSV model, yellow, cyan and magenta take up only
+    a narrow band of the hue.
+
+    \param[out] outColor    RGB color
+    \param[in]  inColor     HSV color
+*/
+void color_hsv_to_rgb_spectrum(color * outColor, const color_hsv * inColor);
+
+
+/*! Convert to RGB with the hue split into eight sections
+
+    The sections red, orange, yellow, green, aqua, blue, purple and pink
+    get the same share of the hue, which looks more even on leds.
+
+    \param[out] outColor    RGB color
+    \param[in]  inColor     HSV color
+*/
+void color_hsv_to_rgb_rainbow(color * outColor, const color_hsv * inColor);
+
+
+/*! Convert to HSV, the inverse of color_hsv_to_rgb_spectrum()
+
+    \param[out] outColor    HSV color, hue and saturation are 0 for grey
+    \param[in]  inColor     RGB color
+*/
+void color_rgb_to_hsv(color_hsv * outColor, const color * inColor);
+
+
+/*! Fill a row with a rainbow
+
+    \param[out] outColors   Colors
+    \param[in]  inCount     Number of colors
+    \param[in]  inHue       Hue of the first color, fixed point 8.8
+    \param[in]  inStep      Hue change from one color to the next, fixed point 8.8
+    \param[in]  inSaturation Saturation of all colors
+    \param[in]  inValue     Value of all colors
+*/
+void color_hsv_fill_rainbow(color * outColors, size_t inCount, uint16_t inHue, int16_t inStep,
+                            uint8_t inSaturation, uint8_t inValue);
+
+
+/*! Convert a row of HSV colors to RGB with color_hsv_to_rgb_rainbow()
+
+    \param[out] outColors   RGB colors
+    \param[in]  inColors    HSV colors
+    \param[in]  inCount     Number of colors
+*/
+void color_hsv_to_rgb_rainbow_n(color * outColors, const color_hsv * inColors, size_t inCount);
+
+
+/*! Shift the hue of a row of colors
+
+    The colors keep their saturation and value.
+
+    \param[in,out] pColors  Colors
+    \param[in]  inCount     Number of colors
+    \param[in]  inShift     Hue to add, 256 is a full circle
+*/
+void color_hue_shift(color * pColors, size_t inCount, uint8_t inShift);
+
+
+
+#endif /* COLOR_HSV_H_ */
+
+/* eof */
@@ -47,6 +47,25 @@ void color_palette_get(const ts_color_palette_16 * const inPalette, color * outC
 void color_palette_get_e(const te_color_palettes inPalette, color * outColor, uint8_t inIndex);
 
 
+/*! Get a palette identified by an enum
+
+    \param[in]  inPalette   Color palette to get
+
+    \return the palette, rainbow if inPalette is unknown
+*/
+const ts_color_palette_16 * color_palette_from_enum(const te_color_palettes inPalette);
+
+
+/*! Blend two palettes entry by entry
+
+    \param[out] outPalette  Blended palette
+    \param[in]  inFrom      Palette at amount 0
+    \param[in]  inTo        Palette at amount 255
+    \param[in]  inAmount    Amount of inTo (0 - 255)
+*/
+void color_palette_blend(ts_color_palette_16 * outPalette, const ts_color_palette_16 * inFrom, const ts_color_palette_16 * inTo, uint8_t inAmount);
+
+
 /*! Rainbow */
 extern const ts_color_palette_16 color_palette_rainbow;
 
@@ -0,0 +1,63 @@
+#include "color.h"
+
+
+void color_fill(color * outColors, size_t inCount, const color * inColor) {
+
+    size_t lCount;
+
+#if defined(COLOR_XRGB)
+    uint32_t lWord = color_word(inColor);
+
+    for(lCount = 0; lCount < inCount; lCount++) {
+        color_set_word(&outColors[lCount], lWord);
+    }
+#else
+    for(lCount = 0; lCount < inCount; lCount++) {
+        outColors[lCount] = *inColor;
+    }
+#endif
+}
+
+
+void color_blend(color * outColors, const color * inFrom, const color * inTo, size_t inCount, uint8_t inAmount) {
+
+    size_t lCount;
+
+#if defined(COLOR_XRGB)
+    /* as color_lerp(), with the weights kept over the row */
+    uint32_t lWeight  = inAmount + (inAmount >> 7);
+    uint32_t lInverse = 256 - lWeight;
+
+    for(lCount = 0; lCount < inCount; lCount++) {
+
+        uint32_t lFrom = color_word(&inFrom[lCount]);
+        uint32_t lTo   = color_word(&inTo[lCount]);
+
+        uint32_t lRedBlue = ((lFrom & 0x00FF00FFu) * lInverse + (lTo & 0x00FF00FFu) * lWeight) >> 8;
+        uint32_t lGreen   = ((lFrom & 0x0000FF00u) * lInverse + (lTo & 0x0000FF00u) * lWeight) >> 8;
+
+        color_set_word(&outColors[lCount], (lRedBlue & 0x00FF00FFu) | (lGreen & 0x0000FF00u));
+    }
+#else
+    for(lCount = 0; lCount < inCount; lCount++) {
+        color_lerp(&outColors[lCount], &inFrom[lCount], &inTo[lCount], inAmount);
+    }
+#endif
+}
+
+
+void color_unpack(color * outColors, const uint8_t * inRgb, size_t inCount) {
+
+#if defined(COLOR_XRGB)
+    size_t lCount;
+
+    for(lCount = 0; lCount < inCount; lCount++, inRgb += 3) {
+        color_set_word(&outColors[lCount], ((uint32_t)inRgb[0] << 16) | ((uint32_t)inRgb[1] << 8) | inRgb[2]);
+    }
+#else
+    memcpy(outColors, inRgb, inCount * sizeof(color));
+#endif
+}
+
+
+/* eof */
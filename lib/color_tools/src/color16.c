@@ -0,0 +1,73 @@
+#include "color16.h"
+
+
+/*! 4x4 Bayer matrix, thresholds in the middle of their 1/16, column 0 in the low byte */
+static const uint32_t sDitherRows[4] = {
+    0xA8288808u,    /*  0  8  2 10 */
+    0x68E848C8u,    /* 12  4 14  6 */
+    0x9818B838u,    /*  3 11  1  9 */
+    0x58D878F8u,    /* 15  7 13  5 */
+};
+
+
+void color16_expand(color16 * outColors, const color * inColors, size_t inCount) {
+
+    size_t lCount;
+
+    for(lCount = 0; lCount < inCount; lCount++) {
+        color_to_color16(&outColors[lCount], &inColors[lCount]);
+    }
+}
+
+
+void color16_blend(color16 * outColors, const color16 * inFrom, const color16 * inTo, size_t inCount, uint32_t inAmount) {
+
+    size_t lCount;
+
+    for(lCount = 0; lCount < inCount; lCount++) {
+        color16_lerp(&outColors[lCount], &inFrom[lCount], &inTo[lCount], inAmount);
+    }
+}
+
+
+void color16_blend8(color16 * outColors, const color * inFrom, const color * inTo, size_t inCount, uint32_t inAmount) {
+
+    uint32_t lInverse = 65536 - inAmount;
+    size_t lCount;
+
+    /* 255 * 65536 needs 24 bit, the result keeps 8 bit of fraction */
+    for(lCount = 0; lCount < inCount; lCount++) {
+
+        outColors[lCount].R = (uint16_t)((inFrom[lCount].R * lInverse + inTo[lCount].R * inAmount + 0x80) >> 8);
+        outColors[lCount].G = (uint16_t)((inFrom[lCount].G * lInverse + inTo[lCount].G * inAmount + 0x80) >> 8);
+        outColors[lCount].B = (uint16_t)((inFrom[lCount].B * lInverse + inTo[lCount].B * inAmount + 0x80) >> 8);
+    }
+}
+
+
+uint32_t color16_dither_thresholds(uint32_t inRow, uint32_t inFrame) {
+
+    return sDitherRows[(inRow + inFrame) & 3];
+}
+
+
+void color16_quantize(color * outColors, const color16 * inColors, size_t inCount, uint32_t inThresholds) {
+
+    size_t lCount;
+
+    for(lCount = 0; lCount < inCount; lCount++) {
+
+        uint32_t lThreshold = inThresholds & 0xFF;
+
+        /* at most 0xFF00 + 0xFF, so no clamping */
+        color_set_word(&outColors[lCount], (((inColors[lCount].R + lThreshold) & 0xFF00u) << 8) |
+                                           ((inColors[lCount].G + lThreshold) & 0xFF00u) |
+                                           (((inColors[lCount].B + lThreshold) >> 8) & 0xFFu));
+
+        /* next column uses the next byte */
+        inThresholds = (inThresholds >> 8) | (inThresholds << 24);
+    }
+}
+
+
+/* eof */
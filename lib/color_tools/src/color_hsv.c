@@ -0,0 +1,187 @@
+#include "color_hsv.h"
+
+
+/*! Scale a value by inScale / 256, 255 keeps the value */
+static inline uint32_t color_hsv_scale(uint32_t inValue, uint32_t inScale) {
+
+    return (inValue * (inScale + 1)) >> 8;
+}
+
+
+/*! Channel order of each spectrum section
+
+    Index 0 is the value, 1 the rising, 2 the falling and 3 the lowest
+    channel of the section.
+*/
+static const uint8_t sSpectrumOrder[6][3] = {
+    { 0, 1, 3 },    /* red to yellow */
+    { 2, 0, 3 },    /* yellow to green */
+    { 3, 0, 1 },    /* green to cyan */
+    { 3, 2, 0 },    /* cyan to blue */
+    { 1, 3, 0 },    /* blue to magenta */
+    { 0, 3, 2 },    /* magenta to red */
+};
+
+
+void color_hsv_to_rgb_spectrum(color * outColor, const color_hsv * inColor) {
+
+    uint32_t lScaled   = (uint32_t)inColor->H * 6;
+    uint32_t lFraction = lScaled & 0xFF;
+    uint32_t lValue    = inColor->V;
+    uint32_t lSat      = inColor->S;
+    uint8_t  lChannels[4];
+
+    const uint8_t * lOrder = sSpectrumOrder[lScaled >> 8];
+
+    lChannels[0] = (uint8_t)lValue;
+    lChannels[1] = (uint8_t)color_hsv_scale(lValue, 255 - color_hsv_scale(lSat, 255 - lFraction));
+    lChannels[2] = (uint8_t)color_hsv_scale(lValue, 255 - color_hsv_scale(lSat, lFraction));
+    lChannels[3] = (uint8_t)color_hsv_scale(lValue, 255 - lSat);
+
+    /* table lookup instead of a branch per section */
+    outColor->R = lChannels[lOrder[0]];
+    outColor->G = lChannels[lOrder[1]];
+    outColor->B = lChannels[lOrder[2]];
+}
+
+
+void color_hsv_to_rgb_rainbow(color * outColor, const color_hsv * inColor) {
+
+    uint32_t lOffset = (uint32_t)(inColor->H & 0x1F) << 3;
+    uint32_t lThird  = color_hsv_scale(lOffset, 85);
+    uint32_t lTwoThirds = color_hsv_scale(lOffset, 170);
+    uint32_t lDesat;
+    uint32_t lSatScale;
+    uint32_t lR;
+    uint32_t lG;
+    uint32_t lB;
+
+    switch(inColor->H >> 5) {
+        case 0:     /* red to orange */
+            lR = 255 - lThird;      lG = lThird;                lB = 0;
+            break;
+        case 1:     /* orange to yellow */
+            lR = 171;               lG = 85 + lThird;           lB = 0;
+            break;
+        case 2:     /* yellow to green */
+            lR = 171 - lTwoThirds;  lG = 170 + lThird;          lB = 0;
+            break;
+        case 3:     /* green to aqua */
+            lR = 0;                 lG = 255 - lOffset;         lB = lOffset;
+            break;
+        case 4:     /* aqua to blue */
+            lR = 0;                 lG = 171 - lTwoThirds;      lB = 85 + lTwoThirds;
+            break;
+        case 5:     /* blue to purple */
+            lR = lThird;            lG = 0;                     lB = 255 - lThird;
+            break;
+        case 6:     /* purple to pink */
+            lR = 85 + lThird;       lG = 0;                     lB = 171 - lThird;
+            break;
+        default:    /* pink to red */
+            lR = 170 + lThird;      lG = 0;                     lB = 85 - lThird;
+            break;
+    }
+
+    /* mix in white, the square makes low saturations less washed out */
+    lDesat    = 255 - inColor->S;
+    lDesat    = color_hsv_scale(lDesat, lDesat);
+    lSatScale = 255 - lDesat;
+
+    lR = color_hsv_scale(lR, lSatScale) + lDesat;
+    lG = color_hsv_scale(lG, lSatScale) + lDesat;
+    lB = color_hsv_scale(lB, lSatScale) + lDesat;
+
+    outColor->R = (uint8_t)color_hsv_scale(lR, inColor->V);
+    outColor->G = (uint8_t)color_hsv_scale(lG, inColor->V);
+    outColor->B = (uint8_t)color_hsv_scale(lB, inColor->V);
+}
+
+
+void color_rgb_to_hsv(color_hsv * outColor, const color * inColor) {
+
+    int32_t lR = inColor->R;
+    int32_t lG = inColor->G;
+    int32_t lB = inColor->B;
+    int32_t lMax = lR;
+    int32_t lMin = lR;
+    int32_t lDelta;
+    int32_t lHue;
+
+    if(lG > lMax) { lMax = lG; }
+    if(lB > lMax) { lMax = lB; }
+    if(lG < lMin) { lMin = lG; }
+    if(lB < lMin) { lMin = lB; }
+
+    lDelta = lMax - lMin;
+
+    outColor->V = (uint8_t)lMax;
+
+    if(lDelta == 0) {
+
+        outColor->H = 0;
+        outColor->S = 0;
+        return;
+    }
+
+    outColor->S = (uint8_t)((lDelta * 255 + (lMax >> 1)) / lMax);
+
+    /* hue in sixths of the circle times delta */
+    if(lMax == lR) {
+        lHue = lG - lB + ((lG < lB)? 6 * lDelta : 0);
+    } else if(lMax == lG) {
+        lHue = lB - lR + 2 * lDelta;
+    } else {
+        lHue = lR - lG + 4 * lDelta;
+    }
+
+    outColor->H = (uint8_t)(((lHue << 8) + 3 * lDelta) / (6 * lDelta));
+}
+
+
+void color_hsv_fill_rainbow(color * outColors, size_t inCount, uint16_t inHue, int16_t inStep,
+                            uint8_t inSaturation, uint8_t inValue) {
+
+    color_hsv lColor;
+    size_t lCount;
+
+    lColor.S = inSaturation;
+    lColor.V = inValue;
+
+    for(lCount = 0; lCount < inCount; lCount++) {
+
+        lColor.H = (uint8_t)(inHue >> 8);
+        color_hsv_to_rgb_rainbow(&outColors[lCount], &lColor);
+
+        inHue = (uint16_t)(inHue + inStep);
+    }
+}
+
+
+void color_hsv_to_rgb_rainbow_n(color * outColors, const color_hsv * inColors, size_t inCount) {
+
+    size_t lCount;
+
+    for(lCount = 0; lCount < inCount; lCount++) {
+        color_hsv_to_rgb_rainbow(&outColors[lCount], &inColors[lCount]);
+    }
+}
+
+
+void color_hue_shift(color * pColors, size_t inCount, uint8_t inShift) {
+
+    color_hsv lColor;
+    size_t lCount;
+
+    for(lCount = 0; lCount < inCount; lCount++) {
+
+        color_rgb_to_hsv(&lColor, &pColors[lCount]);
+
+        lColor.H += inShift;
+
+        color_hsv_to_rgb_spectrum(&pColors[lCount], &lColor);
+    }
+}
+
+
+/* eof */
@@ -1,4 +1,5 @@
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "color.h"
@@ -9,13 +10,13 @@ void color_palette_get(const ts_color_palette_16 * const inPalette, color * outC
 
     uint8_t lIndex  = (inIndex >> 4) & 0x0f;
     uint8_t lIndex2 = (lIndex == 0x0f)? 0 : (lIndex + 1);
-    float lInterpol = (float)(inIndex & 0x0f);
+    uint32_t lInterpol = inIndex & 0x0f;
+    uint32_t lInverse  = 16 - lInterpol;
 
-    lIndex2 = (lIndex == 0x0f)? 0 : (lIndex + 1);
-
-    outColor->R = (uint8_t)((float)inPalette->mColors[lIndex].R * (16.0f - lInterpol) * 1.0f / 16.0f + (float)inPalette->mColors[lIndex2].R * lInterpol * 1.0f / 16.0f + 0.5f);
-    outColor->G = (uint8_t)((float)inPalette->mColors[lIndex].G * (16.0f - lInterpol) * 1.0f / 16.0f + (float)inPalette->mColors[lIndex2].G * lInterpol * 1.0f / 16.0f + 0.5f);
-    outColor->B = (uint8_t)((float)inPalette->mColors[lIndex].B * (16.0f - lInterpol) * 1.0f / 16.0f + (float)inPalette->mColors[lIndex2].B * lInterpol * 1.0f / 16.0f + 0.5f);
+    /* weights in 1/16, rounded */
+    outColor->R = (uint8_t)((inPalette->mColors[lIndex].R * lInverse + inPalette->mColors[lIndex2].R * lInterpol + 8) >> 4);
+    outColor->G = (uint8_t)((inPalette->mColors[lIndex].G * lInverse + inPalette->mColors[lIndex2].G * lInterpol + 8) >> 4);
+    outColor->B = (uint8_t)((inPalette->mColors[lIndex].B * lInverse + inPalette->mColors[lIndex2].B * lInterpol + 8) >> 4);
 }
 
 
@@ -33,6 +34,26 @@ void color_palette_get_e(const te_color_palettes inPalette, color * outColor, ui
 }
 
 
+const ts_color_palette_16 * color_palette_from_enum(const te_color_palettes inPalette) {
+
+    switch(inPalette) {
+        case COLOR_PALETTE_SKY:     return &color_palette_sky;
+        case COLOR_PALETTE_LAVA:    return &color_palette_lava;
+        case COLOR_PALETTE_HEAT:    return &color_palette_heat;
+        case COLOR_PALETTE_OCEAN:   return &color_palette_ocean;
+        case COLOR_PALETTE_FOREST:  return &color_palette_forest;
+        case COLOR_PALETTE_RAINBOW:
+        default:                    return &color_palette_rainbow;
+    }
+}
+
+
+void color_palette_blend(ts_color_palette_16 * outPalette, const ts_color_palette_16 * inFrom, const ts_color_palette_16 * inTo, uint8_t inAmount) {
+
+    color_blend(outPalette->mColors, inFrom->mColors, inTo->mColors, 16, inAmount);
+}
+
+
 const ts_color_palette_16 color_palette_rainbow = {
 
     .mColors = {
@@ -0,0 +1,328 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "color.h"
+#include "color16.h"
+
+/*  Checks the precision of the 16 bit blends and measures them against
+    8 bit and float panels
+
+    Usage: color16_bench [<frames>]
+
+    A slow fade from 12 to 0 over 200 frames is compared with the exact
+    value in 8 bit, rounded 16 bit and dithered 16 bit, where the average
+    of a 4x4 block counts. The end points of a blend have to come back
+    exactly for every threshold. The timing blends and quantises a 5 x 172
+    panel, the time is the best of five runs. Build it with
+    -fno-tree-vectorize, the Cortex-M4 has no SIMD like the host.
+*/
+
+
+/*! Rows of a panel */
+#define ROWS                (5)
+
+/*! Columns of a panel */
+#define COLUMNS             (172)
+
+/*! Leds of a panel */
+#define LEDS                (ROWS * COLUMNS)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+/*! Start value and length of the slow fade */
+#define FADE_FROM           (12)
+#define FADE_FRAMES         (200)
+
+/*! Allowed error of the dithered 4x4 average, 1/16 is the dither step */
+#define DITHER_TOLERANCE    (0.04)
+
+
+/*! A float color, what the former color_f held */
+typedef struct {
+    float R;
+    float G;
+    float B;
+} ts_color_float;
+
+
+static color sFrom[LEDS];
+static color sTo[LEDS];
+static color sOut[LEDS];
+
+static color16 sFrom16[LEDS];
+static color16 sTo16[LEDS];
+static color16 sOut16[LEDS];
+
+static ts_color_float sFromF[LEDS];
+static ts_color_float sToF[LEDS];
+static ts_color_float sOutF[LEDS];
+
+
+static int check_fade(void) {
+
+    color lFrom;
+    color lTo;
+    color lColor;
+    color lBlock[4];
+    color16 lWide;
+    double lExact;
+    double lAverage;
+    double lError8 = 0.0;
+    double lError16 = 0.0;
+    double lErrorDither = 0.0;
+    uint32_t lFrame;
+    uint32_t lRow;
+    uint32_t lColumn;
+    uint32_t lSteps = 0;
+    uint32_t lSum;
+    uint8_t lLast = FADE_FROM;
+
+    memset(&lFrom, 0, sizeof(lFrom));
+    memset(&lTo, 0, sizeof(lTo));
+    lFrom.R = FADE_FROM;
+
+    for(lFrame = 0; lFrame <= FADE_FRAMES; lFrame++) {
+
+        lExact = FADE_FROM * (1.0 - (double)lFrame / FADE_FRAMES);
+
+        /* 8 bit, the amount of the fade transition */
+        color_lerp(&lColor, &lFrom, &lTo, (uint8_t)((lFrame * 255) / FADE_FRAMES));
+        lError8 += fabs(lColor.R - lExact);
+
+        if(lColor.R != lLast) {
+            lSteps++;
+            lLast = lColor.R;
+        }
+
+        /* 16 bit, quantised once */
+        color16_blend8(&lWide, &lFrom, &lTo, 1, (lFrame << 16) / FADE_FRAMES);
+        color16_quantize(&lColor, &lWide, 1, COLOR16_ROUND);
+        lError16 += fabs(lColor.R - lExact);
+
+        /* every led of a 4x4 block shows the same value with its own threshold */
+        lSum = 0;
+
+        for(lRow = 0; lRow < 4; lRow++) {
+
+            color16_quantize(lBlock, (const color16[]){ lWide, lWide, lWide, lWide }, 4,
+                             color16_dither_thresholds(lRow, lFrame));
+
+            for(lColumn = 0; lColumn < 4; lColumn++) {
+                lSum += lBlock[lColumn].R;
+            }
+        }
+
+        lAverage = lSum / 16.0;
+
+        if(fabs(lAverage - lExact) > lErrorDither) {
+            lErrorDither = fabs(lAverage - lExact);
+        }
+    }
+
+    printf("Fade %d to 0 over %d frames\n", FADE_FROM, FADE_FRAMES);
+    printf("  8 bit                 %3u steps, mean error %.2f\n", (unsigned)lSteps, lError8 / (FADE_FRAMES + 1));
+    printf("  16 bit rounded        mean error %.2f\n", lError16 / (FADE_FRAMES + 1));
+    printf("  16 bit dithered 4x4   max error %.3f\n\n", lErrorDither);
+
+    return lErrorDither > DITHER_TOLERANCE || lError16 > lError8;
+}
+
+
+static int check_end_points(void) {
+
+    color lFrom;
+    color lTo;
+    color lColor;
+    color16 lWide;
+    color16 lFrom16;
+    color16 lTo16;
+    uint32_t lValue;
+    uint32_t lThreshold;
+    int lErrors = 0;
+
+    memset(&lFrom, 0, sizeof(lFrom));
+    memset(&lTo, 0, sizeof(lTo));
+
+    for(lValue = 0; lValue < 256; lValue++) {
+
+        lFrom.R = lFrom.G = lFrom.B = (uint8_t)lValue;
+        lTo.R = (uint8_t)(255 - lValue);
+        lTo.G = (uint8_t)(lValue * 7);
+        lTo.B = (uint8_t)(lValue ^ 0x5A);
+
+        color_to_color16(&lFrom16, &lFrom);
+        color_to_color16(&lTo16, &lTo);
+
+        for(lThreshold = 0; lThreshold < 256; lThreshold++) {
+
+            color16_blend8(&lWide, &lFrom, &lTo, 1, 0);
+            color16_quantize(&lColor, &lWide, 1, lThreshold);
+            lErrors += !color_equal(&lColor, &lFrom);
+
+            color16_blend8(&lWide, &lFrom, &lTo, 1, 65536);
+            color16_quantize(&lColor, &lWide, 1, lThreshold);
+            lErrors += !color_equal(&lColor, &lTo);
+
+            color16_blend(&lWide, &lFrom16, &lTo16, 1, 65536);
+            color16_quantize(&lColor, &lWide, 1, lThreshold);
+            lErrors += !color_equal(&lColor, &lTo);
+        }
+    }
+
+    printf("End points of a blend   %s\n\n", lErrors ? "FAIL" : "exact for every threshold");
+
+    return lErrors;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+static void run_blend8(uint32_t inFrame) {
+
+    color_blend(sOut, sFrom, sTo, LEDS, (uint8_t)inFrame);
+}
+
+
+static void run_blend16(uint32_t inFrame) {
+
+    size_t lRow;
+
+    color16_blend(sOut16, sFrom16, sTo16, LEDS, (inFrame & 0xFF) << 8);
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        color16_quantize(&sOut[lRow * COLUMNS], &sOut16[lRow * COLUMNS], COLUMNS, color16_dither_thresholds(lRow, inFrame));
+    }
+}
+
+
+static void run_blend8_to16(uint32_t inFrame) {
+
+    size_t lRow;
+
+    color16_blend8(sOut16, sFrom, sTo, LEDS, (inFrame & 0xFF) << 8);
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        color16_quantize(&sOut[lRow * COLUMNS], &sOut16[lRow * COLUMNS], COLUMNS, color16_dither_thresholds(lRow, inFrame));
+    }
+}
+
+
+static void run_blend_float(uint32_t inFrame) {
+
+    float lAmount = (inFrame & 0xFF) / 256.0f;
+    size_t lCount;
+
+    for(lCount = 0; lCount < LEDS; lCount++) {
+
+        sOutF[lCount].R = sFromF[lCount].R + (sToF[lCount].R - sFromF[lCount].R) * lAmount;
+        sOutF[lCount].G = sFromF[lCount].G + (sToF[lCount].G - sFromF[lCount].G) * lAmount;
+        sOutF[lCount].B = sFromF[lCount].B + (sToF[lCount].B - sFromF[lCount].B) * lAmount;
+    }
+
+    for(lCount = 0; lCount < LEDS; lCount++) {
+
+        sOut[lCount].R = (uint8_t)(sOutF[lCount].R + 0.5f);
+        sOut[lCount].G = (uint8_t)(sOutF[lCount].G + 0.5f);
+        sOut[lCount].B = (uint8_t)(sOutF[lCount].B + 0.5f);
+    }
+}
+
+
+/*! Best time of a blend in ns per panel */
+static double measure(void (* infRun)(uint32_t), uint32_t inFrames) {
+
+    uint32_t lFrame;
+    uint32_t lSum = 0;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        lStart = now();
+
+        for(lFrame = 0; lFrame < inFrames; lFrame++) {
+            infRun(lFrame);
+            lSum += sOut[lFrame % LEDS].G;
+        }
+
+        lTime = (now() - lStart) / inFrames;
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+    }
+
+    /* the panels have to be used */
+    if(lSum == 0xFFFFFFFF) {
+        printf("\n");
+    }
+
+    return lBest;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    uint32_t lFrames = 20000;
+    uint32_t lSeed = 1;
+    size_t lCount;
+    int lErrors = 0;
+
+    if(argc > 1) {
+        lFrames = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lFrames == 0) {
+        printf("Usage: %s [<frames>]\n", argv[0]);
+        return -1;
+    }
+
+    lErrors += check_fade();
+    lErrors += check_end_points();
+
+    for(lCount = 0; lCount < LEDS; lCount++) {
+
+        lSeed = lSeed * 1664525u + 1013904223u;
+        color_set_word(&sFrom[lCount], lSeed >> 8);
+        lSeed = lSeed * 1664525u + 1013904223u;
+        color_set_word(&sTo[lCount], lSeed >> 8);
+
+        color_to_color16(&sFrom16[lCount], &sFrom[lCount]);
+        color_to_color16(&sTo16[lCount], &sTo[lCount]);
+
+        sFromF[lCount].R = sFrom[lCount].R;
+        sFromF[lCount].G = sFrom[lCount].G;
+        sFromF[lCount].B = sFrom[lCount].B;
+        sToF[lCount].R = sTo[lCount].R;
+        sToF[lCount].G = sTo[lCount].G;
+        sToF[lCount].B = sTo[lCount].B;
+    }
+
+    printf("Blend of a %d x %d panel    ns   bytes per panel\n", ROWS, COLUMNS);
+    printf("  8 bit                     %7.0f  %6u\n", measure(run_blend8, lFrames), (unsigned)sizeof(sOut));
+    printf("  16 bit, dithered          %7.0f  %6u\n", measure(run_blend16, lFrames), (unsigned)sizeof(sOut16));
+    printf("  8 bit into 16, dithered   %7.0f  %6u\n", measure(run_blend8_to16, lFrames), (unsigned)sizeof(sOut16));
+    printf("  float, rounded            %7.0f  %6u\n", measure(run_blend_float, lFrames), (unsigned)sizeof(sOutF));
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
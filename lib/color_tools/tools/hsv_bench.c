@@ -0,0 +1,412 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "color.h"
+#include "color_hsv.h"
+
+/*  Checks the integer HSV conversions against float and measures them
+
+    Usage: hsv_bench [<rows>]
+
+    color_hsv_to_rgb_spectrum is compared with the float HSV model for
+    every hue, saturation and value, color_rgb_to_hsv for every RGB color,
+    and a round trip from HSV through RGB for the hue of saturated colors.
+    The row functions have to match their single color versions. The
+    timing converts <rows> rows of 172 colors, the best of five runs, next
+    to the float conversions.
+*/
+
+
+/*! Colors of a row */
+#define COLUMNS             (172)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+/*! Allowed difference of a channel to the float model */
+#define RGB_TOLERANCE       (2)
+
+/*! Allowed difference of a hue to float, ties may round either way */
+#define HUE_TOLERANCE       (1)
+
+
+static color sRow[COLUMNS];
+
+static color_hsv sRowHsv[COLUMNS];
+
+
+/*! Float HSV to RGB, hue in 1/256 of the circle */
+static void hsv_to_rgb_f(color * outColor, float inH, float inS, float inV) {
+
+    float lSection = inH * 6.0f / 256.0f;
+    int lIndex = (int)lSection;
+    float lFraction = lSection - lIndex;
+    float lS = inS / 255.0f;
+    float lP = inV * (1.0f - lS);
+    float lQ = inV * (1.0f - lS * lFraction);
+    float lT = inV * (1.0f - lS * (1.0f - lFraction));
+    float lR;
+    float lG;
+    float lB;
+
+    switch(lIndex % 6) {
+        case 0:  lR = inV; lG = lT;  lB = lP;  break;
+        case 1:  lR = lQ;  lG = inV; lB = lP;  break;
+        case 2:  lR = lP;  lG = inV; lB = lT;  break;
+        case 3:  lR = lP;  lG = lQ;  lB = inV; break;
+        case 4:  lR = lT;  lG = lP;  lB = inV; break;
+        default: lR = inV; lG = lP;  lB = lQ;  break;
+    }
+
+    outColor->R = (uint8_t)lroundf(lR);
+    outColor->G = (uint8_t)lroundf(lG);
+    outColor->B = (uint8_t)lroundf(lB);
+}
+
+
+/*! Float RGB to HSV, hue in 1/256 of the circle */
+static void rgb_to_hsv_f(float * outH, float * outS, float * outV, const color * inColor) {
+
+    float lR = inColor->R;
+    float lG = inColor->G;
+    float lB = inColor->B;
+    float lMax = fmaxf(lR, fmaxf(lG, lB));
+    float lMin = fminf(lR, fminf(lG, lB));
+    float lDelta = lMax - lMin;
+    float lHue;
+
+    *outV = lMax;
+
+    if(lDelta == 0.0f) {
+        *outH = 0.0f;
+        *outS = 0.0f;
+        return;
+    }
+
+    *outS = lDelta * 255.0f / lMax;
+
+    if(lMax == lR) {
+        lHue = (lG - lB) / lDelta;
+    } else if(lMax == lG) {
+        lHue = (lB - lR) / lDelta + 2.0f;
+    } else {
+        lHue = (lR - lG) / lDelta + 4.0f;
+    }
+
+    if(lHue < 0.0f) {
+        lHue += 6.0f;
+    }
+
+    *outH = lHue * 256.0f / 6.0f;
+}
+
+
+/*! Difference of two hues on the circle */
+static int hue_difference(int inA, int inB) {
+
+    int lDiff = abs(inA - inB) & 0xFF;
+
+    return (lDiff > 128)? 256 - lDiff : lDiff;
+}
+
+
+static int channel_difference(const color * inA, const color * inB) {
+
+    int lDiff = abs(inA->R - inB->R);
+
+    if(abs(inA->G - inB->G) > lDiff) {
+        lDiff = abs(inA->G - inB->G);
+    }
+
+    if(abs(inA->B - inB->B) > lDiff) {
+        lDiff = abs(inA->B - inB->B);
+    }
+
+    return lDiff;
+}
+
+
+static int check_spectrum(void) {
+
+    color_hsv lHsv;
+    color lColor;
+    color lReference;
+    uint32_t lCount;
+    int lDiff;
+    int lMax = 0;
+
+    for(lCount = 0; lCount < 1u << 24; lCount++) {
+
+        lHsv.H = (uint8_t)(lCount >> 16);
+        lHsv.S = (uint8_t)(lCount >> 8);
+        lHsv.V = (uint8_t)lCount;
+
+        color_hsv_to_rgb_spectrum(&lColor, &lHsv);
+        hsv_to_rgb_f(&lReference, lHsv.H, lHsv.S, lHsv.V);
+
+        lDiff = channel_difference(&lColor, &lReference);
+
+        if(lDiff > lMax) {
+            lMax = lDiff;
+        }
+    }
+
+    printf("color_hsv_to_rgb_spectrum  every HSV, max difference %d\n", lMax);
+
+    return lMax > RGB_TOLERANCE;
+}
+
+
+static int check_rgb_to_hsv(void) {
+
+    color_hsv lHsv;
+    color lColor;
+    float lH;
+    float lS;
+    float lV;
+    uint32_t lCount;
+    int lMaxH = 0;
+    int lMaxS = 0;
+    int lMaxV = 0;
+    int lMaxTrip = 0;
+    int lDiff;
+
+    memset(&lColor, 0, sizeof(lColor));
+
+    for(lCount = 0; lCount < 1u << 24; lCount++) {
+
+        lColor.R = (uint8_t)(lCount >> 16);
+        lColor.G = (uint8_t)(lCount >> 8);
+        lColor.B = (uint8_t)lCount;
+
+        color_rgb_to_hsv(&lHsv, &lColor);
+        rgb_to_hsv_f(&lH, &lS, &lV, &lColor);
+
+        if(lS > 0.0f) {
+
+            lDiff = hue_difference(lHsv.H, (int)lroundf(lH));
+            lMaxH = (lDiff > lMaxH)? lDiff : lMaxH;
+        }
+
+        lDiff = abs(lHsv.S - (int)lroundf(lS));
+        lMaxS = (lDiff > lMaxS)? lDiff : lMaxS;
+
+        lDiff = abs(lHsv.V - (int)lroundf(lV));
+        lMaxV = (lDiff > lMaxV)? lDiff : lMaxV;
+    }
+
+    /* saturated colors come back with their hue */
+    for(lCount = 0; lCount < 256; lCount++) {
+
+        lHsv.H = (uint8_t)lCount;
+        lHsv.S = 255;
+        lHsv.V = 255;
+
+        color_hsv_to_rgb_spectrum(&lColor, &lHsv);
+        color_rgb_to_hsv(&lHsv, &lColor);
+
+        lDiff = hue_difference(lHsv.H, (int)lCount);
+        lMaxTrip = (lDiff > lMaxTrip)? lDiff : lMaxTrip;
+    }
+
+    printf("color_rgb_to_hsv           every RGB, max difference H %d, S %d, V %d\n", lMaxH, lMaxS, lMaxV);
+    printf("round trip                 every hue, max difference %d\n", lMaxTrip);
+
+    return lMaxH > HUE_TOLERANCE || lMaxS > 1 || lMaxV > 0 || lMaxTrip > HUE_TOLERANCE;
+}
+
+
+static int check_rows(void) {
+
+    color lColor;
+    color_hsv lHsv;
+    uint32_t lCount;
+    uint16_t lHue = 0x1234;
+    int lErrors = 0;
+
+    for(lCount = 0; lCount < COLUMNS; lCount++) {
+
+        sRowHsv[lCount].H = (uint8_t)(lCount * 37);
+        sRowHsv[lCount].S = (uint8_t)(lCount * 11 + 40);
+        sRowHsv[lCount].V = (uint8_t)(255 - lCount);
+    }
+
+    color_hsv_to_rgb_rainbow_n(sRow, sRowHsv, COLUMNS);
+
+    for(lCount = 0; lCount < COLUMNS; lCount++) {
+
+        color_hsv_to_rgb_rainbow(&lColor, &sRowHsv[lCount]);
+        lErrors += (channel_difference(&lColor, &sRow[lCount]) != 0);
+    }
+
+    color_hsv_fill_rainbow(sRow, COLUMNS, lHue, -300, 200, 180);
+
+    for(lCount = 0; lCount < COLUMNS; lCount++, lHue -= 300) {
+
+        lHsv.H = (uint8_t)(lHue >> 8);
+        lHsv.S = 200;
+        lHsv.V = 180;
+
+        color_hsv_to_rgb_rainbow(&lColor, &lHsv);
+        lErrors += (channel_difference(&lColor, &sRow[lCount]) != 0);
+    }
+
+    printf("row functions              %s\n\n", lErrors ? "differ from single colors" : "match single colors");
+
+    return lErrors;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+static void run_spectrum(uint32_t inRow) {
+
+    color_hsv lHsv;
+    size_t lCount;
+
+    lHsv.S = 240;
+    lHsv.V = 200;
+
+    for(lCount = 0; lCount < COLUMNS; lCount++) {
+
+        lHsv.H = (uint8_t)(inRow + lCount);
+        color_hsv_to_rgb_spectrum(&sRow[lCount], &lHsv);
+    }
+}
+
+
+static void run_spectrum_f(uint32_t inRow) {
+
+    size_t lCount;
+
+    for(lCount = 0; lCount < COLUMNS; lCount++) {
+        hsv_to_rgb_f(&sRow[lCount], (float)((inRow + lCount) & 0xFF), 240.0f, 200.0f);
+    }
+}
+
+
+static void run_rainbow(uint32_t inRow) {
+
+    color_hsv_fill_rainbow(sRow, COLUMNS, (uint16_t)(inRow << 8), 380, 240, 200);
+}
+
+
+static void run_rgb_to_hsv(uint32_t inRow) {
+
+    size_t lCount;
+
+    (void)inRow;
+
+    for(lCount = 0; lCount < COLUMNS; lCount++) {
+        color_rgb_to_hsv(&sRowHsv[lCount], &sRow[lCount]);
+    }
+}
+
+
+static void run_hue_shift(uint32_t inRow) {
+
+    (void)inRow;
+
+    color_hue_shift(sRow, COLUMNS, 3);
+}
+
+
+static void run_hue_shift_f(uint32_t inRow) {
+
+    float lH;
+    float lS;
+    float lV;
+    size_t lCount;
+
+    (void)inRow;
+
+    for(lCount = 0; lCount < COLUMNS; lCount++) {
+
+        rgb_to_hsv_f(&lH, &lS, &lV, &sRow[lCount]);
+        hsv_to_rgb_f(&sRow[lCount], fmodf(lH + 3.0f, 256.0f), lS, lV);
+    }
+}
+
+
+/*! Best time of a row function in ns per color */
+static double measure(void (* infRun)(uint32_t), uint32_t inRows) {
+
+    uint32_t lRow;
+    uint32_t lSum = 0;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        run_rainbow(0);
+
+        lStart = now();
+
+        for(lRow = 0; lRow < inRows; lRow++) {
+            infRun(lRow);
+            lSum += sRow[lRow % COLUMNS].G + sRowHsv[lRow % COLUMNS].H;
+        }
+
+        lTime = (now() - lStart) / ((double)inRows * COLUMNS);
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+    }
+
+    /* the rows have to be used */
+    if(lSum == 0xFFFFFFFF) {
+        printf("\n");
+    }
+
+    return lBest;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    uint32_t lRows = 20000;
+    int lErrors = 0;
+
+    if(argc > 1) {
+        lRows = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lRows == 0) {
+        printf("Usage: %s [<rows>]\n", argv[0]);
+        return -1;
+    }
+
+    lErrors += check_spectrum();
+    lErrors += check_rgb_to_hsv();
+    lErrors += check_rows();
+
+    printf("Conversion                 ns per color\n");
+    printf("  spectrum                 %6.2f\n", measure(run_spectrum, lRows));
+    printf("  spectrum float           %6.2f\n", measure(run_spectrum_f, lRows));
+    printf("  rainbow row              %6.2f\n", measure(run_rainbow, lRows));
+    printf("  RGB to HSV               %6.2f\n", measure(run_rgb_to_hsv, lRows));
+    printf("  hue shift                %6.2f\n", measure(run_hue_shift, lRows));
+    printf("  hue shift float          %6.2f\n", measure(run_hue_shift_f, lRows));
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
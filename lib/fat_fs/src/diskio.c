@@ -1,35 +1,27 @@
 /*-----------------------------------------------------------------------*/
 /* Low level disk I/O module skeleton for FatFs     (C)ChaN, 2007        */
 /*-----------------------------------------------------------------------*/
-/* This is a stub disk I/O module that acts as front end of the existing */
-/* disk I/O modules and attach it to FatFs module with common interface. */
+/* The board has no drive attached while the USB core runs as device,    */
+/* so every drive reports that it is not ready and FatFs fails with      */
+/* FR_NOT_READY. The USB host mass storage class (usbh_msc_fatfs.c)      */
+/* implements these functions for a USB stick, link it instead of this   */
+/* module when the OTG core is configured as host.                       */
 /*-----------------------------------------------------------------------*/
 
 #include "diskio.h"
 
-/*-----------------------------------------------------------------------*/
-/* Correspondence between physical drive number and physical drive.      */
-
-#define ATA		0
-#define MMC		1
-#define USB		2
-
 
 
 /*-----------------------------------------------------------------------*/
 /* Inicializes a Drive                                                    */
 
-DSTATUS disk_initialize (BYTE drv)    /* Physical drive nmuber (0..) */
+DSTATUS disk_initialize (
+	BYTE drv		/* Physical drive nmuber (0..) */
+)
 {
-  DSTATUS stat = STA_NOINIT;
-  
-  if(HCD_IsDeviceConnected(&USB_OTG_Core_dev))
-  {  
-    stat &= ~STA_NOINIT;
-  }
-  
-  return stat;
-  
+	(void)drv;
+
+	return STA_NOINIT | STA_NODISK;
 }
 
 
@@ -41,29 +33,9 @@ DSTATUS disk_status (
 	BYTE drv		/* Physical drive nmuber (0..) */
 )
 {
-	DSTATUS stat;
-	int result;
-
-	switch (drv) {
-	case ATA :
-		result = ATA_disk_status();
-		// translate the reslut code here
-
-		return stat;
+	(void)drv;
 
-	case MMC :
-		result = MMC_disk_status();
-		// translate the reslut code here
-
-		return stat;
-
-	case USB :
-		result = USB_disk_status();
-		// translate the reslut code here
-
-		return stat;
-	}
-	return STA_NOINIT;
+	return STA_NOINIT | STA_NODISK;
 }
 
 
@@ -78,29 +50,12 @@ DRESULT disk_read (
 	BYTE count		/* Number of sectors to read (1..255) */
 )
 {
-	DRESULT res;
-	int result;
-
-	switch (drv) {
-	case ATA :
-		result = ATA_disk_read(buff, sector, count);
-		// translate the reslut code here
-
-		return res;
-
-	case MMC :
-		result = MMC_disk_read(buff, sector, count);
-		// translate the reslut code here
-
-		return res;
+	(void)drv;
+	(void)buff;
+	(void)sector;
+	(void)count;
 
-	case USB :
-		result = USB_disk_read(buff, sector, count);
-		// translate the reslut code here
-
-		return res;
-	}
-	return RES_PARERR;
+	return RES_NOTRDY;
 }
 
 
@@ -116,29 +71,12 @@ DRESULT disk_write (
 	BYTE count			/* Number of sectors to write (1..255) */
 )
 {
-	DRESULT res;
-	int result;
-
-	switch (drv) {
-	case ATA :
-		result = ATA_disk_write(buff, sector, count);
-		// translate the reslut code here
-
-		return res;
-
-	case MMC :
-		result = MMC_disk_write(buff, sector, count);
-		// translate the reslut code here
+	(void)drv;
+	(void)buff;
+	(void)sector;
+	(void)count;
 
-		return res;
-
-	case USB :
-		result = USB_disk_write(buff, sector, count);
-		// translate the reslut code here
-
-		return res;
-	}
-	return RES_PARERR;
+	return RES_NOTRDY;
 }
 #endif /* _READONLY */
 
@@ -153,34 +91,10 @@ DRESULT disk_ioctl (
 	void *buff		/* Buffer to send/receive control data */
 )
 {
-	DRESULT res;
-	int result;
-
-	switch (drv) {
-	case ATA :
-		// pre-process here
-
-		result = ATA_disk_ioctl(ctrl, buff);
-		// post-process here
-
-		return res;
-
-	case MMC :
-		// pre-process here
-
-		result = MMC_disk_ioctl(ctrl, buff);
-		// post-process here
-
-		return res;
-
-	case USB :
-		// pre-process here
-
-		result = USB_disk_ioctl(ctrl, buff);
-		// post-process here
+	(void)drv;
+	(void)ctrl;
+	(void)buff;
 
-		return res;
-	}
-	return RES_PARERR;
+	return RES_NOTRDY;
 }
 
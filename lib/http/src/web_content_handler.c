@@ -520,6 +520,8 @@ bool web_content_parse_url_encoded_data(char * inURLEncodedData, size_t inURLEnc
     size_t lValueStart = 0;
     size_t lValueLen = 0;
 
+    char lRaw;
+
     te_url_parser_state lState = URL_PARSER_STATE_IDLE;
 
     /* Read index         v                         */
@@ -529,26 +531,31 @@ bool web_content_parse_url_encoded_data(char * inURLEncodedData, size_t inURLEnc
 
     for(lReadIndex = 0, lWriteIndex = 0; lReadIndex < inURLEncodedDataLen; lReadIndex ++, lWriteIndex++) {
 
-        if(inURLEncodedData[lReadIndex] == '%') {
+        /* the states look at the encoded character, a decoded space or '&' is part of the value */
+        lRaw = inURLEncodedData[lReadIndex];
+
+        if(lRaw == '%') {
             inURLEncodedData[lWriteIndex] = web_content_decode_percent(&inURLEncodedData[lReadIndex], inURLEncodedDataLen - lReadIndex, &lIncrement);
             lReadIndex += lIncrement - 1;   /* don't point to the replaced character */
+        } else if(lRaw == '+') {
+            inURLEncodedData[lWriteIndex] = ' ';                            /* form encoded space */
         } else {
             inURLEncodedData[lWriteIndex] = inURLEncodedData[lReadIndex];
         }
 
-        dbg("Read Index:  %d (%c)\r\n", lReadIndex, inURLEncodedData[lReadIndex]);
+        dbg("Read Index:  %d (%c)\r\n", lReadIndex, lRaw);
         dbg("Write Index: %d (%c)\r\n", lWriteIndex, inURLEncodedData[lWriteIndex]);
 
         switch(lState) {
             case URL_PARSER_STATE_IDLE:
-                if(!isspace((int)inURLEncodedData[lReadIndex])) {        /* skip leading white spaces */
+                if(!isspace((int)lRaw)) {        /* skip leading white spaces */
                     dbg("URL_PARSER_TOKEN\r\n");
                     lTokenStart = lWriteIndex;
                     lState = URL_PARSER_TOKEN;
                 }
                 break;
             case URL_PARSER_TOKEN:
-                if(inURLEncodedData[lReadIndex] == '=') {
+                if(lRaw == '=') {
                     dbg("URL_PARSER_START_VALUE\r\n");
                     lTokenLen = lWriteIndex - lTokenStart;
                     lState = URL_PARSER_START_VALUE;
@@ -560,8 +567,8 @@ bool web_content_parse_url_encoded_data(char * inURLEncodedData, size_t inURLEnc
                 lState = URL_PARSER_VALUE;
                 break;
             case URL_PARSER_VALUE:
-                if(isspace((int)inURLEncodedData[lReadIndex]) ||                /* cr or lf or something like that */
-                   inURLEncodedData[lReadIndex] == '&') {                       /* next token */
+                if(isspace((int)lRaw) ||                                        /* cr or lf or something like that */
+                   lRaw == '&') {                                               /* next token */
 
                     dbg("URL_PARSER_STATE_IDLE\r\n");
                     lValueLen = lWriteIndex - lValueStart;
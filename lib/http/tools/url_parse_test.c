@@ -0,0 +1,122 @@
+/*  Host check of web_content_parse_url_encoded_data()
+
+    Parses url encoded forms and compares the values the handlers get.
+    Go to the tools folder and run:
+
+    gcc -O2 -Wall -I../inc -o url_parse_test url_parse_test.c ../src/web_content_handler.c ../src/web_content.c
+    ./url_parse_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "web_content.h"
+#include "web_content_handler.h"
+
+
+#define VALUE_MAX   (64)
+#define TOKENS      (3)
+
+
+/*! Values the handlers received */
+static char sValues[TOKENS][VALUE_MAX];
+
+/*! Number of values received per token */
+static int sCalls[TOKENS];
+
+
+static bool set_value(int inToken, const char * const inValue, size_t inValueLength) {
+
+    size_t lLen = (inValueLength < VALUE_MAX - 1)? inValueLength : VALUE_MAX - 1;
+
+    memcpy(sValues[inToken], inValue, lLen);
+    sValues[inToken][lLen] = '\0';
+    sCalls[inToken]++;
+
+    return true;
+}
+
+static bool set_text(void * inUserData, const char * const inValue, size_t inValueLength) {
+    return set_value(0, inValue, inValueLength);
+}
+
+static bool set_speed(void * inUserData, const char * const inValue, size_t inValueLength) {
+    return set_value(1, inValue, inValueLength);
+}
+
+static bool set_name(void * inUserData, const char * const inValue, size_t inValueLength) {
+    return set_value(2, inValue, inValueLength);
+}
+
+
+const ts_web_content_handlers g_WebContentHandler = {
+    .mHandlerCount = TOKENS,
+    .mParsingStart = NULL,
+    .mParsingDone = NULL,
+    .mUserData = NULL,
+    .mHandler = {
+        { .mToken = "anres1", .mGet = NULL, .mSet = set_text },
+        { .mToken = "anspd",  .mGet = NULL, .mSet = set_speed },
+        { .mToken = "name",   .mGet = NULL, .mSet = set_name },
+    },
+};
+
+
+/*! A form and the values expected for its tokens, NULL for no call */
+typedef struct {
+
+    const char * mForm;
+
+    const char * mExpected[TOKENS];
+
+} ts_case;
+
+
+static const ts_case sCases[] = {
+    { "anres1=Hello&anspd=20",                  { "Hello", "20", NULL } },
+    { "anres1=Hello+World&anspd=20",            { "Hello World", "20", NULL } },
+    { "anres1=Hello%20World&anspd=20",          { "Hello World", "20", NULL } },
+    { "anres1=a+b%20c+d&anspd=5&name=x+y",      { "a b c d", "5", "x y" } },
+    { "anres1=Tom+%26+Jerry&anspd=7",           { "Tom & Jerry", "7", NULL } },
+    { "anres1=1%2B1+%3D+2&anspd=3",             { "1+1 = 2", "3", NULL } },
+    { "anspd=20&anres1=last+word",              { "last word", "20", NULL } },
+    { "anres1=x+y\r\n",                         { "x y", NULL, NULL } },
+};
+
+
+int main(void) {
+
+    char lForm[256];
+    size_t lCase;
+    int lToken;
+    int lErrors = 0;
+
+    for(lCase = 0; lCase < sizeof(sCases) / sizeof(sCases[0]); lCase++) {
+
+        memset(sValues, 0, sizeof(sValues));
+        memset(sCalls, 0, sizeof(sCalls));
+
+        strcpy(lForm, sCases[lCase].mForm);
+        web_content_parse_url_encoded_data(lForm, strlen(lForm));
+
+        for(lToken = 0; lToken < TOKENS; lToken++) {
+
+            const char * lExpected = sCases[lCase].mExpected[lToken];
+
+            if(lExpected ? (sCalls[lToken] != 1 || strcmp(sValues[lToken], lExpected) != 0) : sCalls[lToken] != 0) {
+
+                printf("FAIL \"%s\": %s got \"%s\" (%d calls), expected \"%s\"\n", sCases[lCase].mForm,
+                       g_WebContentHandler.mHandler[lToken].mToken, sValues[lToken], sCalls[lToken], lExpected ? lExpected : "no call");
+                lErrors++;
+            }
+        }
+    }
+
+    printf("%zu forms, %d errors\n", sizeof(sCases) / sizeof(sCases[0]), lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
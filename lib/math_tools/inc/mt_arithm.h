@@ -53,6 +53,76 @@ static inline uint8_t add8_cl(uint8_t inA, uint8_t inB, uint8_t inLimit) {
 
 
 
+/*! Scale a value by a fraction
+
+    \param[in]  inValue     Value to scale
+    \param[in]  inScale     Fraction in 1/256, 255 keeps the value
+
+    \retval inValue * (inScale + 1) / 256
+*/
+static inline uint8_t scale8(uint8_t inValue, uint8_t inScale) {
+
+    return (uint8_t)(((uint32_t)inValue * (1u + inScale)) >> 8);
+}
+
+
+/*! Scale three values in place by the same fraction, see scale8() */
+static inline void nscale8x3(uint8_t * pFirst, uint8_t * pSecond, uint8_t * pThird, uint8_t inScale) {
+
+    uint32_t lScale = 1u + inScale;
+
+    *pFirst  = (uint8_t)((*pFirst  * lScale) >> 8);
+    *pSecond = (uint8_t)((*pSecond * lScale) >> 8);
+    *pThird  = (uint8_t)((*pThird  * lScale) >> 8);
+}
+
+
+/*! Scale a 16 bit value by a fraction
+
+    \retval inValue * (inScale + 1) / 65536
+*/
+static inline uint16_t scale16(uint16_t inValue, uint16_t inScale) {
+
+    return (uint16_t)(((uint32_t)inValue * (1u + inScale)) >> 16);
+}
+
+
+/*! Linear interpolation between two values
+
+    \param[in]  inFrom      Value at amount 0
+    \param[in]  inTo        Value at amount 255
+    \param[in]  inAmount    Amount of inTo (0 - 255)
+*/
+static inline uint8_t blend8(uint8_t inFrom, uint8_t inTo, uint8_t inAmount) {
+
+    /* scale amount to 0 - 256 */
+    int32_t lWeight = inAmount + (inAmount >> 7);
+
+    return (uint8_t)(inFrom + ((((int32_t)inTo - inFrom) * lWeight) >> 8));
+}
+
+
+/*! Linear interpolation between two 16 bit values, see blend8()
+
+    \param[in]  inAmount    Amount of inTo (0 - 65535)
+*/
+static inline uint16_t blend16(uint16_t inFrom, uint16_t inTo, uint16_t inAmount) {
+
+    /* scale amount to 0 - 65536 */
+    int64_t lWeight = inAmount + (inAmount >> 15);
+
+    return (uint16_t)(inFrom + ((((int64_t)inTo - inFrom) * lWeight) >> 16));
+}
+
+
+/*! Integer square root
+
+    \retval the largest value whose square is not greater than inValue
+*/
+uint16_t sqrt16(uint32_t inValue);
+
+
+
 #endif /* MT_ARITHM_H_ */
 
 /* eof */
@@ -0,0 +1,53 @@
+#ifndef MT_FFT_H_
+#define MT_FFT_H_
+
+#include <stdint.h>
+
+
+/*  Fixed point FFT
+
+    A radix-4 decimation in frequency FFT of complex Q15 data, in place,
+    like arm_cfft_radix4_q15() of CMSIS DSP. The data is interleaved real
+    and imaginary parts. Every stage divides by 4, so the output is the
+    DFT divided by the number of points and can't overflow. The result is
+    in natural order.
+
+    Real signals are transformed with the imaginary parts set to 0, bins
+    above half the points mirror the lower ones then.
+*/
+
+
+/*! Largest transform in points, the size of the twiddle table */
+#define MT_FFT_MAX              (256)
+
+
+/*! Complex FFT in place
+
+    \param[in,out]  pData       2 * inPoints values, real and imaginary part of every point,
+                                from -32767 to 32767
+    \param[in]      inPoints    Number of points, 4, 16, 64 or 256
+*/
+void mt_fft_q15(int16_t * pData, uint32_t inPoints);
+
+
+/*! Power of a bin
+
+    \param[in]  inData      Output of mt_fft_q15()
+    \param[in]  inBin       Index of the bin
+
+    \return squared magnitude, at most 2^31
+*/
+static inline uint32_t mt_fft_power(const int16_t * inData, uint32_t inBin) {
+
+    int32_t lReal = inData[2 * inBin];
+    int32_t lImag = inData[2 * inBin + 1];
+
+    return (uint32_t)(lReal * lReal) + (uint32_t)(lImag * lImag);
+}
+
+
+
+
+#endif /* MT_FFT_H_ */
+
+/* eof */
@@ -0,0 +1,55 @@
+#ifndef MT_NOISE_H_
+#define MT_NOISE_H_
+
+#include <stdint.h>
+#include <stddef.h>     // size_t
+
+
+/*  Value noise on an integer lattice
+
+    Coordinates are fixed point 8.8, the upper byte selects the lattice
+    cell and the lower byte is the position within it. The noise repeats
+    every 256 cells. Values are smoothly interpolated between random values
+    at the lattice points, so neighbouring pixels should be a fraction of a
+    cell apart (e.g. a step of 32 for 8 pixels per cell).
+*/
+
+
+/*! 2D value noise
+
+    \param[in]  inX     X coordinate, fixed point 8.8
+    \param[in]  inY     Y coordinate, fixed point 8.8
+
+    \return noise from 0 to 255
+*/
+uint8_t noise8_2d(uint16_t inX, uint16_t inY);
+
+
+/*! 3D value noise, see noise8_2d()
+
+    Use the third coordinate as time to animate a 2D noise.
+*/
+uint8_t noise8_3d(uint16_t inX, uint16_t inY, uint16_t inZ);
+
+
+/*! 3D value noise for a row of pixels
+
+    Gives the same values as noise8_3d() for (inX + n * inStepX, inY, inZ)
+    but only looks up the lattice when the row enters a new cell, which
+    makes it several times faster for steps below one cell.
+
+    \param[out] outValues   inCount noise values
+    \param[in]  inCount     Number of values
+    \param[in]  inX         X coordinate of the first value, fixed point 8.8
+    \param[in]  inStepX     X distance between two values, fixed point 8.8
+    \param[in]  inY         Y coordinate, fixed point 8.8
+    \param[in]  inZ         Z coordinate, fixed point 8.8
+*/
+void noise8_3d_row(uint8_t * outValues, size_t inCount, uint16_t inX, uint16_t inStepX, uint16_t inY, uint16_t inZ);
+
+
+
+
+#endif /* MT_NOISE_H_ */
+
+/* eof */
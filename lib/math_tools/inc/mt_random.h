@@ -3,6 +3,25 @@
 
 
 #include <stdint.h>
+#include <stddef.h>     // size_t
+
+
+/*  The xorshift generators share one global state each. Consumers which
+    need their own sequence or many random numbers per frame use a PCG32
+    generator object and its bulk functions.
+*/
+
+
+/*! PCG32 generator state */
+typedef struct {
+
+    /*! Current state */
+    uint64_t    mState;
+
+    /*! Increment, selects one of 2^63 sequences, always odd */
+    uint64_t    mIncrement;
+
+} ts_pcg32;
 
 
 /*! Generate 8 bit random number
@@ -33,6 +52,49 @@ uint32_t xorshift32(void);
 uint64_t xorshift64(void);
 
 
+/*! Seed a PCG32 generator
+
+    \param[in]  inSeed      Start state
+    \param[in]  inSequence  Sequence, generators with different sequences are independent
+*/
+void pcg32_seed(ts_pcg32 * pThis, uint64_t inSeed, uint64_t inSequence);
+
+
+/*! Generate 32 bit random number
+
+    \return 32bit random number, all values possible
+*/
+uint32_t pcg32(ts_pcg32 * pThis);
+
+
+/*! Generate 32 bit random number with limit
+
+    \return random number from 0 to inRange - 1
+*/
+static inline uint32_t pcg32_bounded(ts_pcg32 * pThis, uint32_t inRange) {
+
+    return (uint32_t)(((uint64_t)pcg32(pThis) * inRange) >> 32);
+}
+
+
+/*! Fill a buffer with random bytes, one generator step per 4 bytes
+
+    \param[out] outBuffer   Random bytes
+    \param[in]  inLength    Number of bytes
+*/
+void pcg32_fill(ts_pcg32 * pThis, uint8_t * outBuffer, size_t inLength);
+
+
+/*! Fill a buffer with random bytes within a range
+
+    \param[out] outBuffer   Random bytes from inMin to inMax inclusive
+    \param[in]  inLength    Number of bytes
+    \param[in]  inMin       Smallest value
+    \param[in]  inMax       Largest value, not less than inMin
+*/
+void pcg32_fill_range(ts_pcg32 * pThis, uint8_t * outBuffer, size_t inLength, uint8_t inMin, uint8_t inMax);
+
+
 /*! Generate 8 bit random number with limit
 
     \return 8bit random number from 1 to n
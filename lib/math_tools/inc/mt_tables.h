@@ -0,0 +1,29 @@
+#ifndef MT_TABLES_H_
+#define MT_TABLES_H_
+
+#include <stdint.h>
+
+
+/*  Lookup tables of the math tools
+
+    src/mt_tables.c is generated by tools/mt_tables_gen.c, see README.md.
+*/
+
+
+/*! First quarter of a sine wave in Q15, 64 steps + end point */
+extern const int16_t mt_sin16_quarter[65];
+
+/*! Full sine wave with 256 steps, 128 + 127 * sin */
+extern const uint8_t mt_sin8[256];
+
+/*! Arc tangent of 0 to 1 in 64 steps + end point, 65536 is a full circle */
+extern const uint16_t mt_atan16_octant[65];
+
+/*! Full sine wave with 256 steps in Q15, the twiddle factors of mt_fft_q15() */
+extern const int16_t mt_sin16_wave[256];
+
+
+
+#endif /* MT_TABLES_H_ */
+
+/* eof */
@@ -0,0 +1,74 @@
+#ifndef MT_TRIG_H_
+#define MT_TRIG_H_
+
+#include <stdint.h>
+
+
+/*! Full circle in 16 bit angle units */
+#define MT_ANGLE16_FULL         (65536)
+
+
+/*! Convert degree to a 16 bit angle
+
+    \param[in]  inDegree    Angle in degree, may be negative
+
+    \return the angle where 65536 is a full circle
+*/
+static inline uint16_t deg_to_angle16(int32_t inDegree) {
+
+    return (uint16_t)((inDegree * MT_ANGLE16_FULL) / 360);
+}
+
+
+/*! Fixed point sine
+
+    \param[in]  inAngle     Angle where 65536 is a full circle
+
+    \return sine in Q15 (-32767 to 32767)
+*/
+int16_t sin16(uint16_t inAngle);
+
+
+/*! Fixed point cosine
+
+    \param[in]  inAngle     Angle where 65536 is a full circle
+
+    \return cosine in Q15 (-32767 to 32767)
+*/
+static inline int16_t cos16(uint16_t inAngle) {
+
+    return sin16(inAngle + (MT_ANGLE16_FULL / 4));
+}
+
+
+/*! 8 bit sine from a table, for per pixel use
+
+    \param[in]  inAngle     Angle where 256 is a full circle
+
+    \return sine scaled to 1 - 255, 128 is zero
+*/
+uint8_t sin8(uint8_t inAngle);
+
+
+/*! 8 bit cosine, see sin8() */
+static inline uint8_t cos8(uint8_t inAngle) {
+
+    return sin8((uint8_t)(inAngle + 64));
+}
+
+
+/*! Fixed point arc tangent of inY / inX
+
+    \param[in]  inY     Y coordinate
+    \param[in]  inX     X coordinate
+
+    \return the angle of the point, 65536 is a full circle, counter clockwise from the x axis, 0 for (0, 0)
+*/
+uint16_t atan2_16(int32_t inY, int32_t inX);
+
+
+
+
+#endif /* MT_TRIG_H_ */
+
+/* eof */
@@ -0,0 +1,34 @@
+
+#include <stdint.h>
+
+#include "mt_arithm.h"
+
+
+uint16_t sqrt16(uint32_t inValue) {
+
+    uint32_t lResult = 0;
+    uint32_t lBit = 1u << 30;
+
+    /* highest power of 4 not greater than the value */
+    while(lBit > inValue) {
+        lBit >>= 2;
+    }
+
+    /* one result bit per iteration */
+    while(lBit != 0) {
+
+        if(inValue >= lResult + lBit) {
+            inValue -= lResult + lBit;
+            lResult  = (lResult >> 1) + lBit;
+        } else {
+            lResult >>= 1;
+        }
+
+        lBit >>= 2;
+    }
+
+    return (uint16_t)lResult;
+}
+
+
+/* eof */
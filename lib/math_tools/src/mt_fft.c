@@ -0,0 +1,117 @@
+#include <stdint.h>
+
+#include "mt_fft.h"
+#include "mt_tables.h"
+
+
+/*! Multiply a point by the twiddle factor exp(-2 pi i inIndex / MT_FFT_MAX) and store it */
+static inline void mt_fft_twiddle(int16_t * outPoint, int32_t inReal, int32_t inImag, uint32_t inIndex) {
+
+    int32_t lCos = mt_sin16_wave[(inIndex + MT_FFT_MAX / 4) & (MT_FFT_MAX - 1)];
+    int32_t lSin = mt_sin16_wave[inIndex];
+
+    outPoint[0] = (int16_t)((inReal * lCos + inImag * lSin) >> 15);
+    outPoint[1] = (int16_t)((inImag * lCos - inReal * lSin) >> 15);
+}
+
+
+/*! Reverse the base 4 digits of all indices */
+static void mt_fft_digit_reverse(int16_t * pData, uint32_t inPoints) {
+
+    uint32_t lIndex;
+    uint32_t lReverse;
+    uint32_t lDigits;
+    uint32_t lPoints;
+    int16_t lSwap;
+
+    for(lIndex = 1; lIndex < inPoints - 1; lIndex++) {
+
+        lReverse = 0;
+        lDigits  = lIndex;
+
+        for(lPoints = inPoints; lPoints > 1; lPoints >>= 2) {
+            lReverse = (lReverse << 2) | (lDigits & 3);
+            lDigits >>= 2;
+        }
+
+        if(lReverse > lIndex) {
+
+            lSwap                    = pData[2 * lIndex];
+            pData[2 * lIndex]        = pData[2 * lReverse];
+            pData[2 * lReverse]      = lSwap;
+
+            lSwap                    = pData[2 * lIndex + 1];
+            pData[2 * lIndex + 1]    = pData[2 * lReverse + 1];
+            pData[2 * lReverse + 1]  = lSwap;
+        }
+    }
+}
+
+
+void mt_fft_q15(int16_t * pData, uint32_t inPoints) {
+
+    uint32_t lSpan;
+    uint32_t lQuarter;
+    uint32_t lStep;
+    uint32_t lTwiddle;
+    uint32_t lGroup;
+    int16_t * lA;
+    int16_t * lB;
+    int16_t * lC;
+    int16_t * lD;
+    int32_t lSumAC[2];
+    int32_t lDiffAC[2];
+    int32_t lSumBD[2];
+    int32_t lDiffBD[2];
+
+    for(lSpan = inPoints; lSpan >= 4; lSpan >>= 2) {
+
+        lQuarter = lSpan / 4;
+        lStep    = MT_FFT_MAX / lSpan;
+
+        /* the twiddle factors only depend on the position within a span */
+        for(lTwiddle = 0; lTwiddle < lQuarter; lTwiddle++) {
+            for(lGroup = lTwiddle; lGroup < inPoints; lGroup += lSpan) {
+
+                lA = &pData[2 * lGroup];
+                lB = &lA[2 * lQuarter];
+                lC = &lB[2 * lQuarter];
+                lD = &lC[2 * lQuarter];
+
+                lSumAC[0]  = lA[0] + lC[0];
+                lSumAC[1]  = lA[1] + lC[1];
+                lDiffAC[0] = lA[0] - lC[0];
+                lDiffAC[1] = lA[1] - lC[1];
+                lSumBD[0]  = lB[0] + lD[0];
+                lSumBD[1]  = lB[1] + lD[1];
+                lDiffBD[0] = lB[0] - lD[0];
+                lDiffBD[1] = lB[1] - lD[1];
+
+                /* the outputs for bins 4k, 4k + 1, 4k + 2 and 4k + 3 of the span, divided by 4 */
+                lA[0] = (int16_t)((lSumAC[0] + lSumBD[0]) >> 2);
+                lA[1] = (int16_t)((lSumAC[1] + lSumBD[1]) >> 2);
+
+                if(lTwiddle == 0) {
+
+                    lB[0] = (int16_t)((lDiffAC[0] + lDiffBD[1]) >> 2);
+                    lB[1] = (int16_t)((lDiffAC[1] - lDiffBD[0]) >> 2);
+                    lC[0] = (int16_t)((lSumAC[0] - lSumBD[0]) >> 2);
+                    lC[1] = (int16_t)((lSumAC[1] - lSumBD[1]) >> 2);
+                    lD[0] = (int16_t)((lDiffAC[0] - lDiffBD[1]) >> 2);
+                    lD[1] = (int16_t)((lDiffAC[1] + lDiffBD[0]) >> 2);
+
+                } else {
+
+                    mt_fft_twiddle(lB, (lDiffAC[0] + lDiffBD[1]) >> 2, (lDiffAC[1] - lDiffBD[0]) >> 2, lTwiddle * lStep);
+                    mt_fft_twiddle(lC, (lSumAC[0] - lSumBD[0]) >> 2, (lSumAC[1] - lSumBD[1]) >> 2, 2 * lTwiddle * lStep);
+                    mt_fft_twiddle(lD, (lDiffAC[0] - lDiffBD[1]) >> 2, (lDiffAC[1] + lDiffBD[0]) >> 2, 3 * lTwiddle * lStep);
+                }
+            }
+        }
+    }
+
+    mt_fft_digit_reverse(pData, inPoints);
+}
+
+
+/* eof */
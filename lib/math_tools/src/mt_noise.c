@@ -0,0 +1,128 @@
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mt_noise.h"
+
+
+/*! Permutation of 0 - 255 which hashes the lattice points */
+static const uint8_t sPerm[256] = {
+    151, 160, 137,  91,  90,  15, 131,  13, 201,  95,  96,  53, 194, 233,   7, 225,
+    140,  36, 103,  30,  69, 142,   8,  99,  37, 240,  21,  10,  23, 190,   6, 148,
+    247, 120, 234,  75,   0,  26, 197,  62,  94, 252, 219, 203, 117,  35,  11,  32,
+     57, 177,  33,  88, 237, 149,  56,  87, 174,  20, 125, 136, 171, 168,  68, 175,
+     74, 165,  71, 134, 139,  48,  27, 166,  77, 146, 158, 231,  83, 111, 229, 122,
+     60, 211, 133, 230, 220, 105,  92,  41,  55,  46, 245,  40, 244, 102, 143,  54,
+     65,  25,  63, 161,   1, 216,  80,  73, 209,  76, 132, 187, 208,  89,  18, 169,
+    200, 196, 135, 130, 116, 188, 159,  86, 164, 100, 109, 198, 173, 186,   3,  64,
+     52, 217, 226, 250, 124, 123,   5, 202,  38, 147, 118, 126, 255,  82,  85, 212,
+    207, 206,  59, 227,  47,  16,  58,  17, 182, 189,  28,  42, 223, 183, 170, 213,
+    119, 248, 152,   2,  44, 154, 163,  70, 221, 153, 101, 155, 167,  43, 172,   9,
+    129,  22,  39, 253,  19,  98, 108, 110,  79, 113, 224, 232, 178, 185, 112, 104,
+    218, 246,  97, 228, 251,  34, 242, 193, 238, 210, 144,  12, 191, 179, 162, 241,
+     81,  51, 145, 235, 249,  14, 239, 107,  49, 192, 214,  31, 181, 199, 106, 157,
+    184,  84, 204, 176, 115, 121,  50,  45, 127,   4, 150, 254, 138, 236, 205,  93,
+    222, 114,  67,  29,  24,  72, 243, 141, 128, 195,  78,  66, 215,  61, 156, 180,
+};
+
+
+/*! Random value of a lattice point */
+static inline uint8_t noise8_hash(uint8_t inX, uint8_t inY, uint8_t inZ) {
+
+    return sPerm[(uint8_t)(sPerm[(uint8_t)(sPerm[inX] + inY)] + inZ)];
+}
+
+
+/*! Smoothstep 3t^2 - 2t^3 of a cell position, 0 - 255 */
+static inline uint32_t noise8_ease(uint32_t inFrac) {
+
+    return (inFrac * inFrac * (3 * 256 - 2 * inFrac)) >> 16;
+}
+
+
+/*! Interpolate from A to B by inAmount / 256 */
+static inline int32_t noise8_lerp(int32_t inA, int32_t inB, uint32_t inAmount) {
+
+    return inA + (((inB - inA) * (int32_t)inAmount) >> 8);
+}
+
+
+/*! Interpolate the values of the 4 lattice points at x in y and z
+
+    \return the value on the edge at x, scaled by 256
+*/
+static inline int32_t noise8_edge(uint8_t inX, uint8_t inY, uint8_t inZ, uint32_t inEaseY, uint32_t inEaseZ) {
+
+    int32_t lNear = noise8_lerp(noise8_hash(inX, inY, inZ)     << 8, noise8_hash(inX, inY + 1, inZ)     << 8, inEaseY);
+    int32_t lFar  = noise8_lerp(noise8_hash(inX, inY, inZ + 1) << 8, noise8_hash(inX, inY + 1, inZ + 1) << 8, inEaseY);
+
+    return noise8_lerp(lNear, lFar, inEaseZ);
+}
+
+
+uint8_t noise8_3d(uint16_t inX, uint16_t inY, uint16_t inZ) {
+
+    uint8_t lX = (uint8_t)(inX >> 8);
+    uint8_t lY = (uint8_t)(inY >> 8);
+    uint8_t lZ = (uint8_t)(inZ >> 8);
+
+    uint32_t lEaseY = noise8_ease(inY & 0xFF);
+    uint32_t lEaseZ = noise8_ease(inZ & 0xFF);
+
+    int32_t lLeft  = noise8_edge(lX,     lY, lZ, lEaseY, lEaseZ);
+    int32_t lRight = noise8_edge(lX + 1, lY, lZ, lEaseY, lEaseZ);
+
+    return (uint8_t)(noise8_lerp(lLeft, lRight, noise8_ease(inX & 0xFF)) >> 8);
+}
+
+
+uint8_t noise8_2d(uint16_t inX, uint16_t inY) {
+
+    uint8_t lX = (uint8_t)(inX >> 8);
+    uint8_t lY = (uint8_t)(inY >> 8);
+
+    uint32_t lEaseX = noise8_ease(inX & 0xFF);
+    uint32_t lEaseY = noise8_ease(inY & 0xFF);
+
+    int32_t lTop    = noise8_lerp(noise8_hash(lX, lY, 0)     << 8, noise8_hash(lX + 1, lY, 0)     << 8, lEaseX);
+    int32_t lBottom = noise8_lerp(noise8_hash(lX, lY + 1, 0) << 8, noise8_hash(lX + 1, lY + 1, 0) << 8, lEaseX);
+
+    return (uint8_t)(noise8_lerp(lTop, lBottom, lEaseY) >> 8);
+}
+
+
+void noise8_3d_row(uint8_t * outValues, size_t inCount, uint16_t inX, uint16_t inStepX, uint16_t inY, uint16_t inZ) {
+
+    uint8_t lY = (uint8_t)(inY >> 8);
+    uint8_t lZ = (uint8_t)(inZ >> 8);
+
+    uint32_t lEaseY = noise8_ease(inY & 0xFF);
+    uint32_t lEaseZ = noise8_ease(inZ & 0xFF);
+
+    uint8_t lCell = (uint8_t)(inX >> 8);
+    int32_t lLeft  = noise8_edge(lCell,     lY, lZ, lEaseY, lEaseZ);
+    int32_t lRight = noise8_edge(lCell + 1, lY, lZ, lEaseY, lEaseZ);
+
+    size_t lCount;
+
+    for(lCount = 0; lCount < inCount; lCount++, inX += inStepX) {
+
+        /* the edges only change with the cell */
+        if((uint8_t)(inX >> 8) != lCell) {
+
+            if((uint8_t)(inX >> 8) == (uint8_t)(lCell + 1)) {
+                lLeft = lRight;
+            } else {
+                lLeft = noise8_edge((uint8_t)(inX >> 8), lY, lZ, lEaseY, lEaseZ);
+            }
+
+            lCell  = (uint8_t)(inX >> 8);
+            lRight = noise8_edge(lCell + 1, lY, lZ, lEaseY, lEaseZ);
+        }
+
+        outValues[lCount] = (uint8_t)(noise8_lerp(lLeft, lRight, noise8_ease(inX & 0xFF)) >> 8);
+    }
+}
+
+
+/* eof */
@@ -1,5 +1,6 @@
 
 #include <stdio.h>
+#include <stddef.h>
 
 #include "mt_random.h"
 
@@ -69,7 +70,77 @@ uint64_t xorshift64(void) {
     y64 ^= (y64 >> 7);
     y64 ^= (y64 << 17);
 
-    return 64;
+    return y64;
+}
+
+
+/*! Multiplier of the PCG32 linear congruential step */
+#define PCG32_MULTIPLIER    (6364136223846793005ull)
+
+
+void pcg32_seed(ts_pcg32 * pThis, uint64_t inSeed, uint64_t inSequence) {
+
+    pThis->mState     = 0;
+    pThis->mIncrement = (inSequence << 1) | 1u;
+
+    pcg32(pThis);
+    pThis->mState += inSeed;
+    pcg32(pThis);
+}
+
+
+uint32_t pcg32(ts_pcg32 * pThis) {
+
+    uint64_t lState = pThis->mState;
+    uint32_t lShifted;
+    uint32_t lRotation;
+
+    pThis->mState = lState * PCG32_MULTIPLIER + pThis->mIncrement;
+
+    /* xorshift high bits, random rotation */
+    lShifted  = (uint32_t)(((lState >> 18) ^ lState) >> 27);
+    lRotation = (uint32_t)(lState >> 59);
+
+    return (lShifted >> lRotation) | (lShifted << ((32 - lRotation) & 31));
+}
+
+
+void pcg32_fill(ts_pcg32 * pThis, uint8_t * outBuffer, size_t inLength) {
+
+    uint32_t lRandom;
+    size_t lCount;
+
+    /* four bytes per step */
+    for(lCount = 0; lCount + 4 <= inLength; lCount += 4) {
+
+        lRandom = pcg32(pThis);
+
+        outBuffer[lCount]     = (uint8_t)lRandom;
+        outBuffer[lCount + 1] = (uint8_t)(lRandom >> 8);
+        outBuffer[lCount + 2] = (uint8_t)(lRandom >> 16);
+        outBuffer[lCount + 3] = (uint8_t)(lRandom >> 24);
+    }
+
+    if(lCount < inLength) {
+
+        for(lRandom = pcg32(pThis); lCount < inLength; lCount++, lRandom >>= 8) {
+            outBuffer[lCount] = (uint8_t)lRandom;
+        }
+    }
+}
+
+
+void pcg32_fill_range(ts_pcg32 * pThis, uint8_t * outBuffer, size_t inLength, uint8_t inMin, uint8_t inMax) {
+
+    uint32_t lRange = (uint32_t)inMax - inMin + 1;
+    size_t lCount;
+
+    pcg32_fill(pThis, outBuffer, inLength);
+
+    /* multiply and shift instead of a modulo */
+    for(lCount = 0; lCount < inLength; lCount++) {
+        outBuffer[lCount] = (uint8_t)(inMin + ((outBuffer[lCount] * lRange) >> 8));
+    }
 }
 
 
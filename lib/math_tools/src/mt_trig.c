@@ -0,0 +1,98 @@
+
+#include <stdint.h>
+
+#include "mt_trig.h"
+#include "mt_tables.h"
+
+
+int16_t sin16(uint16_t inAngle) {
+
+    uint32_t lPos = inAngle & 0x3fff;
+    uint32_t lIndex;
+    uint32_t lFrac;
+    int32_t  lValue;
+
+    /* 2nd and 4th quarter are mirrored */
+    if(inAngle & 0x4000) {
+        lPos = 0x4000 - lPos;
+    }
+
+    lIndex = lPos >> 8;
+    lFrac  = lPos & 0xff;
+
+    lValue = mt_sin16_quarter[lIndex];
+
+    /* linear interpolation between the table entries */
+    if(lFrac) {
+        lValue += ((mt_sin16_quarter[lIndex + 1] - lValue) * (int32_t)lFrac) >> 8;
+    }
+
+    /* 3rd and 4th quarter are negative */
+    if(inAngle & 0x8000) {
+        lValue = -lValue;
+    }
+
+    return (int16_t)lValue;
+}
+
+
+uint8_t sin8(uint8_t inAngle) {
+
+    return mt_sin8[inAngle];
+}
+
+
+uint16_t atan2_16(int32_t inY, int32_t inX) {
+
+    uint32_t lX = (inX < 0)? 0u - (uint32_t)inX : (uint32_t)inX;
+    uint32_t lY = (inY < 0)? 0u - (uint32_t)inY : (uint32_t)inY;
+    uint32_t lRatio;
+    uint32_t lIndex;
+    uint32_t lFrac;
+    uint32_t lAngle;
+
+    if(lX == 0 && lY == 0) {
+        return 0;
+    }
+
+    /* keep the ratio within 32 bit, only the proportion matters */
+    while((lX | lY) >= (1u << 17)) {
+        lX >>= 1;
+        lY >>= 1;
+    }
+
+    /* ratio of the smaller to the larger coordinate in Q14 */
+    if(lY <= lX) {
+        lRatio = (lY << 14) / lX;
+    } else {
+        lRatio = (lX << 14) / lY;
+    }
+
+    lIndex = lRatio >> 8;
+    lFrac  = lRatio & 0xff;
+
+    lAngle = mt_atan16_octant[lIndex];
+
+    /* linear interpolation between the table entries */
+    if(lFrac) {
+        lAngle += ((mt_atan16_octant[lIndex + 1] - lAngle) * lFrac + 128) >> 8;
+    }
+
+    /* mirror the octant to the quadrant */
+    if(lY > lX) {
+        lAngle = MT_ANGLE16_FULL / 4 - lAngle;
+    }
+
+    if(inX < 0) {
+        lAngle = MT_ANGLE16_FULL / 2 - lAngle;
+    }
+
+    if(inY < 0) {
+        lAngle = MT_ANGLE16_FULL - lAngle;
+    }
+
+    return (uint16_t)lAngle;
+}
+
+
+/* eof */
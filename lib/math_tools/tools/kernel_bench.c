@@ -0,0 +1,448 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "mt_arithm.h"
+#include "mt_trig.h"
+
+/*  Checks the fixed point kernels and measures them against the float
+    functions of the C library
+
+    Usage: kernel_bench [<calls>]
+
+    The byte kernels are checked bit exact for every input against their
+    definition in double precision, the 16 and 32 bit ones for all edge
+    values and a few million random inputs. sin16 and atan2_16 interpolate
+    tables and are checked against an error bound. The
+    timing is the best of five runs of <calls> calls with inputs from a
+    table, in ns and time stamp counter ticks per call.
+*/
+
+
+/*! Inputs of the timed calls, a power of 2 */
+#define INPUTS              (4096)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+/*! Random inputs of the 16 and 32 bit checks */
+#define RANDOM_CHECKS       (4000000)
+
+/*! Allowed difference of sin16 to 32767 * sin, the quarter table has 64 steps */
+#define SIN16_TOLERANCE     (4)
+
+/*! Allowed difference of atan2_16 to atan2 rounded, in angle units */
+#define ATAN2_TOLERANCE     (2)
+
+
+/*! A kernel and its float counterpart, each summing its results over the inputs */
+typedef struct {
+    const char    * mName;
+    uint32_t     (* mfFixed)(void);
+    float        (* mfFloat)(void);
+    const char    * mFloatName;
+} ts_kernel;
+
+
+static uint32_t sInA[INPUTS];
+static uint32_t sInB[INPUTS];
+static uint32_t sInC[INPUTS];
+
+static float sInAF[INPUTS];
+static float sInBF[INPUTS];
+static float sInCF[INPUTS];
+
+/*! Sum of the results, keeps the calls from being optimized away */
+static volatile uint32_t sSink;
+static volatile float sSinkF;
+
+static uint32_t sSeed = 1;
+
+
+static uint32_t next_random(void) {
+
+    sSeed ^= sSeed << 13;
+    sSeed ^= sSeed >> 17;
+    sSeed ^= sSeed << 5;
+
+    return sSeed;
+}
+
+
+static int check(const char * inName, uint32_t inInput, long inGot, long inExpected, long inTolerance, long * pMax) {
+
+    long lDiff = labs(inGot - inExpected);
+
+    if(lDiff > *pMax) {
+        *pMax = lDiff;
+    }
+
+    if(lDiff > inTolerance) {
+        printf("FAIL %s(0x%08x) = %ld, expected %ld\n", inName, (unsigned)inInput, inGot, inExpected);
+        return 1;
+    }
+
+    return 0;
+}
+
+
+static int check_byte_kernels(void) {
+
+    uint32_t lA;
+    uint32_t lB;
+    uint8_t lR;
+    uint8_t lG;
+    uint8_t lBl;
+    long lMax = 0;
+    int lErrors = 0;
+
+    for(lA = 0; lA < 256; lA++) {
+        for(lB = 0; lB < 256; lB++) {
+
+            lErrors += check("scale8", lA << 8 | lB, scale8(lA, lB), (long)floor(lA * (lB + 1.0) / 256.0), 0, &lMax);
+
+            lR = lG = lBl = (uint8_t)lA;
+            nscale8x3(&lR, &lG, &lBl, (uint8_t)lB);
+            lErrors += check("nscale8x3", lA << 8 | lB, lR | lG << 8 | lBl << 16, scale8(lA, lB) * 0x010101L, 0, &lMax);
+
+            lErrors += check("add8_c", lA << 8 | lB, add8_c(lA, lB), (lA + lB > 255)? 255 : lA + lB, 0, &lMax);
+            lErrors += check("sub8_f", lA << 8 | lB, sub8_f(lA, lB), (lA < lB)? 0 : lA - lB, 0, &lMax);
+        }
+    }
+
+    /* blend8 for every start, end and amount */
+    for(lA = 0; lA < 1u << 24; lA++) {
+
+        uint32_t lFrom   = lA >> 16;
+        uint32_t lTo     = (lA >> 8) & 0xFF;
+        uint32_t lAmount = lA & 0xFF;
+
+        lErrors += check("blend8", lA, blend8(lFrom, lTo, lAmount),
+                         lFrom + (long)floor(((double)lTo - lFrom) * (lAmount + (lAmount >> 7)) / 256.0), 0, &lMax);
+
+        if(lErrors > 10) {
+            break;
+        }
+    }
+
+    printf("scale8, nscale8x3, add8_c, sub8_f, blend8   all inputs, %s\n", lErrors ? "differ" : "bit exact");
+
+    return lErrors;
+}
+
+
+static int check_wide_kernels(void) {
+
+    static const uint32_t lEdges[] = { 0, 1, 2, 3, 255, 256, 65534, 65535, 65536, 65537,
+                                       0x3FFFFFFF, 0x40000000, 0xFFFE0001, 0xFFFE0000, 0xFFFFFFFE, 0xFFFFFFFF };
+    uint32_t lCount;
+    uint32_t lA;
+    uint32_t lB;
+    uint32_t lC;
+    long lMax = 0;
+    int lErrors = 0;
+
+    for(lCount = 0; lCount < sizeof(lEdges) / sizeof(lEdges[0]) + RANDOM_CHECKS && lErrors < 10; lCount++) {
+
+        if(lCount < sizeof(lEdges) / sizeof(lEdges[0])) {
+            lA = lEdges[lCount];
+            lB = lEdges[(lCount * 7) % (sizeof(lEdges) / sizeof(lEdges[0]))];
+            lC = lEdges[(lCount * 5 + 3) % (sizeof(lEdges) / sizeof(lEdges[0]))];
+        } else {
+            lA = next_random();
+            lB = next_random();
+            lC = next_random();
+        }
+
+        lErrors += check("sqrt16", lA, sqrt16(lA), (long)floor(sqrt((double)lA)), 0, &lMax);
+
+        lErrors += check("scale16", lA, scale16((uint16_t)lA, (uint16_t)lB),
+                         (long)floor((uint16_t)lA * ((uint16_t)lB + 1.0) / 65536.0), 0, &lMax);
+
+        lErrors += check("blend16", lA, blend16((uint16_t)lA, (uint16_t)lB, (uint16_t)lC),
+                         (uint16_t)lA + (long)floor(((double)(uint16_t)lB - (uint16_t)lA) *
+                                                    ((uint16_t)lC + ((uint16_t)lC >> 15)) / 65536.0), 0, &lMax);
+    }
+
+    /* every square and its neighbours */
+    for(lCount = 1; lCount < 65536 && lErrors < 10; lCount++) {
+
+        lErrors += check("sqrt16", lCount * lCount,     sqrt16(lCount * lCount),     lCount,     0, &lMax);
+        lErrors += check("sqrt16", lCount * lCount - 1, sqrt16(lCount * lCount - 1), lCount - 1, 0, &lMax);
+    }
+
+    printf("sqrt16, scale16, blend16                    edges and %d random inputs, %s\n", RANDOM_CHECKS,
+           lErrors ? "differ" : "bit exact");
+
+    return lErrors;
+}
+
+
+static int check_trig(void) {
+
+    int32_t lX;
+    int32_t lY;
+    uint32_t lAngle;
+    long lExpected;
+    long lMaxSin16 = 0;
+    long lMaxSin8 = 0;
+    long lMaxAtan2 = 0;
+    int lErrors = 0;
+
+    for(lAngle = 0; lAngle < 65536; lAngle++) {
+        lErrors += check("sin16", lAngle, sin16((uint16_t)lAngle),
+                         lround(32767.0 * sin(lAngle * 2.0 * M_PI / 65536.0)), SIN16_TOLERANCE, &lMaxSin16);
+    }
+
+    for(lAngle = 0; lAngle < 256; lAngle++) {
+        lErrors += check("sin8", lAngle, sin8((uint8_t)lAngle),
+                         lround(128.0 + 127.0 * sin(lAngle * 2.0 * M_PI / 256.0)), 0, &lMaxSin8);
+    }
+
+    for(lY = -2000; lY <= 2000 && lErrors < 10; lY += 7) {
+        for(lX = -2000; lX <= 2000; lX += 3) {
+
+            if(lX == 0 && lY == 0) {
+                continue;
+            }
+
+            lExpected = lround(atan2((double)lY, (double)lX) * 65536.0 / (2.0 * M_PI));
+
+            /* compare on the circle, 65535 is next to 0 */
+            lExpected = atan2_16(lY, lX) + (((lExpected - atan2_16(lY, lX)) % 65536 + 98304) % 65536 - 32768);
+
+            lErrors += check("atan2_16", (uint32_t)(lY << 16 | (lX & 0xFFFF)), atan2_16(lY, lX), lExpected,
+                             ATAN2_TOLERANCE, &lMaxAtan2);
+        }
+    }
+
+    printf("sin8                                        all inputs, %s\n", lMaxSin8 ? "differs" : "bit exact");
+    printf("sin16                                       all inputs, max difference %ld\n", lMaxSin16);
+    printf("atan2_16                                    grid of points, max difference %ld\n", lMaxAtan2);
+
+    return lErrors;
+}
+
+
+static uint32_t run_scale8(void) {
+    uint32_t lSum = 0;
+    size_t lCount;
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+        lSum += scale8((uint8_t)sInA[lCount], (uint8_t)sInB[lCount]);
+    }
+    return lSum;
+}
+
+static float run_scale8_f(void) {
+    float lSum = 0.0f;
+    size_t lCount;
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+        lSum += floorf(sInAF[lCount] * sInBF[lCount]);
+    }
+    return lSum;
+}
+
+static uint32_t run_blend8(void) {
+    uint32_t lSum = 0;
+    size_t lCount;
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+        lSum += blend8((uint8_t)sInA[lCount], (uint8_t)sInB[lCount], (uint8_t)sInC[lCount]);
+    }
+    return lSum;
+}
+
+static float run_blend8_f(void) {
+    float lSum = 0.0f;
+    size_t lCount;
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+        lSum += sInAF[lCount] + (sInBF[lCount] - sInAF[lCount]) * sInCF[lCount];
+    }
+    return lSum;
+}
+
+static uint32_t run_sqrt16(void) {
+    uint32_t lSum = 0;
+    size_t lCount;
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+        lSum += sqrt16(sInA[lCount]);
+    }
+    return lSum;
+}
+
+static float run_sqrt16_f(void) {
+    float lSum = 0.0f;
+    size_t lCount;
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+        lSum += sqrtf(sInAF[lCount]);
+    }
+    return lSum;
+}
+
+static uint32_t run_sin8(void) {
+    uint32_t lSum = 0;
+    size_t lCount;
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+        lSum += sin8((uint8_t)sInA[lCount]);
+    }
+    return lSum;
+}
+
+static uint32_t run_sin16(void) {
+    uint32_t lSum = 0;
+    size_t lCount;
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+        lSum += (uint32_t)sin16((uint16_t)sInA[lCount]);
+    }
+    return lSum;
+}
+
+static float run_sin_f(void) {
+    float lSum = 0.0f;
+    size_t lCount;
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+        lSum += sinf(sInCF[lCount]);
+    }
+    return lSum;
+}
+
+static uint32_t run_atan2_16(void) {
+    uint32_t lSum = 0;
+    size_t lCount;
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+        lSum += atan2_16((int16_t)sInA[lCount], (int16_t)sInB[lCount]);
+    }
+    return lSum;
+}
+
+static float run_atan2_f(void) {
+    float lSum = 0.0f;
+    size_t lCount;
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+        lSum += atan2f(sInAF[lCount] - 32768.0f, sInBF[lCount] - 32768.0f);
+    }
+    return lSum;
+}
+
+
+static const ts_kernel sKernels[] = {
+    { "scale8",   run_scale8,   run_scale8_f, "floorf(a * b)"     },
+    { "blend8",   run_blend8,   run_blend8_f, "a + (b - a) * t"   },
+    { "sqrt16",   run_sqrt16,   run_sqrt16_f, "sqrtf"             },
+    { "sin8",     run_sin8,     run_sin_f,    "sinf"              },
+    { "sin16",    run_sin16,    run_sin_f,    "sinf"              },
+    { "atan2_16", run_atan2_16, run_atan2_f,  "atan2f"            },
+};
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+/*! Time stamp counter, 0 if there is none */
+static uint64_t ticks(void) {
+
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+
+/*! Best ns and ticks per call of a fixed (inFixed) or float kernel */
+static void measure(const ts_kernel * inKernel, int inFixed, uint32_t inCalls, double * outNs, double * outTicks) {
+
+    uint32_t lLoop;
+    int lRun;
+    double lStart;
+    uint64_t lTicks;
+    double lTime;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        lStart = now();
+        lTicks = ticks();
+
+        for(lLoop = 0; lLoop < inCalls / INPUTS; lLoop++) {
+            if(inFixed) {
+                sSink += inKernel->mfFixed();
+            } else {
+                sSinkF += inKernel->mfFloat();
+            }
+        }
+
+        lTicks = ticks() - lTicks;
+        lTime  = (now() - lStart) / (lLoop * INPUTS);
+
+        if(lRun == 0 || lTime < *outNs) {
+            *outNs    = lTime;
+            *outTicks = (double)lTicks / (lLoop * INPUTS);
+        }
+    }
+}
+
+
+int main(int argc, char * argv[]) {
+
+    uint32_t lCalls = 4000000;
+    size_t lCount;
+    int lErrors = 0;
+    double lFixedNs;
+    double lFixedTicks;
+    double lFloatNs;
+    double lFloatTicks;
+
+    if(argc > 1) {
+        lCalls = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lCalls < INPUTS) {
+        printf("Usage: %s [<calls>], at least %d calls\n", argv[0], INPUTS);
+        return -1;
+    }
+
+    lErrors += check_byte_kernels();
+    lErrors += check_wide_kernels();
+    lErrors += check_trig();
+
+    for(lCount = 0; lCount < INPUTS; lCount++) {
+
+        sInA[lCount] = next_random();
+        sInB[lCount] = next_random();
+        sInC[lCount] = next_random();
+
+        sInAF[lCount] = (float)(sInA[lCount] & 0xFFFF);
+        sInBF[lCount] = (float)(sInB[lCount] & 0xFFFF) / 65536.0f;
+        sInCF[lCount] = (float)(sInC[lCount] & 0xFFFF) * (float)(2.0 * M_PI / 65536.0);
+    }
+
+    printf("\nKernel     ns   ticks   float            ns   ticks\n");
+
+    for(lCount = 0; lCount < sizeof(sKernels) / sizeof(sKernels[0]); lCount++) {
+
+        measure(&sKernels[lCount], 1, lCalls, &lFixedNs, &lFixedTicks);
+        measure(&sKernels[lCount], 0, lCalls, &lFloatNs, &lFloatTicks);
+
+        printf("%-8s %5.2f %7.1f   %-15s %5.2f %7.1f\n", sKernels[lCount].mName, lFixedNs, lFixedTicks,
+               sKernels[lCount].mFloatName, lFloatNs, lFloatTicks);
+    }
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+
+/*! Entries of the sine quarter wave, excluding the end point */
+#define SIN16_QUARTER_STEPS     (64)
+
+/*! Entries of the sine wave */
+#define SIN8_STEPS              (256)
+
+/*! Entries of the arc tangent octant, excluding the end point */
+#define ATAN16_OCTANT_STEPS     (64)
+
+/*! Entries of the Q15 sine wave, the largest FFT */
+#define SIN16_WAVE_STEPS        (256)
+
+
+/*! Write the values of a table, 8 or 16 per line */
+static void write_values(FILE * inFile, const long * inValues, int inCount, int inPerLine, int inWidth) {
+
+    int lCount;
+
+    for(lCount = 0; lCount < inCount; lCount++) {
+
+        if(lCount % inPerLine == 0) {
+            fprintf(inFile, "    ");
+        }
+
+        fprintf(inFile, "%*ld,", inWidth, inValues[lCount]);
+
+        if(lCount % inPerLine == inPerLine - 1 || lCount == inCount - 1) {
+            fprintf(inFile, "\n");
+        } else {
+            fprintf(inFile, " ");
+        }
+    }
+}
+
+
+int main(int argc, char * argv[]) {
+
+    FILE * lOutputFile;
+    long lValues[SIN8_STEPS];
+    int lCount;
+
+    if(argc < 2) {
+        printf("Output file missing!\n");
+        return -1;
+    }
+
+    lOutputFile = fopen(argv[1], "w");
+
+    if(!lOutputFile) {
+        perror ("Could not open output file");
+        return -1;
+    }
+
+    fprintf(lOutputFile, "/* generated by tools/mt_tables_gen.c, don't edit */\n");
+    fprintf(lOutputFile, "\n");
+    fprintf(lOutputFile, "#include <stdint.h>\n");
+    fprintf(lOutputFile, "\n");
+    fprintf(lOutputFile, "#include \"mt_tables.h\"\n");
+    fprintf(lOutputFile, "\n");
+
+    /* sin16: first quarter of a sine wave in Q15 */
+    for(lCount = 0; lCount <= SIN16_QUARTER_STEPS; lCount++) {
+        lValues[lCount] = lround(32767.0 * sin(M_PI / 2.0 * lCount / SIN16_QUARTER_STEPS));
+    }
+
+    fprintf(lOutputFile, "\nconst int16_t mt_sin16_quarter[%d] = {\n", SIN16_QUARTER_STEPS + 1);
+    write_values(lOutputFile, lValues, SIN16_QUARTER_STEPS + 1, 8, 5);
+    fprintf(lOutputFile, "};\n\n");
+
+    /* sin8: full sine wave, 128 + 127 * sin */
+    for(lCount = 0; lCount < SIN8_STEPS; lCount++) {
+        lValues[lCount] = lround(128.0 + 127.0 * sin(2.0 * M_PI * lCount / SIN8_STEPS));
+    }
+
+    fprintf(lOutputFile, "\nconst uint8_t mt_sin8[%d] = {\n", SIN8_STEPS);
+    write_values(lOutputFile, lValues, SIN8_STEPS, 16, 3);
+    fprintf(lOutputFile, "};\n\n");
+
+    /* atan16: arc tangent of 0 to 1 in 16 bit angle units */
+    for(lCount = 0; lCount <= ATAN16_OCTANT_STEPS; lCount++) {
+        lValues[lCount] = lround(65536.0 / (2.0 * M_PI) * atan((double)lCount / ATAN16_OCTANT_STEPS));
+    }
+
+    fprintf(lOutputFile, "\nconst uint16_t mt_atan16_octant[%d] = {\n", ATAN16_OCTANT_STEPS + 1);
+    write_values(lOutputFile, lValues, ATAN16_OCTANT_STEPS + 1, 8, 4);
+    fprintf(lOutputFile, "};\n\n");
+
+    /* sin16 wave: full sine wave in Q15, the twiddle factors of the FFT */
+    for(lCount = 0; lCount < SIN16_WAVE_STEPS; lCount++) {
+        lValues[lCount] = lround(32767.0 * sin(2.0 * M_PI * lCount / SIN16_WAVE_STEPS));
+    }
+
+    fprintf(lOutputFile, "\nconst int16_t mt_sin16_wave[%d] = {\n", SIN16_WAVE_STEPS);
+    write_values(lOutputFile, lValues, SIN16_WAVE_STEPS, 8, 6);
+    fprintf(lOutputFile, "};\n\n");
+
+    fprintf(lOutputFile, "\n/* eof */\n");
+
+    fclose(lOutputFile);
+
+    return 0;
+}
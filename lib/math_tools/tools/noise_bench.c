@@ -0,0 +1,284 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "mt_noise.h"
+#include "mt_trig.h"
+
+/*  Checks the integer noise against a float reference and measures it
+
+    Usage: noise_bench [<frames>]
+
+    The float reference interpolates the same lattice values (noise8_3d at
+    whole cells, read once into a table) with a float smoothstep. noise8_3d_row has to match
+    noise8_3d exactly, sin8 is compared with 128 + 127 * sin. The timing
+    renders 5 x 172 frames of 3D noise per pixel, per row and in float,
+    the time is the best of five runs on the host.
+*/
+
+
+/*! Rows of a frame */
+#define ROWS                (5)
+
+/*! Columns of a frame */
+#define COLUMNS             (172)
+
+/*! X and y distance between pixels, 8 pixels per cell like the clouds */
+#define STEP                (32)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+/*! Allowed difference to the float reference, the three lerps truncate */
+#define NOISE_TOLERANCE     (3)
+
+/*! Allowed difference of sin8 to 128 + 127 * sin */
+#define SIN8_TOLERANCE      (1)
+
+
+static uint8_t sFrame[ROWS * COLUMNS];
+
+static float sFrameF[ROWS * COLUMNS];
+
+/*! Lattice values of the float reference, by z, y and x */
+static uint8_t sLattice[256][256][256];
+
+
+/*! Lattice value of a cell, the noise repeats every 256 cells */
+static float lattice(uint32_t inX, uint32_t inY, uint32_t inZ) {
+
+    return sLattice[inZ & 0xFF][inY & 0xFF][inX & 0xFF];
+}
+
+
+static float ease_f(float inT) {
+
+    return inT * inT * (3.0f - 2.0f * inT);
+}
+
+
+static float lerp_f(float inA, float inB, float inT) {
+
+    return inA + (inB - inA) * inT;
+}
+
+
+/*! Float value noise on the lattice of noise8_3d() */
+static float noise_3d_f(float inX, float inY, float inZ) {
+
+    uint32_t lX = (uint32_t)inX;
+    uint32_t lY = (uint32_t)inY;
+    uint32_t lZ = (uint32_t)inZ;
+
+    float lEaseX = ease_f(inX - lX);
+    float lEaseY = ease_f(inY - lY);
+    float lEaseZ = ease_f(inZ - lZ);
+
+    float lLeft  = lerp_f(lerp_f(lattice(lX, lY, lZ),         lattice(lX, lY + 1, lZ),         lEaseY),
+                          lerp_f(lattice(lX, lY, lZ + 1),     lattice(lX, lY + 1, lZ + 1),     lEaseY), lEaseZ);
+    float lRight = lerp_f(lerp_f(lattice(lX + 1, lY, lZ),     lattice(lX + 1, lY + 1, lZ),     lEaseY),
+                          lerp_f(lattice(lX + 1, lY, lZ + 1), lattice(lX + 1, lY + 1, lZ + 1), lEaseY), lEaseZ);
+
+    return lerp_f(lLeft, lRight, lEaseX);
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+static void render_pixel(uint16_t inZ) {
+
+    size_t lRow;
+    size_t lColumn;
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        for(lColumn = 0; lColumn < COLUMNS; lColumn++) {
+            sFrame[lRow * COLUMNS + lColumn] = noise8_3d((uint16_t)(lColumn * STEP), (uint16_t)(lRow * STEP), inZ);
+        }
+    }
+}
+
+
+static void render_row(uint16_t inZ) {
+
+    size_t lRow;
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        noise8_3d_row(&sFrame[lRow * COLUMNS], COLUMNS, 0, STEP, (uint16_t)(lRow * STEP), inZ);
+    }
+}
+
+
+static void render_float(uint16_t inZ) {
+
+    size_t lRow;
+    size_t lColumn;
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        for(lColumn = 0; lColumn < COLUMNS; lColumn++) {
+            sFrameF[lRow * COLUMNS + lColumn] = noise_3d_f(lColumn * STEP / 256.0f, lRow * STEP / 256.0f, inZ / 256.0f);
+        }
+    }
+}
+
+
+/*! Best time of a renderer in ns per frame */
+static double measure(void (* infRender)(uint16_t), uint32_t inFrames) {
+
+    uint32_t lFrame;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        lStart = now();
+
+        for(lFrame = 0; lFrame < inFrames; lFrame++) {
+            infRender((uint16_t)(lFrame * 7));
+        }
+
+        lTime = (now() - lStart) / inFrames;
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+    }
+
+    return lBest;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    uint32_t lFrames = 2000;
+    uint32_t lSeed = 1;
+    uint32_t lCount;
+    uint16_t lX;
+    uint16_t lY;
+    uint16_t lZ;
+    uint16_t lStep;
+    uint8_t lRow[COLUMNS];
+    int lDiff;
+    int lMaxNoise = 0;
+    int lMaxSin = 0;
+    int lErrors = 0;
+    int lRowErrors = 0;
+    double lPixel;
+    double lPerRow;
+    double lFloat;
+
+    if(argc > 1) {
+        lFrames = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lFrames == 0) {
+        printf("Usage: %s [<frames>]\n", argv[0]);
+        return -1;
+    }
+
+    /* the corner of a cell is its lattice value */
+    for(lCount = 0; lCount < 256 * 256 * 256; lCount++) {
+        sLattice[lCount >> 16][(lCount >> 8) & 0xFF][lCount & 0xFF] =
+            noise8_3d((uint16_t)(lCount << 8), (uint16_t)(lCount & 0xFF00), (uint16_t)((lCount >> 8) & 0xFF00));
+    }
+
+    for(lCount = 0; lCount < 1000000; lCount++) {
+
+        lSeed = lSeed * 1664525u + 1013904223u;
+        lX = (uint16_t)(lSeed >> 16);
+        lSeed = lSeed * 1664525u + 1013904223u;
+        lY = (uint16_t)(lSeed >> 16);
+        lSeed = lSeed * 1664525u + 1013904223u;
+        lZ = (uint16_t)(lSeed >> 16);
+
+        lDiff = abs((int)noise8_3d(lX, lY, lZ) - (int)lroundf(noise_3d_f(lX / 256.0f, lY / 256.0f, lZ / 256.0f)));
+
+        if(lDiff > lMaxNoise) {
+            lMaxNoise = lDiff;
+        }
+    }
+
+    if(lMaxNoise > NOISE_TOLERANCE) {
+        lErrors++;
+    }
+
+    printf("noise8_3d     max difference to float %d\n", lMaxNoise);
+
+    /* the row has to give the same values for every step */
+    for(lStep = 1; lStep <= 512; lStep += 3) {
+
+        lSeed = lSeed * 1664525u + 1013904223u;
+        lX = (uint16_t)(lSeed >> 16);
+        lY = (uint16_t)lSeed;
+
+        noise8_3d_row(lRow, COLUMNS, lX, lStep, lY, lStep * 5);
+
+        for(lCount = 0; lCount < COLUMNS; lCount++) {
+
+            if(lRow[lCount] != noise8_3d((uint16_t)(lX + lCount * lStep), lY, (uint16_t)(lStep * 5))) {
+
+                printf("FAIL noise8_3d_row step %u column %u\n", (unsigned)lStep, (unsigned)lCount);
+                lRowErrors++;
+                break;
+            }
+        }
+    }
+
+    printf("noise8_3d_row %s noise8_3d\n", lRowErrors ? "differs from" : "matches");
+
+    lErrors += lRowErrors;
+
+    for(lCount = 0; lCount < 256; lCount++) {
+
+        lDiff = abs((int)sin8((uint8_t)lCount) - (int)lround(128.0 + 127.0 * sin(lCount * 2.0 * M_PI / 256.0)));
+
+        if(lDiff > lMaxSin) {
+            lMaxSin = lDiff;
+        }
+    }
+
+    if(lMaxSin > SIN8_TOLERANCE) {
+        lErrors++;
+    }
+
+    printf("sin8          max difference to float %d\n\n", lMaxSin);
+
+    lPixel  = measure(render_pixel, lFrames);
+    lPerRow = measure(render_row, lFrames);
+    lFloat  = measure(render_float, lFrames);
+
+    printf("%d x %d frame   ns per frame\n", ROWS, COLUMNS);
+    printf("  noise8_3d     %10.0f\n", lPixel);
+    printf("  noise8_3d_row %10.0f\n", lPerRow);
+    printf("  float         %10.0f\n\n", lFloat);
+
+    /* the last frames differ by the rounding only */
+    for(lCount = 0; lCount < ROWS * COLUMNS; lCount++) {
+
+        lDiff = abs((int)sFrame[lCount] - (int)lroundf(sFrameF[lCount]));
+
+        if(lDiff > NOISE_TOLERANCE) {
+            printf("FAIL frame pixel %u\n", (unsigned)lCount);
+            lErrors++;
+            break;
+        }
+    }
+
+    printf("%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
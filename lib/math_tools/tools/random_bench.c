@@ -0,0 +1,342 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "mt_random.h"
+
+/*  Checks the statistics of the random generators and measures them
+
+    Usage: random_bench [<megabytes>]
+
+    PCG32 has to give the values of the reference implementation (seed 42,
+    sequence 54). The bytes of pcg32_fill, pcg32_bounded and
+    pcg32_fill_range are tested with chi square against their expected
+    distribution at 1 % significance, different sequences of the same seed
+    against each other. The throughput is the best of five runs filling
+    <megabytes> MB, next to the former per byte xorshift8 calls.
+*/
+
+
+/*! Bytes per fill call, a panel worth of random bytes */
+#define BLOCK               (1024)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+/*! Samples per bucket of the chi square tests */
+#define SAMPLES             (20000)
+
+
+static uint8_t sBlock[BLOCK];
+
+/*! Sum of the results, keeps the loops from being optimized away */
+static volatile uint32_t sSink;
+
+
+/*! Chi square limit at 1 % significance, Wilson-Hilferty approximation */
+static double chi_square_limit(uint32_t inDegrees) {
+
+    double lK = inDegrees;
+    double lTerm = 1.0 - 2.0 / (9.0 * lK) + 2.326348 * sqrt(2.0 / (9.0 * lK));
+
+    return lK * lTerm * lTerm * lTerm;
+}
+
+
+/*! Chi square of counts against expected counts, prints the result
+
+    \return 1 if above the limit
+*/
+static int chi_square(const char * inName, const uint32_t * inCounts, const double * inExpected, uint32_t inBuckets) {
+
+    double lChi = 0.0;
+    double lLimit = chi_square_limit(inBuckets - 1);
+    uint32_t lCount;
+
+    for(lCount = 0; lCount < inBuckets; lCount++) {
+        lChi += (inCounts[lCount] - inExpected[lCount]) * (inCounts[lCount] - inExpected[lCount]) / inExpected[lCount];
+    }
+
+    printf("%-28s chi square %8.1f, limit %6.1f  %s\n", inName, lChi, lLimit, (lChi > lLimit)? "FAIL" : "ok");
+
+    return lChi > lLimit;
+}
+
+
+static int check_reference(void) {
+
+    static const uint32_t lExpected[] = { 0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e };
+    ts_pcg32 lGenerator;
+    size_t lCount;
+    int lErrors = 0;
+
+    pcg32_seed(&lGenerator, 42, 54);
+
+    for(lCount = 0; lCount < sizeof(lExpected) / sizeof(lExpected[0]); lCount++) {
+        lErrors += (pcg32(&lGenerator) != lExpected[lCount]);
+    }
+
+    printf("%-28s %s\n", "pcg32 reference values", lErrors ? "FAIL" : "ok");
+
+    return lErrors ? 1 : 0;
+}
+
+
+static int check_fill(void) {
+
+    static uint32_t lCounts[256];
+    static double lExpected[256];
+    ts_pcg32 lGenerator;
+    uint32_t lBlock;
+    uint32_t lCount;
+
+    memset(lCounts, 0, sizeof(lCounts));
+    pcg32_seed(&lGenerator, 1, 1);
+
+    /* odd lengths check the tail of the fill too */
+    for(lBlock = 0; lBlock < 256 * SAMPLES / 255; lBlock++) {
+
+        pcg32_fill(&lGenerator, sBlock, 255);
+
+        for(lCount = 0; lCount < 255; lCount++) {
+            lCounts[sBlock[lCount]]++;
+        }
+    }
+
+    for(lCount = 0; lCount < 256; lCount++) {
+        lExpected[lCount] = lBlock * 255.0 / 256.0;
+    }
+
+    return chi_square("pcg32_fill bytes", lCounts, lExpected, 256);
+}
+
+
+static int check_bounded(uint32_t inRange) {
+
+    static uint32_t lCounts[256];
+    static double lExpected[256];
+    char lName[40];
+    ts_pcg32 lGenerator;
+    uint32_t lCount;
+
+    memset(lCounts, 0, sizeof(lCounts));
+    pcg32_seed(&lGenerator, 2, inRange);
+
+    for(lCount = 0; lCount < inRange * SAMPLES; lCount++) {
+        lCounts[pcg32_bounded(&lGenerator, inRange)]++;
+    }
+
+    for(lCount = 0; lCount < inRange; lCount++) {
+        lExpected[lCount] = SAMPLES;
+    }
+
+    snprintf(lName, sizeof(lName), "pcg32_bounded 0 - %u", (unsigned)(inRange - 1));
+
+    return chi_square(lName, lCounts, lExpected, inRange);
+}
+
+
+/*! The range of 256 byte values can't be split evenly, every result is
+    expected as often as bytes map to it */
+static int check_fill_range(uint8_t inMin, uint8_t inMax) {
+
+    static uint32_t lCounts[256];
+    static double lExpected[256];
+    char lName[40];
+    ts_pcg32 lGenerator;
+    uint32_t lRange = (uint32_t)inMax - inMin + 1;
+    uint32_t lBlock;
+    uint32_t lCount;
+    int lErrors = 0;
+
+    memset(lCounts, 0, sizeof(lCounts));
+    memset(lExpected, 0, sizeof(lExpected));
+    pcg32_seed(&lGenerator, 3, inMin);
+
+    for(lBlock = 0; lBlock < (lRange * SAMPLES) / BLOCK + 1; lBlock++) {
+
+        pcg32_fill_range(&lGenerator, sBlock, BLOCK, inMin, inMax);
+
+        for(lCount = 0; lCount < BLOCK; lCount++) {
+
+            if(sBlock[lCount] < inMin || sBlock[lCount] > inMax) {
+                lErrors = 1;
+            }
+
+            lCounts[sBlock[lCount] - inMin]++;
+        }
+    }
+
+    for(lCount = 0; lCount < 256; lCount++) {
+        lExpected[(lCount * lRange) >> 8] += lBlock * (double)BLOCK / 256.0;
+    }
+
+    snprintf(lName, sizeof(lName), "pcg32_fill_range %u - %u", (unsigned)inMin, (unsigned)inMax);
+
+    if(lErrors) {
+        printf("%-28s FAIL, out of range\n", lName);
+        return 1;
+    }
+
+    return chi_square(lName, lCounts, lExpected, lRange);
+}
+
+
+/*! Two sequences of one seed, the same byte at the same position as often as chance */
+static int check_sequences(void) {
+
+    static uint32_t lCounts[2];
+    static double lExpected[2];
+    static uint8_t lOther[BLOCK];
+    ts_pcg32 lFirst;
+    ts_pcg32 lSecond;
+    uint32_t lBlock;
+    uint32_t lCount;
+
+    memset(lCounts, 0, sizeof(lCounts));
+    pcg32_seed(&lFirst, 4, 100);
+    pcg32_seed(&lSecond, 4, 101);
+
+    for(lBlock = 0; lBlock < 256 * SAMPLES / BLOCK; lBlock++) {
+
+        pcg32_fill(&lFirst, sBlock, BLOCK);
+        pcg32_fill(&lSecond, lOther, BLOCK);
+
+        for(lCount = 0; lCount < BLOCK; lCount++) {
+            lCounts[sBlock[lCount] == lOther[lCount]]++;
+        }
+    }
+
+    lExpected[0] = lBlock * (double)BLOCK * 255.0 / 256.0;
+    lExpected[1] = lBlock * (double)BLOCK / 256.0;
+
+    return chi_square("sequences 100 and 101", lCounts, lExpected, 2);
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+static void run_pcg32_fill(ts_pcg32 * pGenerator) {
+
+    pcg32_fill(pGenerator, sBlock, BLOCK);
+}
+
+
+static void run_pcg32_fill_range(ts_pcg32 * pGenerator) {
+
+    pcg32_fill_range(pGenerator, sBlock, BLOCK, 10, 200);
+}
+
+
+static void run_xorshift8(ts_pcg32 * pGenerator) {
+
+    size_t lCount;
+
+    (void)pGenerator;
+
+    for(lCount = 0; lCount < BLOCK; lCount++) {
+        sBlock[lCount] = xorshift8();
+    }
+}
+
+
+static void run_xorshift8_range(ts_pcg32 * pGenerator) {
+
+    size_t lCount;
+
+    (void)pGenerator;
+
+    for(lCount = 0; lCount < BLOCK; lCount++) {
+        sBlock[lCount] = xorshift8_range(10, 200);
+    }
+}
+
+
+/*! Best throughput of a fill in MB/s */
+static double measure(void (* infFill)(ts_pcg32 *), uint32_t inBlocks) {
+
+    ts_pcg32 lGenerator;
+    uint32_t lBlock;
+    int lRun;
+    double lStart;
+    double lRate;
+    double lBest = 0.0;
+
+    pcg32_seed(&lGenerator, 5, 5);
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        lStart = now();
+
+        for(lBlock = 0; lBlock < inBlocks; lBlock++) {
+            infFill(&lGenerator);
+            sSink += sBlock[lBlock % BLOCK];
+        }
+
+        lRate = (double)inBlocks * BLOCK * 1e3 / (now() - lStart);
+
+        if(lRate > lBest) {
+            lBest = lRate;
+        }
+    }
+
+    return lBest;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    uint32_t lMegabytes = 64;
+    uint32_t lBlocks;
+    int lErrors = 0;
+
+    if(argc > 1) {
+        lMegabytes = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lMegabytes == 0) {
+        printf("Usage: %s [<megabytes>]\n", argv[0]);
+        return -1;
+    }
+
+    lErrors += check_reference();
+    lErrors += check_fill();
+    lErrors += check_bounded(10);
+    lErrors += check_bounded(172);
+    lErrors += check_fill_range(0, 255);
+    lErrors += check_fill_range(10, 20);
+    lErrors += check_fill_range(100, 199);
+    lErrors += check_sequences();
+
+    /* the shared state has to move on */
+    if(xorshift64() == xorshift64()) {
+        printf("%-28s FAIL\n", "xorshift64 changes");
+        lErrors++;
+    }
+
+    lBlocks = lMegabytes * (1024 * 1024 / BLOCK);
+
+    printf("\nFill of %d bytes         MB/s\n", BLOCK);
+    printf("  pcg32_fill            %7.0f\n", measure(run_pcg32_fill, lBlocks));
+    printf("  pcg32_fill_range      %7.0f\n", measure(run_pcg32_fill_range, lBlocks));
+    printf("  xorshift8 per byte    %7.0f\n", measure(run_xorshift8, lBlocks));
+    printf("  xorshift8_range       %7.0f\n", measure(run_xorshift8_range, lBlocks));
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
@@ -2,6 +2,7 @@
 #define WS2812_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdio.h>
 
 #include "color.h"
@@ -16,6 +17,86 @@
 
 //------------------------------ structs ------------------------------
 
+/*! Span of columns within one row */
+typedef struct {
+
+    /*! First column */
+    uint16_t    mFirst;
+
+    /*! Column after the last one, the span is empty if it isn't greater than mFirst */
+    uint16_t    mLast;
+
+} ts_ws2812_span;
+
+
+/*!
+    Check if a span is empty
+*/
+static inline bool ws2812_span_empty(const ts_ws2812_span * inSpan) {
+
+    return inSpan->mLast <= inSpan->mFirst;
+}
+
+/*!
+    Make a span empty
+*/
+static inline void ws2812_span_clear(ts_ws2812_span * pSpan) {
+
+    pSpan->mFirst = WS2812_NR_COLUMNS;
+    pSpan->mLast  = 0;
+}
+
+/*!
+    Extend a span to include the columns inFirst to inLast (excluding)
+*/
+static inline void ws2812_span_add(ts_ws2812_span * pSpan, size_t inFirst, size_t inLast) {
+
+    if(inFirst < pSpan->mFirst) {
+        pSpan->mFirst = (uint16_t)inFirst;
+    }
+
+    if(inLast > pSpan->mLast) {
+        pSpan->mLast = (uint16_t)inLast;
+    }
+}
+
+/*!
+    Set the spans of all rows to the whole row
+*/
+static inline void ws2812_spans_full(ts_ws2812_span * pSpans) {
+
+    size_t lRow;
+
+    for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+        pSpans[lRow].mFirst = 0;
+        pSpans[lRow].mLast  = WS2812_NR_COLUMNS;
+    }
+}
+
+/*!
+    Make the spans of all rows empty
+*/
+static inline void ws2812_spans_clear(ts_ws2812_span * pSpans) {
+
+    size_t lRow;
+
+    for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+        ws2812_span_clear(&pSpans[lRow]);
+    }
+}
+
+/*!
+    Repack a color into the order the leds shift it in, 0x00GGRRBB
+
+    A single load and three operations in the XRGB layout.
+*/
+static inline uint32_t ws2812_color_grb(const color * inColor) {
+
+    uint32_t lWord = color_word(inColor);
+
+    return ((lWord << 8) & 0x00FF0000u) | ((lWord >> 8) & 0x0000FF00u) | (lWord & 0x000000FFu);
+}
+
 
 
 // ----------------------------- functions -----------------------------
@@ -30,6 +111,36 @@ void ws2812_init(void);
 */
 void ws2812_updateLED(color * inPanel);
 
+/*!
+    Send some rows to the leds, the other rows keep their colors
+
+    \param[in]  inRows  Bit mask of the rows to send, bit 0 is row 0
+*/
+void ws2812_updateLED_Rows(color * inPanel, uint32_t inRows);
+
+/*!
+    Send the changed part of a panel
+
+    The leds of a row are chained, so a row is sent from its first led up
+    to the end of its span. Rows with an empty span aren't sent at all.
+
+    \param[in]  inSpans     WS2812_NR_ROWS spans of changed leds
+
+    \return the number of leds sent
+*/
+size_t ws2812_updateLED_Spans(color * inPanel, const ts_ws2812_span * inSpans);
+
+/*!
+    Send one strip of colors to every row
+
+    Led (row, column) shows inStrip[(column + inRowOffset[row]) % WS2812_NR_COLUMNS],
+    so a positive offset shifts the row to the left.
+
+    \param[in]  inStrip     WS2812_NR_COLUMNS colors
+    \param[in]  inRowOffset WS2812_NR_ROWS column offsets or NULL for none
+*/
+void ws2812_updateLED_Strip(const color * inStrip, const int16_t * inRowOffset);
+
 // ----------------------------- graphics -----------------------------
 /*!
     Set a led to a specific color
@@ -71,6 +182,24 @@ void ws2812_setLED_Row(color * inPanel, size_t inRow, uint8_t r, uint8_t g, uint
 */
 void ws2812_setLED_All(color * inPanel, uint8_t r, uint8_t g, uint8_t b);
 
+/*!
+    Copy a strip of colors to every row of a panel, see ws2812_updateLED_Strip()
+
+    \param[in]  inStrip     WS2812_NR_COLUMNS colors
+    \param[in]  inRowOffset WS2812_NR_ROWS column offsets or NULL for none
+*/
+void ws2812_setLED_Strip(color * inPanel, const color * inStrip, const int16_t * inRowOffset);
+
+/*!
+    Queue the copies of ws2812_setLED_Strip() to the blit service
+
+    The panel is complete after ws2812_blit_wait(), see ws2812_blit.h.
+
+    \param[in]  inStrip     WS2812_NR_COLUMNS colors, unchanged until the wait
+    \param[in]  inRowOffset WS2812_NR_ROWS column offsets or NULL for none
+*/
+void ws2812_queueLED_Strip(color * inPanel, const color * inStrip, const int16_t * inRowOffset);
+
 /*!
     Get the number of leds in one row
 
@@ -2,11 +2,243 @@
 #define WS2812_ANIM_H_
 
 #include <stdint.h>     // uint8_t
+#include <stdbool.h>
+#include <stddef.h>     // size_t
 #include "color_palette.h"
 
 
-/*! Initialize Animation */
-void ws2812_animation_init(void);
+/*! Enumerates the animations */
+typedef enum {
+
+    /*! Constant color animation */
+    WS2812_ANIMATION_CONSTANT_COLOR = 0,
+
+    /*! Gradient animation */
+    WS2812_ANIMATION_GRADIENT,
+
+    /*! Palette animation */
+    WS2812_ANIMATION_PALETTE,
+
+    /*! Fire animation */
+    WS2812_ANIMATION_FIRE,
+
+    /*! Scrolling text */
+    WS2812_ANIMATION_TEXT,
+
+    /*! Plasma animation */
+    WS2812_ANIMATION_PLASMA,
+
+    /*! Clouds animation */
+    WS2812_ANIMATION_CLOUDS,
+
+    /*! Rainbow animation */
+    WS2812_ANIMATION_RAINBOW,
+
+    /*! Particles animation */
+    WS2812_ANIMATION_PARTICLES,
+
+    /*! Cellular automaton animation */
+    WS2812_ANIMATION_CELLS,
+
+    /*! Uploaded program */
+    WS2812_ANIMATION_PROGRAM,
+
+    /*! Uploaded GIF */
+    WS2812_ANIMATION_GIF,
+
+    /*! Frame sequence from the FAT volume */
+    WS2812_ANIMATION_SEQ,
+
+    /*! Audio visualiser */
+    WS2812_ANIMATION_AUDIO,
+
+    /*! Number of animations */
+    WS2812_ANIMATION_COUNT
+
+} te_ws2812_animations;
+
+
+/*! Enumerates the effects of the particles animation */
+typedef enum {
+
+    /*! Bursts at random places */
+    WS2812_PARTICLES_FIREWORKS = 0,
+
+    /*! Sparks flying up and falling back */
+    WS2812_PARTICLES_SPARKS,
+
+    /*! Drops falling down */
+    WS2812_PARTICLES_RAIN,
+
+    /*! Dots fading out */
+    WS2812_PARTICLES_CONFETTI,
+
+    /*! Number of effects */
+    WS2812_PARTICLES_COUNT
+
+} te_ws2812_particle_effects;
+
+
+/*! Enumerates the rules of the cellular automaton animation */
+typedef enum {
+
+    /*! Conway's Game of Life */
+    WS2812_CELLS_LIFE = 0,
+
+    /*! Falling sand */
+    WS2812_CELLS_SAND,
+
+    /*! Water ripples */
+    WS2812_CELLS_RIPPLE,
+
+    /*! Spreading heat */
+    WS2812_CELLS_HEAT,
+
+    /*! Number of rules */
+    WS2812_CELLS_COUNT
+
+} te_ws2812_cell_rules;
+
+
+/*! Enumerates how the outgoing animation runs during a transition
+
+    Running it live looks best but renders two animations per frame. The
+    snapshot blends from its last frame and costs no rendering at all.
+*/
+typedef enum {
+
+    /*! Keep running at full rate */
+    WS2812_TRANSITION_OUTGOING_LIVE = 0,
+
+    /*! Keep running at half rate */
+    WS2812_TRANSITION_OUTGOING_HALF,
+
+    /*! Keep running at a quarter of the rate */
+    WS2812_TRANSITION_OUTGOING_QUARTER,
+
+    /*! Freeze the last frame */
+    WS2812_TRANSITION_OUTGOING_SNAPSHOT,
+
+} te_ws2812_transition_outgoing;
+
+
+/*! Enumerates the working formats to blend transitions and keyframes in
+
+    With 8 bit every blend rounds its result, low brightness fades show
+    steps. The 16 bit formats blend in color16 and quantise once per frame
+    right before the leds are encoded.
+*/
+typedef enum {
+
+    /*! Blend in 8 bit */
+    WS2812_PRECISION_8BIT = 0,
+
+    /*! Blend in 16 bit, round to the nearest color */
+    WS2812_PRECISION_ROUND,
+
+    /*! Blend in 16 bit, ordered dither over space and time */
+    WS2812_PRECISION_DITHER,
+
+} te_ws2812_precision;
+
+
+/*! Enumerates how a GIF is fit to the canvas */
+typedef enum {
+
+    /*! Stretch the GIF over the canvas */
+    WS2812_GIF_SCALE = 0,
+
+    /*! Show the center of the GIF at its size */
+    WS2812_GIF_CROP,
+
+    /*! Number of modes */
+    WS2812_GIF_FIT_COUNT
+
+} te_ws2812_gif_fit;
+
+
+/*! Enumerates the views of the audio animation */
+typedef enum {
+
+    /*! Bars of the bands from low to high frequencies */
+    WS2812_AUDIO_SPECTRUM = 0,
+
+    /*! Level meter with peak */
+    WS2812_AUDIO_VU,
+
+    /*! The panel flashes with the beats */
+    WS2812_AUDIO_PULSE,
+
+    /*! Number of views */
+    WS2812_AUDIO_VIEW_COUNT
+
+} te_ws2812_audio_view;
+
+
+/*! Number of zones */
+#define WS2812_ZONES_MAX        (4)
+
+
+/*! Number of program slots */
+#define WS2812_PROGRAM_SLOTS    (4)
+
+
+/*! Largest GIF in bytes */
+#define WS2812_GIF_STORE_MAX    (16 * 1024)
+
+
+/*! Longest path of a frame sequence with the terminating 0 */
+#define WS2812_SEQ_PATH_MAX     (32)
+
+
+/*! Animation statistics */
+typedef struct {
+
+    /*! Time in ms from the last command until its first frame was sent */
+    uint32_t    mCommandLatency;
+
+    /*! Worst case of mCommandLatency in ms */
+    uint32_t    mCommandLatencyMax;
+
+    /*! Number of commands replaced by a newer one before they were processed */
+    uint32_t    mCommandsCoalesced;
+
+    /*! Number of frames neither rendered nor sent because they were cached */
+    uint32_t    mFramesSkipped;
+
+    /*! Core cycles spent rendering the last frame, without sending it */
+    uint32_t    mFrameCycles;
+
+    /*! Average core cycles per frame spent rendering the last transition */
+    uint32_t    mTransitionFrameCycles;
+
+    /*! Average core cycles per frame spent rendering the last morph */
+    uint32_t    mMorphFrameCycles;
+
+    /*! Core cycles spent rendering the last keyframe of an interpolated animation */
+    uint32_t    mKeyframeCycles;
+
+    /*! Core cycles the blit DMA saved in the last frame which was sent, estimated by ws2812_blit_saved() */
+    int32_t     mBlitCyclesSaved;
+
+    /*! Core cycles of the last analysis of an audio animation */
+    uint32_t    mAudioCycles;
+
+    /*! Leds changed in the last frame which was sent */
+    uint32_t    mDirtyLeds;
+
+    /*! Leds encoded for the last frame which was sent */
+    uint32_t    mSentLeds;
+
+} ts_ws2812_anim_stats;
+
+
+/*! Initialize Animation
+
+    inSeed seeds the generator of the animation seeds, init_random_seed()
+    reads one from the hardware random generator.
+*/
+void ws2812_animation_init(uint32_t inSeed);
 
 
 /*! This function executes the led animation control
@@ -16,8 +248,49 @@ void ws2812_animation_init(void);
 void ws2812_animation_main(void);
 
 
+/*! Get the animation statistics
+
+    \param[out]  outStats    Filled with the current statistics
+*/
+void ws2812_animation_get_stats(ts_ws2812_anim_stats * outStats);
+
+
+/*! Configure the transition used by the next animation changes
+
+    \param[in]  inDuration  Duration of the transition in ms
+    \param[in]  inOutgoing  How the outgoing animation runs during the transition
+*/
+void ws2812_anim_transition(uint32_t inDuration, te_ws2812_transition_outgoing inOutgoing);
+
+
+/*! Select the render quality of an animation
+
+    Expensive animations (fire) can be rendered at a reduced keyframe rate.
+    The keyframe is rendered in parts over the frames in between, which are
+    blended from the last two keyframes. Interpolation is on by default,
+    switching it off renders every frame in full.
+
+    \param[in]  inAnimation The animation to configure
+    \param[in]  inEnable    true to interpolate, false for full rate rendering
+*/
+void ws2812_anim_interpolation(te_ws2812_animations inAnimation, bool inEnable);
+
+
+/*! Select the working format of transitions and keyframe interpolation
+
+    The 16 bit buffers are allocated on first use. If that fails, blending
+    stays 8 bit. The default is WS2812_PRECISION_8BIT.
+
+    \param[in]  inPrecision Working format
+*/
+void ws2812_anim_precision(te_ws2812_precision inPrecision);
+
+
 /*! This function will switch to constant color mode
 
+    None of the animation switching functions block. A command which was
+    not picked up by the animation task yet is replaced by the new one.
+
     \param[in]  inRed   Red color from 0 to 255
     \param[in]  inGreen Green color from 0 to 255
     \param[in]  inBlue  Blue part from 0 to 255
@@ -36,10 +309,11 @@ void ws2812_anim_const_color(uint8_t inRed, uint8_t inGreen, uint8_t inBlue);
     \param[in]  inSecondBlue    Blue part from 0 to 255
 
     \param[in]  inAngle         Angle in degree
+    \param[in]  inRotation      Rotation speed in degree per second, 0 for a static gradient
 */
 void ws2812_anim_gradient(uint8_t inFirstRed,  uint8_t inFirstGreen,  uint8_t inFirstBlue,
                           uint8_t inSecondRed, uint8_t inSecondGreen, uint8_t inSecondBlue,
-                          int16_t inAngle);
+                          int16_t inAngle, int16_t inRotation);
 
 
 /*! This function will switch to palette mode
@@ -56,6 +330,260 @@ void ws2812_anim_palette(te_color_palettes inPalette);
 void ws2812_anim_fire(te_color_palettes inPalette);
 
 
+/*! This function will switch to the plasma animation
+
+    \param[in]  inPalette   The palette to use
+*/
+void ws2812_anim_plasma(te_color_palettes inPalette);
+
+
+/*! This function will switch to the clouds animation
+
+    \param[in]  inPalette   The palette to use
+*/
+void ws2812_anim_clouds(te_color_palettes inPalette);
+
+
+/*! This function will switch to the rainbow animation
+
+    \param[in]  inSpeed         Hue change in degree per second, 0 for a static rainbow
+    \param[in]  inLength        Columns of one full rainbow, 0 shows a single color
+    \param[in]  inSaturation    Saturation from 0 (white) to 255
+    \param[in]  inValue         Brightness from 0 to 255
+*/
+void ws2812_anim_rainbow(int16_t inSpeed, uint16_t inLength, uint8_t inSaturation, uint8_t inValue);
+
+
+/*! This function will switch to the particles animation
+
+    \param[in]  inEffect    The effect to show
+    \param[in]  inPalette   The palette the particles take their colors from
+*/
+void ws2812_anim_particles(te_ws2812_particle_effects inEffect, te_color_palettes inPalette);
+
+
+/*! This function will switch to the cellular automaton animation
+
+    \param[in]  inRule      The rule to run
+    \param[in]  inPalette   The palette of the cells
+*/
+void ws2812_anim_cells(te_ws2812_cell_rules inRule, te_color_palettes inPalette);
+
+
+/*! Store a program for the program animation
+
+    The program is checked and copied, see ws2812_vm.h for the format.
+    Animations running the slot switch to the new program with the next
+    frame.
+
+    \param[in]  inSlot      Slot, less than WS2812_PROGRAM_SLOTS
+    \param[in]  inProgram   Program
+    \param[in]  inLength    Length of the program in bytes
+
+    \retval true    The program is stored
+    \retval false   Invalid slot or program
+*/
+bool ws2812_program_store(size_t inSlot, const uint8_t * inProgram, size_t inLength);
+
+
+/*! This function will switch to a stored program
+
+    The program computes the color of every led from its position and the
+    time, see tools/shader_to_bc.c.
+
+    \param[in]  inSlot      Slot of the program
+    \param[in]  inPalette   The palette of WS2812_VM_OP_OUT_PAL
+*/
+void ws2812_anim_program(size_t inSlot, te_color_palettes inPalette);
+
+
+/*! Store a part of a GIF for the GIF animation
+
+    A GIF is sent in parts in order, the first one at offset 0. Animations
+    showing the GIF switch to black with the first part and start the new
+    GIF when the last part is stored.
+
+    \param[in]  inOffset    Offset of the part in the GIF
+    \param[in]  inData      Part of the GIF
+    \param[in]  inLength    Length of the part
+    \param[in]  inTotal     Length of the whole GIF, up to WS2812_GIF_STORE_MAX
+
+    \retval true    The part is stored
+    \retval false   The part doesn't follow the last one or the GIF is too large
+*/
+bool ws2812_gif_store(size_t inOffset, const uint8_t * inData, size_t inLength, size_t inTotal);
+
+
+/*! This function will switch to the stored GIF
+
+    The frames are shown with their delays, the GIF repeats.
+
+    \param[in]  inFit       Stretch the GIF over the panel or show its center
+*/
+void ws2812_anim_gif(te_ws2812_gif_fit inFit);
+
+
+#ifdef WS2812_ANIM_SEQ
+
+/*! This function will switch to a frame sequence
+
+    The sequence is played from a file on the FAT volume and repeats,
+    tools/seq_encode.c makes the files. Frames are read ahead by
+    ws2812_seq_loader_main(), which has to run in a task below the
+    animation task.
+
+    \param[in]  inPath      Path of the file, cut to WS2812_SEQ_PATH_MAX - 1 characters
+*/
+void ws2812_anim_seq(const char * inPath);
+
+
+/*! Load frame sequences
+
+    Waits until a sequence animation frees a block and reads the next one
+    from its file. Call it in an endless loop of a task with a lower
+    priority than the animation task.
+*/
+void ws2812_seq_loader_main(void);
+
+#endif /* WS2812_ANIM_SEQ */
+
+
+/*! Feed audio samples to the audio animation
+
+    Only the newest samples are kept, nothing waits for the animation.
+    There must be one caller only, which may be an interrupt.
+
+    \param[in]  inSamples   Interleaved 16 bit PCM samples at 48 kHz
+    \param[in]  inFrames    Number of samples per channel
+    \param[in]  inChannels  Number of channels, mixed down to mono
+*/
+void ws2812_audio_feed(const int16_t * inSamples, size_t inFrames, size_t inChannels);
+
+
+/*! This function will switch to the audio visualiser
+
+    The audio fed by ws2812_audio_feed() is analyzed every frame, see
+    ws2812_audio.h. Without audio the view falls back to black.
+
+    \param[in]  inView      What to show
+    \param[in]  inPalette   The palette of the view
+*/
+void ws2812_anim_audio(te_ws2812_audio_view inView, te_color_palettes inPalette);
+
+
+/*! This function will switch to scrolling text
+
+    The text is drawn in the top rows with a 5 row font. Characters
+    outside of Latin-1 are shown as '?'. Sending a new message while the
+    text scrolls shows it after the current one has scrolled through.
+
+    \param[in]  inText          UTF-8 message, cut to 127 characters
+
+    \param[in]  inRed           Red text color from 0 to 255
+    \param[in]  inGreen         Green text color from 0 to 255
+    \param[in]  inBlue          Blue text color from 0 to 255
+
+    \param[in]  inBackRed       Red background from 0 to 255
+    \param[in]  inBackGreen     Green background from 0 to 255
+    \param[in]  inBackBlue      Blue background from 0 to 255
+
+    \param[in]  inSpeed         Scroll speed in columns per second, 0 shows the text left aligned
+*/
+void ws2812_anim_text(const char * inText,
+                      uint8_t inRed, uint8_t inGreen, uint8_t inBlue,
+                      uint8_t inBackRed, uint8_t inBackGreen, uint8_t inBackBlue,
+                      uint16_t inSpeed);
+
+
+/*! Define a zone
+
+    A zone is a rectangle on top of the main animation with its own
+    animation, rendered every inPeriod ms only. Only the rows of zones
+    which were rendered are sent. A new zone is black.
+
+    \param[in]  inZone      Zone index, less than WS2812_ZONES_MAX
+    \param[in]  inRow       First row
+    \param[in]  inColumn    First column
+    \param[in]  inRows      Number of rows, 0 removes the zone
+    \param[in]  inColumns   Number of columns
+    \param[in]  inPeriod    Time between renders in ms
+
+    \retval true    The zone is set up with the next frame
+    \retval false   Invalid zone or the area is outside of the panel
+*/
+bool ws2812_zone_set(size_t inZone, size_t inRow, size_t inColumn, size_t inRows, size_t inColumns, uint32_t inPeriod);
+
+
+/*! Remove a zone, the main animation shows again
+
+    \param[in]  inZone      Zone index
+*/
+void ws2812_zone_remove(size_t inZone);
+
+
+/*! Switch a zone to constant color, see ws2812_anim_const_color() */
+void ws2812_zone_const_color(size_t inZone, uint8_t inRed, uint8_t inGreen, uint8_t inBlue);
+
+
+/*! Switch a zone to gradient mode, see ws2812_anim_gradient() */
+void ws2812_zone_gradient(size_t inZone,
+                          uint8_t inFirstRed,  uint8_t inFirstGreen,  uint8_t inFirstBlue,
+                          uint8_t inSecondRed, uint8_t inSecondGreen, uint8_t inSecondBlue,
+                          int16_t inAngle, int16_t inRotation);
+
+
+/*! Switch a zone to palette mode, see ws2812_anim_palette() */
+void ws2812_zone_palette(size_t inZone, te_color_palettes inPalette);
+
+
+/*! Switch a zone to the fire animation, see ws2812_anim_fire() */
+void ws2812_zone_fire(size_t inZone, te_color_palettes inPalette);
+
+
+/*! Switch a zone to the plasma animation, see ws2812_anim_plasma() */
+void ws2812_zone_plasma(size_t inZone, te_color_palettes inPalette);
+
+
+/*! Switch a zone to the clouds animation, see ws2812_anim_clouds() */
+void ws2812_zone_clouds(size_t inZone, te_color_palettes inPalette);
+
+
+/*! Switch a zone to the rainbow animation, see ws2812_anim_rainbow() */
+void ws2812_zone_rainbow(size_t inZone, int16_t inSpeed, uint16_t inLength, uint8_t inSaturation, uint8_t inValue);
+
+
+/*! Switch a zone to the particles animation, see ws2812_anim_particles() */
+void ws2812_zone_particles(size_t inZone, te_ws2812_particle_effects inEffect, te_color_palettes inPalette);
+
+
+/*! Switch a zone to the cellular automaton animation, see ws2812_anim_cells() */
+void ws2812_zone_cells(size_t inZone, te_ws2812_cell_rules inRule, te_color_palettes inPalette);
+
+
+/*! Switch a zone to a stored program, see ws2812_anim_program() */
+void ws2812_zone_program(size_t inZone, size_t inSlot, te_color_palettes inPalette);
+
+
+/*! Switch a zone to the stored GIF, see ws2812_anim_gif() */
+void ws2812_zone_gif(size_t inZone, te_ws2812_gif_fit inFit);
+
+#ifdef WS2812_ANIM_SEQ
+/*! Switch a zone to a frame sequence, see ws2812_anim_seq() */
+void ws2812_zone_seq(size_t inZone, const char * inPath);
+#endif /* WS2812_ANIM_SEQ */
+
+
+/*! Switch a zone to the audio visualiser, see ws2812_anim_audio() */
+void ws2812_zone_audio(size_t inZone, te_ws2812_audio_view inView, te_color_palettes inPalette);
+
+
+/*! Switch a zone to scrolling text, see ws2812_anim_text() */
+void ws2812_zone_text(size_t inZone, const char * inText,
+                      uint8_t inRed, uint8_t inGreen, uint8_t inBlue,
+                      uint8_t inBackRed, uint8_t inBackGreen, uint8_t inBackBlue,
+                      uint16_t inSpeed);
+
+
 #endif /* WS2812_ANIM_H_ */
 
 /* eof */
@@ -0,0 +1,87 @@
+#ifndef WS2812_ANIM_AUDIO_H_
+#define WS2812_ANIM_AUDIO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "color.h"              // for color
+#include "color_palette.h"      // for color palettes
+
+#include "ws2812_anim.h"        // for te_ws2812_audio_view
+#include "ws2812_anim_base.h"
+#include "ws2812_audio.h"
+
+
+/*! Analysis of one audio animation, allocated once */
+typedef struct {
+
+    /*! analysis result and state */
+    ts_ws2812_audio                 mAudio;
+
+    /*! newest samples read from the ring */
+    int16_t                         mBlock[WS2812_AUDIO_BLOCK];
+
+} ts_ws2812_anim_audio_analysis;
+
+
+typedef struct {
+
+    /*! base object */
+    ts_ws2812_anim_base             mBase;
+
+    /*! view */
+    te_ws2812_audio_view            mView;
+
+    /*! color palette */
+    te_color_palettes               mPalette;
+
+    /*! palette in use, blended while morphing */
+    ts_color_palette_16             mCurrent;
+
+    /*! palette when the morph started */
+    ts_color_palette_16             mFrom;
+
+    /*! morph progress */
+    ts_ws2812_anim_morph            mMorph;
+
+    /*! analysis */
+    ts_ws2812_anim_audio_analysis * mAnalysis;
+
+    /*! mWritten of the ring at the last read */
+    uint32_t                        mRead;
+
+    /*! palette index of the pulse view, moves on with every beat */
+    uint8_t                         mHue;
+
+} ts_ws2812_anim_audio;
+
+
+typedef struct {
+
+    /*! view */
+    te_ws2812_audio_view            mView;
+
+    /*! color palette */
+    te_color_palettes               mPalette;
+
+} ts_ws2812_anim_param_audio;
+
+
+
+
+/*! Initialize audio animation */
+void ws2812_anim_audio_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+
+/*! Cleanup audio animation */
+void ws2812_anim_audio_clean(tu_ws2812_anim * pThis);
+
+
+/*! Core cycles of the last analysis of an audio animation, 0 before the first one */
+uint32_t ws2812_anim_audio_cycles(void);
+
+
+
+#endif /* WS2812_ANIM_AUDIO_H_ */
+
+/* eof */
@@ -2,7 +2,12 @@
 #define WS2812_ANIM_BASE_H_
 
 
-#include "color.h"                  // for color / color_f
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "color.h"                  // for color
+#include "ws2812.h"                 // for ts_ws2812_span
 #include "ws2812_modifier_obj.h"    // for tu_ws2812_modifier
 
 union u_ws2812_anim;
@@ -15,19 +20,105 @@ struct s_ws2812_anim_base;
 typedef struct s_ws2812_anim_base ts_ws2812_anim_base;
 
 
+/*! The output only depends on the parameters, it is rendered once until they change */
+#define WS2812_ANIM_FLAG_STATIC     (1u << 0)
+
+/*! The parameters changed, the animation has to be rendered again */
+#define WS2812_ANIM_FLAG_DIRTY      (1u << 1)
+
+/*! Every row shows the same colors, the animation renders mStrip instead of mPanel */
+#define WS2812_ANIM_FLAG_STRIP      (1u << 2)
+
+/*! The animation reports the leds it changed in mDirty, otherwise the whole area counts as changed */
+#define WS2812_ANIM_FLAG_SPANS      (1u << 3)
+
+
+/*! Progress of a parameter morph */
+typedef struct {
+
+    /*! Frames done */
+    uint32_t    mFrame;
+
+    /*! Frames to morph over */
+    uint32_t    mFrames;
+
+} ts_ws2812_anim_morph;
+
+
 struct s_ws2812_anim_base {
 
     /*! Process function */
     void     (* mfUpdate)(tu_ws2812_anim * pThis);
 
+    /*! Morph to new parameters of the same animation over a number of frames, NULL if not supported */
+    void     (* mfMorph)(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames);
+
+    /*! Render part inPart of inParts of the next frame, NULL if not supported
+
+        The parts are rendered on consecutive calls, in order. Together
+        they are one update.
+    */
+    void     (* mfUpdatePart)(tu_ws2812_anim * pThis, uint32_t inPart, uint32_t inParts);
+
+    /*! Frames per keyframe if the animation is interpolated */
+    uint32_t    mKeyframeDivider;
+
+    /*! Animation flags, see WS2812_ANIM_FLAG_* */
+    uint32_t    mFlags;
+
+    /*! Rows to render, the panel keeps its row length of WS2812_NR_COLUMNS */
+    size_t      mRows;
+
+    /*! Columns to render */
+    size_t      mColumns;
+
     /*! modifiers */
     tu_ws2812_modifier * mModifier;
 
     /*! panel to paint on */
     color       mPanel[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+
+    /*! strip to paint on if WS2812_ANIM_FLAG_STRIP is set */
+    color       mStrip[WS2812_NR_COLUMNS];
+
+    /*! column offset of each row when the strip is shown */
+    int16_t     mRowOffset[WS2812_NR_ROWS];
+
+    /*! spans changed by the last update if WS2812_ANIM_FLAG_SPANS is set, cleared before each update */
+    ts_ws2812_span mDirty[WS2812_NR_ROWS];
 };
 
 
+/*! Start a morph
+
+    \param[in]  inFrames    Number of frames to morph over
+*/
+static inline void ws2812_anim_morph_start(ts_ws2812_anim_morph * pThis, uint32_t inFrames) {
+
+    pThis->mFrame  = 0;
+    pThis->mFrames = (inFrames > 0)? inFrames : 1;
+}
+
+
+/*! Check if a morph is in progress */
+static inline bool ws2812_anim_morph_active(ts_ws2812_anim_morph * pThis) {
+
+    return pThis->mFrame < pThis->mFrames;
+}
+
+
+/*! Advance a morph by one frame
+
+    \return the amount of the new parameters (0 - 255)
+*/
+static inline uint8_t ws2812_anim_morph_step(ts_ws2812_anim_morph * pThis) {
+
+    pThis->mFrame++;
+
+    return (uint8_t)((pThis->mFrame * 255) / pThis->mFrames);
+}
+
+
 typedef void (*f_ws2812_anim_init)(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
 
 typedef void (*f_ws2812_anim_clean)(tu_ws2812_anim * pThis);
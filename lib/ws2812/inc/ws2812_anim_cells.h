@@ -0,0 +1,87 @@
+#ifndef WS2812_ANIM_CELLS_H_
+#define WS2812_ANIM_CELLS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "color.h"              // for color
+#include "color_palette.h"      // for color palettes
+#include "mt_random.h"          // for ts_pcg32
+
+#include "ws2812_anim.h"        // for te_ws2812_cell_rules
+#include "ws2812_anim_base.h"
+#include "ws2812_cells.h"
+
+
+/*! Level fields of the multi state rules */
+typedef struct {
+
+    /*! current, previous and scratch levels */
+    uint8_t                 mLevels[3][WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+
+} ts_ws2812_anim_cells_levels;
+
+
+typedef struct {
+
+    /*! base object */
+    ts_ws2812_anim_base             mBase;
+
+    /*! rule */
+    te_ws2812_cell_rules            mRule;
+
+    /*! color palette */
+    te_color_palettes               mPalette;
+
+    /*! palette expanded to 256 colors */
+    color                           mColors[256];
+
+    /*! cells of the binary rules, current and next generation */
+    ts_ws2812_cells_row             mBits[2][WS2812_NR_ROWS];
+
+    /*! levels of the multi state rules, allocated once */
+    ts_ws2812_anim_cells_levels   * mField;
+
+    /*! index of the current generation in mBits or mField */
+    size_t                          mCurrent;
+
+    /*! population of the last two generations of Life */
+    size_t                          mPopulation[2];
+
+    /*! generations of Life without change of the population */
+    uint32_t                        mStale;
+
+    /*! frame counter */
+    uint32_t                        mFrame;
+
+    /*! random generator */
+    ts_pcg32                        mRandom;
+
+} ts_ws2812_anim_cells;
+
+
+typedef struct {
+
+    /*! rule */
+    te_ws2812_cell_rules            mRule;
+
+    /*! color palette */
+    te_color_palettes               mPalette;
+
+} ts_ws2812_anim_param_cells;
+
+
+
+
+/*! Initialize cellular automaton animation */
+void ws2812_anim_cells_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+
+/*! Cleanup cellular automaton animation */
+void ws2812_anim_cells_clean(tu_ws2812_anim * pThis);
+
+
+
+#endif /* WS2812_ANIM_CELLS_H_ */
+
+/* eof */
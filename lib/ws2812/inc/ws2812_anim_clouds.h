@@ -0,0 +1,52 @@
+#ifndef WS2812_ANIM_CLOUDS_H_
+#define WS2812_ANIM_CLOUDS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "color.h"              // for color
+#include "color_palette.h"      // for color palettes
+
+#include "ws2812_anim_base.h"
+
+typedef struct {
+
+    /*! base object */
+    ts_ws2812_anim_base     mBase;
+
+    /*! color palette */
+    te_color_palettes       mPalette;
+
+    /*! palette in use, blended while morphing */
+    ts_color_palette_16     mCurrent;
+
+    /*! palette when the morph started */
+    ts_color_palette_16     mFrom;
+
+    /*! morph progress */
+    ts_ws2812_anim_morph    mMorph;
+
+    /*! time, the z coordinate of the noise */
+    uint16_t                mTime;
+
+} ts_ws2812_anim_clouds;
+
+
+typedef struct {
+
+    /*! color palette */
+    te_color_palettes       mPalette;
+
+} ts_ws2812_anim_param_clouds;
+
+
+
+
+/*! Initialize clouds animation, drifting value noise through a palette */
+void ws2812_anim_clouds_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+
+
+#endif /* WS2812_ANIM_CLOUDS_H_ */
+
+/* eof */
@@ -17,6 +17,15 @@ typedef struct {
     /*! color palette */
     te_color_palettes       mPalette;
 
+    /*! palette in use, blended while morphing */
+    ts_color_palette_16     mCurrent;
+
+    /*! palette when the morph started */
+    ts_color_palette_16     mFrom;
+
+    /*! morph progress */
+    ts_ws2812_anim_morph    mMorph;
+
 } ts_ws2812_anim_color_palette;
 
 
@@ -16,6 +16,15 @@ typedef struct {
     /*! constant color */
     color                   mColor;
 
+    /*! color when the morph started */
+    color                   mFrom;
+
+    /*! color to morph to */
+    color                   mTo;
+
+    /*! morph progress */
+    ts_ws2812_anim_morph    mMorph;
+
 } ts_ws2812_anim_const_color;
 
 
@@ -6,6 +6,7 @@
 
 #include "color.h"              // for color
 #include "color_palette.h"      // for color palettes
+#include "mt_random.h"          // for ts_pcg32
 
 #include "ws2812_anim_base.h"
 
@@ -17,9 +18,21 @@ typedef struct {
     /*! color palette */
     te_color_palettes       mPalette;
 
+    /*! palette in use, blended while morphing */
+    ts_color_palette_16     mCurrent;
+
+    /*! palette when the morph started */
+    ts_color_palette_16     mFrom;
+
+    /*! morph progress */
+    ts_ws2812_anim_morph    mMorph;
+
     /*! heat map */
     uint8_t               * mHeat;
 
+    /*! random generator of this fire */
+    ts_pcg32                mRandom;
+
 } ts_ws2812_anim_fire;
 
 
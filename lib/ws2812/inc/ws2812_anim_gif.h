@@ -0,0 +1,73 @@
+#ifndef WS2812_ANIM_GIF_H_
+#define WS2812_ANIM_GIF_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ws2812_anim.h"        // for te_ws2812_gif_fit
+#include "ws2812_anim_base.h"
+#include "ws2812_gif.h"
+
+
+typedef struct {
+
+    /*! base object */
+    ts_ws2812_anim_base     mBase;
+
+    /*! decoder, allocated once */
+    ts_ws2812_gif         * mDecoder;
+
+    /*! the stored GIF */
+    ts_ws2812_gif_memory    mSource;
+
+    /*! version of the store the GIF was opened from */
+    uint32_t                mVersion;
+
+    /*! the GIF is open and has frames */
+    bool                    mValid;
+
+    /*! the area has to be cleared */
+    bool                    mClear;
+
+    /*! fit to the area */
+    te_ws2812_gif_fit       mFit;
+
+    /*! time left of the current frame in 1/100 s */
+    int32_t                 mCountdown;
+
+    /*! time per update in 1/100 s */
+    uint32_t                mStep;
+
+} ts_ws2812_anim_gif;
+
+
+typedef struct {
+
+    /*! fit to the area */
+    te_ws2812_gif_fit       mFit;
+
+    /*! time per update in 1/100 s */
+    uint32_t                mStep;
+
+} ts_ws2812_anim_param_gif;
+
+
+
+
+/*! Initialize GIF animation
+
+    The animation shows the GIF of ws2812_gif_store(). Frames are only
+    decoded when their delay is over, updates in between change and send
+    nothing.
+*/
+void ws2812_anim_gif_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+
+/*! Cleanup GIF animation */
+void ws2812_anim_gif_clean(tu_ws2812_anim * pThis);
+
+
+
+#endif /* WS2812_ANIM_GIF_H_ */
+
+/* eof */
@@ -19,8 +19,38 @@ typedef struct {
     /*! second color */
     color                   mSecondColor;
 
-    /*! angle */
-    int16_t                 mAngle;
+    /*! angle, 65536 is a full circle */
+    uint16_t                mAngle;
+
+    /*! angle increment per frame, 65536 is a full circle */
+    int16_t                 mRotation;
+
+    /*! colors when the morph started */
+    color                   mFromColor[2];
+
+    /*! colors to morph to */
+    color                   mToColor[2];
+
+    /*! rotation when the morph started */
+    int16_t                 mFromRotation;
+
+    /*! rotation to morph to */
+    int16_t                 mToRotation;
+
+    /*! angle change of the morph, the shorter way round */
+    int32_t                 mAngleDelta;
+
+    /*! part of the angle change already applied */
+    int32_t                 mAngleDone;
+
+    /*! morph progress */
+    ts_ws2812_anim_morph    mMorph;
+
+    /*! blended color for each weight */
+    color                   mColorLut[256];
+
+    /*! blend weight of the second color for each led */
+    uint8_t                 mWeight[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
 
 } ts_ws2812_anim_gradient;
 
@@ -33,9 +63,12 @@ typedef struct {
     /*! second color */
     color                   mSecondColor;
 
-    /*! angle */
+    /*! angle in degree */
     int16_t                 mAngle;
 
+    /*! angle increment per frame, 65536 is a full circle */
+    int16_t                 mRotation;
+
 } ts_ws2812_anim_param_gradient;
 
 
@@ -43,7 +76,10 @@ typedef struct {
 
 /*! Initialize gradient color animation
 
-    \param[in]  inColor     The color to show
+    The panel geometry is projected onto the gradient direction once and
+    stored as a per led blend weight. Without rotation the gradient is
+    static, a rotating gradient updates the weights every frame.
+    Colors, angle and rotation can be morphed.
 */
 void ws2812_anim_gradient_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
 
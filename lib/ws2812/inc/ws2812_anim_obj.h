@@ -9,6 +9,16 @@
 #include "ws2812_anim_gradient.h"
 #include "ws2812_anim_color_palette.h"
 #include "ws2812_anim_fire.h"
+#include "ws2812_anim_text.h"
+#include "ws2812_anim_plasma.h"
+#include "ws2812_anim_clouds.h"
+#include "ws2812_anim_rainbow.h"
+#include "ws2812_anim_particles.h"
+#include "ws2812_anim_cells.h"
+#include "ws2812_anim_program.h"
+#include "ws2812_anim_gif.h"
+#include "ws2812_anim_seq.h"
+#include "ws2812_anim_audio.h"
 
 /*! Animation object definition */
 union u_ws2812_anim {
@@ -27,6 +37,36 @@ union u_ws2812_anim {
 
     /*! Fire */
     ts_ws2812_anim_fire             mFire;
+
+    /*! Text */
+    ts_ws2812_anim_text             mText;
+
+    /*! Plasma */
+    ts_ws2812_anim_plasma           mPlasma;
+
+    /*! Clouds */
+    ts_ws2812_anim_clouds           mClouds;
+
+    /*! Rainbow */
+    ts_ws2812_anim_rainbow          mRainbow;
+
+    /*! Particles */
+    ts_ws2812_anim_particles        mParticles;
+
+    /*! Cellular automaton */
+    ts_ws2812_anim_cells            mCells;
+
+    /*! Program */
+    ts_ws2812_anim_program          mProgram;
+
+    /*! GIF */
+    ts_ws2812_anim_gif              mGif;
+
+    /*! Frame sequence */
+    ts_ws2812_anim_seq              mSeq;
+
+    /*! Audio */
+    ts_ws2812_anim_audio            mAudio;
 };
 
 
@@ -44,6 +84,36 @@ union u_ws2812_anim_param {
 
     /*! Parameters for Fire */
     ts_ws2812_anim_param_fire           mFire;
+
+    /*! Parameters for Text */
+    ts_ws2812_anim_param_text           mText;
+
+    /*! Parameters for Plasma */
+    ts_ws2812_anim_param_plasma         mPlasma;
+
+    /*! Parameters for Clouds */
+    ts_ws2812_anim_param_clouds         mClouds;
+
+    /*! Parameters for Rainbow */
+    ts_ws2812_anim_param_rainbow        mRainbow;
+
+    /*! Parameters for Particles */
+    ts_ws2812_anim_param_particles      mParticles;
+
+    /*! Parameters for Cellular automaton */
+    ts_ws2812_anim_param_cells          mCells;
+
+    /*! Parameters for Program */
+    ts_ws2812_anim_param_program        mProgram;
+
+    /*! Parameters for GIF */
+    ts_ws2812_anim_param_gif            mGif;
+
+    /*! Parameters for frame sequence */
+    ts_ws2812_anim_param_seq            mSeq;
+
+    /*! Parameters for audio */
+    ts_ws2812_anim_param_audio          mAudio;
 };
 
 
@@ -2,6 +2,8 @@
 #define WS2812_ANIM_P_H_
 
 
+#include <stdint.h>
+
 #include "FreeRTOS.h"   // for TickType_t
 
 
@@ -11,6 +13,16 @@
 void ws2812_transition_done(void);
 
 
+/*! Get a seed for the random generator of an animation
+
+    The seeds come from a generator which was seeded by the hardware
+    random generator at boot, every call returns a new one.
+
+    \return 32 bit seed
+*/
+uint32_t ws2812_animation_seed(void);
+
+
 
 #endif /* WS2812_ANIM_P_H_ */
 
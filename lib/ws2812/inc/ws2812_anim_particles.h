@@ -0,0 +1,66 @@
+#ifndef WS2812_ANIM_PARTICLES_H_
+#define WS2812_ANIM_PARTICLES_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "color.h"              // for color
+#include "color_palette.h"      // for color palettes
+#include "mt_random.h"          // for ts_pcg32
+
+#include "ws2812_anim.h"        // for te_ws2812_particle_effects
+#include "ws2812_anim_base.h"
+#include "ws2812_particles.h"
+
+
+typedef struct {
+
+    /*! base object */
+    ts_ws2812_anim_base             mBase;
+
+    /*! effect */
+    te_ws2812_particle_effects      mEffect;
+
+    /*! color palette */
+    te_color_palettes               mPalette;
+
+    /*! palette expanded to 256 colors */
+    color                           mColors[256];
+
+    /*! particle pool, allocated once */
+    ts_ws2812_particles           * mPool;
+
+    /*! random generator */
+    ts_pcg32                        mRandom;
+
+    /*! frames until the next burst of fireworks */
+    uint32_t                        mCountdown;
+
+} ts_ws2812_anim_particles;
+
+
+typedef struct {
+
+    /*! effect */
+    te_ws2812_particle_effects      mEffect;
+
+    /*! color palette */
+    te_color_palettes               mPalette;
+
+} ts_ws2812_anim_param_particles;
+
+
+
+
+/*! Initialize particles animation */
+void ws2812_anim_particles_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+
+/*! Cleanup particles animation */
+void ws2812_anim_particles_clean(tu_ws2812_anim * pThis);
+
+
+
+#endif /* WS2812_ANIM_PARTICLES_H_ */
+
+/* eof */
@@ -0,0 +1,78 @@
+#ifndef WS2812_ANIM_PROGRAM_H_
+#define WS2812_ANIM_PROGRAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "color.h"              // for color
+#include "color_palette.h"      // for color palettes
+
+#include "ws2812_anim_base.h"
+#include "ws2812_vm.h"
+
+
+typedef struct {
+
+    /*! base object */
+    ts_ws2812_anim_base     mBase;
+
+    /*! loaded program */
+    ts_ws2812_vm            mVm;
+
+    /*! copy of the program, allocated once */
+    uint32_t              * mCode;
+
+    /*! slot of the program */
+    size_t                  mSlot;
+
+    /*! version of the slot mCode was copied from */
+    uint32_t                mVersion;
+
+    /*! the program in mCode loaded */
+    bool                    mValid;
+
+    /*! color palette */
+    te_color_palettes       mPalette;
+
+    /*! time in seconds, fixed point 16.16 */
+    uint32_t                mTime;
+
+    /*! time per frame, fixed point 16.16 */
+    uint32_t                mTimeStep;
+
+} ts_ws2812_anim_program;
+
+
+typedef struct {
+
+    /*! slot of the program */
+    size_t                  mSlot;
+
+    /*! color palette */
+    te_color_palettes       mPalette;
+
+    /*! time per frame, fixed point 16.16 */
+    uint32_t                mTimeStep;
+
+} ts_ws2812_anim_param_program;
+
+
+
+
+/*! Initialize program animation
+
+    The animation runs the program of a slot, see ws2812_program_store().
+    A program stored while it runs is picked up with the next frame. An
+    empty slot shows black.
+*/
+void ws2812_anim_program_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+
+/*! Cleanup program animation */
+void ws2812_anim_program_clean(tu_ws2812_anim * pThis);
+
+
+
+#endif /* WS2812_ANIM_PROGRAM_H_ */
+
+/* eof */
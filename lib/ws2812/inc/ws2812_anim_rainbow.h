@@ -0,0 +1,83 @@
+#ifndef WS2812_ANIM_RAINBOW_H_
+#define WS2812_ANIM_RAINBOW_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "color.h"             // for color
+
+#include "ws2812_anim_base.h"
+
+
+typedef struct {
+
+    /*! base object */
+    ts_ws2812_anim_base     mBase;
+
+    /*! hue of the first column, 65536 is a full circle */
+    uint16_t                mHue;
+
+    /*! hue change per frame, 65536 is a full circle */
+    int16_t                 mSpeed;
+
+    /*! hue change from one column to the next, 65536 is a full circle */
+    int16_t                 mStep;
+
+    /*! saturation */
+    uint8_t                 mSaturation;
+
+    /*! value */
+    uint8_t                 mValue;
+
+    /*! step when the morph started */
+    int16_t                 mFromStep;
+
+    /*! step to morph to */
+    int16_t                 mToStep;
+
+    /*! saturation and value when the morph started */
+    uint8_t                 mFromSaturation;
+    uint8_t                 mFromValue;
+
+    /*! saturation and value to morph to */
+    uint8_t                 mToSaturation;
+    uint8_t                 mToValue;
+
+    /*! morph progress */
+    ts_ws2812_anim_morph    mMorph;
+
+} ts_ws2812_anim_rainbow;
+
+
+typedef struct {
+
+    /*! hue change per frame, 65536 is a full circle */
+    int16_t                 mSpeed;
+
+    /*! hue change from one column to the next, 65536 is a full circle */
+    int16_t                 mStep;
+
+    /*! saturation */
+    uint8_t                 mSaturation;
+
+    /*! value */
+    uint8_t                 mValue;
+
+} ts_ws2812_anim_param_rainbow;
+
+
+
+
+/*! Initialize rainbow animation
+
+    All rows show the same colors, so only a strip is rendered. A rainbow
+    without speed is static. Step, saturation and value are morphed, the
+    speed changes at once.
+*/
+void ws2812_anim_rainbow_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+
+
+#endif /* WS2812_ANIM_RAINBOW_H_ */
+
+/* eof */
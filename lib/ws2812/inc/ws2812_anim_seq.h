@@ -0,0 +1,71 @@
+#ifndef WS2812_ANIM_SEQ_H_
+#define WS2812_ANIM_SEQ_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ws2812_anim.h"        // for WS2812_SEQ_PATH_MAX
+#include "ws2812_anim_base.h"
+#include "ws2812_seq.h"
+
+
+typedef struct {
+
+    /*! base object */
+    ts_ws2812_anim_base     mBase;
+
+    /*! player and its blocks, allocated once */
+    ts_ws2812_seq         * mSeq;
+
+    /*! file of the sequence */
+    char                    mPath[WS2812_SEQ_PATH_MAX];
+
+    /*! frames are coming */
+    bool                    mValid;
+
+    /*! the area has to be cleared */
+    bool                    mClear;
+
+    /*! time left of the current frame in 1/100 s */
+    int32_t                 mCountdown;
+
+    /*! time per update in 1/100 s */
+    uint32_t                mStep;
+
+} ts_ws2812_anim_seq;
+
+
+typedef struct {
+
+    /*! file of the sequence */
+    char                    mPath[WS2812_SEQ_PATH_MAX];
+
+    /*! time per update in 1/100 s */
+    uint32_t                mStep;
+
+} ts_ws2812_anim_param_seq;
+
+
+
+
+/*! Initialize the sequence animation
+
+    The animation plays a frame sequence from the FAT volume. The file is
+    read by ws2812_seq_loader_main() while frames are shown, only one
+    sequence is loaded at a time.
+*/
+void ws2812_anim_seq_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+
+/*! Cleanup the sequence animation */
+void ws2812_anim_seq_clean(tu_ws2812_anim * pThis);
+
+
+/*! Create the loader semaphores, called by ws2812_animation_init() */
+void ws2812_seq_loader_init(void);
+
+
+
+#endif /* WS2812_ANIM_SEQ_H_ */
+
+/* eof */
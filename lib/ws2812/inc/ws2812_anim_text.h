@@ -0,0 +1,89 @@
+#ifndef WS2812_ANIM_TEXT_H_
+#define WS2812_ANIM_TEXT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "color.h"             // for color
+
+#include "ws2812_anim_base.h"
+
+
+/*! Maximum length of a message including the terminator */
+#define WS2812_ANIM_TEXT_LENGTH     (128)
+
+/*! Blank columns after the message before it starts again */
+#define WS2812_ANIM_TEXT_GAP        (16)
+
+
+typedef struct {
+
+    /*! base object */
+    ts_ws2812_anim_base     mBase;
+
+    /*! message in Latin-1 */
+    char                    mText[WS2812_ANIM_TEXT_LENGTH];
+
+    /*! length of mText */
+    size_t                  mLength;
+
+    /*! message to show when the current one has scrolled through */
+    char                    mNext[WS2812_ANIM_TEXT_LENGTH];
+
+    /*! mNext is valid */
+    bool                    mNextPending;
+
+    /*! text color */
+    color                   mForeground;
+
+    /*! background color */
+    color                   mBackground;
+
+    /*! scroll speed in columns per frame, fixed point 8.8 */
+    uint16_t                mStep;
+
+    /*! fraction of a column scrolled */
+    uint32_t                mPhase;
+
+    /*! character of the next column, mLength while in the gap */
+    size_t                  mChar;
+
+    /*! column within the character or the gap */
+    uint8_t                 mColumn;
+
+    /*! the whole area has to be drawn again */
+    bool                    mRedraw;
+
+    /*! the colors changed, the whole area has to be sent */
+    bool                    mRecolored;
+
+} ts_ws2812_anim_text;
+
+
+typedef struct {
+
+    /*! message in Latin-1 */
+    char                    mText[WS2812_ANIM_TEXT_LENGTH];
+
+    /*! text color */
+    color                   mForeground;
+
+    /*! background color */
+    color                   mBackground;
+
+    /*! scroll speed in columns per frame, fixed point 8.8, 0 shows the text left aligned */
+    uint16_t                mStep;
+
+} ts_ws2812_anim_param_text;
+
+
+
+
+/*! Initialize text animation */
+void ws2812_anim_text_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+
+
+#endif /* WS2812_ANIM_TEXT_H_ */
+
+/* eof */
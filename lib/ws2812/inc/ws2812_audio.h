@@ -0,0 +1,165 @@
+#ifndef WS2812_AUDIO_H_
+#define WS2812_AUDIO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>     // size_t
+
+
+/*  Audio analysis
+
+    PCM samples are mixed down to mono, decimated by WS2812_AUDIO_DECIMATE
+    and written to a ring. Every frame the newest WS2812_AUDIO_BLOCK
+    samples of the ring are analyzed:
+
+    - Spectrum: the block is windowed (Hann), scaled up to full range and
+      transformed by a Q15 FFT. The power of the bins is summed in
+      WS2812_AUDIO_BANDS log spaced bands.
+    - Level: the power of the newest WS2812_AUDIO_LEVEL_SAMPLES samples,
+      so a loud start shows without waiting for the window.
+    - Beat: the power of the lowest bands rising well above its running
+      average.
+
+    All levels are 0 - 255 over WS2812_AUDIO_RANGE dB below full scale.
+    They rise at once and fall by WS2812_AUDIO_FALL per analysis.
+
+    One writer pushes samples, which may be an interrupt, while one reader
+    analyzes them. Nothing here depends on the hardware, the analysis runs
+    on the host with tools/audio_bench.c.
+*/
+
+
+/*! Input samples per analyzed sample */
+#define WS2812_AUDIO_DECIMATE       (2)
+
+/*! Samples per analysis, the FFT size */
+#define WS2812_AUDIO_BLOCK          (256)
+
+/*! Samples kept in the ring, a power of 2 */
+#define WS2812_AUDIO_RING           (1024)
+
+/*! Number of bands of the spectrum */
+#define WS2812_AUDIO_BANDS          (16)
+
+/*! Newest samples of the level */
+#define WS2812_AUDIO_LEVEL_SAMPLES  (64)
+
+/*! Range of the levels in dB */
+#define WS2812_AUDIO_RANGE          (60)
+
+/*! Fall of the levels per analysis */
+#define WS2812_AUDIO_FALL           (6)
+
+/*! Analyses the level peak is held */
+#define WS2812_AUDIO_PEAK_HOLD      (50)
+
+/*! Rise of the bass over its average for a beat, in levels */
+#define WS2812_AUDIO_BEAT_RISE      (32)
+
+/*! Lowest bass level of a beat */
+#define WS2812_AUDIO_BEAT_MIN       (96)
+
+/*! Analyses from one beat to the next at least */
+#define WS2812_AUDIO_BEAT_HOLD      (20)
+
+/*! Fall of the beat pulse per analysis */
+#define WS2812_AUDIO_PULSE_FALL     (12)
+
+
+/*! Ring of mono samples */
+typedef struct {
+
+    /*! Samples, the newest one before mWritten */
+    int16_t             mSamples[WS2812_AUDIO_RING];
+
+    /*! Samples written since the start, wraps around */
+    volatile uint32_t   mWritten;
+
+    /*! Sum of the input samples of the next sample, writer only */
+    int32_t             mSum;
+
+    /*! Input samples in mSum */
+    uint32_t            mSummed;
+
+} ts_ws2812_audio_ring;
+
+
+/*! Result and state of the analysis */
+typedef struct {
+
+    /*! Band levels, lowest band first */
+    uint8_t     mBands[WS2812_AUDIO_BANDS];
+
+    /*! Level */
+    uint8_t     mLevel;
+
+    /*! Highest level of the last WS2812_AUDIO_PEAK_HOLD analyses, then falling */
+    uint8_t     mPeak;
+
+    /*! 255 at a beat, then falling by WS2812_AUDIO_PULSE_FALL */
+    uint8_t     mPulse;
+
+    /*! A beat started with the last analysis */
+    bool        mBeat;
+
+    /*! Number of beats */
+    uint32_t    mBeats;
+
+    /*! Level of the bass of the last analysis */
+    uint8_t     mBass;
+
+    /*! Running average of the bass level, 8.8 fixed point */
+    uint16_t    mBassAverage;
+
+    /*! Analyses since the last beat */
+    uint32_t    mSinceBeat;
+
+    /*! Analyses until the peak falls */
+    uint32_t    mPeakHold;
+
+    /*! FFT data, real and imaginary part of every bin */
+    int16_t     mFft[2 * WS2812_AUDIO_BLOCK];
+
+} ts_ws2812_audio;
+
+
+/*! Empty the ring */
+void ws2812_audio_ring_init(ts_ws2812_audio_ring * pThis);
+
+
+/*! Push PCM samples
+
+    \param[in]  inSamples   Interleaved samples of all channels
+    \param[in]  inFrames    Number of samples per channel
+    \param[in]  inChannels  Number of channels
+*/
+void ws2812_audio_ring_push(ts_ws2812_audio_ring * pThis, const int16_t * inSamples, size_t inFrames, size_t inChannels);
+
+
+/*! Read the newest samples
+
+    \param[out]     outBlock    WS2812_AUDIO_BLOCK samples, oldest first, 0 before the first sample
+    \param[in,out]  pWritten    mWritten of the last read, updated
+
+    \retval true    Samples were pushed since the last read
+    \retval false   No new samples, outBlock is unchanged
+*/
+bool ws2812_audio_ring_read(const ts_ws2812_audio_ring * pThis, int16_t * outBlock, uint32_t * pWritten);
+
+
+/*! Reset the analysis */
+void ws2812_audio_init(ts_ws2812_audio * pThis);
+
+
+/*! Analyze a block
+
+    \param[in]  inBlock     WS2812_AUDIO_BLOCK samples, oldest first, NULL for silence
+*/
+void ws2812_audio_analyze(ts_ws2812_audio * pThis, const int16_t * inBlock);
+
+
+
+
+#endif /* WS2812_AUDIO_H_ */
+
+/* eof */
@@ -0,0 +1,84 @@
+#ifndef WS2812_BLIT_H_
+#define WS2812_BLIT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>     // size_t
+
+#include "color.h"      // for color
+
+
+/*  Blit service
+
+    Copies and fills of panels are queued to a DMA2 stream in memory to
+    memory mode, so the animation task can compute while the buffers move.
+    The jobs run in the order they were queued, ws2812_blit_wait() blocks
+    until all of them are done.
+
+    Jobs which the DMA can't do or which are too small to pay for its
+    setup are done by the CPU right away: less than WS2812_BLIT_MIN_DMA
+    bytes, a buffer in the core coupled memory (the FreeRTOS heap lives
+    there) or a packed RGB fill with different red, green and blue. Jobs
+    queued before a wait therefore must not overlap each other, and their
+    sources must not change until the wait.
+
+    Only the animation task queues jobs. A host build defines
+    WS2812_BLIT_CPU and does every job with the CPU.
+*/
+
+
+/*! Smallest job for the DMA */
+#define WS2812_BLIT_MIN_DMA         (64)
+
+/*! Jobs which can wait for the DMA, one more is queued after a wait */
+#define WS2812_BLIT_QUEUE           (16)
+
+
+/*! Set up the DMA stream */
+void ws2812_blit_init(void);
+
+
+/*! Queue a copy of bytes
+
+    \param[out] outTarget   Where to copy to
+    \param[in]  inSource    Where to copy from, unchanged until the copy is done
+    \param[in]  inBytes     Number of bytes
+*/
+void ws2812_blit_copy(void * outTarget, const void * inSource, size_t inBytes);
+
+
+/*! Queue a fill of colors
+
+    \param[out] outTarget   First color to fill
+    \param[in]  inColor     Color to fill with
+    \param[in]  inCount     Number of colors
+*/
+void ws2812_blit_fill(color * outTarget, const color * inColor, size_t inCount);
+
+
+/*! Wait until all queued jobs are done */
+void ws2812_blit_wait(void);
+
+
+/*! Check for queued jobs
+
+    \retval true    A job is still running
+    \retval false   All jobs are done
+*/
+bool ws2812_blit_busy(void);
+
+
+/*! Get the core cycles the DMA saved since the last call
+
+    The saving is the time the CPU took for the first copy and the first
+    fill of at least WS2812_BLIT_MIN_DMA bytes, scaled to the bytes moved
+    by the DMA, minus the cycles spent queuing them and waiting for them.
+
+    \return estimated core cycles saved, negative if the DMA cost more
+*/
+int32_t ws2812_blit_saved(void);
+
+
+#endif /* WS2812_BLIT_H_ */
+
+/* eof */
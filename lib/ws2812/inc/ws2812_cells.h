@@ -0,0 +1,102 @@
+#ifndef WS2812_CELLS_H_
+#define WS2812_CELLS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>     // size_t
+
+#include "ws2812.h"     // for WS2812_NR_ROWS, WS2812_NR_COLUMNS
+
+
+/*! Words of a bit packed row, bit n of word w is column 32 * w + n */
+#define WS2812_CELLS_WORDS      ((WS2812_NR_COLUMNS + 31) / 32)
+
+
+/*! Binary cells, one bit per cell
+
+    Bits beyond the last column are always 0.
+*/
+typedef uint32_t ts_ws2812_cells_row[WS2812_CELLS_WORDS];
+
+
+/*! Weights of a 3x3 neighbourhood */
+typedef struct {
+
+    /*! Weights, [1][1] is the cell itself */
+    uint8_t     mWeight[3][3];
+
+    /*! The weighted sum is shifted right by this */
+    uint8_t     mShift;
+
+} ts_ws2812_stencil;
+
+
+/*! Check a binary cell */
+static inline bool ws2812_cells_get(const ts_ws2812_cells_row * inRows, size_t inRow, size_t inColumn) {
+
+    return (inRows[inRow][inColumn >> 5] >> (inColumn & 31)) & 1u;
+}
+
+
+/*! Set a binary cell */
+static inline void ws2812_cells_set(ts_ws2812_cells_row * pRows, size_t inRow, size_t inColumn) {
+
+    pRows[inRow][inColumn >> 5] |= 1u << (inColumn & 31);
+}
+
+
+/*! Count the set cells of inCount rows */
+size_t ws2812_cells_count(const ts_ws2812_cells_row * inRows, size_t inCount);
+
+
+/*! Clear the bits beyond the last column of each row */
+void ws2812_cells_mask(ts_ws2812_cells_row * pRows, size_t inRows, size_t inColumns);
+
+
+/*! One generation of Conway's Game of Life
+
+    The 8 neighbours of 32 cells are added at once with bitwise adders. The
+    rows wrap around, the columns beyond the sides are dead.
+
+    \param[out] outRows     Next generation, not the same as inRows
+    \param[in]  inRows      Current generation
+    \param[in]  inCount     Number of rows
+    \param[in]  inColumns   Number of columns
+*/
+void ws2812_cells_life(ts_ws2812_cells_row * outRows, const ts_ws2812_cells_row * inRows, size_t inCount, size_t inColumns);
+
+
+/*! One step of falling sand, in place
+
+    A grain falls if the cell below is free, otherwise it slides down to
+    the left or right. The sides are tried in turn, starting with the left
+    one if inLeftFirst is set. The bottom row is the last one.
+
+    \param[in,out] pRows    Grains
+    \param[in]  inCount     Number of rows
+    \param[in]  inColumns   Number of columns
+    \param[in]  inLeftFirst Try sliding to the left first
+*/
+void ws2812_cells_sand(ts_ws2812_cells_row * pRows, size_t inCount, size_t inColumns, bool inLeftFirst);
+
+
+/*! Apply a 3x3 stencil to a field of levels
+
+    Cells beyond the borders repeat the border cells, sums above 255 are
+    limited to 255.
+
+    \param[out] outCells    New levels, not the same as inCells
+    \param[in]  inCells     Levels
+    \param[in]  inRows      Number of rows
+    \param[in]  inColumns   Number of columns
+    \param[in]  inStride    Cells from one row to the next
+    \param[in]  inStencil   Weights
+*/
+void ws2812_cells_stencil(uint8_t * outCells, const uint8_t * inCells, size_t inRows, size_t inColumns, size_t inStride,
+                          const ts_ws2812_stencil * inStencil);
+
+
+
+#endif /* WS2812_CELLS_H_ */
+
+/* eof */
@@ -0,0 +1,42 @@
+#ifndef WS2812_CYCLES_H_
+#define WS2812_CYCLES_H_
+
+#include <stdint.h>
+
+#include "stm32f4xx.h"  // for CoreDebug
+
+
+/*! DWT control register */
+#define WS2812_DWT_CTRL             (*(volatile uint32_t *)0xE0001000)
+
+/*! DWT cycle counter */
+#define WS2812_DWT_CYCCNT           (*(volatile uint32_t *)0xE0001004)
+
+/*! DWT control: enable the cycle counter */
+#define WS2812_DWT_CTRL_CYCCNTENA   (1u << 0)
+
+
+/*! Enable the core cycle counter */
+static inline void ws2812_cycles_init(void) {
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    WS2812_DWT_CYCCNT = 0;
+    WS2812_DWT_CTRL  |= WS2812_DWT_CTRL_CYCCNTENA;
+}
+
+
+/*! Get the core cycle counter
+
+    Differences are correct across a wrap around.
+
+    \return number of core cycles
+*/
+static inline uint32_t ws2812_cycles(void) {
+
+    return WS2812_DWT_CYCCNT;
+}
+
+
+#endif /* WS2812_CYCLES_H_ */
+
+/* eof */
@@ -0,0 +1,135 @@
+#ifndef WS2812_DRAW_H_
+#define WS2812_DRAW_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>     // size_t
+
+#include "color.h"      // for color
+#include "ws2812_sprite.h"  // for ts_ws2812_sprite
+
+
+/*! Rectangular area of pixels to draw on
+
+    Every primitive is clipped against the canvas once and then writes
+    straight into the pixels, there are no per pixel checks.
+*/
+typedef struct {
+
+    /*! Top left pixel */
+    color     * mPixels;
+
+    /*! Pixels from one row to the next */
+    size_t      mStride;
+
+    /*! Width in pixels */
+    int16_t     mWidth;
+
+    /*! Height in pixels */
+    int16_t     mHeight;
+
+} ts_ws2812_canvas;
+
+
+/*! Set up a canvas
+
+    \param[in]  inPixels    Top left pixel
+    \param[in]  inWidth     Width in pixels
+    \param[in]  inHeight    Height in pixels
+    \param[in]  inStride    Pixels from one row to the next, e.g. WS2812_NR_COLUMNS for a panel
+*/
+static inline void ws2812_canvas_init(ts_ws2812_canvas * pThis, color * inPixels, size_t inWidth, size_t inHeight, size_t inStride) {
+
+    pThis->mPixels = inPixels;
+    pThis->mStride = inStride;
+    pThis->mWidth  = (int16_t)inWidth;
+    pThis->mHeight = (int16_t)inHeight;
+}
+
+
+/*! Get a pixel of a canvas without clipping */
+static inline color * ws2812_canvas_pixel(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY) {
+
+    return &inCanvas->mPixels[(size_t)inY * inCanvas->mStride + (size_t)inX];
+}
+
+
+/*! Draw a horizontal span
+
+    \param[in]  inX         First column
+    \param[in]  inY         Row
+    \param[in]  inLength    Number of pixels to the right
+*/
+void ws2812_draw_hspan(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inLength, const color * inColor);
+
+
+/*! Draw a vertical span
+
+    \param[in]  inX         Column
+    \param[in]  inY         First row
+    \param[in]  inLength    Number of pixels downwards
+*/
+void ws2812_draw_vspan(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inLength, const color * inColor);
+
+
+/*! Draw a filled rectangle
+
+    \param[in]  inX         Left column
+    \param[in]  inY         Top row
+    \param[in]  inWidth     Width in pixels
+    \param[in]  inHeight    Height in pixels
+*/
+void ws2812_draw_rect(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inWidth, int16_t inHeight, const color * inColor);
+
+
+/*! Draw the outline of a rectangle, see ws2812_draw_rect() */
+void ws2812_draw_rect_outline(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inWidth, int16_t inHeight, const color * inColor);
+
+
+/*! Draw a line from (inX0, inY0) to (inX1, inY1), both ends included
+
+    The line is clipped by computing the first and last step within the
+    canvas, the pixels drawn are the same as without clipping.
+*/
+void ws2812_draw_line(const ts_ws2812_canvas * inCanvas, int16_t inX0, int16_t inY0, int16_t inX1, int16_t inY1, const color * inColor);
+
+
+/*! Draw the outline of a circle
+
+    \param[in]  inX         Column of the center
+    \param[in]  inY         Row of the center
+    \param[in]  inRadius    Radius in pixels
+*/
+void ws2812_draw_circle(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inRadius, const color * inColor);
+
+
+/*! Draw a filled circle, see ws2812_draw_circle() */
+void ws2812_draw_circle_filled(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inRadius, const color * inColor);
+
+
+/*! Copy a sprite onto a canvas
+
+    \param[in]  inX         Column of the top left pixel of the sprite
+    \param[in]  inY         Row of the top left pixel of the sprite
+    \param[in]  inSprite    Pixels of the sprite
+    \param[in]  inKey       Color which is transparent, NULL if the sprite is opaque
+*/
+void ws2812_draw_sprite(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const ts_ws2812_canvas * inSprite, const color * inKey);
+
+
+/*! Draw a run length encoded sprite
+
+    The runs are decoded straight into the canvas, runs outside of it are
+    skipped and transparent runs leave the pixels as they are.
+
+    \param[in]  inX         Column of the top left pixel of the sprite
+    \param[in]  inY         Row of the top left pixel of the sprite
+    \param[in]  inSprite    Sprite to draw
+*/
+void ws2812_draw_sprite_rle(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const ts_ws2812_sprite * inSprite);
+
+
+
+#endif /* WS2812_DRAW_H_ */
+
+/* eof */
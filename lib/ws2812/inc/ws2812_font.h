@@ -0,0 +1,51 @@
+#ifndef WS2812_FONT_H_
+#define WS2812_FONT_H_
+
+#include <stdint.h>
+#include <stddef.h>     // size_t
+
+
+/*! Height of the glyphs in rows */
+#define WS2812_FONT_HEIGHT      (5)
+
+/*! Character shown for characters without glyph */
+#define WS2812_FONT_FALLBACK    ('?')
+
+
+/*! Get the width of a glyph
+
+    \param[in]  inChar  Latin-1 character
+
+    \return width in columns without spacing, the width of the fallback if the font has no glyph for it
+*/
+uint8_t ws2812_font_width(uint8_t inChar);
+
+
+/*! Get one column of a glyph
+
+    \param[in]  inChar      Latin-1 character
+    \param[in]  inColumn    Column, less than ws2812_font_width()
+
+    \return the pixels of the column, bit 0 is the top row
+*/
+uint8_t ws2812_font_column(uint8_t inChar, uint8_t inColumn);
+
+
+/*! Convert an UTF-8 string to Latin-1
+
+    Characters outside of Latin-1 and invalid sequences are replaced by
+    WS2812_FONT_FALLBACK.
+
+    \param[out] outText     Latin-1 string, always terminated
+    \param[in]  inSize      Size of outText
+    \param[in]  inText      UTF-8 string
+
+    \return length of outText
+*/
+size_t ws2812_font_from_utf8(char * outText, size_t inSize, const char * inText);
+
+
+
+#endif /* WS2812_FONT_H_ */
+
+/* eof */
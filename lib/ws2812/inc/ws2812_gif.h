@@ -0,0 +1,207 @@
+#ifndef WS2812_GIF_H_
+#define WS2812_GIF_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>     // size_t
+
+#include "color.h"          // for color
+#include "ws2812.h"         // for WS2812_NR_ROWS, WS2812_NR_COLUMNS, ts_ws2812_span
+#include "ws2812_anim.h"    // for te_ws2812_gif_fit
+#include "ws2812_draw.h"    // for ts_ws2812_canvas
+
+
+/*  Streaming GIF decoder
+
+    The GIF is read in small pieces through a callback and every frame is
+    decoded straight onto a canvas, there is no image buffer. The LZW
+    strings are unwound on a stack and written pixel by pixel, pixels
+    which don't reach the canvas are only counted. All memory is in
+    ts_ws2812_gif, a bit over 20 KiB.
+
+    Frames are scaled to the canvas by nearest neighbour or cropped around
+    the center. Transparent pixels keep the canvas, the disposal methods
+    clear the frame to black or restore what was below it. After the last
+    frame the GIF starts over with a black canvas.
+*/
+
+
+/*! Size of the input buffer */
+#define WS2812_GIF_INPUT            (64)
+
+/*! Number of LZW codes */
+#define WS2812_GIF_CODES            (4096)
+
+
+/*! Read the next bytes of a GIF
+
+    \param[in]  pUser       User data of the source
+    \param[out] outData     Bytes read
+    \param[in]  inLength    Number of bytes to read at most
+
+    \return number of bytes read, 0 at the end
+*/
+typedef size_t (*f_ws2812_gif_read)(void * pUser, uint8_t * outData, size_t inLength);
+
+
+/*! Continue reading a GIF at an offset
+
+    \param[in]  pUser       User data of the source
+    \param[in]  inOffset    Offset from the start of the GIF
+
+    \retval true    The next read starts at inOffset
+    \retval false   The offset can't be reached
+*/
+typedef bool (*f_ws2812_gif_seek)(void * pUser, size_t inOffset);
+
+
+/*! GIF in memory, source for ws2812_gif_open() */
+typedef struct {
+
+    /*! Bytes of the GIF */
+    const uint8_t * mData;
+
+    /*! Number of bytes */
+    size_t          mLength;
+
+    /*! Next byte to read */
+    size_t          mPosition;
+
+} ts_ws2812_gif_memory;
+
+
+/*! Decoder state */
+typedef struct {
+
+    /*! Read callback */
+    f_ws2812_gif_read   mfRead;
+
+    /*! Seek callback */
+    f_ws2812_gif_seek   mfSeek;
+
+    /*! User data of the callbacks */
+    void              * mUser;
+
+    /*! Bytes read ahead */
+    uint8_t             mInput[WS2812_GIF_INPUT];
+
+    /*! Next byte in mInput */
+    size_t              mInputPosition;
+
+    /*! Valid bytes in mInput */
+    size_t              mInputLength;
+
+    /*! Offset of the byte after mInput in the GIF */
+    size_t              mOffset;
+
+    /*! Bytes left in the current data sub-block */
+    size_t              mBlockLeft;
+
+    /*! The source ended */
+    bool                mEnd;
+
+    /*! Offset of the first block after the header */
+    size_t              mFirstBlock;
+
+    /*! Frames decoded since the start */
+    uint32_t            mFrames;
+
+    /*! Size of the logical screen */
+    uint16_t            mWidth;
+    uint16_t            mHeight;
+
+    /*! Global and local color table */
+    color               mGlobal[256];
+    color               mLocal[256];
+
+    /*! The GIF has a global color table */
+    bool                mHasGlobal;
+
+    /*! Graphic control of the next frame: delay in 1/100 s, transparent index or -1 and disposal */
+    uint16_t            mDelay;
+    int16_t             mTransparent;
+    uint8_t             mDisposal;
+
+    /*! Disposal of the last frame and the canvas area it covered */
+    uint8_t             mLastDisposal;
+    int16_t             mLastX;
+    int16_t             mLastY;
+    int16_t             mLastWidth;
+    int16_t             mLastHeight;
+
+    /*! Canvas below the last frame for disposal 3 */
+    color               mBackup[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+
+    /*! Fit to the canvas */
+    te_ws2812_gif_fit   mFit;
+
+    /*! Canvas size the samples are computed for */
+    int16_t             mCanvasWidth;
+    int16_t             mCanvasHeight;
+
+    /*! Screen column and row shown by every canvas column and row, 0xFFFF for none */
+    uint16_t            mSampleX[WS2812_NR_COLUMNS];
+    uint16_t            mSampleY[WS2812_NR_ROWS];
+
+    /*! LZW string table, the code of the string without its last index and the last index */
+    uint16_t            mPrefix[WS2812_GIF_CODES];
+    uint8_t             mSuffix[WS2812_GIF_CODES];
+
+    /*! Indices of one string, last first */
+    uint8_t             mStack[WS2812_GIF_CODES];
+
+} ts_ws2812_gif;
+
+
+/*! Open a GIF
+
+    Reads the header and the global color table.
+
+    \param[out] pThis       Decoder
+    \param[in]  infRead     Read callback
+    \param[in]  infSeek     Seek callback, needed to start over
+    \param[in]  pUser       User data of the callbacks
+    \param[in]  inFit       How the frames are fit to the canvas
+
+    \retval true    The source is a GIF
+    \retval false   The source is no GIF or too short
+*/
+bool ws2812_gif_open(ts_ws2812_gif * pThis, f_ws2812_gif_read infRead, f_ws2812_gif_seek infSeek, void * pUser, te_ws2812_gif_fit inFit);
+
+
+/*! Decode the next frame
+
+    Disposes the last frame and draws the next one. After the last frame
+    the canvas is cleared and the first frame follows.
+
+    \param[in]  inCanvas    Canvas to draw on, up to WS2812_NR_ROWS x WS2812_NR_COLUMNS, the same for all frames
+    \param[out] outDirty    Changed columns of every canvas row, may be NULL
+    \param[out] outDelay    Time to show the frame in 1/100 s
+
+    \retval true    A frame was drawn
+    \retval false   The GIF has no frame or is damaged
+*/
+bool ws2812_gif_next_frame(ts_ws2812_gif * pThis, const ts_ws2812_canvas * inCanvas, ts_ws2812_span * outDirty, uint32_t * outDelay);
+
+
+/*! Prepare a GIF in memory
+
+    \param[out] pThis       Source to pass to ws2812_gif_open() as user data
+    \param[in]  inData      GIF, has to stay valid while it is decoded
+    \param[in]  inLength    Number of bytes
+*/
+void ws2812_gif_memory_init(ts_ws2812_gif_memory * pThis, const uint8_t * inData, size_t inLength);
+
+
+/*! Read callback of a GIF in memory */
+size_t ws2812_gif_memory_read(void * pUser, uint8_t * outData, size_t inLength);
+
+
+/*! Seek callback of a GIF in memory */
+bool ws2812_gif_memory_seek(void * pUser, size_t inOffset);
+
+
+
+#endif /* WS2812_GIF_H_ */
+
+/* eof */
@@ -2,7 +2,8 @@
 #define WS2812_MODIFIER_BASE_H_
 
 
-#include "color.h"     // for color / color_f
+#include "color.h"     // for color
+#include "ws2812.h"    // for ts_ws2812_span
 
 union u_ws2812_modifier;
 typedef union u_ws2812_modifier tu_ws2812_modifier;
@@ -15,8 +16,13 @@ typedef union u_ws2812_modifier_param tu_ws2812_modifier_param;
 
 struct s_ws2812_modifier_base {
 
-    /*! Process function */
-    void      (* mfUpdate)(tu_ws2812_modifier * pThis, color * pBasePanel);
+    /*! Process function
+
+        pDirty holds the changed spans of each row of pBasePanel. The
+        modifier only has to process those and extends them by the leds it
+        changed on top.
+    */
+    void      (* mfUpdate)(tu_ws2812_modifier * pThis, color * pBasePanel, ts_ws2812_span * pDirty);
 
     /*! next modifier */
     tu_ws2812_modifier * mModifier;
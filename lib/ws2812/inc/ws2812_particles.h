@@ -0,0 +1,130 @@
+#ifndef WS2812_PARTICLES_H_
+#define WS2812_PARTICLES_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>     // size_t
+
+#include "color.h"          // for color
+#include "ws2812_draw.h"    // for ts_ws2812_canvas
+
+
+/*! Number of particles in a pool, the host bench builds larger pools
+
+    A pool takes 10 bytes per particle from the malloc heap in the 128 KB
+    SRAM. The same heap holds the 15 KB precision buffers, up to two 7.7 KB
+    keyframe buffers, the zone animations and the GIF decoder. A transition
+    between two particle animations holds two pools, 2 x 10 KB with 1000
+    particles against 2 x 2.5 KB with 256. _sbrk_r() grows the heap without
+    a limit check, so an overrun would corrupt RAM instead of making malloc
+    fail. The firmware therefore stays at 256.
+*/
+#ifndef WS2812_PARTICLES_MAX
+#define WS2812_PARTICLES_MAX        (256)
+#endif
+
+/*! Fraction bits of positions and velocities */
+#define WS2812_PARTICLE_SHIFT       (6)
+
+/*! One pixel in particle units */
+#define WS2812_PARTICLE_ONE         (1 << WS2812_PARTICLE_SHIFT)
+
+
+/*! Pool of particles
+
+    Every property is kept in its own array, so a step only walks the
+    arrays it needs. The live particles are always the first mCount
+    entries, a dead one is replaced by the last.
+*/
+typedef struct {
+
+    /*! Number of live particles */
+    size_t      mCount;
+
+    /*! Column in particle units */
+    int16_t     mX[WS2812_PARTICLES_MAX];
+
+    /*! Row in particle units */
+    int16_t     mY[WS2812_PARTICLES_MAX];
+
+    /*! Column change per frame in particle units */
+    int16_t     mVelocityX[WS2812_PARTICLES_MAX];
+
+    /*! Row change per frame in particle units, positive is down */
+    int16_t     mVelocityY[WS2812_PARTICLES_MAX];
+
+    /*! Remaining life, also the brightness, 0 is dead */
+    uint8_t     mLife[WS2812_PARTICLES_MAX];
+
+    /*! Index into the color table */
+    uint8_t     mColor[WS2812_PARTICLES_MAX];
+
+} ts_ws2812_particles;
+
+
+/*! Forces acting on all particles of a pool */
+typedef struct {
+
+    /*! Added to the row velocity every frame */
+    int16_t     mGravity;
+
+    /*! Velocities lose 1 / 2^mDrag every frame, 0 for no drag */
+    uint8_t     mDrag;
+
+    /*! Life lost every frame */
+    uint8_t     mDecay;
+
+} ts_ws2812_particle_forces;
+
+
+/*! Remove all particles */
+static inline void ws2812_particles_clear(ts_ws2812_particles * pThis) {
+
+    pThis->mCount = 0;
+}
+
+
+/*! Add a particle
+
+    \param[in]  inX         Column in particle units
+    \param[in]  inY         Row in particle units
+    \param[in]  inVelocityX Column change per frame in particle units
+    \param[in]  inVelocityY Row change per frame in particle units
+    \param[in]  inLife      Life and brightness, 0 is ignored
+    \param[in]  inColor     Index into the color table
+
+    \retval true    The particle was added
+    \retval false   The pool is full
+*/
+bool ws2812_particles_spawn(ts_ws2812_particles * pThis, int16_t inX, int16_t inY,
+                            int16_t inVelocityX, int16_t inVelocityY, uint8_t inLife, uint8_t inColor);
+
+
+/*! Move all particles by one frame
+
+    Particles which died or left the area to the sides or the bottom are
+    removed. Leaving to the top is allowed, gravity may bring them back.
+
+    \param[in]  inForces    Forces to apply
+    \param[in]  inWidth     Width of the area in pixels
+    \param[in]  inHeight    Height of the area in pixels
+*/
+void ws2812_particles_step(ts_ws2812_particles * pThis, const ts_ws2812_particle_forces * inForces,
+                           int16_t inWidth, int16_t inHeight);
+
+
+/*! Add the particles onto a canvas
+
+    Each particle adds its color scaled by its life to the pixel it is on,
+    the channels saturate at 255.
+
+    \param[in]  inCanvas    Canvas to draw on
+    \param[in]  inColors    Color table with 256 entries
+*/
+void ws2812_particles_render(const ts_ws2812_particles * pThis, const ts_ws2812_canvas * inCanvas, const color * inColors);
+
+
+
+#endif /* WS2812_PARTICLES_H_ */
+
+/* eof */
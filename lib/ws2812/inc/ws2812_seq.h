@@ -0,0 +1,207 @@
+#ifndef WS2812_SEQ_H_
+#define WS2812_SEQ_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>     // size_t
+
+#include "color.h"          // for color
+#include "ws2812.h"         // for WS2812_NR_ROWS, WS2812_NR_COLUMNS, ts_ws2812_span
+#include "ws2812_draw.h"    // for ts_ws2812_canvas
+
+
+/*  Frame sequences
+
+    A sequence holds pre-rendered frames, each stored as the changes to
+    the frame before it. All numbers are little endian.
+
+    Header, WS2812_SEQ_HEADER bytes:
+        "WSQ1", width and height in leds (16 bit each, at most
+        WS2812_NR_COLUMNS x WS2812_NR_ROWS), number of frames (16 bit),
+        6 bytes reserved
+
+    Every frame:
+        delay in 1/100 s (16 bit), length of the operations (16 bit),
+        operations
+
+    The operations walk the leds row by row, the first frame starts from
+    black. The top two bits of an operation give its kind, the low six
+    bits n:
+        00  skip n + 1 leds, they keep their color
+        01  n + 1 leds of the color in the next three bytes (R, G, B)
+        10  n + 1 leds with the colors in the next 3 * (n + 1) bytes
+        11  skip (n << 8 | next byte) + 1 leds
+
+    The sequence is read from a stream of two blocks. A loader fills the
+    free blocks with the file from start to end and over again, while the
+    player decodes frames out of the full ones. After the last frame the
+    header follows again and the canvas is cleared.
+*/
+
+
+/*! Size of the header */
+#define WS2812_SEQ_HEADER           (16)
+
+/*! Size of the frame header */
+#define WS2812_SEQ_FRAME_HEADER     (4)
+
+/*! Largest frame, all leds in literal operations */
+#define WS2812_SEQ_FRAME_MAX        (WS2812_SEQ_FRAME_HEADER + WS2812_NR_ROWS * WS2812_NR_COLUMNS * 3 + \
+                                     (WS2812_NR_ROWS * WS2812_NR_COLUMNS + 63) / 64)
+
+/*! Size of a read-ahead block, a multiple of the sector size so the file
+    system reads whole sectors straight into it */
+#define WS2812_SEQ_BLOCK            (4096)
+
+/*! Operation kinds */
+#define WS2812_SEQ_OP_SKIP          (0x00)
+#define WS2812_SEQ_OP_RUN           (0x40)
+#define WS2812_SEQ_OP_LITERAL       (0x80)
+#define WS2812_SEQ_OP_LONG_SKIP     (0xC0)
+
+
+/*! Read the next bytes of a sequence
+
+    \param[in]  pUser       User data of the source
+    \param[out] outData     Bytes read
+    \param[in]  inLength    Number of bytes to read at most
+
+    \return number of bytes read, 0 at the end or on an error
+*/
+typedef size_t (*f_ws2812_seq_read)(void * pUser, uint8_t * outData, size_t inLength);
+
+
+/*! Continue reading a sequence from its start
+
+    \retval true    The next read starts at the first byte
+    \retval false   The source can't be rewound
+*/
+typedef bool (*f_ws2812_seq_rewind)(void * pUser);
+
+
+/*! Called by the player when it frees a block */
+typedef void (*f_ws2812_seq_wake)(void * pUser);
+
+
+/*! Result of ws2812_seq_next_frame() */
+typedef enum {
+
+    /*! A frame was drawn */
+    WS2812_SEQ_FRAME = 0,
+
+    /*! The loader has not read the frame yet */
+    WS2812_SEQ_WAIT,
+
+    /*! The sequence is damaged */
+    WS2812_SEQ_ERROR
+
+} te_ws2812_seq_result;
+
+
+/*! Two blocks shared by a loader and a player
+
+    A block belongs to the loader while its length is 0 and to the player
+    otherwise, so both sides only hand over blocks and never need a lock.
+    Blocks are filled and read in turn.
+*/
+typedef struct {
+
+    /*! Blocks, 32 bit aligned for the disk driver */
+    uint32_t            mBlock[2][WS2812_SEQ_BLOCK / sizeof(uint32_t)];
+
+    /*! Bytes in every block, 0 while the loader owns it */
+    volatile size_t     mLength[2];
+
+    /*! Block the loader fills next */
+    size_t              mFill;
+
+    /*! Block the player reads */
+    size_t              mRead;
+
+    /*! Next byte in the block the player reads */
+    size_t              mPosition;
+
+    /*! Called when a block is freed */
+    f_ws2812_seq_wake   mfWake;
+
+    /*! User data of mfWake */
+    void              * mWakeUser;
+
+} ts_ws2812_seq_stream;
+
+
+/*! Player state */
+typedef struct {
+
+    /*! Stream the frames are read from */
+    ts_ws2812_seq_stream    mStream;
+
+    /*! Size of the frames */
+    uint16_t                mWidth;
+    uint16_t                mHeight;
+
+    /*! Frames of the sequence */
+    uint16_t                mFrames;
+
+    /*! Next frame, mFrames when the header is next */
+    uint16_t                mFrame;
+
+    /*! Frames which span both blocks are copied here */
+    uint8_t                 mScratch[WS2812_SEQ_FRAME_MAX];
+
+} ts_ws2812_seq;
+
+
+/*! Prepare a player
+
+    Both blocks are free afterwards, the loader has to start reading at
+    the first byte of the sequence.
+
+    \param[out] pThis       Player
+    \param[in]  infWake     Called when a block is freed, may be NULL
+    \param[in]  pWakeUser   User data of infWake
+*/
+void ws2812_seq_init(ts_ws2812_seq * pThis, f_ws2812_seq_wake infWake, void * pWakeUser);
+
+
+/*! Check if the loader can fill a block */
+static inline bool ws2812_seq_stream_free(const ts_ws2812_seq_stream * inStream) {
+
+    return inStream->mLength[inStream->mFill] == 0;
+}
+
+
+/*! Fill the next free block
+
+    Runs in the loader. At the end of the source it is rewound, so the
+    blocks carry the sequence over and over.
+
+    \param[in]  infRead     Read callback
+    \param[in]  infRewind   Rewind callback
+    \param[in]  pUser       User data of the callbacks
+
+    \retval true    A block was filled or none is free
+    \retval false   The source has no data even from its start
+*/
+bool ws2812_seq_stream_fill(ts_ws2812_seq_stream * pThis, f_ws2812_seq_read infRead, f_ws2812_seq_rewind infRewind, void * pUser);
+
+
+/*! Decode the next frame
+
+    Runs in the player.
+
+    \param[in]  inCanvas    Canvas to draw on, the same for all frames
+    \param[out] outDirty    Changed columns of every canvas row, may be NULL
+    \param[out] outDelay    Time to show the frame in 1/100 s
+
+    \retval WS2812_SEQ_FRAME    The frame was drawn
+    \retval WS2812_SEQ_WAIT     Not read yet, the canvas is unchanged
+    \retval WS2812_SEQ_ERROR    The sequence is damaged
+*/
+te_ws2812_seq_result ws2812_seq_next_frame(ts_ws2812_seq * pThis, const ts_ws2812_canvas * inCanvas, ts_ws2812_span * outDirty, uint32_t * outDelay);
+
+
+
+#endif /* WS2812_SEQ_H_ */
+
+/* eof */
@@ -0,0 +1,62 @@
+#ifndef WS2812_SPRITE_H_
+#define WS2812_SPRITE_H_
+
+#include <stdint.h>
+#include <stddef.h>     // size_t
+
+#include "color.h"      // for color
+
+
+/*! Runs of one byte, the high nibble is the length - 1, the low nibble the color index */
+#define WS2812_SPRITE_RLE4              (4)
+
+/*! Runs of two bytes, the length - 1 followed by the color index */
+#define WS2812_SPRITE_RLE8              (8)
+
+/*! Color index of transparent runs in WS2812_SPRITE_RLE4 sprites */
+#define WS2812_SPRITE_TRANSPARENT4      (0x0F)
+
+/*! Color index of transparent runs in WS2812_SPRITE_RLE8 sprites */
+#define WS2812_SPRITE_TRANSPARENT8      (0xFF)
+
+
+/*! Palette indexed, run length encoded sprite
+
+    Sprites are generated by tools/sprite_to_c and stay in flash. Runs
+    never continue into the next row, so every row can be decoded on its
+    own.
+*/
+typedef struct {
+
+    /*! Width in pixels */
+    int16_t             mWidth;
+
+    /*! Height in pixels */
+    int16_t             mHeight;
+
+    /*! Run format, WS2812_SPRITE_RLE4 or WS2812_SPRITE_RLE8 */
+    uint8_t             mFormat;
+
+    /*! Colors of the indices */
+    const color       * mPalette;
+
+    /*! Offset of the first run of each row in mRuns */
+    const uint16_t    * mRows;
+
+    /*! Runs of all rows */
+    const uint8_t     * mRuns;
+
+} ts_ws2812_sprite;
+
+
+/*! Sprites of src/ws2812_sprites.c */
+extern const ts_ws2812_sprite * const gWs2812Sprites[];
+
+/*! Number of entries in gWs2812Sprites */
+extern const size_t gWs2812SpriteCount;
+
+
+
+#endif /* WS2812_SPRITE_H_ */
+
+/* eof */
@@ -1,7 +1,7 @@
 #ifndef WS2812_TRANSITION_BASE_H_
 #define WS2812_TRANSITION_BASE_H_
 
-#include "color.h"     // for color_f
+#include "color.h"     // for color / color16
 
 union u_ws2812_trans;
 typedef union u_ws2812_trans tu_ws2812_trans;
@@ -15,6 +15,9 @@ typedef struct {
     /*! update function */
     void        (* mfUpdate)(tu_ws2812_trans * pThis, color * pAnimationOne, color * pAnimationTwo);
 
+    /*! update function in 16 bit, writes outPanel instead of mPanel, NULL if not supported */
+    void        (* mfUpdate16)(tu_ws2812_trans * pThis, const color16 * inAnimationOne, const color16 * inAnimationTwo, color16 * outPanel);
+
     /*! Panel to paint on */
     color          mPanel[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
 
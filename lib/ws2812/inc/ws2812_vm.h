@@ -0,0 +1,218 @@
+#ifndef WS2812_VM_H_
+#define WS2812_VM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>     // size_t
+
+#include "color.h"              // for color
+#include "color_palette.h"      // for ts_color_palette_16
+
+
+/*  Register machine for per pixel programs
+
+    Values are fixed point 16.16, 1.0 is 65536. A program has three
+    sections of straight code without jumps: the frame section runs once
+    per frame, the row section once per row and the pixel section once per
+    pixel. Values which only depend on the time or the row are computed in
+    the outer sections, so the pixel section only holds what really
+    changes per pixel. The sections end with WS2812_VM_OP_END.
+
+    Registers keep their values between the sections and frames. The first
+    ones are the inputs, followed by the constants of the program.
+
+    An instruction is four bytes: opcode, destination and two sources.
+    Instructions with a third source read it from the destination, output
+    instructions have no destination and read all three sources.
+
+    Program layout, little endian:
+
+        0   magic "WSVM"
+        4   version
+        5   number of constants
+        6   number of frame, row and pixel instructions, 16 bit each
+        12  reserved, 0
+        16  constants, 32 bit each, loaded to WS2812_VM_REG_CONSTANTS up
+        ..  frame, row and pixel instructions
+*/
+
+
+/*! Program version */
+#define WS2812_VM_VERSION           (1)
+
+/*! Size of the program header in bytes */
+#define WS2812_VM_HEADER_SIZE       (16)
+
+/*! Number of registers */
+#define WS2812_VM_REGISTERS         (64)
+
+/*! Largest program in bytes */
+#define WS2812_VM_PROGRAM_MAX       (1024)
+
+/*! Register of the column position, 0 to 1 over the area */
+#define WS2812_VM_REG_X             (0)
+
+/*! Register of the row position, 0 to 1 over the area */
+#define WS2812_VM_REG_Y             (1)
+
+/*! Register of the time in seconds */
+#define WS2812_VM_REG_T             (2)
+
+/*! Register of the column index */
+#define WS2812_VM_REG_COLUMN        (3)
+
+/*! Register of the row index */
+#define WS2812_VM_REG_ROW           (4)
+
+/*! First register of the constants */
+#define WS2812_VM_REG_CONSTANTS     (5)
+
+/*! 1.0 in fixed point 16.16 */
+#define WS2812_VM_ONE               (65536)
+
+
+/*! Enumerates the instructions */
+typedef enum {
+
+    /*! End of a section */
+    WS2812_VM_OP_END = 0,
+
+    /*! d = a */
+    WS2812_VM_OP_MOV,
+
+    /*! d = a + b */
+    WS2812_VM_OP_ADD,
+
+    /*! d = a - b */
+    WS2812_VM_OP_SUB,
+
+    /*! d = a * b */
+    WS2812_VM_OP_MUL,
+
+    /*! d = a / b, saturated on division by 0 */
+    WS2812_VM_OP_DIV,
+
+    /*! d = -a */
+    WS2812_VM_OP_NEG,
+
+    /*! d = |a| */
+    WS2812_VM_OP_ABS,
+
+    /*! d = largest integer not greater than a */
+    WS2812_VM_OP_FLOOR,
+
+    /*! d = a - floor(a) */
+    WS2812_VM_OP_FRACT,
+
+    /*! d = smaller of a and b */
+    WS2812_VM_OP_MIN,
+
+    /*! d = greater of a and b */
+    WS2812_VM_OP_MAX,
+
+    /*! d = a clamped to 0 - 1 */
+    WS2812_VM_OP_SAT,
+
+    /*! d = 1 if b >= a, else 0 */
+    WS2812_VM_OP_STEP,
+
+    /*! d = sine of a, a full circle is 1 */
+    WS2812_VM_OP_SIN,
+
+    /*! d = cosine of a, a full circle is 1 */
+    WS2812_VM_OP_COS,
+
+    /*! d = noise at (a, b) from 0 to 1, one lattice cell is 1 */
+    WS2812_VM_OP_NOISE2,
+
+    /*! d = noise at (a, b, d) */
+    WS2812_VM_OP_NOISE3,
+
+    /*! d = a + (b - a) * d */
+    WS2812_VM_OP_MIX,
+
+    /*! pixel = (a, b, d) as red, green and blue, clamped to 0 - 1 */
+    WS2812_VM_OP_OUT_RGB,
+
+    /*! pixel = (a, b, d) as hue, saturation and value, the hue wraps at 1 */
+    WS2812_VM_OP_OUT_HSV,
+
+    /*! pixel = palette color at a, wraps at 1 */
+    WS2812_VM_OP_OUT_PAL,
+
+    /*! Number of instructions */
+    WS2812_VM_OP_COUNT
+
+} te_ws2812_vm_ops;
+
+
+/*! One instruction */
+typedef struct {
+
+    /*! Opcode, see te_ws2812_vm_ops */
+    uint8_t     mOp;
+
+    /*! Destination register */
+    uint8_t     mDst;
+
+    /*! First source register */
+    uint8_t     mA;
+
+    /*! Second source register */
+    uint8_t     mB;
+
+} ts_ws2812_vm_instr;
+
+
+/*! Loaded program */
+typedef struct {
+
+    /*! Registers */
+    int32_t                     mRegister[WS2812_VM_REGISTERS];
+
+    /*! Frame section */
+    const ts_ws2812_vm_instr  * mFrame;
+
+    /*! Row section */
+    const ts_ws2812_vm_instr  * mRow;
+
+    /*! Pixel section */
+    const ts_ws2812_vm_instr  * mPixel;
+
+    /*! Palette of WS2812_VM_OP_OUT_PAL */
+    const ts_color_palette_16 * mPalette;
+
+} ts_ws2812_vm;
+
+
+/*! Check a program and prepare it to run
+
+    Every instruction is checked once here, so a program can't access
+    anything but its registers and always ends.
+
+    \param[out] pThis       Loaded program
+    \param[in]  inProgram   Program, 32 bit aligned, has to stay valid while it runs
+    \param[in]  inLength    Length of the program in bytes
+    \param[in]  inPalette   Palette of WS2812_VM_OP_OUT_PAL
+
+    \retval true    Program is valid
+    \retval false   Program is damaged or of another version
+*/
+bool ws2812_vm_load(ts_ws2812_vm * pThis, const uint32_t * inProgram, size_t inLength, const ts_color_palette_16 * inPalette);
+
+
+/*! Run a program for one frame
+
+    \param[out] outPanel    Pixels, inRows x inColumns
+    \param[in]  inRows      Number of rows
+    \param[in]  inColumns   Number of columns
+    \param[in]  inStride    Distance of two rows in outPanel
+    \param[in]  inTime      Time in seconds, fixed point 16.16
+*/
+void ws2812_vm_run(ts_ws2812_vm * pThis, color * outPanel, size_t inRows, size_t inColumns, size_t inStride, int32_t inTime);
+
+
+
+#endif /* WS2812_VM_H_ */
+
+/* eof */
@@ -3,6 +3,7 @@
 #include <string.h>
 
 #include "ws2812.h"
+#include "ws2812_blit.h"
 #include "stm32f4xx_gpio.h"
 #include "stm32f4xx_rcc.h"
 #include "stm32f4xx_dma.h"
@@ -39,6 +40,9 @@
 #define TIM4_CH1_ROW_IDX                (1)
 #define TIM4_CH2_ROW_IDX                (4)
 
+/* mask of all rows */
+#define WS2812_ROWS_ALL                 ((1u << WS2812_NR_ROWS) - 1)
+
 
 #define WS2812_PARALLEL_ROW
 #define WS2812_FREERTOS
@@ -82,7 +86,14 @@ static const ts_skip_leds sSkipRow3 = {
     .mSkipLen = 6,
 };
 
-static color * sUpdatePanel = NULL;
+/*! First led of each row in the buffer being sent */
+static const color * sUpdateRow[WS2812_NR_ROWS];
+
+/*! Column offset of each row in the buffer being sent */
+static size_t sUpdateOffset[WS2812_NR_ROWS];
+
+/*! Number of leds sent of each row, the rest keeps its latched colors */
+static size_t sUpdateEnd[WS2812_NR_ROWS];
 
 static const ts_led_panel sLedPanel[WS2812_NR_ROWS] = {
     {
@@ -139,6 +150,14 @@ static inline size_t isLedSkipped(size_t inLedRow, size_t inLedColumn) {
     return 0;
 }
 
+/*! Normalize a column offset to 0 .. WS2812_NR_COLUMNS - 1 */
+static inline size_t ws2812_normalizeOffset(int32_t inOffset) {
+
+    inOffset %= WS2812_NR_COLUMNS;
+
+    return (inOffset < 0)? (size_t)(inOffset + WS2812_NR_COLUMNS) : (size_t)inOffset;
+}
+
 void ws2812_setLED(color * inPanel, size_t inRow, size_t inColumn, uint8_t r, uint8_t g, uint8_t b) {
 
     assert_param(inRow < WS2812_NR_ROWS);
@@ -149,9 +168,7 @@ void ws2812_setLED(color * inPanel, size_t inRow, size_t inColumn, uint8_t r, ui
         return;
     }
 
-    inPanel[sLedPanel[inRow].mLeds + inColumn].R = r;
-    inPanel[sLedPanel[inRow].mLeds + inColumn].G = g;
-    inPanel[sLedPanel[inRow].mLeds + inColumn].B = b;
+    color_set_word(&inPanel[sLedPanel[inRow].mLeds + inColumn], ((uint32_t)r << 16) | ((uint32_t)g << 8) | b);
 }
 
 void ws2812_setLED_Column(color * inPanel, size_t inColumn, uint8_t r, uint8_t g, uint8_t b) {
@@ -178,6 +195,7 @@ void ws2812_setLED_All(color * inPanel, uint8_t r, uint8_t g, uint8_t b){
 
     size_t lRowCount;
     size_t lColumnCount;
+    uint32_t lWord = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
 
     for(lRowCount = 0; lRowCount < WS2812_NR_ROWS; lRowCount++) {
         for(lColumnCount = 0; lColumnCount < WS2812_NR_COLUMNS; lColumnCount++) {
@@ -186,14 +204,41 @@ void ws2812_setLED_All(color * inPanel, uint8_t r, uint8_t g, uint8_t b){
             lColumnCount += isLedSkipped(lRowCount, lColumnCount);
 
             if(lColumnCount < WS2812_NR_COLUMNS) {
-                inPanel[sLedPanel[lRowCount].mLeds + lColumnCount].R = r;
-                inPanel[sLedPanel[lRowCount].mLeds + lColumnCount].G = g;
-                inPanel[sLedPanel[lRowCount].mLeds + lColumnCount].B = b;
+                color_set_word(&inPanel[sLedPanel[lRowCount].mLeds + lColumnCount], lWord);
             }
         }
     }
 }
 
+void ws2812_setLED_Strip(color * inPanel, const color * inStrip, const int16_t * inRowOffset) {
+
+    size_t lRow;
+    size_t lOffset;
+
+    for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+
+        lOffset = (inRowOffset != NULL)? ws2812_normalizeOffset(inRowOffset[lRow]) : 0;
+
+        /* the row is the strip rotated left by the offset */
+        memcpy(&inPanel[sLedPanel[lRow].mLeds], &inStrip[lOffset], (WS2812_NR_COLUMNS - lOffset) * sizeof(color));
+        memcpy(&inPanel[sLedPanel[lRow].mLeds + WS2812_NR_COLUMNS - lOffset], inStrip, lOffset * sizeof(color));
+    }
+}
+
+void ws2812_queueLED_Strip(color * inPanel, const color * inStrip, const int16_t * inRowOffset) {
+
+    size_t lRow;
+    size_t lOffset;
+
+    for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+
+        lOffset = (inRowOffset != NULL)? ws2812_normalizeOffset(inRowOffset[lRow]) : 0;
+
+        ws2812_blit_copy(&inPanel[sLedPanel[lRow].mLeds], &inStrip[lOffset], (WS2812_NR_COLUMNS - lOffset) * sizeof(color));
+        ws2812_blit_copy(&inPanel[sLedPanel[lRow].mLeds + WS2812_NR_COLUMNS - lOffset], inStrip, lOffset * sizeof(color));
+    }
+}
+
 size_t ws2812_getLED_PanelNumberOfRows(void) {
 
     return WS2812_NR_ROWS;
@@ -637,7 +682,6 @@ static inline size_t incrementBufferIndex(size_t inBufferIndex) {
 static inline void fillBuffer(size_t inRow) {
 
     size_t lCount;
-    size_t lBitMask;
     size_t lBitIndex;
     size_t lIndex;
 
@@ -646,9 +690,8 @@ static inline void fillBuffer(size_t inRow) {
     /* avoid access to volatile variables */
     size_t lDmaBufferIndexCache = sLedDMA[inRow].mDmaBufferIndex;
 
-    uint16_t * lGreenPtr = &sLedDMA[inRow].mDmaBuffer[lDmaBufferIndexCache * DMA_DOUBLE_BUFFER_SIZE];
-    uint16_t * lRedPtr   = &sLedDMA[inRow].mDmaBuffer[lDmaBufferIndexCache * DMA_DOUBLE_BUFFER_SIZE +  8];
-    uint16_t * lBluePtr  = &sLedDMA[inRow].mDmaBuffer[lDmaBufferIndexCache * DMA_DOUBLE_BUFFER_SIZE + 16];
+    /* green, red and blue bits of a led follow each other */
+    uint16_t * lLedPtr = &sLedDMA[inRow].mDmaBuffer[lDmaBufferIndexCache * DMA_DOUBLE_BUFFER_SIZE];
 
     /* fill whole buffer */
     for(lCount = 0; lCount < DMA_DOUBLE_BUFFER_NUM_LEDS; lCount++) {
@@ -659,49 +702,33 @@ static inline void fillBuffer(size_t inRow) {
         lIndex += isLedSkipped(inRow, lIndex);
 
         /* check if index is still in range */
-        if(lIndex < WS2812_NR_COLUMNS) {
-
-            color lColor;
-            lColor.R = sUpdatePanel[sLedPanel[inRow].mLeds + lIndex].R;
-            lColor.G = sUpdatePanel[sLedPanel[inRow].mLeds + lIndex].G;
-            lColor.B = sUpdatePanel[sLedPanel[inRow].mLeds + lIndex].B;
-
-            /* decode colors to pwm duty cycles */
-            for(lBitMask = 0x80, lBitIndex = 0; lBitMask != 0; lBitMask >>= 1, lBitIndex++) {
-
-                if((lColor.R & lBitMask) != 0) {
-                    lRedPtr[lBitIndex] = WS2812_PWM_ONE;
-                } else {
-                    lRedPtr[lBitIndex] = WS2812_PWM_ZERO;
-                }
-
-                if((lColor.G & lBitMask) != 0) {
-                    lGreenPtr[lBitIndex] = WS2812_PWM_ONE;
-                } else {
-                    lGreenPtr[lBitIndex] = WS2812_PWM_ZERO;
-                }
-
-                if((lColor.B & lBitMask) != 0) {
-                    lBluePtr[lBitIndex] = WS2812_PWM_ONE;
-                } else {
-                    lBluePtr[lBitIndex] = WS2812_PWM_ZERO;
-                }
+        if(lIndex < sUpdateEnd[inRow]) {
+
+            uint32_t lGrb;
+            size_t lColumn = lIndex + sUpdateOffset[inRow];
+
+            /* a shifted row wraps around */
+            if(lColumn >= WS2812_NR_COLUMNS) {
+                lColumn -= WS2812_NR_COLUMNS;
+            }
+
+            lGrb = ws2812_color_grb(&sUpdateRow[inRow][lColumn]);
+
+            /* decode colors to pwm duty cycles, most significant bit first */
+            for(lBitIndex = 0; lBitIndex < SIZE_OF_LED; lBitIndex++, lGrb <<= 1) {
+                lLedPtr[lBitIndex] = (lGrb & 0x00800000u)? WS2812_PWM_ONE : WS2812_PWM_ZERO;
             }
 
         } else {
 
             /* fill with zeroes */
-            for(lBitIndex = 0; lBitIndex < 8; lBitIndex++) {
-                lRedPtr[lBitIndex] = 0;
-                lGreenPtr[lBitIndex] = 0;
-                lBluePtr[lBitIndex] = 0;
+            for(lBitIndex = 0; lBitIndex < SIZE_OF_LED; lBitIndex++) {
+                lLedPtr[lBitIndex] = 0;
             }
         }
 
-        /* jump over other colors */
-        lGreenPtr += SIZE_OF_LED;
-        lRedPtr   += SIZE_OF_LED;
-        lBluePtr  += SIZE_OF_LED;
+        /* next led of the buffer */
+        lLedPtr += SIZE_OF_LED;
 
         /* next led */
         sLedDMA[inRow].mDmaColumnIndex = lIndex + 1;
@@ -710,15 +737,23 @@ static inline void fillBuffer(size_t inRow) {
     sLedDMA[inRow].mDmaBufferIndex = incrementBufferIndex(lDmaBufferIndexCache);
 }
 
-void ws2812_updateLED(color * inPanel){
+/*!
+    Send the rows set up in sUpdateRow and sUpdateOffset
 
-    size_t lRow;
+    \param[in]  inRows  Bit mask of the rows to send
+*/
+static void ws2812_update(uint32_t inRows) {
 
-    sUpdatePanel = inPanel;
+    size_t lRow;
 
     /* iterate over all rows */
     for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
 
+        /* other rows keep showing what they latched */
+        if(!(inRows & (1u << lRow))) {
+            continue;
+        }
+
         /* initialize global variables */
         sLedDMA[lRow].mDmaBufferIndex = 0;
         sLedDMA[lRow].mDmaColumnIndex = 0;
@@ -749,6 +784,11 @@ void ws2812_updateLED(color * inPanel){
 
 #if defined(WS2812_PARALLEL_ROW)
     for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+
+        if(!(inRows & (1u << lRow))) {
+            continue;
+        }
+
 #if defined(WS2812_FREERTOS)
         /* wait on semaphore */
         xSemaphoreTake(sLedDMA[lRow].mDmaDoneSemaphore, portMAX_DELAY);
@@ -760,11 +800,78 @@ void ws2812_updateLED(color * inPanel){
 #endif /* WS2812_PARALLEL_ROW */
 }
 
+void ws2812_updateLED(color * inPanel) {
+
+    size_t lRow;
+
+    for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+        sUpdateRow[lRow]    = &inPanel[sLedPanel[lRow].mLeds];
+        sUpdateOffset[lRow] = 0;
+        sUpdateEnd[lRow]    = WS2812_NR_COLUMNS;
+    }
+
+    ws2812_update(WS2812_ROWS_ALL);
+}
+
+void ws2812_updateLED_Rows(color * inPanel, uint32_t inRows) {
+
+    size_t lRow;
+
+    for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+        sUpdateRow[lRow]    = &inPanel[sLedPanel[lRow].mLeds];
+        sUpdateOffset[lRow] = 0;
+        sUpdateEnd[lRow]    = WS2812_NR_COLUMNS;
+    }
+
+    ws2812_update(inRows);
+}
+
+size_t ws2812_updateLED_Spans(color * inPanel, const ts_ws2812_span * inSpans) {
+
+    size_t lRow;
+    size_t lSent = 0;
+    uint32_t lRows = 0;
+
+    for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+
+        sUpdateRow[lRow]    = &inPanel[sLedPanel[lRow].mLeds];
+        sUpdateOffset[lRow] = 0;
+
+        /* the chain has to be sent from its start up to the last changed led */
+        if(!ws2812_span_empty(&inSpans[lRow])) {
+
+            sUpdateEnd[lRow] = inSpans[lRow].mLast;
+            lSent           += inSpans[lRow].mLast;
+            lRows           |= (1u << lRow);
+        }
+    }
+
+    if(lRows) {
+        ws2812_update(lRows);
+    }
+
+    return lSent;
+}
+
+void ws2812_updateLED_Strip(const color * inStrip, const int16_t * inRowOffset) {
+
+    size_t lRow;
+
+    /* every row reads from the same strip */
+    for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+        sUpdateRow[lRow]    = inStrip;
+        sUpdateOffset[lRow] = (inRowOffset != NULL)? ws2812_normalizeOffset(inRowOffset[lRow]) : 0;
+        sUpdateEnd[lRow]    = WS2812_NR_COLUMNS;
+    }
+
+    ws2812_update(WS2812_ROWS_ALL);
+}
+
 /*! Check if DMA tranmitted the last leds of a specific row */
 static inline bool checkLastIndex(size_t inRow) {
 
     /* +2 adds 2*3*24 bits which corresponds to the end frame ~50us */
-    return sLedDMA[inRow].mDmaColumnIndex > (WS2812_NR_COLUMNS + 2);
+    return sLedDMA[inRow].mDmaColumnIndex > (sUpdateEnd[inRow] + 2);
 }
 
 /*! Handler for Tim3 CH1 DMA */
@@ -1,10 +1,12 @@
 
 #include <stdbool.h>
 #include <stdio.h>      // for dbg
+#include <stdlib.h>     // for malloc
 #include <string.h>     // for memcpy
 
 #include "ws2812.h"   // for WS2812_NR_ROWS, WS2812_NR_COLUMNS
-#include "color.h"    // for color / color_f
+#include "color.h"    // for color / color16
+#include "color16.h"  // for color16_quantize
 
 #include "ws2812_anim_obj.h"
 #include "ws2812_modifier_obj.h"
@@ -13,7 +15,7 @@
 #include "ws2812_anim.h"
 
 #include "FreeRTOS.h"
-#include "queue.h"
+#include "semphr.h"
 #include "task.h"
 
 // animations
@@ -23,6 +25,13 @@
 // transitions
 #include "ws2812_transition_fade.h"
 
+#include "ws2812_blit.h"
+#include "ws2812_cycles.h"
+#include "ws2812_font.h"      // for ws2812_font_from_utf8
+
+#include "mt_trig.h"    // for MT_ANGLE16_FULL
+#include "mt_random.h"  // for ts_pcg32
+
 
 // ------------------- debug ------------------------
 
@@ -45,6 +54,15 @@
 /*! Defines the ms per animation tick */
 #define WS2812_ANIMATION_DELAY_MS   (1000 / WS2812_ANIMATION_FREQ)
 
+/*! Number of frames a cached frame is not sent again, the leds latch it */
+#define WS2812_ANIMATION_REFRESH    (WS2812_ANIMATION_FREQ)
+
+/*! Marks an unconsumed command in the mailbox */
+#define WS2812_MAILBOX_FRESH        (0x80000000u)
+
+/*! Masks the slot index in the mailbox */
+#define WS2812_MAILBOX_INDEX_MASK   (0x00000003u)
+
 
 
 /*! Enumerates the animation states */
@@ -58,24 +76,6 @@ typedef enum {
 
 } te_ws2812_animation_state;
 
-/*! Enumerates the animations */
-typedef enum {
-
-    /*! Constant color animation */
-    WS2812_ANIMATION_CONSTANT_COLOR = 0,
-
-    /*! Gradient animation */
-    WS2812_ANIMATION_GRADIENT,
-
-    /*! Palette animation */
-    WS2812_ANIMATION_PALETTE,
-
-    /*! Fire animation */
-    WS2812_ANIMATION_FIRE,
-
-} te_ws2812_animations;
-
-
 /*! Enumerates the transitions */
 typedef enum {
 
@@ -100,14 +100,159 @@ typedef struct {
     /*! The transition parameters */
     tu_ws2812_trans_param   mTransParam;
 
+    /*! How to run the outgoing animation during the transition */
+    te_ws2812_transition_outgoing mOutgoing;
+
+    /*! Duration of the transition or morph in frames */
+    uint32_t                mFrames;
+
+    /*! Tick count when the command was issued */
+    TickType_t              mTimestamp;
+
 } ts_ws2812_anim_ctrl_cmd;
 
 
+/*! Defines a latest-wins command mailbox
+
+    The three slots rotate between the producer, the pending position and
+    the consumer. Publishing swaps the producer's slot into the pending
+    position, fetching swaps the consumer's slot out of it. Both are a
+    single atomic exchange, so neither side ever blocks and a command which
+    was not consumed yet is simply replaced by the newer one.
+
+    There may only be one producer at a time, ws2812_animation_reserve()
+    serializes the tasks issuing commands.
+*/
+typedef struct {
+
+    /*! Command slots */
+    ts_ws2812_anim_ctrl_cmd     mSlot[3];
+
+    /*! Pending slot index, or'ed with WS2812_MAILBOX_FRESH if unconsumed */
+    volatile uint32_t           mPending;
+
+    /*! Slot owned by the producer */
+    uint32_t                    mWrite;
+
+    /*! Slot owned by the consumer */
+    uint32_t                    mRead;
+
+    /*! Number of commands replaced before they were consumed */
+    volatile uint32_t           mCoalesced;
+
+} ts_ws2812_anim_mailbox;
+
+
+/*! Defines the buffers of an interpolated animation
+
+    The animation renders the next keyframe into its panel in parts, one
+    part per frame. Meanwhile the output is blended between the last two
+    complete keyframes.
+*/
+typedef struct {
+
+    /*! The last two complete keyframes */
+    color                       mKey[2][WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+
+    /*! Blended output */
+    color                       mOutput[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+
+    /*! Index of the newer keyframe */
+    size_t                      mNewest;
+
+    /*! Next part of the keyframe to render */
+    uint32_t                    mPart;
+
+    /*! Render cycles accumulated over the current keyframe */
+    uint32_t                    mCycles;
+
+    /*! Both keyframes are valid */
+    bool                        mPrimed;
+
+} ts_ws2812_anim_keyframes;
+
+
+/*! Defines the 16 bit working buffers, see ws2812_anim_precision() */
+typedef struct {
+
+    /*! Output of each animation object in 16 bit */
+    color16                     mInput[2][WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+
+    /*! Blended panel */
+    color16                     mOutput[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+
+    /*! mInput holds the last output of the animation object */
+    bool                        mValid[2];
+
+    /*! Frame counter of the dither pattern */
+    uint32_t                    mFrame;
+
+} ts_ws2812_anim_precision;
+
+
+/*! Defines the area and update rate of a zone */
+typedef struct {
+
+    /*! First row */
+    size_t                      mRow;
+
+    /*! First column */
+    size_t                      mColumn;
+
+    /*! Number of rows, 0 if the zone is not used */
+    size_t                      mRows;
+
+    /*! Number of columns */
+    size_t                      mColumns;
+
+    /*! Frames per render */
+    uint32_t                    mPeriod;
+
+} ts_ws2812_zone_geometry;
+
+
+/*! Defines a zone
+
+    A zone is a rectangle of the panel shown on top of the main animation.
+    It runs its own animation at its own rate, without transitions.
+*/
+typedef struct {
+
+    /*! The command mailbox of the zone */
+    ts_ws2812_anim_mailbox      mMailbox;
+
+    /*! Geometry in use */
+    ts_ws2812_zone_geometry     mGeometry;
+
+    /*! Geometry set by the application, taken over at the next frame */
+    ts_ws2812_zone_geometry     mPendingGeometry;
+
+    /*! mPendingGeometry was changed */
+    volatile bool               mGeometryPending;
+
+    /*! Animation object, NULL if the zone is not used */
+    tu_ws2812_anim            * mAnimation;
+
+    /*! Animation type */
+    te_ws2812_animations        mType;
+
+    /*! Animation parameters, to set up the animation again on resize */
+    tu_ws2812_anim_param        mParam;
+
+    /*! Frames until the next render */
+    uint32_t                    mCountdown;
+
+} ts_ws2812_zone;
+
+
 /*! Defines the animation control object */
 typedef struct {
 
-    /*! The notification message queue */
-    QueueHandle_t               mMsgQueue;
+    /*! The command mailbox */
+    ts_ws2812_anim_mailbox      mMailbox;
+
+    /*! Wakes the animation task when a command was published */
+    SemaphoreHandle_t           mWakeup;
 
     /*! for timing */
     TimeOut_t                   mTimeout;
@@ -118,8 +263,74 @@ typedef struct {
     /*! next animation */
     size_t                      mCurrentAnimation;
 
-    /*! Received command */
-    ts_ws2812_anim_ctrl_cmd     mLastCommand;
+    /*! Animation type running in each animation object */
+    te_ws2812_animations        mAnimationType[2];
+
+    /*! Issue time of the command whose first frame is not out yet */
+    TickType_t                  mLatencyStart;
+
+    /*! A command's first frame is pending */
+    bool                        mLatencyPending;
+
+    /*! Frames until a cached frame is sent again */
+    size_t                      mRefresh;
+
+    /*! Transition duration for new commands in ms */
+    uint32_t                    mTransitionDuration;
+
+    /*! Outgoing animation mode for new commands */
+    te_ws2812_transition_outgoing mTransitionOutgoing;
+
+    /*! Run the outgoing animation every n-th transition frame, 0 freezes it */
+    uint32_t                    mOutgoingDivider;
+
+    /*! Frames since the transition started */
+    uint32_t                    mTransitionFrame;
+
+    /*! Render cycles accumulated over the current transition */
+    uint32_t                    mTransitionCycles;
+
+    /*! Frames left of the current morph */
+    uint32_t                    mMorphFrames;
+
+    /*! Frames of the current morph */
+    uint32_t                    mMorphLength;
+
+    /*! Render cycles accumulated over the current morph */
+    uint32_t                    mMorphCycles;
+
+    /*! Interpolate animations which support it, per animation type */
+    bool                        mInterpolate[WS2812_ANIMATION_COUNT];
+
+    /*! Keyframe buffers of interpolated animations, allocated on first use */
+    ts_ws2812_anim_keyframes  * mKeyframes[2];
+
+    /*! Working format selected by the application */
+    volatile te_ws2812_precision mPrecision;
+
+    /*! 16 bit buffers, allocated while a 16 bit format is selected */
+    ts_ws2812_anim_precision  * mPrecisionBuffers;
+
+    /*! The current frame blends in 16 bit */
+    bool                        mPrecise;
+
+    /*! Last output panel of each animation object */
+    color                     * mOutput[2];
+
+    /*! The last output is a strip for all rows */
+    bool                        mOutputStrip[2];
+
+    /*! Zones */
+    ts_ws2812_zone              mZone[WS2812_ZONES_MAX];
+
+    /*! Main animation with the zones on top */
+    color                       mComposite[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+
+    /*! Statistics */
+    ts_ws2812_anim_stats        mStats;
+
+    /*! Generator for the seeds of the animations */
+    ts_pcg32                    mRandom;
 
     /*! Animation object */
     tu_ws2812_anim              mAnimation[2];
@@ -143,6 +354,18 @@ static const f_ws2812_anim_init sAnimationInitFuncs[] = {
     [WS2812_ANIMATION_GRADIENT]       = ws2812_anim_gradient_init,
     [WS2812_ANIMATION_PALETTE]        = ws2812_anim_color_palette_init,
     [WS2812_ANIMATION_FIRE]           = ws2812_anim_fire_init,
+    [WS2812_ANIMATION_TEXT]           = ws2812_anim_text_init,
+    [WS2812_ANIMATION_PLASMA]         = ws2812_anim_plasma_init,
+    [WS2812_ANIMATION_CLOUDS]         = ws2812_anim_clouds_init,
+    [WS2812_ANIMATION_RAINBOW]        = ws2812_anim_rainbow_init,
+    [WS2812_ANIMATION_PARTICLES]      = ws2812_anim_particles_init,
+    [WS2812_ANIMATION_CELLS]          = ws2812_anim_cells_init,
+    [WS2812_ANIMATION_PROGRAM]        = ws2812_anim_program_init,
+    [WS2812_ANIMATION_GIF]            = ws2812_anim_gif_init,
+#ifdef WS2812_ANIM_SEQ
+    [WS2812_ANIMATION_SEQ]            = ws2812_anim_seq_init,
+#endif /* WS2812_ANIM_SEQ */
+    [WS2812_ANIMATION_AUDIO]          = ws2812_anim_audio_init,
 };
 
 /*! Animation cleanup functions */
@@ -152,6 +375,18 @@ static const f_ws2812_anim_clean sAnimationCleanFuncs[] = {
     [WS2812_ANIMATION_GRADIENT]       = NULL,
     [WS2812_ANIMATION_PALETTE]        = NULL,
     [WS2812_ANIMATION_FIRE]           = ws2812_anim_fire_clean,
+    [WS2812_ANIMATION_TEXT]           = NULL,
+    [WS2812_ANIMATION_PLASMA]         = NULL,
+    [WS2812_ANIMATION_CLOUDS]         = NULL,
+    [WS2812_ANIMATION_RAINBOW]        = NULL,
+    [WS2812_ANIMATION_PARTICLES]      = ws2812_anim_particles_clean,
+    [WS2812_ANIMATION_CELLS]          = ws2812_anim_cells_clean,
+    [WS2812_ANIMATION_PROGRAM]        = ws2812_anim_program_clean,
+    [WS2812_ANIMATION_GIF]            = ws2812_anim_gif_clean,
+#ifdef WS2812_ANIM_SEQ
+    [WS2812_ANIMATION_SEQ]            = ws2812_anim_seq_clean,
+#endif /* WS2812_ANIM_SEQ */
+    [WS2812_ANIMATION_AUDIO]          = ws2812_anim_audio_clean,
 };
 
 
@@ -162,234 +397,1725 @@ static const f_ws2812_trans_init sTransitionInitFuncs[] = {
 };
 
 
+/*! Outgoing animation update divider */
+static const uint32_t sOutgoingDivider[] = {
+
+    [WS2812_TRANSITION_OUTGOING_LIVE]     = 1,
+    [WS2812_TRANSITION_OUTGOING_HALF]     = 2,
+    [WS2812_TRANSITION_OUTGOING_QUARTER]  = 4,
+    [WS2812_TRANSITION_OUTGOING_SNAPSHOT] = 0,
+};
+
+
 // ------------------- functions --------------------
 
 
-void ws2812_animation_init(void) {
+/*! Initialize an empty mailbox */
+static void ws2812_anim_mailbox_init(ts_ws2812_anim_mailbox * pThis) {
 
-    sAnimationControl.mMsgQueue         = xQueueCreate(4, sizeof(ts_ws2812_anim_ctrl_cmd));
-    sAnimationControl.mState            = WS2812_ANIM_STATE_MAIN;
-    sAnimationControl.mCurrentAnimation = 0;
+    pThis->mWrite     = 0;
+    pThis->mPending   = 1;
+    pThis->mRead      = 2;
+    pThis->mCoalesced = 0;
+}
 
-    if(!sAnimationControl.mMsgQueue) {
-        dbg_err("%s(%d): Failed initializing mMsgQueue\r\n", __FILE__, __LINE__);
-    }
 
-    /* black color */
-    sAnimationControl.mLastCommand.mAnimation = WS2812_ANIMATION_CONSTANT_COLOR;
-    sAnimationControl.mLastCommand.mAnimParam.mConstantColor.mColor.R = 0;
-    sAnimationControl.mLastCommand.mAnimParam.mConstantColor.mColor.G = 0;
-    sAnimationControl.mLastCommand.mAnimParam.mConstantColor.mColor.B = 0;
+/*! Get the producer's slot of the mailbox
 
-    /* clean init of modifier */
-    sAnimationControl.mAnimation[sAnimationControl.mCurrentAnimation].mBase.mModifier = NULL;
+    \return the command to be filled and published
+*/
+static inline ts_ws2812_anim_ctrl_cmd * ws2812_anim_mailbox_reserve(ts_ws2812_anim_mailbox * pThis) {
 
-    /* initialize animation */
-    sAnimationInitFuncs[sAnimationControl.mLastCommand.mAnimation](&sAnimationControl.mAnimation[sAnimationControl.mCurrentAnimation], &sAnimationControl.mLastCommand.mAnimParam);
+    return &pThis->mSlot[pThis->mWrite];
 }
 
 
-static void ws2812_animation_update(tu_ws2812_anim * pThis) {
+/*! Publish the producer's slot, replacing an unconsumed command */
+static inline void ws2812_anim_mailbox_publish(ts_ws2812_anim_mailbox * pThis) {
 
-    color * lPanel;
-    tu_ws2812_modifier * lModifier;
+    uint32_t lPrevious;
 
-    pThis->mBase.mfUpdate(pThis);
+    lPrevious = __atomic_exchange_n(&pThis->mPending, pThis->mWrite | WS2812_MAILBOX_FRESH, __ATOMIC_ACQ_REL);
 
-    /* iterate over all modifiers */
-    for(lPanel = pThis->mBase.mPanel,     lModifier = pThis->mBase.mModifier;
-        lModifier != NULL;
-        lPanel = lModifier->mBase.mPanel, lModifier = lModifier->mBase.mModifier) {
+    if(lPrevious & WS2812_MAILBOX_FRESH) {
+        pThis->mCoalesced++;
+    }
 
-        /* run current modifier */
-        lModifier->mBase.mfUpdate(lModifier, lPanel);
+    pThis->mWrite = lPrevious & WS2812_MAILBOX_INDEX_MASK;
+}
+
+
+/*! Fetch the latest command
+
+    The returned command stays valid until the next fetch.
+
+    \return the latest command or NULL if there is none
+*/
+static inline ts_ws2812_anim_ctrl_cmd * ws2812_anim_mailbox_fetch(ts_ws2812_anim_mailbox * pThis) {
+
+    uint32_t lPrevious;
+
+    if(!(pThis->mPending & WS2812_MAILBOX_FRESH)) {
+        return NULL;
     }
+
+    lPrevious = __atomic_exchange_n(&pThis->mPending, pThis->mRead, __ATOMIC_ACQ_REL);
+
+    pThis->mRead = lPrevious & WS2812_MAILBOX_INDEX_MASK;
+
+    return &pThis->mSlot[pThis->mRead];
 }
 
 
-static color * ws2812_animation_get_modifier_panel(tu_ws2812_modifier * pThis) {
+/*! Fill in the configured transition */
+static void ws2812_animation_set_transition(ts_ws2812_anim_ctrl_cmd * pCommand) {
 
-    tu_ws2812_modifier * lModifier;
+    pCommand->mFrames     = sAnimationControl.mTransitionDuration / WS2812_ANIMATION_DELAY_MS;
 
-    /* find last modifier */
-    for(lModifier = pThis; lModifier->mBase.mModifier != NULL; lModifier = lModifier->mBase.mModifier);
+    /* a fade needs one frame at least, shorter durations switch with the next frame */
+    if(pCommand->mFrames == 0) {
+        pCommand->mFrames = 1;
+    }
 
-    /* return it's panel */
-    return lModifier->mBase.mPanel;
+    pCommand->mTransition = WS2812_TRANSITION_FADE;
+    pCommand->mTransParam.mFade.mDuration = pCommand->mFrames;
+    pCommand->mOutgoing = sAnimationControl.mTransitionOutgoing;
 }
 
 
-static color * ws2812_animation_get_panel(tu_ws2812_anim * pThis) {
+/*! Get the producer's slot of a mailbox for a new command
 
-    if(pThis->mBase.mModifier != NULL) {
+    The scheduler stays suspended until ws2812_animation_post(), so only one
+    task at a time fills a slot and reads the transition settings. Filling
+    a command must not block.
 
-        return ws2812_animation_get_modifier_panel(pThis->mBase.mModifier);
-    } else {
+    \return the command to be filled and posted
+*/
+static ts_ws2812_anim_ctrl_cmd * ws2812_animation_reserve(ts_ws2812_anim_mailbox * pMailbox) {
+
+    vTaskSuspendAll();
+
+    return ws2812_anim_mailbox_reserve(pMailbox);
+}
+
+
+/*! Publish a command reserved by ws2812_animation_reserve() and wake up the animation task */
+static void ws2812_animation_post(ts_ws2812_anim_mailbox * pMailbox) {
+
+    ws2812_anim_mailbox_reserve(pMailbox)->mTimestamp = xTaskGetTickCount();
 
-        return pThis->mBase.mPanel;
+    ws2812_anim_mailbox_publish(pMailbox);
+
+    xTaskResumeAll();
+
+    /* doesn't block, a pending wakeup is good enough */
+    xSemaphoreGive(sAnimationControl.mWakeup);
+}
+
+
+/*! Initialize an animation object rendering inRows x inColumns leds */
+static void ws2812_animation_setup(tu_ws2812_anim * pThis, te_ws2812_animations inType, tu_ws2812_anim_param * pParam,
+                                   size_t inRows, size_t inColumns) {
+
+    /* has to be rendered at least once */
+    pThis->mBase.mFlags            = WS2812_ANIM_FLAG_DIRTY;
+    pThis->mBase.mfMorph           = NULL;
+    pThis->mBase.mfUpdatePart      = NULL;
+    pThis->mBase.mKeyframeDivider  = 1;
+    pThis->mBase.mRows             = inRows;
+    pThis->mBase.mColumns          = inColumns;
+
+    memset(pThis->mBase.mRowOffset, 0, sizeof(pThis->mBase.mRowOffset));
+
+    sAnimationInitFuncs[inType](pThis, pParam);
+
+    /* clean init of modifier */
+    pThis->mBase.mModifier = NULL;
+}
+
+
+/*! Cleanup an animation object */
+static void ws2812_animation_cleanup(tu_ws2812_anim * pThis, te_ws2812_animations inType) {
+
+    if(sAnimationCleanFuncs[inType]) {
+
+        sAnimationCleanFuncs[inType](pThis);
     }
 }
 
 
-void ws2812_transition_done(void) {
+/*! Initialize one of the animation objects */
+static void ws2812_animation_create(size_t inAnimation, te_ws2812_animations inType, tu_ws2812_anim_param * pParam) {
 
-    /* cleanup */
-    if(sAnimationCleanFuncs[sAnimationControl.mCurrentAnimation]) {
+    tu_ws2812_anim * lAnimation = &sAnimationControl.mAnimation[inAnimation];
+
+    sAnimationControl.mAnimationType[inAnimation] = inType;
+
+    ws2812_animation_setup(lAnimation, inType, pParam, WS2812_NR_ROWS, WS2812_NR_COLUMNS);
+
+    sAnimationControl.mOutput[inAnimation]      = lAnimation->mBase.mPanel;
+    sAnimationControl.mOutputStrip[inAnimation] = false;
 
-        sAnimationCleanFuncs[sAnimationControl.mCurrentAnimation](&sAnimationControl.mAnimation[sAnimationControl.mCurrentAnimation]);
+    if(sAnimationControl.mPrecisionBuffers) {
+        sAnimationControl.mPrecisionBuffers->mValid[inAnimation] = false;
     }
+}
 
-    /* switch animation */
-    sAnimationControl.mCurrentAnimation = (sAnimationControl.mCurrentAnimation + 1) & 1;
 
-    /* switch mode */
-    sAnimationControl.mState = WS2812_ANIM_STATE_MAIN;
+uint32_t ws2812_animation_seed(void) {
+
+    return pcg32(&sAnimationControl.mRandom);
 }
 
 
-void ws2812_animation_main(void) {
+void ws2812_animation_init(uint32_t inSeed) {
 
-    /* run at 100 Hz */
-    TickType_t lDelay = configTICK_RATE_HZ / WS2812_ANIMATION_FREQ;
+    ts_ws2812_anim_ctrl_cmd lCommand;
+    size_t lCount;
 
-    vTaskSetTimeOutState(&sAnimationControl.mTimeout);
+    ws2812_anim_mailbox_init(&sAnimationControl.mMailbox);
 
-    switch(sAnimationControl.mState) {
+    for(lCount = 0; lCount < WS2812_ZONES_MAX; lCount++) {
 
-        case WS2812_ANIM_STATE_TRANSIT: {
+        ws2812_anim_mailbox_init(&sAnimationControl.mZone[lCount].mMailbox);
 
-                /* run animation 1 */
-                ws2812_animation_update(&sAnimationControl.mAnimation[sAnimationControl.mCurrentAnimation]);
+        sAnimationControl.mZone[lCount].mAnimation       = NULL;
+        sAnimationControl.mZone[lCount].mGeometryPending = false;
+    }
 
-                /* run animation 2 */
-                ws2812_animation_update(&sAnimationControl.mAnimation[(sAnimationControl.mCurrentAnimation + 1) & 1]);
+    sAnimationControl.mWakeup           = xSemaphoreCreateCounting(1, 0);
+    sAnimationControl.mState            = WS2812_ANIM_STATE_MAIN;
+    sAnimationControl.mCurrentAnimation = 0;
+    sAnimationControl.mLatencyPending   = false;
+    sAnimationControl.mRefresh          = 0;
+    sAnimationControl.mMorphFrames      = 0;
+    sAnimationControl.mKeyframes[0]     = NULL;
+    sAnimationControl.mKeyframes[1]     = NULL;
+    sAnimationControl.mPrecision        = WS2812_PRECISION_8BIT;
+    sAnimationControl.mPrecisionBuffers = NULL;
+    sAnimationControl.mPrecise          = false;
+
+    for(lCount = 0; lCount < WS2812_ANIMATION_COUNT; lCount++) {
+        sAnimationControl.mInterpolate[lCount] = true;
+    }
 
-                sAnimationControl.mTransition.mBase.mfUpdate(&sAnimationControl.mTransition,
-                                                             ws2812_animation_get_panel(&sAnimationControl.mAnimation[sAnimationControl.mCurrentAnimation]),
-                                                             ws2812_animation_get_panel(&sAnimationControl.mAnimation[(sAnimationControl.mCurrentAnimation + 1) & 1]));
+    sAnimationControl.mTransitionDuration = 1000;
+    sAnimationControl.mTransitionOutgoing = WS2812_TRANSITION_OUTGOING_LIVE;
 
-                /* update led from transition buffer */
-                ws2812_updateLED(sAnimationControl.mTransition.mBase.mPanel);
-            }
-            break;
-        case WS2812_ANIM_STATE_MAIN:
-        default: {
+    ws2812_cycles_init();
+    ws2812_blit_init();
 
-                /* run animation */
-                sAnimationControl.mAnimation[sAnimationControl.mCurrentAnimation].mBase.mfUpdate(&sAnimationControl.mAnimation[sAnimationControl.mCurrentAnimation]);
+    pcg32_seed(&sAnimationControl.mRandom, inSeed, 0);
 
-                /* update led from animation buffer */
-                ws2812_updateLED(sAnimationControl.mAnimation[sAnimationControl.mCurrentAnimation].mBase.mPanel);
-            }
-            break;
+    memset(&sAnimationControl.mStats, 0, sizeof(sAnimationControl.mStats));
+
+    if(!sAnimationControl.mWakeup) {
+        dbg_err("%s(%d): Failed initializing mWakeup\r\n", __FILE__, __LINE__);
     }
 
-    /* Adapt the timeout according to the animation's request */
-    if(xTaskCheckForTimeOut(&sAnimationControl.mTimeout, &lDelay)) {
+#ifdef WS2812_ANIM_SEQ
+    ws2812_seq_loader_init();
+#endif /* WS2812_ANIM_SEQ */
 
-        dbg_err("%s(%d): timed out!\r\n", __FILE__, __LINE__);
+    /* black color */
+    lCommand.mAnimation = WS2812_ANIMATION_CONSTANT_COLOR;
+    lCommand.mAnimParam.mConstantColor.mColor.R = 0;
+    lCommand.mAnimParam.mConstantColor.mColor.G = 0;
+    lCommand.mAnimParam.mConstantColor.mColor.B = 0;
 
-        lDelay = 0; // timed out
-    } // xTaskCheckForTimeOut adapts lDelay to fit to the timeout
+    /* initialize animation */
+    ws2812_animation_create(sAnimationControl.mCurrentAnimation, lCommand.mAnimation, &lCommand.mAnimParam);
+}
 
-    if(sAnimationControl.mState == WS2812_ANIM_STATE_TRANSIT) {
 
-        vTaskDelay(lDelay);
+/*! Check if the current frame blends in 16 bit
 
-    } else {
-        /* check if there are new transition commands */
-        if(xQueueReceive(sAnimationControl.mMsgQueue, &sAnimationControl.mLastCommand, lDelay)) {
+    The buffers are allocated when a 16 bit format is selected and freed
+    when 8 bit is selected again. If the allocation fails, 8 bit is used.
+*/
+static bool ws2812_animation_is_precise(void) {
 
-            /* wait if neccessary */
-            if(!xTaskCheckForTimeOut(&sAnimationControl.mTimeout, &lDelay)) {
-                vTaskDelay(lDelay);
-            }
+    ts_ws2812_anim_precision * lBuffers = sAnimationControl.mPrecisionBuffers;
+
+    if(sAnimationControl.mPrecision == WS2812_PRECISION_8BIT) {
+
+        if(lBuffers) {
+            free(lBuffers);
+            sAnimationControl.mPrecisionBuffers = NULL;
+        }
+
+        return false;
+    }
+
+    if(lBuffers == NULL) {
 
-            /* if we received a command, go to transition state */
-            sAnimationControl.mState = WS2812_ANIM_STATE_TRANSIT;
-            sTransitionInitFuncs[sAnimationControl.mLastCommand.mTransition](&sAnimationControl.mTransition, &sAnimationControl.mLastCommand.mTransParam);
+        lBuffers = (ts_ws2812_anim_precision*)malloc(sizeof(ts_ws2812_anim_precision));
 
-            /* init second animation */
-            sAnimationInitFuncs[sAnimationControl.mLastCommand.mAnimation](&sAnimationControl.mAnimation[(sAnimationControl.mCurrentAnimation + 1) & 1], &sAnimationControl.mLastCommand.mAnimParam);
+        if(lBuffers == NULL) {
 
-            /* clean init of modifier */
-            sAnimationControl.mAnimation[(sAnimationControl.mCurrentAnimation + 1) & 1].mBase.mModifier = NULL;
+            dbg_err("%s(%d): Failed allocating 16 bit buffers\r\n", __FILE__, __LINE__);
+            sAnimationControl.mPrecision = WS2812_PRECISION_8BIT;
+            return false;
         }
+
+        lBuffers->mValid[0] = false;
+        lBuffers->mValid[1] = false;
+        lBuffers->mFrame    = 0;
+
+        sAnimationControl.mPrecisionBuffers = lBuffers;
     }
+
+    lBuffers->mFrame++;
+
+    return true;
 }
 
 
-void ws2812_anim_const_color(uint8_t inRed, uint8_t inGreen, uint8_t inBlue) {
+/*! Quantise a 16 bit panel, the only rounding of a 16 bit blend
 
-    ts_ws2812_anim_ctrl_cmd lCommand;
+    Ordered dither moves with the frame, so a fraction shows as the average
+    of the leds over space and time instead of a step.
+*/
+static void ws2812_animation_quantize(color * outPanel, const color16 * inPanel) {
 
-    lCommand.mAnimation = WS2812_ANIMATION_CONSTANT_COLOR;
-    lCommand.mAnimParam.mConstantColor.mColor.R = inRed;
-    lCommand.mAnimParam.mConstantColor.mColor.G = inGreen;
-    lCommand.mAnimParam.mConstantColor.mColor.B = inBlue;
+    size_t lRow;
+    uint32_t lThresholds = COLOR16_ROUND;
+
+    for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
 
-    /*! todo: use configured transition */
-    lCommand.mTransition = WS2812_TRANSITION_FADE;
-    lCommand.mTransParam.mFade.mDuration = 1000 / WS2812_ANIMATION_DELAY_MS;    // 1000ms @ 100 Hz
+        if(sAnimationControl.mPrecision == WS2812_PRECISION_DITHER) {
+            lThresholds = color16_dither_thresholds(lRow, sAnimationControl.mPrecisionBuffers->mFrame);
+        }
 
-    xQueueSend(sAnimationControl.mMsgQueue, &lCommand, portMAX_DELAY );
+        color16_quantize(&outPanel[lRow * WS2812_NR_COLUMNS], &inPanel[lRow * WS2812_NR_COLUMNS], WS2812_NR_COLUMNS, lThresholds);
+    }
 }
 
 
-void ws2812_anim_gradient(uint8_t inFirstRed, uint8_t inFirstGreen, uint8_t inFirstBlue,
-                          uint8_t inSecondRed, uint8_t inSecondGreen, uint8_t inSecondBlue,
-                          int16_t inAngle) {
+/*! Run an animation
 
-    ts_ws2812_anim_ctrl_cmd lCommand;
+    Static animations are only rendered when their parameters changed.
+    The update may mark itself dirty again, e.g. while morphing.
+*/
+static void ws2812_animation_render(tu_ws2812_anim * pThis) {
 
-    lCommand.mAnimation = WS2812_ANIMATION_GRADIENT;
-    lCommand.mAnimParam.mGradient.mFirstColor.R = inFirstRed;
-    lCommand.mAnimParam.mGradient.mFirstColor.G = inFirstGreen;
-    lCommand.mAnimParam.mGradient.mFirstColor.B = inFirstBlue;
+    if((pThis->mBase.mFlags & (WS2812_ANIM_FLAG_STATIC | WS2812_ANIM_FLAG_DIRTY)) != WS2812_ANIM_FLAG_STATIC) {
 
-    lCommand.mAnimParam.mGradient.mSecondColor.R = inSecondRed;
-    lCommand.mAnimParam.mGradient.mSecondColor.G = inSecondGreen;
-    lCommand.mAnimParam.mGradient.mSecondColor.B = inSecondBlue;
+        pThis->mBase.mFlags &= ~WS2812_ANIM_FLAG_DIRTY;
 
-    lCommand.mAnimParam.mGradient.mAngle = inAngle;
+        pThis->mBase.mfUpdate(pThis);
+    }
+}
 
-    /*! todo: use configured transition */
-    lCommand.mTransition = WS2812_TRANSITION_FADE;
-    lCommand.mTransParam.mFade.mDuration = 1000 / WS2812_ANIMATION_DELAY_MS;    // 1000ms @ 100 Hz
 
-    xQueueSend(sAnimationControl.mMsgQueue, &lCommand, portMAX_DELAY );
-}
+/*! Check if an animation is rendered at keyframe rate
 
+    The keyframe buffers are allocated on first use. If that fails, the
+    animation is rendered at full rate.
+*/
+static bool ws2812_animation_is_interpolated(size_t inAnimation) {
 
-void ws2812_anim_palette(te_color_palettes inPalette) {
+    tu_ws2812_anim * lAnimation = &sAnimationControl.mAnimation[inAnimation];
 
-    ts_ws2812_anim_ctrl_cmd lCommand;
+    if(lAnimation->mBase.mfUpdatePart == NULL || lAnimation->mBase.mKeyframeDivider < 2 ||
+       !sAnimationControl.mInterpolate[sAnimationControl.mAnimationType[inAnimation]]) {
+
+        /* start over when it is switched on again */
+        if(sAnimationControl.mKeyframes[inAnimation]) {
+            sAnimationControl.mKeyframes[inAnimation]->mPrimed = false;
+        }
+
+        return false;
+    }
+
+    if(sAnimationControl.mKeyframes[inAnimation] == NULL) {
+
+        sAnimationControl.mKeyframes[inAnimation] = (ts_ws2812_anim_keyframes*)malloc(sizeof(ts_ws2812_anim_keyframes));
 
-    lCommand.mAnimation = WS2812_ANIMATION_PALETTE;
-    lCommand.mAnimParam.mPalette.mPalette = inPalette;
+        if(sAnimationControl.mKeyframes[inAnimation] == NULL) {
 
-    /*! todo: use configured transition */
-    lCommand.mTransition = WS2812_TRANSITION_FADE;
-    lCommand.mTransParam.mFade.mDuration = 1000 / WS2812_ANIMATION_DELAY_MS;    // 1000ms @ 100 Hz
+            dbg_err("%s(%d): Failed allocating keyframes\r\n", __FILE__, __LINE__);
+            return false;
+        }
+
+        sAnimationControl.mKeyframes[inAnimation]->mPrimed = false;
+    }
 
-    xQueueSend(sAnimationControl.mMsgQueue, &lCommand, portMAX_DELAY );
+    return true;
 }
 
 
-void ws2812_anim_fire(te_color_palettes inPalette) {
+/*! Run an animation at keyframe rate
 
-    ts_ws2812_anim_ctrl_cmd lCommand;
+    One part of the next keyframe is rendered per frame, so the cost of a
+    keyframe is spread over the frames in between. Only the very first
+    keyframe is rendered at once. Strip animations only blend the strip.
+
+    \return the blended panel or strip
+*/
+static color * ws2812_animation_interpolate(size_t inAnimation) {
+
+    tu_ws2812_anim * lAnimation = &sAnimationControl.mAnimation[inAnimation];
+    ts_ws2812_anim_keyframes * lKeys = sAnimationControl.mKeyframes[inAnimation];
+
+    bool lStrip = (lAnimation->mBase.mFlags & WS2812_ANIM_FLAG_STRIP) != 0;
+    color * lSource = lStrip? lAnimation->mBase.mStrip : lAnimation->mBase.mPanel;
+    size_t lLeds = lStrip? WS2812_NR_COLUMNS : WS2812_NR_ROWS * WS2812_NR_COLUMNS;
 
-    lCommand.mAnimation = WS2812_ANIMATION_FIRE;
-    lCommand.mAnimParam.mFire.mPalette = inPalette;
+    uint32_t lDivider = lAnimation->mBase.mKeyframeDivider;
+    uint32_t lStart;
+    size_t lOlder;
+    uint8_t lAmount;
 
-    /*! todo: use configured transition */
-    lCommand.mTransition = WS2812_TRANSITION_FADE;
-    lCommand.mTransParam.mFade.mDuration = 1000 / WS2812_ANIMATION_DELAY_MS;    // 1000ms @ 100 Hz
+    if(!lKeys->mPrimed) {
 
-    xQueueSend(sAnimationControl.mMsgQueue, &lCommand, portMAX_DELAY );
+        for(lKeys->mPart = 0; lKeys->mPart < lDivider; lKeys->mPart++) {
+            lAnimation->mBase.mfUpdatePart(lAnimation, lKeys->mPart, lDivider);
+        }
+
+        memcpy(lKeys->mKey[0], lSource, lLeds * sizeof(color));
+        memcpy(lKeys->mKey[1], lSource, lLeds * sizeof(color));
+
+        lKeys->mNewest = 0;
+        lKeys->mPart   = 0;
+        lKeys->mCycles = 0;
+        lKeys->mPrimed = true;
+    }
+
+    lStart = ws2812_cycles();
+    lAnimation->mBase.mfUpdatePart(lAnimation, lKeys->mPart, lDivider);
+    lKeys->mCycles += ws2812_cycles() - lStart;
+
+    if(++lKeys->mPart == lDivider) {
+
+        /* keyframe is complete, it replaces the older one */
+        lKeys->mNewest ^= 1;
+        memcpy(lKeys->mKey[lKeys->mNewest], lSource, lLeds * sizeof(color));
+
+        sAnimationControl.mStats.mKeyframeCycles = lKeys->mCycles;
+
+        lKeys->mPart   = 0;
+        lKeys->mCycles = 0;
+    }
+
+    /* reaches the newer keyframe when the next one is complete */
+    lOlder = lKeys->mNewest ^ 1;
+
+    /* a transition takes the 16 bit blend as it is */
+    if(sAnimationControl.mPrecise && !lStrip) {
+
+        ts_ws2812_anim_precision * lBuffers = sAnimationControl.mPrecisionBuffers;
+
+        color16_blend8(lBuffers->mInput[inAnimation], lKeys->mKey[lOlder], lKeys->mKey[lKeys->mNewest], lLeds,
+                       (lKeys->mPart << 16) / lDivider);
+        lBuffers->mValid[inAnimation] = true;
+
+        ws2812_animation_quantize(lKeys->mOutput, lBuffers->mInput[inAnimation]);
+
+        return lKeys->mOutput;
+    }
+
+    lAmount = (uint8_t)((lKeys->mPart << 8) / lDivider);
+
+    color_blend(lKeys->mOutput, lKeys->mKey[lOlder], lKeys->mKey[lKeys->mNewest], lLeds, lAmount);
+
+    return lKeys->mOutput;
+}
+
+
+/*! Check if the panel of an animation is still valid
+
+    \retval true    Static animation without modifiers which doesn't need rendering
+    \retval false   The animation has to be rendered
+*/
+static inline bool ws2812_animation_is_cached(tu_ws2812_anim * pThis) {
+
+    return ((pThis->mBase.mFlags & (WS2812_ANIM_FLAG_STATIC | WS2812_ANIM_FLAG_DIRTY)) == WS2812_ANIM_FLAG_STATIC) &&
+           (pThis->mBase.mModifier == NULL);
 }
 
 
+/*! Run an animation and its modifiers
+
+    \param[out] outDirty    Filled with the changed spans of each row
+
+    \return the panel to send, a strip if mOutputStrip is set
+*/
+static color * ws2812_animation_update(size_t inAnimation, ts_ws2812_span * outDirty) {
+
+    tu_ws2812_anim * lAnimation = &sAnimationControl.mAnimation[inAnimation];
+
+    color * lPanel;
+    tu_ws2812_modifier * lModifier;
+    bool lStrip = (lAnimation->mBase.mFlags & WS2812_ANIM_FLAG_STRIP) != 0;
+    bool lSpans = (lAnimation->mBase.mFlags & WS2812_ANIM_FLAG_SPANS) != 0;
+
+    /* the 8 bit output changes, an interpolation sets it again */
+    if(sAnimationControl.mPrecisionBuffers) {
+        sAnimationControl.mPrecisionBuffers->mValid[inAnimation] = false;
+    }
+
+    if(ws2812_animation_is_interpolated(inAnimation)) {
+
+        lPanel = ws2812_animation_interpolate(inAnimation);
+        lSpans = false;
+
+    } else {
+
+        if(lSpans) {
+            ws2812_spans_clear(lAnimation->mBase.mDirty);
+        }
+
+        ws2812_animation_render(lAnimation);
+        lPanel = lStrip? lAnimation->mBase.mStrip : lAnimation->mBase.mPanel;
+    }
+
+    if(lSpans && !lStrip) {
+        memcpy(outDirty, lAnimation->mBase.mDirty, sizeof(lAnimation->mBase.mDirty));
+    } else {
+        ws2812_spans_full(outDirty);
+    }
+
+    /* modifiers work on the whole panel */
+    if(lStrip && lAnimation->mBase.mModifier != NULL) {
+
+        ws2812_setLED_Strip(lAnimation->mBase.mPanel, lPanel, lAnimation->mBase.mRowOffset);
+
+        lPanel = lAnimation->mBase.mPanel;
+        lStrip = false;
+    }
+
+    /* iterate over all modifiers */
+    for(lModifier = lAnimation->mBase.mModifier;
+        lModifier != NULL;
+        lPanel = lModifier->mBase.mPanel, lModifier = lModifier->mBase.mModifier) {
+
+        /* run current modifier */
+        lModifier->mBase.mfUpdate(lModifier, lPanel, outDirty);
+    }
+
+    sAnimationControl.mOutput[inAnimation]      = lPanel;
+    sAnimationControl.mOutputStrip[inAnimation] = lStrip;
+
+    return lPanel;
+}
+
+
+/*! Get the last output of an animation as whole panel
+
+    A strip is copied to all rows of the animation's panel.
+*/
+static color * ws2812_animation_get_panel(size_t inAnimation) {
+
+    tu_ws2812_anim * lAnimation = &sAnimationControl.mAnimation[inAnimation];
+
+    if(sAnimationControl.mOutputStrip[inAnimation]) {
+
+        ws2812_setLED_Strip(lAnimation->mBase.mPanel, sAnimationControl.mOutput[inAnimation], lAnimation->mBase.mRowOffset);
+
+        sAnimationControl.mOutput[inAnimation]      = lAnimation->mBase.mPanel;
+        sAnimationControl.mOutputStrip[inAnimation] = false;
+    }
+
+    return sAnimationControl.mOutput[inAnimation];
+}
+
+
+/*! Get the last output of an animation as whole panel in 16 bit
+
+    The 8 bit panel is only expanded once per output, a frozen animation
+    keeps its 16 bit panel.
+*/
+static const color16 * ws2812_animation_get_panel16(size_t inAnimation) {
+
+    ts_ws2812_anim_precision * lBuffers = sAnimationControl.mPrecisionBuffers;
+
+    if(!lBuffers->mValid[inAnimation]) {
+
+        color16_expand(lBuffers->mInput[inAnimation], ws2812_animation_get_panel(inAnimation), WS2812_NR_ROWS * WS2812_NR_COLUMNS);
+        lBuffers->mValid[inAnimation] = true;
+    }
+
+    return lBuffers->mInput[inAnimation];
+}
+
+
+/*! Cleanup one of the animation objects */
+static void ws2812_animation_clean(size_t inAnimation) {
+
+    ws2812_animation_cleanup(&sAnimationControl.mAnimation[inAnimation], sAnimationControl.mAnimationType[inAnimation]);
+
+    if(sAnimationControl.mKeyframes[inAnimation]) {
+
+        free(sAnimationControl.mKeyframes[inAnimation]);
+        sAnimationControl.mKeyframes[inAnimation] = NULL;
+    }
+}
+
+
+void ws2812_anim_interpolation(te_ws2812_animations inAnimation, bool inEnable) {
+
+    if(inAnimation < WS2812_ANIMATION_COUNT) {
+        sAnimationControl.mInterpolate[inAnimation] = inEnable;
+    }
+}
+
+
+void ws2812_anim_precision(te_ws2812_precision inPrecision) {
+
+    if(inPrecision <= WS2812_PRECISION_DITHER) {
+        sAnimationControl.mPrecision = inPrecision;
+    }
+}
+
+
+/*! Start a command
+
+    If the running animation has the same type and supports morphing, its
+    parameters are morphed within the instance instead of fading between
+    two animations.
+    If a transition is in progress, it is retargeted: the incoming
+    animation is morphed or replaced and the transition keeps its progress.
+*/
+static void ws2812_animation_start(ts_ws2812_anim_ctrl_cmd * pCommand) {
+
+    size_t lNext = (sAnimationControl.mCurrentAnimation + 1) & 1;
+    size_t lTarget = (sAnimationControl.mState == WS2812_ANIM_STATE_TRANSIT)? lNext : sAnimationControl.mCurrentAnimation;
+    tu_ws2812_anim * lAnimation = &sAnimationControl.mAnimation[lTarget];
+
+    /* measure until the first frame is out */
+    sAnimationControl.mLatencyStart   = pCommand->mTimestamp;
+    sAnimationControl.mLatencyPending = true;
+
+    if(sAnimationControl.mAnimationType[lTarget] == pCommand->mAnimation && lAnimation->mBase.mfMorph) {
+
+        lAnimation->mBase.mfMorph(lAnimation, &pCommand->mAnimParam, pCommand->mFrames);
+
+        if(sAnimationControl.mState == WS2812_ANIM_STATE_MAIN) {
+            sAnimationControl.mMorphFrames = (pCommand->mFrames > 0)? pCommand->mFrames : 1;
+            sAnimationControl.mMorphLength = sAnimationControl.mMorphFrames;
+            sAnimationControl.mMorphCycles = 0;
+        }
+
+        return;
+    }
+
+    if(sAnimationControl.mState == WS2812_ANIM_STATE_TRANSIT) {
+
+        /* drop the animation we were fading to */
+        ws2812_animation_clean(lNext);
+
+    } else {
+
+        /* go to transition state */
+        sAnimationControl.mState = WS2812_ANIM_STATE_TRANSIT;
+        sTransitionInitFuncs[pCommand->mTransition](&sAnimationControl.mTransition, &pCommand->mTransParam);
+
+        /* the outgoing panel still holds its last frame, which is the snapshot */
+        sAnimationControl.mOutgoingDivider  = sOutgoingDivider[pCommand->mOutgoing];
+        sAnimationControl.mTransitionFrame  = 0;
+        sAnimationControl.mTransitionCycles = 0;
+    }
+
+    /* a morph of the outgoing animation is not measured further */
+    sAnimationControl.mMorphFrames = 0;
+
+    /* init second animation */
+    ws2812_animation_create(lNext, pCommand->mAnimation, &pCommand->mAnimParam);
+}
+
+
+void ws2812_transition_done(void) {
+
+    /* cleanup */
+    ws2812_animation_clean(sAnimationControl.mCurrentAnimation);
+
+    /* switch animation */
+    sAnimationControl.mCurrentAnimation = (sAnimationControl.mCurrentAnimation + 1) & 1;
+
+    /* switch mode */
+    sAnimationControl.mState = WS2812_ANIM_STATE_MAIN;
+
+    /* leds show the transition, send the animation at least once */
+    sAnimationControl.mRefresh = 0;
+}
+
+
+/*! Set up the animation of a zone for its geometry */
+static void ws2812_zone_setup(ts_ws2812_zone * pThis) {
+
+    ws2812_animation_setup(pThis->mAnimation, pThis->mType, &pThis->mParam, pThis->mGeometry.mRows, pThis->mGeometry.mColumns);
+
+    pThis->mCountdown = 1;
+}
+
+
+/*! Scale a signed step per frame by the zone period, saturated to int16_t */
+static int16_t ws2812_zone_scale_int16(int16_t inStep, uint32_t inPeriod) {
+
+    /* 64 bit, the period goes up to 2^32 / WS2812_ANIMATION_DELAY_MS */
+    int64_t lStep = (int64_t)inStep * inPeriod;
+
+    if(lStep > INT16_MAX) {
+        return INT16_MAX;
+    } else if(lStep < INT16_MIN) {
+        return INT16_MIN;
+    }
+
+    return (int16_t)lStep;
+}
+
+
+/*! Scale an unsigned step per frame by the zone period, saturated to inMax */
+static uint32_t ws2812_zone_scale_uint(uint32_t inStep, uint32_t inPeriod, uint32_t inMax) {
+
+    uint64_t lStep = (uint64_t)inStep * inPeriod;
+
+    return (lStep > inMax)? inMax : (uint32_t)lStep;
+}
+
+
+/*! Start a command of a zone
+
+    A command for the running animation type is morphed if possible, all
+    other commands replace the animation right away.
+*/
+static void ws2812_zone_start(ts_ws2812_zone * pThis, ts_ws2812_anim_ctrl_cmd * pCommand) {
+
+    /* the rotation is given per frame, the zone renders every n-th frame */
+    if(pCommand->mAnimation == WS2812_ANIMATION_GRADIENT) {
+        pCommand->mAnimParam.mGradient.mRotation = ws2812_zone_scale_int16(pCommand->mAnimParam.mGradient.mRotation, pThis->mGeometry.mPeriod);
+    }
+
+    if(pCommand->mAnimation == WS2812_ANIMATION_TEXT) {
+        pCommand->mAnimParam.mText.mStep = (uint16_t)ws2812_zone_scale_uint(pCommand->mAnimParam.mText.mStep, pThis->mGeometry.mPeriod, UINT16_MAX);
+    }
+
+    if(pCommand->mAnimation == WS2812_ANIMATION_RAINBOW) {
+        pCommand->mAnimParam.mRainbow.mSpeed = ws2812_zone_scale_int16(pCommand->mAnimParam.mRainbow.mSpeed, pThis->mGeometry.mPeriod);
+    }
+
+    if(pCommand->mAnimation == WS2812_ANIMATION_PROGRAM) {
+        pCommand->mAnimParam.mProgram.mTimeStep = ws2812_zone_scale_uint(pCommand->mAnimParam.mProgram.mTimeStep, pThis->mGeometry.mPeriod, UINT32_MAX);
+    }
+
+    if(pCommand->mAnimation == WS2812_ANIMATION_GIF) {
+        pCommand->mAnimParam.mGif.mStep = ws2812_zone_scale_uint(pCommand->mAnimParam.mGif.mStep, pThis->mGeometry.mPeriod, UINT32_MAX);
+    }
+
+    if(pCommand->mAnimation == WS2812_ANIMATION_SEQ) {
+        pCommand->mAnimParam.mSeq.mStep = ws2812_zone_scale_uint(pCommand->mAnimParam.mSeq.mStep, pThis->mGeometry.mPeriod, UINT32_MAX);
+    }
+
+    pThis->mParam = pCommand->mAnimParam;
+
+    if(pThis->mType == pCommand->mAnimation && pThis->mAnimation->mBase.mfMorph) {
+
+        pThis->mAnimation->mBase.mfMorph(pThis->mAnimation, &pCommand->mAnimParam, pCommand->mFrames / pThis->mGeometry.mPeriod);
+
+    } else {
+
+        ws2812_animation_cleanup(pThis->mAnimation, pThis->mType);
+
+        pThis->mType = pCommand->mAnimation;
+
+        ws2812_zone_setup(pThis);
+    }
+}
+
+
+/*! Take over geometry changes and commands of all zones */
+static void ws2812_zones_apply(void) {
+
+    size_t lCount;
+    ts_ws2812_zone * lZone;
+    ts_ws2812_anim_ctrl_cmd * lCommand;
+
+    for(lCount = 0; lCount < WS2812_ZONES_MAX; lCount++) {
+
+        lZone = &sAnimationControl.mZone[lCount];
+
+        if(lZone->mGeometryPending) {
+
+            taskENTER_CRITICAL();
+
+            lZone->mGeometry        = lZone->mPendingGeometry;
+            lZone->mGeometryPending = false;
+
+            taskEXIT_CRITICAL();
+
+            if(lZone->mAnimation) {
+
+                ws2812_animation_cleanup(lZone->mAnimation, lZone->mType);
+            }
+
+            if(lZone->mGeometry.mRows == 0) {
+
+                /* removed */
+                free(lZone->mAnimation);
+                lZone->mAnimation = NULL;
+
+            } else {
+
+                if(lZone->mAnimation == NULL) {
+
+                    lZone->mAnimation = (tu_ws2812_anim*)malloc(sizeof(tu_ws2812_anim));
+
+                    if(lZone->mAnimation == NULL) {
+                        dbg_err("%s(%d): Failed allocating zone %u\r\n", __FILE__, __LINE__, (unsigned)lCount);
+                        continue;
+                    }
+
+                    /* new zones are black */
+                    lZone->mType = WS2812_ANIMATION_CONSTANT_COLOR;
+                    memset(&lZone->mParam, 0, sizeof(lZone->mParam));
+                }
+
+                ws2812_zone_setup(lZone);
+            }
+
+            /* the main animation has to be sent again to restore or compose the whole panel */
+            sAnimationControl.mRefresh = 0;
+        }
+
+        lCommand = ws2812_anim_mailbox_fetch(&lZone->mMailbox);
+
+        if(lCommand && lZone->mAnimation) {
+
+            ws2812_zone_start(lZone, lCommand);
+        }
+    }
+}
+
+
+/*! Copy the columns inFirst to inLast (excluding) of a row of a zone into the composite panel */
+static void ws2812_zone_blit_row(ts_ws2812_zone * pThis, size_t inRow, size_t inFirst, size_t inLast) {
+
+    tu_ws2812_anim * lAnimation = pThis->mAnimation;
+
+    size_t lColumns = pThis->mGeometry.mColumns;
+    size_t lColumn;
+    size_t lOffset;
+    color * lOut = &sAnimationControl.mComposite[(pThis->mGeometry.mRow + inRow) * WS2812_NR_COLUMNS + pThis->mGeometry.mColumn + inFirst];
+
+    if(lAnimation->mBase.mFlags & WS2812_ANIM_FLAG_STRIP) {
+
+        lOffset = (size_t)((lAnimation->mBase.mRowOffset[inRow] + (int32_t)inFirst) % (int32_t)lColumns + (int32_t)lColumns) % lColumns;
+
+        for(lColumn = inFirst; lColumn < inLast; lColumn++) {
+
+            *lOut++ = lAnimation->mBase.mStrip[lOffset];
+
+            if(++lOffset == lColumns) {
+                lOffset = 0;
+            }
+        }
+
+    } else {
+
+        memcpy(lOut, &lAnimation->mBase.mPanel[inRow * WS2812_NR_COLUMNS + inFirst], (inLast - inFirst) * sizeof(color));
+    }
+}
+
+
+/*! Copy the changed part of a zone into the composite panel and mark it dirty
+
+    \param[in]      inAll       Copy the whole zone
+    \param[in,out]  pDirty      Changed spans of the panel
+*/
+static void ws2812_zone_blit(ts_ws2812_zone * pThis, bool inAll, ts_ws2812_span * pDirty) {
+
+    tu_ws2812_anim * lAnimation = pThis->mAnimation;
+
+    size_t lRow;
+    size_t lFirst = 0;
+    size_t lLast  = pThis->mGeometry.mColumns;
+
+    /* a strip can't report spans */
+    if(!(lAnimation->mBase.mFlags & WS2812_ANIM_FLAG_SPANS) || (lAnimation->mBase.mFlags & WS2812_ANIM_FLAG_STRIP)) {
+        inAll = true;
+    }
+
+    for(lRow = 0; lRow < pThis->mGeometry.mRows; lRow++) {
+
+        if(!inAll) {
+
+            if(ws2812_span_empty(&lAnimation->mBase.mDirty[lRow])) {
+                continue;
+            }
+
+            lFirst = lAnimation->mBase.mDirty[lRow].mFirst;
+            lLast  = lAnimation->mBase.mDirty[lRow].mLast;
+        }
+
+        ws2812_zone_blit_row(pThis, lRow, lFirst, lLast);
+
+        ws2812_span_add(&pDirty[pThis->mGeometry.mRow + lRow], pThis->mGeometry.mColumn + lFirst, pThis->mGeometry.mColumn + lLast);
+    }
+}
+
+
+/*! Render the zones which are due and compose them over the main animation
+
+    Only the changed spans of the main animation are copied. Zones are
+    copied again where the main animation changed below them.
+
+    \param[in,out]  pOutput     Main output of this frame or NULL if it is unchanged,
+                                replaced by the composite panel or NULL if nothing changed
+    \param[in,out]  pRowOffset  Row offsets if the main output is a strip, NULL afterwards
+    \param[in,out]  pDirty      Changed spans of the main output, extended by the zones
+*/
+static void ws2812_zones_compose(color ** pOutput, const int16_t ** pRowOffset, ts_ws2812_span * pDirty) {
+
+    size_t lCount;
+    size_t lRow;
+    ts_ws2812_zone * lZone;
+    bool lActive = false;
+    bool lRendered[WS2812_ZONES_MAX];
+    bool lChanged = false;
+
+    for(lCount = 0; lCount < WS2812_ZONES_MAX; lCount++) {
+        lActive |= (sAnimationControl.mZone[lCount].mAnimation != NULL);
+    }
+
+    /* main animation only */
+    if(!lActive) {
+        return;
+    }
+
+    /* the main output is copied by the DMA while the zones render */
+    if(*pOutput) {
+
+        if(*pRowOffset) {
+
+            ws2812_queueLED_Strip(sAnimationControl.mComposite, *pOutput, *pRowOffset);
+            lChanged = true;
+
+        } else {
+
+            for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+
+                if(!ws2812_span_empty(&pDirty[lRow])) {
+
+                    ws2812_blit_copy(&sAnimationControl.mComposite[lRow * WS2812_NR_COLUMNS + pDirty[lRow].mFirst],
+                                     &(*pOutput)[lRow * WS2812_NR_COLUMNS + pDirty[lRow].mFirst],
+                                     (pDirty[lRow].mLast - pDirty[lRow].mFirst) * sizeof(color));
+
+                    lChanged = true;
+                }
+            }
+        }
+    } else {
+
+        ws2812_spans_clear(pDirty);
+    }
+
+    for(lCount = 0; lCount < WS2812_ZONES_MAX; lCount++) {
+
+        lZone             = &sAnimationControl.mZone[lCount];
+        lRendered[lCount] = false;
+
+        if(lZone->mAnimation == NULL || --lZone->mCountdown != 0) {
+            continue;
+        }
+
+        lZone->mCountdown = lZone->mGeometry.mPeriod;
+
+        if(!ws2812_animation_is_cached(lZone->mAnimation)) {
+
+            if(lZone->mAnimation->mBase.mFlags & WS2812_ANIM_FLAG_SPANS) {
+                ws2812_spans_clear(lZone->mAnimation->mBase.mDirty);
+            }
+
+            ws2812_animation_render(lZone->mAnimation);
+            lRendered[lCount] = true;
+        }
+    }
+
+    /* the zones go on top of the main output */
+    ws2812_blit_wait();
+
+    for(lCount = 0; lCount < WS2812_ZONES_MAX; lCount++) {
+
+        lZone = &sAnimationControl.mZone[lCount];
+
+        if(lZone->mAnimation == NULL) {
+            continue;
+        }
+
+        /* restore the zone where the main animation painted over it */
+        for(lRow = 0; lRow < lZone->mGeometry.mRows; lRow++) {
+
+            ts_ws2812_span * lSpan = &pDirty[lZone->mGeometry.mRow + lRow];
+
+            if(lSpan->mFirst < lZone->mGeometry.mColumn + lZone->mGeometry.mColumns &&
+               lSpan->mLast  > lZone->mGeometry.mColumn) {
+
+                ws2812_zone_blit_row(lZone, lRow, 0, lZone->mGeometry.mColumns);
+                ws2812_span_add(lSpan, lZone->mGeometry.mColumn, lZone->mGeometry.mColumn + lZone->mGeometry.mColumns);
+            }
+        }
+
+        if(lRendered[lCount]) {
+
+            ws2812_zone_blit(lZone, false, pDirty);
+            lChanged = true;
+        }
+    }
+
+    *pOutput    = lChanged? sAnimationControl.mComposite : NULL;
+    *pRowOffset = NULL;
+}
+
+
+void ws2812_animation_main(void) {
+
+    /* run at 100 Hz */
+    TickType_t lDelay = configTICK_RATE_HZ / WS2812_ANIMATION_FREQ;
+
+    ts_ws2812_anim_ctrl_cmd * lCommand;
+    color * lOutput = NULL;
+    const int16_t * lRowOffset = NULL;
+    uint32_t lStart;
+    uint32_t lCycles;
+    bool lTransit;
+    ts_ws2812_span lDirty[WS2812_NR_ROWS];
+
+    vTaskSetTimeOutState(&sAnimationControl.mTimeout);
+
+    /* only the latest command counts, older ones were overwritten */
+    lCommand = ws2812_anim_mailbox_fetch(&sAnimationControl.mMailbox);
+    if(lCommand) {
+        ws2812_animation_start(lCommand);
+    }
+
+    ws2812_zones_apply();
+
+    lStart   = ws2812_cycles();
+
+    sAnimationControl.mPrecise = ws2812_animation_is_precise();
+    lTransit = (sAnimationControl.mState == WS2812_ANIM_STATE_TRANSIT);
+
+    switch(sAnimationControl.mState) {
+
+        case WS2812_ANIM_STATE_TRANSIT: {
+
+                size_t lOutgoing = sAnimationControl.mCurrentAnimation;
+                size_t lIncoming = (sAnimationControl.mCurrentAnimation + 1) & 1;
+
+                /* run animation 1 at the selected rate */
+                if(sAnimationControl.mOutgoingDivider != 0 &&
+                   (sAnimationControl.mTransitionFrame % sAnimationControl.mOutgoingDivider) == 0) {
+
+                    ws2812_animation_update(lOutgoing, lDirty);
+                }
+                sAnimationControl.mTransitionFrame++;
+
+                /* run animation 2 */
+                ws2812_animation_update(lIncoming, lDirty);
+
+                if(sAnimationControl.mPrecise && sAnimationControl.mTransition.mBase.mfUpdate16) {
+
+                    color16 * lBlend = sAnimationControl.mPrecisionBuffers->mOutput;
+
+                    sAnimationControl.mTransition.mBase.mfUpdate16(&sAnimationControl.mTransition,
+                                                                   ws2812_animation_get_panel16(lOutgoing),
+                                                                   ws2812_animation_get_panel16(lIncoming),
+                                                                   lBlend);
+
+                    ws2812_animation_quantize(sAnimationControl.mTransition.mBase.mPanel, lBlend);
+
+                } else {
+
+                    sAnimationControl.mTransition.mBase.mfUpdate(&sAnimationControl.mTransition,
+                                                                 ws2812_animation_get_panel(lOutgoing),
+                                                                 ws2812_animation_get_panel(lIncoming));
+                }
+
+                /* update led from transition buffer */
+                lOutput = sAnimationControl.mTransition.mBase.mPanel;
+                ws2812_spans_full(lDirty);
+            }
+            break;
+        case WS2812_ANIM_STATE_MAIN:
+        default: {
+
+                tu_ws2812_anim * lAnimation = &sAnimationControl.mAnimation[sAnimationControl.mCurrentAnimation];
+
+                if(ws2812_animation_is_cached(lAnimation) && sAnimationControl.mRefresh > 0) {
+
+                    /* nothing changed, the leds still show the cached frame */
+                    sAnimationControl.mRefresh--;
+                    sAnimationControl.mStats.mFramesSkipped++;
+                    ws2812_spans_clear(lDirty);
+
+                } else {
+
+                    /* run animation, update led from its output */
+                    lOutput = ws2812_animation_update(sAnimationControl.mCurrentAnimation, lDirty);
+
+                    /* the driver copies a strip to all rows */
+                    if(sAnimationControl.mOutputStrip[sAnimationControl.mCurrentAnimation]) {
+                        lRowOffset = lAnimation->mBase.mRowOffset;
+                    }
+
+                    /* animations reporting spans are sent completely once in a while, too */
+                    if(!(lAnimation->mBase.mFlags & WS2812_ANIM_FLAG_SPANS) || sAnimationControl.mRefresh == 0) {
+
+                        ws2812_spans_full(lDirty);
+                        sAnimationControl.mRefresh = WS2812_ANIMATION_REFRESH;
+
+                    } else {
+
+                        sAnimationControl.mRefresh--;
+                    }
+                }
+            }
+            break;
+    }
+
+    /* put the zones on top */
+    ws2812_zones_compose(&lOutput, &lRowOffset, lDirty);
+
+    lCycles = ws2812_cycles() - lStart;
+
+    if(lOutput) {
+
+        sAnimationControl.mStats.mFrameCycles      = lCycles;
+        sAnimationControl.mStats.mBlitCyclesSaved  = ws2812_blit_saved();
+        sAnimationControl.mStats.mAudioCycles      = ws2812_anim_audio_cycles();
+
+        if(lRowOffset) {
+
+            ws2812_updateLED_Strip(lOutput, lRowOffset);
+
+            sAnimationControl.mStats.mDirtyLeds = WS2812_NR_ROWS * WS2812_NR_COLUMNS;
+            sAnimationControl.mStats.mSentLeds  = WS2812_NR_ROWS * WS2812_NR_COLUMNS;
+
+        } else {
+
+            size_t lRow;
+
+            sAnimationControl.mStats.mDirtyLeds = 0;
+            for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+
+                if(!ws2812_span_empty(&lDirty[lRow])) {
+                    sAnimationControl.mStats.mDirtyLeds += lDirty[lRow].mLast - lDirty[lRow].mFirst;
+                }
+            }
+
+            sAnimationControl.mStats.mSentLeds = ws2812_updateLED_Spans(lOutput, lDirty);
+        }
+    }
+
+    if(sAnimationControl.mMorphFrames > 0) {
+
+        sAnimationControl.mMorphCycles += lCycles;
+
+        /* morph is over */
+        if(--sAnimationControl.mMorphFrames == 0) {
+            sAnimationControl.mStats.mMorphFrameCycles = sAnimationControl.mMorphCycles / sAnimationControl.mMorphLength;
+        }
+    }
+
+    if(lTransit) {
+
+        sAnimationControl.mTransitionCycles += lCycles;
+
+        /* transition is over */
+        if(sAnimationControl.mState != WS2812_ANIM_STATE_TRANSIT) {
+            sAnimationControl.mStats.mTransitionFrameCycles = sAnimationControl.mTransitionCycles / sAnimationControl.mTransitionFrame;
+        }
+    }
+
+    /* first frame of the last command is out */
+    if(sAnimationControl.mLatencyPending) {
+
+        uint32_t lLatency = (xTaskGetTickCount() - sAnimationControl.mLatencyStart) * portTICK_PERIOD_MS;
+
+        sAnimationControl.mStats.mCommandLatency = lLatency;
+        if(lLatency > sAnimationControl.mStats.mCommandLatencyMax) {
+            sAnimationControl.mStats.mCommandLatencyMax = lLatency;
+        }
+
+        sAnimationControl.mLatencyPending = false;
+    }
+
+    /* Adapt the timeout according to the animation's request */
+    if(xTaskCheckForTimeOut(&sAnimationControl.mTimeout, &lDelay)) {
+
+        dbg_err("%s(%d): timed out!\r\n", __FILE__, __LINE__);
+
+        lDelay = 0; // timed out
+    } // xTaskCheckForTimeOut adapts lDelay to fit to the timeout
+
+    /* wait for the next frame, a new command cuts this short */
+    xSemaphoreTake(sAnimationControl.mWakeup, lDelay);
+}
+
+
+void ws2812_animation_get_stats(ts_ws2812_anim_stats * outStats) {
+
+    *outStats = sAnimationControl.mStats;
+
+    outStats->mCommandsCoalesced = sAnimationControl.mMailbox.mCoalesced;
+}
+
+
+void ws2812_anim_transition(uint32_t inDuration, te_ws2812_transition_outgoing inOutgoing) {
+
+    /* commands are filled with the scheduler suspended, they never see half of the settings */
+    vTaskSuspendAll();
+
+    sAnimationControl.mTransitionDuration = inDuration;
+
+    if(inOutgoing <= WS2812_TRANSITION_OUTGOING_SNAPSHOT) {
+        sAnimationControl.mTransitionOutgoing = inOutgoing;
+    }
+
+    xTaskResumeAll();
+}
+
+
+/*! Fill in a constant color command */
+static void ws2812_animation_cmd_const_color(ts_ws2812_anim_ctrl_cmd * pCommand, uint8_t inRed, uint8_t inGreen, uint8_t inBlue) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_CONSTANT_COLOR;
+    pCommand->mAnimParam.mConstantColor.mColor.R = inRed;
+    pCommand->mAnimParam.mConstantColor.mColor.G = inGreen;
+    pCommand->mAnimParam.mConstantColor.mColor.B = inBlue;
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+/*! Fill in a gradient command */
+static void ws2812_animation_cmd_gradient(ts_ws2812_anim_ctrl_cmd * pCommand,
+                                          uint8_t inFirstRed, uint8_t inFirstGreen, uint8_t inFirstBlue,
+                                          uint8_t inSecondRed, uint8_t inSecondGreen, uint8_t inSecondBlue,
+                                          int16_t inAngle, int16_t inRotation) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_GRADIENT;
+    pCommand->mAnimParam.mGradient.mFirstColor.R = inFirstRed;
+    pCommand->mAnimParam.mGradient.mFirstColor.G = inFirstGreen;
+    pCommand->mAnimParam.mGradient.mFirstColor.B = inFirstBlue;
+
+    pCommand->mAnimParam.mGradient.mSecondColor.R = inSecondRed;
+    pCommand->mAnimParam.mGradient.mSecondColor.G = inSecondGreen;
+    pCommand->mAnimParam.mGradient.mSecondColor.B = inSecondBlue;
+
+    pCommand->mAnimParam.mGradient.mAngle = inAngle;
+
+    /* degree per second to angle units per frame */
+    pCommand->mAnimParam.mGradient.mRotation = (int16_t)(((int32_t)inRotation * MT_ANGLE16_FULL) / (360 * WS2812_ANIMATION_FREQ));
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+/*! Fill in a palette command */
+static void ws2812_animation_cmd_palette(ts_ws2812_anim_ctrl_cmd * pCommand, te_color_palettes inPalette) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_PALETTE;
+    pCommand->mAnimParam.mPalette.mPalette = inPalette;
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+/*! Fill in a fire command */
+static void ws2812_animation_cmd_fire(ts_ws2812_anim_ctrl_cmd * pCommand, te_color_palettes inPalette) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_FIRE;
+    pCommand->mAnimParam.mFire.mPalette = inPalette;
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+/*! Fill in a plasma command */
+static void ws2812_animation_cmd_plasma(ts_ws2812_anim_ctrl_cmd * pCommand, te_color_palettes inPalette) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_PLASMA;
+    pCommand->mAnimParam.mPlasma.mPalette = inPalette;
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+/*! Fill in a clouds command */
+static void ws2812_animation_cmd_clouds(ts_ws2812_anim_ctrl_cmd * pCommand, te_color_palettes inPalette) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_CLOUDS;
+    pCommand->mAnimParam.mClouds.mPalette = inPalette;
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+/*! Fill in a rainbow command */
+static void ws2812_animation_cmd_rainbow(ts_ws2812_anim_ctrl_cmd * pCommand,
+                                         int16_t inSpeed, uint16_t inLength, uint8_t inSaturation, uint8_t inValue) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_RAINBOW;
+
+    /* a full circle of hue is 65536 */
+    pCommand->mAnimParam.mRainbow.mSpeed      = (int16_t)(((int32_t)inSpeed * 65536) / (360 * WS2812_ANIMATION_FREQ));
+    pCommand->mAnimParam.mRainbow.mStep       = (int16_t)((inLength > 0)? 65536u / inLength : 0);
+    pCommand->mAnimParam.mRainbow.mSaturation = inSaturation;
+    pCommand->mAnimParam.mRainbow.mValue      = inValue;
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+/*! Fill in a particles command */
+static void ws2812_animation_cmd_particles(ts_ws2812_anim_ctrl_cmd * pCommand, te_ws2812_particle_effects inEffect, te_color_palettes inPalette) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_PARTICLES;
+    pCommand->mAnimParam.mParticles.mEffect  = inEffect;
+    pCommand->mAnimParam.mParticles.mPalette = inPalette;
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+/*! Fill in a cellular automaton command */
+static void ws2812_animation_cmd_cells(ts_ws2812_anim_ctrl_cmd * pCommand, te_ws2812_cell_rules inRule, te_color_palettes inPalette) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_CELLS;
+    pCommand->mAnimParam.mCells.mRule    = inRule;
+    pCommand->mAnimParam.mCells.mPalette = inPalette;
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+/*! Fill in a program command */
+static void ws2812_animation_cmd_program(ts_ws2812_anim_ctrl_cmd * pCommand, size_t inSlot, te_color_palettes inPalette) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_PROGRAM;
+    pCommand->mAnimParam.mProgram.mSlot     = inSlot;
+    pCommand->mAnimParam.mProgram.mPalette  = inPalette;
+    pCommand->mAnimParam.mProgram.mTimeStep = WS2812_VM_ONE / WS2812_ANIMATION_FREQ;
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+/*! Fill in a GIF command */
+static void ws2812_animation_cmd_gif(ts_ws2812_anim_ctrl_cmd * pCommand, te_ws2812_gif_fit inFit) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_GIF;
+    pCommand->mAnimParam.mGif.mFit = inFit;
+
+    /* GIF delays are in 1/100 s */
+    pCommand->mAnimParam.mGif.mStep = 100 / WS2812_ANIMATION_FREQ;
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+#ifdef WS2812_ANIM_SEQ
+/*! Fill in a frame sequence command */
+static void ws2812_animation_cmd_seq(ts_ws2812_anim_ctrl_cmd * pCommand, const char * inPath) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_SEQ;
+
+    strncpy(pCommand->mAnimParam.mSeq.mPath, inPath, sizeof(pCommand->mAnimParam.mSeq.mPath) - 1);
+    pCommand->mAnimParam.mSeq.mPath[sizeof(pCommand->mAnimParam.mSeq.mPath) - 1] = '\0';
+
+    /* frame delays are in 1/100 s */
+    pCommand->mAnimParam.mSeq.mStep = 100 / WS2812_ANIMATION_FREQ;
+
+    ws2812_animation_set_transition(pCommand);
+}
+#endif /* WS2812_ANIM_SEQ */
+
+
+/*! Fill in an audio command */
+static void ws2812_animation_cmd_audio(ts_ws2812_anim_ctrl_cmd * pCommand, te_ws2812_audio_view inView, te_color_palettes inPalette) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_AUDIO;
+    pCommand->mAnimParam.mAudio.mView    = inView;
+    pCommand->mAnimParam.mAudio.mPalette = inPalette;
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+/*! Fill in a text command */
+static void ws2812_animation_cmd_text(ts_ws2812_anim_ctrl_cmd * pCommand, const char * inText,
+                                      uint8_t inRed, uint8_t inGreen, uint8_t inBlue,
+                                      uint8_t inBackRed, uint8_t inBackGreen, uint8_t inBackBlue,
+                                      uint16_t inSpeed) {
+
+    pCommand->mAnimation = WS2812_ANIMATION_TEXT;
+
+    /* decoded here, the animation task only deals with Latin-1 */
+    ws2812_font_from_utf8(pCommand->mAnimParam.mText.mText, sizeof(pCommand->mAnimParam.mText.mText), inText);
+
+    pCommand->mAnimParam.mText.mForeground.R = inRed;
+    pCommand->mAnimParam.mText.mForeground.G = inGreen;
+    pCommand->mAnimParam.mText.mForeground.B = inBlue;
+
+    pCommand->mAnimParam.mText.mBackground.R = inBackRed;
+    pCommand->mAnimParam.mText.mBackground.G = inBackGreen;
+    pCommand->mAnimParam.mText.mBackground.B = inBackBlue;
+
+    /* columns per second to 8.8 columns per frame */
+    pCommand->mAnimParam.mText.mStep = (uint16_t)(((uint32_t)inSpeed << 8) / WS2812_ANIMATION_FREQ);
+
+    ws2812_animation_set_transition(pCommand);
+}
+
+
+void ws2812_anim_const_color(uint8_t inRed, uint8_t inGreen, uint8_t inBlue) {
+
+    ws2812_animation_cmd_const_color(ws2812_animation_reserve(&sAnimationControl.mMailbox), inRed, inGreen, inBlue);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+void ws2812_anim_gradient(uint8_t inFirstRed, uint8_t inFirstGreen, uint8_t inFirstBlue,
+                          uint8_t inSecondRed, uint8_t inSecondGreen, uint8_t inSecondBlue,
+                          int16_t inAngle, int16_t inRotation) {
+
+    ws2812_animation_cmd_gradient(ws2812_animation_reserve(&sAnimationControl.mMailbox),
+                                  inFirstRed, inFirstGreen, inFirstBlue, inSecondRed, inSecondGreen, inSecondBlue,
+                                  inAngle, inRotation);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+void ws2812_anim_palette(te_color_palettes inPalette) {
+
+    ws2812_animation_cmd_palette(ws2812_animation_reserve(&sAnimationControl.mMailbox), inPalette);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+void ws2812_anim_fire(te_color_palettes inPalette) {
+
+    ws2812_animation_cmd_fire(ws2812_animation_reserve(&sAnimationControl.mMailbox), inPalette);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+void ws2812_anim_plasma(te_color_palettes inPalette) {
+
+    ws2812_animation_cmd_plasma(ws2812_animation_reserve(&sAnimationControl.mMailbox), inPalette);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+void ws2812_anim_clouds(te_color_palettes inPalette) {
+
+    ws2812_animation_cmd_clouds(ws2812_animation_reserve(&sAnimationControl.mMailbox), inPalette);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+void ws2812_anim_rainbow(int16_t inSpeed, uint16_t inLength, uint8_t inSaturation, uint8_t inValue) {
+
+    ws2812_animation_cmd_rainbow(ws2812_animation_reserve(&sAnimationControl.mMailbox),
+                                 inSpeed, inLength, inSaturation, inValue);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+void ws2812_anim_particles(te_ws2812_particle_effects inEffect, te_color_palettes inPalette) {
+
+    ws2812_animation_cmd_particles(ws2812_animation_reserve(&sAnimationControl.mMailbox), inEffect, inPalette);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+void ws2812_anim_cells(te_ws2812_cell_rules inRule, te_color_palettes inPalette) {
+
+    ws2812_animation_cmd_cells(ws2812_animation_reserve(&sAnimationControl.mMailbox), inRule, inPalette);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+void ws2812_anim_program(size_t inSlot, te_color_palettes inPalette) {
+
+    ws2812_animation_cmd_program(ws2812_animation_reserve(&sAnimationControl.mMailbox), inSlot, inPalette);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+void ws2812_anim_gif(te_ws2812_gif_fit inFit) {
+
+    ws2812_animation_cmd_gif(ws2812_animation_reserve(&sAnimationControl.mMailbox), inFit);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+#ifdef WS2812_ANIM_SEQ
+void ws2812_anim_seq(const char * inPath) {
+
+    ws2812_animation_cmd_seq(ws2812_animation_reserve(&sAnimationControl.mMailbox), inPath);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+#endif /* WS2812_ANIM_SEQ */
+
+
+void ws2812_anim_audio(te_ws2812_audio_view inView, te_color_palettes inPalette) {
+
+    ws2812_animation_cmd_audio(ws2812_animation_reserve(&sAnimationControl.mMailbox), inView, inPalette);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+void ws2812_anim_text(const char * inText,
+                      uint8_t inRed, uint8_t inGreen, uint8_t inBlue,
+                      uint8_t inBackRed, uint8_t inBackGreen, uint8_t inBackBlue,
+                      uint16_t inSpeed) {
+
+    ws2812_animation_cmd_text(ws2812_animation_reserve(&sAnimationControl.mMailbox), inText,
+                              inRed, inGreen, inBlue, inBackRed, inBackGreen, inBackBlue, inSpeed);
+
+    ws2812_animation_post(&sAnimationControl.mMailbox);
+}
+
+
+bool ws2812_zone_set(size_t inZone, size_t inRow, size_t inColumn, size_t inRows, size_t inColumns, uint32_t inPeriod) {
+
+    ts_ws2812_zone * lZone;
+
+    if(inZone >= WS2812_ZONES_MAX || inRow + inRows > WS2812_NR_ROWS || inColumn + inColumns > WS2812_NR_COLUMNS) {
+        return false;
+    }
+
+    lZone = &sAnimationControl.mZone[inZone];
+
+    taskENTER_CRITICAL();
+
+    lZone->mPendingGeometry.mRow     = inRow;
+    lZone->mPendingGeometry.mColumn  = inColumn;
+    lZone->mPendingGeometry.mRows    = (inColumns > 0)? inRows : 0;
+    lZone->mPendingGeometry.mColumns = inColumns;
+    lZone->mPendingGeometry.mPeriod  = (inPeriod > WS2812_ANIMATION_DELAY_MS)? inPeriod / WS2812_ANIMATION_DELAY_MS : 1;
+    lZone->mGeometryPending          = true;
+
+    taskEXIT_CRITICAL();
+
+    return true;
+}
+
+
+void ws2812_zone_remove(size_t inZone) {
+
+    ws2812_zone_set(inZone, 0, 0, 0, 0, 0);
+}
+
+
+void ws2812_zone_const_color(size_t inZone, uint8_t inRed, uint8_t inGreen, uint8_t inBlue) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_const_color(ws2812_animation_reserve(lMailbox), inRed, inGreen, inBlue);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+void ws2812_zone_gradient(size_t inZone,
+                          uint8_t inFirstRed, uint8_t inFirstGreen, uint8_t inFirstBlue,
+                          uint8_t inSecondRed, uint8_t inSecondGreen, uint8_t inSecondBlue,
+                          int16_t inAngle, int16_t inRotation) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_gradient(ws2812_animation_reserve(lMailbox),
+                                      inFirstRed, inFirstGreen, inFirstBlue, inSecondRed, inSecondGreen, inSecondBlue,
+                                      inAngle, inRotation);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+void ws2812_zone_palette(size_t inZone, te_color_palettes inPalette) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_palette(ws2812_animation_reserve(lMailbox), inPalette);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+void ws2812_zone_fire(size_t inZone, te_color_palettes inPalette) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_fire(ws2812_animation_reserve(lMailbox), inPalette);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+
+void ws2812_zone_plasma(size_t inZone, te_color_palettes inPalette) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_plasma(ws2812_animation_reserve(lMailbox), inPalette);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+void ws2812_zone_clouds(size_t inZone, te_color_palettes inPalette) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_clouds(ws2812_animation_reserve(lMailbox), inPalette);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+void ws2812_zone_rainbow(size_t inZone, int16_t inSpeed, uint16_t inLength, uint8_t inSaturation, uint8_t inValue) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_rainbow(ws2812_animation_reserve(lMailbox), inSpeed, inLength, inSaturation, inValue);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+void ws2812_zone_particles(size_t inZone, te_ws2812_particle_effects inEffect, te_color_palettes inPalette) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_particles(ws2812_animation_reserve(lMailbox), inEffect, inPalette);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+void ws2812_zone_cells(size_t inZone, te_ws2812_cell_rules inRule, te_color_palettes inPalette) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_cells(ws2812_animation_reserve(lMailbox), inRule, inPalette);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+void ws2812_zone_program(size_t inZone, size_t inSlot, te_color_palettes inPalette) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_program(ws2812_animation_reserve(lMailbox), inSlot, inPalette);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+void ws2812_zone_gif(size_t inZone, te_ws2812_gif_fit inFit) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_gif(ws2812_animation_reserve(lMailbox), inFit);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+#ifdef WS2812_ANIM_SEQ
+void ws2812_zone_seq(size_t inZone, const char * inPath) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_seq(ws2812_animation_reserve(lMailbox), inPath);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+#endif /* WS2812_ANIM_SEQ */
+
+
+void ws2812_zone_audio(size_t inZone, te_ws2812_audio_view inView, te_color_palettes inPalette) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_audio(ws2812_animation_reserve(lMailbox), inView, inPalette);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
+
+void ws2812_zone_text(size_t inZone, const char * inText,
+                      uint8_t inRed, uint8_t inGreen, uint8_t inBlue,
+                      uint8_t inBackRed, uint8_t inBackGreen, uint8_t inBackBlue,
+                      uint16_t inSpeed) {
+
+    if(inZone < WS2812_ZONES_MAX) {
+
+        ts_ws2812_anim_mailbox * lMailbox = &sAnimationControl.mZone[inZone].mMailbox;
+
+        ws2812_animation_cmd_text(ws2812_animation_reserve(lMailbox), inText,
+                                  inRed, inGreen, inBlue, inBackRed, inBackGreen, inBackBlue, inSpeed);
+
+        ws2812_animation_post(lMailbox);
+    }
+}
+
 
 /* eof */
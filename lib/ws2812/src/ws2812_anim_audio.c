@@ -0,0 +1,223 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "ws2812.h"
+
+#include "ws2812_anim.h"
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_audio.h"
+#include "ws2812_cycles.h"
+
+#include "mt_arithm.h"
+
+
+/*! Palette steps the pulse view moves on with every beat */
+#define WS2812_ANIM_AUDIO_HUE_STEP  (40)
+
+
+/*! Samples fed by the audio source, shared by all audio animations */
+static ts_ws2812_audio_ring sAudioRing;
+
+/*! Core cycles of the last analysis */
+static uint32_t sAudioCycles;
+
+
+void ws2812_audio_feed(const int16_t * inSamples, size_t inFrames, size_t inChannels) {
+
+    ws2812_audio_ring_push(&sAudioRing, inSamples, inFrames, inChannels);
+}
+
+
+uint32_t ws2812_anim_audio_cycles(void) {
+
+    return sAudioCycles;
+}
+
+
+/*! Bars of the bands growing up from row 0, the top led of a bar dimmed by the rest of its level */
+static void ws2812_anim_audio_draw_spectrum(tu_ws2812_anim * pThis, const ts_ws2812_audio * inAudio) {
+
+    size_t lCountX;
+    size_t lCountY;
+    size_t lFull;
+    uint32_t lHeight;
+    color lColor;
+    color * lLed;
+
+    for(lCountX = 0; lCountX < pThis->mBase.mColumns; lCountX++) {
+
+        lHeight = inAudio->mBands[(lCountX * WS2812_AUDIO_BANDS) / pThis->mBase.mColumns] * (uint32_t)pThis->mBase.mRows;
+        lFull   = lHeight >> 8;
+
+        color_palette_get(&pThis->mAudio.mCurrent, &lColor, (uint8_t)((lCountX * 255) / pThis->mBase.mColumns));
+
+        for(lCountY = 0; lCountY < pThis->mBase.mRows; lCountY++) {
+
+            lLed = &pThis->mBase.mPanel[lCountY * WS2812_NR_COLUMNS + lCountX];
+
+            if(lCountY < lFull) {
+
+                *lLed = lColor;
+
+            } else if(lCountY == lFull) {
+
+                *lLed = lColor;
+                nscale8x3(&lLed->R, &lLed->G, &lLed->B, (uint8_t)lHeight);
+
+            } else {
+
+                memset(lLed, 0, sizeof(color));
+            }
+        }
+    }
+}
+
+
+/*! Level bar along the columns with the peak on top, the same on every row */
+static void ws2812_anim_audio_draw_vu(tu_ws2812_anim * pThis, const ts_ws2812_audio * inAudio) {
+
+    size_t lCountX;
+    size_t lCountY;
+    size_t lFull;
+    size_t lPeak;
+    uint32_t lLength;
+    color * lLed = pThis->mBase.mPanel;
+
+    lLength = inAudio->mLevel * (uint32_t)pThis->mBase.mColumns;
+    lFull   = lLength >> 8;
+    lPeak   = (inAudio->mPeak * (pThis->mBase.mColumns - 1)) / 255;
+
+    for(lCountX = 0; lCountX < pThis->mBase.mColumns; lCountX++) {
+
+        if(lCountX < lFull) {
+
+            color_palette_get(&pThis->mAudio.mCurrent, &lLed[lCountX], (uint8_t)((lCountX * 255) / pThis->mBase.mColumns));
+
+        } else if(lCountX == lFull) {
+
+            color_palette_get(&pThis->mAudio.mCurrent, &lLed[lCountX], (uint8_t)((lCountX * 255) / pThis->mBase.mColumns));
+            nscale8x3(&lLed[lCountX].R, &lLed[lCountX].G, &lLed[lCountX].B, (uint8_t)lLength);
+
+        } else {
+
+            memset(&lLed[lCountX], 0, sizeof(color));
+        }
+    }
+
+    if(inAudio->mPeak > 0) {
+        color_palette_get(&pThis->mAudio.mCurrent, &lLed[lPeak], 255);
+    }
+
+    for(lCountY = 1; lCountY < pThis->mBase.mRows; lCountY++) {
+        memcpy(&lLed[lCountY * WS2812_NR_COLUMNS], lLed, pThis->mBase.mColumns * sizeof(color));
+    }
+}
+
+
+/*! The whole panel flashes with every beat and fades out */
+static void ws2812_anim_audio_draw_pulse(tu_ws2812_anim * pThis, const ts_ws2812_audio * inAudio) {
+
+    size_t lCountX;
+    size_t lCountY;
+    color lColor;
+
+    if(inAudio->mBeat) {
+        pThis->mAudio.mHue += WS2812_ANIM_AUDIO_HUE_STEP;
+    }
+
+    color_palette_get(&pThis->mAudio.mCurrent, &lColor, pThis->mAudio.mHue);
+    nscale8x3(&lColor.R, &lColor.G, &lColor.B, inAudio->mPulse);
+
+    for(lCountY = 0; lCountY < pThis->mBase.mRows; lCountY++) {
+        for(lCountX = 0; lCountX < pThis->mBase.mColumns; lCountX++) {
+            pThis->mBase.mPanel[lCountY * WS2812_NR_COLUMNS + lCountX] = lColor;
+        }
+    }
+}
+
+
+static void ws2812_anim_audio_update(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_audio_analysis * lAnalysis = pThis->mAudio.mAnalysis;
+    uint32_t lStart;
+
+    if(lAnalysis) {
+
+        lStart = ws2812_cycles();
+
+        /* without new samples the levels fall as if it was silent */
+        if(ws2812_audio_ring_read(&sAudioRing, lAnalysis->mBlock, &pThis->mAudio.mRead)) {
+            ws2812_audio_analyze(&lAnalysis->mAudio, lAnalysis->mBlock);
+        } else {
+            ws2812_audio_analyze(&lAnalysis->mAudio, NULL);
+        }
+
+        sAudioCycles = ws2812_cycles() - lStart;
+
+        if(ws2812_anim_morph_active(&pThis->mAudio.mMorph)) {
+
+            color_palette_blend(&pThis->mAudio.mCurrent, &pThis->mAudio.mFrom, color_palette_from_enum(pThis->mAudio.mPalette),
+                                ws2812_anim_morph_step(&pThis->mAudio.mMorph));
+        }
+
+        switch(pThis->mAudio.mView) {
+
+            case WS2812_AUDIO_VU:
+                ws2812_anim_audio_draw_vu(pThis, &lAnalysis->mAudio);
+                break;
+
+            case WS2812_AUDIO_PULSE:
+                ws2812_anim_audio_draw_pulse(pThis, &lAnalysis->mAudio);
+                break;
+
+            case WS2812_AUDIO_SPECTRUM:
+            default:
+                ws2812_anim_audio_draw_spectrum(pThis, &lAnalysis->mAudio);
+                break;
+        }
+    }
+}
+
+
+static void ws2812_anim_audio_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    /* the analysis goes on, the palette blends and the view switches at once */
+    pThis->mAudio.mFrom    = pThis->mAudio.mCurrent;
+    pThis->mAudio.mPalette = pParam->mAudio.mPalette;
+    pThis->mAudio.mView    = pParam->mAudio.mView;
+
+    ws2812_anim_morph_start(&pThis->mAudio.mMorph, inFrames);
+}
+
+
+void ws2812_anim_audio_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
+
+    pThis->mBase.mfUpdate        = ws2812_anim_audio_update;
+    pThis->mBase.mfMorph         = ws2812_anim_audio_morph;
+    pThis->mAudio.mView          = pParam->mAudio.mView;
+    pThis->mAudio.mPalette       = pParam->mAudio.mPalette;
+    pThis->mAudio.mCurrent       = *color_palette_from_enum(pParam->mAudio.mPalette);
+    pThis->mAudio.mMorph.mFrame  = 0;
+    pThis->mAudio.mMorph.mFrames = 0;
+    pThis->mAudio.mHue           = 0;
+
+    /* only samples fed from now on count as new */
+    pThis->mAudio.mRead = sAudioRing.mWritten;
+
+    pThis->mAudio.mAnalysis = (ts_ws2812_anim_audio_analysis*)malloc(sizeof(ts_ws2812_anim_audio_analysis));
+    if(pThis->mAudio.mAnalysis) {
+        ws2812_audio_init(&pThis->mAudio.mAnalysis->mAudio);
+    } else {
+        printf("%s(%d): malloc failed!\r\n", __FILE__, __LINE__);
+    }
+}
+
+
+void ws2812_anim_audio_clean(tu_ws2812_anim * pThis) {
+
+    free(pThis->mAudio.mAnalysis);
+}
+
+
+/* eof */
@@ -0,0 +1,372 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "ws2812.h"
+
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_cells.h"
+#include "ws2812_anim_p.h"
+
+#include "mt_arithm.h"
+
+
+/*! Frames per generation of Life (10 Hz) */
+#define WS2812_ANIM_CELLS_LIFE_DIVIDER      (10)
+
+/*! Frames per step of sand (25 Hz) */
+#define WS2812_ANIM_CELLS_SAND_DIVIDER      (4)
+
+/*! Life is seeded again after this many generations without population change */
+#define WS2812_ANIM_CELLS_LIFE_STALE        (50)
+
+/*! Level of calm water */
+#define WS2812_ANIM_CELLS_WATER             (128)
+
+
+/*! Sum of the 4 direct neighbours / 4 */
+static const ts_ws2812_stencil sRippleStencil = {
+    .mWeight = { { 0, 1, 0 }, { 1, 0, 1 }, { 0, 1, 0 } },
+    .mShift  = 2,
+};
+
+/*! Gaussian blur */
+static const ts_ws2812_stencil sHeatStencil = {
+    .mWeight = { { 1, 2, 1 }, { 2, 4, 2 }, { 1, 2, 1 } },
+    .mShift  = 4,
+};
+
+
+/*! Random number from 0 to inRange - 1 */
+static inline uint32_t ws2812_anim_cells_random(tu_ws2812_anim * pThis, uint32_t inRange) {
+
+    return pcg32_bounded(&pThis->mCells.mRandom, inRange);
+}
+
+
+/*! Fill the binary cells with a random pattern, 3 of 8 cells alive */
+static void ws2812_anim_cells_seed(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_cells_row * lRows = pThis->mCells.mBits[pThis->mCells.mCurrent];
+    ts_pcg32 * lRandom = &pThis->mCells.mRandom;
+    size_t lRow;
+    size_t lWord;
+
+    for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+        for(lWord = 0; lWord < WS2812_CELLS_WORDS; lWord++) {
+            lRows[lRow][lWord] = pcg32(lRandom) & (pcg32(lRandom) | pcg32(lRandom));
+        }
+    }
+
+    ws2812_cells_mask(lRows, pThis->mBase.mRows, pThis->mBase.mColumns);
+
+    pThis->mCells.mStale = 0;
+}
+
+
+/*! Start the current rule from scratch */
+static void ws2812_anim_cells_reset(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_cells * lCells = &pThis->mCells;
+
+    memset(lCells->mBits, 0, sizeof(lCells->mBits));
+
+    lCells->mCurrent       = 0;
+    lCells->mPopulation[0] = 0;
+    lCells->mPopulation[1] = 0;
+    lCells->mStale         = 0;
+
+    /* calm water or cold */
+    if(lCells->mField) {
+        memset(lCells->mField->mLevels, (lCells->mRule == WS2812_CELLS_RIPPLE)? WS2812_ANIM_CELLS_WATER : 0,
+               sizeof(lCells->mField->mLevels));
+    }
+
+    if(lCells->mRule == WS2812_CELLS_LIFE) {
+        ws2812_anim_cells_seed(pThis);
+    }
+}
+
+
+/*! Next generation of Life, seeded again when it died out or got stuck */
+static void ws2812_anim_cells_life(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_cells * lCells = &pThis->mCells;
+    size_t lNext = lCells->mCurrent ^ 1;
+    size_t lPopulation;
+
+    ws2812_cells_life(lCells->mBits[lNext], lCells->mBits[lCells->mCurrent], pThis->mBase.mRows, pThis->mBase.mColumns);
+
+    lCells->mCurrent = lNext;
+
+    /* still lifes and blinkers repeat the population of one of the last two generations */
+    lPopulation = ws2812_cells_count(lCells->mBits[lNext], pThis->mBase.mRows);
+
+    if(lPopulation == lCells->mPopulation[0] || lPopulation == lCells->mPopulation[1]) {
+        lCells->mStale++;
+    } else {
+        lCells->mStale = 0;
+    }
+
+    lCells->mPopulation[1] = lCells->mPopulation[0];
+    lCells->mPopulation[0] = lPopulation;
+
+    if(lPopulation == 0 || lCells->mStale >= WS2812_ANIM_CELLS_LIFE_STALE) {
+        ws2812_anim_cells_seed(pThis);
+    }
+}
+
+
+/*! Drop a grain in the top row and let the sand fall, start over when the pile reached the top */
+static void ws2812_anim_cells_sand(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_cells * lCells = &pThis->mCells;
+    ts_ws2812_cells_row * lRows = lCells->mBits[lCells->mCurrent];
+
+    if(ws2812_cells_count(lRows, 1) > pThis->mBase.mColumns / 4) {
+        memset(lCells->mBits, 0, sizeof(lCells->mBits));
+    }
+
+    ws2812_cells_set(lRows, 0, ws2812_anim_cells_random(pThis, (uint32_t)pThis->mBase.mColumns));
+
+    /* alternate the side grains try first */
+    ws2812_cells_sand(lRows, pThis->mBase.mRows, pThis->mBase.mColumns, ((lCells->mFrame / WS2812_ANIM_CELLS_SAND_DIVIDER) & 1) != 0);
+}
+
+
+/*! Water ripples from random drops
+
+    The next level is half the sum of the 4 neighbours minus the previous
+    level, damped by 1/16. Levels are offset by WS2812_ANIM_CELLS_WATER.
+*/
+static void ws2812_anim_cells_ripple(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_cells * lCells = &pThis->mCells;
+    size_t lCurrent  = lCells->mCurrent;
+    size_t lPrevious = lCurrent ^ 1;
+    uint8_t * lSum   = lCells->mField->mLevels[2];
+    uint8_t * lLevel = lCells->mField->mLevels[lPrevious];
+    size_t lRow;
+    size_t lColumn;
+    size_t lIndex;
+    int32_t lHeight;
+
+    if(ws2812_anim_cells_random(pThis, 16) == 0) {
+
+        lIndex = ws2812_anim_cells_random(pThis, (uint32_t)pThis->mBase.mRows) * WS2812_NR_COLUMNS +
+                 ws2812_anim_cells_random(pThis, (uint32_t)pThis->mBase.mColumns);
+
+        lCells->mField->mLevels[lCurrent][lIndex] = 255;
+    }
+
+    ws2812_cells_stencil(lSum, lCells->mField->mLevels[lCurrent], pThis->mBase.mRows, pThis->mBase.mColumns,
+                         WS2812_NR_COLUMNS, &sRippleStencil);
+
+    /* the previous levels are replaced by the next ones */
+    for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+
+        lIndex = lRow * WS2812_NR_COLUMNS;
+
+        for(lColumn = 0; lColumn < pThis->mBase.mColumns; lColumn++, lIndex++) {
+
+            lHeight  = 2 * ((int32_t)lSum[lIndex] - WS2812_ANIM_CELLS_WATER) - ((int32_t)lLevel[lIndex] - WS2812_ANIM_CELLS_WATER);
+            lHeight -= lHeight >> 4;
+            lHeight += WS2812_ANIM_CELLS_WATER;
+
+            lLevel[lIndex] = (lHeight < 0)? 0 : (lHeight > 255)? 255 : (uint8_t)lHeight;
+        }
+    }
+
+    lCells->mCurrent = lPrevious;
+}
+
+
+/*! Hot spots spreading and cooling down */
+static void ws2812_anim_cells_heat(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_cells * lCells = &pThis->mCells;
+    size_t lCurrent = lCells->mCurrent;
+    size_t lNext    = lCurrent ^ 1;
+    uint8_t * lLevel = lCells->mField->mLevels[lNext];
+    size_t lRow;
+    size_t lColumn;
+    size_t lIndex;
+
+    if(ws2812_anim_cells_random(pThis, 4) == 0) {
+
+        lIndex = ws2812_anim_cells_random(pThis, (uint32_t)pThis->mBase.mRows) * WS2812_NR_COLUMNS +
+                 ws2812_anim_cells_random(pThis, (uint32_t)pThis->mBase.mColumns);
+
+        lCells->mField->mLevels[lCurrent][lIndex] = 255;
+    }
+
+    ws2812_cells_stencil(lLevel, lCells->mField->mLevels[lCurrent], pThis->mBase.mRows, pThis->mBase.mColumns,
+                         WS2812_NR_COLUMNS, &sHeatStencil);
+
+    for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+
+        lIndex = lRow * WS2812_NR_COLUMNS;
+
+        for(lColumn = 0; lColumn < pThis->mBase.mColumns; lColumn++, lIndex++) {
+            lLevel[lIndex] = sub8_f(lLevel[lIndex], 1);
+        }
+    }
+
+    lCells->mCurrent = lNext;
+}
+
+
+/*! Draw the binary cells, live cells take their color from the palette by position */
+static void ws2812_anim_cells_draw_bits(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_cells * lCells = &pThis->mCells;
+    const ts_ws2812_cells_row * lRows = lCells->mBits[lCells->mCurrent];
+    size_t lRow;
+    size_t lColumn;
+    color * lLed;
+    uint8_t lShift = (uint8_t)(lCells->mFrame >> 2);
+
+    for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+
+        lLed = &pThis->mBase.mPanel[lRow * WS2812_NR_COLUMNS];
+
+        for(lColumn = 0; lColumn < pThis->mBase.mColumns; lColumn++) {
+
+            if(ws2812_cells_get(lRows, lRow, lColumn)) {
+                lLed[lColumn] = lCells->mColors[(uint8_t)(lColumn * 2 + lRow * 16 + lShift)];
+            } else {
+                color_set_word(&lLed[lColumn], 0);
+            }
+        }
+    }
+}
+
+
+/*! Draw the levels through the palette, water by the height of the waves */
+static void ws2812_anim_cells_draw_levels(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_cells * lCells = &pThis->mCells;
+    const uint8_t * lLevel = lCells->mField->mLevels[lCells->mCurrent];
+    bool lWater = (lCells->mRule == WS2812_CELLS_RIPPLE);
+    size_t lRow;
+    size_t lColumn;
+    size_t lIndex;
+    int32_t lValue;
+
+    for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+
+        lIndex = lRow * WS2812_NR_COLUMNS;
+
+        for(lColumn = 0; lColumn < pThis->mBase.mColumns; lColumn++, lIndex++) {
+
+            lValue = lLevel[lIndex];
+
+            if(lWater) {
+                lValue = 4 * abs(lValue - WS2812_ANIM_CELLS_WATER);
+                lValue = (lValue > 255)? 255 : lValue;
+            }
+
+            pThis->mBase.mPanel[lIndex] = lCells->mColors[lValue];
+        }
+    }
+}
+
+
+/*! Expand the palette to mColors */
+static void ws2812_anim_cells_update_colors(tu_ws2812_anim * pThis) {
+
+    size_t lCount;
+
+    for(lCount = 0; lCount < 256; lCount++) {
+        color_palette_get_e(pThis->mCells.mPalette, &pThis->mCells.mColors[lCount], (uint8_t)lCount);
+    }
+}
+
+
+static void ws2812_anim_cells_update(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_cells * lCells = &pThis->mCells;
+    uint32_t lFrame = lCells->mFrame++;
+
+    switch(lCells->mRule) {
+        case WS2812_CELLS_LIFE:
+            if(lFrame % WS2812_ANIM_CELLS_LIFE_DIVIDER == 0) {
+                ws2812_anim_cells_life(pThis);
+            }
+            ws2812_anim_cells_draw_bits(pThis);
+            break;
+
+        case WS2812_CELLS_SAND:
+            if(lFrame % WS2812_ANIM_CELLS_SAND_DIVIDER == 0) {
+                ws2812_anim_cells_sand(pThis);
+            }
+            ws2812_anim_cells_draw_bits(pThis);
+            break;
+
+        case WS2812_CELLS_RIPPLE:
+            if(lCells->mField) {
+                ws2812_anim_cells_ripple(pThis);
+                ws2812_anim_cells_draw_levels(pThis);
+            }
+            break;
+
+        default:
+            if(lCells->mField) {
+                ws2812_anim_cells_heat(pThis);
+                ws2812_anim_cells_draw_levels(pThis);
+            }
+            break;
+    }
+}
+
+
+static void ws2812_anim_cells_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    (void)inFrames;
+
+    if(pParam->mCells.mRule < WS2812_CELLS_COUNT && pParam->mCells.mRule != pThis->mCells.mRule) {
+
+        pThis->mCells.mRule = pParam->mCells.mRule;
+
+        ws2812_anim_cells_reset(pThis);
+    }
+
+    if(pParam->mCells.mPalette != pThis->mCells.mPalette) {
+
+        pThis->mCells.mPalette = pParam->mCells.mPalette;
+
+        ws2812_anim_cells_update_colors(pThis);
+    }
+}
+
+
+void ws2812_anim_cells_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
+
+    ts_ws2812_anim_cells * lCells = &pThis->mCells;
+
+    pThis->mBase.mfUpdate = ws2812_anim_cells_update;
+    pThis->mBase.mfMorph  = ws2812_anim_cells_morph;
+    lCells->mRule         = (pParam->mCells.mRule < WS2812_CELLS_COUNT)? pParam->mCells.mRule : WS2812_CELLS_LIFE;
+    lCells->mPalette      = pParam->mCells.mPalette;
+    lCells->mFrame        = 0;
+
+    pcg32_seed(&lCells->mRandom, ws2812_animation_seed(), (uintptr_t)pThis);
+
+    ws2812_anim_cells_update_colors(pThis);
+
+    lCells->mField = (ts_ws2812_anim_cells_levels*)malloc(sizeof(ts_ws2812_anim_cells_levels));
+    if(!lCells->mField) {
+        printf("%s(%d): malloc failed!\r\n", __FILE__, __LINE__);
+    }
+
+    ws2812_anim_cells_reset(pThis);
+}
+
+
+void ws2812_anim_cells_clean(tu_ws2812_anim * pThis) {
+
+    free(pThis->mCells.mField);
+}
+
+
+/* eof */
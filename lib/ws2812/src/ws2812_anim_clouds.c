@@ -0,0 +1,78 @@
+#include "ws2812.h"
+
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_clouds.h"
+
+#include "mt_noise.h"
+
+
+/*! Noise cells per column, fixed point 8.8 */
+#define WS2812_ANIM_CLOUDS_STEP_X   (24)
+
+/*! Noise cells per row, fixed point 8.8 */
+#define WS2812_ANIM_CLOUDS_STEP_Y   (64)
+
+
+/*! Two octaves of 3D noise, drifting to the left while z changes the shape */
+static void ws2812_anim_clouds_update(tu_ws2812_anim * pThis) {
+
+    uint8_t lCoarse[WS2812_NR_COLUMNS];
+    uint8_t lFine[WS2812_NR_COLUMNS];
+
+    size_t lRows = pThis->mBase.mRows;
+    size_t lColumns = pThis->mBase.mColumns;
+    size_t lRow;
+    size_t lColumn;
+    color * lLed;
+
+    uint16_t lTime = ++pThis->mClouds.mTime;
+    uint16_t lDrift = (uint16_t)(lTime * 4);
+
+    if(ws2812_anim_morph_active(&pThis->mClouds.mMorph)) {
+
+        color_palette_blend(&pThis->mClouds.mCurrent, &pThis->mClouds.mFrom, color_palette_from_enum(pThis->mClouds.mPalette),
+                            ws2812_anim_morph_step(&pThis->mClouds.mMorph));
+    }
+
+    for(lRow = 0; lRow < lRows; lRow++) {
+
+        noise8_3d_row(lCoarse, lColumns, lDrift, WS2812_ANIM_CLOUDS_STEP_X,
+                      (uint16_t)(lRow * WS2812_ANIM_CLOUDS_STEP_Y), (uint16_t)(lTime * 2));
+
+        /* second octave at double frequency, offset to be independent */
+        noise8_3d_row(lFine, lColumns, (uint16_t)(lDrift * 2), 2 * WS2812_ANIM_CLOUDS_STEP_X,
+                      (uint16_t)(lRow * 2 * WS2812_ANIM_CLOUDS_STEP_Y + 0x8000), (uint16_t)(lTime * 3));
+
+        lLed = &pThis->mBase.mPanel[lRow * WS2812_NR_COLUMNS];
+
+        for(lColumn = 0; lColumn < lColumns; lColumn++) {
+
+            color_palette_get(&pThis->mClouds.mCurrent, &lLed[lColumn],
+                              (uint8_t)((3 * (uint32_t)lCoarse[lColumn] + lFine[lColumn]) >> 2));
+        }
+    }
+}
+
+
+static void ws2812_anim_clouds_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    pThis->mClouds.mFrom    = pThis->mClouds.mCurrent;
+    pThis->mClouds.mPalette = pParam->mClouds.mPalette;
+
+    ws2812_anim_morph_start(&pThis->mClouds.mMorph, inFrames);
+}
+
+
+void ws2812_anim_clouds_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
+
+    pThis->mBase.mfUpdate       = ws2812_anim_clouds_update;
+    pThis->mBase.mfMorph        = ws2812_anim_clouds_morph;
+    pThis->mClouds.mPalette     = pParam->mClouds.mPalette;
+    pThis->mClouds.mCurrent     = *color_palette_from_enum(pParam->mClouds.mPalette);
+    pThis->mClouds.mMorph.mFrame  = 0;
+    pThis->mClouds.mMorph.mFrames = 0;
+    pThis->mClouds.mTime        = 0;
+}
+
+
+/* eof */
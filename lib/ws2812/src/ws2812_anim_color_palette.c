@@ -8,26 +8,47 @@
 static void ws2812_anim_color_palette_update(tu_ws2812_anim * pThis) {
 
     size_t lCount;
+    size_t lColumns = pThis->mBase.mColumns;
 
-    color lColor;
+    if(ws2812_anim_morph_active(&pThis->mPalette.mMorph)) {
 
-    float lIncrement = 256.0f / WS2812_NR_COLUMNS;
+        color_palette_blend(&pThis->mPalette.mCurrent, &pThis->mPalette.mFrom, color_palette_from_enum(pThis->mPalette.mPalette),
+                            ws2812_anim_morph_step(&pThis->mPalette.mMorph));
 
-    for(lCount = 0; lCount < WS2812_NR_COLUMNS; lCount++) {
-
-        color_palette_get_e(pThis->mPalette.mPalette, &lColor, (uint8_t)(lIncrement * lCount + 0.5f));
+        /* render again next frame */
+        if(ws2812_anim_morph_active(&pThis->mPalette.mMorph)) {
+            pThis->mBase.mFlags |= WS2812_ANIM_FLAG_DIRTY;
+        }
+    }
 
-//        printf("%s(%d): got Color: %d, %d, %d\r\n", __func__, __LINE__, lColor.R, lColor.G, lColor.B);
+    for(lCount = 0; lCount < lColumns; lCount++) {
 
-        ws2812_setLED_Column(pThis->mBase.mPanel, lCount, lColor.R, lColor.G, lColor.B);
+        /* spread the palette over all columns, rounded */
+        color_palette_get(&pThis->mPalette.mCurrent, &pThis->mBase.mStrip[lCount], (uint8_t)((lCount * 512 + lColumns) / (2 * lColumns)));
     }
 }
 
 
+static void ws2812_anim_color_palette_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    pThis->mPalette.mFrom    = pThis->mPalette.mCurrent;
+    pThis->mPalette.mPalette = pParam->mPalette.mPalette;
+
+    ws2812_anim_morph_start(&pThis->mPalette.mMorph, inFrames);
+
+    pThis->mBase.mFlags |= WS2812_ANIM_FLAG_DIRTY;
+}
+
+
 void ws2812_anim_color_palette_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
 
     pThis->mBase.mfUpdate       = ws2812_anim_color_palette_update;
+    pThis->mBase.mfMorph        = ws2812_anim_color_palette_morph;
+    pThis->mBase.mFlags        |= WS2812_ANIM_FLAG_STATIC | WS2812_ANIM_FLAG_STRIP;
     pThis->mPalette.mPalette    = pParam->mPalette.mPalette;
+    pThis->mPalette.mCurrent    = *color_palette_from_enum(pParam->mPalette.mPalette);
+    pThis->mPalette.mMorph.mFrame  = 0;
+    pThis->mPalette.mMorph.mFrames = 0;
 }
 
 
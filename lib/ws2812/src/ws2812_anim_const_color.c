@@ -9,14 +9,39 @@
 
 static void ws2812_anim_const_color_update(tu_ws2812_anim * pThis) {
 
-    /* set the buffer once */
-    ws2812_setLED_All(pThis->mBase.mPanel, pThis->mConstantColor.mColor.R, pThis->mConstantColor.mColor.G, pThis->mConstantColor.mColor.B);
+    if(ws2812_anim_morph_active(&pThis->mConstantColor.mMorph)) {
+
+        color_lerp(&pThis->mConstantColor.mColor, &pThis->mConstantColor.mFrom, &pThis->mConstantColor.mTo,
+                   ws2812_anim_morph_step(&pThis->mConstantColor.mMorph));
+
+        /* render again next frame */
+        if(ws2812_anim_morph_active(&pThis->mConstantColor.mMorph)) {
+            pThis->mBase.mFlags |= WS2812_ANIM_FLAG_DIRTY;
+        }
+    }
+
+    /* set the strip once */
+    color_fill(pThis->mBase.mStrip, pThis->mBase.mColumns, &pThis->mConstantColor.mColor);
+}
+
+static void ws2812_anim_const_color_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    pThis->mConstantColor.mFrom = pThis->mConstantColor.mColor;
+    pThis->mConstantColor.mTo   = pParam->mConstantColor.mColor;
+
+    ws2812_anim_morph_start(&pThis->mConstantColor.mMorph, inFrames);
+
+    pThis->mBase.mFlags |= WS2812_ANIM_FLAG_DIRTY;
 }
 
 void ws2812_anim_const_color_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
 
     pThis->mBase.mfUpdate        = ws2812_anim_const_color_update;
+    pThis->mBase.mfMorph         = ws2812_anim_const_color_morph;
+    pThis->mBase.mFlags         |= WS2812_ANIM_FLAG_STATIC | WS2812_ANIM_FLAG_STRIP;
     pThis->mConstantColor.mColor  = pParam->mConstantColor.mColor;
+    pThis->mConstantColor.mMorph.mFrame  = 0;
+    pThis->mConstantColor.mMorph.mFrames = 0;
 }
 
 
@@ -6,6 +6,7 @@
 
 #include "ws2812_anim_obj.h"
 #include "ws2812_anim_fire.h"
+#include "ws2812_anim_p.h"
 
 #include "mt_random.h"
 #include "mt_arithm.h"
@@ -17,6 +18,9 @@
 #define MAX_COOLING (15)
 #define MIN_COOLING (0)
 
+/*! Render a keyframe every 2nd frame (50 Hz) when interpolated */
+#define WS2812_ANIM_FIRE_KEYFRAME_DIVIDER   (2)
+
 
 /*! This function cools everything a bit down */
 static void ws2812_anim_fire_update_cool(tu_ws2812_anim * pThis) {
@@ -24,18 +28,20 @@ static void ws2812_anim_fire_update_cool(tu_ws2812_anim * pThis) {
     size_t lCountX;
     size_t lCountY;
 
-    uint8_t lRandom;
+    uint8_t lRandom[WS2812_NR_COLUMNS];
     uint8_t lHeat;
 
     /* all rows except first and last (which gets replaced by shift up and was already updated by burn) */
-    for(lCountY = 1; lCountY < WS2812_NR_ROWS-1; lCountY++) {
-        for(lCountX = 0; lCountX < WS2812_NR_COLUMNS; lCountX++) {
+    for(lCountY = 1; lCountY + 1 < pThis->mBase.mRows; lCountY++) {
+
+        /* random cool down values for the whole row */
+        pcg32_fill_range(&pThis->mFire.mRandom, lRandom, pThis->mBase.mColumns, MIN_COOLING, MAX_COOLING);
+
+        for(lCountX = 0; lCountX < pThis->mBase.mColumns; lCountX++) {
 
-            /* get a random cool down value */
-            lRandom = xorshift8_range(MIN_COOLING, MAX_COOLING);
             lHeat = pThis->mFire.mHeat[lCountY * WS2812_NR_COLUMNS + lCountX];
 
-            lHeat = sub8_f(lHeat, lRandom);
+            lHeat = sub8_f(lHeat, lRandom[lCountX]);
 
             pThis->mFire.mHeat[lCountY * WS2812_NR_COLUMNS + lCountX] = lHeat;
         }
@@ -61,13 +67,13 @@ static void ws2812_anim_fire_update_fade(tu_ws2812_anim * pThis) {
     */
 
     /* all rows except first one */
-    for(lCountY = WS2812_NR_ROWS-1; lCountY > 0; lCountY--) {
-        for(lCountX = 0; lCountX < WS2812_NR_COLUMNS; lCountX++) {
+    for(lCountY = pThis->mBase.mRows-1; lCountY > 0; lCountY--) {
+        for(lCountX = 0; lCountX < pThis->mBase.mColumns; lCountX++) {
 
             /* 2 * h(n-1)(x, y-1) */
             lSum = (pThis->mFire.mHeat[(lCountY - 1) * WS2812_NR_COLUMNS + lCountX] << 1);
 
-            if(lCountX < WS2812_NR_COLUMNS-1) {
+            if(lCountX < pThis->mBase.mColumns-1) {
                 /* 1 * h(n-1)(x+1, y-1) */
                 lSum += pThis->mFire.mHeat[(lCountY - 1) * WS2812_NR_COLUMNS + lCountX + 1];
             } else if(lCountX > 0) {
@@ -89,26 +95,35 @@ static void ws2812_anim_fire_update_burn(tu_ws2812_anim * pThis) {
 
     size_t lCountX;
     uint8_t lHeat;
-    uint8_t lRandom;
+    uint8_t lRandom[WS2812_NR_COLUMNS];
+    uint32_t lCoins = 0;
 
     uint8_t lHeatBackup[3];
 
+    pcg32_fill_range(&pThis->mFire.mRandom, lRandom, pThis->mBase.mColumns, MIN_HEAT_UP, MAX_HEAT_UP);
+
     /* only on first row */
-    for(lCountX = 0; lCountX < WS2812_NR_COLUMNS; lCountX++) {
+    for(lCountX = 0; lCountX < pThis->mBase.mColumns; lCountX++) {
 
         lHeat = pThis->mFire.mHeat[lCountX];
-        lRandom = xorshift8_range(MIN_HEAT_UP, MAX_HEAT_UP);
 
-        if(xorshift8() < xorshift8()) {
+        /* one random bit per column decides between heating and cooling */
+        if((lCountX & 31) == 0) {
+            lCoins = pcg32(&pThis->mFire.mRandom);
+        }
+
+        if(lCoins & 1u) {
 
             /* heat up */
-            lHeat = add8_cl(lHeat, lRandom, MAX_HEAT);
+            lHeat = add8_cl(lHeat, lRandom[lCountX], MAX_HEAT);
 
         } else {
 
             /* cool down */
-            lHeat = sub8_f(lHeat, lRandom);
+            lHeat = sub8_f(lHeat, lRandom[lCountX]);
         }
+
+        lCoins >>= 1;
         pThis->mFire.mHeat[lCountX] = lHeat;
     }
 
@@ -117,13 +132,13 @@ static void ws2812_anim_fire_update_burn(tu_ws2812_anim * pThis) {
     lHeatBackup[1] = pThis->mFire.mHeat[0];
     lHeatBackup[2] = pThis->mFire.mHeat[1];
 
-    for(lCountX = 0; lCountX < WS2812_NR_COLUMNS; lCountX++) {
+    for(lCountX = 0; lCountX < pThis->mBase.mColumns; lCountX++) {
 
         lHeat = (uint8_t)(((uint32_t)lHeatBackup[0] + ((uint32_t)lHeatBackup[1] << 1) + (uint32_t)lHeatBackup[2]) >> 2);
 
         lHeatBackup[0] = lHeatBackup[1];
         lHeatBackup[1] = lHeatBackup[2];
-        if(lCountX < WS2812_NR_COLUMNS-1) {
+        if(lCountX < pThis->mBase.mColumns-1) {
             lHeatBackup[2] = pThis->mFire.mHeat[lCountX + 1];
         } else {
             lHeatBackup[2] = 0;
@@ -134,41 +149,84 @@ static void ws2812_anim_fire_update_burn(tu_ws2812_anim * pThis) {
 }
 
 
-/*! draw from palette */
-static void ws2812_anim_fire_update_draw(tu_ws2812_anim * pThis) {
+/*! draw the rows from inFirst to inLast (excluding) from palette */
+static void ws2812_anim_fire_update_draw(tu_ws2812_anim * pThis, size_t inFirst, size_t inLast) {
 
-    size_t lCount;
+    size_t lCountX;
+    size_t lCountY;
+    size_t lIndex;
+
+    for(lCountY = inFirst; lCountY < inLast; lCountY++) {
+
+        lIndex = lCountY * WS2812_NR_COLUMNS;
 
-    for(lCount = 0; lCount < WS2812_NR_ROWS * WS2812_NR_COLUMNS; lCount++) {
+        for(lCountX = 0; lCountX < pThis->mBase.mColumns; lCountX++, lIndex++) {
 
-        color_palette_get_e(pThis->mFire.mPalette, &pThis->mBase.mPanel[lCount], pThis->mFire.mHeat[lCount]);
+            color_palette_get(&pThis->mFire.mCurrent, &pThis->mBase.mPanel[lIndex], pThis->mFire.mHeat[lIndex]);
+        }
     }
 }
 
 
-static void ws2812_anim_fire_update(tu_ws2812_anim * pThis) {
+/*! Simulate with the first part, draw some of the rows with each part */
+static void ws2812_anim_fire_update_part(tu_ws2812_anim * pThis, uint32_t inPart, uint32_t inParts) {
 
     if(pThis->mFire.mHeat) {
 
-        /* 1st add new fire */
-        ws2812_anim_fire_update_burn(pThis);
+        if(inPart == 0) {
+
+            /* 1st add new fire */
+            ws2812_anim_fire_update_burn(pThis);
 
-        /* 2nd cool down */
-        ws2812_anim_fire_update_cool(pThis);
+            /* 2nd cool down */
+            ws2812_anim_fire_update_cool(pThis);
 
-        /* 3rd drift up with blurring */
-        ws2812_anim_fire_update_fade(pThis);
+            /* 3rd drift up with blurring */
+            ws2812_anim_fire_update_fade(pThis);
+
+            if(ws2812_anim_morph_active(&pThis->mFire.mMorph)) {
+
+                color_palette_blend(&pThis->mFire.mCurrent, &pThis->mFire.mFrom, color_palette_from_enum(pThis->mFire.mPalette),
+                                    ws2812_anim_morph_step(&pThis->mFire.mMorph));
+            }
+        }
 
         /* 4th draw from palette */
-        ws2812_anim_fire_update_draw(pThis);
+        ws2812_anim_fire_update_draw(pThis, (inPart * pThis->mBase.mRows) / inParts,
+                                            ((inPart + 1) * pThis->mBase.mRows) / inParts);
     }
 }
 
 
+static void ws2812_anim_fire_update(tu_ws2812_anim * pThis) {
+
+    ws2812_anim_fire_update_part(pThis, 0, 1);
+}
+
+
+static void ws2812_anim_fire_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    /* the heat map keeps burning, only the palette changes */
+    pThis->mFire.mFrom    = pThis->mFire.mCurrent;
+    pThis->mFire.mPalette = pParam->mFire.mPalette;
+
+    ws2812_anim_morph_start(&pThis->mFire.mMorph, inFrames);
+}
+
+
 void ws2812_anim_fire_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
 
-    pThis->mBase.mfUpdate   = ws2812_anim_fire_update;
-    pThis->mFire.mPalette   = pParam->mFire.mPalette;
+    pThis->mBase.mfUpdate         = ws2812_anim_fire_update;
+    pThis->mBase.mfMorph          = ws2812_anim_fire_morph;
+    pThis->mBase.mfUpdatePart     = ws2812_anim_fire_update_part;
+    pThis->mBase.mKeyframeDivider = WS2812_ANIM_FIRE_KEYFRAME_DIVIDER;
+    pThis->mFire.mPalette         = pParam->mFire.mPalette;
+    pThis->mFire.mCurrent         = *color_palette_from_enum(pParam->mFire.mPalette);
+    pThis->mFire.mMorph.mFrame  = 0;
+    pThis->mFire.mMorph.mFrames = 0;
+
+    /* own sequence per object, two fires do not burn the same */
+    pcg32_seed(&pThis->mFire.mRandom, ws2812_animation_seed(), (uintptr_t)pThis);
 
     pThis->mFire.mHeat = (uint8_t*)malloc(WS2812_NR_ROWS * WS2812_NR_COLUMNS);
     if(pThis->mFire.mHeat) {
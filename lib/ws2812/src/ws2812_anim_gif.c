@@ -0,0 +1,203 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "ws2812.h"
+
+#include "ws2812_anim.h"
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_gif.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+/*! The stored GIF */
+typedef struct {
+
+    /*! GIF, allocated with the first part */
+    uint8_t   * mData;
+
+    /*! Length shown to the animations, set when the last part is stored */
+    size_t      mLength;
+
+    /*! Bytes received */
+    size_t      mReceived;
+
+    /*! Incremented when the GIF is replaced and when it is complete */
+    uint32_t    mVersion;
+
+} ts_ws2812_gif_store;
+
+
+/*! Stored GIF */
+static ts_ws2812_gif_store sGifStore;
+
+
+bool ws2812_gif_store(size_t inOffset, const uint8_t * inData, size_t inLength, size_t inTotal) {
+
+    if(inTotal > WS2812_GIF_STORE_MAX || inOffset + inLength > inTotal ||
+       (inOffset != 0 && inOffset != sGifStore.mReceived)) {
+        return false;
+    }
+
+    if(!sGifStore.mData) {
+
+        sGifStore.mData = (uint8_t*)malloc(WS2812_GIF_STORE_MAX);
+        if(!sGifStore.mData) {
+            printf("%s(%d): malloc failed!\r\n", __FILE__, __LINE__);
+            return false;
+        }
+    }
+
+    /* the animation task runs above the callers, it never decodes while a
+       part is copied; the old GIF is given up before it is overwritten */
+    if(inOffset == 0) {
+
+        taskENTER_CRITICAL();
+
+        sGifStore.mLength = 0;
+        sGifStore.mVersion++;
+
+        taskEXIT_CRITICAL();
+    }
+
+    memcpy(&sGifStore.mData[inOffset], inData, inLength);
+    sGifStore.mReceived = inOffset + inLength;
+
+    if(sGifStore.mReceived == inTotal) {
+
+        taskENTER_CRITICAL();
+
+        sGifStore.mLength = inTotal;
+        sGifStore.mVersion++;
+
+        taskEXIT_CRITICAL();
+    }
+
+    return true;
+}
+
+
+/*! Clear the area and mark it changed */
+static void ws2812_anim_gif_clear(tu_ws2812_anim * pThis) {
+
+    size_t lRow;
+
+    for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+
+        memset(&pThis->mBase.mPanel[lRow * WS2812_NR_COLUMNS], 0, pThis->mBase.mColumns * sizeof(color));
+
+        ws2812_span_add(&pThis->mBase.mDirty[lRow], 0, pThis->mBase.mColumns);
+    }
+}
+
+
+/*! Open the stored GIF again, the area is cleared with the next update */
+static void ws2812_anim_gif_open(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_gif * lGif = &pThis->mGif;
+
+    taskENTER_CRITICAL();
+
+    lGif->mVersion = sGifStore.mVersion;
+    ws2812_gif_memory_init(&lGif->mSource, sGifStore.mData, sGifStore.mLength);
+
+    taskEXIT_CRITICAL();
+
+    lGif->mValid = lGif->mDecoder && lGif->mSource.mLength > 0 &&
+                   ws2812_gif_open(lGif->mDecoder, ws2812_gif_memory_read, ws2812_gif_memory_seek, &lGif->mSource, lGif->mFit);
+
+    lGif->mCountdown = 0;
+    lGif->mClear     = true;
+}
+
+
+static void ws2812_anim_gif_update(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_gif * lGif = &pThis->mGif;
+    ts_ws2812_canvas lCanvas;
+    uint32_t lDelay;
+
+    if(lGif->mVersion != sGifStore.mVersion) {
+        ws2812_anim_gif_open(pThis);
+    }
+
+    if(lGif->mClear) {
+        ws2812_anim_gif_clear(pThis);
+        lGif->mClear = false;
+    }
+
+    if(!lGif->mValid) {
+        return;
+    }
+
+    lGif->mCountdown -= (int32_t)lGif->mStep;
+
+    if(lGif->mCountdown > 0) {
+        return;
+    }
+
+    ws2812_canvas_init(&lCanvas, pThis->mBase.mPanel, pThis->mBase.mColumns, pThis->mBase.mRows, WS2812_NR_COLUMNS);
+
+    if(ws2812_gif_next_frame(lGif->mDecoder, &lCanvas, pThis->mBase.mDirty, &lDelay)) {
+
+        lGif->mCountdown += (int32_t)lDelay;
+
+        /* too slow to keep up, the next frame follows at once */
+        if(lGif->mCountdown < 0) {
+            lGif->mCountdown = 0;
+        }
+
+    } else {
+
+        lGif->mValid = false;
+        ws2812_anim_gif_clear(pThis);
+    }
+}
+
+
+static void ws2812_anim_gif_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    ts_ws2812_anim_gif * lGif = &pThis->mGif;
+
+    (void)inFrames;
+
+    lGif->mStep = pParam->mGif.mStep;
+
+    /* the samples depend on the fit, start over */
+    if(pParam->mGif.mFit != lGif->mFit) {
+
+        lGif->mFit = pParam->mGif.mFit;
+
+        ws2812_anim_gif_open(pThis);
+    }
+}
+
+
+void ws2812_anim_gif_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
+
+    ts_ws2812_anim_gif * lGif = &pThis->mGif;
+
+    pThis->mBase.mfUpdate = ws2812_anim_gif_update;
+    pThis->mBase.mfMorph  = ws2812_anim_gif_morph;
+    pThis->mBase.mFlags  |= WS2812_ANIM_FLAG_SPANS;
+    lGif->mFit            = pParam->mGif.mFit;
+    lGif->mStep           = pParam->mGif.mStep;
+
+    lGif->mDecoder = (ts_ws2812_gif*)malloc(sizeof(ts_ws2812_gif));
+    if(!lGif->mDecoder) {
+        printf("%s(%d): malloc failed!\r\n", __FILE__, __LINE__);
+    }
+
+    ws2812_anim_gif_open(pThis);
+}
+
+
+void ws2812_anim_gif_clean(tu_ws2812_anim * pThis) {
+
+    free(pThis->mGif.mDecoder);
+}
+
+
+/* eof */
@@ -4,18 +4,208 @@
 #include "ws2812_anim_obj.h"
 #include "ws2812_anim_gradient.h"
 
+#include "mt_trig.h"
+
+
+/*! Weight 255 in 16.16 fixed point */
+#define WEIGHT_MAX_Q16      ((int64_t)255 << 16)
+
+
+/*! Blend both colors for every possible weight */
+static void ws2812_anim_gradient_update_lut(tu_ws2812_anim * pThis) {
+
+    size_t lCount;
+
+    for(lCount = 0; lCount < 256; lCount++) {
+
+        color_lerp(&pThis->mGradient.mColorLut[lCount], &pThis->mGradient.mFirstColor, &pThis->mGradient.mSecondColor, (uint8_t)lCount);
+    }
+}
+
+
+/*! Project the panel onto the gradient direction
+
+    The projection is linear in row and column, so the weights are
+    accumulated with one addition per led instead of being calculated.
+*/
+static void ws2812_anim_gradient_update_weights(tu_ws2812_anim * pThis) {
+
+    size_t lRow;
+    size_t lColumn;
+
+    int32_t lCos = cos16(pThis->mGradient.mAngle);
+    int32_t lSin = sin16(pThis->mGradient.mAngle);
+
+    int32_t lMin = 0;
+    int32_t lMax = 0;
+    int32_t lRange;
+
+    int32_t lStepX;
+    int32_t lStepY;
+    int32_t lRowWeight;
+    int32_t lWeight;
+
+    uint8_t * lOut;
+
+    /* projection of the panel corners */
+    if(lCos < 0) {
+        lMin += lCos * (int32_t)(pThis->mBase.mColumns - 1);
+    } else {
+        lMax += lCos * (int32_t)(pThis->mBase.mColumns - 1);
+    }
+
+    if(lSin < 0) {
+        lMin += lSin * (int32_t)(pThis->mBase.mRows - 1);
+    } else {
+        lMax += lSin * (int32_t)(pThis->mBase.mRows - 1);
+    }
+
+    lRange = lMax - lMin;
+    if(lRange == 0) {
+        lRange = 1;
+    }
+
+    /* weight increments in 16.16 fixed point */
+    lStepX     = (int32_t)(lCos * WEIGHT_MAX_Q16 / lRange);
+    lStepY     = (int32_t)(lSin * WEIGHT_MAX_Q16 / lRange);
+    lRowWeight = (int32_t)(-lMin * WEIGHT_MAX_Q16 / lRange) + (1 << 15);
+
+    for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+
+        lWeight = lRowWeight;
+        lOut    = &pThis->mGradient.mWeight[lRow * WS2812_NR_COLUMNS];
+
+        for(lColumn = 0; lColumn < pThis->mBase.mColumns; lColumn++) {
+
+            /* accumulated rounding errors may leave the range slightly */
+            if(lWeight < 0) {
+                *lOut++ = 0;
+            } else if(lWeight > (255 << 16)) {
+                *lOut++ = 255;
+            } else {
+                *lOut++ = (uint8_t)(lWeight >> 16);
+            }
+
+            lWeight += lStepX;
+        }
+
+        lRowWeight += lStepY;
+    }
+}
+
+
+/*! Advance a morph by one frame
+
+    \return true if the angle changed
+*/
+static bool ws2812_anim_gradient_morph_step(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_gradient * lGradient = &pThis->mGradient;
+
+    uint8_t lAmount = ws2812_anim_morph_step(&lGradient->mMorph);
+    int32_t lAngle  = lGradient->mAngleDelta * lAmount / 255;
+
+    color_lerp(&lGradient->mFirstColor,  &lGradient->mFromColor[0], &lGradient->mToColor[0], lAmount);
+    color_lerp(&lGradient->mSecondColor, &lGradient->mFromColor[1], &lGradient->mToColor[1], lAmount);
+
+    ws2812_anim_gradient_update_lut(pThis);
+
+    lGradient->mRotation = (int16_t)(lGradient->mFromRotation + (lGradient->mToRotation - lGradient->mFromRotation) * lAmount / 255);
+
+    lGradient->mAngle    += (uint16_t)(lAngle - lGradient->mAngleDone);
+    lGradient->mAngleDone = lAngle;
+
+    /* render again next frame */
+    if(ws2812_anim_morph_active(&lGradient->mMorph)) {
+        pThis->mBase.mFlags |= WS2812_ANIM_FLAG_DIRTY;
+    }
+
+    return lGradient->mAngleDelta != 0;
+}
+
 
 static void ws2812_anim_gradient_update(tu_ws2812_anim * pThis) {
 
+    size_t lRow;
+    size_t lColumn;
+    size_t lIndex;
+    bool lNewAngle = false;
+
+    if(ws2812_anim_morph_active(&pThis->mGradient.mMorph)) {
+
+        lNewAngle = ws2812_anim_gradient_morph_step(pThis);
+    }
+
+    if(pThis->mGradient.mRotation) {
+
+        pThis->mGradient.mAngle += pThis->mGradient.mRotation;
+
+        lNewAngle = true;
+    }
+
+    if(lNewAngle) {
+
+        ws2812_anim_gradient_update_weights(pThis);
+    }
+
+    for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+
+        lIndex = lRow * WS2812_NR_COLUMNS;
+
+        for(lColumn = 0; lColumn < pThis->mBase.mColumns; lColumn++, lIndex++) {
+
+            pThis->mBase.mPanel[lIndex] = pThis->mGradient.mColorLut[pThis->mGradient.mWeight[lIndex]];
+        }
+    }
+}
+
+
+static void ws2812_anim_gradient_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    ts_ws2812_anim_gradient * lGradient = &pThis->mGradient;
+
+    lGradient->mFromColor[0]  = lGradient->mFirstColor;
+    lGradient->mFromColor[1]  = lGradient->mSecondColor;
+    lGradient->mToColor[0]    = pParam->mGradient.mFirstColor;
+    lGradient->mToColor[1]    = pParam->mGradient.mSecondColor;
+    lGradient->mToRotation    = pParam->mGradient.mRotation;
+    lGradient->mAngleDone     = 0;
+
+    /* a rotating gradient changes its speed, a static one stops and turns to the new angle */
+    if(lGradient->mToRotation) {
+        lGradient->mFromRotation = lGradient->mRotation;
+        lGradient->mAngleDelta   = 0;
+        pThis->mBase.mFlags     &= ~WS2812_ANIM_FLAG_STATIC;
+    } else {
+        lGradient->mFromRotation = 0;
+        lGradient->mRotation     = 0;
+        lGradient->mAngleDelta   = (int16_t)(deg_to_angle16(pParam->mGradient.mAngle) - lGradient->mAngle);
+        pThis->mBase.mFlags     |= WS2812_ANIM_FLAG_STATIC;
+    }
+
+    ws2812_anim_morph_start(&lGradient->mMorph, inFrames);
+
+    pThis->mBase.mFlags |= WS2812_ANIM_FLAG_DIRTY;
 }
 
 
 void ws2812_anim_gradient_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
 
     pThis->mBase.mfUpdate         = ws2812_anim_gradient_update;
+    pThis->mBase.mfMorph          = ws2812_anim_gradient_morph;
+    pThis->mGradient.mMorph.mFrame  = 0;
+    pThis->mGradient.mMorph.mFrames = 0;
     pThis->mGradient.mFirstColor  = pParam->mGradient.mFirstColor;
     pThis->mGradient.mSecondColor = pParam->mGradient.mSecondColor;
-    pThis->mGradient.mAngle       = pParam->mGradient.mAngle;
+    pThis->mGradient.mAngle       = deg_to_angle16(pParam->mGradient.mAngle);
+    pThis->mGradient.mRotation    = pParam->mGradient.mRotation;
+
+    if(!pThis->mGradient.mRotation) {
+        pThis->mBase.mFlags |= WS2812_ANIM_FLAG_STATIC;
+    }
+
+    ws2812_anim_gradient_update_lut(pThis);
+    ws2812_anim_gradient_update_weights(pThis);
 }
 
 
@@ -0,0 +1,239 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "ws2812.h"
+
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_particles.h"
+#include "ws2812_anim_p.h"
+#include "ws2812_draw.h"
+
+#include "mt_arithm.h"
+#include "mt_trig.h"
+
+
+/*! Parameters of an effect */
+typedef struct {
+
+    /*! Forces on the particles */
+    ts_ws2812_particle_forces   mForces;
+
+    /*! Brightness kept from the last frame, trails of the particles */
+    uint8_t                     mTrail;
+
+} ts_ws2812_anim_particles_effect;
+
+
+static const ts_ws2812_anim_particles_effect sEffects[] = {
+    [WS2812_PARTICLES_FIREWORKS] = { .mForces = { .mGravity = 1, .mDrag = 4, .mDecay = 4 }, .mTrail = 160 },
+    [WS2812_PARTICLES_SPARKS]    = { .mForces = { .mGravity = 2, .mDrag = 0, .mDecay = 6 }, .mTrail = 128 },
+    [WS2812_PARTICLES_RAIN]      = { .mForces = { .mGravity = 0, .mDrag = 0, .mDecay = 1 }, .mTrail = 96  },
+    [WS2812_PARTICLES_CONFETTI]  = { .mForces = { .mGravity = 0, .mDrag = 0, .mDecay = 3 }, .mTrail = 224 },
+};
+
+
+/*! Random number from 0 to inRange - 1 */
+static inline int16_t ws2812_anim_particles_random(tu_ws2812_anim * pThis, uint32_t inRange) {
+
+    return (int16_t)pcg32_bounded(&pThis->mParticles.mRandom, inRange);
+}
+
+
+/*! Random position in particle units from 0 to inPixels pixels */
+static inline int16_t ws2812_anim_particles_position(tu_ws2812_anim * pThis, size_t inPixels) {
+
+    return ws2812_anim_particles_random(pThis, (uint32_t)inPixels << WS2812_PARTICLE_SHIFT);
+}
+
+
+/*! A burst at a random place every 0.4 to 1.2 seconds */
+static void ws2812_anim_particles_fireworks(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_particles * lParticles = &pThis->mParticles;
+    int16_t lX;
+    int16_t lY;
+    int32_t lSpeed;
+    uint8_t lAngle;
+    uint8_t lColor;
+    size_t lCount;
+    size_t lSparks;
+
+    if(lParticles->mCountdown > 0) {
+        lParticles->mCountdown--;
+        return;
+    }
+
+    lParticles->mCountdown = 40 + (uint32_t)ws2812_anim_particles_random(pThis, 80);
+
+    lX      = ws2812_anim_particles_position(pThis, pThis->mBase.mColumns);
+    lY      = ws2812_anim_particles_position(pThis, (pThis->mBase.mRows + 1) / 2);
+    lColor  = (uint8_t)ws2812_anim_particles_random(pThis, 256);
+    lSparks = 24 + (size_t)ws2812_anim_particles_random(pThis, 24);
+
+    for(lCount = 0; lCount < lSparks; lCount++) {
+
+        lAngle = (uint8_t)((lCount * 256) / lSparks);
+        lSpeed = 16 + ws2812_anim_particles_random(pThis, 48);
+
+        /* sin8 and cos8 are centered at 128 */
+        ws2812_particles_spawn(lParticles->mPool, lX, lY,
+                               (int16_t)(((cos8(lAngle) - 128) * lSpeed) >> 7),
+                               (int16_t)(((sin8(lAngle) - 128) * lSpeed) >> 8),
+                               255, (uint8_t)(lColor + ws2812_anim_particles_random(pThis, 32)));
+    }
+}
+
+
+/*! Sparks flying up from the bottom row and falling back */
+static void ws2812_anim_particles_sparks(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_particles * lParticles = &pThis->mParticles;
+
+    ws2812_particles_spawn(lParticles->mPool,
+                           ws2812_anim_particles_position(pThis, pThis->mBase.mColumns),
+                           (int16_t)((pThis->mBase.mRows - 1) << WS2812_PARTICLE_SHIFT),
+                           (int16_t)(ws2812_anim_particles_random(pThis, 64) - 32),
+                           (int16_t)(-16 - ws2812_anim_particles_random(pThis, 16)),
+                           255, (uint8_t)ws2812_anim_particles_random(pThis, 256));
+}
+
+
+/*! Drops entering at the top row with different speeds */
+static void ws2812_anim_particles_rain(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_particles * lParticles = &pThis->mParticles;
+    size_t lCount;
+
+    for(lCount = 0; lCount < 2; lCount++) {
+
+        ws2812_particles_spawn(lParticles->mPool,
+                               ws2812_anim_particles_position(pThis, pThis->mBase.mColumns), 0,
+                               0, (int16_t)(4 + ws2812_anim_particles_random(pThis, 12)),
+                               255, (uint8_t)ws2812_anim_particles_random(pThis, 256));
+    }
+}
+
+
+/*! Resting dots of random color fading out */
+static void ws2812_anim_particles_confetti(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_particles * lParticles = &pThis->mParticles;
+
+    ws2812_particles_spawn(lParticles->mPool,
+                           ws2812_anim_particles_position(pThis, pThis->mBase.mColumns),
+                           ws2812_anim_particles_position(pThis, pThis->mBase.mRows),
+                           0, 0, 255, (uint8_t)ws2812_anim_particles_random(pThis, 256));
+}
+
+
+/*! Expand the palette to mColors */
+static void ws2812_anim_particles_update_colors(tu_ws2812_anim * pThis) {
+
+    size_t lCount;
+
+    for(lCount = 0; lCount < 256; lCount++) {
+        color_palette_get_e(pThis->mParticles.mPalette, &pThis->mParticles.mColors[lCount], (uint8_t)lCount);
+    }
+}
+
+
+static void ws2812_anim_particles_update(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_particles * lParticles = &pThis->mParticles;
+    const ts_ws2812_anim_particles_effect * lEffect = &sEffects[lParticles->mEffect];
+    ts_ws2812_canvas lCanvas;
+    size_t lRow;
+    size_t lColumn;
+    color * lLed;
+
+    if(!lParticles->mPool) {
+        return;
+    }
+
+    /* fade the last frame */
+    for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+
+        lLed = &pThis->mBase.mPanel[lRow * WS2812_NR_COLUMNS];
+
+        for(lColumn = 0; lColumn < pThis->mBase.mColumns; lColumn++, lLed++) {
+            nscale8x3(&lLed->R, &lLed->G, &lLed->B, lEffect->mTrail);
+        }
+    }
+
+    switch(lParticles->mEffect) {
+        case WS2812_PARTICLES_FIREWORKS:
+            ws2812_anim_particles_fireworks(pThis);
+            break;
+        case WS2812_PARTICLES_SPARKS:
+            ws2812_anim_particles_sparks(pThis);
+            break;
+        case WS2812_PARTICLES_RAIN:
+            ws2812_anim_particles_rain(pThis);
+            break;
+        default:
+            ws2812_anim_particles_confetti(pThis);
+            break;
+    }
+
+    ws2812_particles_step(lParticles->mPool, &lEffect->mForces, (int16_t)pThis->mBase.mColumns, (int16_t)pThis->mBase.mRows);
+
+    ws2812_canvas_init(&lCanvas, pThis->mBase.mPanel, pThis->mBase.mColumns, pThis->mBase.mRows, WS2812_NR_COLUMNS);
+
+    ws2812_particles_render(lParticles->mPool, &lCanvas, lParticles->mColors);
+}
+
+
+static void ws2812_anim_particles_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    (void)inFrames;
+
+    /* the particles in flight keep going with the new effect */
+    if(pParam->mParticles.mEffect < WS2812_PARTICLES_COUNT) {
+        pThis->mParticles.mEffect = pParam->mParticles.mEffect;
+    }
+
+    if(pThis->mParticles.mPalette != pParam->mParticles.mPalette) {
+
+        pThis->mParticles.mPalette = pParam->mParticles.mPalette;
+
+        ws2812_anim_particles_update_colors(pThis);
+    }
+}
+
+
+void ws2812_anim_particles_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
+
+    ts_ws2812_anim_particles * lParticles = &pThis->mParticles;
+    size_t lCount;
+
+    pThis->mBase.mfUpdate   = ws2812_anim_particles_update;
+    pThis->mBase.mfMorph    = ws2812_anim_particles_morph;
+    lParticles->mEffect     = (pParam->mParticles.mEffect < WS2812_PARTICLES_COUNT)? pParam->mParticles.mEffect : WS2812_PARTICLES_CONFETTI;
+    lParticles->mPalette    = pParam->mParticles.mPalette;
+    lParticles->mCountdown  = 0;
+
+    pcg32_seed(&lParticles->mRandom, ws2812_animation_seed(), (uintptr_t)pThis);
+
+    ws2812_anim_particles_update_colors(pThis);
+
+    /* the trails fade from black */
+    for(lCount = 0; lCount < WS2812_NR_ROWS * WS2812_NR_COLUMNS; lCount++) {
+        color_set_word(&pThis->mBase.mPanel[lCount], 0);
+    }
+
+    lParticles->mPool = (ts_ws2812_particles*)malloc(sizeof(ts_ws2812_particles));
+    if(lParticles->mPool) {
+        ws2812_particles_clear(lParticles->mPool);
+    } else {
+        printf("%s(%d): malloc failed!\r\n", __FILE__, __LINE__);
+    }
+}
+
+
+void ws2812_anim_particles_clean(tu_ws2812_anim * pThis) {
+
+    free(pThis->mParticles.mPool);
+}
+
+
+/* eof */
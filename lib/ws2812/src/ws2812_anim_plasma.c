@@ -0,0 +1,87 @@
+#include "ws2812.h"
+
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_plasma.h"
+
+#include "mt_trig.h"
+
+
+/*! Sum of four waves along the columns, rows and both diagonals
+
+    Each wave only depends on one coordinate, so it is computed once per
+    column, row or diagonal and a pixel is four table lookups.
+*/
+static void ws2812_anim_plasma_update(tu_ws2812_anim * pThis) {
+
+    uint8_t lColumnWave[WS2812_NR_COLUMNS];
+    uint8_t lRowWave[WS2812_NR_ROWS];
+    uint8_t lDiagonalWave[WS2812_NR_COLUMNS + WS2812_NR_ROWS];
+    uint8_t lAntiDiagonalWave[WS2812_NR_COLUMNS + WS2812_NR_ROWS];
+
+    size_t lRows = pThis->mBase.mRows;
+    size_t lColumns = pThis->mBase.mColumns;
+    size_t lRow;
+    size_t lColumn;
+    uint32_t lSum;
+    color * lLed;
+
+    uint8_t lTime = (uint8_t)(++pThis->mPlasma.mTime);
+
+    if(ws2812_anim_morph_active(&pThis->mPlasma.mMorph)) {
+
+        color_palette_blend(&pThis->mPlasma.mCurrent, &pThis->mPlasma.mFrom, color_palette_from_enum(pThis->mPlasma.mPalette),
+                            ws2812_anim_morph_step(&pThis->mPlasma.mMorph));
+    }
+
+    for(lColumn = 0; lColumn < lColumns; lColumn++) {
+        lColumnWave[lColumn] = sin8((uint8_t)(lColumn * 5 + lTime));
+    }
+
+    for(lRow = 0; lRow < lRows; lRow++) {
+        lRowWave[lRow] = sin8((uint8_t)(lRow * 29 - lTime * 2));
+    }
+
+    /* diagonals are numbered by column + row and column + (rows - 1 - row) */
+    for(lColumn = 0; lColumn < lColumns + lRows; lColumn++) {
+        lDiagonalWave[lColumn]     = sin8((uint8_t)(lColumn * 3 + lTime * 3));
+        lAntiDiagonalWave[lColumn] = sin8((uint8_t)(lColumn * 7 - lTime));
+    }
+
+    for(lRow = 0; lRow < lRows; lRow++) {
+
+        lLed = &pThis->mBase.mPanel[lRow * WS2812_NR_COLUMNS];
+
+        for(lColumn = 0; lColumn < lColumns; lColumn++) {
+
+            lSum = (uint32_t)lColumnWave[lColumn] + lRowWave[lRow] +
+                   lDiagonalWave[lColumn + lRow] + lAntiDiagonalWave[lColumn + lRows - 1 - lRow];
+
+            /* average of the waves, shifted through the palette over time */
+            color_palette_get(&pThis->mPlasma.mCurrent, &lLed[lColumn], (uint8_t)((lSum >> 2) + lTime));
+        }
+    }
+}
+
+
+static void ws2812_anim_plasma_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    pThis->mPlasma.mFrom    = pThis->mPlasma.mCurrent;
+    pThis->mPlasma.mPalette = pParam->mPlasma.mPalette;
+
+    ws2812_anim_morph_start(&pThis->mPlasma.mMorph, inFrames);
+}
+
+
+void ws2812_anim_plasma_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
+
+    pThis->mBase.mfUpdate       = ws2812_anim_plasma_update;
+    pThis->mBase.mfMorph        = ws2812_anim_plasma_morph;
+    pThis->mPlasma.mPalette     = pParam->mPlasma.mPalette;
+    pThis->mPlasma.mCurrent     = *color_palette_from_enum(pParam->mPlasma.mPalette);
+    pThis->mPlasma.mMorph.mFrame  = 0;
+    pThis->mPlasma.mMorph.mFrames = 0;
+    pThis->mPlasma.mTime        = 0;
+}
+
+
+/* eof */
@@ -0,0 +1,165 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "ws2812.h"
+
+#include "ws2812_anim.h"
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_program.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+/*! A stored program */
+typedef struct {
+
+    /*! program, 32 bit aligned for ws2812_vm_load() */
+    uint32_t    mCode[WS2812_VM_PROGRAM_MAX / sizeof(uint32_t)];
+
+    /*! length in bytes, 0 for an empty slot */
+    size_t      mLength;
+
+    /*! incremented with every store */
+    uint32_t    mVersion;
+
+} ts_ws2812_program_slot;
+
+
+/*! Stored programs */
+static ts_ws2812_program_slot sProgramSlots[WS2812_PROGRAM_SLOTS];
+
+
+bool ws2812_program_store(size_t inSlot, const uint8_t * inProgram, size_t inLength) {
+
+    ts_ws2812_program_slot * lSlot;
+    ts_ws2812_vm lVm;
+    uint32_t * lCheck;
+    bool lValid;
+
+    if(inSlot >= WS2812_PROGRAM_SLOTS || inLength > WS2812_VM_PROGRAM_MAX) {
+        return false;
+    }
+
+    /* the caller's buffer may not be aligned, the check runs on a copy */
+    lCheck = (uint32_t*)malloc(WS2812_VM_PROGRAM_MAX);
+    if(!lCheck) {
+        printf("%s(%d): malloc failed!\r\n", __FILE__, __LINE__);
+        return false;
+    }
+
+    memcpy(lCheck, inProgram, inLength);
+    lValid = ws2812_vm_load(&lVm, lCheck, inLength, NULL);
+
+    if(lValid) {
+
+        lSlot = &sProgramSlots[inSlot];
+
+        taskENTER_CRITICAL();
+
+        memcpy(lSlot->mCode, lCheck, inLength);
+        lSlot->mLength = inLength;
+        lSlot->mVersion++;
+
+        taskEXIT_CRITICAL();
+    }
+
+    free(lCheck);
+
+    return lValid;
+}
+
+
+/*! Copy the program of the slot if it changed and load it */
+static void ws2812_anim_program_load(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_program * lProgram = &pThis->mProgram;
+    ts_ws2812_program_slot * lSlot = &sProgramSlots[lProgram->mSlot];
+    size_t lLength;
+
+    if(!lProgram->mCode || lProgram->mVersion == lSlot->mVersion) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+
+    lLength = lSlot->mLength;
+    lProgram->mVersion = lSlot->mVersion;
+    memcpy(lProgram->mCode, lSlot->mCode, lLength);
+
+    taskEXIT_CRITICAL();
+
+    /* the registers start at 0, the time goes on */
+    lProgram->mValid = ws2812_vm_load(&lProgram->mVm, lProgram->mCode, lLength, color_palette_from_enum(lProgram->mPalette));
+}
+
+
+static void ws2812_anim_program_update(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_program * lProgram = &pThis->mProgram;
+
+    ws2812_anim_program_load(pThis);
+
+    if(lProgram->mValid) {
+        ws2812_vm_run(&lProgram->mVm, pThis->mBase.mPanel, pThis->mBase.mRows, pThis->mBase.mColumns,
+                      WS2812_NR_COLUMNS, (int32_t)lProgram->mTime);
+    } else {
+        memset(pThis->mBase.mPanel, 0, sizeof(pThis->mBase.mPanel));
+    }
+
+    lProgram->mTime += lProgram->mTimeStep;
+}
+
+
+static void ws2812_anim_program_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    ts_ws2812_anim_program * lProgram = &pThis->mProgram;
+
+    (void)inFrames;
+
+    lProgram->mTimeStep = pParam->mProgram.mTimeStep;
+
+    if(pParam->mProgram.mSlot < WS2812_PROGRAM_SLOTS && pParam->mProgram.mSlot != lProgram->mSlot) {
+
+        lProgram->mSlot    = pParam->mProgram.mSlot;
+        lProgram->mVersion = sProgramSlots[lProgram->mSlot].mVersion - 1;
+    }
+
+    if(pParam->mProgram.mPalette != lProgram->mPalette) {
+
+        lProgram->mPalette     = pParam->mProgram.mPalette;
+        lProgram->mVm.mPalette = color_palette_from_enum(lProgram->mPalette);
+    }
+}
+
+
+void ws2812_anim_program_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
+
+    ts_ws2812_anim_program * lProgram = &pThis->mProgram;
+
+    pThis->mBase.mfUpdate = ws2812_anim_program_update;
+    pThis->mBase.mfMorph  = ws2812_anim_program_morph;
+    lProgram->mSlot       = (pParam->mProgram.mSlot < WS2812_PROGRAM_SLOTS)? pParam->mProgram.mSlot : 0;
+    lProgram->mPalette    = pParam->mProgram.mPalette;
+    lProgram->mTimeStep   = pParam->mProgram.mTimeStep;
+    lProgram->mTime       = 0;
+    lProgram->mValid      = false;
+
+    /* differs from the slot, so the first update loads the program */
+    lProgram->mVersion    = sProgramSlots[lProgram->mSlot].mVersion - 1;
+
+    lProgram->mCode = (uint32_t*)malloc(WS2812_VM_PROGRAM_MAX);
+    if(!lProgram->mCode) {
+        printf("%s(%d): malloc failed!\r\n", __FILE__, __LINE__);
+    }
+}
+
+
+void ws2812_anim_program_clean(tu_ws2812_anim * pThis) {
+
+    free(pThis->mProgram.mCode);
+}
+
+
+/* eof */
@@ -0,0 +1,88 @@
+#include "ws2812.h"
+
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_rainbow.h"
+
+#include "color_hsv.h"
+
+
+/*! Blend two bytes, inAmount of 255 is inTo */
+static inline uint8_t ws2812_anim_rainbow_blend(uint8_t inFrom, uint8_t inTo, uint8_t inAmount) {
+
+    return (uint8_t)(inFrom + ((int32_t)inTo - inFrom) * inAmount / 255);
+}
+
+
+static void ws2812_anim_rainbow_update(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_rainbow * lRainbow = &pThis->mRainbow;
+    uint8_t lAmount;
+
+    if(ws2812_anim_morph_active(&lRainbow->mMorph)) {
+
+        lAmount = ws2812_anim_morph_step(&lRainbow->mMorph);
+
+        lRainbow->mStep       = (int16_t)(lRainbow->mFromStep + (lRainbow->mToStep - lRainbow->mFromStep) * lAmount / 255);
+        lRainbow->mSaturation = ws2812_anim_rainbow_blend(lRainbow->mFromSaturation, lRainbow->mToSaturation, lAmount);
+        lRainbow->mValue      = ws2812_anim_rainbow_blend(lRainbow->mFromValue, lRainbow->mToValue, lAmount);
+
+        /* render again next frame */
+        if(ws2812_anim_morph_active(&lRainbow->mMorph)) {
+            pThis->mBase.mFlags |= WS2812_ANIM_FLAG_DIRTY;
+        }
+    }
+
+    lRainbow->mHue += (uint16_t)lRainbow->mSpeed;
+
+    color_hsv_fill_rainbow(pThis->mBase.mStrip, pThis->mBase.mColumns, lRainbow->mHue, lRainbow->mStep,
+                           lRainbow->mSaturation, lRainbow->mValue);
+}
+
+
+static void ws2812_anim_rainbow_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    ts_ws2812_anim_rainbow * lRainbow = &pThis->mRainbow;
+
+    lRainbow->mSpeed          = pParam->mRainbow.mSpeed;
+    lRainbow->mFromStep       = lRainbow->mStep;
+    lRainbow->mFromSaturation = lRainbow->mSaturation;
+    lRainbow->mFromValue      = lRainbow->mValue;
+    lRainbow->mToStep         = pParam->mRainbow.mStep;
+    lRainbow->mToSaturation   = pParam->mRainbow.mSaturation;
+    lRainbow->mToValue        = pParam->mRainbow.mValue;
+
+    if(lRainbow->mSpeed) {
+        pThis->mBase.mFlags &= ~WS2812_ANIM_FLAG_STATIC;
+    } else {
+        pThis->mBase.mFlags |= WS2812_ANIM_FLAG_STATIC;
+    }
+
+    ws2812_anim_morph_start(&lRainbow->mMorph, inFrames);
+
+    pThis->mBase.mFlags |= WS2812_ANIM_FLAG_DIRTY;
+}
+
+
+void ws2812_anim_rainbow_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
+
+    ts_ws2812_anim_rainbow * lRainbow = &pThis->mRainbow;
+
+    pThis->mBase.mfUpdate  = ws2812_anim_rainbow_update;
+    pThis->mBase.mfMorph   = ws2812_anim_rainbow_morph;
+    pThis->mBase.mFlags   |= WS2812_ANIM_FLAG_STRIP;
+
+    lRainbow->mHue          = 0;
+    lRainbow->mSpeed        = pParam->mRainbow.mSpeed;
+    lRainbow->mStep         = pParam->mRainbow.mStep;
+    lRainbow->mSaturation   = pParam->mRainbow.mSaturation;
+    lRainbow->mValue        = pParam->mRainbow.mValue;
+    lRainbow->mMorph.mFrame  = 0;
+    lRainbow->mMorph.mFrames = 0;
+
+    if(!lRainbow->mSpeed) {
+        pThis->mBase.mFlags |= WS2812_ANIM_FLAG_STATIC;
+    }
+}
+
+
+/* eof */
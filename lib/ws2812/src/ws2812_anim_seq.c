@@ -0,0 +1,302 @@
+#ifdef WS2812_ANIM_SEQ
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "ws2812.h"
+
+#include "ws2812_anim.h"
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_seq.h"
+
+#include "ff.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+
+/*! The loader */
+typedef struct {
+
+    /*! Given when a block was freed or a request changed */
+    SemaphoreHandle_t   mWakeup;
+
+    /*! Held by the loader while it fills blocks and to change a request */
+    SemaphoreHandle_t   mLock;
+
+    /*! Player to load for, NULL for none */
+    ts_ws2812_seq     * mRequest;
+
+    /*! File to load */
+    char                mPath[WS2812_SEQ_PATH_MAX];
+
+    /*! Incremented with every request */
+    uint32_t            mRequestCount;
+
+    /*! Request the loader works on */
+    uint32_t            mServedCount;
+
+    /*! Player the loader fills, the file is open while it is set */
+    ts_ws2812_seq     * mSeq;
+
+    /*! Volume and file */
+    FATFS               mFs;
+    FIL                 mFile;
+
+} ts_ws2812_seq_loader;
+
+
+/*! Loader of the sequence animations */
+static ts_ws2812_seq_loader sLoader;
+
+
+/*! Read callback for a FatFs file */
+static size_t ws2812_seq_file_read(void * pUser, uint8_t * outData, size_t inLength) {
+
+    UINT lRead;
+
+    if(f_read((FIL*)pUser, outData, (UINT)inLength, &lRead) != FR_OK) {
+        return 0;
+    }
+
+    return lRead;
+}
+
+
+/*! Rewind callback for a FatFs file */
+static bool ws2812_seq_file_rewind(void * pUser) {
+
+    return f_lseek((FIL*)pUser, 0) == FR_OK;
+}
+
+
+/*! Wake callback of the players */
+static void ws2812_seq_loader_wake(void * pUser) {
+
+    (void)pUser;
+
+    xSemaphoreGive(sLoader.mWakeup);
+}
+
+
+void ws2812_seq_loader_init(void) {
+
+    sLoader.mWakeup = xSemaphoreCreateCounting(1, 0);
+    sLoader.mLock   = xSemaphoreCreateMutex();
+
+    if(!sLoader.mWakeup || !sLoader.mLock) {
+        printf("%s(%d): semaphore create failed!\r\n", __FILE__, __LINE__);
+    }
+
+    /* only registers the work area, the volume is mounted with the first open */
+    f_mount(0, &sLoader.mFs);
+}
+
+
+void ws2812_seq_loader_main(void) {
+
+    FRESULT lResult;
+
+    xSemaphoreTake(sLoader.mWakeup, portMAX_DELAY);
+    xSemaphoreTake(sLoader.mLock, portMAX_DELAY);
+
+    /* a player which was released is never touched again */
+    if(sLoader.mServedCount != sLoader.mRequestCount) {
+
+        sLoader.mServedCount = sLoader.mRequestCount;
+
+        if(sLoader.mSeq) {
+            f_close(&sLoader.mFile);
+            sLoader.mSeq = NULL;
+        }
+
+        if(sLoader.mRequest) {
+
+            lResult = f_open(&sLoader.mFile, sLoader.mPath, FA_READ | FA_OPEN_EXISTING);
+
+            if(lResult == FR_OK) {
+                sLoader.mSeq = sLoader.mRequest;
+            } else {
+                printf("%s(%d): Can't open %s (%d)\r\n", __FILE__, __LINE__, sLoader.mPath, (int)lResult);
+            }
+        }
+    }
+
+    /* read ahead until both blocks are full, the player frees them one by one */
+    while(sLoader.mSeq && ws2812_seq_stream_free(&sLoader.mSeq->mStream)) {
+
+        if(!ws2812_seq_stream_fill(&sLoader.mSeq->mStream, ws2812_seq_file_read, ws2812_seq_file_rewind, &sLoader.mFile)) {
+
+            printf("%s(%d): Can't read %s\r\n", __FILE__, __LINE__, sLoader.mPath);
+
+            f_close(&sLoader.mFile);
+            sLoader.mSeq = NULL;
+        }
+    }
+
+    xSemaphoreGive(sLoader.mLock);
+}
+
+
+/*! Ask the loader to fill a player from a file, replaces any other player */
+static void ws2812_seq_loader_request(ts_ws2812_seq * inSeq, const char * inPath) {
+
+    xSemaphoreTake(sLoader.mLock, portMAX_DELAY);
+
+    sLoader.mRequest = inSeq;
+    strncpy(sLoader.mPath, inPath, sizeof(sLoader.mPath) - 1);
+    sLoader.mPath[sizeof(sLoader.mPath) - 1] = '\0';
+    sLoader.mRequestCount++;
+
+    xSemaphoreGive(sLoader.mLock);
+
+    xSemaphoreGive(sLoader.mWakeup);
+}
+
+
+/*! Stop loading for a player, it is not used by the loader afterwards */
+static void ws2812_seq_loader_release(ts_ws2812_seq * inSeq) {
+
+    xSemaphoreTake(sLoader.mLock, portMAX_DELAY);
+
+    if(sLoader.mRequest == inSeq) {
+        sLoader.mRequest = NULL;
+        sLoader.mRequestCount++;
+    }
+
+    xSemaphoreGive(sLoader.mLock);
+
+    xSemaphoreGive(sLoader.mWakeup);
+}
+
+
+/*! Start the sequence of mPath, the area is cleared with the next update */
+static void ws2812_anim_seq_start(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_seq * lSeq = &pThis->mSeq;
+
+    lSeq->mValid     = lSeq->mSeq != NULL;
+    lSeq->mClear     = true;
+    lSeq->mCountdown = 0;
+
+    if(lSeq->mValid) {
+
+        ws2812_seq_init(lSeq->mSeq, ws2812_seq_loader_wake, NULL);
+        ws2812_seq_loader_request(lSeq->mSeq, lSeq->mPath);
+    }
+}
+
+
+static void ws2812_anim_seq_update(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_seq * lSeq = &pThis->mSeq;
+    ts_ws2812_canvas lCanvas;
+    size_t lRow;
+    uint32_t lDelay;
+
+    if(lSeq->mClear) {
+
+        for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+
+            memset(&pThis->mBase.mPanel[lRow * WS2812_NR_COLUMNS], 0, pThis->mBase.mColumns * sizeof(color));
+
+            ws2812_span_add(&pThis->mBase.mDirty[lRow], 0, pThis->mBase.mColumns);
+        }
+
+        lSeq->mClear = false;
+    }
+
+    if(!lSeq->mValid) {
+        return;
+    }
+
+    lSeq->mCountdown -= (int32_t)lSeq->mStep;
+
+    if(lSeq->mCountdown > 0) {
+        return;
+    }
+
+    ws2812_canvas_init(&lCanvas, pThis->mBase.mPanel, pThis->mBase.mColumns, pThis->mBase.mRows, WS2812_NR_COLUMNS);
+
+    switch(ws2812_seq_next_frame(lSeq->mSeq, &lCanvas, pThis->mBase.mDirty, &lDelay)) {
+
+        case WS2812_SEQ_FRAME:
+            lSeq->mCountdown += (int32_t)lDelay;
+
+            /* too slow to keep up, the next frame follows at once */
+            if(lSeq->mCountdown < 0) {
+                lSeq->mCountdown = 0;
+            }
+            break;
+
+        case WS2812_SEQ_WAIT:
+            /* not loaded yet, the frame is shown late */
+            lSeq->mCountdown = 0;
+            break;
+
+        default:
+            lSeq->mValid = false;
+            lSeq->mClear = true;
+            ws2812_seq_loader_release(lSeq->mSeq);
+            break;
+    }
+}
+
+
+static void ws2812_anim_seq_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    ts_ws2812_anim_seq * lSeq = &pThis->mSeq;
+
+    (void)inFrames;
+
+    lSeq->mStep = pParam->mSeq.mStep;
+
+    if(strncmp(pParam->mSeq.mPath, lSeq->mPath, sizeof(lSeq->mPath)) != 0) {
+
+        strncpy(lSeq->mPath, pParam->mSeq.mPath, sizeof(lSeq->mPath));
+
+        if(lSeq->mSeq) {
+            ws2812_seq_loader_release(lSeq->mSeq);
+        }
+
+        ws2812_anim_seq_start(pThis);
+    }
+}
+
+
+void ws2812_anim_seq_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
+
+    ts_ws2812_anim_seq * lSeq = &pThis->mSeq;
+
+    pThis->mBase.mfUpdate = ws2812_anim_seq_update;
+    pThis->mBase.mfMorph  = ws2812_anim_seq_morph;
+    pThis->mBase.mFlags  |= WS2812_ANIM_FLAG_SPANS;
+    lSeq->mStep           = pParam->mSeq.mStep;
+
+    strncpy(lSeq->mPath, pParam->mSeq.mPath, sizeof(lSeq->mPath));
+
+    lSeq->mSeq = (ts_ws2812_seq*)malloc(sizeof(ts_ws2812_seq));
+    if(!lSeq->mSeq) {
+        printf("%s(%d): malloc failed!\r\n", __FILE__, __LINE__);
+    }
+
+    ws2812_anim_seq_start(pThis);
+}
+
+
+void ws2812_anim_seq_clean(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_seq * lSeq = &pThis->mSeq;
+
+    if(lSeq->mSeq) {
+        ws2812_seq_loader_release(lSeq->mSeq);
+    }
+
+    free(lSeq->mSeq);
+}
+
+#endif /* WS2812_ANIM_SEQ */
+
+/* eof */
@@ -0,0 +1,263 @@
+#include <string.h>
+
+#include "ws2812.h"
+
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_text.h"
+#include "ws2812_font.h"
+
+
+/*! Number of rows showing text */
+static inline size_t ws2812_anim_text_rows(tu_ws2812_anim * pThis) {
+
+    return (pThis->mBase.mRows < WS2812_FONT_HEIGHT)? pThis->mBase.mRows : WS2812_FONT_HEIGHT;
+}
+
+
+/*! Get the glyph column at the cursor and advance it
+
+    Characters are followed by one blank column, the message by
+    WS2812_ANIM_TEXT_GAP blank columns. A pending message is taken over
+    when the gap is done.
+
+    \return the pixels of the column, bit 0 is the top row
+*/
+static uint8_t ws2812_anim_text_next_column(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_text * lText = &pThis->mText;
+    uint8_t lColumn = 0;
+    uint8_t lWidth;
+
+    if(lText->mChar < lText->mLength) {
+
+        lWidth = ws2812_font_width((uint8_t)lText->mText[lText->mChar]);
+
+        if(lText->mColumn < lWidth) {
+            lColumn = ws2812_font_column((uint8_t)lText->mText[lText->mChar], lText->mColumn);
+        }
+
+        /* the spacing column is part of the character */
+        if(++lText->mColumn > lWidth) {
+            lText->mColumn = 0;
+            lText->mChar++;
+        }
+
+    } else if(++lText->mColumn >= WS2812_ANIM_TEXT_GAP) {
+
+        if(lText->mNextPending) {
+
+            memcpy(lText->mText, lText->mNext, sizeof(lText->mText));
+            lText->mLength      = strlen(lText->mText);
+            lText->mNextPending = false;
+        }
+
+        lText->mColumn = 0;
+        lText->mChar   = 0;
+    }
+
+    return lColumn;
+}
+
+
+/*! Draw a glyph column into one column of the text rows */
+static void ws2812_anim_text_draw_column(tu_ws2812_anim * pThis, size_t inColumn, uint8_t inPixels) {
+
+    size_t lRow;
+    size_t lRows = ws2812_anim_text_rows(pThis);
+
+    for(lRow = 0; lRow < lRows; lRow++) {
+
+        pThis->mBase.mPanel[lRow * WS2812_NR_COLUMNS + inColumn] =
+            (inPixels & (1u << lRow))? pThis->mText.mForeground : pThis->mText.mBackground;
+    }
+}
+
+
+/*! Draw the whole area
+
+    A static text is drawn left aligned. A scrolling text starts with an
+    empty area and enters from the right.
+*/
+static void ws2812_anim_text_redraw(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_text * lText = &pThis->mText;
+    size_t lRow;
+    size_t lColumn;
+
+    for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+        for(lColumn = 0; lColumn < pThis->mBase.mColumns; lColumn++) {
+            pThis->mBase.mPanel[lRow * WS2812_NR_COLUMNS + lColumn] = lText->mBackground;
+        }
+
+        ws2812_span_add(&pThis->mBase.mDirty[lRow], 0, pThis->mBase.mColumns);
+    }
+
+    lText->mChar   = 0;
+    lText->mColumn = 0;
+    lText->mPhase  = 0;
+    lText->mRedraw = false;
+
+    if(lText->mStep == 0) {
+
+        for(lColumn = 0; lColumn < pThis->mBase.mColumns && lText->mChar < lText->mLength; lColumn++) {
+            ws2812_anim_text_draw_column(pThis, lColumn, ws2812_anim_text_next_column(pThis));
+        }
+    }
+}
+
+
+/*! Scroll the text rows left and draw the exposed columns
+
+    Only the new columns are rendered from the font, the rest of the
+    text is moved in place.
+*/
+static void ws2812_anim_text_scroll(tu_ws2812_anim * pThis, size_t inColumns) {
+
+    size_t lRow;
+    size_t lRows = ws2812_anim_text_rows(pThis);
+    size_t lColumns = pThis->mBase.mColumns;
+    size_t lColumn;
+
+    if(inColumns > lColumns) {
+        inColumns = lColumns;
+    }
+
+    for(lRow = 0; lRow < lRows; lRow++) {
+
+        memmove(&pThis->mBase.mPanel[lRow * WS2812_NR_COLUMNS],
+                &pThis->mBase.mPanel[lRow * WS2812_NR_COLUMNS + inColumns],
+                (lColumns - inColumns) * sizeof(color));
+
+        ws2812_span_add(&pThis->mBase.mDirty[lRow], 0, lColumns);
+    }
+
+    for(lColumn = lColumns - inColumns; lColumn < lColumns; lColumn++) {
+        ws2812_anim_text_draw_column(pThis, lColumn, ws2812_anim_text_next_column(pThis));
+    }
+}
+
+
+static void ws2812_anim_text_update(tu_ws2812_anim * pThis) {
+
+    ts_ws2812_anim_text * lText = &pThis->mText;
+    size_t lRow;
+
+    if(lText->mRecolored) {
+
+        for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+            ws2812_span_add(&pThis->mBase.mDirty[lRow], 0, pThis->mBase.mColumns);
+        }
+
+        lText->mRecolored = false;
+    }
+
+    if(lText->mRedraw) {
+
+        ws2812_anim_text_redraw(pThis);
+
+    } else if(lText->mStep > 0) {
+
+        lText->mPhase += lText->mStep;
+
+        /* frames without a full column step change nothing */
+        if(lText->mPhase >= 256) {
+
+            ws2812_anim_text_scroll(pThis, lText->mPhase >> 8);
+
+            lText->mPhase &= 0xFF;
+        }
+    }
+}
+
+
+/*! Take over new parameters
+
+    Colors and speed change right away. A new message of a scrolling text
+    follows after the current one has scrolled through, a static text is
+    replaced at once.
+*/
+static void ws2812_anim_text_morph(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam, uint32_t inFrames) {
+
+    ts_ws2812_anim_text * lText = &pThis->mText;
+    ts_ws2812_anim_param_text * lParam = &pParam->mText;
+    size_t lRow;
+    size_t lColumn;
+    color * lLed;
+
+    (void)inFrames;
+
+    if(!color_equal(&lText->mForeground, &lParam->mForeground) ||
+       !color_equal(&lText->mBackground, &lParam->mBackground)) {
+
+        /* recolor in place, the scroll position stays */
+        for(lRow = 0; lRow < pThis->mBase.mRows; lRow++) {
+            for(lColumn = 0; lColumn < pThis->mBase.mColumns; lColumn++) {
+
+                lLed = &pThis->mBase.mPanel[lRow * WS2812_NR_COLUMNS + lColumn];
+                *lLed = color_equal(lLed, &lText->mForeground)? lParam->mForeground : lParam->mBackground;
+            }
+        }
+
+        lText->mForeground = lParam->mForeground;
+        lText->mBackground = lParam->mBackground;
+        lText->mRecolored  = true;
+    }
+
+    if((lParam->mStep == 0) != (lText->mStep == 0)) {
+        lText->mRedraw = true;
+    }
+
+    lText->mStep = lParam->mStep;
+
+    if(lText->mStep == 0) {
+
+        if(lText->mNextPending || strncmp(lText->mText, lParam->mText, sizeof(lText->mText)) != 0) {
+
+            memcpy(lText->mText, lParam->mText, sizeof(lText->mText));
+            lText->mLength      = strlen(lText->mText);
+            lText->mNextPending = false;
+            lText->mRedraw      = true;
+        }
+
+    } else if(strncmp(lText->mNextPending? lText->mNext : lText->mText, lParam->mText, sizeof(lText->mText)) != 0) {
+
+        memcpy(lText->mNext, lParam->mText, sizeof(lText->mNext));
+        lText->mNextPending = true;
+    }
+
+    if(lText->mStep == 0) {
+        pThis->mBase.mFlags |= WS2812_ANIM_FLAG_STATIC;
+    } else {
+        pThis->mBase.mFlags &= ~WS2812_ANIM_FLAG_STATIC;
+    }
+
+    pThis->mBase.mFlags |= WS2812_ANIM_FLAG_DIRTY;
+}
+
+
+void ws2812_anim_text_init(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam) {
+
+    ts_ws2812_anim_text * lText = &pThis->mText;
+
+    pThis->mBase.mfUpdate = ws2812_anim_text_update;
+    pThis->mBase.mfMorph  = ws2812_anim_text_morph;
+    pThis->mBase.mFlags  |= WS2812_ANIM_FLAG_SPANS;
+
+    memcpy(lText->mText, pParam->mText.mText, sizeof(lText->mText));
+    lText->mText[sizeof(lText->mText) - 1] = '\0';
+
+    lText->mLength      = strlen(lText->mText);
+    lText->mNextPending = false;
+    lText->mForeground  = pParam->mText.mForeground;
+    lText->mBackground  = pParam->mText.mBackground;
+    lText->mStep        = pParam->mText.mStep;
+    lText->mRedraw      = true;
+    lText->mRecolored   = false;
+
+    if(lText->mStep == 0) {
+        pThis->mBase.mFlags |= WS2812_ANIM_FLAG_STATIC;
+    }
+}
+
+
+/* eof */
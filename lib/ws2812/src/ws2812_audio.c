@@ -0,0 +1,308 @@
+#include <string.h>
+
+#include "ws2812_audio.h"
+
+#include "mt_fft.h"
+#include "mt_tables.h"
+
+
+/* The full scale references are in 1/16 steps of log2, see ws2812_audio_log2() */
+
+/*! Power of a full scale sine in its bin, 2^26 after the window and the FFT */
+#define WS2812_AUDIO_FULL_BIN       (26 * 16)
+
+/*! Power of a full scale sine summed over the level samples, 2^29 per sample */
+#define WS2812_AUDIO_FULL_LEVEL     ((29 + 6) * 16)
+
+/*! Range of the levels in 1/16 steps of log2, about 3 dB per step of 16 */
+#define WS2812_AUDIO_RANGE_LOG2     ((WS2812_AUDIO_RANGE * 16 * 100) / 301)
+
+/*! Largest shift of a quiet block before the FFT */
+#define WS2812_AUDIO_SHIFT_MAX      (8)
+
+/*! Bands which are the bass of the beat */
+#define WS2812_AUDIO_BASS_BANDS     (2)
+
+
+/*! First bin of every band and the end of the last one, 93.75 Hz per bin after decimating 48 kHz */
+static const uint8_t sBandBins[WS2812_AUDIO_BANDS + 1] = {
+    1, 2, 3, 4, 5, 6, 7, 8, 11, 15, 21, 28, 38, 52, 70, 95, 128
+};
+
+/*! 16 * log2(1 + n / 16) */
+static const uint8_t sLog2Fraction[16] = {
+    0, 1, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 15
+};
+
+
+/*! log2 in 1/16 steps, 0 for 0 */
+static uint32_t ws2812_audio_log2(uint64_t inValue) {
+
+    uint32_t lBit;
+    uint32_t lFraction;
+
+    if(inValue == 0) {
+        return 0;
+    }
+
+    lBit = 63 - (uint32_t)__builtin_clzll(inValue);
+
+    if(lBit >= 4) {
+        lFraction = (uint32_t)(inValue >> (lBit - 4)) & 15;
+    } else {
+        lFraction = (uint32_t)(inValue << (4 - lBit)) & 15;
+    }
+
+    return lBit * 16 + sLog2Fraction[lFraction];
+}
+
+
+/*! Map a log2 of a power to a level
+
+    \param[in]  inLog2      ws2812_audio_log2() of the power
+    \param[in]  inFull      ws2812_audio_log2() of the power at full scale
+*/
+static uint8_t ws2812_audio_level(int32_t inLog2, int32_t inFull) {
+
+    int32_t lLevel = inLog2 - (inFull - WS2812_AUDIO_RANGE_LOG2);
+
+    if(lLevel <= 0) {
+        return 0;
+    }
+
+    lLevel = (lLevel * 255) / WS2812_AUDIO_RANGE_LOG2;
+
+    return (lLevel > 255)? 255 : (uint8_t)lLevel;
+}
+
+
+/*! Let a level fall, or rise at once */
+static inline uint8_t ws2812_audio_follow(uint8_t inLevel, uint8_t inNew, uint8_t inFall) {
+
+    if(inNew + inFall >= inLevel) {
+        return inNew;
+    }
+
+    return inLevel - inFall;
+}
+
+
+void ws2812_audio_ring_init(ts_ws2812_audio_ring * pThis) {
+
+    memset(pThis->mSamples, 0, sizeof(pThis->mSamples));
+
+    pThis->mWritten = 0;
+    pThis->mSum     = 0;
+    pThis->mSummed  = 0;
+}
+
+
+void ws2812_audio_ring_push(ts_ws2812_audio_ring * pThis, const int16_t * inSamples, size_t inFrames, size_t inChannels) {
+
+    uint32_t lWritten = pThis->mWritten;
+    size_t lFrame;
+    size_t lChannel;
+    int32_t lMono;
+
+    if(inChannels == 0) {
+        return;
+    }
+
+    for(lFrame = 0; lFrame < inFrames; lFrame++, inSamples += inChannels) {
+
+        lMono = 0;
+        for(lChannel = 0; lChannel < inChannels; lChannel++) {
+            lMono += inSamples[lChannel];
+        }
+
+        pThis->mSum += lMono / (int32_t)inChannels;
+
+        if(++pThis->mSummed == WS2812_AUDIO_DECIMATE) {
+
+            pThis->mSamples[lWritten & (WS2812_AUDIO_RING - 1)] = (int16_t)(pThis->mSum / WS2812_AUDIO_DECIMATE);
+            lWritten++;
+
+            pThis->mSum    = 0;
+            pThis->mSummed = 0;
+        }
+    }
+
+    /* the samples have to be in place before the reader sees them */
+    __sync_synchronize();
+
+    pThis->mWritten = lWritten;
+}
+
+
+bool ws2812_audio_ring_read(const ts_ws2812_audio_ring * pThis, int16_t * outBlock, uint32_t * pWritten) {
+
+    uint32_t lWritten = pThis->mWritten;
+    uint32_t lStart;
+    uint32_t lFirst;
+
+    if(lWritten == *pWritten) {
+        return false;
+    }
+
+    /* the samples are read after the count, the writer only overwrites
+       the oldest ones of the ring meanwhile */
+    __sync_synchronize();
+
+    /* the ring starts with zeros, so this also works before the first block */
+    lStart = (lWritten - WS2812_AUDIO_BLOCK) & (WS2812_AUDIO_RING - 1);
+    lFirst = WS2812_AUDIO_RING - lStart;
+
+    if(lFirst >= WS2812_AUDIO_BLOCK) {
+        memcpy(outBlock, &pThis->mSamples[lStart], WS2812_AUDIO_BLOCK * sizeof(int16_t));
+    } else {
+        memcpy(outBlock, &pThis->mSamples[lStart], lFirst * sizeof(int16_t));
+        memcpy(&outBlock[lFirst], pThis->mSamples, (WS2812_AUDIO_BLOCK - lFirst) * sizeof(int16_t));
+    }
+
+    *pWritten = lWritten;
+
+    return true;
+}
+
+
+void ws2812_audio_init(ts_ws2812_audio * pThis) {
+
+    memset(pThis, 0, sizeof(*pThis));
+
+    pThis->mSinceBeat = WS2812_AUDIO_BEAT_HOLD;
+}
+
+
+/*! Window a block into the FFT data, scaled up as far as the loudest sample allows
+
+    \return the shift of the samples
+*/
+static uint32_t ws2812_audio_window(ts_ws2812_audio * pThis, const int16_t * inBlock) {
+
+    int32_t lSample;
+    int32_t lPeak = 0;
+    uint32_t lShift = 0;
+    size_t lCount;
+
+    for(lCount = 0; lCount < WS2812_AUDIO_BLOCK; lCount++) {
+
+        /* Hann window 0.5 - 0.5 cos, from the twiddle table of the FFT */
+        lSample = (inBlock[lCount] * ((32767 - mt_sin16_wave[(lCount + MT_FFT_MAX / 4) & (MT_FFT_MAX - 1)]) >> 1)) >> 15;
+
+        pThis->mFft[2 * lCount]     = (int16_t)lSample;
+        pThis->mFft[2 * lCount + 1] = 0;
+
+        if(lSample < 0) {
+            lSample = -lSample;
+        }
+        if(lSample > lPeak) {
+            lPeak = lSample;
+        }
+    }
+
+    /* block floating point, quiet music keeps the precision of the FFT */
+    while(lShift < WS2812_AUDIO_SHIFT_MAX && (lPeak << (lShift + 1)) <= 32767) {
+        lShift++;
+    }
+
+    if(lShift > 0 && lPeak > 0) {
+        for(lCount = 0; lCount < WS2812_AUDIO_BLOCK; lCount++) {
+            pThis->mFft[2 * lCount] = (int16_t)(pThis->mFft[2 * lCount] * (1 << lShift));
+        }
+    }
+
+    return lShift;
+}
+
+
+void ws2812_audio_analyze(ts_ws2812_audio * pThis, const int16_t * inBlock) {
+
+    uint8_t lBands[WS2812_AUDIO_BANDS];
+    uint8_t lLevel = 0;
+    uint8_t lBass = 0;
+    uint64_t lPower;
+    uint64_t lBassPower = 0;
+    uint32_t lShift;
+    uint32_t lBin;
+    size_t lBand;
+    size_t lCount;
+    int32_t lSample;
+
+    memset(lBands, 0, sizeof(lBands));
+
+    if(inBlock) {
+
+        lShift = ws2812_audio_window(pThis, inBlock);
+
+        mt_fft_q15(pThis->mFft, WS2812_AUDIO_BLOCK);
+
+        for(lBand = 0; lBand < WS2812_AUDIO_BANDS; lBand++) {
+
+            lPower = 0;
+            for(lBin = sBandBins[lBand]; lBin < sBandBins[lBand + 1]; lBin++) {
+                lPower += mt_fft_power(pThis->mFft, lBin);
+            }
+
+            if(lBand < WS2812_AUDIO_BASS_BANDS) {
+                lBassPower += lPower;
+            }
+
+            /* the shift scaled the power by 4^shift */
+            if(lPower) {
+                lBands[lBand] = ws2812_audio_level((int32_t)ws2812_audio_log2(lPower) - (int32_t)(32 * lShift), WS2812_AUDIO_FULL_BIN);
+            }
+        }
+
+        if(lBassPower) {
+            lBass = ws2812_audio_level((int32_t)ws2812_audio_log2(lBassPower) - (int32_t)(32 * lShift), WS2812_AUDIO_FULL_BIN);
+        }
+
+        /* the level only looks at the newest samples, without window */
+        lPower = 0;
+        for(lCount = WS2812_AUDIO_BLOCK - WS2812_AUDIO_LEVEL_SAMPLES; lCount < WS2812_AUDIO_BLOCK; lCount++) {
+            lSample = inBlock[lCount];
+            lPower += (uint32_t)(lSample * lSample);
+        }
+
+        lLevel = ws2812_audio_level((int32_t)ws2812_audio_log2(lPower), WS2812_AUDIO_FULL_LEVEL);
+    }
+
+    for(lBand = 0; lBand < WS2812_AUDIO_BANDS; lBand++) {
+        pThis->mBands[lBand] = ws2812_audio_follow(pThis->mBands[lBand], lBands[lBand], WS2812_AUDIO_FALL);
+    }
+
+    pThis->mLevel = ws2812_audio_follow(pThis->mLevel, lLevel, WS2812_AUDIO_FALL);
+
+    if(pThis->mLevel >= pThis->mPeak) {
+        pThis->mPeak     = pThis->mLevel;
+        pThis->mPeakHold = WS2812_AUDIO_PEAK_HOLD;
+    } else if(pThis->mPeakHold > 0) {
+        pThis->mPeakHold--;
+    } else {
+        pThis->mPeak = ws2812_audio_follow(pThis->mPeak, pThis->mLevel, WS2812_AUDIO_FALL);
+    }
+
+    /* a beat is a jump of the bass over its recent average */
+    if(pThis->mSinceBeat < WS2812_AUDIO_BEAT_HOLD) {
+        pThis->mSinceBeat++;
+    }
+
+    pThis->mBeat = lBass >= WS2812_AUDIO_BEAT_MIN &&
+                   lBass >= (pThis->mBassAverage >> 8) + WS2812_AUDIO_BEAT_RISE &&
+                   pThis->mSinceBeat >= WS2812_AUDIO_BEAT_HOLD;
+
+    if(pThis->mBeat) {
+        pThis->mPulse     = 255;
+        pThis->mSinceBeat = 0;
+        pThis->mBeats++;
+    } else {
+        pThis->mPulse = (pThis->mPulse > WS2812_AUDIO_PULSE_FALL)? pThis->mPulse - WS2812_AUDIO_PULSE_FALL : 0;
+    }
+
+    /* average over about 16 analyses */
+    pThis->mBassAverage = (uint16_t)(pThis->mBassAverage + (((int32_t)lBass << 8) - (int32_t)pThis->mBassAverage) / 16);
+    pThis->mBass        = lBass;
+}
+
+
+/* eof */
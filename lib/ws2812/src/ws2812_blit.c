@@ -0,0 +1,440 @@
+#include <stdio.h>      // for printf
+#include <string.h>     // for memcpy
+
+#include "ws2812_blit.h"
+
+#if !defined(WS2812_BLIT_CPU)
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+#include "stm32f4xx_dma.h"
+#include "stm32f4xx_rcc.h"
+#include "misc.h"
+
+#include "ws2812_cycles.h"
+#endif
+
+
+/*! DMA2 stream of the jobs, only DMA2 can copy memory to memory */
+#define WS2812_BLIT_STREAM          DMA2_Stream0
+
+/*! Interrupt of the stream */
+#define WS2812_BLIT_IRQ             DMA2_Stream0_IRQn
+
+/*! All flags of the stream */
+#define WS2812_BLIT_FLAGS           (DMA_FLAG_TCIF0 | DMA_FLAG_HTIF0 | DMA_FLAG_TEIF0 | DMA_FLAG_DMEIF0 | DMA_FLAG_FEIF0)
+
+/*! Most items of one transfer */
+#define WS2812_BLIT_ITEMS_MAX       (0xFFFF)
+
+/*! Jobs in the ring, one stays free to tell a full ring from an empty one */
+#define WS2812_BLIT_RING            (WS2812_BLIT_QUEUE + 1)
+
+/*! Check for an address in the core coupled memory, which the DMA can't reach */
+#define WS2812_BLIT_CCM(p)          (((uintptr_t)(p) & 0xFFFF0000u) == 0x10000000u)
+
+/*! Index of the rates */
+#define WS2812_BLIT_RATE_COPY       (0)
+#define WS2812_BLIT_RATE_FILL       (1)
+
+
+/*! A copy or fill of the DMA */
+typedef struct {
+
+    /*! First byte to write */
+    uint8_t               * mTarget;
+
+    /*! First byte to read, NULL to fill with mPattern */
+    const uint8_t         * mSource;
+
+    /*! Fill pattern, the same in every item of mSize */
+    uint32_t                mPattern;
+
+    /*! Number of items */
+    uint16_t                mItems;
+
+    /*! Bytes per item, 1, 2 or 4 */
+    uint8_t                 mSize;
+
+} ts_ws2812_blit_job;
+
+
+/*! The blit service */
+typedef struct {
+
+    /*! Queued jobs, mTail is running */
+    ts_ws2812_blit_job      mJob[WS2812_BLIT_RING];
+
+    /*! Next free job, written by the task */
+    volatile size_t         mHead;
+
+    /*! Running job, written by the interrupt */
+    volatile size_t         mTail;
+
+    /*! The task waits for mDone */
+    volatile bool           mWaiting;
+
+    /*! The jobs can be queued, the DMA is set up */
+    bool                    mReady;
+
+    /*! CPU cycles per 256 bytes of a copy and a fill, 0 until measured */
+    uint32_t                mRate[2];
+
+    /*! CPU cycles of the bytes moved by the DMA */
+    uint32_t                mSaved;
+
+    /*! Cycles spent queuing and waiting */
+    uint32_t                mSpent;
+
+#if !defined(WS2812_BLIT_CPU)
+    /*! Given when the last job is done and the task waits */
+    SemaphoreHandle_t       mDone;
+#endif
+
+} ts_ws2812_blit;
+
+
+static ts_ws2812_blit sBlit;
+
+
+/*! Do a job with the CPU */
+static void ws2812_blit_run(const ts_ws2812_blit_job * inJob) {
+
+    size_t lCount;
+
+    if(inJob->mSource) {
+
+        memcpy(inJob->mTarget, inJob->mSource, (size_t)inJob->mItems * inJob->mSize);
+
+    } else if(inJob->mSize == 4) {
+
+        uint32_t * lTarget = (uint32_t*)inJob->mTarget;
+
+        for(lCount = 0; lCount < inJob->mItems; lCount++) {
+            lTarget[lCount] = inJob->mPattern;
+        }
+
+    } else {
+
+        /* smaller items have the same byte all over */
+        memset(inJob->mTarget, (uint8_t)inJob->mPattern, (size_t)inJob->mItems * inJob->mSize);
+    }
+}
+
+
+#if defined(WS2812_BLIT_CPU)
+
+static inline uint32_t ws2812_blit_cycles(void) {
+
+    return 0;
+}
+
+
+/*! The host has no DMA, the CPU does the job right away */
+static void ws2812_blit_enqueue(const ts_ws2812_blit_job * inJob) {
+
+    ws2812_blit_run(inJob);
+}
+
+
+static void ws2812_blit_drain(void) {
+}
+
+
+void ws2812_blit_init(void) {
+
+    memset(&sBlit, 0, sizeof(sBlit));
+
+    sBlit.mReady = true;
+}
+
+
+bool ws2812_blit_busy(void) {
+
+    return false;
+}
+
+
+#else /* WS2812_BLIT_CPU */
+
+static inline uint32_t ws2812_blit_cycles(void) {
+
+    return ws2812_cycles();
+}
+
+
+/*! Start the DMA on a job, the stream is disabled */
+static void ws2812_blit_start(const ts_ws2812_blit_job * inJob) {
+
+    DMA_InitTypeDef lInit;
+
+    lInit.DMA_Channel            = DMA_Channel_0;
+    lInit.DMA_PeripheralBaseAddr = (uint32_t)(inJob->mSource? inJob->mSource : (const uint8_t*)&inJob->mPattern);
+    lInit.DMA_Memory0BaseAddr    = (uint32_t)inJob->mTarget;
+    lInit.DMA_DIR                = DMA_DIR_MemoryToMemory;
+    lInit.DMA_BufferSize         = inJob->mItems;
+    lInit.DMA_PeripheralInc      = inJob->mSource? DMA_PeripheralInc_Enable : DMA_PeripheralInc_Disable;
+    lInit.DMA_MemoryInc          = DMA_MemoryInc_Enable;
+    lInit.DMA_PeripheralDataSize = (inJob->mSize == 4)? DMA_PeripheralDataSize_Word :
+                                   (inJob->mSize == 2)? DMA_PeripheralDataSize_HalfWord : DMA_PeripheralDataSize_Byte;
+    lInit.DMA_MemoryDataSize     = (inJob->mSize == 4)? DMA_MemoryDataSize_Word :
+                                   (inJob->mSize == 2)? DMA_MemoryDataSize_HalfWord : DMA_MemoryDataSize_Byte;
+    lInit.DMA_Mode               = DMA_Mode_Normal;
+    lInit.DMA_Priority           = DMA_Priority_Low;                /* the leds go first */
+    lInit.DMA_FIFOMode           = DMA_FIFOMode_Enable;             /* memory to memory needs the fifo */
+    lInit.DMA_FIFOThreshold      = DMA_FIFOThreshold_Full;
+    lInit.DMA_MemoryBurst        = DMA_MemoryBurst_Single;          /* short bus accesses for the led dma */
+    lInit.DMA_PeripheralBurst    = DMA_PeripheralBurst_Single;
+
+    DMA_ClearFlag(WS2812_BLIT_STREAM, WS2812_BLIT_FLAGS);
+    DMA_Init(WS2812_BLIT_STREAM, &lInit);
+    DMA_ITConfig(WS2812_BLIT_STREAM, DMA_IT_TC | DMA_IT_TE, ENABLE);
+    DMA_Cmd(WS2812_BLIT_STREAM, ENABLE);
+}
+
+
+/*! Wait until the ring is empty */
+static void ws2812_blit_drain(void) {
+
+    bool lBusy;
+
+    taskENTER_CRITICAL();
+    lBusy = (sBlit.mHead != sBlit.mTail);
+    sBlit.mWaiting = lBusy;
+    taskEXIT_CRITICAL();
+
+    if(lBusy) {
+        xSemaphoreTake(sBlit.mDone, portMAX_DELAY);
+    }
+}
+
+
+/*! Queue a job, the DMA starts on it if it is idle */
+static void ws2812_blit_enqueue(const ts_ws2812_blit_job * inJob) {
+
+    bool lIdle;
+
+    if((sBlit.mHead + 1) % WS2812_BLIT_RING == sBlit.mTail) {
+        ws2812_blit_drain();
+    }
+
+    sBlit.mJob[sBlit.mHead] = *inJob;
+
+    /* the source is written before the DMA reads it */
+    __sync_synchronize();
+
+    taskENTER_CRITICAL();
+    lIdle = (sBlit.mHead == sBlit.mTail);
+    sBlit.mHead = (sBlit.mHead + 1) % WS2812_BLIT_RING;
+    taskEXIT_CRITICAL();
+
+    /* the interrupt starts the next job otherwise */
+    if(lIdle) {
+        ws2812_blit_start(&sBlit.mJob[sBlit.mTail]);
+    }
+}
+
+
+void ws2812_blit_init(void) {
+
+    NVIC_InitTypeDef lNvic;
+
+    memset(&sBlit, 0, sizeof(sBlit));
+
+    sBlit.mDone = xSemaphoreCreateCounting(1, 0);
+    if(!sBlit.mDone) {
+        printf("%s(%d): semaphore create failed!\r\n", __FILE__, __LINE__);
+        return;
+    }
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+    DMA_DeInit(WS2812_BLIT_STREAM);
+
+    /* same priority as the led dma, it gives semaphores too */
+    lNvic.NVIC_IRQChannel                   = WS2812_BLIT_IRQ;
+    lNvic.NVIC_IRQChannelPreemptionPriority = 7;
+    lNvic.NVIC_IRQChannelSubPriority        = 0;
+    lNvic.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_Init(&lNvic);
+
+    sBlit.mReady = true;
+}
+
+
+bool ws2812_blit_busy(void) {
+
+    return sBlit.mHead != sBlit.mTail;
+}
+
+
+/*! Handler for the blit DMA */
+void DMA2_Stream0_IRQHandler(void) {
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if(DMA_GetITStatus(WS2812_BLIT_STREAM, DMA_IT_TEIF0)) {
+
+        /* the CPU does the job the DMA couldn't */
+        ws2812_blit_run(&sBlit.mJob[sBlit.mTail]);
+
+    } else if(!DMA_GetITStatus(WS2812_BLIT_STREAM, DMA_IT_TCIF0)) {
+        return;
+    }
+
+    DMA_ClearFlag(WS2812_BLIT_STREAM, WS2812_BLIT_FLAGS);
+
+    sBlit.mTail = (sBlit.mTail + 1) % WS2812_BLIT_RING;
+
+    if(sBlit.mTail != sBlit.mHead) {
+
+        ws2812_blit_start(&sBlit.mJob[sBlit.mTail]);
+
+    } else if(sBlit.mWaiting) {
+
+        sBlit.mWaiting = false;
+        xSemaphoreGiveFromISR(sBlit.mDone, &xHigherPriorityTaskWoken);
+    }
+
+    portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
+}
+
+
+#endif /* WS2812_BLIT_CPU */
+
+
+/*! Check if the DMA can do a job */
+static bool ws2812_blit_dma(const void * inTarget, const void * inSource, size_t inBytes) {
+
+    return sBlit.mReady && inBytes >= WS2812_BLIT_MIN_DMA && !WS2812_BLIT_CCM(inTarget) && !WS2812_BLIT_CCM(inSource);
+}
+
+
+/*! Split bytes into jobs of the largest items their alignment allows
+
+    \param[in]  inCpu   Do the jobs with the CPU instead of queuing them
+*/
+static void ws2812_blit_split(uint8_t * outTarget, const uint8_t * inSource, uint32_t inPattern, size_t inBytes, bool inCpu) {
+
+    uintptr_t lAlign = (uintptr_t)outTarget | (uintptr_t)inSource | inBytes;
+    ts_ws2812_blit_job lJob;
+    size_t lItems;
+
+    lJob.mSource  = inSource;
+    lJob.mPattern = inPattern;
+    lJob.mSize    = ((lAlign & 3) == 0)? 4 : ((lAlign & 1) == 0)? 2 : 1;
+
+    for(lItems = inBytes / lJob.mSize; lItems > 0; lItems -= lJob.mItems) {
+
+        lJob.mTarget = outTarget;
+        lJob.mItems  = (uint16_t)((lItems > WS2812_BLIT_ITEMS_MAX)? WS2812_BLIT_ITEMS_MAX : lItems);
+
+        if(inCpu) {
+            ws2812_blit_run(&lJob);
+        } else {
+            ws2812_blit_enqueue(&lJob);
+        }
+
+        outTarget += (size_t)lJob.mItems * lJob.mSize;
+
+        if(lJob.mSource) {
+            lJob.mSource += (size_t)lJob.mItems * lJob.mSize;
+        }
+    }
+}
+
+
+/*! Queue the jobs of a copy or fill
+
+    The first one of a kind is done by the CPU to measure what the DMA
+    saves on the following ones.
+*/
+static void ws2812_blit_submit(uint8_t * outTarget, const uint8_t * inSource, uint32_t inPattern, size_t inBytes) {
+
+    size_t lKind = inSource? WS2812_BLIT_RATE_COPY : WS2812_BLIT_RATE_FILL;
+    uint32_t lStart = ws2812_blit_cycles();
+    uint32_t lRate;
+
+    if(sBlit.mRate[lKind] == 0) {
+
+        ws2812_blit_split(outTarget, inSource, inPattern, inBytes, true);
+
+        lRate = ((ws2812_blit_cycles() - lStart) << 8) / inBytes;
+        sBlit.mRate[lKind] = (lRate > 0)? lRate : 1;
+        return;
+    }
+
+    ws2812_blit_split(outTarget, inSource, inPattern, inBytes, false);
+
+    sBlit.mSaved += (sBlit.mRate[lKind] * inBytes) >> 8;
+    sBlit.mSpent += ws2812_blit_cycles() - lStart;
+}
+
+
+void ws2812_blit_copy(void * outTarget, const void * inSource, size_t inBytes) {
+
+    if(!ws2812_blit_dma(outTarget, inSource, inBytes)) {
+        memcpy(outTarget, inSource, inBytes);
+        return;
+    }
+
+    ws2812_blit_submit((uint8_t*)outTarget, (const uint8_t*)inSource, 0, inBytes);
+}
+
+
+void ws2812_blit_fill(color * outTarget, const color * inColor, size_t inCount) {
+
+    size_t lBytes = inCount * sizeof(color);
+    uint32_t lPattern;
+
+#if defined(COLOR_XRGB)
+    lPattern = color_word(inColor);
+#else
+    /* the DMA repeats items of up to 4 bytes, packed RGB only repeats in gray */
+    lPattern = inColor->R * 0x01010101u;
+
+    if(inColor->G != inColor->R || inColor->B != inColor->R) {
+        lBytes = 0;
+    }
+#endif
+
+    if(!ws2812_blit_dma(outTarget, NULL, lBytes)) {
+        color_fill(outTarget, inCount, inColor);
+        return;
+    }
+
+    ws2812_blit_submit((uint8_t*)outTarget, NULL, lPattern, lBytes);
+}
+
+
+void ws2812_blit_wait(void) {
+
+    uint32_t lStart;
+
+    if(!ws2812_blit_busy()) {
+        return;
+    }
+
+    lStart = ws2812_blit_cycles();
+    ws2812_blit_drain();
+    sBlit.mSpent += ws2812_blit_cycles() - lStart;
+}
+
+
+int32_t ws2812_blit_saved(void) {
+
+    int32_t lSaved = (int32_t)(sBlit.mSaved - sBlit.mSpent);
+
+    sBlit.mSaved = 0;
+    sBlit.mSpent = 0;
+
+#if defined(WS2812_BLIT_CPU)
+    /* no cycle counter */
+    lSaved = 0;
+#endif
+
+    return lSaved;
+}
+
+
+/* eof */
@@ -0,0 +1,282 @@
+#include <string.h>
+
+#include "ws2812_cells.h"
+
+
+/*! Shift a row so each cell gets the value of its left neighbour */
+static inline void ws2812_cells_from_left(uint32_t * outRow, const uint32_t * inRow) {
+
+    uint32_t lCarry = 0;
+    size_t lWord;
+
+    for(lWord = 0; lWord < WS2812_CELLS_WORDS; lWord++) {
+
+        outRow[lWord] = (inRow[lWord] << 1) | lCarry;
+        lCarry        = inRow[lWord] >> 31;
+    }
+}
+
+
+/*! Shift a row so each cell gets the value of its right neighbour */
+static inline void ws2812_cells_from_right(uint32_t * outRow, const uint32_t * inRow) {
+
+    uint32_t lCarry = 0;
+    size_t lWord = WS2812_CELLS_WORDS;
+
+    while(lWord-- > 0) {
+
+        outRow[lWord] = (inRow[lWord] >> 1) | lCarry;
+        lCarry        = inRow[lWord] << 31;
+    }
+}
+
+
+/*! Mask of the valid bits of a word */
+static inline uint32_t ws2812_cells_word_mask(size_t inWord, size_t inColumns) {
+
+    size_t lFirst = inWord * 32;
+
+    if(lFirst >= inColumns) {
+        return 0;
+    } else if(inColumns - lFirst >= 32) {
+        return 0xFFFFFFFFu;
+    } else {
+        return (1u << (inColumns - lFirst)) - 1;
+    }
+}
+
+
+size_t ws2812_cells_count(const ts_ws2812_cells_row * inRows, size_t inCount) {
+
+    size_t lCount = 0;
+    size_t lRow;
+    size_t lWord;
+
+    for(lRow = 0; lRow < inCount; lRow++) {
+        for(lWord = 0; lWord < WS2812_CELLS_WORDS; lWord++) {
+            lCount += (size_t)__builtin_popcount(inRows[lRow][lWord]);
+        }
+    }
+
+    return lCount;
+}
+
+
+void ws2812_cells_mask(ts_ws2812_cells_row * pRows, size_t inRows, size_t inColumns) {
+
+    size_t lRow;
+    size_t lWord;
+
+    for(lRow = 0; lRow < inRows; lRow++) {
+        for(lWord = 0; lWord < WS2812_CELLS_WORDS; lWord++) {
+            pRows[lRow][lWord] &= ws2812_cells_word_mask(lWord, inColumns);
+        }
+    }
+}
+
+
+void ws2812_cells_life(ts_ws2812_cells_row * outRows, const ts_ws2812_cells_row * inRows, size_t inCount, size_t inColumns) {
+
+    /* left and right neighbours of every row */
+    ts_ws2812_cells_row lLeft[WS2812_NR_ROWS];
+    ts_ws2812_cells_row lRight[WS2812_NR_ROWS];
+
+    size_t lRow;
+    size_t lAbove;
+    size_t lBelow;
+    size_t lWord;
+
+    uint32_t lSumA, lCarryA;
+    uint32_t lSumB, lCarryB;
+    uint32_t lSumC, lCarryC;
+    uint32_t lOnes, lCarryD;
+    uint32_t lSumE, lFoursA;
+    uint32_t lTwos, lFoursB;
+    uint32_t lFours;
+    uint32_t lN[8];
+
+    for(lRow = 0; lRow < inCount; lRow++) {
+        ws2812_cells_from_left(lLeft[lRow], inRows[lRow]);
+        ws2812_cells_from_right(lRight[lRow], inRows[lRow]);
+    }
+
+    for(lRow = 0; lRow < inCount; lRow++) {
+
+        lAbove = (lRow == 0)? inCount - 1 : lRow - 1;
+        lBelow = (lRow + 1 == inCount)? 0 : lRow + 1;
+
+        for(lWord = 0; lWord < WS2812_CELLS_WORDS; lWord++) {
+
+            lN[0] = lLeft[lAbove][lWord];
+            lN[1] = inRows[lAbove][lWord];
+            lN[2] = lRight[lAbove][lWord];
+            lN[3] = lLeft[lRow][lWord];
+            lN[4] = lRight[lRow][lWord];
+            lN[5] = lLeft[lBelow][lWord];
+            lN[6] = inRows[lBelow][lWord];
+            lN[7] = lRight[lBelow][lWord];
+
+            /* add the 8 neighbours bit by bit, counts of 8 wrap to 0 */
+            lSumA   = lN[0] ^ lN[1] ^ lN[2];
+            lCarryA = (lN[0] & lN[1]) | (lN[2] & (lN[0] ^ lN[1]));
+            lSumB   = lN[3] ^ lN[4] ^ lN[5];
+            lCarryB = (lN[3] & lN[4]) | (lN[5] & (lN[3] ^ lN[4]));
+            lSumC   = lN[6] ^ lN[7];
+            lCarryC = lN[6] & lN[7];
+
+            lOnes   = lSumA ^ lSumB ^ lSumC;
+            lCarryD = (lSumA & lSumB) | (lSumC & (lSumA ^ lSumB));
+
+            lSumE   = lCarryA ^ lCarryB ^ lCarryC;
+            lFoursA = (lCarryA & lCarryB) | (lCarryC & (lCarryA ^ lCarryB));
+
+            lTwos   = lSumE ^ lCarryD;
+            lFoursB = lSumE & lCarryD;
+            lFours  = lFoursA ^ lFoursB;
+
+            /* 3 neighbours give birth, 2 keep a cell alive */
+            outRows[lRow][lWord] = lTwos & ~lFours & (lOnes | inRows[lRow][lWord]) & ws2812_cells_word_mask(lWord, inColumns);
+        }
+    }
+}
+
+
+/*! Let grains of a row slide down to one side
+
+    \param[in,out] pRow     Grains which could not fall
+    \param[in,out] pBelow   Row below
+    \param[in]  inLeft      Slide to the left
+*/
+static void ws2812_cells_sand_slide(uint32_t * pRow, uint32_t * pBelow, size_t inColumns, bool inLeft) {
+
+    ts_ws2812_cells_row lNeighbour;
+    ts_ws2812_cells_row lMoving;
+    ts_ws2812_cells_row lTarget;
+    size_t lWord;
+
+    uint32_t lEdge;
+
+    /* cell below on the side of each grain */
+    if(inLeft) {
+        ws2812_cells_from_left(lNeighbour, pBelow);
+    } else {
+        ws2812_cells_from_right(lNeighbour, pBelow);
+    }
+
+    for(lWord = 0; lWord < WS2812_CELLS_WORDS; lWord++) {
+
+        /* grains in the first or last column can't leave the area */
+        lEdge = ws2812_cells_word_mask(lWord, inColumns);
+
+        if(inLeft && lWord == 0) {
+            lEdge &= ~1u;
+        } else if(!inLeft && lWord == (inColumns - 1) >> 5) {
+            lEdge &= ~(1u << ((inColumns - 1) & 31));
+        }
+
+        lMoving[lWord] = pRow[lWord] & pBelow[lWord] & ~lNeighbour[lWord] & lEdge;
+        pRow[lWord]   &= ~lMoving[lWord];
+    }
+
+    /* every target has exactly one source */
+    if(inLeft) {
+        ws2812_cells_from_right(lTarget, lMoving);
+    } else {
+        ws2812_cells_from_left(lTarget, lMoving);
+    }
+
+    for(lWord = 0; lWord < WS2812_CELLS_WORDS; lWord++) {
+        pBelow[lWord] |= lTarget[lWord];
+    }
+}
+
+
+void ws2812_cells_sand(ts_ws2812_cells_row * pRows, size_t inCount, size_t inColumns, bool inLeftFirst) {
+
+    size_t lRow;
+    size_t lWord;
+    uint32_t lFalling;
+
+    if(inCount < 2) {
+        return;
+    }
+
+    /* from the bottom up, so a grain moves at most one row per step */
+    for(lRow = inCount - 1; lRow-- > 0; ) {
+
+        for(lWord = 0; lWord < WS2812_CELLS_WORDS; lWord++) {
+
+            lFalling = pRows[lRow][lWord] & ~pRows[lRow + 1][lWord];
+
+            pRows[lRow + 1][lWord] |= lFalling;
+            pRows[lRow][lWord]     &= ~lFalling;
+        }
+
+        ws2812_cells_sand_slide(pRows[lRow], pRows[lRow + 1], inColumns, inLeftFirst);
+        ws2812_cells_sand_slide(pRows[lRow], pRows[lRow + 1], inColumns, !inLeftFirst);
+    }
+}
+
+
+/*! Weighted sum of three neighbouring cells of a row */
+static inline uint32_t ws2812_cells_stencil_row(const uint8_t * inWeight, uint8_t inLeft, uint8_t inCenter, uint8_t inRight) {
+
+    return (uint32_t)inWeight[0] * inLeft + (uint32_t)inWeight[1] * inCenter + (uint32_t)inWeight[2] * inRight;
+}
+
+
+/*! Apply the stencil to one cell */
+static inline uint8_t ws2812_cells_stencil_cell(const ts_ws2812_stencil * inStencil,
+                                                const uint8_t * inAbove, const uint8_t * inRow, const uint8_t * inBelow,
+                                                size_t inLeft, size_t inColumn, size_t inRight) {
+
+    uint32_t lSum = ws2812_cells_stencil_row(inStencil->mWeight[0], inAbove[inLeft], inAbove[inColumn], inAbove[inRight]) +
+                    ws2812_cells_stencil_row(inStencil->mWeight[1], inRow[inLeft],   inRow[inColumn],   inRow[inRight]) +
+                    ws2812_cells_stencil_row(inStencil->mWeight[2], inBelow[inLeft], inBelow[inColumn], inBelow[inRight]);
+
+    lSum >>= inStencil->mShift;
+
+    return (lSum > 255)? 255 : (uint8_t)lSum;
+}
+
+
+void ws2812_cells_stencil(uint8_t * outCells, const uint8_t * inCells, size_t inRows, size_t inColumns, size_t inStride,
+                          const ts_ws2812_stencil * inStencil) {
+
+    const uint8_t * lAbove;
+    const uint8_t * lRow;
+    const uint8_t * lBelow;
+    uint8_t * lOut;
+    size_t lCount;
+    size_t lColumn;
+
+    if(inRows == 0 || inColumns == 0) {
+        return;
+    }
+
+    for(lCount = 0; lCount < inRows; lCount++) {
+
+        /* the border rows are their own neighbours */
+        lRow   = &inCells[lCount * inStride];
+        lAbove = (lCount > 0)? lRow - inStride : lRow;
+        lBelow = (lCount + 1 < inRows)? lRow + inStride : lRow;
+        lOut   = &outCells[lCount * inStride];
+
+        if(inColumns == 1) {
+            lOut[0] = ws2812_cells_stencil_cell(inStencil, lAbove, lRow, lBelow, 0, 0, 0);
+            continue;
+        }
+
+        lOut[0] = ws2812_cells_stencil_cell(inStencil, lAbove, lRow, lBelow, 0, 0, 1);
+
+        /* no border checks inside */
+        for(lColumn = 1; lColumn + 1 < inColumns; lColumn++) {
+            lOut[lColumn] = ws2812_cells_stencil_cell(inStencil, lAbove, lRow, lBelow, lColumn - 1, lColumn, lColumn + 1);
+        }
+
+        lOut[inColumns - 1] = ws2812_cells_stencil_cell(inStencil, lAbove, lRow, lBelow, inColumns - 2, inColumns - 1, inColumns - 1);
+    }
+}
+
+
+/* eof */
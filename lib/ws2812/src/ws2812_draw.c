@@ -0,0 +1,396 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>     // for memcpy
+
+#include "ws2812_draw.h"
+
+
+/*! Fill inCount pixels in a row */
+static inline void ws2812_draw_fill(color * pPixels, int32_t inCount, const color * inColor) {
+
+    color_fill(pPixels, (size_t)inCount, inColor);
+}
+
+
+/*! Clip the range inStart to inStart + inLength (excluding) to 0 .. inSize
+
+    \return false if nothing is left
+*/
+static inline bool ws2812_draw_clip(int32_t * pStart, int32_t * pEnd, int32_t inStart, int32_t inLength, int32_t inSize) {
+
+    *pStart = (inStart < 0)? 0 : inStart;
+    *pEnd   = (inStart + inLength > inSize)? inSize : inStart + inLength;
+
+    return *pStart < *pEnd;
+}
+
+
+void ws2812_draw_hspan(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inLength, const color * inColor) {
+
+    int32_t lStart;
+    int32_t lEnd;
+
+    if(inY < 0 || inY >= inCanvas->mHeight || !ws2812_draw_clip(&lStart, &lEnd, inX, inLength, inCanvas->mWidth)) {
+        return;
+    }
+
+    ws2812_draw_fill(ws2812_canvas_pixel(inCanvas, (int16_t)lStart, inY), lEnd - lStart, inColor);
+}
+
+
+void ws2812_draw_vspan(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inLength, const color * inColor) {
+
+    int32_t lStart;
+    int32_t lEnd;
+    color * lPixel;
+
+    if(inX < 0 || inX >= inCanvas->mWidth || !ws2812_draw_clip(&lStart, &lEnd, inY, inLength, inCanvas->mHeight)) {
+        return;
+    }
+
+    for(lPixel = ws2812_canvas_pixel(inCanvas, inX, (int16_t)lStart); lStart < lEnd; lStart++, lPixel += inCanvas->mStride) {
+        *lPixel = *inColor;
+    }
+}
+
+
+void ws2812_draw_rect(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inWidth, int16_t inHeight, const color * inColor) {
+
+    int32_t lLeft;
+    int32_t lRight;
+    int32_t lTop;
+    int32_t lBottom;
+    color * lRow;
+
+    if(!ws2812_draw_clip(&lLeft, &lRight, inX, inWidth, inCanvas->mWidth) ||
+       !ws2812_draw_clip(&lTop, &lBottom, inY, inHeight, inCanvas->mHeight)) {
+        return;
+    }
+
+    for(lRow = ws2812_canvas_pixel(inCanvas, (int16_t)lLeft, (int16_t)lTop); lTop < lBottom; lTop++, lRow += inCanvas->mStride) {
+        ws2812_draw_fill(lRow, lRight - lLeft, inColor);
+    }
+}
+
+
+void ws2812_draw_rect_outline(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inWidth, int16_t inHeight, const color * inColor) {
+
+    if(inWidth <= 0 || inHeight <= 0) {
+        return;
+    }
+
+    ws2812_draw_hspan(inCanvas, inX, inY, inWidth, inColor);
+
+    if(inHeight > 1) {
+        ws2812_draw_hspan(inCanvas, inX, (int16_t)(inY + inHeight - 1), inWidth, inColor);
+    }
+
+    /* sides without the corners */
+    ws2812_draw_vspan(inCanvas, inX, (int16_t)(inY + 1), (int16_t)(inHeight - 2), inColor);
+
+    if(inWidth > 1) {
+        ws2812_draw_vspan(inCanvas, (int16_t)(inX + inWidth - 1), (int16_t)(inY + 1), (int16_t)(inHeight - 2), inColor);
+    }
+}
+
+
+/*! Get the steps of a line axis which are within 0 .. inSize - 1
+
+    The position at step i is inStart + inDirection * i.
+*/
+static inline void ws2812_draw_line_steps(int32_t * pFirst, int32_t * pLast, int32_t inStart, int32_t inDirection, int32_t inSize) {
+
+    if(inDirection > 0) {
+        *pFirst = -inStart;
+        *pLast  = inSize - 1 - inStart;
+    } else {
+        *pFirst = inStart - (inSize - 1);
+        *pLast  = inStart;
+    }
+}
+
+
+void ws2812_draw_line(const ts_ws2812_canvas * inCanvas, int16_t inX0, int16_t inY0, int16_t inX1, int16_t inY1, const color * inColor) {
+
+    int32_t lDx = (inX1 >= inX0)? inX1 - inX0 : inX0 - inX1;
+    int32_t lDy = (inY1 >= inY0)? inY1 - inY0 : inY0 - inY1;
+    int32_t lStepX = (inX1 >= inX0)? 1 : -1;
+    int32_t lStepY = (inY1 >= inY0)? 1 : -1;
+
+    int32_t lMajor;         /* steps along the major axis */
+    int32_t lMinor;         /* steps along the minor axis */
+    int32_t lMajorDelta;    /* pixel index change of a major step */
+    int32_t lMinorDelta;    /* pixel index change of a minor step */
+
+    int32_t lFirst;         /* first step within the canvas */
+    int32_t lLast;          /* last step within the canvas */
+    int32_t lMinorFirst;    /* first minor offset within the canvas */
+    int32_t lMinorLast;     /* last minor offset within the canvas */
+    int32_t lLimit;
+
+    int32_t lError;
+    int32_t lIndex;
+    int32_t lOffset;
+
+    /* pixel offset of the minor axis at step i is (2 * i * lMinor + lMajor) / (2 * lMajor) */
+    if(lDx >= lDy) {
+
+        lMajor      = lDx;
+        lMinor      = lDy;
+        lMajorDelta = lStepX;
+        lMinorDelta = lStepY * (int32_t)inCanvas->mStride;
+
+        ws2812_draw_line_steps(&lFirst, &lLast, inX0, lStepX, inCanvas->mWidth);
+        ws2812_draw_line_steps(&lMinorFirst, &lMinorLast, inY0, lStepY, inCanvas->mHeight);
+
+    } else {
+
+        lMajor      = lDy;
+        lMinor      = lDx;
+        lMajorDelta = lStepY * (int32_t)inCanvas->mStride;
+        lMinorDelta = lStepX;
+
+        ws2812_draw_line_steps(&lFirst, &lLast, inY0, lStepY, inCanvas->mHeight);
+        ws2812_draw_line_steps(&lMinorFirst, &lMinorLast, inX0, lStepX, inCanvas->mWidth);
+    }
+
+    /* clip the steps to the line itself */
+    lFirst = (lFirst < 0)? 0 : lFirst;
+    lLast  = (lLast > lMajor)? lMajor : lLast;
+
+    /* clip the steps to the minor axis */
+    if(lMinorLast < 0) {
+        return;
+    }
+
+    if(lMinor == 0) {
+
+        if(lMinorFirst > 0) {
+            return;
+        }
+
+    } else {
+
+        if(lMinorFirst > 0) {
+
+            /* first step with offset >= lMinorFirst, rounded up */
+            lLimit = (2 * lMajor * lMinorFirst - lMajor + 2 * lMinor - 1) / (2 * lMinor);
+            lFirst = (lLimit > lFirst)? lLimit : lFirst;
+        }
+
+        /* last step with offset <= lMinorLast */
+        lLimit = (2 * lMajor * (lMinorLast + 1) - lMajor - 1) / (2 * lMinor);
+        lLast  = (lLimit < lLast)? lLimit : lLast;
+    }
+
+    if(lFirst > lLast) {
+        return;
+    }
+
+    /* start at the first visible step */
+    if(lMajor > 0) {
+        lOffset = (2 * lFirst * lMinor + lMajor) / (2 * lMajor);
+        lError  = (2 * lFirst * lMinor + lMajor) % (2 * lMajor);
+    } else {
+        lOffset = 0;
+        lError  = 0;
+    }
+
+    lIndex = inY0 * (int32_t)inCanvas->mStride + inX0 + lFirst * lMajorDelta + lOffset * lMinorDelta;
+
+    for(; lFirst <= lLast; lFirst++, lIndex += lMajorDelta) {
+
+        inCanvas->mPixels[lIndex] = *inColor;
+
+        lError += 2 * lMinor;
+
+        if(lError >= 2 * lMajor) {
+            lError -= 2 * lMajor;
+            lIndex += lMinorDelta;
+        }
+    }
+}
+
+
+/*! Set the 8 symmetric points of a circle
+
+    \param[in]  inClip  Check each point, only needed if the circle isn't completely within the canvas
+*/
+static inline void ws2812_draw_circle_points(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY,
+                                             int16_t inDx, int16_t inDy, bool inClip, const color * inColor) {
+
+    const int16_t lX[8] = { inX + inDx, inX - inDx, inX + inDx, inX - inDx, inX + inDy, inX - inDy, inX + inDy, inX - inDy };
+    const int16_t lY[8] = { inY + inDy, inY + inDy, inY - inDy, inY - inDy, inY + inDx, inY + inDx, inY - inDx, inY - inDx };
+    size_t lCount;
+
+    for(lCount = 0; lCount < 8; lCount++) {
+
+        if(!inClip || (lX[lCount] >= 0 && lX[lCount] < inCanvas->mWidth && lY[lCount] >= 0 && lY[lCount] < inCanvas->mHeight)) {
+            *ws2812_canvas_pixel(inCanvas, lX[lCount], lY[lCount]) = *inColor;
+        }
+    }
+}
+
+
+void ws2812_draw_circle(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inRadius, const color * inColor) {
+
+    int16_t lDx = inRadius;
+    int16_t lDy = 0;
+    int32_t lError = 1 - inRadius;
+    bool lClip;
+
+    if(inRadius < 0 ||
+       inX + inRadius < 0 || inX - inRadius >= inCanvas->mWidth ||
+       inY + inRadius < 0 || inY - inRadius >= inCanvas->mHeight) {
+        return;
+    }
+
+    /* points are only checked if the circle crosses the border */
+    lClip = inX - inRadius < 0 || inX + inRadius >= inCanvas->mWidth ||
+            inY - inRadius < 0 || inY + inRadius >= inCanvas->mHeight;
+
+    while(lDx >= lDy) {
+
+        ws2812_draw_circle_points(inCanvas, inX, inY, lDx, lDy, lClip, inColor);
+
+        lDy++;
+
+        if(lError < 0) {
+            lError += 2 * lDy + 1;
+        } else {
+            lDx--;
+            lError += 2 * (lDy - lDx) + 1;
+        }
+    }
+}
+
+
+void ws2812_draw_circle_filled(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, int16_t inRadius, const color * inColor) {
+
+    int16_t lDx = inRadius;
+    int16_t lDy = 0;
+    int32_t lError = 1 - inRadius;
+
+    if(inRadius < 0 ||
+       inX + inRadius < 0 || inX - inRadius >= inCanvas->mWidth ||
+       inY + inRadius < 0 || inY - inRadius >= inCanvas->mHeight) {
+        return;
+    }
+
+    /* every row is drawn once as a span */
+    while(lDx >= lDy) {
+
+        ws2812_draw_hspan(inCanvas, (int16_t)(inX - lDx), (int16_t)(inY + lDy), (int16_t)(2 * lDx + 1), inColor);
+
+        if(lDy != 0) {
+            ws2812_draw_hspan(inCanvas, (int16_t)(inX - lDx), (int16_t)(inY - lDy), (int16_t)(2 * lDx + 1), inColor);
+        }
+
+        /* the rows at +-lDx are done when lDx moves on */
+        if(lError >= 0 && lDx != lDy) {
+            ws2812_draw_hspan(inCanvas, (int16_t)(inX - lDy), (int16_t)(inY + lDx), (int16_t)(2 * lDy + 1), inColor);
+            ws2812_draw_hspan(inCanvas, (int16_t)(inX - lDy), (int16_t)(inY - lDx), (int16_t)(2 * lDy + 1), inColor);
+        }
+
+        lDy++;
+
+        if(lError < 0) {
+            lError += 2 * lDy + 1;
+        } else {
+            lDx--;
+            lError += 2 * (lDy - lDx) + 1;
+        }
+    }
+}
+
+
+void ws2812_draw_sprite(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const ts_ws2812_canvas * inSprite, const color * inKey) {
+
+    int32_t lLeft;
+    int32_t lRight;
+    int32_t lTop;
+    int32_t lBottom;
+    int32_t lColumn;
+    const color * lSource;
+    color * lTarget;
+
+    if(!ws2812_draw_clip(&lLeft, &lRight, inX, inSprite->mWidth, inCanvas->mWidth) ||
+       !ws2812_draw_clip(&lTop, &lBottom, inY, inSprite->mHeight, inCanvas->mHeight)) {
+        return;
+    }
+
+    lSource = ws2812_canvas_pixel(inSprite, (int16_t)(lLeft - inX), (int16_t)(lTop - inY));
+    lTarget = ws2812_canvas_pixel(inCanvas, (int16_t)lLeft, (int16_t)lTop);
+
+    for(; lTop < lBottom; lTop++, lSource += inSprite->mStride, lTarget += inCanvas->mStride) {
+
+        if(inKey == NULL) {
+
+            memcpy(lTarget, lSource, (size_t)(lRight - lLeft) * sizeof(color));
+
+        } else {
+
+            for(lColumn = 0; lColumn < lRight - lLeft; lColumn++) {
+
+                if(!color_equal(&lSource[lColumn], inKey)) {
+                    lTarget[lColumn] = lSource[lColumn];
+                }
+            }
+        }
+    }
+}
+
+
+void ws2812_draw_sprite_rle(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const ts_ws2812_sprite * inSprite) {
+
+    int32_t lLeft;
+    int32_t lRight;
+    int32_t lTop;
+    int32_t lBottom;
+    int32_t lColumn;
+    int32_t lEnd;
+    uint32_t lLength;
+    uint32_t lIndex;
+    uint32_t lTransparent;
+    const uint8_t * lRun;
+    color * lTarget;
+
+    if(!ws2812_draw_clip(&lLeft, &lRight, inX, inSprite->mWidth, inCanvas->mWidth) ||
+       !ws2812_draw_clip(&lTop, &lBottom, inY, inSprite->mHeight, inCanvas->mHeight)) {
+        return;
+    }
+
+    lTransparent = (inSprite->mFormat == WS2812_SPRITE_RLE4)? WS2812_SPRITE_TRANSPARENT4 : WS2812_SPRITE_TRANSPARENT8;
+
+    for(; lTop < lBottom; lTop++) {
+
+        lRun    = &inSprite->mRuns[inSprite->mRows[lTop - inY]];
+        lTarget = ws2812_canvas_pixel(inCanvas, 0, (int16_t)lTop);
+
+        /* the runs of a row add up to the width, the row ends before that if clipped */
+        for(lColumn = inX; lColumn < lRight; lColumn = lEnd) {
+
+            if(inSprite->mFormat == WS2812_SPRITE_RLE4) {
+                lLength = (uint32_t)(*lRun >> 4) + 1;
+                lIndex  = *lRun & 0x0F;
+                lRun   += 1;
+            } else {
+                lLength = (uint32_t)lRun[0] + 1;
+                lIndex  = lRun[1];
+                lRun   += 2;
+            }
+
+            lEnd = lColumn + (int32_t)lLength;
+
+            if(lIndex != lTransparent && lEnd > lLeft) {
+
+                ws2812_draw_fill(&lTarget[(lColumn < lLeft)? lLeft : lColumn],
+                                 ((lEnd > lRight)? lRight : lEnd) - ((lColumn < lLeft)? lLeft : lColumn),
+                                 &inSprite->mPalette[lIndex]);
+            }
+        }
+    }
+}
+
+
+/* eof */
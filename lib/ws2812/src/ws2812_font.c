@@ -0,0 +1,360 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ws2812_font.h"
+
+
+/*! First character of the glyph table */
+#define WS2812_FONT_FIRST       (0x20)
+
+/*! Bit offset and width of a glyph in one table entry */
+#define WS2812_FONT_GLYPH(OFFSET, WIDTH)    ((uint16_t)(((OFFSET) << 4) | (WIDTH)))
+
+/*! Bit offset of a glyph table entry */
+#define WS2812_FONT_OFFSET(GLYPH)           ((GLYPH) >> 4)
+
+/*! Width of a glyph table entry */
+#define WS2812_FONT_WIDTH(GLYPH)            ((GLYPH) & 0x0F)
+
+
+/*! Glyph columns of WS2812_FONT_HEIGHT bits each, packed LSB first without padding */
+static const uint8_t sFontBits[] = {
+    0x00, 0xdc, 0x01, 0x86, 0xfa, 0xea, 0x2b, 0xd9, 0x6f, 0xca, 0x44, 0x44,
+    0x55, 0x15, 0x1d, 0x2e, 0x46, 0x57, 0x44, 0x21, 0x8e, 0x40, 0x44, 0x08,
+    0x81, 0x98, 0x0c, 0x17, 0xa3, 0x13, 0x3f, 0xd7, 0x2a, 0x63, 0xad, 0xea,
+    0x10, 0xf2, 0x6f, 0xad, 0xc9, 0xd5, 0x8a, 0x42, 0x2e, 0x43, 0xd5, 0xaa,
+    0x44, 0xad, 0x4e, 0x41, 0x45, 0x54, 0x54, 0x4a, 0x45, 0x45, 0x42, 0x2d,
+    0xc2, 0xc5, 0xba, 0x9c, 0x2f, 0xc5, 0xff, 0x5a, 0x95, 0x8b, 0x31, 0xfe,
+    0x18, 0xdd, 0xaf, 0x35, 0xfe, 0x52, 0x82, 0x8b, 0xb5, 0x7f, 0x42, 0x7e,
+    0xfc, 0x11, 0x41, 0xf8, 0x3e, 0x51, 0xf1, 0x43, 0x08, 0xbf, 0x20, 0xe2,
+    0x7f, 0x41, 0xd0, 0x77, 0x31, 0xba, 0x5f, 0x8a, 0x70, 0x31, 0xd9, 0x5f,
+    0x9a, 0x94, 0xb5, 0xa6, 0xf0, 0xc3, 0x83, 0xf0, 0x1d, 0x04, 0xd1, 0xf9,
+    0x88, 0xa0, 0x1f, 0x15, 0x51, 0x31, 0x08, 0x2e, 0x42, 0xae, 0x75, 0xfe,
+    0x38, 0x08, 0x8e, 0x5f, 0x04, 0x01, 0x21, 0x84, 0x41, 0x30, 0xe9, 0xbf,
+    0x64, 0x4c, 0x4a, 0x26, 0x3f, 0xd3, 0xd4, 0x17, 0x59, 0xdf, 0x17, 0xbc,
+    0xc3, 0xf6, 0x89, 0xfe, 0x5e, 0x78, 0xc1, 0xbd, 0xe0, 0x4c, 0xb2, 0x5f,
+    0x84, 0x28, 0xdf, 0x0b, 0x59, 0xd3, 0x93, 0x0e, 0x7a, 0x07, 0x9d, 0x83,
+    0x0c, 0x3a, 0xc9, 0xe4, 0xa4, 0x4f, 0x6a, 0x4b, 0x54, 0xfc, 0x51, 0x11,
+    0x22, 0x88, 0x38, 0xe5, 0x74, 0xa5, 0x7a, 0x93, 0xb2, 0x35, 0x08, 0x9b,
+    0x2f, 0x13, 0x25, 0xda, 0x13, 0x4d, 0x0d, 0x76,
+};
+
+/*! Glyph of each Latin-1 character from WS2812_FONT_FIRST, width 0 if the font has none */
+static const uint16_t sFontGlyphs[] = {
+    WS2812_FONT_GLYPH(   0, 2),    /* ' ' */
+    WS2812_FONT_GLYPH(  10, 1),    /* '!' */
+    WS2812_FONT_GLYPH(  15, 3),    /* '"' */
+    WS2812_FONT_GLYPH(  30, 5),    /* '#' */
+    WS2812_FONT_GLYPH(  55, 4),    /* '$' */
+    WS2812_FONT_GLYPH(  75, 4),    /* '%' */
+    WS2812_FONT_GLYPH(  95, 4),    /* '&' */
+    WS2812_FONT_GLYPH( 115, 1),    /* '\'' */
+    WS2812_FONT_GLYPH( 120, 2),    /* '(' */
+    WS2812_FONT_GLYPH( 130, 2),    /* ')' */
+    WS2812_FONT_GLYPH( 140, 3),    /* 0x2a */
+    WS2812_FONT_GLYPH( 155, 3),    /* '+' */
+    WS2812_FONT_GLYPH( 170, 2),    /* ',' */
+    WS2812_FONT_GLYPH( 180, 3),    /* '-' */
+    WS2812_FONT_GLYPH( 195, 1),    /* '.' */
+    WS2812_FONT_GLYPH( 200, 3),    /* 0x2f */
+    WS2812_FONT_GLYPH( 215, 4),    /* '0' */
+    WS2812_FONT_GLYPH( 235, 2),    /* '1' */
+    WS2812_FONT_GLYPH( 245, 4),    /* '2' */
+    WS2812_FONT_GLYPH( 265, 4),    /* '3' */
+    WS2812_FONT_GLYPH( 285, 4),    /* '4' */
+    WS2812_FONT_GLYPH( 305, 4),    /* '5' */
+    WS2812_FONT_GLYPH( 325, 4),    /* '6' */
+    WS2812_FONT_GLYPH( 345, 4),    /* '7' */
+    WS2812_FONT_GLYPH( 365, 4),    /* '8' */
+    WS2812_FONT_GLYPH( 385, 4),    /* '9' */
+    WS2812_FONT_GLYPH( 405, 1),    /* ':' */
+    WS2812_FONT_GLYPH( 410, 2),    /* ';' */
+    WS2812_FONT_GLYPH( 420, 3),    /* '<' */
+    WS2812_FONT_GLYPH( 435, 3),    /* '=' */
+    WS2812_FONT_GLYPH( 450, 3),    /* '>' */
+    WS2812_FONT_GLYPH( 465, 4),    /* '?' */
+    WS2812_FONT_GLYPH( 485, 5),    /* '@' */
+    WS2812_FONT_GLYPH( 510, 4),    /* 'A' */
+    WS2812_FONT_GLYPH( 530, 4),    /* 'B' */
+    WS2812_FONT_GLYPH( 550, 4),    /* 'C' */
+    WS2812_FONT_GLYPH( 570, 4),    /* 'D' */
+    WS2812_FONT_GLYPH( 590, 4),    /* 'E' */
+    WS2812_FONT_GLYPH( 610, 4),    /* 'F' */
+    WS2812_FONT_GLYPH( 630, 4),    /* 'G' */
+    WS2812_FONT_GLYPH( 650, 4),    /* 'H' */
+    WS2812_FONT_GLYPH( 670, 3),    /* 'I' */
+    WS2812_FONT_GLYPH( 685, 4),    /* 'J' */
+    WS2812_FONT_GLYPH( 705, 4),    /* 'K' */
+    WS2812_FONT_GLYPH( 725, 4),    /* 'L' */
+    WS2812_FONT_GLYPH( 745, 5),    /* 'M' */
+    WS2812_FONT_GLYPH( 770, 5),    /* 'N' */
+    WS2812_FONT_GLYPH( 795, 4),    /* 'O' */
+    WS2812_FONT_GLYPH( 815, 4),    /* 'P' */
+    WS2812_FONT_GLYPH( 835, 4),    /* 'Q' */
+    WS2812_FONT_GLYPH( 855, 4),    /* 'R' */
+    WS2812_FONT_GLYPH( 875, 4),    /* 'S' */
+    WS2812_FONT_GLYPH( 895, 3),    /* 'T' */
+    WS2812_FONT_GLYPH( 910, 4),    /* 'U' */
+    WS2812_FONT_GLYPH( 930, 5),    /* 'V' */
+    WS2812_FONT_GLYPH( 955, 5),    /* 'W' */
+    WS2812_FONT_GLYPH( 980, 5),    /* 'X' */
+    WS2812_FONT_GLYPH(1005, 5),    /* 'Y' */
+    WS2812_FONT_GLYPH(1030, 4),    /* 'Z' */
+    WS2812_FONT_GLYPH(1050, 2),    /* '[' */
+    WS2812_FONT_GLYPH(1060, 3),    /* '\\' */
+    WS2812_FONT_GLYPH(1075, 2),    /* ']' */
+    WS2812_FONT_GLYPH(1085, 3),    /* '^' */
+    WS2812_FONT_GLYPH(1100, 4),    /* '_' */
+    WS2812_FONT_GLYPH(1120, 2),    /* '`' */
+    WS2812_FONT_GLYPH(1130, 3),    /* 'a' */
+    WS2812_FONT_GLYPH(1145, 3),    /* 'b' */
+    WS2812_FONT_GLYPH(1160, 3),    /* 'c' */
+    WS2812_FONT_GLYPH(1175, 3),    /* 'd' */
+    WS2812_FONT_GLYPH(1190, 3),    /* 'e' */
+    WS2812_FONT_GLYPH(1205, 2),    /* 'f' */
+    WS2812_FONT_GLYPH(1215, 3),    /* 'g' */
+    WS2812_FONT_GLYPH(1230, 3),    /* 'h' */
+    WS2812_FONT_GLYPH(1245, 1),    /* 'i' */
+    WS2812_FONT_GLYPH(1250, 2),    /* 'j' */
+    WS2812_FONT_GLYPH(1260, 3),    /* 'k' */
+    WS2812_FONT_GLYPH(1275, 1),    /* 'l' */
+    WS2812_FONT_GLYPH(1280, 5),    /* 'm' */
+    WS2812_FONT_GLYPH(1305, 3),    /* 'n' */
+    WS2812_FONT_GLYPH(1320, 3),    /* 'o' */
+    WS2812_FONT_GLYPH(1335, 3),    /* 'p' */
+    WS2812_FONT_GLYPH(1350, 3),    /* 'q' */
+    WS2812_FONT_GLYPH(1365, 2),    /* 'r' */
+    WS2812_FONT_GLYPH(1375, 3),    /* 's' */
+    WS2812_FONT_GLYPH(1390, 2),    /* 't' */
+    WS2812_FONT_GLYPH(1400, 3),    /* 'u' */
+    WS2812_FONT_GLYPH(1415, 3),    /* 'v' */
+    WS2812_FONT_GLYPH(1430, 5),    /* 'w' */
+    WS2812_FONT_GLYPH(1455, 3),    /* 'x' */
+    WS2812_FONT_GLYPH(1470, 3),    /* 'y' */
+    WS2812_FONT_GLYPH(1485, 3),    /* 'z' */
+    WS2812_FONT_GLYPH(1500, 3),    /* '{' */
+    WS2812_FONT_GLYPH(1515, 1),    /* '|' */
+    WS2812_FONT_GLYPH(1520, 3),    /* '}' */
+    WS2812_FONT_GLYPH(1535, 4),    /* '~' */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x7f */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x80 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x81 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x82 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x83 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x84 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x85 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x86 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x87 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x88 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x89 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x8a */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x8b */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x8c */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x8d */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x8e */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x8f */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x90 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x91 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x92 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x93 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x94 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x95 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x96 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x97 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x98 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x99 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x9a */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x9b */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x9c */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x9d */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x9e */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0x9f */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xa0 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xa1 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xa2 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xa3 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xa4 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xa5 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xa6 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xa7 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xa8 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xa9 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xaa */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xab */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xac */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xad */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xae */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xaf */
+    WS2812_FONT_GLYPH(1555, 3),    /* 0xb0 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xb1 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xb2 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xb3 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xb4 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xb5 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xb6 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xb7 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xb8 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xb9 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xba */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xbb */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xbc */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xbd */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xbe */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xbf */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xc0 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xc1 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xc2 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xc3 */
+    WS2812_FONT_GLYPH(1570, 4),    /* 0xc4 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xc5 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xc6 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xc7 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xc8 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xc9 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xca */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xcb */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xcc */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xcd */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xce */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xcf */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xd0 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xd1 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xd2 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xd3 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xd4 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xd5 */
+    WS2812_FONT_GLYPH(1590, 4),    /* 0xd6 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xd7 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xd8 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xd9 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xda */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xdb */
+    WS2812_FONT_GLYPH(1610, 4),    /* 0xdc */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xdd */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xde */
+    WS2812_FONT_GLYPH(1630, 4),    /* 0xdf */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xe0 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xe1 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xe2 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xe3 */
+    WS2812_FONT_GLYPH(1650, 3),    /* 0xe4 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xe5 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xe6 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xe7 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xe8 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xe9 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xea */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xeb */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xec */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xed */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xee */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xef */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xf0 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xf1 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xf2 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xf3 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xf4 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xf5 */
+    WS2812_FONT_GLYPH(1665, 3),    /* 0xf6 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xf7 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xf8 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xf9 */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xfa */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xfb */
+    WS2812_FONT_GLYPH(1680, 3),    /* 0xfc */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xfd */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xfe */
+    WS2812_FONT_GLYPH(   0, 0),    /* 0xff */
+};
+
+
+/*! Look up the table entry of a character, uses the fallback if it has no glyph */
+static uint16_t ws2812_font_glyph(uint8_t inChar) {
+
+    uint16_t lGlyph = 0;
+
+    if(inChar >= WS2812_FONT_FIRST) {
+        lGlyph = sFontGlyphs[inChar - WS2812_FONT_FIRST];
+    }
+
+    if(WS2812_FONT_WIDTH(lGlyph) == 0) {
+        lGlyph = sFontGlyphs[WS2812_FONT_FALLBACK - WS2812_FONT_FIRST];
+    }
+
+    return lGlyph;
+}
+
+
+uint8_t ws2812_font_width(uint8_t inChar) {
+
+    return WS2812_FONT_WIDTH(ws2812_font_glyph(inChar));
+}
+
+
+uint8_t ws2812_font_column(uint8_t inChar, uint8_t inColumn) {
+
+    uint16_t lGlyph = ws2812_font_glyph(inChar);
+    uint32_t lBit;
+    uint32_t lBits;
+
+    if(inColumn >= WS2812_FONT_WIDTH(lGlyph)) {
+        return 0;
+    }
+
+    lBit  = WS2812_FONT_OFFSET(lGlyph) + (uint32_t)inColumn * WS2812_FONT_HEIGHT;
+
+    /* a column spans two bytes at most, the last one is padded */
+    lBits = sFontBits[lBit >> 3];
+
+    if((lBit >> 3) + 1 < sizeof(sFontBits)) {
+        lBits |= (uint32_t)sFontBits[(lBit >> 3) + 1] << 8;
+    }
+
+    return (uint8_t)((lBits >> (lBit & 7)) & ((1u << WS2812_FONT_HEIGHT) - 1));
+}
+
+
+size_t ws2812_font_from_utf8(char * outText, size_t inSize, const char * inText) {
+
+    const uint8_t * lRead = (const uint8_t *)inText;
+    size_t lLength = 0;
+    uint8_t lChar;
+
+    if(inSize == 0) {
+        return 0;
+    }
+
+    while(*lRead != '\0' && lLength + 1 < inSize) {
+
+        lChar = *lRead++;
+
+        if(lChar >= 0x80) {
+
+            if((lChar == 0xC2 || lChar == 0xC3) && (*lRead & 0xC0) == 0x80) {
+
+                /* two byte sequence within Latin-1 */
+                lChar = (uint8_t)(((lChar & 0x1F) << 6) | (*lRead++ & 0x3F));
+
+            } else {
+
+                /* skip the rest of the sequence */
+                if(lChar >= 0xC0) {
+                    while((*lRead & 0xC0) == 0x80) {
+                        lRead++;
+                    }
+                }
+
+                lChar = WS2812_FONT_FALLBACK;
+            }
+        }
+
+        outText[lLength++] = (char)lChar;
+    }
+
+    outText[lLength] = '\0';
+
+    return lLength;
+}
+
+
+/* eof */
@@ -0,0 +1,744 @@
+#include <string.h>     // for memcpy
+
+#include "ws2812_gif.h"
+
+
+/*! Block introducers */
+#define WS2812_GIF_EXTENSION        (0x21)
+#define WS2812_GIF_IMAGE            (0x2C)
+#define WS2812_GIF_TRAILER          (0x3B)
+
+/*! Label of the graphic control extension */
+#define WS2812_GIF_GRAPHIC_CONTROL  (0xF9)
+
+/*! Disposal methods */
+#define WS2812_GIF_DISPOSE_BACKGROUND   (2)
+#define WS2812_GIF_DISPOSE_PREVIOUS     (3)
+
+/*! Canvas column or row without a screen column or row */
+#define WS2812_GIF_NONE             (0xFFFF)
+
+/*! Delay of frames without one in 1/100 s, like browsers */
+#define WS2812_GIF_DEFAULT_DELAY    (10)
+
+/*! Longest LZW code in bits */
+#define WS2812_GIF_CODE_BITS        (12)
+
+
+/*! First row and row step of the four interlace passes */
+static const uint8_t sInterlaceStart[4] = { 0, 4, 2, 1 };
+static const uint8_t sInterlaceStep[4]  = { 8, 8, 4, 2 };
+
+
+/*! Position of the next pixel of a frame */
+typedef struct {
+
+    /*! Canvas to draw on */
+    const ts_ws2812_canvas    * mCanvas;
+
+    /*! Color table */
+    const color               * mColors;
+
+    /*! Transparent index, -1 for none */
+    int16_t                     mTransparent;
+
+    /*! Left screen column and width of the frame */
+    uint16_t                    mLeft;
+    uint16_t                    mWidth;
+
+    /*! Top screen row and height of the frame */
+    uint16_t                    mTop;
+    uint16_t                    mHeight;
+
+    /*! Canvas columns the frame covers */
+    int16_t                     mFirstX;
+    int16_t                     mEndX;
+
+    /*! Frame row and column of the next pixel */
+    uint16_t                    mRow;
+    uint16_t                    mColumn;
+
+    /*! Interlace pass, 0 for a frame which isn't interlaced */
+    uint8_t                     mPass;
+
+    /*! The frame is interlaced */
+    bool                        mInterlaced;
+
+    /*! Next canvas column */
+    int16_t                     mX;
+
+    /*! Canvas rows showing the current row, one bit each */
+    uint32_t                    mRows;
+
+} ts_ws2812_gif_frame;
+
+
+/*! Refill the input buffer
+
+    \return false at the end of the source
+*/
+static bool ws2812_gif_fill(ts_ws2812_gif * pThis) {
+
+    if(pThis->mEnd) {
+        return false;
+    }
+
+    pThis->mInputLength   = pThis->mfRead(pThis->mUser, pThis->mInput, sizeof(pThis->mInput));
+    pThis->mInputPosition = 0;
+    pThis->mOffset       += pThis->mInputLength;
+
+    if(pThis->mInputLength == 0) {
+        pThis->mEnd = true;
+        return false;
+    }
+
+    return true;
+}
+
+
+/*! Read a byte, 0 at the end of the source */
+static inline uint8_t ws2812_gif_byte(ts_ws2812_gif * pThis) {
+
+    if(pThis->mInputPosition == pThis->mInputLength && !ws2812_gif_fill(pThis)) {
+        return 0;
+    }
+
+    return pThis->mInput[pThis->mInputPosition++];
+}
+
+
+/*! Read a little endian 16 bit value */
+static uint16_t ws2812_gif_word(ts_ws2812_gif * pThis) {
+
+    uint16_t lLow = ws2812_gif_byte(pThis);
+
+    return (uint16_t)(lLow | (ws2812_gif_byte(pThis) << 8));
+}
+
+
+/*! Skip bytes */
+static void ws2812_gif_skip(ts_ws2812_gif * pThis, size_t inCount) {
+
+    while(inCount > 0 && !pThis->mEnd) {
+
+        size_t lSkip = pThis->mInputLength - pThis->mInputPosition;
+
+        if(lSkip == 0) {
+            ws2812_gif_fill(pThis);
+            continue;
+        }
+
+        lSkip = (lSkip < inCount)? lSkip : inCount;
+
+        pThis->mInputPosition += lSkip;
+        inCount -= lSkip;
+    }
+}
+
+
+/*! Skip data sub-blocks up to and including the terminator */
+static void ws2812_gif_skip_blocks(ts_ws2812_gif * pThis) {
+
+    size_t lSize;
+
+    while((lSize = ws2812_gif_byte(pThis)) != 0) {
+        ws2812_gif_skip(pThis, lSize);
+    }
+}
+
+
+/*! Offset of the next byte in the GIF */
+static size_t ws2812_gif_position(const ts_ws2812_gif * pThis) {
+
+    return pThis->mOffset - (pThis->mInputLength - pThis->mInputPosition);
+}
+
+
+/*! Continue reading at an offset */
+static bool ws2812_gif_seek(ts_ws2812_gif * pThis, size_t inOffset) {
+
+    if(!pThis->mfSeek || !pThis->mfSeek(pThis->mUser, inOffset)) {
+        return false;
+    }
+
+    pThis->mOffset        = inOffset;
+    pThis->mInputPosition = 0;
+    pThis->mInputLength   = 0;
+    pThis->mEnd           = false;
+
+    return true;
+}
+
+
+/*! Read a color table, the indices above it are black */
+static void ws2812_gif_colors(ts_ws2812_gif * pThis, color * outColors, size_t inCount) {
+
+    size_t lCount;
+
+    for(lCount = 0; lCount < inCount; lCount++) {
+        outColors[lCount].R = ws2812_gif_byte(pThis);
+        outColors[lCount].G = ws2812_gif_byte(pThis);
+        outColors[lCount].B = ws2812_gif_byte(pThis);
+    }
+
+    memset(&outColors[inCount], 0, (256 - inCount) * sizeof(color));
+}
+
+
+/*! Screen column or row shown by every canvas column or row */
+static void ws2812_gif_samples(uint16_t * outSamples, int16_t inCanvas, uint16_t inScreen, te_ws2812_gif_fit inFit) {
+
+    int32_t lOffset = ((int32_t)inScreen - inCanvas) / 2;
+    int32_t lSample;
+    int16_t lCount;
+
+    for(lCount = 0; lCount < inCanvas; lCount++) {
+
+        if(inFit == WS2812_GIF_SCALE) {
+            /* the screen pixel under the center of the canvas pixel */
+            lSample = (int32_t)(((2u * lCount + 1u) * inScreen) / (2u * inCanvas));
+        } else {
+            lSample = lCount + lOffset;
+        }
+
+        outSamples[lCount] = (lSample >= 0 && lSample < inScreen)? (uint16_t)lSample : WS2812_GIF_NONE;
+    }
+}
+
+
+/*! Canvas columns or rows showing the screen columns or rows inFirst to inEnd (excluding) */
+static void ws2812_gif_range(const uint16_t * inSamples, int16_t inCount, uint32_t inFirst, uint32_t inEnd,
+                             int16_t * outFirst, int16_t * outEnd) {
+
+    int16_t lFirst = 0;
+    int16_t lEnd;
+
+    /* the samples increase, the ones without screen pixel are at the ends */
+    while(lFirst < inCount && (inSamples[lFirst] == WS2812_GIF_NONE || inSamples[lFirst] < inFirst)) {
+        lFirst++;
+    }
+
+    lEnd = lFirst;
+
+    while(lEnd < inCount && inSamples[lEnd] != WS2812_GIF_NONE && inSamples[lEnd] < inEnd) {
+        lEnd++;
+    }
+
+    *outFirst = lFirst;
+    *outEnd   = lEnd;
+}
+
+
+/*! Fill the canvas black */
+static void ws2812_gif_clear(const ts_ws2812_canvas * inCanvas, ts_ws2812_span * outDirty) {
+
+    int16_t lRow;
+
+    for(lRow = 0; lRow < inCanvas->mHeight; lRow++) {
+
+        memset(ws2812_canvas_pixel(inCanvas, 0, lRow), 0, (size_t)inCanvas->mWidth * sizeof(color));
+
+        if(outDirty) {
+            ws2812_span_add(&outDirty[lRow], 0, (size_t)inCanvas->mWidth);
+        }
+    }
+}
+
+
+/*! Dispose the last frame as it asked for */
+static void ws2812_gif_dispose(ts_ws2812_gif * pThis, const ts_ws2812_canvas * inCanvas, ts_ws2812_span * outDirty) {
+
+    int16_t lRow;
+
+    if(pThis->mLastDisposal != WS2812_GIF_DISPOSE_BACKGROUND && pThis->mLastDisposal != WS2812_GIF_DISPOSE_PREVIOUS) {
+        return;
+    }
+
+    for(lRow = pThis->mLastY; lRow < pThis->mLastY + pThis->mLastHeight; lRow++) {
+
+        color * lPixel = ws2812_canvas_pixel(inCanvas, pThis->mLastX, lRow);
+
+        /* the background is black, like the panel around the GIF */
+        if(pThis->mLastDisposal == WS2812_GIF_DISPOSE_BACKGROUND) {
+            memset(lPixel, 0, (size_t)pThis->mLastWidth * sizeof(color));
+        } else {
+            memcpy(lPixel, &pThis->mBackup[lRow * WS2812_NR_COLUMNS + pThis->mLastX], (size_t)pThis->mLastWidth * sizeof(color));
+        }
+
+        if(outDirty) {
+            ws2812_span_add(&outDirty[lRow], (size_t)pThis->mLastX, (size_t)(pThis->mLastX + pThis->mLastWidth));
+        }
+    }
+
+    pThis->mLastDisposal = 0;
+}
+
+
+/*! Find the canvas rows of the current frame row */
+static void ws2812_gif_row(const ts_ws2812_gif * pThis, ts_ws2812_gif_frame * pFrame) {
+
+    uint16_t lRow = (uint16_t)(pFrame->mTop + pFrame->mRow);
+    int16_t lCount;
+
+    pFrame->mRows   = 0;
+    pFrame->mColumn = 0;
+    pFrame->mX      = pFrame->mFirstX;
+
+    for(lCount = 0; lCount < pFrame->mCanvas->mHeight; lCount++) {
+        if(pThis->mSampleY[lCount] == lRow) {
+            pFrame->mRows |= 1u << lCount;
+        }
+    }
+}
+
+
+/*! Move to the next frame row, in the order of the interlace passes */
+static void ws2812_gif_next_row(const ts_ws2812_gif * pThis, ts_ws2812_gif_frame * pFrame) {
+
+    if(!pFrame->mInterlaced) {
+
+        pFrame->mRow++;
+
+    } else {
+
+        pFrame->mRow += sInterlaceStep[pFrame->mPass];
+
+        while(pFrame->mRow >= pFrame->mHeight && pFrame->mPass < 3) {
+            pFrame->mPass++;
+            pFrame->mRow = sInterlaceStart[pFrame->mPass];
+        }
+    }
+
+    if(pFrame->mRow < pFrame->mHeight) {
+        ws2812_gif_row(pThis, pFrame);
+    }
+}
+
+
+/*! Draw the next pixel of a frame
+
+    Only the canvas columns sampling this screen column are written, all
+    others only advance the position.
+*/
+static inline void ws2812_gif_pixel(const ts_ws2812_gif * pThis, ts_ws2812_gif_frame * pFrame, uint8_t inIndex) {
+
+    uint16_t lColumn;
+
+    /* more pixels than the frame has */
+    if(pFrame->mRow >= pFrame->mHeight) {
+        return;
+    }
+
+    if(pFrame->mRows) {
+
+        lColumn = (uint16_t)(pFrame->mLeft + pFrame->mColumn);
+
+        while(pFrame->mX < pFrame->mEndX && pThis->mSampleX[pFrame->mX] == lColumn) {
+
+            if(inIndex != pFrame->mTransparent) {
+
+                uint32_t lRows = pFrame->mRows;
+                int16_t lRow;
+
+                for(lRow = 0; lRows; lRow++, lRows >>= 1) {
+                    if(lRows & 1) {
+                        *ws2812_canvas_pixel(pFrame->mCanvas, pFrame->mX, lRow) = pFrame->mColors[inIndex];
+                    }
+                }
+            }
+
+            pFrame->mX++;
+        }
+    }
+
+    if(++pFrame->mColumn == pFrame->mWidth) {
+        ws2812_gif_next_row(pThis, pFrame);
+    }
+}
+
+
+/*! Decode the LZW data of a frame
+
+    \retval true    The data ended with the end code or the last sub-block
+    \retval false   The data is damaged
+*/
+static bool ws2812_gif_lzw(ts_ws2812_gif * pThis, ts_ws2812_gif_frame * pFrame) {
+
+    uint32_t lMinSize = ws2812_gif_byte(pThis);
+    uint32_t lClear;
+    uint32_t lNext;
+    uint32_t lSize;
+    uint32_t lBits  = 0;
+    uint32_t lCount = 0;
+    uint32_t lCode;
+    uint32_t lString;
+    int32_t  lOld   = -1;
+    uint8_t  lFirst = 0;
+    size_t   lStack;
+
+    if(lMinSize < 2 || lMinSize > 8) {
+        return false;
+    }
+
+    lClear = 1u << lMinSize;
+    lNext  = lClear + 2;
+    lSize  = lMinSize + 1;
+
+    pThis->mBlockLeft = 0;
+
+    for(;;) {
+
+        /* the codes are packed LSB first over the sub-blocks */
+        while(lCount < lSize) {
+
+            if(pThis->mBlockLeft == 0) {
+
+                pThis->mBlockLeft = ws2812_gif_byte(pThis);
+
+                /* the terminator came before the end code */
+                if(pThis->mBlockLeft == 0) {
+                    return !pThis->mEnd;
+                }
+            }
+
+            lBits |= (uint32_t)ws2812_gif_byte(pThis) << lCount;
+            lCount += 8;
+            pThis->mBlockLeft--;
+        }
+
+        lCode   = lBits & ((1u << lSize) - 1);
+        lBits >>= lSize;
+        lCount -= lSize;
+
+        if(lCode == lClear) {
+            lNext = lClear + 2;
+            lSize = lMinSize + 1;
+            lOld  = -1;
+            continue;
+        }
+
+        if(lCode == lClear + 1) {
+            break;
+        }
+
+        if(lOld < 0) {
+
+            if(lCode > lClear) {
+                return false;
+            }
+
+            lFirst = (uint8_t)lCode;
+            ws2812_gif_pixel(pThis, pFrame, lFirst);
+            lOld = (int32_t)lCode;
+            continue;
+        }
+
+        lStack  = 0;
+        lString = lCode;
+
+        /* the code being defined is the last string plus its first index */
+        if(lCode >= lNext) {
+
+            if(lCode > lNext) {
+                return false;
+            }
+
+            pThis->mStack[lStack++] = lFirst;
+            lString = (uint32_t)lOld;
+        }
+
+        while(lString >= lClear) {
+            pThis->mStack[lStack++] = pThis->mSuffix[lString];
+            lString = pThis->mPrefix[lString];
+        }
+
+        lFirst = (uint8_t)lString;
+        pThis->mStack[lStack++] = lFirst;
+
+        while(lStack > 0) {
+            ws2812_gif_pixel(pThis, pFrame, pThis->mStack[--lStack]);
+        }
+
+        /* a full table is kept until the next clear code */
+        if(lNext < WS2812_GIF_CODES) {
+
+            pThis->mPrefix[lNext] = (uint16_t)lOld;
+            pThis->mSuffix[lNext] = lFirst;
+            lNext++;
+
+            if(lNext == (1u << lSize) && lSize < WS2812_GIF_CODE_BITS) {
+                lSize++;
+            }
+        }
+
+        lOld = (int32_t)lCode;
+    }
+
+    ws2812_gif_skip(pThis, pThis->mBlockLeft);
+    ws2812_gif_skip_blocks(pThis);
+
+    return !pThis->mEnd;
+}
+
+
+/*! Read an image descriptor and draw the frame */
+static bool ws2812_gif_image(ts_ws2812_gif * pThis, const ts_ws2812_canvas * inCanvas, ts_ws2812_span * outDirty) {
+
+    ts_ws2812_gif_frame lFrame;
+    int16_t lFirstY;
+    int16_t lEndY;
+    int16_t lRow;
+    uint8_t lPacked;
+
+    lFrame.mCanvas      = inCanvas;
+    lFrame.mColors      = pThis->mGlobal;
+    lFrame.mTransparent = pThis->mTransparent;
+    lFrame.mLeft        = ws2812_gif_word(pThis);
+    lFrame.mTop         = ws2812_gif_word(pThis);
+    lFrame.mWidth       = ws2812_gif_word(pThis);
+    lFrame.mHeight      = ws2812_gif_word(pThis);
+    lPacked             = ws2812_gif_byte(pThis);
+    lFrame.mInterlaced  = (lPacked & 0x40) != 0;
+    lFrame.mPass        = 0;
+    lFrame.mRow         = 0;
+
+    if(lPacked & 0x80) {
+        ws2812_gif_colors(pThis, pThis->mLocal, 2u << (lPacked & 0x07));
+        lFrame.mColors = pThis->mLocal;
+    }
+
+    ws2812_gif_range(pThis->mSampleX, inCanvas->mWidth, lFrame.mLeft, (uint32_t)lFrame.mLeft + lFrame.mWidth,
+                     &lFrame.mFirstX, &lFrame.mEndX);
+    ws2812_gif_range(pThis->mSampleY, inCanvas->mHeight, lFrame.mTop, (uint32_t)lFrame.mTop + lFrame.mHeight,
+                     &lFirstY, &lEndY);
+
+    if(pThis->mDisposal == WS2812_GIF_DISPOSE_PREVIOUS) {
+        for(lRow = lFirstY; lRow < lEndY; lRow++) {
+            memcpy(&pThis->mBackup[lRow * WS2812_NR_COLUMNS + lFrame.mFirstX], ws2812_canvas_pixel(inCanvas, lFrame.mFirstX, lRow),
+                   (size_t)(lFrame.mEndX - lFrame.mFirstX) * sizeof(color));
+        }
+    }
+
+    if(lFrame.mWidth == 0 || lFrame.mHeight == 0) {
+
+        /* nothing to draw, only the code size and the sub-blocks */
+        lFrame.mRow = lFrame.mHeight;
+        ws2812_gif_byte(pThis);
+        ws2812_gif_skip_blocks(pThis);
+
+    } else {
+
+        ws2812_gif_row(pThis, &lFrame);
+
+        if(!ws2812_gif_lzw(pThis, &lFrame)) {
+            return false;
+        }
+    }
+
+    for(lRow = lFirstY; outDirty && lRow < lEndY; lRow++) {
+        ws2812_span_add(&outDirty[lRow], (size_t)lFrame.mFirstX, (size_t)lFrame.mEndX);
+    }
+
+    pThis->mLastDisposal = pThis->mDisposal;
+    pThis->mLastX        = lFrame.mFirstX;
+    pThis->mLastY        = lFirstY;
+    pThis->mLastWidth    = lFrame.mEndX - lFrame.mFirstX;
+    pThis->mLastHeight   = lEndY - lFirstY;
+
+    return true;
+}
+
+
+/*! Read a graphic control extension, other extensions are skipped */
+static void ws2812_gif_extension(ts_ws2812_gif * pThis) {
+
+    uint8_t lLabel = ws2812_gif_byte(pThis);
+    uint8_t lSize;
+    uint8_t lPacked;
+    uint8_t lTransparent;
+
+    if(lLabel == WS2812_GIF_GRAPHIC_CONTROL) {
+
+        lSize = ws2812_gif_byte(pThis);
+
+        if(lSize >= 4) {
+
+            lPacked             = ws2812_gif_byte(pThis);
+            pThis->mDelay       = ws2812_gif_word(pThis);
+            lTransparent        = ws2812_gif_byte(pThis);
+            pThis->mDisposal    = (lPacked >> 2) & 0x07;
+            pThis->mTransparent = (lPacked & 0x01)? lTransparent : -1;
+
+            lSize -= 4;
+        }
+
+        ws2812_gif_skip(pThis, lSize);
+    }
+
+    ws2812_gif_skip_blocks(pThis);
+}
+
+
+bool ws2812_gif_open(ts_ws2812_gif * pThis, f_ws2812_gif_read infRead, f_ws2812_gif_seek infSeek, void * pUser, te_ws2812_gif_fit inFit) {
+
+    uint8_t lSignature[6];
+    uint8_t lPacked;
+    size_t lCount;
+
+    pThis->mfRead         = infRead;
+    pThis->mfSeek         = infSeek;
+    pThis->mUser          = pUser;
+    pThis->mInputPosition = 0;
+    pThis->mInputLength   = 0;
+    pThis->mOffset        = 0;
+    pThis->mBlockLeft     = 0;
+    pThis->mEnd           = false;
+    pThis->mFrames        = 0;
+    pThis->mFit           = (inFit < WS2812_GIF_FIT_COUNT)? inFit : WS2812_GIF_SCALE;
+    pThis->mCanvasWidth   = -1;
+    pThis->mCanvasHeight  = -1;
+    pThis->mLastDisposal  = 0;
+    pThis->mDelay         = 0;
+    pThis->mTransparent   = -1;
+    pThis->mDisposal      = 0;
+
+    for(lCount = 0; lCount < sizeof(lSignature); lCount++) {
+        lSignature[lCount] = ws2812_gif_byte(pThis);
+    }
+
+    /* GIF87a or GIF89a */
+    if(memcmp(lSignature, "GIF", 3) != 0 || lSignature[5] != 'a') {
+        return false;
+    }
+
+    pThis->mWidth  = ws2812_gif_word(pThis);
+    pThis->mHeight = ws2812_gif_word(pThis);
+    lPacked        = ws2812_gif_byte(pThis);
+
+    /* background and aspect ratio, the background is black */
+    ws2812_gif_skip(pThis, 2);
+
+    pThis->mHasGlobal = (lPacked & 0x80) != 0;
+    ws2812_gif_colors(pThis, pThis->mGlobal, pThis->mHasGlobal? (2u << (lPacked & 0x07)) : 0);
+
+    pThis->mFirstBlock = ws2812_gif_position(pThis);
+
+    return !pThis->mEnd && pThis->mWidth > 0 && pThis->mHeight > 0;
+}
+
+
+bool ws2812_gif_next_frame(ts_ws2812_gif * pThis, const ts_ws2812_canvas * inCanvas, ts_ws2812_span * outDirty, uint32_t * outDelay) {
+
+    uint8_t lBlock;
+
+    if(inCanvas->mWidth > WS2812_NR_COLUMNS || inCanvas->mHeight > WS2812_NR_ROWS) {
+        return false;
+    }
+
+    if(inCanvas->mWidth != pThis->mCanvasWidth || inCanvas->mHeight != pThis->mCanvasHeight) {
+
+        ws2812_gif_samples(pThis->mSampleX, inCanvas->mWidth, pThis->mWidth, pThis->mFit);
+        ws2812_gif_samples(pThis->mSampleY, inCanvas->mHeight, pThis->mHeight, pThis->mFit);
+
+        pThis->mCanvasWidth  = inCanvas->mWidth;
+        pThis->mCanvasHeight = inCanvas->mHeight;
+    }
+
+    if(pThis->mFrames == 0) {
+        ws2812_gif_clear(inCanvas, outDirty);
+        pThis->mLastDisposal = 0;
+    }
+
+    ws2812_gif_dispose(pThis, inCanvas, outDirty);
+
+    for(;;) {
+
+        bool lEnd = false;
+
+        lBlock = ws2812_gif_byte(pThis);
+
+        if(lBlock == WS2812_GIF_EXTENSION && !pThis->mEnd) {
+
+            ws2812_gif_extension(pThis);
+
+        } else if(lBlock == WS2812_GIF_IMAGE && !pThis->mEnd) {
+
+            if(ws2812_gif_image(pThis, inCanvas, outDirty)) {
+
+                *outDelay = (pThis->mDelay > 1)? pThis->mDelay : WS2812_GIF_DEFAULT_DELAY;
+
+                /* the graphic control only applies to one frame */
+                pThis->mDelay       = 0;
+                pThis->mTransparent = -1;
+                pThis->mDisposal    = 0;
+                pThis->mFrames++;
+
+                return true;
+            }
+
+            lEnd = true;
+
+        } else {
+
+            /* the trailer, the end of the source or damaged data */
+            lEnd = true;
+        }
+
+        if(lEnd) {
+
+            /* start over, unless there was no frame since the last start */
+            if(pThis->mFrames == 0 || !ws2812_gif_seek(pThis, pThis->mFirstBlock)) {
+                return false;
+            }
+
+            pThis->mFrames       = 0;
+            pThis->mDelay        = 0;
+            pThis->mTransparent  = -1;
+            pThis->mDisposal     = 0;
+            pThis->mLastDisposal = 0;
+
+            ws2812_gif_clear(inCanvas, outDirty);
+        }
+    }
+}
+
+
+void ws2812_gif_memory_init(ts_ws2812_gif_memory * pThis, const uint8_t * inData, size_t inLength) {
+
+    pThis->mData     = inData;
+    pThis->mLength   = inLength;
+    pThis->mPosition = 0;
+}
+
+
+size_t ws2812_gif_memory_read(void * pUser, uint8_t * outData, size_t inLength) {
+
+    ts_ws2812_gif_memory * lMemory = (ts_ws2812_gif_memory*)pUser;
+    size_t lLeft = lMemory->mLength - lMemory->mPosition;
+
+    if(inLength > lLeft) {
+        inLength = lLeft;
+    }
+
+    memcpy(outData, &lMemory->mData[lMemory->mPosition], inLength);
+    lMemory->mPosition += inLength;
+
+    return inLength;
+}
+
+
+bool ws2812_gif_memory_seek(void * pUser, size_t inOffset) {
+
+    ts_ws2812_gif_memory * lMemory = (ts_ws2812_gif_memory*)pUser;
+
+    if(inOffset > lMemory->mLength) {
+        return false;
+    }
+
+    lMemory->mPosition = inOffset;
+
+    return true;
+}
+
+
+/* eof */
@@ -0,0 +1,122 @@
+#include "ws2812_particles.h"
+
+#include "mt_arithm.h"
+
+
+bool ws2812_particles_spawn(ts_ws2812_particles * pThis, int16_t inX, int16_t inY,
+                            int16_t inVelocityX, int16_t inVelocityY, uint8_t inLife, uint8_t inColor) {
+
+    size_t lIndex = pThis->mCount;
+
+    if(lIndex >= WS2812_PARTICLES_MAX || inLife == 0) {
+        return false;
+    }
+
+    pThis->mX[lIndex]         = inX;
+    pThis->mY[lIndex]         = inY;
+    pThis->mVelocityX[lIndex] = inVelocityX;
+    pThis->mVelocityY[lIndex] = inVelocityY;
+    pThis->mLife[lIndex]      = inLife;
+    pThis->mColor[lIndex]     = inColor;
+
+    pThis->mCount++;
+
+    return true;
+}
+
+
+/*! Replace a particle by the last one */
+static inline void ws2812_particles_remove(ts_ws2812_particles * pThis, size_t inIndex) {
+
+    size_t lLast = --pThis->mCount;
+
+    pThis->mX[inIndex]         = pThis->mX[lLast];
+    pThis->mY[inIndex]         = pThis->mY[lLast];
+    pThis->mVelocityX[inIndex] = pThis->mVelocityX[lLast];
+    pThis->mVelocityY[inIndex] = pThis->mVelocityY[lLast];
+    pThis->mLife[inIndex]      = pThis->mLife[lLast];
+    pThis->mColor[inIndex]     = pThis->mColor[lLast];
+}
+
+
+void ws2812_particles_step(ts_ws2812_particles * pThis, const ts_ws2812_particle_forces * inForces,
+                           int16_t inWidth, int16_t inHeight) {
+
+    int32_t lWidth  = (int32_t)inWidth << WS2812_PARTICLE_SHIFT;
+    int32_t lHeight = (int32_t)inHeight << WS2812_PARTICLE_SHIFT;
+    int32_t lVelocityX;
+    int32_t lVelocityY;
+    int32_t lX;
+    int32_t lY;
+    uint8_t lLife;
+    size_t lIndex = 0;
+
+    while(lIndex < pThis->mCount) {
+
+        lLife = sub8_f(pThis->mLife[lIndex], inForces->mDecay);
+
+        lVelocityX = pThis->mVelocityX[lIndex];
+        lVelocityY = pThis->mVelocityY[lIndex] + inForces->mGravity;
+
+        if(inForces->mDrag) {
+            lVelocityX -= lVelocityX >> inForces->mDrag;
+            lVelocityY -= lVelocityY >> inForces->mDrag;
+        }
+
+        lX = pThis->mX[lIndex] + lVelocityX;
+        lY = pThis->mY[lIndex] + lVelocityY;
+
+        if(lLife == 0 || lX < 0 || lX >= lWidth || lY >= lHeight || lY < INT16_MIN) {
+
+            /* the last particle moves here and is stepped next */
+            ws2812_particles_remove(pThis, lIndex);
+
+        } else {
+
+            pThis->mX[lIndex]         = (int16_t)lX;
+            pThis->mY[lIndex]         = (int16_t)lY;
+            pThis->mVelocityX[lIndex] = (int16_t)lVelocityX;
+            pThis->mVelocityY[lIndex] = (int16_t)lVelocityY;
+            pThis->mLife[lIndex]      = lLife;
+
+            lIndex++;
+        }
+    }
+}
+
+
+void ws2812_particles_render(const ts_ws2812_particles * pThis, const ts_ws2812_canvas * inCanvas, const color * inColors) {
+
+    const color * lColor;
+    color * lLed;
+    int16_t lX;
+    int16_t lY;
+    uint8_t lLife;
+    size_t lIndex;
+
+    for(lIndex = 0; lIndex < pThis->mCount; lIndex++) {
+
+        /* particles above the top are still alive */
+        if(pThis->mY[lIndex] < 0) {
+            continue;
+        }
+
+        lX = (int16_t)(pThis->mX[lIndex] >> WS2812_PARTICLE_SHIFT);
+        lY = (int16_t)(pThis->mY[lIndex] >> WS2812_PARTICLE_SHIFT);
+
+        if(lX >= inCanvas->mWidth || lY >= inCanvas->mHeight) {
+            continue;
+        }
+
+        lColor = &inColors[pThis->mColor[lIndex]];
+        lLife  = pThis->mLife[lIndex];
+        lLed   = ws2812_canvas_pixel(inCanvas, lX, lY);
+
+        lLed->R = add8_c(lLed->R, scale8(lColor->R, lLife));
+        lLed->G = add8_c(lLed->G, scale8(lColor->G, lLife));
+        lLed->B = add8_c(lLed->B, scale8(lColor->B, lLife));
+    }
+}
+
+
+/* eof */
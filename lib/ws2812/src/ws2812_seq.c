@@ -0,0 +1,348 @@
+#include <string.h>
+
+#include "ws2812_seq.h"
+
+
+/*! Read a little endian 16 bit number */
+static inline uint16_t ws2812_seq_u16(const uint8_t * inData) {
+
+    return (uint16_t)(inData[0] | (inData[1] << 8));
+}
+
+
+void ws2812_seq_init(ts_ws2812_seq * pThis, f_ws2812_seq_wake infWake, void * pWakeUser) {
+
+    pThis->mStream.mLength[0] = 0;
+    pThis->mStream.mLength[1] = 0;
+    pThis->mStream.mFill      = 0;
+    pThis->mStream.mRead      = 0;
+    pThis->mStream.mPosition  = 0;
+    pThis->mStream.mfWake     = infWake;
+    pThis->mStream.mWakeUser  = pWakeUser;
+
+    pThis->mWidth  = 0;
+    pThis->mHeight = 0;
+    pThis->mFrames = 0;
+    pThis->mFrame  = 0;
+}
+
+
+bool ws2812_seq_stream_fill(ts_ws2812_seq_stream * pThis, f_ws2812_seq_read infRead, f_ws2812_seq_rewind infRewind, void * pUser) {
+
+    uint8_t * lBlock = (uint8_t*)pThis->mBlock[pThis->mFill];
+    size_t lLength = 0;
+    size_t lRead;
+
+    if(!ws2812_seq_stream_free(pThis)) {
+        return true;
+    }
+
+    /* only the last block of the file is short, so a frame always fits in
+       the rest of one block and the next */
+    do {
+        lRead    = infRead(pUser, &lBlock[lLength], WS2812_SEQ_BLOCK - lLength);
+        lLength += lRead;
+    } while(lRead > 0 && lLength < WS2812_SEQ_BLOCK);
+
+    if(lLength == 0) {
+
+        if(!infRewind(pUser)) {
+            return false;
+        }
+
+        do {
+            lRead    = infRead(pUser, &lBlock[lLength], WS2812_SEQ_BLOCK - lLength);
+            lLength += lRead;
+        } while(lRead > 0 && lLength < WS2812_SEQ_BLOCK);
+
+        if(lLength == 0) {
+            return false;
+        }
+    }
+
+    /* the data has to be in place before the player sees the length */
+    __sync_synchronize();
+
+    pThis->mLength[pThis->mFill] = lLength;
+    pThis->mFill ^= 1;
+
+    return true;
+}
+
+
+/*! Bytes the player can read */
+static size_t ws2812_seq_available(const ts_ws2812_seq_stream * inStream) {
+
+    size_t lCurrent = inStream->mLength[inStream->mRead];
+    size_t lNext    = inStream->mLength[inStream->mRead ^ 1];
+
+    /* the data is read after the lengths */
+    __sync_synchronize();
+
+    if(lCurrent == 0) {
+        return 0;
+    }
+
+    return lCurrent - inStream->mPosition + lNext;
+}
+
+
+/*! Get the next bytes without reading them, copied to the scratch if they span both blocks */
+static const uint8_t * ws2812_seq_peek(ts_ws2812_seq * pThis, size_t inLength) {
+
+    ts_ws2812_seq_stream * lStream = &pThis->mStream;
+    const uint8_t * lCurrent = (const uint8_t*)lStream->mBlock[lStream->mRead];
+    size_t lLeft = lStream->mLength[lStream->mRead] - lStream->mPosition;
+
+    if(inLength <= lLeft) {
+        return &lCurrent[lStream->mPosition];
+    }
+
+    memcpy(pThis->mScratch, &lCurrent[lStream->mPosition], lLeft);
+    memcpy(&pThis->mScratch[lLeft], lStream->mBlock[lStream->mRead ^ 1], inLength - lLeft);
+
+    return pThis->mScratch;
+}
+
+
+/*! Read bytes and hand the blocks read to the end back to the loader */
+static void ws2812_seq_consume(ts_ws2812_seq_stream * pThis, size_t inLength) {
+
+    size_t lLength = pThis->mLength[pThis->mRead];
+
+    pThis->mPosition += inLength;
+
+    if(pThis->mPosition < lLength) {
+        return;
+    }
+
+    pThis->mPosition -= lLength;
+
+    /* done with the data before the loader may overwrite it */
+    __sync_synchronize();
+
+    pThis->mLength[pThis->mRead] = 0;
+    pThis->mRead ^= 1;
+
+    if(pThis->mfWake) {
+        pThis->mfWake(pThis->mWakeUser);
+    }
+}
+
+
+/*! Draw leds of one frame row, clipped to the canvas
+
+    \param[in]  inColors    inLength colors, or one color for all if inRun
+*/
+static void ws2812_seq_put(const ts_ws2812_canvas * inCanvas, ts_ws2812_span * outDirty, size_t inX, size_t inY, size_t inLength,
+                           const uint8_t * inColors, bool inRun) {
+
+    color * lPixel;
+
+    if(inY >= (size_t)inCanvas->mHeight || inX >= (size_t)inCanvas->mWidth) {
+        return;
+    }
+
+    if(inLength > (size_t)inCanvas->mWidth - inX) {
+        inLength = (size_t)inCanvas->mWidth - inX;
+    }
+
+    lPixel = ws2812_canvas_pixel(inCanvas, (int16_t)inX, (int16_t)inY);
+
+    if(inRun) {
+
+        color lColor;
+
+        color_unpack(&lColor, inColors, 1);
+        color_fill(lPixel, inLength, &lColor);
+
+    } else {
+        color_unpack(lPixel, inColors, inLength);
+    }
+
+    if(outDirty) {
+        ws2812_span_add(&outDirty[inY], inX, inX + inLength);
+    }
+}
+
+
+/*! Apply the operations of a frame */
+static bool ws2812_seq_decode(ts_ws2812_seq * pThis, const ts_ws2812_canvas * inCanvas, ts_ws2812_span * outDirty,
+                              const uint8_t * inData, size_t inLength) {
+
+    const uint8_t * lEnd = inData + inLength;
+    const uint8_t * lColors;
+    size_t lLeft = (size_t)pThis->mWidth * pThis->mHeight;
+    size_t lX = 0;
+    size_t lY = 0;
+    size_t lCount;
+    size_t lRow;
+    uint8_t lOp;
+
+    while(inData < lEnd) {
+
+        lOp     = *inData++;
+        lCount  = (size_t)(lOp & 0x3F) + 1;
+        lColors = inData;
+
+        switch(lOp & 0xC0) {
+            case WS2812_SEQ_OP_LONG_SKIP:
+                if(inData >= lEnd) {
+                    return false;
+                }
+                lCount = ((size_t)(lOp & 0x3F) << 8 | *inData++) + 1;
+                /* fall through */
+            case WS2812_SEQ_OP_SKIP:
+                if(lCount > lLeft) {
+                    return false;
+                }
+                lX += lCount;
+                lY += lX / pThis->mWidth;
+                lX %= pThis->mWidth;
+                lLeft -= lCount;
+                continue;
+            case WS2812_SEQ_OP_RUN:
+                if((size_t)(lEnd - inData) < 3) {
+                    return false;
+                }
+                inData += 3;
+                break;
+            default:
+                if((size_t)(lEnd - inData) < 3 * lCount) {
+                    return false;
+                }
+                inData += 3 * lCount;
+                break;
+        }
+
+        if(lCount > lLeft) {
+            return false;
+        }
+
+        lLeft -= lCount;
+
+        /* split at the row ends */
+        while(lCount > 0) {
+
+            lRow = pThis->mWidth - lX;
+            if(lRow > lCount) {
+                lRow = lCount;
+            }
+
+            ws2812_seq_put(inCanvas, outDirty, lX, lY, lRow, lColors, lOp < WS2812_SEQ_OP_LITERAL);
+
+            if(lOp >= WS2812_SEQ_OP_LITERAL) {
+                lColors += 3 * lRow;
+            }
+
+            lCount -= lRow;
+            lX     += lRow;
+
+            if(lX == pThis->mWidth) {
+                lX = 0;
+                lY++;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/*! Read the header and clear the canvas */
+static te_ws2812_seq_result ws2812_seq_start(ts_ws2812_seq * pThis, const ts_ws2812_canvas * inCanvas, ts_ws2812_span * outDirty) {
+
+    const uint8_t * lHeader;
+    int16_t lRow;
+
+    if(ws2812_seq_available(&pThis->mStream) < WS2812_SEQ_HEADER) {
+        return WS2812_SEQ_WAIT;
+    }
+
+    lHeader = ws2812_seq_peek(pThis, WS2812_SEQ_HEADER);
+
+    if(memcmp(lHeader, "WSQ1", 4) != 0) {
+        return WS2812_SEQ_ERROR;
+    }
+
+    pThis->mWidth  = ws2812_seq_u16(&lHeader[4]);
+    pThis->mHeight = ws2812_seq_u16(&lHeader[6]);
+    pThis->mFrames = ws2812_seq_u16(&lHeader[8]);
+    pThis->mFrame  = 0;
+
+    if(pThis->mWidth == 0 || pThis->mWidth > WS2812_NR_COLUMNS ||
+       pThis->mHeight == 0 || pThis->mHeight > WS2812_NR_ROWS || pThis->mFrames == 0) {
+        return WS2812_SEQ_ERROR;
+    }
+
+    ws2812_seq_consume(&pThis->mStream, WS2812_SEQ_HEADER);
+
+    for(lRow = 0; lRow < inCanvas->mHeight; lRow++) {
+
+        memset(ws2812_canvas_pixel(inCanvas, 0, lRow), 0, (size_t)inCanvas->mWidth * sizeof(color));
+
+        if(outDirty) {
+            ws2812_span_add(&outDirty[lRow], 0, (size_t)inCanvas->mWidth);
+        }
+    }
+
+    return WS2812_SEQ_FRAME;
+}
+
+
+te_ws2812_seq_result ws2812_seq_next_frame(ts_ws2812_seq * pThis, const ts_ws2812_canvas * inCanvas, ts_ws2812_span * outDirty, uint32_t * outDelay) {
+
+    te_ws2812_seq_result lResult;
+    const uint8_t * lFrame;
+    size_t lAvailable;
+    size_t lLength;
+
+    if(pThis->mFrame == pThis->mFrames) {
+
+        lResult = ws2812_seq_start(pThis, inCanvas, outDirty);
+
+        if(lResult != WS2812_SEQ_FRAME) {
+            return lResult;
+        }
+    }
+
+    lAvailable = ws2812_seq_available(&pThis->mStream);
+
+    if(lAvailable < WS2812_SEQ_FRAME_HEADER) {
+        return WS2812_SEQ_WAIT;
+    }
+
+    lFrame  = ws2812_seq_peek(pThis, WS2812_SEQ_FRAME_HEADER);
+    lLength = ws2812_seq_u16(&lFrame[2]);
+
+    if(lLength > WS2812_SEQ_FRAME_MAX - WS2812_SEQ_FRAME_HEADER) {
+        return WS2812_SEQ_ERROR;
+    }
+
+    if(lAvailable < WS2812_SEQ_FRAME_HEADER + lLength) {
+
+        /* a frame always fits into both blocks, the length is broken if it
+           does not with the next block loaded */
+        if(pThis->mStream.mLength[pThis->mStream.mRead ^ 1] != 0 &&
+           ws2812_seq_available(&pThis->mStream) < WS2812_SEQ_FRAME_HEADER + lLength) {
+            return WS2812_SEQ_ERROR;
+        }
+
+        return WS2812_SEQ_WAIT;
+    }
+
+    lFrame    = ws2812_seq_peek(pThis, WS2812_SEQ_FRAME_HEADER + lLength);
+    *outDelay = ws2812_seq_u16(&lFrame[0]);
+
+    if(!ws2812_seq_decode(pThis, inCanvas, outDirty, &lFrame[WS2812_SEQ_FRAME_HEADER], lLength)) {
+        return WS2812_SEQ_ERROR;
+    }
+
+    ws2812_seq_consume(&pThis->mStream, WS2812_SEQ_FRAME_HEADER + lLength);
+    pThis->mFrame++;
+
+    return WS2812_SEQ_FRAME;
+}
+
+
+/* eof */
@@ -0,0 +1,90 @@
+/* generated by tools/sprite_to_c, don't edit */
+
+#include "ws2812_sprite.h"
+
+
+/* heart.ppm */
+static const uint16_t sRows_heart[] = {
+    0, 5, 6, 7, 10,
+};
+
+static const uint8_t sRuns_heart[] = {
+    0x0f, 0x10, 0x0f, 0x10, 0x0f, 0x60, 0x60, 0x0f, 0x40, 0x0f, 0x1f, 0x20,
+    0x1f,
+};
+
+static const color sPalette_heart[] = {
+    { .R = 0xff, .G = 0x00, .B = 0x20 },
+};
+
+/* 7x5, 1 colors, 26 bytes of data, 105 bytes uncompressed */
+static const ts_ws2812_sprite sSprite_heart = {
+    .mWidth   = 7,
+    .mHeight  = 5,
+    .mFormat  = WS2812_SPRITE_RLE4,
+    .mPalette = sPalette_heart,
+    .mRows    = sRows_heart,
+    .mRuns    = sRuns_heart,
+};
+
+
+/* smiley.ppm */
+static const uint16_t sRows_smiley[] = {
+    0, 3, 8, 9, 12,
+};
+
+static const uint8_t sRuns_smiley[] = {
+    0x0f, 0x20, 0x0f, 0x00, 0x01, 0x00, 0x01, 0x00, 0x40, 0x00, 0x21, 0x00,
+    0x0f, 0x20, 0x0f,
+};
+
+static const color sPalette_smiley[] = {
+    { .R = 0xff, .G = 0xc8, .B = 0x00 },
+    { .R = 0x28, .G = 0x14, .B = 0x00 },
+};
+
+/* 5x5, 2 colors, 31 bytes of data, 75 bytes uncompressed */
+static const ts_ws2812_sprite sSprite_smiley = {
+    .mWidth   = 5,
+    .mHeight  = 5,
+    .mFormat  = WS2812_SPRITE_RLE4,
+    .mPalette = sPalette_smiley,
+    .mRows    = sRows_smiley,
+    .mRuns    = sRuns_smiley,
+};
+
+
+/* arrow.ppm */
+static const uint16_t sRows_arrow[] = {
+    0, 3, 6, 7, 10,
+};
+
+static const uint8_t sRuns_arrow[] = {
+    0x1f, 0x00, 0x1f, 0x2f, 0x00, 0x0f, 0x40, 0x2f, 0x00, 0x0f, 0x1f, 0x00,
+    0x1f,
+};
+
+static const color sPalette_arrow[] = {
+    { .R = 0x00, .G = 0xff, .B = 0x40 },
+};
+
+/* 5x5, 1 colors, 26 bytes of data, 75 bytes uncompressed */
+static const ts_ws2812_sprite sSprite_arrow = {
+    .mWidth   = 5,
+    .mHeight  = 5,
+    .mFormat  = WS2812_SPRITE_RLE4,
+    .mPalette = sPalette_arrow,
+    .mRows    = sRows_arrow,
+    .mRuns    = sRuns_arrow,
+};
+
+
+const ts_ws2812_sprite * const gWs2812Sprites[] = {
+    &sSprite_heart,
+    &sSprite_smiley,
+    &sSprite_arrow,
+};
+
+const size_t gWs2812SpriteCount = sizeof(gWs2812Sprites) / sizeof(gWs2812Sprites[0]);
+
+/* eof */
@@ -4,6 +4,7 @@
 
 #include "ws2812.h"
 #include "color.h"              // for color
+#include "color16.h"            // for color16_blend
 
 #include "ws2812_anim_p.h"      // for ws2812_transition_done
 #include "ws2812_anim_obj.h"    // for tu_ws2812_anim
@@ -12,45 +13,46 @@
 #include "ws2812_transition_fade.h"
 
 
-#define REGULARIZE_COLOR(x) ((uint8_t)((x > 255.0f)? 255 : ((x < 0.0f)? 0: x + 0.5f)))
+static void ws2812_trans_fade_update(tu_ws2812_trans * pThis, color * pAnimationOne, color * pAnimationTwo) {
 
+    uint8_t lAmount;
 
-static void ws2812_trans_fade_update(tu_ws2812_trans * pThis, color * pAnimationOne, color * pAnimationTwo) {
+    /* amount of the second animation, 255 at the end */
+    lAmount = (uint8_t)((++pThis->mFade.mElapsed * 255) / pThis->mFade.mDuration);
+
+    /* update all colors */
+    color_blend(pThis->mBase.mPanel, pAnimationOne, pAnimationTwo, WS2812_NR_ROWS * WS2812_NR_COLUMNS, lAmount);
 
-    size_t lColumnCount;
-    size_t lRowCount;
+    if(pThis->mFade.mElapsed >= pThis->mFade.mDuration) {
+        ws2812_transition_done();
+    }
+}
 
-    float lPercentage;
 
-    lPercentage = (float)(++pThis->mFade.mElapsed) / (float)pThis->mFade.mDuration;
 
-    /* update all colors */
-    for(lColumnCount = 0; lColumnCount < WS2812_NR_COLUMNS; lColumnCount++) {
-        for(lRowCount = 0; lRowCount < WS2812_NR_ROWS; lRowCount++) {
+static void ws2812_trans_fade_update16(tu_ws2812_trans * pThis, const color16 * inAnimationOne, const color16 * inAnimationTwo, color16 * outPanel) {
 
-            size_t lLedIndex = lRowCount * WS2812_NR_COLUMNS + lColumnCount;
+    uint32_t lAmount;
 
-            float r = ((1.0f - lPercentage) * pAnimationOne[lLedIndex].R + (lPercentage) * pAnimationTwo[lLedIndex].R);
-            float g = ((1.0f - lPercentage) * pAnimationOne[lLedIndex].G + (lPercentage) * pAnimationTwo[lLedIndex].G);
-            float b = ((1.0f - lPercentage) * pAnimationOne[lLedIndex].B + (lPercentage) * pAnimationTwo[lLedIndex].B);
+    /* amount of the second animation, 65536 at the end */
+    lAmount = (uint32_t)(((uint64_t)++pThis->mFade.mElapsed << 16) / pThis->mFade.mDuration);
 
-            pThis->mBase.mPanel[lLedIndex].R = REGULARIZE_COLOR(r);
-            pThis->mBase.mPanel[lLedIndex].G = REGULARIZE_COLOR(g);
-            pThis->mBase.mPanel[lLedIndex].B = REGULARIZE_COLOR(b);
-        }
+    if(lAmount > 65536) {
+        lAmount = 65536;
     }
 
+    color16_blend(outPanel, inAnimationOne, inAnimationTwo, WS2812_NR_ROWS * WS2812_NR_COLUMNS, lAmount);
+
     if(pThis->mFade.mElapsed >= pThis->mFade.mDuration) {
         ws2812_transition_done();
     }
 }
 
 
-
-
 void ws2812_trans_fade_init(tu_ws2812_trans * pThis, tu_ws2812_trans_param * pParam) {
 
-    pThis->mBase.mfUpdate = ws2812_trans_fade_update;
+    pThis->mBase.mfUpdate   = ws2812_trans_fade_update;
+    pThis->mBase.mfUpdate16 = ws2812_trans_fade_update16;
     pThis->mFade.mDuration = pParam->mFade.mDuration;
     pThis->mFade.mElapsed  = 0;
 
@@ -0,0 +1,343 @@
+#include <string.h>     // for memset
+
+#include "ws2812_vm.h"
+
+#include "color_hsv.h"
+#include "mt_trig.h"
+#include "mt_noise.h"
+
+
+/*! "WSVM" read as little endian word */
+#define WS2812_VM_MAGIC         (0x4D565357u)
+
+/*! Largest section in instructions, the END included */
+#define WS2812_VM_SECTION_MAX   ((WS2812_VM_PROGRAM_MAX - WS2812_VM_HEADER_SIZE) / sizeof(ts_ws2812_vm_instr))
+
+
+/*! Multiply two fixed point values */
+static inline int32_t ws2812_vm_mul(int32_t inA, int32_t inB) {
+
+    return (int32_t)(((int64_t)inA * inB) >> 16);
+}
+
+
+/*! Divide two fixed point values, saturated */
+static int32_t ws2812_vm_div(int32_t inA, int32_t inB) {
+
+    int64_t lResult;
+
+    if(inB == 0) {
+        return (inA < 0)? INT32_MIN : INT32_MAX;
+    }
+
+    lResult = ((int64_t)inA * WS2812_VM_ONE) / inB;
+
+    if(lResult > INT32_MAX) {
+        return INT32_MAX;
+    } else if(lResult < INT32_MIN) {
+        return INT32_MIN;
+    }
+
+    return (int32_t)lResult;
+}
+
+
+/*! Clamp a value to 0 - 1 */
+static inline int32_t ws2812_vm_sat(int32_t inValue) {
+
+    if(inValue < 0) {
+        return 0;
+    } else if(inValue > WS2812_VM_ONE) {
+        return WS2812_VM_ONE;
+    }
+
+    return inValue;
+}
+
+
+/*! Convert a value from 0 - 1 to 0 - 255 */
+static inline uint8_t ws2812_vm_byte(int32_t inValue) {
+
+    inValue = ws2812_vm_sat(inValue);
+
+    return (uint8_t)((inValue - (inValue >> 8)) >> 8);
+}
+
+
+/*! Noise coordinate, one lattice cell is 1.0 */
+static inline uint16_t ws2812_vm_noise_coord(int32_t inValue) {
+
+    return (uint16_t)(inValue >> 8);
+}
+
+
+/*! Run one section
+
+    The dispatch is threaded: each handler jumps to the handler of the next
+    instruction through the table, there is no central loop and no range
+    check. ws2812_vm_load() made sure of the opcodes and registers.
+*/
+static void ws2812_vm_exec(ts_ws2812_vm * pThis, const ts_ws2812_vm_instr * inCode, color * outPixel) {
+
+    static const void * const sDispatch[WS2812_VM_OP_COUNT] = {
+        [WS2812_VM_OP_END]      = &&op_end,
+        [WS2812_VM_OP_MOV]      = &&op_mov,
+        [WS2812_VM_OP_ADD]      = &&op_add,
+        [WS2812_VM_OP_SUB]      = &&op_sub,
+        [WS2812_VM_OP_MUL]      = &&op_mul,
+        [WS2812_VM_OP_DIV]      = &&op_div,
+        [WS2812_VM_OP_NEG]      = &&op_neg,
+        [WS2812_VM_OP_ABS]      = &&op_abs,
+        [WS2812_VM_OP_FLOOR]    = &&op_floor,
+        [WS2812_VM_OP_FRACT]    = &&op_fract,
+        [WS2812_VM_OP_MIN]      = &&op_min,
+        [WS2812_VM_OP_MAX]      = &&op_max,
+        [WS2812_VM_OP_SAT]      = &&op_sat,
+        [WS2812_VM_OP_STEP]     = &&op_step,
+        [WS2812_VM_OP_SIN]      = &&op_sin,
+        [WS2812_VM_OP_COS]      = &&op_cos,
+        [WS2812_VM_OP_NOISE2]   = &&op_noise2,
+        [WS2812_VM_OP_NOISE3]   = &&op_noise3,
+        [WS2812_VM_OP_MIX]      = &&op_mix,
+        [WS2812_VM_OP_OUT_RGB]  = &&op_out_rgb,
+        [WS2812_VM_OP_OUT_HSV]  = &&op_out_hsv,
+        [WS2812_VM_OP_OUT_PAL]  = &&op_out_pal,
+    };
+
+    int32_t * lR = pThis->mRegister;
+    const ts_ws2812_vm_instr * lIp = inCode;
+
+#define WS2812_VM_D         lR[lIp->mDst]
+#define WS2812_VM_A         lR[lIp->mA]
+#define WS2812_VM_B         lR[lIp->mB]
+#define WS2812_VM_NEXT()    lIp++; goto *sDispatch[lIp->mOp]
+
+    goto *sDispatch[lIp->mOp];
+
+op_mov:
+    WS2812_VM_D = WS2812_VM_A;
+    WS2812_VM_NEXT();
+
+op_add:
+    WS2812_VM_D = WS2812_VM_A + WS2812_VM_B;
+    WS2812_VM_NEXT();
+
+op_sub:
+    WS2812_VM_D = WS2812_VM_A - WS2812_VM_B;
+    WS2812_VM_NEXT();
+
+op_mul:
+    WS2812_VM_D = ws2812_vm_mul(WS2812_VM_A, WS2812_VM_B);
+    WS2812_VM_NEXT();
+
+op_div:
+    WS2812_VM_D = ws2812_vm_div(WS2812_VM_A, WS2812_VM_B);
+    WS2812_VM_NEXT();
+
+op_neg:
+    WS2812_VM_D = -WS2812_VM_A;
+    WS2812_VM_NEXT();
+
+op_abs:
+    WS2812_VM_D = (WS2812_VM_A < 0)? -WS2812_VM_A : WS2812_VM_A;
+    WS2812_VM_NEXT();
+
+op_floor:
+    WS2812_VM_D = WS2812_VM_A & ~(WS2812_VM_ONE - 1);
+    WS2812_VM_NEXT();
+
+op_fract:
+    WS2812_VM_D = WS2812_VM_A & (WS2812_VM_ONE - 1);
+    WS2812_VM_NEXT();
+
+op_min:
+    WS2812_VM_D = (WS2812_VM_A < WS2812_VM_B)? WS2812_VM_A : WS2812_VM_B;
+    WS2812_VM_NEXT();
+
+op_max:
+    WS2812_VM_D = (WS2812_VM_A > WS2812_VM_B)? WS2812_VM_A : WS2812_VM_B;
+    WS2812_VM_NEXT();
+
+op_sat:
+    WS2812_VM_D = ws2812_vm_sat(WS2812_VM_A);
+    WS2812_VM_NEXT();
+
+op_step:
+    WS2812_VM_D = (WS2812_VM_B >= WS2812_VM_A)? WS2812_VM_ONE : 0;
+    WS2812_VM_NEXT();
+
+op_sin:
+    /* the fraction is the angle, Q15 to 16.16 */
+    WS2812_VM_D = sin16((uint16_t)WS2812_VM_A) * 2;
+    WS2812_VM_NEXT();
+
+op_cos:
+    WS2812_VM_D = cos16((uint16_t)WS2812_VM_A) * 2;
+    WS2812_VM_NEXT();
+
+op_noise2:
+    WS2812_VM_D = noise8_2d(ws2812_vm_noise_coord(WS2812_VM_A), ws2812_vm_noise_coord(WS2812_VM_B)) << 8;
+    WS2812_VM_NEXT();
+
+op_noise3:
+    WS2812_VM_D = noise8_3d(ws2812_vm_noise_coord(WS2812_VM_A), ws2812_vm_noise_coord(WS2812_VM_B),
+                            ws2812_vm_noise_coord(WS2812_VM_D)) << 8;
+    WS2812_VM_NEXT();
+
+op_mix:
+    WS2812_VM_D = WS2812_VM_A + ws2812_vm_mul(WS2812_VM_B - WS2812_VM_A, WS2812_VM_D);
+    WS2812_VM_NEXT();
+
+op_out_rgb:
+    outPixel->R = ws2812_vm_byte(WS2812_VM_A);
+    outPixel->G = ws2812_vm_byte(WS2812_VM_B);
+    outPixel->B = ws2812_vm_byte(WS2812_VM_D);
+    WS2812_VM_NEXT();
+
+op_out_hsv: {
+        color_hsv lColor;
+
+        lColor.H = (uint8_t)(WS2812_VM_A >> 8);
+        lColor.S = ws2812_vm_byte(WS2812_VM_B);
+        lColor.V = ws2812_vm_byte(WS2812_VM_D);
+
+        color_hsv_to_rgb_rainbow(outPixel, &lColor);
+    }
+    WS2812_VM_NEXT();
+
+op_out_pal:
+    color_palette_get(pThis->mPalette, outPixel, (uint8_t)(WS2812_VM_A >> 8));
+    WS2812_VM_NEXT();
+
+op_end:
+    return;
+
+#undef WS2812_VM_D
+#undef WS2812_VM_A
+#undef WS2812_VM_B
+#undef WS2812_VM_NEXT
+}
+
+
+/*! Read a little endian 16 bit value */
+static inline uint16_t ws2812_vm_read16(const uint8_t * inData) {
+
+    return (uint16_t)(inData[0] | (inData[1] << 8));
+}
+
+
+/*! Check a section
+
+    \return true if all opcodes and registers are valid and only the last
+            instruction ends the section
+*/
+static bool ws2812_vm_check(const ts_ws2812_vm_instr * inCode, size_t inCount, bool inPixel) {
+
+    size_t lCount;
+
+    if(inCount == 0 || inCount > WS2812_VM_SECTION_MAX) {
+        return false;
+    }
+
+    for(lCount = 0; lCount < inCount; lCount++) {
+
+        const ts_ws2812_vm_instr * lInstr = &inCode[lCount];
+
+        if(lInstr->mOp >= WS2812_VM_OP_COUNT ||
+           (lInstr->mOp == WS2812_VM_OP_END) != (lCount == inCount - 1) ||
+           lInstr->mDst >= WS2812_VM_REGISTERS || lInstr->mA >= WS2812_VM_REGISTERS || lInstr->mB >= WS2812_VM_REGISTERS) {
+
+            return false;
+        }
+
+        /* outputs only make sense per pixel */
+        if(!inPixel && lInstr->mOp >= WS2812_VM_OP_OUT_RGB) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool ws2812_vm_load(ts_ws2812_vm * pThis, const uint32_t * inProgram, size_t inLength, const ts_color_palette_16 * inPalette) {
+
+    const uint8_t * lHeader = (const uint8_t*)inProgram;
+    size_t lConstants;
+    size_t lFrame;
+    size_t lRow;
+    size_t lPixel;
+    size_t lCount;
+    const ts_ws2812_vm_instr * lCode;
+
+    if(inLength < WS2812_VM_HEADER_SIZE || inLength > WS2812_VM_PROGRAM_MAX ||
+       inProgram[0] != WS2812_VM_MAGIC || lHeader[4] != WS2812_VM_VERSION) {
+        return false;
+    }
+
+    lConstants = lHeader[5];
+    lFrame     = ws2812_vm_read16(&lHeader[6]);
+    lRow       = ws2812_vm_read16(&lHeader[8]);
+    lPixel     = ws2812_vm_read16(&lHeader[10]);
+
+    if(WS2812_VM_REG_CONSTANTS + lConstants > WS2812_VM_REGISTERS ||
+       inLength != WS2812_VM_HEADER_SIZE + 4 * lConstants + sizeof(ts_ws2812_vm_instr) * (lFrame + lRow + lPixel)) {
+        return false;
+    }
+
+    lCode = (const ts_ws2812_vm_instr*)&inProgram[WS2812_VM_HEADER_SIZE / 4 + lConstants];
+
+    if(!ws2812_vm_check(lCode, lFrame, false) ||
+       !ws2812_vm_check(&lCode[lFrame], lRow, false) ||
+       !ws2812_vm_check(&lCode[lFrame + lRow], lPixel, true)) {
+        return false;
+    }
+
+    memset(pThis->mRegister, 0, sizeof(pThis->mRegister));
+
+    for(lCount = 0; lCount < lConstants; lCount++) {
+        pThis->mRegister[WS2812_VM_REG_CONSTANTS + lCount] = (int32_t)inProgram[WS2812_VM_HEADER_SIZE / 4 + lCount];
+    }
+
+    pThis->mFrame   = lCode;
+    pThis->mRow     = &lCode[lFrame];
+    pThis->mPixel   = &lCode[lFrame + lRow];
+    pThis->mPalette = inPalette;
+
+    return true;
+}
+
+
+void ws2812_vm_run(ts_ws2812_vm * pThis, color * outPanel, size_t inRows, size_t inColumns, size_t inStride, int32_t inTime) {
+
+    int32_t * lR = pThis->mRegister;
+    int32_t lStepX = (inColumns > 1)? WS2812_VM_ONE / (int32_t)(inColumns - 1) : 0;
+    int32_t lStepY = (inRows > 1)? WS2812_VM_ONE / (int32_t)(inRows - 1) : 0;
+    size_t lRow;
+    size_t lColumn;
+
+    lR[WS2812_VM_REG_T] = inTime;
+
+    ws2812_vm_exec(pThis, pThis->mFrame, NULL);
+
+    for(lRow = 0; lRow < inRows; lRow++) {
+
+        color * lPixel = &outPanel[lRow * inStride];
+
+        lR[WS2812_VM_REG_Y]   = (int32_t)lRow * lStepY;
+        lR[WS2812_VM_REG_ROW] = (int32_t)lRow * WS2812_VM_ONE;
+
+        ws2812_vm_exec(pThis, pThis->mRow, NULL);
+
+        for(lColumn = 0; lColumn < inColumns; lColumn++) {
+
+            lR[WS2812_VM_REG_X]      = (int32_t)lColumn * lStepX;
+            lR[WS2812_VM_REG_COLUMN] = (int32_t)lColumn * WS2812_VM_ONE;
+
+            ws2812_vm_exec(pThis, pThis->mPixel, &lPixel[lColumn]);
+        }
+    }
+}
+
+
+/* eof */
@@ -0,0 +1,570 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "ws2812_audio.h"
+
+#include "mt_fft.h"
+
+/*  Checks the audio analysis on the host and measures it
+
+    Usage: audio_bench [-v] [<file.wav>...]
+
+    Without files it checks the FFT against a DFT in double precision,
+    the bands of sine tones and the time from a kick drum to its beat, and
+    measures an analysis. WAV files of 16 bit PCM are fed like the USB
+    audio of the firmware, 1 ms per packet, and analyzed every 10 ms, -v
+    prints every analysis.
+*/
+
+
+/*! Sample rate of the USB audio */
+#define RATE                (48000)
+
+/*! Samples of the USB audio per packet */
+#define PACKET              (RATE / 1000)
+
+/*! Frames per second of the animations */
+#define FRAME_RATE          (100)
+
+/*! Time in us from the start of a frame until the leds show it: analysis
+    and rendering below 1 ms, sending 5.2 ms */
+#define FRAME_TO_LIGHT      (6200)
+
+/*! Analyses per timing */
+#define ANALYSES            (20000)
+
+
+static ts_ws2812_audio_ring sRing;
+static ts_ws2812_audio sAudio;
+static int16_t sBlock[WS2812_AUDIO_BLOCK];
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+/*! Time stamp counter, 0 if there is none */
+static uint64_t ticks(void) {
+
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+
+/*! Worst signal to noise ratio of the FFT against a DFT in double precision */
+static double check_fft(void) {
+
+    static int16_t lData[2 * MT_FFT_MAX];
+    static double lInput[2 * MT_FFT_MAX];
+    double lWorst = 1000.0;
+    double lSignal;
+    double lNoise;
+    double lReal;
+    double lImag;
+    double lAngle;
+    uint32_t lPoints;
+    uint32_t lRun;
+    uint32_t lBin;
+    uint32_t lIndex;
+
+    srand(1);
+
+    for(lPoints = 4; lPoints <= MT_FFT_MAX; lPoints *= 4) {
+        for(lRun = 0; lRun < 40; lRun++) {
+
+            /* random complex data, random real data, sines of random bins */
+            for(lIndex = 0; lIndex < lPoints; lIndex++) {
+
+                switch(lRun % 3) {
+                    case 0:
+                        lInput[2 * lIndex]     = rand() % 65535 - 32767;
+                        lInput[2 * lIndex + 1] = rand() % 65535 - 32767;
+                        break;
+                    case 1:
+                        lInput[2 * lIndex]     = rand() % 65535 - 32767;
+                        lInput[2 * lIndex + 1] = 0;
+                        break;
+                    default:
+                        lInput[2 * lIndex]     = round(32000.0 * sin(2.0 * M_PI * (lRun % lPoints) * lIndex / lPoints + 0.3));
+                        lInput[2 * lIndex + 1] = 0;
+                        break;
+                }
+
+                lData[2 * lIndex]     = (int16_t)lInput[2 * lIndex];
+                lData[2 * lIndex + 1] = (int16_t)lInput[2 * lIndex + 1];
+            }
+
+            mt_fft_q15(lData, lPoints);
+
+            lSignal = 0.0;
+            lNoise  = 0.0;
+
+            for(lBin = 0; lBin < lPoints; lBin++) {
+
+                lReal = 0.0;
+                lImag = 0.0;
+
+                for(lIndex = 0; lIndex < lPoints; lIndex++) {
+                    lAngle = -2.0 * M_PI * lBin * lIndex / lPoints;
+                    lReal += lInput[2 * lIndex] * cos(lAngle) - lInput[2 * lIndex + 1] * sin(lAngle);
+                    lImag += lInput[2 * lIndex] * sin(lAngle) + lInput[2 * lIndex + 1] * cos(lAngle);
+                }
+
+                lReal /= lPoints;
+                lImag /= lPoints;
+
+                lSignal += lReal * lReal + lImag * lImag;
+                lNoise  += (lReal - lData[2 * lBin]) * (lReal - lData[2 * lBin]) +
+                           (lImag - lData[2 * lBin + 1]) * (lImag - lData[2 * lBin + 1]);
+            }
+
+            if(lNoise > 0.0 && 10.0 * log10(lSignal / lNoise) < lWorst) {
+                lWorst = 10.0 * log10(lSignal / lNoise);
+            }
+        }
+    }
+
+    return lWorst;
+}
+
+
+/*! Analyze sine tones in the middle of every band
+
+    \return number of tones whose band isn't the loudest
+*/
+static uint32_t check_bands(void) {
+
+    static const double lBins[WS2812_AUDIO_BANDS] = {
+        1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 9.5, 13.0, 18.0, 24.5, 33.0, 45.0, 61.0, 82.5, 111.5
+    };
+    static int16_t lStereo[2 * WS2812_AUDIO_DECIMATE * WS2812_AUDIO_BLOCK];
+    double lFrequency;
+    uint32_t lWrong = 0;
+    uint32_t lWritten = 0;
+    size_t lBand;
+    size_t lLoudest;
+    size_t lCount;
+    int lDb;
+
+    printf("band  Hz      -6 dB  -26 dB  -46 dB\n");
+
+    for(lBand = 0; lBand < WS2812_AUDIO_BANDS; lBand++) {
+
+        lFrequency = lBins[lBand] * RATE / WS2812_AUDIO_DECIMATE / WS2812_AUDIO_BLOCK;
+
+        printf("%4u  %5.0f", (unsigned)lBand, lFrequency);
+
+        for(lDb = -6; lDb >= -46; lDb -= 20) {
+
+            for(lCount = 0; lCount < WS2812_AUDIO_DECIMATE * WS2812_AUDIO_BLOCK; lCount++) {
+                lStereo[2 * lCount]     = (int16_t)round(32767.0 * pow(10.0, lDb / 20.0) * sin(2.0 * M_PI * lFrequency * lCount / RATE));
+                lStereo[2 * lCount + 1] = lStereo[2 * lCount];
+            }
+
+            lWritten = 0;
+
+            ws2812_audio_ring_init(&sRing);
+            ws2812_audio_init(&sAudio);
+            ws2812_audio_ring_push(&sRing, lStereo, WS2812_AUDIO_DECIMATE * WS2812_AUDIO_BLOCK, 2);
+            ws2812_audio_ring_read(&sRing, sBlock, &lWritten);
+            ws2812_audio_analyze(&sAudio, sBlock);
+
+            lLoudest = 0;
+            for(lCount = 1; lCount < WS2812_AUDIO_BANDS; lCount++) {
+                if(sAudio.mBands[lCount] > sAudio.mBands[lLoudest]) {
+                    lLoudest = lCount;
+                }
+            }
+
+            lWrong += (lLoudest != lBand);
+
+            printf("  %3u%c  ", sAudio.mBands[lBand], (lLoudest == lBand)? ' ' : '!');
+        }
+
+        printf("\n");
+    }
+
+    printf("\n");
+
+    return lWrong;
+}
+
+
+/*! Sample of a kick drum
+
+    \param[in]  inTime      Time since the kick in s, negative before
+*/
+static int16_t kick(double inTime) {
+
+    if(inTime < 0.0 || inTime > 0.15) {
+        return 0;
+    }
+
+    /* a sine falling from 120 Hz to 50 Hz with a fast attack */
+    return (int16_t)round(16000.0 * exp(-inTime * 25.0) * sin(2.0 * M_PI * (50.0 * inTime + 70.0 * (1.0 - exp(-inTime * 30.0)) / 30.0)));
+}
+
+
+/*! Latency of the beat and the level from a kick drum to the leds
+
+    Packets arrive every ms, the animation analyzes the newest samples at
+    the start of every frame. The kicks start at random times relative to
+    the packets and frames.
+*/
+static void check_latency(void) {
+
+    static int16_t lPacket[2 * PACKET];
+    const uint32_t lKicks = 200;
+    const double lSpacing = 0.5;
+    uint32_t lKick;
+    uint32_t lPacketCount;
+    uint32_t lWritten = 0;
+    uint32_t lBeats = 0;
+    uint32_t lLevels = 0;
+    uint32_t lBeatAt = UINT32_MAX;
+    uint32_t lLevelAt = UINT32_MAX;
+    uint32_t lSample;
+    double lOnset[lKicks];
+    double lBeatSum = 0.0;
+    double lBeatMax = 0.0;
+    double lLevelSum = 0.0;
+    double lLevelMax = 0.0;
+    double lFrame;
+    double lTime;
+    double lNext;
+    uint32_t lIndex;
+    size_t lCount;
+
+    srand(2);
+
+    /* the onsets in us, not on the packets */
+    for(lKick = 0; lKick < lKicks; lKick++) {
+        lOnset[lKick] = (0.25 + lKick * lSpacing) * 1e6 + (rand() % 10000) * 1.0173;
+    }
+
+    ws2812_audio_ring_init(&sRing);
+    ws2812_audio_init(&sAudio);
+
+    /* frames start at a phase which doesn't repeat with the packets */
+    lFrame = 3333.0;
+    lKick  = 0;
+
+    for(lPacketCount = 0; lPacketCount * 1000.0 < (lKicks * lSpacing + 0.5) * 1e6; lPacketCount++) {
+
+        /* the packet arrives at the end of its ms */
+        lTime = (lPacketCount + 1) * 1000.0;
+
+        /* frames before the packet */
+        while(lFrame < lTime) {
+
+            ws2812_audio_analyze(&sAudio, ws2812_audio_ring_read(&sRing, sBlock, &lWritten)? sBlock : NULL);
+
+            /* the kick which was last started */
+            while(lKick + 1 < lKicks && lOnset[lKick + 1] <= lFrame) {
+                lKick++;
+            }
+
+            if(lOnset[lKick] <= lFrame) {
+
+                if(sAudio.mBeat && lBeatAt != lKick) {
+                    lBeatAt   = lKick;
+                    lBeats++;
+                    lBeatSum += lFrame - lOnset[lKick];
+                    lBeatMax  = (lFrame - lOnset[lKick] > lBeatMax)? lFrame - lOnset[lKick] : lBeatMax;
+                }
+
+                if(sAudio.mLevel >= 128 && lLevelAt != lKick) {
+                    lLevelAt   = lKick;
+                    lLevels++;
+                    lLevelSum += lFrame - lOnset[lKick];
+                    lLevelMax  = (lFrame - lOnset[lKick] > lLevelMax)? lFrame - lOnset[lKick] : lLevelMax;
+                }
+            }
+
+            lFrame += 1e6 / FRAME_RATE;
+        }
+
+        for(lCount = 0; lCount < PACKET; lCount++) {
+
+            lSample = lPacketCount * PACKET + (uint32_t)lCount;
+            lNext   = lSample * 1e6 / RATE;
+
+            /* the kick of this sample, the kicks don't overlap */
+            lIndex = 0;
+            while(lIndex + 1 < lKicks && lOnset[lIndex + 1] <= lNext) {
+                lIndex++;
+            }
+
+            lPacket[2 * lCount]     = kick((lNext - lOnset[lIndex]) / 1e6);
+            lPacket[2 * lCount + 1] = lPacket[2 * lCount];
+        }
+
+        ws2812_audio_ring_push(&sRing, lPacket, PACKET, 2);
+    }
+
+    printf("%u kicks, %u beats, %u levels over 128\n", (unsigned)lKicks, (unsigned)lBeats, (unsigned)lLevels);
+    printf("ms from the kick      mean  worst\n");
+    if(lBeats > 0) {
+        printf("beat analyzed        %5.1f  %5.1f\n", lBeatSum / lBeats / 1000.0, lBeatMax / 1000.0);
+        printf("beat on the leds     %5.1f  %5.1f\n", (lBeatSum / lBeats + FRAME_TO_LIGHT) / 1000.0, (lBeatMax + FRAME_TO_LIGHT) / 1000.0);
+    }
+    if(lLevels > 0) {
+        printf("level analyzed       %5.1f  %5.1f\n", lLevelSum / lLevels / 1000.0, lLevelMax / 1000.0);
+        printf("level on the leds    %5.1f  %5.1f\n", (lLevelSum / lLevels + FRAME_TO_LIGHT) / 1000.0, (lLevelMax + FRAME_TO_LIGHT) / 1000.0);
+    }
+    printf("\n");
+}
+
+
+/*! Time an analysis */
+static void measure(void) {
+
+    double lStart;
+    double lTime;
+    uint64_t lTicks;
+    uint32_t lCount;
+
+    for(lCount = 0; lCount < WS2812_AUDIO_BLOCK; lCount++) {
+        sBlock[lCount] = (int16_t)(rand() % 20001 - 10000);
+    }
+
+    ws2812_audio_init(&sAudio);
+
+    lStart = now();
+    lTicks = ticks();
+
+    for(lCount = 0; lCount < ANALYSES; lCount++) {
+        sBlock[lCount & (WS2812_AUDIO_BLOCK - 1)] ^= 1;
+        ws2812_audio_analyze(&sAudio, sBlock);
+    }
+
+    lTicks = ticks() - lTicks;
+    lTime  = now() - lStart;
+
+    printf("analysis of %u samples: %.0f ns", WS2812_AUDIO_BLOCK, lTime / ANALYSES);
+    if(lTicks > 0) {
+        printf(", %.0f TSC ticks", (double)lTicks / ANALYSES);
+    }
+    printf("\n");
+
+    lStart = now();
+    lTicks = ticks();
+
+    for(lCount = 0; lCount < ANALYSES; lCount++) {
+        sAudio.mFft[lCount & (2 * WS2812_AUDIO_BLOCK - 1)] = (int16_t)lCount;
+        mt_fft_q15(sAudio.mFft, WS2812_AUDIO_BLOCK);
+    }
+
+    lTicks = ticks() - lTicks;
+    lTime  = now() - lStart;
+
+    printf("FFT of %u points: %.0f ns", WS2812_AUDIO_BLOCK, lTime / ANALYSES);
+    if(lTicks > 0) {
+        printf(", %.0f TSC ticks", (double)lTicks / ANALYSES);
+    }
+    printf("\n");
+}
+
+
+/*! Read a little endian number */
+static uint32_t le(const uint8_t * inData, size_t inBytes) {
+
+    uint32_t lValue = 0;
+
+    while(inBytes-- > 0) {
+        lValue = (lValue << 8) | inData[inBytes];
+    }
+
+    return lValue;
+}
+
+
+/*! Feed a WAV file like the USB audio, print a line per second or per analysis */
+static int play(const char * inPath, int inVerbose) {
+
+    static const char lBars[] = " .:-=+*#%@";
+    FILE * lFile = fopen(inPath, "rb");
+    uint8_t lHeader[8];
+    uint8_t lFormat[16];
+    int16_t * lSamples = NULL;
+    uint32_t lSize;
+    uint32_t lChannels = 0;
+    uint32_t lRate = 0;
+    uint32_t lFrames = 0;
+    uint32_t lFrame;
+    uint32_t lPacket;
+    uint32_t lWritten = 0;
+    uint32_t lAnalyses = 0;
+    uint32_t lBand;
+    uint32_t lMaxLevel = 0;
+    double lNextFrame = 0.0;
+
+    if(!lFile) {
+        perror(inPath);
+        return -1;
+    }
+
+    if(fread(lHeader, 1, 8, lFile) != 8 || memcmp(lHeader, "RIFF", 4) != 0 ||
+       fread(lHeader, 1, 4, lFile) != 4 || memcmp(lHeader, "WAVE", 4) != 0) {
+        printf("%s: no WAV file\n", inPath);
+        fclose(lFile);
+        return -1;
+    }
+
+    /* chunks until the data */
+    while(fread(lHeader, 1, 8, lFile) == 8) {
+
+        lSize = le(&lHeader[4], 4);
+
+        if(memcmp(lHeader, "fmt ", 4) == 0 && lSize >= 16) {
+
+            if(fread(lFormat, 1, 16, lFile) != 16) {
+                break;
+            }
+
+            lChannels = le(&lFormat[2], 2);
+            lRate     = le(&lFormat[4], 4);
+
+            if(le(lFormat, 2) != 1 || le(&lFormat[14], 2) != 16 || lChannels == 0 || lRate < 1000) {
+                printf("%s: only 16 bit PCM\n", inPath);
+                fclose(lFile);
+                return -1;
+            }
+
+            fseek(lFile, (long)(lSize - 16 + (lSize & 1)), SEEK_CUR);
+
+        } else if(memcmp(lHeader, "data", 4) == 0 && lChannels > 0) {
+
+            lFrames  = lSize / (2 * lChannels);
+            lSamples = (int16_t*)malloc((size_t)lFrames * lChannels * sizeof(int16_t));
+
+            if(!lSamples) {
+                break;
+            }
+
+            /* the host is little endian as well */
+            lFrames = (uint32_t)(fread(lSamples, 2 * lChannels, lFrames, lFile));
+            break;
+
+        } else {
+            fseek(lFile, (long)(lSize + (lSize & 1)), SEEK_CUR);
+        }
+    }
+
+    fclose(lFile);
+
+    if(!lSamples) {
+        printf("%s: no samples\n", inPath);
+        return -1;
+    }
+
+    if(lRate != RATE) {
+        printf("%s: %u Hz instead of %u Hz, the band frequencies scale with it\n", inPath, (unsigned)lRate, RATE);
+    }
+
+    printf("%s: %u channels, %.1f s\n", inPath, (unsigned)lChannels, (double)lFrames / lRate);
+
+    ws2812_audio_ring_init(&sRing);
+    ws2812_audio_init(&sAudio);
+
+    for(lFrame = 0; lFrame < lFrames; lFrame += lPacket) {
+
+        lPacket = lRate / 1000;
+        if(lPacket > lFrames - lFrame) {
+            lPacket = lFrames - lFrame;
+        }
+
+        ws2812_audio_ring_push(&sRing, &lSamples[(size_t)lFrame * lChannels], lPacket, lChannels);
+
+        if(lFrame + lPacket < lNextFrame) {
+            continue;
+        }
+
+        lNextFrame += (double)lRate / FRAME_RATE;
+
+        ws2812_audio_analyze(&sAudio, ws2812_audio_ring_read(&sRing, sBlock, &lWritten)? sBlock : NULL);
+        lAnalyses++;
+
+        if(sAudio.mLevel > lMaxLevel) {
+            lMaxLevel = sAudio.mLevel;
+        }
+
+        if(inVerbose || lAnalyses % FRAME_RATE == 0) {
+
+            printf("%7.2f s  ", (double)(lFrame + lPacket) / lRate);
+
+            for(lBand = 0; lBand < WS2812_AUDIO_BANDS; lBand++) {
+                putchar(lBars[sAudio.mBands[lBand] * (sizeof(lBars) - 2) / 255]);
+            }
+
+            printf("  level %3u peak %3u bass %3u  %s beats %u\n", sAudio.mLevel, sAudio.mPeak, sAudio.mBass,
+                   sAudio.mBeat? "BEAT" : "    ", (unsigned)sAudio.mBeats);
+        }
+    }
+
+    printf("%u analyses, %u beats, %.0f per minute, highest level %u\n\n", (unsigned)lAnalyses, (unsigned)sAudio.mBeats,
+           sAudio.mBeats * 60.0 * lRate / (lFrames? lFrames : 1), (unsigned)lMaxLevel);
+
+    free(lSamples);
+
+    return 0;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    int lArg = 1;
+    int lVerbose = 0;
+    int lResult = 0;
+    double lSnr;
+    uint32_t lWrong;
+
+    if(argc > 1 && strcmp(argv[1], "-v") == 0) {
+        lVerbose = 1;
+        lArg++;
+    }
+
+    if(lArg < argc && argv[lArg][0] == '-') {
+        printf("Usage: %s [-v] [<file.wav>...]\n", argv[0]);
+        return -1;
+    }
+
+    if(lArg == argc) {
+
+        lSnr = check_fft();
+        printf("FFT against double precision DFT: worst SNR %.1f dB\n\n", lSnr);
+
+        lWrong = check_bands();
+
+        check_latency();
+        measure();
+
+        return (lSnr > 55.0 && lWrong == 0)? 0 : 1;
+    }
+
+    for(; lArg < argc; lArg++) {
+        lResult |= play(argv[lArg], lVerbose);
+    }
+
+    return lResult;
+}
+
+/* eof */
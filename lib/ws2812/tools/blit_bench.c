@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "color.h"
+#include "ws2812.h"
+#include "ws2812_blit.h"
+
+/*  Checks the blit service on the host and measures its overhead
+
+    Usage: blit_bench [<jobs>]
+
+    Built with -DWS2812_BLIT_CPU, the jobs are split and run the way the
+    firmware queues them to the DMA, but by the CPU. Random copies and
+    fills of any alignment and length are compared against memcpy() and
+    color_fill(), then a panel copy and fill is timed against both.
+*/
+
+
+/*! Leds of a panel */
+#define LEDS                (WS2812_NR_ROWS * WS2812_NR_COLUMNS)
+
+/*! Bytes of the test buffers, more than the items of one transfer */
+#define BYTES               (3 * 65536 + 1000)
+
+/*! Panels per timing */
+#define FRAMES              (20000)
+
+
+static uint8_t sSource[BYTES];
+static uint8_t sTarget[BYTES];
+static uint8_t sExpect[BYTES];
+static color sPanel[LEDS];
+static color sFrom[LEDS];
+static uint32_t sSeed = 1;
+
+
+static uint32_t next_random(void) {
+
+    sSeed = sSeed * 1664525u + 1013904223u;
+
+    return sSeed >> 8;
+}
+
+
+/*! Random length, mostly around the DMA threshold and a panel */
+static size_t random_length(size_t inMax) {
+
+    size_t lLength;
+
+    switch(next_random() % 4) {
+        case 0:  lLength = next_random() % (2 * WS2812_BLIT_MIN_DMA); break;
+        case 1:  lLength = next_random() % (LEDS * sizeof(color) + 8); break;
+        case 2:  lLength = next_random() % inMax; break;
+        default: lLength = inMax - next_random() % 16; break;
+    }
+
+    return (lLength > inMax)? inMax : lLength;
+}
+
+
+/*! Check one copy
+
+    \return number of wrong bytes
+*/
+static size_t check_copy(void) {
+
+    size_t lLength = random_length(BYTES - 8);
+    size_t lFrom = next_random() % (BYTES - lLength + 1);
+    size_t lTo = next_random() % (BYTES - lLength + 1);
+    size_t lWrong = 0;
+    size_t lCount;
+
+    memcpy(sExpect, sTarget, BYTES);
+    memcpy(&sExpect[lTo], &sSource[lFrom], lLength);
+
+    ws2812_blit_copy(&sTarget[lTo], &sSource[lFrom], lLength);
+    ws2812_blit_wait();
+
+    for(lCount = 0; lCount < BYTES; lCount++) {
+        lWrong += (sTarget[lCount] != sExpect[lCount]);
+    }
+
+    return lWrong;
+}
+
+
+/*! Check one fill, every other one in gray
+
+    \return number of wrong bytes
+*/
+static size_t check_fill(void) {
+
+    color * lTarget = (color*)sTarget;
+    color * lExpect = (color*)sExpect;
+    size_t lColors = BYTES / sizeof(color);
+    size_t lCount = random_length(lColors - 1);
+    size_t lFirst = next_random() % (lColors - lCount + 1);
+    size_t lWrong = 0;
+    size_t lIndex;
+    color lColor;
+
+    color_set_word(&lColor, next_random());
+
+    if(next_random() & 1) {
+        lColor.G = lColor.R;
+        lColor.B = lColor.R;
+    }
+
+    memcpy(sExpect, sTarget, BYTES);
+    for(lIndex = lFirst; lIndex < lFirst + lCount; lIndex++) {
+        lExpect[lIndex] = lColor;
+    }
+
+    ws2812_blit_fill(&lTarget[lFirst], &lColor, lCount);
+    ws2812_blit_wait();
+
+    /* the filler of XRGB doesn't count */
+    for(lIndex = 0; lIndex < lColors; lIndex++) {
+        lWrong += !color_equal(&lTarget[lIndex], &lExpect[lIndex]);
+    }
+
+    return lWrong;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    const color lGray = { .R = 0x40, .G = 0x40, .B = 0x40 };
+    const color lRed = { .R = 0xFF, .G = 0x10, .B = 0x00 };
+    uint32_t lJobs = 20000;
+    uint32_t lJob;
+    size_t lCount;
+    size_t lWrong = 0;
+    double lStart;
+    double lTime[6];
+
+    if(argc > 1) {
+        lJobs = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lJobs == 0) {
+        printf("Usage: %s [<jobs>]\n", argv[0]);
+        return -1;
+    }
+
+    for(lCount = 0; lCount < BYTES; lCount++) {
+        sSource[lCount] = (uint8_t)next_random();
+    }
+
+    ws2812_blit_init();
+
+    for(lJob = 0; lJob < lJobs; lJob++) {
+        lWrong += (lJob & 1)? check_fill() : check_copy();
+    }
+
+    printf("%u jobs, %lu wrong bytes\n\n", (unsigned)lJobs, (unsigned long)lWrong);
+
+    memcpy(sFrom, sSource, sizeof(sFrom));
+
+    lStart = now();
+    for(lJob = 0; lJob < FRAMES; lJob++) {
+        ws2812_blit_copy(sPanel, &sFrom[lJob & 1], sizeof(sPanel) - sizeof(color));
+        ws2812_blit_wait();
+    }
+    lTime[0] = now() - lStart;
+
+    lStart = now();
+    for(lJob = 0; lJob < FRAMES; lJob++) {
+        memcpy(sPanel, &sFrom[lJob & 1], sizeof(sPanel) - sizeof(color));
+    }
+    lTime[1] = now() - lStart;
+
+    lStart = now();
+    for(lJob = 0; lJob < FRAMES; lJob++) {
+        ws2812_blit_fill(sPanel, &lGray, LEDS);
+        ws2812_blit_wait();
+    }
+    lTime[2] = now() - lStart;
+
+    lStart = now();
+    for(lJob = 0; lJob < FRAMES; lJob++) {
+        color_fill(sPanel, LEDS, &lGray);
+    }
+    lTime[3] = now() - lStart;
+
+    lStart = now();
+    for(lJob = 0; lJob < FRAMES; lJob++) {
+        ws2812_blit_fill(sPanel, &lRed, LEDS);
+        ws2812_blit_wait();
+    }
+    lTime[4] = now() - lStart;
+
+    lStart = now();
+    for(lJob = 0; lJob < FRAMES; lJob++) {
+        color_fill(sPanel, LEDS, &lRed);
+    }
+    lTime[5] = now() - lStart;
+
+    printf("ns per panel   blit  direct\n");
+    printf("copy         %6.0f  %6.0f\n", lTime[0] / FRAMES, lTime[1] / FRAMES);
+    printf("fill gray    %6.0f  %6.0f\n", lTime[2] / FRAMES, lTime[3] / FRAMES);
+    printf("fill color   %6.0f  %6.0f\n", lTime[4] / FRAMES, lTime[5] / FRAMES);
+
+    return (lWrong == 0)? 0 : 1;
+}
+
+/* eof */
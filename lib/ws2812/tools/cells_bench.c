@@ -0,0 +1,473 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ws2812.h"
+#include "ws2812_cells.h"
+
+/*  Checks the cellular automata and measures their generations per second
+
+    Usage: cells_bench [<generations>]
+
+    Life and sand on bit packed rows are compared with a reference that
+    keeps one byte per cell, for random fields of the full 5 x 172 grid and
+    of narrower ones, generation by generation. A blinker has to oscillate
+    and sand must neither lose grains nor lift them. The stencil is
+    compared with a direct sum for random weights, sizes and strides, the
+    cells beyond the columns have to stay untouched. The timing runs
+    <generations> generations on the 5 x 172 grid, the best of five runs,
+    next to the byte per cell reference of Life.
+*/
+
+
+/*! Rows and columns of the grid */
+#define ROWS                (WS2812_NR_ROWS)
+#define COLUMNS             (WS2812_NR_COLUMNS)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+/*! Random fields and generations of each per check */
+#define FIELDS              (200)
+#define FIELD_GENERATIONS   (50)
+
+/*! Largest stride of the stencil check */
+#define STENCIL_STRIDE      (COLUMNS + 8)
+
+
+static ts_ws2812_cells_row sRows[ROWS];
+static ts_ws2812_cells_row sNext[ROWS];
+
+static uint8_t sCells[ROWS][COLUMNS];
+static uint8_t sCellsNext[ROWS][COLUMNS];
+
+static uint8_t sLevels[ROWS * STENCIL_STRIDE];
+static uint8_t sLevelsOut[ROWS * STENCIL_STRIDE];
+static uint8_t sLevelsReference[ROWS * STENCIL_STRIDE];
+
+static uint32_t sSeed = 1;
+
+
+static uint32_t random_next(void) {
+
+    sSeed = sSeed * 1664525u + 1013904223u;
+
+    return sSeed >> 8;
+}
+
+
+/*! Random field in both forms, every cell set with inPercent % */
+static void random_field(size_t inColumns, uint32_t inPercent) {
+
+    size_t lRow;
+    size_t lColumn;
+
+    memset(sRows, 0, sizeof(sRows));
+    memset(sCells, 0, sizeof(sCells));
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        for(lColumn = 0; lColumn < inColumns; lColumn++) {
+
+            if(random_next() % 100 < inPercent) {
+                ws2812_cells_set(sRows, lRow, lColumn);
+                sCells[lRow][lColumn] = 1;
+            }
+        }
+    }
+}
+
+
+/*! Both forms have to hold the same cells, nothing beyond the columns */
+static int same_field(size_t inColumns) {
+
+    size_t lRow;
+    size_t lColumn;
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        for(lColumn = 0; lColumn < WS2812_CELLS_WORDS * 32; lColumn++) {
+
+            if(ws2812_cells_get(sRows, lRow, lColumn) != (lColumn < inColumns && sCells[lRow][lColumn])) {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+
+/*! Life with one byte per cell, the rows wrap, the sides are dead */
+static void reference_life(size_t inColumns) {
+
+    size_t lRow;
+    size_t lColumn;
+    size_t lNeighbours;
+    int lDy;
+    int lDx;
+    size_t lY;
+    int32_t lX;
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        for(lColumn = 0; lColumn < inColumns; lColumn++) {
+
+            lNeighbours = 0;
+
+            for(lDy = -1; lDy <= 1; lDy++) {
+                for(lDx = -1; lDx <= 1; lDx++) {
+
+                    lY = (lRow + ROWS + lDy) % ROWS;
+                    lX = (int32_t)lColumn + lDx;
+
+                    if((lDy != 0 || lDx != 0) && lX >= 0 && lX < (int32_t)inColumns) {
+                        lNeighbours += sCells[lY][lX];
+                    }
+                }
+            }
+
+            sCellsNext[lRow][lColumn] = (lNeighbours == 3 || (lNeighbours == 2 && sCells[lRow][lColumn]));
+        }
+    }
+
+    memcpy(sCells, sCellsNext, sizeof(sCells));
+}
+
+
+/*! Let the grains of a row slide to one side, all of them at once */
+static void reference_sand_slide(size_t inRow, size_t inColumns, int inLeft) {
+
+    uint8_t lMoving[COLUMNS];
+    size_t lColumn;
+    size_t lTarget;
+
+    for(lColumn = 0; lColumn < inColumns; lColumn++) {
+
+        lTarget = inLeft ? lColumn - 1 : lColumn + 1;
+
+        lMoving[lColumn] = sCells[inRow][lColumn] && sCells[inRow + 1][lColumn] &&
+                           (inLeft ? lColumn > 0 : lColumn + 1 < inColumns) && !sCells[inRow + 1][lTarget];
+    }
+
+    for(lColumn = 0; lColumn < inColumns; lColumn++) {
+
+        if(lMoving[lColumn]) {
+            sCells[inRow][lColumn] = 0;
+            sCells[inRow + 1][inLeft ? lColumn - 1 : lColumn + 1] = 1;
+        }
+    }
+}
+
+
+/*! Sand with one byte per cell, from the bottom up: fall, then slide to both sides */
+static void reference_sand(size_t inColumns, int inLeftFirst) {
+
+    size_t lRow;
+    size_t lColumn;
+
+    for(lRow = ROWS - 1; lRow-- > 0; ) {
+
+        for(lColumn = 0; lColumn < inColumns; lColumn++) {
+
+            if(sCells[lRow][lColumn] && !sCells[lRow + 1][lColumn]) {
+                sCells[lRow][lColumn] = 0;
+                sCells[lRow + 1][lColumn] = 1;
+            }
+        }
+
+        reference_sand_slide(lRow, inColumns, inLeftFirst);
+        reference_sand_slide(lRow, inColumns, !inLeftFirst);
+    }
+}
+
+
+static int check_life(void) {
+
+    static const size_t lWidths[] = { COLUMNS, 100, 64, 33, 3 };
+    size_t lWidth;
+    uint32_t lField;
+    uint32_t lGeneration;
+
+    for(lField = 0; lField < FIELDS; lField++) {
+
+        lWidth = lWidths[lField % (sizeof(lWidths) / sizeof(lWidths[0]))];
+        random_field(lWidth, 20 + lField % 40);
+
+        for(lGeneration = 0; lGeneration < FIELD_GENERATIONS; lGeneration++) {
+
+            ws2812_cells_life(sNext, sRows, ROWS, lWidth);
+            memcpy(sRows, sNext, sizeof(sRows));
+            reference_life(lWidth);
+
+            if(!same_field(lWidth)) {
+                printf("FAIL life field %u of %u columns, generation %u\n", (unsigned)lField, (unsigned)lWidth, (unsigned)lGeneration);
+                return 1;
+            }
+        }
+    }
+
+    /* a blinker across the word border at column 32 */
+    memset(sRows, 0, sizeof(sRows));
+    ws2812_cells_set(sRows, 2, 31);
+    ws2812_cells_set(sRows, 2, 32);
+    ws2812_cells_set(sRows, 2, 33);
+
+    ws2812_cells_life(sNext, sRows, ROWS, COLUMNS);
+
+    if(ws2812_cells_count(sNext, ROWS) != 3 || !ws2812_cells_get(sNext, 1, 32) ||
+       !ws2812_cells_get(sNext, 2, 32) || !ws2812_cells_get(sNext, 3, 32)) {
+        printf("FAIL life blinker\n");
+        return 1;
+    }
+
+    ws2812_cells_life(sRows, sNext, ROWS, COLUMNS);
+
+    if(ws2812_cells_count(sRows, ROWS) != 3 || !ws2812_cells_get(sRows, 2, 31) ||
+       !ws2812_cells_get(sRows, 2, 32) || !ws2812_cells_get(sRows, 2, 33)) {
+        printf("FAIL life blinker\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+
+static int check_sand(void) {
+
+    static const size_t lWidths[] = { COLUMNS, 100, 64, 33, 2 };
+    size_t lWidth;
+    size_t lGrains;
+    size_t lRow;
+    size_t lLowest;
+    size_t lLowestBefore = 0;
+    uint32_t lField;
+    uint32_t lGeneration;
+
+    for(lField = 0; lField < FIELDS; lField++) {
+
+        lWidth = lWidths[lField % (sizeof(lWidths) / sizeof(lWidths[0]))];
+        random_field(lWidth, 10 + lField % 60);
+        lGrains = ws2812_cells_count(sRows, ROWS);
+
+        for(lGeneration = 0; lGeneration < FIELD_GENERATIONS; lGeneration++) {
+
+            /* grains in the bottom rows, never less than before */
+            for(lRow = ROWS, lLowest = 0; lRow-- > 0 && lRow + 2 >= ROWS; ) {
+                lLowest += ws2812_cells_count(&sRows[lRow], 1);
+            }
+
+            if(lGeneration > 0 && lLowest < lLowestBefore) {
+                printf("FAIL sand field %u lifts grains\n", (unsigned)lField);
+                return 1;
+            }
+
+            lLowestBefore = lLowest;
+
+            ws2812_cells_sand(sRows, ROWS, lWidth, lGeneration & 1);
+            reference_sand(lWidth, lGeneration & 1);
+
+            if(!same_field(lWidth)) {
+                printf("FAIL sand field %u of %u columns, generation %u\n", (unsigned)lField, (unsigned)lWidth, (unsigned)lGeneration);
+                return 1;
+            }
+
+            if(ws2812_cells_count(sRows, ROWS) != lGrains) {
+                printf("FAIL sand field %u loses grains\n", (unsigned)lField);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+static int check_stencil(void) {
+
+    ts_ws2812_stencil lStencil;
+    size_t lRows;
+    size_t lColumns;
+    size_t lStride;
+    size_t lRow;
+    size_t lColumn;
+    size_t lY;
+    size_t lX;
+    uint32_t lSum;
+    uint32_t lField;
+    int lDy;
+    int lDx;
+
+    for(lField = 0; lField < FIELDS * 10; lField++) {
+
+        lRows    = 1 + random_next() % ROWS;
+        lColumns = 1 + random_next() % COLUMNS;
+        lStride  = lColumns + random_next() % (STENCIL_STRIDE - lColumns + 1);
+
+        for(lY = 0; lY < 3; lY++) {
+            for(lX = 0; lX < 3; lX++) {
+                lStencil.mWeight[lY][lX] = (uint8_t)random_next();
+            }
+        }
+
+        lStencil.mShift = (uint8_t)(random_next() % 12);
+
+        for(lX = 0; lX < sizeof(sLevels); lX++) {
+            sLevels[lX] = (uint8_t)random_next();
+        }
+
+        memset(sLevelsOut, 0xA5, sizeof(sLevelsOut));
+        memset(sLevelsReference, 0xA5, sizeof(sLevelsReference));
+
+        for(lRow = 0; lRow < lRows; lRow++) {
+            for(lColumn = 0; lColumn < lColumns; lColumn++) {
+
+                lSum = 0;
+
+                for(lDy = -1; lDy <= 1; lDy++) {
+                    for(lDx = -1; lDx <= 1; lDx++) {
+
+                        /* the border cells repeat */
+                        lY = (lRow == 0 && lDy < 0)? 0 : (lRow + 1 == lRows && lDy > 0)? lRow : lRow + lDy;
+                        lX = (lColumn == 0 && lDx < 0)? 0 : (lColumn + 1 == lColumns && lDx > 0)? lColumn : lColumn + lDx;
+
+                        lSum += (uint32_t)lStencil.mWeight[lDy + 1][lDx + 1] * sLevels[lY * lStride + lX];
+                    }
+                }
+
+                lSum >>= lStencil.mShift;
+                sLevelsReference[lRow * lStride + lColumn] = (uint8_t)((lSum > 255)? 255 : lSum);
+            }
+        }
+
+        ws2812_cells_stencil(sLevelsOut, sLevels, lRows, lColumns, lStride, &lStencil);
+
+        if(memcmp(sLevelsOut, sLevelsReference, sizeof(sLevelsOut)) != 0) {
+            printf("FAIL stencil %u x %u, stride %u\n", (unsigned)lRows, (unsigned)lColumns, (unsigned)lStride);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+static void run_life(uint32_t inGeneration) {
+
+    (void)inGeneration;
+
+    ws2812_cells_life(sNext, sRows, ROWS, COLUMNS);
+    memcpy(sRows, sNext, sizeof(sRows));
+}
+
+
+static void run_life_bytes(uint32_t inGeneration) {
+
+    (void)inGeneration;
+
+    reference_life(COLUMNS);
+}
+
+
+static void run_sand(uint32_t inGeneration) {
+
+    ws2812_cells_sand(sRows, ROWS, COLUMNS, inGeneration & 1);
+
+    /* a new grain on top keeps it moving */
+    ws2812_cells_set(sRows, 0, (inGeneration * 37) % COLUMNS);
+}
+
+
+static void run_stencil(uint32_t inGeneration) {
+
+    static const ts_ws2812_stencil lBlur = { { { 1, 2, 1 }, { 2, 4, 2 }, { 1, 2, 1 } }, 4 };
+
+    ws2812_cells_stencil(sLevelsOut, sLevels, ROWS, COLUMNS, COLUMNS, &lBlur);
+    sLevels[inGeneration % (ROWS * COLUMNS)] = 255;
+    memcpy(sLevels, sLevelsOut, ROWS * COLUMNS);
+}
+
+
+/*! Best rate in generations per second */
+static double measure(void (* infRun)(uint32_t), uint32_t inGenerations) {
+
+    uint32_t lGeneration;
+    uint32_t lSum = 0;
+    int lRun;
+    double lStart;
+    double lRate;
+    double lBest = 0.0;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        sSeed = 1;
+        random_field(COLUMNS, 35);
+
+        lStart = now();
+
+        for(lGeneration = 0; lGeneration < inGenerations; lGeneration++) {
+            infRun(lGeneration);
+            lSum += sRows[lGeneration % ROWS][0] + sCells[lGeneration % ROWS][0] + sLevels[lGeneration % COLUMNS];
+        }
+
+        lRate = inGenerations * 1e9 / (now() - lStart);
+
+        if(lRate > lBest) {
+            lBest = lRate;
+        }
+    }
+
+    /* the fields have to be used */
+    if(lSum == 0xFFFFFFFF) {
+        printf("\n");
+    }
+
+    return lBest;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    uint32_t lGenerations = 200000;
+    int lErrors = 0;
+
+    if(argc > 1) {
+        lGenerations = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lGenerations == 0) {
+        printf("Usage: %s [<generations>]\n", argv[0]);
+        return -1;
+    }
+
+    lErrors += check_life();
+    printf("life against one byte per cell       %s\n", lErrors ? "FAIL" : "ok");
+
+    lErrors += check_sand();
+    printf("sand against one byte per cell       %s\n", lErrors ? "FAIL" : "ok");
+
+    lErrors += check_stencil();
+    printf("stencil against a direct sum         %s\n\n", lErrors ? "FAIL" : "ok");
+
+    printf("Generations per second on %d x %d\n", ROWS, COLUMNS);
+    printf("  life                   %12.0f\n", measure(run_life, lGenerations));
+    printf("  life, byte per cell    %12.0f\n", measure(run_life_bytes, lGenerations));
+    printf("  sand                   %12.0f\n", measure(run_sand, lGenerations));
+    printf("  stencil                %12.0f\n", measure(run_stencil, lGenerations));
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
@@ -0,0 +1,564 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "color.h"
+#include "ws2812.h"
+#include "ws2812_draw.h"
+#include "ws2812_sprite.h"
+
+/*  Checks the drawing primitives and measures them
+
+    Usage: draw_bench [<calls>]
+
+    Every primitive is drawn with random positions around a 5 x 172 panel,
+    once clipped by the panel and once on a larger plane where it fits
+    completely. Within the panel both have to be the same and nothing
+    outside of it may be written. Lines are compared with the rounding
+    of the reference step, circles with their distance to the center and
+    the sprites with a per pixel copy. The timing is the best of five runs
+    of <calls> calls per primitive, next to a per pixel loop with a bounds
+    check like ws2812_setLED(). The sprites of src/ws2812_sprites.c are
+    checked against a decoder of their runs.
+*/
+
+
+/*! Size of the plane the panel is placed on */
+#define PLANE_WIDTH         (320)
+#define PLANE_HEIGHT        (64)
+
+/*! Top left pixel of the panel on the plane */
+#define PANEL_X             (60)
+#define PANEL_Y             (24)
+
+/*! Random shapes per primitive */
+#define SHAPES              (20000)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+
+/*! A primitive drawn with random parameters */
+typedef struct {
+    const char    * mName;
+    void         (* mfDraw)(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const int16_t * inParam);
+} ts_primitive;
+
+
+static color sPlane[PLANE_WIDTH * PLANE_HEIGHT];
+static color sClipped[PLANE_WIDTH * PLANE_HEIGHT];
+static color sPanel[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+
+static color sColor;
+static color sKey;
+
+/*! 12 x 6 sprite, every third pixel has the key color */
+static color sSpritePixels[6 * 12];
+
+/*! 4 x 3 RLE4 sprite, a transparent run in the middle row */
+static const color sRlePalette[2] = { { .R = 255 }, { .B = 255 } };
+static const uint16_t sRleRows[3] = { 0, 1, 4 };
+static const uint8_t sRleRuns[] = { 0x30, 0x00, 0x1F, 0x01, 0x31 };
+static const ts_ws2812_sprite sRle = { 4, 3, WS2812_SPRITE_RLE4, sRlePalette, sRleRows, sRleRuns };
+
+static uint32_t sSeed = 1;
+
+
+static int32_t random_range(int32_t inMin, int32_t inMax) {
+
+    sSeed = sSeed * 1664525u + 1013904223u;
+
+    return inMin + (int32_t)((sSeed >> 8) % (uint32_t)(inMax - inMin + 1));
+}
+
+
+static void draw_hspan(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const int16_t * inParam) {
+    ws2812_draw_hspan(inCanvas, inX, inY, inParam[0], &sColor);
+}
+
+static void draw_vspan(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const int16_t * inParam) {
+    ws2812_draw_vspan(inCanvas, inX, inY, inParam[1], &sColor);
+}
+
+static void draw_rect(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const int16_t * inParam) {
+    ws2812_draw_rect(inCanvas, inX, inY, inParam[0], inParam[1], &sColor);
+}
+
+static void draw_rect_outline(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const int16_t * inParam) {
+    ws2812_draw_rect_outline(inCanvas, inX, inY, inParam[0], inParam[1], &sColor);
+}
+
+static void draw_line(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const int16_t * inParam) {
+    ws2812_draw_line(inCanvas, inX, inY, (int16_t)(inX + inParam[0]), (int16_t)(inY + inParam[1]), &sColor);
+}
+
+static void draw_circle(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const int16_t * inParam) {
+    ws2812_draw_circle(inCanvas, inX, inY, inParam[2], &sColor);
+}
+
+static void draw_circle_filled(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const int16_t * inParam) {
+    ws2812_draw_circle_filled(inCanvas, inX, inY, inParam[2], &sColor);
+}
+
+static void draw_sprite(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const int16_t * inParam) {
+
+    ts_ws2812_canvas lSprite;
+
+    (void)inParam;
+
+    ws2812_canvas_init(&lSprite, sSpritePixels, 12, 6, 12);
+    ws2812_draw_sprite(inCanvas, inX, inY, &lSprite, &sKey);
+}
+
+static void draw_sprite_rle(const ts_ws2812_canvas * inCanvas, int16_t inX, int16_t inY, const int16_t * inParam) {
+    (void)inParam;
+    ws2812_draw_sprite_rle(inCanvas, inX, inY, &sRle);
+}
+
+
+static const ts_primitive sPrimitives[] = {
+    { "hspan",          draw_hspan          },
+    { "vspan",          draw_vspan          },
+    { "rect",           draw_rect           },
+    { "rect outline",   draw_rect_outline   },
+    { "line",           draw_line           },
+    { "circle",         draw_circle         },
+    { "circle filled",  draw_circle_filled  },
+    { "sprite key",     draw_sprite         },
+    { "sprite rle",     draw_sprite_rle     },
+};
+
+
+static int is_set(const color * inPlane, int32_t inX, int32_t inY) {
+
+    return color_equal(&inPlane[(PANEL_Y + inY) * PLANE_WIDTH + PANEL_X + inX], &sColor);
+}
+
+
+/*! The clipped drawing has to match the plane within the panel and leave the rest alone */
+static int check_clipping(const ts_primitive * inPrimitive) {
+
+    ts_ws2812_canvas lPlane;
+    ts_ws2812_canvas lPanel;
+    int16_t lParam[3];
+    int16_t lX;
+    int16_t lY;
+    int32_t lShape;
+    int32_t lRow;
+    int32_t lColumn;
+    int32_t lInside;
+    color * lPlanePixel;
+    color * lClippedPixel;
+
+    ws2812_canvas_init(&lPlane, sPlane, PLANE_WIDTH, PLANE_HEIGHT, PLANE_WIDTH);
+    ws2812_canvas_init(&lPanel, &sClipped[PANEL_Y * PLANE_WIDTH + PANEL_X], WS2812_NR_COLUMNS, WS2812_NR_ROWS, PLANE_WIDTH);
+
+    for(lShape = 0; lShape < SHAPES; lShape++) {
+
+        memset(sPlane, 0, sizeof(sPlane));
+        memset(sClipped, 0, sizeof(sClipped));
+
+        /* around the panel, some of them with negative or zero sizes */
+        lX = (int16_t)random_range(-30, WS2812_NR_COLUMNS + 30);
+        lY = (int16_t)random_range(-10, WS2812_NR_ROWS + 10);
+        lParam[0] = (int16_t)random_range(-2, 40);
+        lParam[1] = (int16_t)random_range(-2, 16);
+        lParam[2] = (int16_t)random_range(-1, 12);
+
+        if(inPrimitive->mfDraw == draw_line) {
+            lParam[0] = (int16_t)random_range(-50, 50);
+            lParam[1] = (int16_t)random_range(-20, 20);
+        }
+
+        inPrimitive->mfDraw(&lPlane, (int16_t)(lX + PANEL_X), (int16_t)(lY + PANEL_Y), lParam);
+        inPrimitive->mfDraw(&lPanel, lX, lY, lParam);
+
+        for(lRow = 0; lRow < PLANE_HEIGHT; lRow++) {
+            for(lColumn = 0; lColumn < PLANE_WIDTH; lColumn++) {
+
+                lPlanePixel   = &sPlane[lRow * PLANE_WIDTH + lColumn];
+                lClippedPixel = &sClipped[lRow * PLANE_WIDTH + lColumn];
+
+                lInside = lRow >= PANEL_Y && lRow < PANEL_Y + WS2812_NR_ROWS &&
+                          lColumn >= PANEL_X && lColumn < PANEL_X + WS2812_NR_COLUMNS;
+
+                if(lInside ? !color_equal(lPlanePixel, lClippedPixel) : color_word(lClippedPixel) != 0) {
+
+                    printf("FAIL %s at (%d, %d) param %d %d %d: pixel (%d, %d)\n", inPrimitive->mName, lX, lY,
+                           lParam[0], lParam[1], lParam[2], (int)(lColumn - PANEL_X), (int)(lRow - PANEL_Y));
+                    return 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+/*! Unclipped lines against the reference rounding of the minor axis */
+static int check_lines(void) {
+
+    ts_ws2812_canvas lPlane;
+    int32_t lDx;
+    int32_t lDy;
+    int32_t lMajor;
+    int32_t lMinor;
+    int32_t lStep;
+    int32_t lOffset;
+    int32_t lX;
+    int32_t lY;
+    int32_t lSet;
+    int32_t lCount;
+
+    ws2812_canvas_init(&lPlane, sPlane, PLANE_WIDTH, PLANE_HEIGHT, PLANE_WIDTH);
+
+    for(lDy = -20; lDy <= 20; lDy++) {
+        for(lDx = -50; lDx <= 50; lDx++) {
+
+            memset(sPlane, 0, sizeof(sPlane));
+            ws2812_draw_line(&lPlane, PANEL_X + 60, PANEL_Y, (int16_t)(PANEL_X + 60 + lDx), (int16_t)(PANEL_Y + lDy), &sColor);
+
+            lMajor = (abs(lDx) >= abs(lDy))? abs(lDx) : abs(lDy);
+            lMinor = (abs(lDx) >= abs(lDy))? abs(lDy) : abs(lDx);
+
+            /* offset of step i is (2 * i * minor + major) / (2 * major), one pixel per step */
+            for(lStep = 0; lStep <= lMajor; lStep++) {
+
+                lOffset = (lMajor > 0)? (2 * lStep * lMinor + lMajor) / (2 * lMajor) : 0;
+
+                if(abs(lDx) >= abs(lDy)) {
+                    lX = (lDx < 0)? -lStep : lStep;
+                    lY = (lDy < 0)? -lOffset : lOffset;
+                } else {
+                    lX = (lDx < 0)? -lOffset : lOffset;
+                    lY = (lDy < 0)? -lStep : lStep;
+                }
+
+                if(!is_set(sPlane, 60 + lX, lY)) {
+                    printf("FAIL line to (%d, %d): step %d not set\n", (int)lDx, (int)lDy, (int)lStep);
+                    return 1;
+                }
+            }
+
+            for(lSet = 0, lCount = 0; lCount < PLANE_WIDTH * PLANE_HEIGHT; lCount++) {
+                lSet += color_equal(&sPlane[lCount], &sColor);
+            }
+
+            if(lSet != lMajor + 1) {
+                printf("FAIL line to (%d, %d): %d pixels instead of %d\n", (int)lDx, (int)lDy, (int)lSet, (int)(lMajor + 1));
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+/*! Unclipped circles, the outline within half a pixel of the radius and the filled circle up to it */
+static int check_circles(void) {
+
+    ts_ws2812_canvas lPlane;
+    ts_ws2812_canvas lFilled;
+    int32_t lRadius;
+    int32_t lX;
+    int32_t lY;
+    int32_t lDistance;
+    int32_t lInner;
+    int32_t lOuter;
+    int lOutline;
+    int lInside;
+
+    ws2812_canvas_init(&lPlane, sPlane, PLANE_WIDTH, PLANE_HEIGHT, PLANE_WIDTH);
+    ws2812_canvas_init(&lFilled, sClipped, PLANE_WIDTH, PLANE_HEIGHT, PLANE_WIDTH);
+
+    for(lRadius = 0; lRadius <= 15; lRadius++) {
+
+        memset(sPlane, 0, sizeof(sPlane));
+        memset(sClipped, 0, sizeof(sClipped));
+
+        ws2812_draw_circle(&lPlane, PANEL_X + 20, PANEL_Y, (int16_t)lRadius, &sColor);
+        ws2812_draw_circle_filled(&lFilled, PANEL_X + 20, PANEL_Y, (int16_t)lRadius, &sColor);
+
+        /* 4 * (x^2 + y^2) against (2r - 1)^2 and (2r + 1)^2, half a pixel in or out */
+        lInner = (lRadius > 0)? (2 * lRadius - 1) * (2 * lRadius - 1) : 0;
+        lOuter = (2 * lRadius + 1) * (2 * lRadius + 1);
+
+        for(lY = -lRadius - 1; lY <= lRadius + 1; lY++) {
+            for(lX = -lRadius - 1; lX <= lRadius + 1; lX++) {
+
+                lDistance = 4 * (lX * lX + lY * lY);
+                lOutline  = is_set(sPlane, 20 + lX, lY);
+                lInside   = is_set(sClipped, 20 + lX, lY);
+
+                if(lOutline != is_set(sPlane, 20 - lX, lY) || lOutline != is_set(sPlane, 20 + lY, lX)) {
+                    printf("FAIL circle %d: not symmetric at (%d, %d)\n", (int)lRadius, (int)lX, (int)lY);
+                    return 1;
+                }
+
+                if(lOutline && (lDistance < lInner || lDistance > lOuter)) {
+                    printf("FAIL circle %d: (%d, %d) off the radius\n", (int)lRadius, (int)lX, (int)lY);
+                    return 1;
+                }
+
+                if((lOutline && !lInside) || (lInside && lDistance > lOuter) || (!lInside && lDistance < lInner)) {
+                    printf("FAIL filled circle %d at (%d, %d)\n", (int)lRadius, (int)lX, (int)lY);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+/*! An unclipped RLE sprite against a decoder of the runs */
+static int check_sprite_rle(const ts_ws2812_sprite * inSprite, const char * inName) {
+
+    ts_ws2812_canvas lPlane;
+    const color * lExpected;
+    uint32_t lRun;
+    uint32_t lLength;
+    uint32_t lIndex;
+    int32_t lColumn;
+    int32_t lY;
+
+    ws2812_canvas_init(&lPlane, sPlane, PLANE_WIDTH, PLANE_HEIGHT, PLANE_WIDTH);
+
+    memset(sPlane, 0, sizeof(sPlane));
+    ws2812_draw_sprite_rle(&lPlane, PANEL_X, PANEL_Y, inSprite);
+
+    for(lY = 0; lY < inSprite->mHeight; lY++) {
+
+        for(lColumn = 0, lRun = inSprite->mRows[lY]; lColumn < inSprite->mWidth; ) {
+
+            if(inSprite->mFormat == WS2812_SPRITE_RLE4) {
+                lLength = (uint32_t)(inSprite->mRuns[lRun] >> 4) + 1;
+                lIndex  = inSprite->mRuns[lRun] & 0x0F;
+                lExpected = (lIndex == WS2812_SPRITE_TRANSPARENT4)? NULL : &inSprite->mPalette[lIndex];
+                lRun += 1;
+            } else {
+                lLength = (uint32_t)inSprite->mRuns[lRun] + 1;
+                lIndex  = inSprite->mRuns[lRun + 1];
+                lExpected = (lIndex == WS2812_SPRITE_TRANSPARENT8)? NULL : &inSprite->mPalette[lIndex];
+                lRun += 2;
+            }
+
+            for(; lLength > 0; lLength--, lColumn++) {
+
+                if(lExpected ? !color_equal(&sPlane[(PANEL_Y + lY) * PLANE_WIDTH + PANEL_X + lColumn], lExpected)
+                             : color_word(&sPlane[(PANEL_Y + lY) * PLANE_WIDTH + PANEL_X + lColumn]) != 0) {
+                    printf("FAIL sprite %s at (%d, %d)\n", inName, (int)lColumn, (int)lY);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+/*! Unclipped sprites against a per pixel copy */
+static int check_sprites(void) {
+
+    ts_ws2812_canvas lPlane;
+    int32_t lX;
+    int32_t lY;
+    size_t lSprite;
+    const color * lExpected;
+    char lName[16];
+    int lErrors = 0;
+
+    ws2812_canvas_init(&lPlane, sPlane, PLANE_WIDTH, PLANE_HEIGHT, PLANE_WIDTH);
+
+    memset(sPlane, 0, sizeof(sPlane));
+    draw_sprite(&lPlane, PANEL_X, PANEL_Y, NULL);
+
+    for(lY = 0; lY < 6; lY++) {
+        for(lX = 0; lX < 12; lX++) {
+
+            lExpected = &sSpritePixels[lY * 12 + lX];
+
+            if(color_equal(lExpected, &sKey) ? color_word(&sPlane[(PANEL_Y + lY) * PLANE_WIDTH + PANEL_X + lX]) != 0
+                                             : !color_equal(&sPlane[(PANEL_Y + lY) * PLANE_WIDTH + PANEL_X + lX], lExpected)) {
+                printf("FAIL sprite key at (%d, %d)\n", (int)lX, (int)lY);
+                return 1;
+            }
+        }
+    }
+
+    lErrors += check_sprite_rle(&sRle, "rle");
+
+    for(lSprite = 0; lSprite < gWs2812SpriteCount; lSprite++) {
+
+        snprintf(lName, sizeof(lName), "%u", (unsigned)lSprite);
+        lErrors += check_sprite_rle(gWs2812Sprites[lSprite], lName);
+    }
+
+    return lErrors;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+/*! Set a pixel with a bounds check, what ws2812_setLED() costs per pixel */
+static void set_pixel(int32_t inX, int32_t inY) {
+
+    if(inX >= 0 && inX < WS2812_NR_COLUMNS && inY >= 0 && inY < WS2812_NR_ROWS) {
+        sPanel[inY * WS2812_NR_COLUMNS + inX] = sColor;
+    }
+}
+
+
+/*! Best time in ns per call, shapes across the panel with a part clipped */
+static double measure(const ts_primitive * inPrimitive, uint32_t inCalls) {
+
+    static const int16_t lParam[3] = { 40, 4, 3 };
+    ts_ws2812_canvas lPanel;
+    uint32_t lCall;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    ws2812_canvas_init(&lPanel, sPanel, WS2812_NR_COLUMNS, WS2812_NR_ROWS, WS2812_NR_COLUMNS);
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        lStart = now();
+
+        for(lCall = 0; lCall < inCalls; lCall++) {
+            inPrimitive->mfDraw(&lPanel, (int16_t)((lCall % (WS2812_NR_COLUMNS + 20)) - 10), (int16_t)((lCall % 7) - 2), lParam);
+        }
+
+        lTime = (now() - lStart) / inCalls;
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+    }
+
+    return lBest;
+}
+
+
+/*! Best time in ns per call of a rectangle or line of set_pixel() calls */
+static double measure_per_pixel(int inLine, uint32_t inCalls) {
+
+    uint32_t lCall;
+    int32_t lX;
+    int32_t lY;
+    int32_t lRow;
+    int32_t lColumn;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        lStart = now();
+
+        for(lCall = 0; lCall < inCalls; lCall++) {
+
+            lX = (int32_t)(lCall % (WS2812_NR_COLUMNS + 20)) - 10;
+            lY = (int32_t)(lCall % 7) - 2;
+
+            if(inLine) {
+                /* 40 to the right and 4 down, as ws2812_draw_line() rounds */
+                for(lColumn = 0; lColumn <= 40; lColumn++) {
+                    set_pixel(lX + lColumn, lY + (2 * lColumn * 4 + 40) / 80);
+                }
+            } else {
+                for(lRow = 0; lRow < 4; lRow++) {
+                    for(lColumn = 0; lColumn < 40; lColumn++) {
+                        set_pixel(lX + lColumn, lY + lRow);
+                    }
+                }
+            }
+        }
+
+        lTime = (now() - lStart) / inCalls;
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+    }
+
+    return lBest;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    uint32_t lCalls = 1000000;
+    size_t lCount;
+    int lErrors = 0;
+
+    if(argc > 1) {
+        lCalls = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lCalls == 0) {
+        printf("Usage: %s [<calls>]\n", argv[0]);
+        return -1;
+    }
+
+    memset(&sColor, 0, sizeof(sColor));
+    memset(&sKey, 0, sizeof(sKey));
+    sColor.G = 200;
+    sKey.R = 255;
+    sKey.B = 255;
+
+    for(lCount = 0; lCount < sizeof(sSpritePixels) / sizeof(sSpritePixels[0]); lCount++) {
+
+        memset(&sSpritePixels[lCount], 0, sizeof(color));
+        sSpritePixels[lCount].R = (uint8_t)(lCount * 3 + 1);
+        sSpritePixels[lCount].G = 200;
+
+        if(lCount % 3 == 0) {
+            sSpritePixels[lCount] = sKey;
+        }
+    }
+
+    for(lCount = 0; lCount < sizeof(sPrimitives) / sizeof(sPrimitives[0]); lCount++) {
+        lErrors += check_clipping(&sPrimitives[lCount]);
+    }
+
+    printf("clipping of %d shapes per primitive   %s\n", SHAPES, lErrors ? "FAIL" : "ok");
+
+    lErrors += check_lines();
+    lErrors += check_circles();
+    lErrors += check_sprites();
+
+    printf("lines, circles, sprites              %s\n\n", lErrors ? "FAIL" : "ok");
+
+    printf("Primitive          ns per call\n");
+
+    for(lCount = 0; lCount < sizeof(sPrimitives) / sizeof(sPrimitives[0]); lCount++) {
+        printf("  %-16s %8.1f\n", sPrimitives[lCount].mName, measure(&sPrimitives[lCount], lCalls));
+    }
+
+    printf("  rect per pixel   %8.1f\n", measure_per_pixel(0, lCalls));
+    printf("  line per pixel   %8.1f\n", measure_per_pixel(1, lCalls));
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
@@ -0,0 +1,284 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ws2812_gif.h"
+
+/*  Checks a GIF for the GIF animation and prepares the upload
+
+    Usage: gif_tool [-c] <gif>
+           gif_tool -u <gif>
+           gif_tool -l <list>
+
+    The first form decodes the GIF from memory like the animation does,
+    scaled or with -c cropped to a 5 x 172 panel, and prints the time per
+    frame and the memory needed. -u prints the forms to upload the GIF,
+    one per line, to be posted in order.
+
+    -l decodes every GIF of a list, one per line with the number of frames
+    of one run, 0 if the decoder has to reject it. Paths are relative to
+    the list, # starts a comment. Every GIF is printed with its frames per
+    second and whether it fits the store. The tool fails if a GIF is
+    rejected, or if it plays a different number of frames than listed. A
+    damaged frame after intact ones ends the run, so it only shows up in
+    the number of frames.
+*/
+
+
+/*! Frames to decode for the benchmark */
+#define BENCH_FRAMES        (2000)
+
+/*! Bytes per upload form, fits the 4 KiB request */
+#define UPLOAD_PART         (1536)
+
+
+/*! Print the forms to upload the GIF */
+static int upload(const uint8_t * inData, size_t inLength) {
+
+    size_t lOffset;
+    size_t lCount;
+
+    for(lOffset = 0; lOffset < inLength; lOffset += UPLOAD_PART) {
+
+        printf("angiflen=%u&angifofs=%u&angif=", (unsigned)inLength, (unsigned)lOffset);
+
+        for(lCount = lOffset; lCount < inLength && lCount < lOffset + UPLOAD_PART; lCount++) {
+            printf("%02x", inData[lCount]);
+        }
+
+        printf("\n");
+    }
+
+    return 0;
+}
+
+
+/*! Result of decoding BENCH_FRAMES frames */
+typedef struct {
+
+    /*! Size of the logical screen, 0 x 0 if the GIF was rejected */
+    uint16_t    mWidth;
+    uint16_t    mHeight;
+
+    /*! Frames and delay in 1/100 s of the first run */
+    uint32_t    mFrames;
+    uint32_t    mDelay;
+
+    /*! Frame the decoder failed on, -1 if all were decoded */
+    int         mDamaged;
+
+    /*! Time of all frames in ns */
+    double      mNanoseconds;
+
+} ts_decode;
+
+
+/*! Decode BENCH_FRAMES frames of the GIF onto a panel */
+static void decode(const uint8_t * inData, size_t inLength, te_ws2812_gif_fit inFit, ts_decode * outResult) {
+
+    static color lPanel[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+    static ts_ws2812_gif lGif;
+
+    ts_ws2812_gif_memory lSource;
+    ts_ws2812_canvas lCanvas;
+    ts_ws2812_span lDirty[WS2812_NR_ROWS];
+    struct timespec lStart;
+    struct timespec lEnd;
+    uint32_t lDelay;
+    int lFrame;
+    int lRow;
+
+    memset(outResult, 0, sizeof(*outResult));
+
+    ws2812_gif_memory_init(&lSource, inData, inLength);
+    ws2812_canvas_init(&lCanvas, lPanel, WS2812_NR_COLUMNS, WS2812_NR_ROWS, WS2812_NR_COLUMNS);
+
+    if(!ws2812_gif_open(&lGif, ws2812_gif_memory_read, ws2812_gif_memory_seek, &lSource, inFit)) {
+        return;
+    }
+
+    outResult->mWidth  = lGif.mWidth;
+    outResult->mHeight = lGif.mHeight;
+
+    clock_gettime(CLOCK_MONOTONIC, &lStart);
+
+    for(lFrame = 0; lFrame < BENCH_FRAMES; lFrame++) {
+
+        for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+            ws2812_span_clear(&lDirty[lRow]);
+        }
+
+        if(!ws2812_gif_next_frame(&lGif, &lCanvas, lDirty, &lDelay)) {
+            outResult->mDamaged = lFrame;
+            return;
+        }
+
+        /* frames of the first run */
+        if(lGif.mFrames > outResult->mFrames) {
+            outResult->mFrames = lGif.mFrames;
+            outResult->mDelay += lDelay;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &lEnd);
+
+    outResult->mDamaged     = -1;
+    outResult->mNanoseconds = (lEnd.tv_sec - lStart.tv_sec) * 1e9 + (lEnd.tv_nsec - lStart.tv_nsec);
+}
+
+
+/*! Decode the GIF onto a panel and print the time per frame */
+static int bench(const uint8_t * inData, size_t inLength, te_ws2812_gif_fit inFit) {
+
+    ts_decode lResult;
+
+    decode(inData, inLength, inFit, &lResult);
+
+    if(lResult.mWidth == 0) {
+        printf("No GIF!\n");
+        return -1;
+    }
+
+    printf("%u x %u, %u bytes\n", lResult.mWidth, lResult.mHeight, (unsigned)inLength);
+
+    if(lResult.mDamaged >= 0) {
+        printf("Frame %d is damaged!\n", lResult.mDamaged);
+        return -1;
+    }
+
+    printf("%u frames, %u.%02u s per run\n", (unsigned)lResult.mFrames, (unsigned)(lResult.mDelay / 100), (unsigned)(lResult.mDelay % 100));
+    printf("%.1f us per frame, %.0f frames per second\n",
+           lResult.mNanoseconds / BENCH_FRAMES / 1000.0, BENCH_FRAMES * 1e9 / lResult.mNanoseconds);
+    printf("%u bytes decoder, %u bytes stored GIF\n", (unsigned)sizeof(ts_ws2812_gif), (unsigned)inLength);
+
+    return 0;
+}
+
+
+/*! Decode every GIF of a list and check the number of frames */
+static int corpus(const char * inList, uint8_t * pData, size_t inSize) {
+
+    char lLine[512];
+    char lName[256];
+    char lPath[768];
+    const char * lSlash;
+    FILE * lList;
+    FILE * lFile;
+    size_t lLength;
+    unsigned lExpected;
+    ts_decode lResult;
+    int lErrors = 0;
+    int lCount = 0;
+
+    lList = fopen(inList, "r");
+    if(!lList) {
+        printf("Could not open list: %s\n", inList);
+        return -1;
+    }
+
+    lSlash = strrchr(inList, '/');
+
+    printf("GIF                      bytes       size  frames     fps  store\n");
+
+    while(fgets(lLine, sizeof(lLine), lList)) {
+
+        if(lLine[0] == '#' || sscanf(lLine, "%255s %u", lName, &lExpected) != 2) {
+            continue;
+        }
+
+        snprintf(lPath, sizeof(lPath), "%.*s%s", lSlash ? (int)(lSlash - inList + 1) : 0, inList, lName);
+
+        lFile = fopen(lPath, "rb");
+        if(!lFile) {
+            printf("%-20s could not be opened\n", lName);
+            lErrors++;
+            continue;
+        }
+
+        lLength = fread(pData, 1, inSize, lFile);
+        fclose(lFile);
+        lCount++;
+
+        decode(pData, lLength, WS2812_GIF_SCALE, &lResult);
+
+        printf("%-20s %9u", lName, (unsigned)lLength);
+
+        if(lResult.mWidth == 0 || lResult.mDamaged >= 0) {
+
+            printf("  rejected%s\n", lResult.mWidth ? " in frame" : "");
+
+            /* only the GIFs listed without frames may be rejected */
+            lErrors += (lExpected != 0);
+            continue;
+        }
+
+        printf("  %4u x %-3u %5u %7.0f  %s\n", lResult.mWidth, lResult.mHeight, (unsigned)lResult.mFrames,
+               BENCH_FRAMES * 1e9 / lResult.mNanoseconds, (lLength <= WS2812_GIF_STORE_MAX)? "yes" : "too big");
+
+        if(lResult.mFrames != lExpected) {
+            printf("FAIL %s plays %u frames instead of %u\n", lName, (unsigned)lResult.mFrames, lExpected);
+            lErrors++;
+        }
+    }
+
+    fclose(lList);
+
+    printf("\n%u bytes decoder and %u bytes store for every GIF, nothing else is allocated\n",
+           (unsigned)sizeof(ts_ws2812_gif), (unsigned)WS2812_GIF_STORE_MAX);
+    printf("%d GIFs, %d errors\n", lCount, lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    static uint8_t lData[1024 * 1024];
+
+    FILE * lFile;
+    size_t lLength;
+    te_ws2812_gif_fit lFit = WS2812_GIF_SCALE;
+    int lUpload = 0;
+    int lArg = 1;
+
+    if(argc > lArg && strcmp(argv[lArg], "-c") == 0) {
+        lFit = WS2812_GIF_CROP;
+        lArg++;
+    } else if(argc > lArg && strcmp(argv[lArg], "-u") == 0) {
+        lUpload = 1;
+        lArg++;
+    } else if(argc == 3 && strcmp(argv[lArg], "-l") == 0) {
+        return corpus(argv[2], lData, sizeof(lData));
+    }
+
+    if(argc <= lArg) {
+        printf("Usage: %s [-c | -u] <gif>\n", argv[0]);
+        printf("       %s -l <list>\n", argv[0]);
+        return -1;
+    }
+
+    lFile = fopen(argv[lArg], "rb");
+    if(!lFile) {
+        printf("Could not open input file: %s\n", argv[lArg]);
+        return -1;
+    }
+
+    lLength = fread(lData, 1, sizeof(lData), lFile);
+    fclose(lFile);
+
+    if(lUpload) {
+
+        if(lLength > WS2812_GIF_STORE_MAX) {
+            printf("The GIF has %u bytes, at most %u fit!\n", (unsigned)lLength, (unsigned)WS2812_GIF_STORE_MAX);
+            return -1;
+        }
+
+        return upload(lData, lLength);
+    }
+
+    return bench(lData, lLength, lFit);
+}
+
+/* eof */
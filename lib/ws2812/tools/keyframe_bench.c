@@ -0,0 +1,396 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "color.h"
+#include "color_palette.h"
+#include "ws2812.h"
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_p.h"
+#include "ws2812_anim_fire.h"
+#include "ws2812_anim_clouds.h"
+#include "ws2812_anim_gradient.h"
+
+/*  Measures keyframe interpolation against rendering every frame
+
+    Usage: keyframe_bench [<frames>]
+
+    The fire, the clouds (noise) and a rotating gradient run <frames> frames
+    at full rate and with a keyframe divider of 2, the latter the way
+    ws2812_animation_interpolate() does in 8 bit: one part of the next
+    keyframe per frame, the finished keyframe copied, the output blended
+    from the last two. Only the fire has mfUpdatePart, it simulates with the
+    first part and draws half of the rows with each. Clouds and gradient
+    have none, for them the bench renders the whole keyframe with the first
+    part and nothing with the second. That is the average they would reach,
+    but every second frame still carries a full render. The keyframes run at
+    half rate, so the fire burns and the others move at 50 Hz.
+
+    A fire keyframe rendered in two parts has to equal a full render, and
+    the output of the first frame after a keyframe has to be the keyframe
+    before it. The timing is the best of five runs in ns per frame on
+    average and of the heavier of the two frames of a keyframe.
+*/
+
+
+/*! Rows and columns of the panel */
+#define ROWS                (WS2812_NR_ROWS)
+#define COLUMNS             (WS2812_NR_COLUMNS)
+
+/*! Leds of a panel */
+#define LEDS                (ROWS * COLUMNS)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+/*! Keyframe divider of the interpolated runs */
+#define DIVIDER             (2)
+
+/*! Frames of the checks */
+#define CHECK_FRAMES        (200)
+
+
+/*! An animation and its parameters */
+typedef struct {
+
+    const char * mName;
+
+    void (* mfInit)(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+    /*! Releases the buffers of the animation, NULL if there are none */
+    void (* mfClean)(tu_ws2812_anim * pThis);
+
+    void (* mfParam)(tu_ws2812_anim_param * outParam);
+
+} ts_keyframe_type;
+
+
+/*! Keyframe state like ts_ws2812_anim_keyframes of ws2812_anim.c */
+typedef struct {
+
+    color mKey[2][LEDS];
+    color mOutput[LEDS];
+    size_t mNewest;
+    uint32_t mPart;
+
+} ts_keyframes;
+
+
+static tu_ws2812_anim sAnim;
+static tu_ws2812_anim_param sParam;
+static ts_keyframes sKeys;
+
+static color sReference[LEDS];
+
+static uint32_t sSeed;
+
+
+uint32_t ws2812_animation_seed(void) {
+
+    sSeed = sSeed * 1664525u + 1013904223u;
+
+    return sSeed;
+}
+
+
+void ws2812_transition_done(void) {
+}
+
+
+static void param_fire(tu_ws2812_anim_param * outParam) {
+
+    outParam->mFire.mPalette = COLOR_PALETTE_HEAT;
+}
+
+
+static void param_clouds(tu_ws2812_anim_param * outParam) {
+
+    outParam->mClouds.mPalette = COLOR_PALETTE_SKY;
+}
+
+
+static void param_gradient(tu_ws2812_anim_param * outParam) {
+
+    color_set_word(&outParam->mGradient.mFirstColor,  0x00FF0000u);
+    color_set_word(&outParam->mGradient.mSecondColor, 0x000000FFu);
+    outParam->mGradient.mAngle    = 30;
+    outParam->mGradient.mRotation = 150;
+}
+
+
+static const ts_keyframe_type sTypes[] = {
+    { "fire",     ws2812_anim_fire_init,     ws2812_anim_fire_clean, param_fire     },
+    { "clouds",   ws2812_anim_clouds_init,   NULL,                   param_clouds   },
+    { "gradient", ws2812_anim_gradient_init, NULL,                   param_gradient },
+};
+
+
+/*! Start the animation, every start burns and moves the same */
+static void start(const ts_keyframe_type * inType) {
+
+    memset(&sAnim, 0, sizeof(sAnim));
+    memset(&sParam, 0, sizeof(sParam));
+
+    sSeed = 1;
+
+    inType->mfParam(&sParam);
+
+    /* what ws2812_animation_setup() sets before the init */
+    sAnim.mBase.mFlags           = WS2812_ANIM_FLAG_DIRTY;
+    sAnim.mBase.mKeyframeDivider = 1;
+    sAnim.mBase.mRows            = ROWS;
+    sAnim.mBase.mColumns         = COLUMNS;
+
+    inType->mfInit(&sAnim, &sParam);
+}
+
+
+static void stop(const ts_keyframe_type * inType) {
+
+    if(inType->mfClean) {
+        inType->mfClean(&sAnim);
+    }
+}
+
+
+/*! The whole keyframe with the first part for animations without mfUpdatePart */
+static void update_part(tu_ws2812_anim * pThis, uint32_t inPart, uint32_t inParts) {
+
+    (void)inParts;
+
+    if(inPart == 0) {
+        pThis->mBase.mfUpdate(pThis);
+    }
+}
+
+
+static void render_part(uint32_t inPart) {
+
+    if(sAnim.mBase.mfUpdatePart) {
+        sAnim.mBase.mfUpdatePart(&sAnim, inPart, DIVIDER);
+    } else {
+        update_part(&sAnim, inPart, DIVIDER);
+    }
+}
+
+
+/*! Render all parts of the first keyframe into both buffers */
+static void prime(void) {
+
+    for(sKeys.mPart = 0; sKeys.mPart < DIVIDER; sKeys.mPart++) {
+        render_part(sKeys.mPart);
+    }
+
+    memcpy(sKeys.mKey[0], sAnim.mBase.mPanel, sizeof(sKeys.mKey[0]));
+    memcpy(sKeys.mKey[1], sAnim.mBase.mPanel, sizeof(sKeys.mKey[1]));
+
+    sKeys.mNewest = 0;
+    sKeys.mPart   = 0;
+}
+
+
+/*! One frame of ws2812_animation_interpolate() in 8 bit */
+static void interpolate(void) {
+
+    render_part(sKeys.mPart);
+
+    if(++sKeys.mPart == DIVIDER) {
+
+        /* keyframe is complete, it replaces the older one */
+        sKeys.mNewest ^= 1;
+        memcpy(sKeys.mKey[sKeys.mNewest], sAnim.mBase.mPanel, sizeof(sKeys.mKey[0]));
+
+        sKeys.mPart = 0;
+    }
+
+    color_blend(sKeys.mOutput, sKeys.mKey[sKeys.mNewest ^ 1], sKeys.mKey[sKeys.mNewest], LEDS,
+                (uint8_t)((sKeys.mPart << 8) / DIVIDER));
+}
+
+
+static void full(void) {
+
+    sAnim.mBase.mfUpdate(&sAnim);
+}
+
+
+/*! A fire keyframe in parts has to burn like the full render */
+static int check_parts(void) {
+
+    uint32_t lFrame;
+
+    start(&sTypes[0]);
+
+    for(lFrame = 0; lFrame < CHECK_FRAMES; lFrame++) {
+        full();
+    }
+
+    memcpy(sReference, sAnim.mBase.mPanel, sizeof(sReference));
+    stop(&sTypes[0]);
+
+    start(&sTypes[0]);
+
+    for(lFrame = 0; lFrame < CHECK_FRAMES * DIVIDER; lFrame++) {
+        render_part(lFrame % DIVIDER);
+    }
+
+    stop(&sTypes[0]);
+
+    if(memcmp(sReference, sAnim.mBase.mPanel, sizeof(sReference)) != 0) {
+        printf("FAIL fire: a keyframe rendered in parts differs from the full render\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+
+/*! The output lags one keyframe, the first frame after one shows the one before */
+static int check_lag(const ts_keyframe_type * inType) {
+
+    uint32_t lFrame;
+
+    start(inType);
+    prime();
+
+    memcpy(sReference, sKeys.mKey[0], sizeof(sReference));
+
+    for(lFrame = 0; lFrame < CHECK_FRAMES; lFrame++) {
+
+        interpolate();
+
+        if(sKeys.mPart == 0) {
+
+            if(memcmp(sReference, sKeys.mOutput, sizeof(sReference)) != 0) {
+                printf("FAIL %s frame %u: the output is not the previous keyframe\n", inType->mName, (unsigned)lFrame);
+                stop(inType);
+                return 1;
+            }
+
+            memcpy(sReference, sKeys.mKey[sKeys.mNewest], sizeof(sReference));
+        }
+    }
+
+    stop(inType);
+
+    return 0;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+/*! Best time in ns per frame, on average and of the heavier frame of a keyframe */
+static void measure(const ts_keyframe_type * inType, void (* infFrame)(void), uint32_t inFrames,
+                    double * outAverage, double * outHeaviest) {
+
+    double lPhase[DIVIDER];
+    uint32_t lFrame;
+    uint32_t lSum = 0;
+    uint32_t lCount;
+    int lRun;
+    double lStart;
+    double lAverage;
+    double lHeaviest;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        start(inType);
+        prime();
+
+        memset(lPhase, 0, sizeof(lPhase));
+
+        for(lFrame = 0; lFrame < inFrames; lFrame++) {
+
+            lStart = now();
+            infFrame();
+            lPhase[lFrame % DIVIDER] += now() - lStart;
+
+            lSum += sKeys.mOutput[lFrame % LEDS].G + sAnim.mBase.mPanel[lFrame % LEDS].G;
+        }
+
+        stop(inType);
+
+        for(lCount = 0, lAverage = 0.0, lHeaviest = 0.0; lCount < DIVIDER; lCount++) {
+
+            lAverage += lPhase[lCount];
+
+            if(lPhase[lCount] > lHeaviest) {
+                lHeaviest = lPhase[lCount];
+            }
+        }
+
+        lAverage  /= inFrames;
+        lHeaviest /= inFrames / DIVIDER;
+
+        if(lRun == 0 || lAverage < *outAverage) {
+            *outAverage = lAverage;
+        }
+
+        if(lRun == 0 || lHeaviest < *outHeaviest) {
+            *outHeaviest = lHeaviest;
+        }
+    }
+
+    /* the panels have to be used */
+    if(lSum == 0xFFFFFFFF) {
+        printf("\n");
+    }
+}
+
+
+int main(int argc, char * argv[]) {
+
+    uint32_t lFrames = 20000;
+    size_t lCount;
+    double lFullAverage;
+    double lFullHeaviest;
+    double lKeyAverage;
+    double lKeyHeaviest;
+    int lErrors = 0;
+
+    if(argc > 1) {
+        lFrames = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lFrames < DIVIDER) {
+        printf("Usage: %s [<frames>]\n", argv[0]);
+        return -1;
+    }
+
+    lErrors += check_parts();
+
+    for(lCount = 0; lCount < sizeof(sTypes) / sizeof(sTypes[0]); lCount++) {
+        lErrors += check_lag(&sTypes[lCount]);
+    }
+
+    printf("keyframes in parts, output one keyframe behind   %s\n\n", lErrors ? "FAIL" : "ok");
+
+    printf("ns per frame           full rate              divider %d\n", DIVIDER);
+    printf("                  average  heaviest     average  heaviest\n");
+
+    for(lCount = 0; lCount < sizeof(sTypes) / sizeof(sTypes[0]); lCount++) {
+
+        measure(&sTypes[lCount], full, lFrames, &lFullAverage, &lFullHeaviest);
+        measure(&sTypes[lCount], interpolate, lFrames, &lKeyAverage, &lKeyHeaviest);
+
+        printf("  %-10s   %8.0f  %8.0f    %8.0f  %8.0f%s\n", sTypes[lCount].mName, lFullAverage, lFullHeaviest,
+               lKeyAverage, lKeyHeaviest, sAnim.mBase.mfUpdatePart ? "" : "   no mfUpdatePart");
+    }
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
@@ -0,0 +1,448 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "color.h"
+#include "color_palette.h"
+#include "ws2812.h"
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_p.h"
+#include "ws2812_anim_const_color.h"
+#include "ws2812_anim_gradient.h"
+#include "ws2812_anim_color_palette.h"
+#include "ws2812_anim_fire.h"
+#include "ws2812_anim_plasma.h"
+#include "ws2812_anim_clouds.h"
+#include "ws2812_anim_rainbow.h"
+#include "ws2812_anim_particles.h"
+#include "ws2812_anim_cells.h"
+#include "ws2812_anim_text.h"
+#include "ws2812_transition_obj.h"
+
+/*  Measures a morph against a restart with a crossfade
+
+    Usage: morph_bench [<frames>]
+
+    Every animation that builds on the host changes its parameters back and
+    forth, ten times per run, over <frames> frames each. The morph calls
+    mfMorph() and renders the one animation, what ws2812_animation_start()
+    does when the type stays. The restart initializes a second animation
+    with the new parameters and renders both through the fade transition
+    like the transition state of ws2812_animation_main(), strips expanded to
+    the panel, the outgoing animation at full rate and cleaned up at the
+    end. Static animations are only rendered when they are dirty, keyframe
+    interpolation is off. The program, GIF, sequence and audio animations
+    need the scheduler, the SD card or the audio input and are left out.
+
+    A morph of a stateless animation has to end on the frame a fresh start
+    with the new parameters renders. The timing is the best of five runs in
+    ns per frame, the start of the change included.
+*/
+
+
+/*! Rows and columns of the panel */
+#define ROWS                (WS2812_NR_ROWS)
+#define COLUMNS             (WS2812_NR_COLUMNS)
+
+/*! Leds of a panel */
+#define LEDS                (ROWS * COLUMNS)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+/*! Parameter changes of a run */
+#define CHANGES             (10)
+
+
+/*! An animation type and the two parameter sets it changes between */
+typedef struct {
+
+    const char * mName;
+
+    void (* mfInit)(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+    /*! Releases the buffers of the animation, NULL if there are none */
+    void (* mfClean)(tu_ws2812_anim * pThis);
+
+    void (* mfParam)(tu_ws2812_anim_param * outParam, int inSecond);
+
+    /*! The end of a morph can be checked against a fresh start */
+    int mStateless;
+
+} ts_morph_type;
+
+
+static tu_ws2812_anim sAnim[2];
+static tu_ws2812_anim_param sParam;
+static tu_ws2812_trans sTransition;
+
+static color sReference[LEDS];
+
+static uint32_t sSeed = 1;
+static uint32_t sTransitionsDone;
+
+
+uint32_t ws2812_animation_seed(void) {
+
+    sSeed = sSeed * 1664525u + 1013904223u;
+
+    return sSeed;
+}
+
+
+void ws2812_transition_done(void) {
+
+    sTransitionsDone++;
+}
+
+
+static void param_const_color(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    color_set_word(&outParam->mConstantColor.mColor, inSecond ? 0x000020FFu : 0x00FF4000u);
+}
+
+
+static void param_gradient(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    color_set_word(&outParam->mGradient.mFirstColor,  inSecond ? 0x0000FF20u : 0x00FF0000u);
+    color_set_word(&outParam->mGradient.mSecondColor, inSecond ? 0x00FFFF00u : 0x000000FFu);
+    outParam->mGradient.mAngle    = inSecond ? 90 : 0;
+    outParam->mGradient.mRotation = 0;
+}
+
+
+static void param_gradient_colors(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    param_gradient(outParam, inSecond);
+    outParam->mGradient.mAngle = 45;
+}
+
+
+static void param_gradient_rotating(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    param_gradient(outParam, inSecond);
+    outParam->mGradient.mRotation = inSecond ? -200 : 100;
+}
+
+
+static void param_color_palette(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    outParam->mPalette.mPalette = inSecond ? COLOR_PALETTE_OCEAN : COLOR_PALETTE_LAVA;
+}
+
+
+static void param_fire(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    outParam->mFire.mPalette = inSecond ? COLOR_PALETTE_OCEAN : COLOR_PALETTE_HEAT;
+}
+
+
+static void param_plasma(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    outParam->mPlasma.mPalette = inSecond ? COLOR_PALETTE_FOREST : COLOR_PALETTE_RAINBOW;
+}
+
+
+static void param_clouds(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    outParam->mClouds.mPalette = inSecond ? COLOR_PALETTE_LAVA : COLOR_PALETTE_SKY;
+}
+
+
+static void param_rainbow(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    outParam->mRainbow.mSpeed      = inSecond ? -500 : 300;
+    outParam->mRainbow.mStep       = inSecond ? 1000 : 380;
+    outParam->mRainbow.mSaturation = inSecond ? 255 : 240;
+    outParam->mRainbow.mValue      = inSecond ? 128 : 200;
+}
+
+
+static void param_particles(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    outParam->mParticles.mEffect  = inSecond ? WS2812_PARTICLES_CONFETTI : WS2812_PARTICLES_FIREWORKS;
+    outParam->mParticles.mPalette = inSecond ? COLOR_PALETTE_OCEAN : COLOR_PALETTE_LAVA;
+}
+
+
+static void param_cells(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    outParam->mCells.mRule    = WS2812_CELLS_LIFE;
+    outParam->mCells.mPalette = inSecond ? COLOR_PALETTE_LAVA : COLOR_PALETTE_FOREST;
+}
+
+
+static void param_text(tu_ws2812_anim_param * outParam, int inSecond) {
+
+    strcpy(outParam->mText.mText, "Hello World! 0123456789");
+    color_set_word(&outParam->mText.mForeground, inSecond ? 0x00FF2000u : 0x00FFFFFFu);
+    color_set_word(&outParam->mText.mBackground, inSecond ? 0x00000010u : 0x00000000u);
+    outParam->mText.mStep = inSecond ? 0x0180 : 0x0100;
+}
+
+
+static const ts_morph_type sTypes[] = {
+    { "const",              ws2812_anim_const_color_init,    NULL,                         param_const_color,       1 },
+    { "gradient turning",   ws2812_anim_gradient_init,       NULL,                         param_gradient,          1 },
+    { "gradient colors",    ws2812_anim_gradient_init,       NULL,                         param_gradient_colors,   1 },
+    { "gradient rotating",  ws2812_anim_gradient_init,       NULL,                         param_gradient_rotating, 0 },
+    { "palette",            ws2812_anim_color_palette_init,  NULL,                         param_color_palette,     1 },
+    { "fire",               ws2812_anim_fire_init,           ws2812_anim_fire_clean,       param_fire,              0 },
+    { "plasma",             ws2812_anim_plasma_init,         NULL,                         param_plasma,            0 },
+    { "clouds",             ws2812_anim_clouds_init,         NULL,                         param_clouds,            0 },
+    { "rainbow",            ws2812_anim_rainbow_init,        NULL,                         param_rainbow,           0 },
+    { "particles",          ws2812_anim_particles_init,      ws2812_anim_particles_clean,  param_particles,         0 },
+    { "cells",              ws2812_anim_cells_init,          ws2812_anim_cells_clean,      param_cells,             0 },
+    { "text",               ws2812_anim_text_init,           NULL,                         param_text,              0 },
+};
+
+
+static void start(tu_ws2812_anim * pAnim, const ts_morph_type * inType, int inSecond) {
+
+    memset(pAnim, 0, sizeof(*pAnim));
+    memset(&sParam, 0, sizeof(sParam));
+
+    inType->mfParam(&sParam, inSecond);
+
+    /* what ws2812_animation_setup() sets before the init */
+    pAnim->mBase.mFlags           = WS2812_ANIM_FLAG_DIRTY;
+    pAnim->mBase.mKeyframeDivider = 1;
+    pAnim->mBase.mRows            = ROWS;
+    pAnim->mBase.mColumns         = COLUMNS;
+
+    inType->mfInit(pAnim, &sParam);
+}
+
+
+static void stop(tu_ws2812_anim * pAnim, const ts_morph_type * inType) {
+
+    if(inType->mfClean) {
+        inType->mfClean(pAnim);
+    }
+}
+
+
+/*! What ws2812_animation_render() and ws2812_animation_update() do at full rate */
+static void render(tu_ws2812_anim * pAnim) {
+
+    if(pAnim->mBase.mFlags & WS2812_ANIM_FLAG_SPANS) {
+        ws2812_spans_clear(pAnim->mBase.mDirty);
+    }
+
+    if((pAnim->mBase.mFlags & (WS2812_ANIM_FLAG_STATIC | WS2812_ANIM_FLAG_DIRTY)) != WS2812_ANIM_FLAG_STATIC) {
+
+        pAnim->mBase.mFlags &= ~WS2812_ANIM_FLAG_DIRTY;
+
+        pAnim->mBase.mfUpdate(pAnim);
+    }
+}
+
+
+/*! The rendered panel, a strip written to every row like ws2812_setLED_Strip() */
+static color * panel(tu_ws2812_anim * pAnim) {
+
+    size_t lRow;
+
+    if(pAnim->mBase.mFlags & WS2812_ANIM_FLAG_STRIP) {
+
+        for(lRow = 0; lRow < ROWS; lRow++) {
+            memcpy(&pAnim->mBase.mPanel[lRow * COLUMNS], pAnim->mBase.mStrip, COLUMNS * sizeof(color));
+        }
+    }
+
+    return pAnim->mBase.mPanel;
+}
+
+
+/*! Change the parameters of the running animation over inFrames frames */
+static void change_morph(const ts_morph_type * inType, int inSecond, uint32_t inFrames) {
+
+    uint32_t lFrame;
+
+    memset(&sParam, 0, sizeof(sParam));
+    inType->mfParam(&sParam, inSecond);
+
+    sAnim[0].mBase.mfMorph(&sAnim[0], &sParam, inFrames);
+
+    for(lFrame = 0; lFrame < inFrames; lFrame++) {
+        render(&sAnim[0]);
+    }
+}
+
+
+/*! Start a second animation and fade to it over inFrames frames, it runs on in sAnim[0] */
+static void change_restart(const ts_morph_type * inType, int inSecond, uint32_t inFrames) {
+
+    tu_ws2812_trans_param lFade;
+    uint32_t lFrame;
+
+    start(&sAnim[1], inType, inSecond);
+
+    lFade.mFade.mDuration = inFrames;
+    ws2812_trans_fade_init(&sTransition, &lFade);
+
+    for(lFrame = 0; lFrame < inFrames; lFrame++) {
+
+        render(&sAnim[0]);
+        render(&sAnim[1]);
+
+        sTransition.mBase.mfUpdate(&sTransition, panel(&sAnim[0]), panel(&sAnim[1]));
+    }
+
+    stop(&sAnim[0], inType);
+
+    sAnim[0] = sAnim[1];
+}
+
+
+/*! A morph of a stateless animation has to end where a fresh start begins */
+static int check_morph(const ts_morph_type * inType, uint32_t inFrames) {
+
+    int lSecond;
+
+    for(lSecond = 1; lSecond >= 0; lSecond--) {
+
+        start(&sAnim[0], inType, lSecond);
+        render(&sAnim[0]);
+        memcpy(sReference, panel(&sAnim[0]), sizeof(sReference));
+        stop(&sAnim[0], inType);
+
+        start(&sAnim[0], inType, !lSecond);
+        render(&sAnim[0]);
+        change_morph(inType, lSecond, inFrames);
+
+        if(memcmp(sReference, panel(&sAnim[0]), sizeof(sReference)) != 0) {
+            printf("FAIL %s: the morph does not end on the new parameters\n", inType->mName);
+            stop(&sAnim[0], inType);
+            return 1;
+        }
+
+        stop(&sAnim[0], inType);
+    }
+
+    return 0;
+}
+
+
+/*! Every fade has to finish exactly once */
+static int check_restart(const ts_morph_type * inType, uint32_t inFrames) {
+
+    int lChange;
+
+    sTransitionsDone = 0;
+
+    start(&sAnim[0], inType, 0);
+    render(&sAnim[0]);
+
+    for(lChange = 0; lChange < CHANGES; lChange++) {
+        change_restart(inType, !(lChange & 1), inFrames);
+    }
+
+    stop(&sAnim[0], inType);
+
+    if(sTransitionsDone != CHANGES) {
+        printf("FAIL %s: %u of %u fades finished\n", inType->mName, (unsigned)sTransitionsDone, (unsigned)CHANGES);
+        return 1;
+    }
+
+    return 0;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+/*! Best time in ns per frame of CHANGES parameter changes */
+static double measure(const ts_morph_type * inType, void (* infChange)(const ts_morph_type *, int, uint32_t), uint32_t inFrames) {
+
+    uint32_t lSum = 0;
+    int lChange;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        start(&sAnim[0], inType, 0);
+        render(&sAnim[0]);
+
+        lStart = now();
+
+        for(lChange = 0; lChange < CHANGES; lChange++) {
+            infChange(inType, !(lChange & 1), inFrames);
+            lSum += sAnim[0].mBase.mPanel[lChange].G + sTransition.mBase.mPanel[lChange].G;
+        }
+
+        lTime = (now() - lStart) / ((double)CHANGES * inFrames);
+
+        stop(&sAnim[0], inType);
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+    }
+
+    /* the panels have to be used */
+    if(lSum == 0xFFFFFFFF) {
+        printf("\n");
+    }
+
+    return lBest;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    uint32_t lFrames = 100;
+    size_t lCount;
+    double lMorph;
+    double lRestart;
+    int lErrors = 0;
+
+    if(argc > 1) {
+        lFrames = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lFrames == 0) {
+        printf("Usage: %s [<frames>]\n", argv[0]);
+        return -1;
+    }
+
+    for(lCount = 0; lCount < sizeof(sTypes) / sizeof(sTypes[0]); lCount++) {
+
+        if(sTypes[lCount].mStateless) {
+            lErrors += check_morph(&sTypes[lCount], lFrames);
+        }
+
+        lErrors += check_restart(&sTypes[lCount], lFrames);
+    }
+
+    printf("morphs end on the new parameters, fades finish   %s\n\n", lErrors ? "FAIL" : "ok");
+
+    printf("ns per frame over %u frames     morph    restart   restart / morph\n", (unsigned)lFrames);
+
+    for(lCount = 0; lCount < sizeof(sTypes) / sizeof(sTypes[0]); lCount++) {
+
+        lMorph   = measure(&sTypes[lCount], change_morph, lFrames);
+        lRestart = measure(&sTypes[lCount], change_restart, lFrames);
+
+        printf("  %-18s         %8.0f   %8.0f   %8.1f\n", sTypes[lCount].mName, lMorph, lRestart, lRestart / lMorph);
+    }
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
@@ -0,0 +1,470 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "color.h"
+#include "ws2812.h"
+#include "ws2812_draw.h"
+#include "ws2812_particles.h"
+
+#include "mt_arithm.h"
+
+/*  Checks the particle engine and measures it at 100, 500 and 1000 particles
+
+    Usage: particle_bench [<frames>]
+
+    Build it with -DWS2812_PARTICLES_MAX=1000, the firmware pool holds 256.
+    The pool is stepped next to a reference that keeps every particle in a
+    struct of its own, the same particles have to survive with the same
+    values, and the render has to add up to the same panel. A full pool
+    has to refuse more particles. The timing steps and renders <frames>
+    frames of a 5 x 172 panel with the pool refilled to a fixed count, the
+    best of five runs, next to particles allocated with malloc() one by one.
+*/
+
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+/*! Frames of the comparison with the reference */
+#define CHECK_FRAMES        (2000)
+
+
+/*! A particle of the reference */
+typedef struct {
+    int32_t     mX;
+    int32_t     mY;
+    int32_t     mVelocityX;
+    int32_t     mVelocityY;
+    uint8_t     mLife;
+    uint8_t     mColor;
+} ts_particle;
+
+
+static ts_ws2812_particles sPool;
+
+static ts_particle sReference[WS2812_PARTICLES_MAX];
+static size_t sReferenceCount;
+
+/*! Particles of the malloc() version, NULL if free */
+static ts_particle * sAllocated[WS2812_PARTICLES_MAX];
+
+static color sPanel[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+static color sReferencePanel[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+static color sColors[256];
+
+/*! Fireworks, the forces of the particles animation */
+static const ts_ws2812_particle_forces sForces = { .mGravity = 1, .mDrag = 4, .mDecay = 4 };
+
+static uint32_t sSeed = 1;
+
+
+static int32_t random_range(int32_t inMin, int32_t inMax) {
+
+    sSeed = sSeed * 1664525u + 1013904223u;
+
+    return inMin + (int32_t)((sSeed >> 8) % (uint32_t)(inMax - inMin + 1));
+}
+
+
+/*! Random particle, some of them above the top or about to leave */
+static void random_particle(ts_particle * outParticle) {
+
+    outParticle->mX         = random_range(0, (WS2812_NR_COLUMNS << WS2812_PARTICLE_SHIFT) - 1);
+    outParticle->mY         = random_range(-4 * WS2812_PARTICLE_ONE, (WS2812_NR_ROWS << WS2812_PARTICLE_SHIFT) - 1);
+    outParticle->mVelocityX = random_range(-64, 64);
+    outParticle->mVelocityY = random_range(-48, 32);
+    outParticle->mLife      = (uint8_t)random_range(1, 255);
+    outParticle->mColor     = (uint8_t)random_range(0, 255);
+}
+
+
+static int spawn(const ts_particle * inParticle) {
+
+    return ws2812_particles_spawn(&sPool, (int16_t)inParticle->mX, (int16_t)inParticle->mY,
+                                  (int16_t)inParticle->mVelocityX, (int16_t)inParticle->mVelocityY,
+                                  inParticle->mLife, inParticle->mColor);
+}
+
+
+/*! Step of one particle in the reference
+
+    \return false if it died
+*/
+static int reference_step(ts_particle * pParticle) {
+
+    int32_t lLife = (int32_t)pParticle->mLife - sForces.mDecay;
+
+    pParticle->mVelocityY += sForces.mGravity;
+
+    if(sForces.mDrag) {
+        pParticle->mVelocityX -= pParticle->mVelocityX >> sForces.mDrag;
+        pParticle->mVelocityY -= pParticle->mVelocityY >> sForces.mDrag;
+    }
+
+    pParticle->mX += pParticle->mVelocityX;
+    pParticle->mY += pParticle->mVelocityY;
+    pParticle->mLife = (uint8_t)((lLife > 0)? lLife : 0);
+
+    return pParticle->mLife > 0 &&
+           pParticle->mX >= 0 && pParticle->mX < (WS2812_NR_COLUMNS << WS2812_PARTICLE_SHIFT) &&
+           pParticle->mY < (WS2812_NR_ROWS << WS2812_PARTICLE_SHIFT) && pParticle->mY >= INT16_MIN;
+}
+
+
+/*! Render of the reference, every particle on its own, a life of 255 adds the full color */
+static void reference_render(void) {
+
+    const ts_particle * lParticle;
+    color * lLed;
+    uint32_t lValue;
+    size_t lCount;
+
+    memset(sReferencePanel, 0, sizeof(sReferencePanel));
+
+    for(lCount = 0; lCount < sReferenceCount; lCount++) {
+
+        lParticle = &sReference[lCount];
+
+        if(lParticle->mY < 0) {
+            continue;
+        }
+
+        lLed = &sReferencePanel[(lParticle->mY >> WS2812_PARTICLE_SHIFT) * WS2812_NR_COLUMNS + (lParticle->mX >> WS2812_PARTICLE_SHIFT)];
+
+        lValue = lLed->R + (sColors[lParticle->mColor].R * (lParticle->mLife + 1u)) / 256;
+        lLed->R = (uint8_t)((lValue > 255)? 255 : lValue);
+        lValue = lLed->G + (sColors[lParticle->mColor].G * (lParticle->mLife + 1u)) / 256;
+        lLed->G = (uint8_t)((lValue > 255)? 255 : lValue);
+        lValue = lLed->B + (sColors[lParticle->mColor].B * (lParticle->mLife + 1u)) / 256;
+        lLed->B = (uint8_t)((lValue > 255)? 255 : lValue);
+    }
+}
+
+
+static int compare_particles(const void * inFirst, const void * inSecond) {
+
+    return memcmp(inFirst, inSecond, sizeof(ts_particle));
+}
+
+
+/*! The pool has to hold the particles of the reference, in any order */
+static int check_same_particles(uint32_t inFrame) {
+
+    static ts_particle lPool[WS2812_PARTICLES_MAX];
+    static ts_particle lReference[WS2812_PARTICLES_MAX];
+    size_t lCount;
+
+    if(sPool.mCount != sReferenceCount) {
+        printf("FAIL frame %u: %u particles instead of %u\n", (unsigned)inFrame, (unsigned)sPool.mCount, (unsigned)sReferenceCount);
+        return 1;
+    }
+
+    memset(lPool, 0, sizeof(lPool));
+    memset(lReference, 0, sizeof(lReference));
+
+    for(lCount = 0; lCount < sPool.mCount; lCount++) {
+
+        lPool[lCount].mX         = sPool.mX[lCount];
+        lPool[lCount].mY         = sPool.mY[lCount];
+        lPool[lCount].mVelocityX = sPool.mVelocityX[lCount];
+        lPool[lCount].mVelocityY = sPool.mVelocityY[lCount];
+        lPool[lCount].mLife      = sPool.mLife[lCount];
+        lPool[lCount].mColor     = sPool.mColor[lCount];
+
+        lReference[lCount] = sReference[lCount];
+    }
+
+    qsort(lPool, sPool.mCount, sizeof(ts_particle), compare_particles);
+    qsort(lReference, sReferenceCount, sizeof(ts_particle), compare_particles);
+
+    if(memcmp(lPool, lReference, sizeof(ts_particle) * sReferenceCount) != 0) {
+        printf("FAIL frame %u: the particles differ from the reference\n", (unsigned)inFrame);
+        return 1;
+    }
+
+    return 0;
+}
+
+
+static int check_reference(void) {
+
+    ts_ws2812_canvas lCanvas;
+    ts_particle lParticle;
+    uint32_t lFrame;
+    size_t lCount;
+    size_t lSpawn;
+
+    ws2812_canvas_init(&lCanvas, sPanel, WS2812_NR_COLUMNS, WS2812_NR_ROWS, WS2812_NR_COLUMNS);
+
+    ws2812_particles_clear(&sPool);
+    sReferenceCount = 0;
+
+    for(lFrame = 0; lFrame < CHECK_FRAMES; lFrame++) {
+
+        /* bursts, every 50th frame overfills the pool */
+        lSpawn = (lFrame % 50 == 0)? WS2812_PARTICLES_MAX : (size_t)random_range(0, 20);
+
+        for(; lSpawn > 0; lSpawn--) {
+
+            random_particle(&lParticle);
+
+            if(spawn(&lParticle) != (sReferenceCount < WS2812_PARTICLES_MAX)) {
+                printf("FAIL frame %u: spawn with %u particles\n", (unsigned)lFrame, (unsigned)sReferenceCount);
+                return 1;
+            }
+
+            if(sReferenceCount < WS2812_PARTICLES_MAX) {
+                sReference[sReferenceCount++] = lParticle;
+            }
+        }
+
+        /* a dead particle is never added */
+        if(ws2812_particles_spawn(&sPool, 0, 0, 0, 0, 0, 0)) {
+            printf("FAIL frame %u: spawn with life 0\n", (unsigned)lFrame);
+            return 1;
+        }
+
+        ws2812_particles_step(&sPool, &sForces, WS2812_NR_COLUMNS, WS2812_NR_ROWS);
+
+        for(lCount = 0; lCount < sReferenceCount; ) {
+
+            if(reference_step(&sReference[lCount])) {
+                lCount++;
+            } else {
+                sReference[lCount] = sReference[--sReferenceCount];
+            }
+        }
+
+        if(check_same_particles(lFrame)) {
+            return 1;
+        }
+
+        memset(sPanel, 0, sizeof(sPanel));
+        ws2812_particles_render(&sPool, &lCanvas, sColors);
+        reference_render();
+
+        if(memcmp(sPanel, sReferencePanel, sizeof(sPanel)) != 0) {
+            printf("FAIL frame %u: the render differs from the reference\n", (unsigned)lFrame);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+/*! Long living particle, rain falling through the panel */
+static void rain_particle(ts_particle * outParticle) {
+
+    outParticle->mX         = random_range(0, (WS2812_NR_COLUMNS << WS2812_PARTICLE_SHIFT) - 1);
+    outParticle->mY         = random_range(0, (WS2812_NR_ROWS << WS2812_PARTICLE_SHIFT) - 1);
+    outParticle->mVelocityX = random_range(-8, 8);
+    outParticle->mVelocityY = random_range(1, 8);
+    outParticle->mLife      = 255;
+    outParticle->mColor     = (uint8_t)random_range(0, 255);
+}
+
+
+/*! Best time in ns per frame of the pool, refilled to inCount after every step */
+static double measure_pool(size_t inCount, uint32_t inFrames) {
+
+    ts_ws2812_canvas lCanvas;
+    ts_particle lParticle;
+    uint32_t lFrame;
+    uint32_t lSum = 0;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    ws2812_canvas_init(&lCanvas, sPanel, WS2812_NR_COLUMNS, WS2812_NR_ROWS, WS2812_NR_COLUMNS);
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        sSeed = 1;
+        ws2812_particles_clear(&sPool);
+
+        lStart = now();
+
+        for(lFrame = 0; lFrame < inFrames; lFrame++) {
+
+            while(sPool.mCount < inCount) {
+                rain_particle(&lParticle);
+                spawn(&lParticle);
+            }
+
+            ws2812_particles_step(&sPool, &sForces, WS2812_NR_COLUMNS, WS2812_NR_ROWS);
+            memset(sPanel, 0, sizeof(sPanel));
+            ws2812_particles_render(&sPool, &lCanvas, sColors);
+
+            lSum += sPanel[lFrame % (WS2812_NR_ROWS * WS2812_NR_COLUMNS)].G;
+        }
+
+        lTime = (now() - lStart) / inFrames;
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+    }
+
+    /* the panel has to be used */
+    if(lSum == 0xFFFFFFFF) {
+        printf("\n");
+    }
+
+    return lBest;
+}
+
+
+/*! Best time in ns per frame with a malloc() and free() per particle */
+static double measure_malloc(size_t inCount, uint32_t inFrames) {
+
+    ts_particle lParticle;
+    ts_particle * lAllocated;
+    color * lLed;
+    uint32_t lFrame;
+    uint32_t lSum = 0;
+    size_t lCount;
+    size_t lLive;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        sSeed = 1;
+        lLive = 0;
+
+        lStart = now();
+
+        for(lFrame = 0; lFrame < inFrames; lFrame++) {
+
+            for(lCount = 0; lCount < inCount && lLive < inCount; lCount++) {
+
+                if(sAllocated[lCount] == NULL) {
+
+                    rain_particle(&lParticle);
+                    lLive++;
+
+                    sAllocated[lCount] = (ts_particle *)malloc(sizeof(ts_particle));
+
+                    if(sAllocated[lCount] == NULL) {
+                        printf("%s(%d): malloc failed!\r\n", __FILE__, __LINE__);
+                        return 0.0;
+                    }
+
+                    *sAllocated[lCount] = lParticle;
+                }
+            }
+
+            memset(sPanel, 0, sizeof(sPanel));
+
+            for(lCount = 0; lCount < inCount; lCount++) {
+
+                lAllocated = sAllocated[lCount];
+
+                if(lAllocated == NULL) {
+                    continue;
+                }
+
+                if(!reference_step(lAllocated)) {
+                    free(lAllocated);
+                    sAllocated[lCount] = NULL;
+                    lLive--;
+                    continue;
+                }
+
+                if(lAllocated->mY >= 0) {
+
+                    lLed = &sPanel[(lAllocated->mY >> WS2812_PARTICLE_SHIFT) * WS2812_NR_COLUMNS + (lAllocated->mX >> WS2812_PARTICLE_SHIFT)];
+                    lLed->R = add8_c(lLed->R, scale8(sColors[lAllocated->mColor].R, lAllocated->mLife));
+                    lLed->G = add8_c(lLed->G, scale8(sColors[lAllocated->mColor].G, lAllocated->mLife));
+                    lLed->B = add8_c(lLed->B, scale8(sColors[lAllocated->mColor].B, lAllocated->mLife));
+                }
+            }
+
+            lSum += sPanel[lFrame % (WS2812_NR_ROWS * WS2812_NR_COLUMNS)].G;
+        }
+
+        lTime = (now() - lStart) / inFrames;
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+
+        for(lCount = 0; lCount < inCount; lCount++) {
+            free(sAllocated[lCount]);
+            sAllocated[lCount] = NULL;
+        }
+    }
+
+    /* the panel has to be used */
+    if(lSum == 0xFFFFFFFF) {
+        printf("\n");
+    }
+
+    return lBest;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    static const size_t lCounts[] = { 100, 500, 1000 };
+    uint32_t lFrames = 20000;
+    double lTime;
+    size_t lCount;
+    int lErrors = 0;
+
+    if(argc > 1) {
+        lFrames = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lFrames == 0) {
+        printf("Usage: %s [<frames>]\n", argv[0]);
+        return -1;
+    }
+
+    if(WS2812_PARTICLES_MAX < 1000) {
+        printf("Build with -DWS2812_PARTICLES_MAX=1000\n");
+        return -1;
+    }
+
+    for(lCount = 0; lCount < 256; lCount++) {
+        color_set_word(&sColors[lCount], (uint32_t)(lCount * 0x00010307u) ^ 0x00A05F30u);
+    }
+
+    lErrors += check_reference();
+
+    printf("%d frames against the reference   %s\n\n", CHECK_FRAMES, lErrors ? "FAIL" : "ok");
+
+    printf("Particles   ns per frame   ns per particle   malloc per particle\n");
+
+    for(lCount = 0; lCount < sizeof(lCounts) / sizeof(lCounts[0]); lCount++) {
+
+        lTime = measure_pool(lCounts[lCount], lFrames);
+
+        printf("  %4u      %10.0f      %10.2f        %10.2f\n", (unsigned)lCounts[lCount], lTime, lTime / lCounts[lCount],
+               measure_malloc(lCounts[lCount], lFrames) / lCounts[lCount]);
+    }
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
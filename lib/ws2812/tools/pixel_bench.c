@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "color.h"
+#include "color16.h"
+#include "ws2812.h"
+#include "ws2812_draw.h"
+#include "ws2812_anim_obj.h"
+
+/*  Measures the panel kernels in the pixel format it is built with
+
+    Usage: pixel_bench [<frames>]
+
+    Build it once as is and once with -DCOLOR_XRGB and compare the two
+    outputs. Every kernel runs over a 5 x 172 panel, the time is the best
+    of five runs. The checksums are taken over red, green and blue only,
+    so they match between the formats if the kernels compute the same.
+*/
+
+
+/*! Leds of a panel */
+#define LEDS                (WS2812_NR_ROWS * WS2812_NR_COLUMNS)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+
+/*! A kernel run over one panel per frame */
+typedef struct {
+    const char    * mName;
+    const char    * mUse;
+    void         (* mfRun)(uint32_t inFrame);
+} ts_kernel;
+
+
+static color sFrom[LEDS];
+static color sTo[LEDS];
+static color sOut[LEDS];
+static color16 sWide[LEDS];
+static uint8_t sRgb[3 * LEDS];
+static uint16_t sDma[24 * LEDS];
+
+
+static void run_fill(uint32_t inFrame) {
+
+    color_fill(sOut, LEDS, &sFrom[inFrame % LEDS]);
+}
+
+
+static void run_blend(uint32_t inFrame) {
+
+    color_blend(sOut, sFrom, sTo, LEDS, (uint8_t)inFrame);
+}
+
+
+static void run_copy(uint32_t inFrame) {
+
+    memcpy(sOut, (inFrame & 1)? sFrom : sTo, sizeof(sOut));
+}
+
+
+static void run_key(uint32_t inFrame) {
+
+    ts_ws2812_canvas lCanvas;
+    ts_ws2812_canvas lSprite;
+
+    ws2812_canvas_init(&lCanvas, sOut, WS2812_NR_COLUMNS, WS2812_NR_ROWS, WS2812_NR_COLUMNS);
+    ws2812_canvas_init(&lSprite, sTo, WS2812_NR_COLUMNS, WS2812_NR_ROWS, WS2812_NR_COLUMNS);
+
+    ws2812_draw_sprite(&lCanvas, 0, 0, &lSprite, &sFrom[inFrame % LEDS]);
+}
+
+
+static void run_quantize(uint32_t inFrame) {
+
+    size_t lRow;
+
+    for(lRow = 0; lRow < WS2812_NR_ROWS; lRow++) {
+        color16_quantize(&sOut[lRow * WS2812_NR_COLUMNS], &sWide[lRow * WS2812_NR_COLUMNS], WS2812_NR_COLUMNS,
+                         color16_dither_thresholds((uint32_t)lRow, inFrame));
+    }
+}
+
+
+static void run_unpack(uint32_t inFrame) {
+
+    color_unpack(sOut, &sRgb[3 * (inFrame & 1)], LEDS - 1);
+}
+
+
+/*! The loop of fillBuffer() in ws2812.c */
+static void run_encode(uint32_t inFrame) {
+
+    const color * lPanel = (inFrame & 1)? sFrom : sTo;
+    uint16_t * lLedPtr = sDma;
+    uint32_t lGrb;
+    size_t lCount;
+    size_t lBitIndex;
+
+    for(lCount = 0; lCount < LEDS; lCount++, lLedPtr += 24) {
+
+        lGrb = ws2812_color_grb(&lPanel[lCount]);
+
+        for(lBitIndex = 0; lBitIndex < 24; lBitIndex++, lGrb <<= 1) {
+            lLedPtr[lBitIndex] = (lGrb & 0x00800000u)? 58 : 29;
+        }
+    }
+}
+
+
+static const ts_kernel sKernels[] = {
+    { "fill",       "constant color, sprites, clears",  run_fill     },
+    { "blend",      "fade, keyframes, palettes",        run_blend    },
+    { "copy",       "keyframes, zones, strips",         run_copy     },
+    { "key",        "sprites with a key color",         run_key      },
+    { "quantize",   "16 bit blends",                    run_quantize },
+    { "unpack",     "frame sequences",                  run_unpack   },
+    { "encode",     "DMA buffers",                      run_encode   },
+};
+
+
+/*! FNV-1a over the colors of the output, without the filler byte */
+static uint32_t checksum(uint32_t inHash) {
+
+    size_t lCount;
+    uint32_t lWord;
+
+    for(lCount = 0; lCount < LEDS; lCount++) {
+
+        lWord  = color_word(&sOut[lCount]);
+        inHash = (inHash ^ lWord) * 16777619u;
+    }
+
+    for(lCount = 0; lCount < 24 * LEDS; lCount += 7) {
+        inHash = (inHash ^ sDma[lCount]) * 16777619u;
+    }
+
+    return inHash;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    const size_t lPanel = LEDS * sizeof(color);
+    uint32_t lFrames = 20000;
+    uint32_t lSeed = 1;
+    uint32_t lHash;
+    uint32_t lFrame;
+    size_t lCount;
+    size_t lKernel;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest;
+
+    if(argc > 1) {
+        lFrames = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lFrames == 0) {
+        printf("Usage: %s [<frames>]\n", argv[0]);
+        return -1;
+    }
+
+    /* noise with runs, a quarter of the leds has the key color */
+    for(lCount = 0; lCount < LEDS; lCount++) {
+
+        lSeed = lSeed * 1664525u + 1013904223u;
+
+        color_set_word(&sFrom[lCount], lSeed >> 8);
+        color_set_word(&sTo[lCount], (lSeed & 0x300)? (lSeed * 2654435761u) >> 8 : color_word(&sFrom[0]));
+
+        /* 16 bit colors are at most 0xFF00 */
+        sWide[lCount].R = (uint16_t)((lSeed >> 8) % 0xFF01u);
+        sWide[lCount].G = (uint16_t)((lSeed * 31u >> 8) % 0xFF01u);
+        sWide[lCount].B = (uint16_t)((lSeed * 17u >> 8) % 0xFF01u);
+
+        sRgb[3 * lCount]     = (uint8_t)(lSeed >> 24);
+        sRgb[3 * lCount + 1] = (uint8_t)(lSeed >> 16);
+        sRgb[3 * lCount + 2] = (uint8_t)(lSeed >> 8);
+    }
+
+#if defined(COLOR_XRGB)
+    printf("XRGB, %u bytes per led\n\n", (unsigned)sizeof(color));
+#else
+    printf("packed RGB, %u bytes per led\n\n", (unsigned)sizeof(color));
+#endif
+
+    printf("RAM\n");
+    printf("  panel                 %6u bytes\n", (unsigned)lPanel);
+    printf("  fixed panels          %6u bytes  2 animations with strips, transition, composite\n",
+           (unsigned)(4 * lPanel + 2 * WS2812_NR_COLUMNS * sizeof(color)));
+    printf("  animation object      %6u bytes  every zone\n", (unsigned)sizeof(tu_ws2812_anim));
+    printf("  keyframes             %6u bytes  every interpolated animation\n", (unsigned)(3 * lPanel));
+    printf("\n");
+
+    printf("Kernel     ns per panel  checksum  used by\n");
+
+    for(lKernel = 0; lKernel < sizeof(sKernels) / sizeof(sKernels[0]); lKernel++) {
+
+        lBest = 0.0;
+        lHash = 2166136261u;
+
+        for(lRun = 0; lRun < RUNS; lRun++) {
+
+            memset(sOut, 0, sizeof(sOut));
+
+            lStart = now();
+
+            for(lFrame = 0; lFrame < lFrames; lFrame++) {
+                sKernels[lKernel].mfRun(lFrame);
+            }
+
+            lTime = (now() - lStart) / lFrames;
+
+            if(lRun == 0 || lTime < lBest) {
+                lBest = lTime;
+            }
+        }
+
+        lHash = checksum(lHash);
+
+        printf("%-10s %12.0f  %08x  %s\n", sKernels[lKernel].mName, lBest, (unsigned)lHash, sKernels[lKernel].mUse);
+    }
+
+    return 0;
+}
+
+/* eof */
@@ -0,0 +1,444 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ws2812_seq.h"
+
+#include "ff.h"
+#include "diskio.h"
+
+/*  Plays frame sequences from a FAT image on the host
+
+    Usage: seq_bench [-l <us>] [-r <kB/s>] [-t <s>] <image> <sequence.wsq>...
+
+    The image is formatted with FatFs, the sequences are copied to it as
+    SEQ0.WSQ, SEQ1.WSQ, ... and every one is played through FatFs with the
+    read-ahead of the firmware, the loader in a thread of its own:
+
+    - flat out: frames are decoded as soon as they are read, this gives
+      the sustained frames per second of the disk
+    - real time: every frame is decoded when it is due, this gives the
+      worst case latency of a frame
+    - no read-ahead: like real time, but a missing block is read when the
+      frame is due
+
+    Every disk read takes -l us plus its sectors at -r kB/s, by default
+    1000 us and 1000 kB/s like a USB stick on a full speed port.
+*/
+
+
+/*! Sector size of the image */
+#define SECTOR_SIZE         (512)
+
+/*! Size of the image */
+#define IMAGE_SECTORS       (64 * 1024 * 1024 / SECTOR_SIZE)
+
+/*! Cluster size of the image */
+#define CLUSTER_SIZE        (32768)
+
+
+/*! Image and disk timing */
+static int sImage = -1;
+static long sLatency = 1000;
+static long sRate = 1000;
+
+/*! Disk statistics */
+static unsigned long sReads;
+static unsigned long sSectors;
+
+
+/*! Time in us */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e6 + lNow.tv_nsec / 1e3;
+}
+
+
+/*! Wait until a time in us */
+static void wait_until(double inTime) {
+
+    struct timespec lTime;
+
+    lTime.tv_sec  = (time_t)(inTime / 1e6);
+    lTime.tv_nsec = (long)((inTime - lTime.tv_sec * 1e6) * 1e3);
+
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &lTime, NULL) != 0) {
+    }
+}
+
+
+DSTATUS disk_initialize(BYTE drv) {
+
+    return (drv == 0 && sImage >= 0)? 0 : STA_NOINIT;
+}
+
+
+DSTATUS disk_status(BYTE drv) {
+
+    return (drv == 0 && sImage >= 0)? 0 : STA_NOINIT;
+}
+
+
+DRESULT disk_read(BYTE drv, BYTE * buff, DWORD sector, BYTE count) {
+
+    double lDone = now() + sLatency + count * SECTOR_SIZE * 1000.0 / sRate;
+
+    if(drv != 0 || pread(sImage, buff, count * SECTOR_SIZE, (off_t)sector * SECTOR_SIZE) != count * SECTOR_SIZE) {
+        return RES_ERROR;
+    }
+
+    sReads++;
+    sSectors += count;
+
+    wait_until(lDone);
+
+    return RES_OK;
+}
+
+
+DRESULT disk_write(BYTE drv, const BYTE * buff, DWORD sector, BYTE count) {
+
+    if(drv != 0 || pwrite(sImage, buff, count * SECTOR_SIZE, (off_t)sector * SECTOR_SIZE) != count * SECTOR_SIZE) {
+        return RES_ERROR;
+    }
+
+    return RES_OK;
+}
+
+
+DRESULT disk_ioctl(BYTE drv, BYTE ctrl, void * buff) {
+
+    if(drv != 0) {
+        return RES_PARERR;
+    }
+
+    switch(ctrl) {
+        case CTRL_SYNC:
+            return RES_OK;
+        case GET_SECTOR_COUNT:
+            *(DWORD*)buff = IMAGE_SECTORS;
+            return RES_OK;
+        case GET_SECTOR_SIZE:
+            *(WORD*)buff = SECTOR_SIZE;
+            return RES_OK;
+        case GET_BLOCK_SIZE:
+            *(DWORD*)buff = 1;
+            return RES_OK;
+        default:
+            return RES_PARERR;
+    }
+}
+
+
+DWORD get_fattime(void) {
+
+    return 0;
+}
+
+
+/*! Read callback for a FatFs file, as in the firmware */
+static size_t file_read(void * pUser, uint8_t * outData, size_t inLength) {
+
+    UINT lRead;
+
+    if(f_read((FIL*)pUser, outData, (UINT)inLength, &lRead) != FR_OK) {
+        return 0;
+    }
+
+    return lRead;
+}
+
+
+/*! Rewind callback for a FatFs file */
+static bool file_rewind(void * pUser) {
+
+    return f_lseek((FIL*)pUser, 0) == FR_OK;
+}
+
+
+/*! The loader thread and its player */
+typedef struct {
+    pthread_t       mThread;
+    sem_t           mWakeup;
+    volatile int    mStop;
+    ts_ws2812_seq * mSeq;
+    FIL             mFile;
+} loader;
+
+
+/*! Wake callback of the player */
+static void loader_wake(void * pUser) {
+
+    loader * lLoader = (loader*)pUser;
+    int lValue;
+
+    sem_getvalue(&lLoader->mWakeup, &lValue);
+
+    if(lValue == 0) {
+        sem_post(&lLoader->mWakeup);
+    }
+}
+
+
+/*! Loader thread, like ws2812_seq_loader_main() */
+static void * loader_thread(void * pUser) {
+
+    loader * lLoader = (loader*)pUser;
+
+    while(!lLoader->mStop) {
+
+        while(!lLoader->mStop && ws2812_seq_stream_free(&lLoader->mSeq->mStream)) {
+
+            if(!ws2812_seq_stream_fill(&lLoader->mSeq->mStream, file_read, file_rewind, &lLoader->mFile)) {
+                printf("Read failed!\n");
+                return NULL;
+            }
+        }
+
+        sem_wait(&lLoader->mWakeup);
+    }
+
+    return NULL;
+}
+
+
+/*! Play a sequence
+
+    \param[in]  inMode      0 flat out, 1 real time, 2 real time without read-ahead
+*/
+static int play(const char * inPath, int inMode, double inSeconds) {
+
+    static ts_ws2812_seq lSeq;
+    static color lPanel[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+    static const char * const lModes[] = { "flat out", "real time", "no read-ahead" };
+
+    loader lLoader;
+    ts_ws2812_canvas lCanvas;
+    ts_ws2812_span lDirty[WS2812_NR_ROWS];
+    te_ws2812_seq_result lResult;
+    uint32_t lDelay = 0;
+    unsigned long lFrames = 0;
+    unsigned long lLate = 0;
+    double lStart;
+    double lDue;
+    double lLatency;
+    double lWorst = 0.0;
+    double lTotal = 0.0;
+    double lDecode = 0.0;
+    double lAsked;
+    double lBefore;
+
+    memset(&lLoader, 0, sizeof(lLoader));
+    lLoader.mSeq = &lSeq;
+
+    if(f_open(&lLoader.mFile, inPath, FA_READ | FA_OPEN_EXISTING) != FR_OK) {
+        printf("Can't open %s!\n", inPath);
+        return -1;
+    }
+
+    ws2812_seq_init(&lSeq, (inMode < 2)? loader_wake : NULL, &lLoader);
+    ws2812_canvas_init(&lCanvas, lPanel, WS2812_NR_COLUMNS, WS2812_NR_ROWS, WS2812_NR_COLUMNS);
+
+    sReads   = 0;
+    sSectors = 0;
+
+    if(inMode < 2) {
+        sem_init(&lLoader.mWakeup, 0, 0);
+        pthread_create(&lLoader.mThread, NULL, loader_thread, &lLoader);
+    }
+
+    lStart = now();
+    lDue   = lStart;
+
+    while(lDue < lStart + inSeconds * 1e6) {
+
+        if(inMode > 0) {
+            wait_until(lDue);
+        }
+
+        ws2812_spans_clear(lDirty);
+
+        lAsked = now();
+
+        for(;;) {
+
+            lBefore = now();
+            lResult = ws2812_seq_next_frame(&lSeq, &lCanvas, lDirty, &lDelay);
+
+            if(lResult != WS2812_SEQ_WAIT) {
+                lDecode += now() - lBefore;
+                break;
+            }
+
+            if(inMode == 2) {
+                ws2812_seq_stream_fill(&lSeq.mStream, file_read, file_rewind, &lLoader.mFile);
+            } else {
+                sched_yield();
+            }
+        }
+
+        if(lResult == WS2812_SEQ_ERROR) {
+            printf("The sequence is damaged!\n");
+            break;
+        }
+
+        /* the firmware updates every 10 ms, later is visible */
+        lLatency = now() - ((inMode > 0)? lDue : lAsked);
+        lTotal  += lLatency;
+
+        if(lLatency > lWorst) {
+            lWorst = lLatency;
+        }
+
+        if(lLatency > 10000.0) {
+            lLate++;
+        }
+
+        lFrames++;
+        lDue = (inMode > 0)? lDue + lDelay * 10000.0 : now();
+    }
+
+    lTotal /= lFrames;
+    lStart  = now() - lStart;
+
+    if(inMode < 2) {
+        lLoader.mStop = 1;
+        sem_post(&lLoader.mWakeup);
+        pthread_join(lLoader.mThread, NULL);
+        sem_destroy(&lLoader.mWakeup);
+    }
+
+    f_close(&lLoader.mFile);
+
+    printf("  %-13s %7.1f frames/s, latency %7.0f us mean %7.0f us worst, %lu late, decode %.1f us, %lu reads of %.1f sectors\n",
+           lModes[inMode], lFrames / (lStart / 1e6), lTotal, lWorst, lLate, lDecode / lFrames,
+           sReads, sReads? (double)sSectors / sReads : 0.0);
+
+    return 0;
+}
+
+
+/*! Copy a file to the image */
+static int copy(const char * inSource, const char * inPath) {
+
+    static uint8_t lBuffer[65536];
+
+    FILE * lSource;
+    FIL lFile;
+    size_t lLength;
+    UINT lWritten;
+    unsigned long lTotal = 0;
+
+    lSource = fopen(inSource, "rb");
+    if(!lSource) {
+        printf("Could not open input file: %s\n", inSource);
+        return -1;
+    }
+
+    if(f_open(&lFile, inPath, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) {
+        printf("Can't create %s!\n", inPath);
+        return -1;
+    }
+
+    while((lLength = fread(lBuffer, 1, sizeof(lBuffer), lSource)) > 0) {
+
+        if(f_write(&lFile, lBuffer, (UINT)lLength, &lWritten) != FR_OK || lWritten != lLength) {
+            printf("Image is full!\n");
+            return -1;
+        }
+
+        lTotal += lLength;
+    }
+
+    f_close(&lFile);
+    fclose(lSource);
+
+    printf("%s: %s, %lu bytes\n", inPath, inSource, lTotal);
+
+    return 0;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    static FATFS lFs;
+
+    char lPath[32];
+    double lSeconds = 10.0;
+    int lArg = 1;
+    int lCount;
+    int lMode;
+
+    for(; lArg + 1 < argc && argv[lArg][0] == '-'; lArg += 2) {
+
+        if(strcmp(argv[lArg], "-l") == 0) {
+            sLatency = atol(argv[lArg + 1]);
+        } else if(strcmp(argv[lArg], "-r") == 0) {
+            sRate = atol(argv[lArg + 1]);
+        } else if(strcmp(argv[lArg], "-t") == 0) {
+            lSeconds = atof(argv[lArg + 1]);
+        } else {
+            break;
+        }
+    }
+
+    if(argc < lArg + 2 || sLatency < 0 || sRate <= 0 || lSeconds <= 0.0) {
+        printf("Usage: %s [-l <us>] [-r <kB/s>] [-t <s>] <image> <sequence.wsq>...\n", argv[0]);
+        return -1;
+    }
+
+    sImage = open(argv[lArg], O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(sImage < 0 || ftruncate(sImage, (off_t)IMAGE_SECTORS * SECTOR_SIZE) != 0) {
+        perror("Could not create image");
+        return -1;
+    }
+
+    f_mount(0, &lFs);
+
+    if(f_mkfs(0, 1, CLUSTER_SIZE) != FR_OK) {
+        printf("Can't format the image!\n");
+        return -1;
+    }
+
+    for(lCount = 0; lArg + 1 + lCount < argc; lCount++) {
+
+        snprintf(lPath, sizeof(lPath), "SEQ%d.WSQ", lCount);
+
+        if(copy(argv[lArg + 1 + lCount], lPath) != 0) {
+            return -1;
+        }
+    }
+
+    printf("Disk reads take %ld us + %ld kB/s, %d KiB clusters, %.0f s per test\n",
+           sLatency, sRate, CLUSTER_SIZE / 1024, lSeconds);
+
+    for(lCount = 0; lArg + 1 + lCount < argc; lCount++) {
+
+        snprintf(lPath, sizeof(lPath), "SEQ%d.WSQ", lCount);
+        printf("%s:\n", lPath);
+
+        for(lMode = 0; lMode < 3; lMode++) {
+
+            if(play(lPath, lMode, lSeconds) != 0) {
+                return -1;
+            }
+        }
+    }
+
+    close(sImage);
+
+    return 0;
+}
+
+/* eof */
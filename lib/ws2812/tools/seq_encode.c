@@ -0,0 +1,342 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "ws2812_seq.h"
+
+/*  Encodes frames to a frame sequence of ws2812_seq.h
+
+    Usage: seq_encode [-d <delay>] <output.wsq> <frame.ppm>...
+           seq_encode [-d <delay>] -s <width>x<height> <output.wsq> <frames.rgb>
+
+    Frames are PPM images (P6) or one file of raw RGB frames, e.g. from
+    ffmpeg -i clip.mp4 -vf scale=172:5 -f rawvideo -pix_fmt rgb24 clip.rgb
+    Every frame is shown for delay 1/100 s, 4 if not given. Frames equal
+    to the one before only add their delay to it.
+*/
+
+
+/*! Largest frame */
+#define MAX_PIXELS          (WS2812_NR_ROWS * WS2812_NR_COLUMNS)
+
+/*! Longest skip of one operation */
+#define LONG_SKIP_MAX       (64 * 256)
+
+
+typedef struct {
+    uint8_t R;
+    uint8_t G;
+    uint8_t B;
+} rgb;
+
+
+/*! Read the next number of a PPM header, skipping white space and comments */
+static int read_number(FILE * inFile, int * outNumber) {
+
+    int lChar;
+
+    do {
+        lChar = fgetc(inFile);
+
+        if(lChar == '#') {
+            while(lChar != '\n' && lChar != EOF) {
+                lChar = fgetc(inFile);
+            }
+        }
+    } while(lChar != EOF && isspace(lChar));
+
+    if(lChar == EOF || !isdigit(lChar)) {
+        return 0;
+    }
+
+    *outNumber = 0;
+
+    while(lChar != EOF && isdigit(lChar)) {
+        *outNumber = *outNumber * 10 + (lChar - '0');
+        lChar = fgetc(inFile);
+    }
+
+    return 1;
+}
+
+
+/*! Read a binary PPM image of at most MAX_PIXELS
+
+    \return 1 if read, 0 on errors
+*/
+static int read_ppm(const char * inName, rgb * outPixels, int * outWidth, int * outHeight) {
+
+    FILE * lFile;
+    char lMagic[2];
+    int lMax;
+
+    lFile = fopen(inName, "rb");
+    if(!lFile) {
+        printf("Could not open input file: %s\n", inName);
+        return 0;
+    }
+
+    /* a single white space follows the header, read_number() consumed it */
+    if(fread(lMagic, 1, 2, lFile) != 2 || lMagic[0] != 'P' || lMagic[1] != '6' ||
+       !read_number(lFile, outWidth) || !read_number(lFile, outHeight) || !read_number(lFile, &lMax) ||
+       lMax != 255 || *outWidth <= 0 || *outHeight <= 0 || *outWidth * *outHeight > MAX_PIXELS ||
+       fread(outPixels, sizeof(rgb), (size_t)(*outWidth * *outHeight), lFile) != (size_t)(*outWidth * *outHeight)) {
+
+        printf("Not a supported PPM file (P6, 255, at most %d x %d): %s\n", WS2812_NR_COLUMNS, WS2812_NR_ROWS, inName);
+        fclose(lFile);
+        return 0;
+    }
+
+    fclose(lFile);
+
+    return 1;
+}
+
+
+/*! Check if two pixels are equal */
+static int same(const rgb * inFirst, const rgb * inSecond) {
+
+    return inFirst->R == inSecond->R && inFirst->G == inSecond->G && inFirst->B == inSecond->B;
+}
+
+
+/*! Number of equal pixels from inFirst, at most 64 */
+static size_t run_length(const rgb * inFrame, size_t inFirst, size_t inCount) {
+
+    size_t lCount = inFirst + 1;
+
+    while(lCount < inCount && lCount - inFirst < 64 && same(&inFrame[lCount], &inFrame[inFirst])) {
+        lCount++;
+    }
+
+    return lCount - inFirst;
+}
+
+
+/*! Encode the changes from inLast to inFrame
+
+    \return number of bytes in outOps
+*/
+static size_t encode_frame(const rgb * inFrame, const rgb * inLast, size_t inCount, uint8_t * outOps) {
+
+    size_t lOut = 0;
+    size_t lFirst = 0;
+    size_t lCount;
+    size_t lSkip;
+    size_t lLong;
+
+    while(lFirst < inCount) {
+
+        /* unchanged leds */
+        if(same(&inFrame[lFirst], &inLast[lFirst])) {
+
+            for(lCount = lFirst; lCount < inCount && same(&inFrame[lCount], &inLast[lCount]); lCount++) {
+            }
+
+            for(lSkip = lCount - lFirst; lSkip > 64; lSkip -= lLong) {
+
+                lLong = (lSkip > LONG_SKIP_MAX)? LONG_SKIP_MAX : lSkip;
+
+                outOps[lOut++] = (uint8_t)(WS2812_SEQ_OP_LONG_SKIP | ((lLong - 1) >> 8));
+                outOps[lOut++] = (uint8_t)(lLong - 1);
+            }
+
+            if(lSkip > 0) {
+                outOps[lOut++] = (uint8_t)(WS2812_SEQ_OP_SKIP | (lSkip - 1));
+            }
+
+            lFirst = lCount;
+            continue;
+        }
+
+        /* a run of two already saves a byte against a literal */
+        lCount = run_length(inFrame, lFirst, inCount);
+
+        if(lCount >= 2) {
+
+            outOps[lOut++] = (uint8_t)(WS2812_SEQ_OP_RUN | (lCount - 1));
+            memcpy(&outOps[lOut], &inFrame[lFirst], 3);
+            lOut += 3;
+
+            lFirst += lCount;
+            continue;
+        }
+
+        /* changed leds up to the next run or unchanged led */
+        for(lCount = lFirst + 1; lCount < inCount && lCount - lFirst < 64 &&
+            !same(&inFrame[lCount], &inLast[lCount]) && run_length(inFrame, lCount, inCount) < 2; lCount++) {
+        }
+
+        outOps[lOut++] = (uint8_t)(WS2812_SEQ_OP_LITERAL | (lCount - lFirst - 1));
+        memcpy(&outOps[lOut], &inFrame[lFirst], 3 * (lCount - lFirst));
+        lOut += 3 * (lCount - lFirst);
+
+        lFirst = lCount;
+    }
+
+    return lOut;
+}
+
+
+/*! Write a little endian 16 bit number */
+static void put_u16(uint8_t * outData, unsigned inValue) {
+
+    outData[0] = (uint8_t)inValue;
+    outData[1] = (uint8_t)(inValue >> 8);
+}
+
+
+int main(int argc, char * argv[]) {
+
+    static rgb lFrame[MAX_PIXELS];
+    static rgb lLast[MAX_PIXELS];
+    static uint8_t lOps[WS2812_SEQ_FRAME_MAX];
+
+    uint8_t lHeader[WS2812_SEQ_HEADER];
+    uint8_t lFrameHeader[WS2812_SEQ_FRAME_HEADER];
+    FILE * lOutput;
+    FILE * lRaw = NULL;
+    long lLastFrame = -1;
+    unsigned lLastDelay = 0;
+    unsigned lDelay = 4;
+    unsigned long lBytes = WS2812_SEQ_HEADER;
+    int lWidth = 0;
+    int lHeight = 0;
+    int lFrameWidth;
+    int lFrameHeight;
+    int lFrames = 0;
+    int lInputs = 0;
+    int lArg = 1;
+    size_t lLength;
+
+    for(; lArg + 1 < argc && argv[lArg][0] == '-'; lArg += 2) {
+
+        if(strcmp(argv[lArg], "-d") == 0) {
+            lDelay = (unsigned)atoi(argv[lArg + 1]);
+        } else if(strcmp(argv[lArg], "-s") != 0 || sscanf(argv[lArg + 1], "%dx%d", &lWidth, &lHeight) != 2) {
+            break;
+        }
+    }
+
+    if(argc < lArg + 2 || lDelay == 0 || lDelay > 0xFFFF || lWidth < 0 || lHeight < 0 ||
+       lWidth * lHeight > MAX_PIXELS || lWidth > WS2812_NR_COLUMNS || lHeight > WS2812_NR_ROWS) {
+        printf("Usage: %s [-d <delay>] <output.wsq> <frame.ppm>...\n", argv[0]);
+        printf("       %s [-d <delay>] -s <width>x<height> <output.wsq> <frames.rgb>\n", argv[0]);
+        printf("Frames are at most %d x %d, the delay is in 1/100 s\n", WS2812_NR_COLUMNS, WS2812_NR_ROWS);
+        return -1;
+    }
+
+    if(lWidth > 0) {
+
+        lRaw = fopen(argv[lArg + 1], "rb");
+        if(!lRaw) {
+            printf("Could not open input file: %s\n", argv[lArg + 1]);
+            return -1;
+        }
+    }
+
+    lOutput = fopen(argv[lArg], "wb");
+    if(!lOutput) {
+        perror("Could not open output file");
+        return -1;
+    }
+
+    /* the header is written with the number of frames at the end */
+    memset(lHeader, 0, sizeof(lHeader));
+    fwrite(lHeader, 1, sizeof(lHeader), lOutput);
+
+    memset(lLast, 0, sizeof(lLast));
+
+    for(;;) {
+
+        if(lRaw) {
+
+            if(fread(lFrame, sizeof(rgb), (size_t)(lWidth * lHeight), lRaw) != (size_t)(lWidth * lHeight)) {
+                break;
+            }
+
+        } else {
+
+            if(lArg + 1 + lInputs >= argc) {
+                break;
+            }
+
+            if(!read_ppm(argv[lArg + 1 + lInputs], lFrame, &lFrameWidth, &lFrameHeight)) {
+                return -1;
+            }
+
+            if(lInputs == 0) {
+                lWidth  = lFrameWidth;
+                lHeight = lFrameHeight;
+            }
+
+            if(lFrameWidth != lWidth || lFrameHeight != lHeight || lFrameWidth > WS2812_NR_COLUMNS || lFrameHeight > WS2812_NR_ROWS) {
+                printf("Frames have to be of one size up to %d x %d: %s\n", WS2812_NR_COLUMNS, WS2812_NR_ROWS, argv[lArg + 1 + lInputs]);
+                return -1;
+            }
+        }
+
+        lInputs++;
+
+        /* an unchanged frame only extends the one before */
+        if(lLastFrame >= 0 && lLastDelay + lDelay <= 0xFFFF &&
+           memcmp(lFrame, lLast, sizeof(rgb) * (size_t)(lWidth * lHeight)) == 0) {
+
+            lLastDelay += lDelay;
+
+            put_u16(lFrameHeader, lLastDelay);
+            fseek(lOutput, lLastFrame, SEEK_SET);
+            fwrite(lFrameHeader, 1, 2, lOutput);
+            fseek(lOutput, 0, SEEK_END);
+            continue;
+        }
+
+        if(lFrames == 0xFFFF) {
+            printf("Too many frames!\n");
+            return -1;
+        }
+
+        lLength = encode_frame(lFrame, lLast, (size_t)(lWidth * lHeight), lOps);
+
+        lLastFrame = ftell(lOutput);
+        lLastDelay = lDelay;
+
+        put_u16(&lFrameHeader[0], lDelay);
+        put_u16(&lFrameHeader[2], (unsigned)lLength);
+        fwrite(lFrameHeader, 1, sizeof(lFrameHeader), lOutput);
+        fwrite(lOps, 1, lLength, lOutput);
+
+        memcpy(lLast, lFrame, sizeof(rgb) * (size_t)(lWidth * lHeight));
+
+        lBytes += sizeof(lFrameHeader) + lLength;
+        lFrames++;
+    }
+
+    if(lFrames == 0) {
+        printf("No frames!\n");
+        return -1;
+    }
+
+    memcpy(lHeader, "WSQ1", 4);
+    put_u16(&lHeader[4], (unsigned)lWidth);
+    put_u16(&lHeader[6], (unsigned)lHeight);
+    put_u16(&lHeader[8], (unsigned)lFrames);
+
+    fseek(lOutput, 0, SEEK_SET);
+    fwrite(lHeader, 1, sizeof(lHeader), lOutput);
+    fclose(lOutput);
+
+    if(lRaw) {
+        fclose(lRaw);
+    }
+
+    printf("%d x %d, %d inputs, %d frames, %lu bytes, %.1f bytes per input, %.1f%% of raw\n",
+           lWidth, lHeight, lInputs, lFrames, lBytes, (double)lBytes / lInputs,
+           100.0 * lBytes / ((double)lInputs * lWidth * lHeight * 3));
+
+    return 0;
+}
+
+/* eof */
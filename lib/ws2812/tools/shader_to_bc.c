@@ -0,0 +1,796 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "ws2812_vm.h"
+
+#include "mt_trig.h"
+#include "mt_noise.h"
+
+/*  Compiles a shader to a program of ws2812_vm.h
+
+    Usage: shader_to_bc [-b] <shader> [output.hex]
+
+    The program is written as hex, ready to be uploaded. -b runs it on a
+    5 x 172 panel instead and prints the time per frame.
+
+    A shader is a list of assignments and one output as last statement,
+    separated by new lines or ';'. '#' starts a comment.
+
+        v = sin(x * 4 + t / 2) + noise(x * 16, y * 2, t)
+        pal(v / 2)
+
+    Inputs are x and y (0 - 1 over the area), col and row (index) and t
+    (seconds). Operators are + - * / and parentheses, functions sin, cos
+    (a full circle is 1), abs, floor, fract, min, max, sat, clamp, step,
+    mix, noise with two or three coordinates. Outputs are rgb(r, g, b),
+    hsv(h, s, v) and pal(i).
+
+    Expressions of constants are folded, equal expressions computed once.
+    Each value is computed in the outermost section it can: per frame if
+    it only depends on t, per row if it depends on y or row.
+*/
+
+
+/*! Largest number of nodes */
+#define MAX_NODES           (1024)
+
+/*! Largest number of variables */
+#define MAX_VARIABLES       (64)
+
+/*! Node kinds besides the opcodes */
+#define NODE_CONST          (-1)
+#define NODE_INPUT          (-2)
+
+/*! Levels of a node, the section it is computed in */
+#define LEVEL_CONST         (0)
+#define LEVEL_FRAME         (1)
+#define LEVEL_ROW           (2)
+#define LEVEL_PIXEL         (3)
+
+/*! Frames to run for the benchmark */
+#define BENCH_FRAMES        (1000)
+
+
+typedef struct {
+    int         mOp;
+    int         mArg[3];
+    int         mArgs;
+    int         mLevel;
+    int32_t     mValue;
+    int         mRegister;
+    int         mLive;
+    int         mLastUse;
+} node;
+
+
+typedef struct {
+    char        mName[32];
+    int         mNode;
+} variable;
+
+
+typedef struct {
+    const char * mName;
+    int         mOp;
+    int         mArgs;
+} function;
+
+
+/*! Functions mapping to one instruction, clamp is expanded */
+static const function sFunctions[] = {
+    { "sin",    WS2812_VM_OP_SIN,       1 },
+    { "cos",    WS2812_VM_OP_COS,       1 },
+    { "abs",    WS2812_VM_OP_ABS,       1 },
+    { "floor",  WS2812_VM_OP_FLOOR,     1 },
+    { "fract",  WS2812_VM_OP_FRACT,     1 },
+    { "sat",    WS2812_VM_OP_SAT,       1 },
+    { "min",    WS2812_VM_OP_MIN,       2 },
+    { "max",    WS2812_VM_OP_MAX,       2 },
+    { "step",   WS2812_VM_OP_STEP,      2 },
+    { "noise",  WS2812_VM_OP_NOISE2,    2 },
+    { "noise",  WS2812_VM_OP_NOISE3,    3 },
+    { "mix",    WS2812_VM_OP_MIX,       3 },
+    { "rgb",    WS2812_VM_OP_OUT_RGB,   3 },
+    { "hsv",    WS2812_VM_OP_OUT_HSV,   3 },
+    { "pal",    WS2812_VM_OP_OUT_PAL,   1 },
+};
+
+
+static node sNodes[MAX_NODES];
+static int sNodeCount;
+
+static variable sVariables[MAX_VARIABLES];
+static int sVariableCount;
+
+static const char * sSource;
+static int sLine = 1;
+
+
+static void fail(const char * inMessage, const char * inName) {
+
+    printf("Line %d: %s%s%s\n", sLine, inMessage, inName? " " : "", inName? inName : "");
+    exit(-1);
+}
+
+
+/*! Skip white space and comments, new lines end a statement so they are kept */
+static void skip_space(void) {
+
+    while(*sSource) {
+
+        if(*sSource == '#') {
+            while(*sSource && *sSource != '\n') {
+                sSource++;
+            }
+        } else if(*sSource != '\n' && isspace((unsigned char)*sSource)) {
+            sSource++;
+        } else {
+            break;
+        }
+    }
+}
+
+
+static int accept(char inChar) {
+
+    skip_space();
+
+    if(*sSource == inChar) {
+        sSource++;
+        return 1;
+    }
+
+    return 0;
+}
+
+
+static void expect(char inChar) {
+
+    char lName[2] = { inChar, '\0' };
+
+    if(!accept(inChar)) {
+        fail("expected", lName);
+    }
+}
+
+
+static int read_name(char * outName, size_t inSize) {
+
+    size_t lLength = 0;
+
+    skip_space();
+
+    if(!isalpha((unsigned char)*sSource) && *sSource != '_') {
+        return 0;
+    }
+
+    while(isalnum((unsigned char)*sSource) || *sSource == '_') {
+
+        if(lLength + 1 < inSize) {
+            outName[lLength++] = *sSource;
+        }
+        sSource++;
+    }
+
+    outName[lLength] = '\0';
+
+    return 1;
+}
+
+
+/*! Evaluate an instruction on constants, the same way the VM does */
+static int32_t fold(int inOp, const int32_t * inArg) {
+
+    int64_t lValue;
+
+    switch(inOp) {
+        case WS2812_VM_OP_ADD:      return inArg[0] + inArg[1];
+        case WS2812_VM_OP_SUB:      return inArg[0] - inArg[1];
+        case WS2812_VM_OP_MUL:      return (int32_t)(((int64_t)inArg[0] * inArg[1]) >> 16);
+        case WS2812_VM_OP_DIV:
+            if(inArg[1] == 0) {
+                return (inArg[0] < 0)? INT32_MIN : INT32_MAX;
+            }
+            lValue = ((int64_t)inArg[0] * WS2812_VM_ONE) / inArg[1];
+            return (lValue > INT32_MAX)? INT32_MAX : (lValue < INT32_MIN)? INT32_MIN : (int32_t)lValue;
+        case WS2812_VM_OP_NEG:      return -inArg[0];
+        case WS2812_VM_OP_ABS:      return (inArg[0] < 0)? -inArg[0] : inArg[0];
+        case WS2812_VM_OP_FLOOR:    return inArg[0] & ~(WS2812_VM_ONE - 1);
+        case WS2812_VM_OP_FRACT:    return inArg[0] & (WS2812_VM_ONE - 1);
+        case WS2812_VM_OP_MIN:      return (inArg[0] < inArg[1])? inArg[0] : inArg[1];
+        case WS2812_VM_OP_MAX:      return (inArg[0] > inArg[1])? inArg[0] : inArg[1];
+        case WS2812_VM_OP_SAT:      return (inArg[0] < 0)? 0 : (inArg[0] > WS2812_VM_ONE)? WS2812_VM_ONE : inArg[0];
+        case WS2812_VM_OP_STEP:     return (inArg[1] >= inArg[0])? WS2812_VM_ONE : 0;
+        case WS2812_VM_OP_SIN:      return sin16((uint16_t)inArg[0]) * 2;
+        case WS2812_VM_OP_COS:      return cos16((uint16_t)inArg[0]) * 2;
+        case WS2812_VM_OP_NOISE2:   return noise8_2d((uint16_t)(inArg[0] >> 8), (uint16_t)(inArg[1] >> 8)) << 8;
+        case WS2812_VM_OP_NOISE3:   return noise8_3d((uint16_t)(inArg[0] >> 8), (uint16_t)(inArg[1] >> 8), (uint16_t)(inArg[2] >> 8)) << 8;
+        case WS2812_VM_OP_MIX:      return inArg[0] + (int32_t)(((int64_t)(inArg[1] - inArg[0]) * inArg[2]) >> 16);
+        default:                    return 0;
+    }
+}
+
+
+static int add_node(int inOp, int inArgs, const int * inArg, int32_t inValue, int inLevel) {
+
+    node * lNode;
+    int lCount;
+
+    if(sNodeCount == MAX_NODES) {
+        fail("shader too long", NULL);
+    }
+
+    lNode = &sNodes[sNodeCount];
+    memset(lNode, 0, sizeof(*lNode));
+
+    lNode->mOp      = inOp;
+    lNode->mArgs    = inArgs;
+    lNode->mValue   = inValue;
+    lNode->mLevel   = inLevel;
+    lNode->mRegister = -1;
+
+    for(lCount = 0; lCount < inArgs; lCount++) {
+        lNode->mArg[lCount] = inArg[lCount];
+    }
+
+    return sNodeCount++;
+}
+
+
+static int make_const(int32_t inValue) {
+
+    int lCount;
+
+    for(lCount = 0; lCount < sNodeCount; lCount++) {
+        if(sNodes[lCount].mOp == NODE_CONST && sNodes[lCount].mValue == inValue) {
+            return lCount;
+        }
+    }
+
+    return add_node(NODE_CONST, 0, NULL, inValue, LEVEL_CONST);
+}
+
+
+/*! Make an instruction node, folds constants and reuses equal nodes */
+static int make_op(int inOp, int inArgs, const int * inArg) {
+
+    int32_t lValues[3];
+    int lLevel = LEVEL_FRAME;
+    int lConst = 1;
+    int lCount;
+
+    for(lCount = 0; lCount < inArgs; lCount++) {
+
+        const node * lArg = &sNodes[inArg[lCount]];
+
+        if(lArg->mOp != NODE_CONST) {
+            lConst = 0;
+        }
+        if(lArg->mLevel > lLevel) {
+            lLevel = lArg->mLevel;
+        }
+
+        lValues[lCount] = lArg->mValue;
+    }
+
+    /* outputs run per pixel */
+    if(inOp >= WS2812_VM_OP_OUT_RGB) {
+        lLevel = LEVEL_PIXEL;
+    } else if(lConst) {
+        return make_const(fold(inOp, lValues));
+    }
+
+    for(lCount = 0; lCount < sNodeCount; lCount++) {
+
+        const node * lNode = &sNodes[lCount];
+
+        if(lNode->mOp == inOp && lNode->mArgs == inArgs &&
+           memcmp(lNode->mArg, inArg, inArgs * sizeof(int)) == 0) {
+            return lCount;
+        }
+    }
+
+    return add_node(inOp, inArgs, inArg, 0, lLevel);
+}
+
+
+static int make_binary(int inOp, int inA, int inB) {
+
+    int lArg[2] = { inA, inB };
+
+    return make_op(inOp, 2, lArg);
+}
+
+
+static int parse_expr(void);
+
+
+static int parse_number(void) {
+
+    double lValue = strtod(sSource, (char**)&sSource);
+
+    if(lValue > 32767.0 || lValue < -32768.0) {
+        fail("number out of range", NULL);
+    }
+
+    return make_const((int32_t)(lValue * WS2812_VM_ONE + ((lValue < 0)? -0.5 : 0.5)));
+}
+
+
+static int parse_call(const char * inName) {
+
+    int lArg[3];
+    int lArgs = 0;
+    size_t lCount;
+
+    if(!accept(')')) {
+        do {
+            if(lArgs == 3) {
+                fail("too many arguments for", inName);
+            }
+            lArg[lArgs++] = parse_expr();
+        } while(accept(','));
+
+        expect(')');
+    }
+
+    if(strcmp(inName, "clamp") == 0 && lArgs == 3) {
+        return make_binary(WS2812_VM_OP_MIN, make_binary(WS2812_VM_OP_MAX, lArg[0], lArg[1]), lArg[2]);
+    }
+
+    for(lCount = 0; lCount < sizeof(sFunctions) / sizeof(sFunctions[0]); lCount++) {
+
+        if(strcmp(inName, sFunctions[lCount].mName) == 0 && lArgs == sFunctions[lCount].mArgs) {
+            return make_op(sFunctions[lCount].mOp, lArgs, lArg);
+        }
+    }
+
+    fail("unknown function or wrong number of arguments:", inName);
+    return -1;
+}
+
+
+static int parse_primary(void) {
+
+    char lName[32];
+    int lCount;
+
+    skip_space();
+
+    if(accept('(')) {
+
+        int lNode = parse_expr();
+
+        expect(')');
+        return lNode;
+    }
+
+    if(isdigit((unsigned char)*sSource) || *sSource == '.') {
+        return parse_number();
+    }
+
+    if(!read_name(lName, sizeof(lName))) {
+        fail("expected a value", NULL);
+    }
+
+    if(accept('(')) {
+        return parse_call(lName);
+    }
+
+    for(lCount = sVariableCount - 1; lCount >= 0; lCount--) {
+        if(strcmp(sVariables[lCount].mName, lName) == 0) {
+            return sVariables[lCount].mNode;
+        }
+    }
+
+    fail("unknown name", lName);
+    return -1;
+}
+
+
+static int parse_unary(void) {
+
+    if(accept('-')) {
+
+        int lArg = parse_unary();
+
+        return make_op(WS2812_VM_OP_NEG, 1, &lArg);
+    }
+
+    return parse_primary();
+}
+
+
+static int parse_term(void) {
+
+    int lNode = parse_unary();
+
+    for(;;) {
+        if(accept('*')) {
+            lNode = make_binary(WS2812_VM_OP_MUL, lNode, parse_unary());
+        } else if(accept('/')) {
+            lNode = make_binary(WS2812_VM_OP_DIV, lNode, parse_unary());
+        } else {
+            return lNode;
+        }
+    }
+}
+
+
+static int parse_expr(void) {
+
+    int lNode = parse_term();
+
+    for(;;) {
+        if(accept('+')) {
+            lNode = make_binary(WS2812_VM_OP_ADD, lNode, parse_term());
+        } else if(accept('-')) {
+            lNode = make_binary(WS2812_VM_OP_SUB, lNode, parse_term());
+        } else {
+            return lNode;
+        }
+    }
+}
+
+
+static void add_variable(const char * inName, int inNode) {
+
+    if(sVariableCount == MAX_VARIABLES) {
+        fail("too many variables", NULL);
+    }
+
+    snprintf(sVariables[sVariableCount].mName, sizeof(sVariables[0].mName), "%s", inName);
+    sVariables[sVariableCount].mNode = inNode;
+    sVariableCount++;
+}
+
+
+static void add_input(const char * inName, int inRegister, int inLevel) {
+
+    int lNode = add_node(NODE_INPUT, 0, NULL, 0, inLevel);
+
+    sNodes[lNode].mRegister = inRegister;
+
+    add_variable(inName, lNode);
+}
+
+
+/*! Parse the shader, \return the output node */
+static int parse(void) {
+
+    int lOutput = -1;
+
+    add_input("x",   WS2812_VM_REG_X,      LEVEL_PIXEL);
+    add_input("col", WS2812_VM_REG_COLUMN, LEVEL_PIXEL);
+    add_input("y",   WS2812_VM_REG_Y,      LEVEL_ROW);
+    add_input("row", WS2812_VM_REG_ROW,    LEVEL_ROW);
+    add_input("t",   WS2812_VM_REG_T,      LEVEL_FRAME);
+
+    for(;;) {
+
+        const char * lStart;
+        char lName[32];
+
+        skip_space();
+
+        if(*sSource == '\0') {
+            break;
+        }
+
+        if(accept('\n') || accept(';')) {
+            if(sSource[-1] == '\n') {
+                sLine++;
+            }
+            continue;
+        }
+
+        if(lOutput >= 0) {
+            fail("the output has to be the last statement", NULL);
+        }
+
+        lStart = sSource;
+
+        if(!read_name(lName, sizeof(lName))) {
+            fail("expected a statement", NULL);
+        }
+
+        if(accept('=')) {
+
+            add_variable(lName, parse_expr());
+
+        } else {
+
+            sSource = lStart;
+            lOutput = parse_expr();
+
+            if(sNodes[lOutput].mOp < WS2812_VM_OP_OUT_RGB) {
+                fail("expected rgb(), hsv() or pal() as output", NULL);
+            }
+        }
+
+        skip_space();
+        if(*sSource != '\0' && *sSource != '\n' && *sSource != ';') {
+            fail("unexpected", sSource);
+        }
+    }
+
+    if(lOutput < 0) {
+        fail("no output", NULL);
+    }
+
+    return lOutput;
+}
+
+
+/*! Program being built */
+static uint8_t sProgram[WS2812_VM_PROGRAM_MAX];
+static ts_ws2812_vm_instr sCode[3][WS2812_VM_PROGRAM_MAX / 4];
+static int sCodeCount[3];
+
+
+static void emit(int inSection, int inOp, int inDst, int inA, int inB) {
+
+    ts_ws2812_vm_instr * lInstr;
+
+    if(sCodeCount[inSection] == WS2812_VM_PROGRAM_MAX / 4) {
+        fail("program too long", NULL);
+    }
+
+    lInstr = &sCode[inSection][sCodeCount[inSection]++];
+
+    lInstr->mOp  = (uint8_t)inOp;
+    lInstr->mDst = (uint8_t)inDst;
+    lInstr->mA   = (uint8_t)inA;
+    lInstr->mB   = (uint8_t)inB;
+}
+
+
+static void mark_live(int inNode, int inUser) {
+
+    node * lNode = &sNodes[inNode];
+    int lCount;
+
+    if(inUser > lNode->mLastUse) {
+        lNode->mLastUse = inUser;
+    }
+
+    if(lNode->mLive) {
+        return;
+    }
+
+    lNode->mLive = 1;
+
+    for(lCount = 0; lCount < lNode->mArgs; lCount++) {
+        mark_live(lNode->mArg[lCount], inNode);
+    }
+}
+
+
+/*! Generate the code, \return the program length */
+static size_t generate(int inOutput) {
+
+    int lUsed[WS2812_VM_REGISTERS] = { 0 };
+    int32_t lConstants[WS2812_VM_REGISTERS];
+    int lConstantCount = 0;
+    int lNext;
+    int lSection;
+    int lCount;
+    int lArg;
+    size_t lLength;
+
+    mark_live(inOutput, inOutput);
+
+    lNext = WS2812_VM_REG_CONSTANTS;
+
+    /* constants first, they are loaded once */
+    for(lCount = 0; lCount < sNodeCount; lCount++) {
+
+        node * lNode = &sNodes[lCount];
+
+        if(lNode->mLive && lNode->mOp == NODE_CONST) {
+
+            lConstants[lConstantCount++] = lNode->mValue;
+            lNode->mRegister = lNext++;
+
+            if(lNext > WS2812_VM_REGISTERS) {
+                fail("too many constants", NULL);
+            }
+        }
+    }
+
+    for(lCount = 0; lCount < lNext; lCount++) {
+        lUsed[lCount] = 1;
+    }
+
+    /* section by section, so the values of the outer sections have their
+       registers before the pixel section reuses the free ones; within a
+       section the nodes are in dependency order, arguments come first */
+    for(lSection = 0; lSection < 3; lSection++)
+    for(lCount = 0; lCount < sNodeCount; lCount++) {
+
+        node * lNode = &sNodes[lCount];
+        int lRegisters[3] = { 0, 0, 0 };
+
+        if(!lNode->mLive || lNode->mOp < 0 || lNode->mLevel - LEVEL_FRAME != lSection) {
+            continue;
+        }
+
+        for(lArg = 0; lArg < lNode->mArgs; lArg++) {
+            lRegisters[lArg] = sNodes[lNode->mArg[lArg]].mRegister;
+        }
+
+        if(lNode->mOp >= WS2812_VM_OP_OUT_RGB) {
+
+            emit(lSection, lNode->mOp, lRegisters[2], lRegisters[0], lRegisters[1]);
+
+        } else {
+
+            /* values of the outer sections are kept, pixel values only until their last use */
+            for(lNode->mRegister = 0; lNode->mRegister < WS2812_VM_REGISTERS && lUsed[lNode->mRegister]; lNode->mRegister++) {
+            }
+
+            if(lNode->mRegister == WS2812_VM_REGISTERS) {
+                fail("shader needs too many registers", NULL);
+            }
+
+            lUsed[lNode->mRegister] = 1;
+
+            /* the third source is read from the destination */
+            if(lNode->mArgs == 3) {
+                emit(lSection, WS2812_VM_OP_MOV, lNode->mRegister, lRegisters[2], 0);
+            }
+
+            emit(lSection, lNode->mOp, lNode->mRegister, lRegisters[0], lRegisters[1]);
+        }
+
+        for(lArg = 0; lArg < lNode->mArgs; lArg++) {
+
+            node * lSource = &sNodes[lNode->mArg[lArg]];
+
+            if(lSource->mOp >= 0 && lSource->mLevel == LEVEL_PIXEL && lSource->mLastUse == lCount) {
+                lUsed[lSource->mRegister] = 0;
+            }
+        }
+    }
+
+    for(lCount = 0; lCount < 3; lCount++) {
+        emit(lCount, WS2812_VM_OP_END, 0, 0, 0);
+    }
+
+    /* header */
+    memcpy(sProgram, "WSVM", 4);
+    sProgram[4]  = WS2812_VM_VERSION;
+    sProgram[5]  = (uint8_t)lConstantCount;
+    for(lCount = 0; lCount < 3; lCount++) {
+        sProgram[6 + 2 * lCount] = (uint8_t)sCodeCount[lCount];
+        sProgram[7 + 2 * lCount] = (uint8_t)(sCodeCount[lCount] >> 8);
+    }
+    memset(&sProgram[12], 0, 4);
+
+    lLength = WS2812_VM_HEADER_SIZE + 4 * lConstantCount +
+              sizeof(ts_ws2812_vm_instr) * (sCodeCount[0] + sCodeCount[1] + sCodeCount[2]);
+
+    if(lLength > WS2812_VM_PROGRAM_MAX) {
+        fail("program too long", NULL);
+    }
+
+    for(lCount = 0; lCount < lConstantCount; lCount++) {
+
+        uint32_t lValue = (uint32_t)lConstants[lCount];
+
+        sProgram[WS2812_VM_HEADER_SIZE + 4 * lCount + 0] = (uint8_t)lValue;
+        sProgram[WS2812_VM_HEADER_SIZE + 4 * lCount + 1] = (uint8_t)(lValue >> 8);
+        sProgram[WS2812_VM_HEADER_SIZE + 4 * lCount + 2] = (uint8_t)(lValue >> 16);
+        sProgram[WS2812_VM_HEADER_SIZE + 4 * lCount + 3] = (uint8_t)(lValue >> 24);
+    }
+
+    lNext = WS2812_VM_HEADER_SIZE + 4 * lConstantCount;
+
+    for(lCount = 0; lCount < 3; lCount++) {
+
+        memcpy(&sProgram[lNext], sCode[lCount], sCodeCount[lCount] * sizeof(ts_ws2812_vm_instr));
+        lNext += sCodeCount[lCount] * sizeof(ts_ws2812_vm_instr);
+    }
+
+    return lLength;
+}
+
+
+/*! Run the program on the host and print the time per frame */
+static int bench(size_t inLength) {
+
+    static uint32_t lProgram[WS2812_VM_PROGRAM_MAX / 4];
+    static color lPanel[5 * 172];
+    static ts_ws2812_vm lVm;
+
+    struct timespec lStart;
+    struct timespec lEnd;
+    double lNanoseconds;
+    int lFrame;
+
+    memcpy(lProgram, sProgram, inLength);
+
+    if(!ws2812_vm_load(&lVm, lProgram, inLength, color_palette_from_enum(COLOR_PALETTE_RAINBOW))) {
+        printf("Program does not load!\n");
+        return -1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &lStart);
+
+    for(lFrame = 0; lFrame < BENCH_FRAMES; lFrame++) {
+        ws2812_vm_run(&lVm, lPanel, 5, 172, 172, lFrame * (WS2812_VM_ONE / 100));
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &lEnd);
+
+    lNanoseconds = (lEnd.tv_sec - lStart.tv_sec) * 1e9 + (lEnd.tv_nsec - lStart.tv_nsec);
+
+    printf("%u bytes, %d frame, %d row and %d pixel instructions\n",
+           (unsigned)inLength, sCodeCount[0], sCodeCount[1], sCodeCount[2]);
+    printf("%d instructions per frame, %.1f us per frame, %.2f ns per instruction\n",
+           sCodeCount[0] + 5 * sCodeCount[1] + 5 * 172 * sCodeCount[2],
+           lNanoseconds / BENCH_FRAMES / 1000.0,
+           lNanoseconds / BENCH_FRAMES / (sCodeCount[0] + 5 * sCodeCount[1] + 5 * 172 * sCodeCount[2]));
+
+    return 0;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    static char lSource[65536];
+
+    FILE * lFile;
+    size_t lLength;
+    size_t lCount;
+    int lBench = 0;
+    int lArg = 1;
+
+    if(argc > lArg && strcmp(argv[lArg], "-b") == 0) {
+        lBench = 1;
+        lArg++;
+    }
+
+    if(argc <= lArg) {
+        printf("Usage: %s [-b] <shader> [output.hex]\n", argv[0]);
+        return -1;
+    }
+
+    lFile = fopen(argv[lArg], "r");
+    if(!lFile) {
+        printf("Could not open input file: %s\n", argv[lArg]);
+        return -1;
+    }
+
+    lLength = fread(lSource, 1, sizeof(lSource) - 1, lFile);
+    lSource[lLength] = '\0';
+    fclose(lFile);
+
+    sSource = lSource;
+    lLength = generate(parse());
+
+    if(lBench) {
+        return bench(lLength);
+    }
+
+    lFile = (argc > lArg + 1)? fopen(argv[lArg + 1], "w") : stdout;
+    if(!lFile) {
+        perror("Could not open output file");
+        return -1;
+    }
+
+    for(lCount = 0; lCount < lLength; lCount++) {
+        fprintf(lFile, "%02x", sProgram[lCount]);
+    }
+    fprintf(lFile, "\n");
+
+    if(lFile != stdout) {
+        fclose(lFile);
+    }
+
+    return 0;
+}
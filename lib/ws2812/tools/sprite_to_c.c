@@ -0,0 +1,312 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/*  Converts PPM images (P3 or P6) to run length encoded sprites for
+    ws2812_draw_sprite_rle(). Magenta (#FF00FF) is transparent.
+
+    Usage: sprite_to_c <output.c> <image.ppm>...
+*/
+
+
+/*! Largest supported image */
+#define MAX_PIXELS          (65536)
+
+/*! Colors of a sprite with one byte runs, one index is transparent */
+#define RLE4_COLORS         (15)
+
+/*! Colors of a sprite with two byte runs, one index is transparent */
+#define RLE8_COLORS         (255)
+
+
+typedef struct {
+    uint8_t R;
+    uint8_t G;
+    uint8_t B;
+} rgb;
+
+
+/*! Read the next number of a PPM header, skipping white space and comments */
+static int read_number(FILE * inFile, int * outNumber) {
+
+    int lChar;
+
+    do {
+        lChar = fgetc(inFile);
+
+        if(lChar == '#') {
+            while(lChar != '\n' && lChar != EOF) {
+                lChar = fgetc(inFile);
+            }
+        }
+    } while(lChar != EOF && isspace(lChar));
+
+    if(lChar == EOF || !isdigit(lChar)) {
+        return 0;
+    }
+
+    *outNumber = 0;
+
+    while(lChar != EOF && isdigit(lChar)) {
+        *outNumber = *outNumber * 10 + (lChar - '0');
+        lChar = fgetc(inFile);
+    }
+
+    return 1;
+}
+
+
+/*! Read a PPM image
+
+    \return number of pixels, 0 on errors
+*/
+static int read_ppm(const char * inName, rgb * outPixels, int * outWidth, int * outHeight) {
+
+    FILE * lFile;
+    char lMagic[2];
+    int lMax;
+    int lCount;
+    int lValue[3];
+    int lChannel;
+
+    lFile = fopen(inName, "rb");
+    if(!lFile) {
+        printf("Could not open input file: %s\n", inName);
+        return 0;
+    }
+
+    if(fread(lMagic, 1, 2, lFile) != 2 || lMagic[0] != 'P' || (lMagic[1] != '3' && lMagic[1] != '6') ||
+       !read_number(lFile, outWidth) || !read_number(lFile, outHeight) || !read_number(lFile, &lMax) ||
+       lMax <= 0 || lMax > 255 || *outWidth <= 0 || *outHeight <= 0 || *outWidth * *outHeight > MAX_PIXELS) {
+
+        printf("Not a supported PPM file: %s\n", inName);
+        fclose(lFile);
+        return 0;
+    }
+
+    /* a single white space follows the header of binary files, read_number() consumed it */
+    for(lCount = 0; lCount < *outWidth * *outHeight; lCount++) {
+
+        for(lChannel = 0; lChannel < 3; lChannel++) {
+
+            if(lMagic[1] == '6') {
+                lValue[lChannel] = fgetc(lFile);
+            } else if(!read_number(lFile, &lValue[lChannel])) {
+                lValue[lChannel] = EOF;
+            }
+
+            if(lValue[lChannel] == EOF) {
+                printf("File is too short: %s\n", inName);
+                fclose(lFile);
+                return 0;
+            }
+
+            lValue[lChannel] = (lValue[lChannel] * 255 + lMax / 2) / lMax;
+        }
+
+        outPixels[lCount].R = (uint8_t)lValue[0];
+        outPixels[lCount].G = (uint8_t)lValue[1];
+        outPixels[lCount].B = (uint8_t)lValue[2];
+    }
+
+    fclose(lFile);
+
+    return lCount;
+}
+
+
+/*! Make a C identifier from the file name without path and extension */
+static void sprite_name(char * outName, size_t inSize, const char * inFile) {
+
+    const char * lStart = strrchr(inFile, '/');
+    size_t lCount;
+
+    lStart = lStart? lStart + 1 : inFile;
+
+    for(lCount = 0; lCount + 1 < inSize && lStart[lCount] && lStart[lCount] != '.'; lCount++) {
+        outName[lCount] = isalnum((unsigned char)lStart[lCount])? lStart[lCount] : '_';
+    }
+
+    outName[lCount] = '\0';
+}
+
+
+int main(int argc, char * argv[]) {
+
+    static rgb lPixels[MAX_PIXELS];
+    static rgb lPalette[RLE8_COLORS];
+    static uint8_t lIndices[MAX_PIXELS];
+    static uint8_t lRuns[2 * MAX_PIXELS];
+
+    FILE * lOutputFile;
+    char lName[64];
+    int lCount;
+
+    if(argc < 2) {
+        printf("Output file missing!\n");
+        return -1;
+    }
+
+    lOutputFile = fopen(argv[1], "w");
+
+    if(!lOutputFile) {
+        perror ("Could not open output file");
+        return -1;
+    }
+
+    fprintf(lOutputFile, "/* generated by tools/sprite_to_c, don't edit */\n");
+    fprintf(lOutputFile, "\n");
+    fprintf(lOutputFile, "#include \"ws2812_sprite.h\"\n");
+
+    for(lCount = 2; lCount < argc; lCount++) {
+
+        int lWidth;
+        int lHeight;
+        int lPixelCount;
+        int lColors = 0;
+        int lTransparent;
+        int lFormat;
+        int lRow;
+        int lColumn;
+        int lIndex;
+        int lLength;
+        size_t lRunBytes = 0;
+        size_t lFlash;
+
+        printf("Processing file \"%s\"\n", argv[lCount]);
+
+        /* every file given ends up in gWs2812Sprites, so errors stop here */
+        lPixelCount = read_ppm(argv[lCount], lPixels, &lWidth, &lHeight);
+        if(lPixelCount == 0) {
+            fclose(lOutputFile);
+            return -1;
+        }
+
+        /* palette, magenta is transparent */
+        for(lIndex = 0; lIndex < lPixelCount; lIndex++) {
+
+            int lEntry;
+
+            if(lPixels[lIndex].R == 0xFF && lPixels[lIndex].G == 0x00 && lPixels[lIndex].B == 0xFF) {
+                lIndices[lIndex] = 0xFF;
+                continue;
+            }
+
+            for(lEntry = 0; lEntry < lColors; lEntry++) {
+                if(memcmp(&lPalette[lEntry], &lPixels[lIndex], sizeof(rgb)) == 0) {
+                    break;
+                }
+            }
+
+            if(lEntry == lColors) {
+
+                if(lColors == RLE8_COLORS) {
+                    break;
+                }
+
+                lPalette[lColors++] = lPixels[lIndex];
+            }
+
+            lIndices[lIndex] = (uint8_t)lEntry;
+        }
+
+        if(lIndex < lPixelCount) {
+            printf("More than %d colors in %s\n", RLE8_COLORS, argv[lCount]);
+            fclose(lOutputFile);
+            return -1;
+        }
+
+        lFormat      = (lColors <= RLE4_COLORS)? 4 : 8;
+        lTransparent = (lFormat == 4)? 0x0F : 0xFF;
+        lRunBytes    = 0;
+
+        sprite_name(lName, sizeof(lName), argv[lCount]);
+
+        fprintf(lOutputFile, "\n\n");
+        fprintf(lOutputFile, "/* %s */\n", argv[lCount]);
+        fprintf(lOutputFile, "static const uint16_t sRows_%s[] = {\n   ", lName);
+
+        for(lRow = 0; lRow < lHeight; lRow++) {
+
+            fprintf(lOutputFile, " %u,", (unsigned)lRunBytes);
+
+            for(lColumn = 0; lColumn < lWidth; lColumn += lLength) {
+
+                lIndex = lIndices[lRow * lWidth + lColumn];
+                if(lIndex == 0xFF) {
+                    lIndex = lTransparent;
+                }
+
+                /* runs end at the row end and at the longest length of the format */
+                for(lLength = 1; lColumn + lLength < lWidth && lLength < ((lFormat == 4)? 16 : 256); lLength++) {
+
+                    int lNext = lIndices[lRow * lWidth + lColumn + lLength];
+
+                    if(((lNext == 0xFF)? lTransparent : lNext) != lIndex) {
+                        break;
+                    }
+                }
+
+                if(lFormat == 4) {
+                    lRuns[lRunBytes++] = (uint8_t)(((lLength - 1) << 4) | lIndex);
+                } else {
+                    lRuns[lRunBytes++] = (uint8_t)(lLength - 1);
+                    lRuns[lRunBytes++] = (uint8_t)lIndex;
+                }
+            }
+        }
+
+        fprintf(lOutputFile, "\n};\n\n");
+        fprintf(lOutputFile, "static const uint8_t sRuns_%s[] = {", lName);
+
+        for(lIndex = 0; lIndex < (int)lRunBytes; lIndex++) {
+            fprintf(lOutputFile, "%s0x%02x,", (lIndex % 12 == 0)? "\n    " : " ", lRuns[lIndex]);
+        }
+
+        fprintf(lOutputFile, "\n};\n\n");
+        fprintf(lOutputFile, "static const color sPalette_%s[] = {\n", lName);
+
+        for(lIndex = 0; lIndex < lColors; lIndex++) {
+            fprintf(lOutputFile, "    { .R = 0x%02x, .G = 0x%02x, .B = 0x%02x },\n",
+                    lPalette[lIndex].R, lPalette[lIndex].G, lPalette[lIndex].B);
+        }
+
+        fprintf(lOutputFile, "};\n\n");
+
+        lFlash = lRunBytes + 2 * (size_t)lHeight + 3 * (size_t)lColors;
+
+        fprintf(lOutputFile, "/* %dx%d, %d colors, %u bytes of data, %u bytes uncompressed */\n",
+                lWidth, lHeight, lColors, (unsigned)lFlash, (unsigned)(3 * lPixelCount));
+        fprintf(lOutputFile, "static const ts_ws2812_sprite sSprite_%s = {\n", lName);
+        fprintf(lOutputFile, "    .mWidth   = %d,\n", lWidth);
+        fprintf(lOutputFile, "    .mHeight  = %d,\n", lHeight);
+        fprintf(lOutputFile, "    .mFormat  = WS2812_SPRITE_RLE%d,\n", lFormat);
+        fprintf(lOutputFile, "    .mPalette = sPalette_%s,\n", lName);
+        fprintf(lOutputFile, "    .mRows    = sRows_%s,\n", lName);
+        fprintf(lOutputFile, "    .mRuns    = sRuns_%s,\n", lName);
+        fprintf(lOutputFile, "};\n");
+
+        printf("%dx%d, %d colors, %u bytes instead of %u\n",
+               lWidth, lHeight, lColors, (unsigned)lFlash, (unsigned)(3 * lPixelCount));
+    }
+
+    fprintf(lOutputFile, "\n\n");
+    fprintf(lOutputFile, "const ts_ws2812_sprite * const gWs2812Sprites[] = {\n");
+
+    for(lCount = 2; lCount < argc; lCount++) {
+
+        sprite_name(lName, sizeof(lName), argv[lCount]);
+        fprintf(lOutputFile, "    &sSprite_%s,\n", lName);
+    }
+
+    fprintf(lOutputFile, "};\n\n");
+    fprintf(lOutputFile, "const size_t gWs2812SpriteCount = sizeof(gWs2812Sprites) / sizeof(gWs2812Sprites[0]);\n");
+    fprintf(lOutputFile, "\n");
+    fprintf(lOutputFile, "/* eof */\n");
+
+    fclose(lOutputFile);
+
+    return 0;
+}
@@ -0,0 +1,389 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "color.h"
+#include "color_hsv.h"
+#include "color_palette.h"
+#include "ws2812.h"
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_color_palette.h"
+#include "ws2812_anim_rainbow.h"
+
+/*  Measures strip against full panel rendering
+
+    Usage: strip_bench [<frames>]
+
+    The rainbow and palette animations render one color per column into
+    their strip. The panel path writes every color to all rows like
+    ws2812_setLED_Column() did before. Both are encoded like fillBuffer() in
+    ws2812.c, the strip with a column offset per row, and have to give the
+    same DMA bits. The strips have to hold what the animations rendered
+    before. The timing runs <frames> frames, the best of five runs, of the
+    render, the keyframe blend and the encoding of each path.
+*/
+
+
+/*! Rows and columns of the panel */
+#define ROWS                (WS2812_NR_ROWS)
+#define COLUMNS             (WS2812_NR_COLUMNS)
+
+/*! Leds of a panel */
+#define LEDS                (ROWS * COLUMNS)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+
+static tu_ws2812_anim sAnim;
+static tu_ws2812_anim_param sParam;
+
+static color sPanel[LEDS];
+static color sKeyframe[LEDS];
+static color sBlend[LEDS];
+
+static uint16_t sDma[24 * LEDS];
+static uint16_t sDmaPanel[24 * LEDS];
+
+/*! Leds not present, none on the bench, checked like ws2812_setLED() does */
+static uint8_t sSkipped[ROWS][COLUMNS];
+
+/*! Column offsets of the rows */
+static const int16_t sOffsets[ROWS] = { 0, 5, -3, 171, 400 };
+
+static int16_t sRowOffset[ROWS];
+
+
+static void start_rainbow(void) {
+
+    memset(&sAnim, 0, sizeof(sAnim));
+    memset(&sParam, 0, sizeof(sParam));
+
+    sParam.mRainbow.mSpeed      = 300;
+    sParam.mRainbow.mStep       = 380;
+    sParam.mRainbow.mSaturation = 240;
+    sParam.mRainbow.mValue      = 200;
+
+    sAnim.mBase.mRows    = ROWS;
+    sAnim.mBase.mColumns = COLUMNS;
+
+    ws2812_anim_rainbow_init(&sAnim, &sParam);
+}
+
+
+static void start_palette(void) {
+
+    memset(&sAnim, 0, sizeof(sAnim));
+    memset(&sParam, 0, sizeof(sParam));
+
+    sParam.mPalette.mPalette = COLOR_PALETTE_LAVA;
+
+    sAnim.mBase.mRows    = ROWS;
+    sAnim.mBase.mColumns = COLUMNS;
+
+    ws2812_anim_color_palette_init(&sAnim, &sParam);
+}
+
+
+/*! Set a led of the panel, what ws2812_setLED() does */
+static void set_led(size_t inRow, size_t inColumn, const color * inColor) {
+
+    if(sSkipped[inRow][inColumn]) {
+        return;
+    }
+
+    sPanel[inRow * COLUMNS + inColumn] = *inColor;
+}
+
+
+/*! Write the strip to every row, shifted by the row offsets */
+static void expand(const color * inStrip, const int16_t * inRowOffset) {
+
+    size_t lRow;
+    size_t lColumn;
+    int32_t lOffset;
+
+    for(lColumn = 0; lColumn < COLUMNS; lColumn++) {
+        for(lRow = 0; lRow < ROWS; lRow++) {
+
+            lOffset = ((int32_t)lColumn - inRowOffset[lRow]) % COLUMNS;
+            set_led(lRow, (size_t)((lOffset < 0)? lOffset + COLUMNS : lOffset), &inStrip[lColumn]);
+        }
+    }
+}
+
+
+/*! The loop of fillBuffer() in ws2812.c for all rows, each row read from inRows[row] */
+static void encode(uint16_t * outDma, const color * const * inRows, const int16_t * inRowOffset) {
+
+    uint16_t * lLedPtr = outDma;
+    uint32_t lGrb;
+    size_t lRow;
+    size_t lIndex;
+    size_t lColumn;
+    size_t lOffset;
+    size_t lBitIndex;
+    int32_t lNormalized;
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+
+        lNormalized = inRowOffset[lRow] % COLUMNS;
+        lOffset = (size_t)((lNormalized < 0)? lNormalized + COLUMNS : lNormalized);
+
+        for(lIndex = 0; lIndex < COLUMNS; lIndex++, lLedPtr += 24) {
+
+            lColumn = lIndex + lOffset;
+
+            /* a shifted row wraps around */
+            if(lColumn >= COLUMNS) {
+                lColumn -= COLUMNS;
+            }
+
+            lGrb = ws2812_color_grb(&inRows[lRow][lColumn]);
+
+            for(lBitIndex = 0; lBitIndex < 24; lBitIndex++, lGrb <<= 1) {
+                lLedPtr[lBitIndex] = (lGrb & 0x00800000u)? 58 : 29;
+            }
+        }
+    }
+}
+
+
+static void encode_strip(uint16_t * outDma) {
+
+    const color * lRows[ROWS];
+    size_t lRow;
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        lRows[lRow] = sAnim.mBase.mStrip;
+    }
+
+    encode(outDma, lRows, sRowOffset);
+}
+
+
+static void encode_panel(uint16_t * outDma) {
+
+    static const int16_t lNoOffsets[ROWS];
+    const color * lRows[ROWS];
+    size_t lRow;
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        lRows[lRow] = &sPanel[lRow * COLUMNS];
+    }
+
+    encode(outDma, lRows, lNoOffsets);
+}
+
+
+/*! Both paths have to send the same, with and without row offsets */
+static int check_paths(const char * inName, void (* infStart)(void)) {
+
+    int lOffsets;
+    int lFrame;
+
+    for(lOffsets = 0; lOffsets < 2; lOffsets++) {
+
+        memcpy(sRowOffset, sOffsets, sizeof(sRowOffset));
+
+        if(!lOffsets) {
+            memset(sRowOffset, 0, sizeof(sRowOffset));
+        }
+
+        infStart();
+
+        for(lFrame = 0; lFrame < 100; lFrame++) {
+
+            sAnim.mBase.mfUpdate(&sAnim);
+
+            encode_strip(sDma);
+            expand(sAnim.mBase.mStrip, sRowOffset);
+            encode_panel(sDmaPanel);
+
+            if(memcmp(sDma, sDmaPanel, sizeof(sDma)) != 0) {
+                printf("FAIL %s frame %d%s: the strip sends other bits than the panel\n", inName, lFrame, lOffsets ? " with offsets" : "");
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+/*! The strips have to hold what the animations rendered into the panel before */
+static int check_colors(void) {
+
+    color lColor;
+    size_t lColumn;
+    int lErrors = 0;
+
+    start_palette();
+    sAnim.mBase.mfUpdate(&sAnim);
+
+    for(lColumn = 0; lColumn < COLUMNS; lColumn++) {
+
+        color_palette_get_e(COLOR_PALETTE_LAVA, &lColor, (uint8_t)((lColumn * 512 + COLUMNS) / (2 * COLUMNS)));
+        lErrors += !color_equal(&lColor, &sAnim.mBase.mStrip[lColumn]);
+    }
+
+    start_rainbow();
+    sAnim.mBase.mfUpdate(&sAnim);
+
+    color_hsv_fill_rainbow(sBlend, COLUMNS, 300, 380, 240, 200);
+
+    for(lColumn = 0; lColumn < COLUMNS; lColumn++) {
+        lErrors += !color_equal(&sBlend[lColumn], &sAnim.mBase.mStrip[lColumn]);
+    }
+
+    if(lErrors) {
+        printf("FAIL %d strip colors differ\n", lErrors);
+    }
+
+    return lErrors ? 1 : 0;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+static void run_render_strip(uint32_t inFrame) {
+
+    (void)inFrame;
+
+    sAnim.mBase.mfUpdate(&sAnim);
+}
+
+
+static void run_render_panel(uint32_t inFrame) {
+
+    (void)inFrame;
+
+    sAnim.mBase.mfUpdate(&sAnim);
+    expand(sAnim.mBase.mStrip, sRowOffset);
+}
+
+
+static void run_blend_strip(uint32_t inFrame) {
+
+    color_blend(sBlend, sAnim.mBase.mStrip, sKeyframe, COLUMNS, (uint8_t)inFrame);
+}
+
+
+static void run_blend_panel(uint32_t inFrame) {
+
+    color_blend(sBlend, sPanel, sKeyframe, LEDS, (uint8_t)inFrame);
+}
+
+
+static void run_encode_strip(uint32_t inFrame) {
+
+    (void)inFrame;
+
+    encode_strip(sDma);
+}
+
+
+static void run_encode_panel(uint32_t inFrame) {
+
+    (void)inFrame;
+
+    encode_panel(sDma);
+}
+
+
+/*! Best time in ns per frame */
+static double measure(void (* infStart)(void), void (* infRun)(uint32_t), uint32_t inFrames) {
+
+    uint32_t lFrame;
+    uint32_t lSum = 0;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        infStart();
+        sAnim.mBase.mfUpdate(&sAnim);
+        expand(sAnim.mBase.mStrip, sRowOffset);
+
+        lStart = now();
+
+        for(lFrame = 0; lFrame < inFrames; lFrame++) {
+            infRun(lFrame);
+            lSum += sPanel[lFrame % LEDS].G + sBlend[lFrame % COLUMNS].G + sDma[lFrame % (24 * LEDS)];
+        }
+
+        lTime = (now() - lStart) / inFrames;
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+    }
+
+    /* the results have to be used */
+    if(lSum == 0xFFFFFFFF) {
+        printf("\n");
+    }
+
+    return lBest;
+}
+
+
+static void print_animation(const char * inName, void (* infStart)(void), uint32_t inFrames) {
+
+    printf("  %-8s render   %8.0f   %8.0f\n", inName, measure(infStart, run_render_strip, inFrames), measure(infStart, run_render_panel, inFrames));
+    printf("  %-8s blend    %8.0f   %8.0f\n", inName, measure(infStart, run_blend_strip, inFrames), measure(infStart, run_blend_panel, inFrames));
+}
+
+
+int main(int argc, char * argv[]) {
+
+    uint32_t lFrames = 50000;
+    size_t lCount;
+    int lErrors = 0;
+
+    if(argc > 1) {
+        lFrames = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lFrames == 0) {
+        printf("Usage: %s [<frames>]\n", argv[0]);
+        return -1;
+    }
+
+    for(lCount = 0; lCount < LEDS; lCount++) {
+        color_set_word(&sKeyframe[lCount], (uint32_t)(lCount * 0x00030507u));
+    }
+
+    lErrors += check_paths("rainbow", start_rainbow);
+    lErrors += check_paths("palette", start_palette);
+    lErrors += check_colors();
+
+    printf("strip and panel send the same bits    %s\n\n", lErrors ? "FAIL" : "ok");
+
+    memcpy(sRowOffset, sOffsets, sizeof(sRowOffset));
+
+    printf("ns per frame                strip      panel\n");
+    print_animation("rainbow", start_rainbow, lFrames);
+    print_animation("palette", start_palette, lFrames);
+    printf("  encode            %8.0f   %8.0f\n", measure(start_rainbow, run_encode_strip, lFrames), measure(start_rainbow, run_encode_panel, lFrames));
+    printf("  bytes             %8u   %8u\n", (unsigned)(COLUMNS * sizeof(color)), (unsigned)sizeof(sPanel));
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
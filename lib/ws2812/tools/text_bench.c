@@ -0,0 +1,340 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "color.h"
+#include "ws2812.h"
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_text.h"
+#include "ws2812_font.h"
+
+/*  Checks the scrolling text and measures it against a full redraw
+
+    Usage: text_bench [<frames>]
+
+    The text animation runs on a 5 x 172 panel for several speeds and is
+    compared after every frame with a panel drawn from scratch: the
+    columns of all characters, each followed by a blank one, and the gap
+    after the message, scrolled in from the right and found again for
+    every frame. Frames without a full column step have to leave the dirty
+    spans empty. A static text has to be drawn left aligned. The timing
+    runs <frames> frames, the best of five runs, of the animation and of
+    the full redraw per frame.
+*/
+
+
+/*! Rows and columns of the panel */
+#define ROWS                (WS2812_NR_ROWS)
+#define COLUMNS             (WS2812_NR_COLUMNS)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+/*! Frames of each comparison with the full redraw */
+#define CHECK_FRAMES        (3000)
+
+
+static tu_ws2812_anim sAnim;
+static tu_ws2812_anim_param sParam;
+
+static color sReference[ROWS * COLUMNS];
+
+/*! Latin-1 message, a glyph missing from the font included */
+static const char sMessage[] = "Hello World! 0123456789 \xC4\xD6\xDC\xE4\xF6\xFC\xDF \x7F ~";
+
+
+/*! Columns of the message and the gap, every character followed by a blank one */
+static size_t stream_length(const char * inText) {
+
+    size_t lColumns = WS2812_ANIM_TEXT_GAP;
+
+    for(; *inText != '\0'; inText++) {
+        lColumns += ws2812_font_width((uint8_t)*inText) + 1u;
+    }
+
+    return lColumns;
+}
+
+
+/*! Draw the whole panel after inScrolled columns, the text entered from the right
+
+    The character of the first column is searched from the start of the
+    message, the following columns are walked from there.
+*/
+static void full_redraw(const char * inText, size_t inLength, size_t inScrolled, const color * inForeground, const color * inBackground) {
+
+    const char * lChar = inText;
+    size_t lColumn;
+    size_t lRow;
+    size_t lGlyphColumn = 0;
+    uint8_t lWidth;
+    uint8_t lPixels;
+
+    if(inScrolled > COLUMNS) {
+
+        lGlyphColumn = (inScrolled - COLUMNS) % inLength;
+
+        for(; *lChar != '\0' && lGlyphColumn > ws2812_font_width((uint8_t)*lChar); lChar++) {
+            lGlyphColumn -= ws2812_font_width((uint8_t)*lChar) + 1u;
+        }
+    }
+
+    for(lColumn = 0; lColumn < COLUMNS; lColumn++) {
+
+        lPixels = 0;
+
+        if(inScrolled + lColumn >= COLUMNS) {
+
+            lWidth = (*lChar != '\0')? ws2812_font_width((uint8_t)*lChar) : WS2812_ANIM_TEXT_GAP;
+
+            if(*lChar != '\0' && lGlyphColumn < lWidth) {
+                lPixels = ws2812_font_column((uint8_t)*lChar, (uint8_t)lGlyphColumn);
+            }
+
+            /* the spacing column belongs to the character, the gap ends the message */
+            if(++lGlyphColumn > lWidth || (*lChar == '\0' && lGlyphColumn == lWidth)) {
+                lGlyphColumn = 0;
+                lChar = (*lChar != '\0')? lChar + 1 : inText;
+            }
+        }
+
+        for(lRow = 0; lRow < ROWS; lRow++) {
+            sReference[lRow * COLUMNS + lColumn] = (lPixels & (1u << lRow))? *inForeground : *inBackground;
+        }
+    }
+}
+
+
+static void start(uint16_t inStep) {
+
+    memset(&sAnim, 0, sizeof(sAnim));
+    memset(&sParam, 0, sizeof(sParam));
+
+    memcpy(sParam.mText.mText, sMessage, sizeof(sMessage));
+    color_set_word(&sParam.mText.mForeground, 0x00FFA020u);
+    color_set_word(&sParam.mText.mBackground, 0x00000408u);
+    sParam.mText.mStep = inStep;
+
+    sAnim.mBase.mRows    = ROWS;
+    sAnim.mBase.mColumns = COLUMNS;
+
+    ws2812_anim_text_init(&sAnim, &sParam);
+}
+
+
+static void update(void) {
+
+    size_t lRow;
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        ws2812_span_clear(&sAnim.mBase.mDirty[lRow]);
+    }
+
+    sAnim.mBase.mfUpdate(&sAnim);
+}
+
+
+static int check_scroll(uint16_t inStep) {
+
+    size_t lLength = stream_length(sMessage);
+    size_t lRow;
+    uint32_t lFrame;
+    uint32_t lPhase = 0;
+    size_t lScrolled = 0;
+    int lDirty;
+
+    start(inStep);
+
+    for(lFrame = 0; lFrame < CHECK_FRAMES; lFrame++) {
+
+        update();
+
+        /* the first frame draws the empty area */
+        if(lFrame > 0) {
+            lPhase += inStep;
+        }
+
+        for(lRow = 0, lDirty = 0; lRow < ROWS; lRow++) {
+            lDirty |= !ws2812_span_empty(&sAnim.mBase.mDirty[lRow]);
+        }
+
+        if(lFrame > 0 && lDirty != (lPhase >= 256)) {
+            printf("FAIL step 0x%04x frame %u: dirty spans with %u columns scrolled\n", inStep, (unsigned)lFrame, (unsigned)(lPhase >> 8));
+            return 1;
+        }
+
+        lScrolled += lPhase >> 8;
+        lPhase    &= 0xFF;
+
+        full_redraw(sMessage, lLength, lScrolled, &sParam.mText.mForeground, &sParam.mText.mBackground);
+
+        if(memcmp(sAnim.mBase.mPanel, sReference, sizeof(sReference)) != 0) {
+            printf("FAIL step 0x%04x frame %u: the panel differs from the full redraw\n", inStep, (unsigned)lFrame);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+static int check_static(void) {
+
+    size_t lLength = stream_length(sMessage);
+    size_t lRow;
+    size_t lColumn;
+    const color * lExpected;
+
+    start(0);
+    update();
+
+    /* left aligned is a scroll by the width of the panel */
+    full_redraw(sMessage, lLength, COLUMNS, &sParam.mText.mForeground, &sParam.mText.mBackground);
+
+    for(lRow = 0; lRow < ROWS; lRow++) {
+        for(lColumn = 0; lColumn < COLUMNS; lColumn++) {
+
+            /* the message is not repeated */
+            lExpected = (lColumn < lLength - WS2812_ANIM_TEXT_GAP)? &sReference[lRow * COLUMNS + lColumn] : &sParam.mText.mBackground;
+
+            if(!color_equal(&sAnim.mBase.mPanel[lRow * WS2812_NR_COLUMNS + lColumn], lExpected)) {
+                printf("FAIL static text at (%u, %u)\n", (unsigned)lColumn, (unsigned)lRow);
+                return 1;
+            }
+        }
+    }
+
+    if(!(sAnim.mBase.mFlags & WS2812_ANIM_FLAG_STATIC)) {
+        printf("FAIL static text is not flagged static\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+/*! Best time in ns per frame of the animation */
+static double measure_anim(uint16_t inStep, uint32_t inFrames) {
+
+    uint32_t lFrame;
+    uint32_t lSum = 0;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        start(inStep);
+
+        lStart = now();
+
+        for(lFrame = 0; lFrame < inFrames; lFrame++) {
+            update();
+            lSum += sAnim.mBase.mPanel[lFrame % (ROWS * COLUMNS)].G;
+        }
+
+        lTime = (now() - lStart) / inFrames;
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+    }
+
+    /* the panel has to be used */
+    if(lSum == 0xFFFFFFFF) {
+        printf("\n");
+    }
+
+    return lBest;
+}
+
+
+/*! Best time in ns per frame of drawing the whole panel every frame */
+static double measure_redraw(uint16_t inStep, uint32_t inFrames) {
+
+    size_t lLength = stream_length(sMessage);
+    uint32_t lFrame;
+    uint32_t lSum = 0;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        start(inStep);
+
+        lStart = now();
+
+        for(lFrame = 0; lFrame < inFrames; lFrame++) {
+            full_redraw(sMessage, lLength, ((size_t)lFrame * inStep) >> 8, &sParam.mText.mForeground, &sParam.mText.mBackground);
+            lSum += sReference[lFrame % (ROWS * COLUMNS)].G;
+        }
+
+        lTime = (now() - lStart) / inFrames;
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+    }
+
+    /* the panel has to be used */
+    if(lSum == 0xFFFFFFFF) {
+        printf("\n");
+    }
+
+    return lBest;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    static const uint16_t lSteps[] = { 0x0040, 0x0100, 0x0180, 0x0300 };
+    uint32_t lFrames = 100000;
+    size_t lCount;
+    int lErrors = 0;
+
+    if(argc > 1) {
+        lFrames = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lFrames == 0) {
+        printf("Usage: %s [<frames>]\n", argv[0]);
+        return -1;
+    }
+
+    for(lCount = 0; lCount < sizeof(lSteps) / sizeof(lSteps[0]); lCount++) {
+        lErrors += check_scroll(lSteps[lCount]);
+    }
+
+    lErrors += check_static();
+
+    printf("scroll and static text against a full redraw   %s\n\n", lErrors ? "FAIL" : "ok");
+
+    printf("Columns per frame   ns per frame   full redraw\n");
+
+    for(lCount = 0; lCount < sizeof(lSteps) / sizeof(lSteps[0]); lCount++) {
+        printf("  %6.2f         %10.0f    %10.0f\n", lSteps[lCount] / 256.0,
+               measure_anim(lSteps[lCount], lFrames), measure_redraw(lSteps[lCount], lFrames));
+    }
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
@@ -0,0 +1,395 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "color.h"
+#include "color_palette.h"
+#include "ws2812.h"
+#include "ws2812_anim.h"
+#include "ws2812_anim_obj.h"
+#include "ws2812_anim_p.h"
+#include "ws2812_anim_color_palette.h"
+#include "ws2812_anim_fire.h"
+#include "ws2812_anim_plasma.h"
+#include "ws2812_anim_clouds.h"
+#include "ws2812_anim_rainbow.h"
+#include "ws2812_transition_obj.h"
+
+/*  Measures the rates of the outgoing animation during a transition
+
+    Usage: transition_bench [<frames>]
+
+    Pairs of animations fade into each other over <frames> frames with the
+    outgoing animation live, at half and at a quarter of the rate and
+    frozen into a snapshot, the way the transition state of
+    ws2812_animation_main() does: the outgoing animation renders when the
+    frame counter is a multiple of its divider, the incoming one every
+    frame, then the fade transition blends the panels. A strip is written to
+    the panel only when it was rendered again. Keyframe interpolation is
+    off, the blend is 8 bit.
+
+    The outgoing animation has to render as often as its divider allows, a
+    snapshot never, and every fade has to finish exactly once. The timing
+    is the best of five runs in ns per frame.
+*/
+
+
+/*! Rows and columns of the panel */
+#define ROWS                (WS2812_NR_ROWS)
+#define COLUMNS             (WS2812_NR_COLUMNS)
+
+/*! Runs of which the fastest counts */
+#define RUNS                (5)
+
+/*! Number of outgoing modes */
+#define MODES               (4)
+
+
+/*! An animation with its parameters */
+typedef struct {
+
+    void (* mfInit)(tu_ws2812_anim * pThis, tu_ws2812_anim_param * pParam);
+
+    /*! Releases the buffers of the animation, NULL if there are none */
+    void (* mfClean)(tu_ws2812_anim * pThis);
+
+    void (* mfParam)(tu_ws2812_anim_param * outParam);
+
+} ts_transition_anim;
+
+
+/*! The outgoing and the incoming animation of a transition */
+typedef struct {
+
+    const char * mName;
+
+    const ts_transition_anim * mOutgoing;
+    const ts_transition_anim * mIncoming;
+
+} ts_transition_pair;
+
+
+static tu_ws2812_anim sAnim[2];
+static tu_ws2812_anim_param sParam;
+static tu_ws2812_trans sTransition;
+
+/*! The strip of the animation was rendered and is not on its panel yet */
+static int sOutputStrip[2];
+
+static uint32_t sRenders[2];
+
+static uint32_t sSeed = 1;
+static uint32_t sTransitionsDone;
+
+/*! Divider of the outgoing animation per mode, like sOutgoingDivider of ws2812_anim.c */
+static const uint32_t sOutgoingDivider[MODES] = {
+
+    [WS2812_TRANSITION_OUTGOING_LIVE]     = 1,
+    [WS2812_TRANSITION_OUTGOING_HALF]     = 2,
+    [WS2812_TRANSITION_OUTGOING_QUARTER]  = 4,
+    [WS2812_TRANSITION_OUTGOING_SNAPSHOT] = 0,
+};
+
+static const char * const sModeNames[MODES] = { "live", "half", "quarter", "snapshot" };
+
+
+uint32_t ws2812_animation_seed(void) {
+
+    sSeed = sSeed * 1664525u + 1013904223u;
+
+    return sSeed;
+}
+
+
+void ws2812_transition_done(void) {
+
+    sTransitionsDone++;
+}
+
+
+static void param_fire(tu_ws2812_anim_param * outParam) {
+
+    outParam->mFire.mPalette = COLOR_PALETTE_HEAT;
+}
+
+
+static void param_clouds(tu_ws2812_anim_param * outParam) {
+
+    outParam->mClouds.mPalette = COLOR_PALETTE_SKY;
+}
+
+
+static void param_plasma(tu_ws2812_anim_param * outParam) {
+
+    outParam->mPlasma.mPalette = COLOR_PALETTE_RAINBOW;
+}
+
+
+static void param_color_palette(tu_ws2812_anim_param * outParam) {
+
+    outParam->mPalette.mPalette = COLOR_PALETTE_LAVA;
+}
+
+
+static void param_rainbow(tu_ws2812_anim_param * outParam) {
+
+    outParam->mRainbow.mSpeed      = 300;
+    outParam->mRainbow.mStep       = 380;
+    outParam->mRainbow.mSaturation = 240;
+    outParam->mRainbow.mValue      = 200;
+}
+
+
+static const ts_transition_anim sFire    = { ws2812_anim_fire_init,          ws2812_anim_fire_clean, param_fire          };
+static const ts_transition_anim sClouds  = { ws2812_anim_clouds_init,        NULL,                   param_clouds        };
+static const ts_transition_anim sPlasma  = { ws2812_anim_plasma_init,        NULL,                   param_plasma        };
+static const ts_transition_anim sPalette = { ws2812_anim_color_palette_init, NULL,                   param_color_palette };
+static const ts_transition_anim sRainbow = { ws2812_anim_rainbow_init,       NULL,                   param_rainbow       };
+
+static const ts_transition_pair sPairs[] = {
+    { "fire -> fire",       &sFire,    &sFire    },
+    { "fire -> palette",    &sFire,    &sPalette },
+    { "clouds -> plasma",   &sClouds,  &sPlasma  },
+    { "rainbow -> fire",    &sRainbow, &sFire    },
+    { "palette -> rainbow", &sPalette, &sRainbow },
+};
+
+
+static void start(size_t inAnimation, const ts_transition_anim * inType) {
+
+    tu_ws2812_anim * lAnim = &sAnim[inAnimation];
+
+    memset(lAnim, 0, sizeof(*lAnim));
+    memset(&sParam, 0, sizeof(sParam));
+
+    inType->mfParam(&sParam);
+
+    /* what ws2812_animation_setup() sets before the init */
+    lAnim->mBase.mFlags           = WS2812_ANIM_FLAG_DIRTY;
+    lAnim->mBase.mKeyframeDivider = 1;
+    lAnim->mBase.mRows            = ROWS;
+    lAnim->mBase.mColumns         = COLUMNS;
+
+    inType->mfInit(lAnim, &sParam);
+
+    sOutputStrip[inAnimation] = 0;
+    sRenders[inAnimation]     = 0;
+}
+
+
+static void stop(size_t inAnimation, const ts_transition_anim * inType) {
+
+    if(inType->mfClean) {
+        inType->mfClean(&sAnim[inAnimation]);
+    }
+}
+
+
+/*! What ws2812_animation_update() does at full rate without modifiers */
+static void update(size_t inAnimation) {
+
+    tu_ws2812_anim * lAnim = &sAnim[inAnimation];
+
+    if((lAnim->mBase.mFlags & (WS2812_ANIM_FLAG_STATIC | WS2812_ANIM_FLAG_DIRTY)) != WS2812_ANIM_FLAG_STATIC) {
+
+        lAnim->mBase.mFlags &= ~WS2812_ANIM_FLAG_DIRTY;
+
+        lAnim->mBase.mfUpdate(lAnim);
+    }
+
+    sOutputStrip[inAnimation] = (lAnim->mBase.mFlags & WS2812_ANIM_FLAG_STRIP) != 0;
+    sRenders[inAnimation]++;
+}
+
+
+/*! The last output as panel, what ws2812_animation_get_panel() does */
+static color * get_panel(size_t inAnimation) {
+
+    tu_ws2812_anim * lAnim = &sAnim[inAnimation];
+    size_t lRow;
+
+    if(sOutputStrip[inAnimation]) {
+
+        for(lRow = 0; lRow < ROWS; lRow++) {
+            memcpy(&lAnim->mBase.mPanel[lRow * COLUMNS], lAnim->mBase.mStrip, COLUMNS * sizeof(color));
+        }
+
+        sOutputStrip[inAnimation] = 0;
+    }
+
+    return lAnim->mBase.mPanel;
+}
+
+
+/*! Start the pair, the outgoing animation ran before */
+static void start_pair(const ts_transition_pair * inPair) {
+
+    start(0, inPair->mOutgoing);
+    update(0);
+
+    start(1, inPair->mIncoming);
+
+    sRenders[0] = 0;
+}
+
+
+static void stop_pair(const ts_transition_pair * inPair) {
+
+    stop(0, inPair->mOutgoing);
+    stop(1, inPair->mIncoming);
+}
+
+
+/*! Fade over inFrames frames with the outgoing divider of inMode */
+static void transition(size_t inMode, uint32_t inFrames) {
+
+    tu_ws2812_trans_param lFade;
+    uint32_t lDivider = sOutgoingDivider[inMode];
+    uint32_t lFrame;
+
+    lFade.mFade.mDuration = inFrames;
+    ws2812_trans_fade_init(&sTransition, &lFade);
+
+    for(lFrame = 0; lFrame < inFrames; lFrame++) {
+
+        /* run animation 1 at the selected rate */
+        if(lDivider != 0 && (lFrame % lDivider) == 0) {
+            update(0);
+        }
+
+        /* run animation 2 */
+        update(1);
+
+        sTransition.mBase.mfUpdate(&sTransition, get_panel(0), get_panel(1));
+    }
+}
+
+
+/*! The outgoing animation renders as often as its divider allows */
+static int check_rates(uint32_t inFrames) {
+
+    uint32_t lExpected;
+    size_t lMode;
+    int lErrors = 0;
+
+    for(lMode = 0; lMode < MODES; lMode++) {
+
+        lExpected = sOutgoingDivider[lMode] ? (inFrames + sOutgoingDivider[lMode] - 1) / sOutgoingDivider[lMode] : 0;
+
+        sTransitionsDone = 0;
+
+        start_pair(&sPairs[0]);
+        transition(lMode, inFrames);
+        stop_pair(&sPairs[0]);
+
+        if(sRenders[0] != lExpected || sRenders[1] != inFrames) {
+            printf("FAIL %s: %u and %u renders instead of %u and %u\n", sModeNames[lMode], (unsigned)sRenders[0], (unsigned)sRenders[1],
+                   (unsigned)lExpected, (unsigned)inFrames);
+            lErrors++;
+        }
+
+        if(sTransitionsDone != 1) {
+            printf("FAIL %s: the fade finished %u times\n", sModeNames[lMode], (unsigned)sTransitionsDone);
+            lErrors++;
+        }
+    }
+
+    return lErrors;
+}
+
+
+/*! Time in ns */
+static double now(void) {
+
+    struct timespec lNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &lNow);
+
+    return lNow.tv_sec * 1e9 + lNow.tv_nsec;
+}
+
+
+/*! Best time in ns per transition frame */
+static double measure(const ts_transition_pair * inPair, size_t inMode, uint32_t inFrames) {
+
+    uint32_t lSum = 0;
+    int lRun;
+    double lStart;
+    double lTime;
+    double lBest = 0.0;
+
+    for(lRun = 0; lRun < RUNS; lRun++) {
+
+        start_pair(inPair);
+
+        lStart = now();
+
+        transition(inMode, inFrames);
+
+        lTime = (now() - lStart) / inFrames;
+
+        lSum += sTransition.mBase.mPanel[lRun].G;
+
+        stop_pair(inPair);
+
+        if(lRun == 0 || lTime < lBest) {
+            lBest = lTime;
+        }
+    }
+
+    /* the panel has to be used */
+    if(lSum == 0xFFFFFFFF) {
+        printf("\n");
+    }
+
+    return lBest;
+}
+
+
+int main(int argc, char * argv[]) {
+
+    uint32_t lFrames = 1000;
+    size_t lCount;
+    size_t lMode;
+    int lErrors = 0;
+
+    if(argc > 1) {
+        lFrames = (uint32_t)atoi(argv[1]);
+    }
+
+    if(argc > 2 || lFrames == 0) {
+        printf("Usage: %s [<frames>]\n", argv[0]);
+        return -1;
+    }
+
+    lErrors += check_rates(lFrames);
+
+    printf("outgoing renders per divider, fades finish   %s\n\n", lErrors ? "FAIL" : "ok");
+
+    printf("ns per frame over %u frames", (unsigned)lFrames);
+
+    for(lMode = 0; lMode < MODES; lMode++) {
+        printf(" %9s", sModeNames[lMode]);
+    }
+
+    printf("\n");
+
+    for(lCount = 0; lCount < sizeof(sPairs) / sizeof(sPairs[0]); lCount++) {
+
+        printf("  %-24s", sPairs[lCount].mName);
+
+        for(lMode = 0; lMode < MODES; lMode++) {
+            printf(" %9.0f", measure(&sPairs[lCount], lMode, lFrames));
+        }
+
+        printf("\n");
+    }
+
+    printf("\n%d errors\n", lErrors);
+
+    return lErrors ? 1 : 0;
+}
+
+/* eof */
@@ -4,6 +4,7 @@
 #include "stm32f4xx_rcc.h"
 #include "stm32f4xx_conf.h"
 #include "stm32f4xx_gpio.h"
+#include "stm32f4xx_rng.h"
 #include "misc.h"
 
 #include "init.h"
@@ -12,6 +13,7 @@
 #include "usbd_usr.h"
 #include "usbd_desc.h"
 #include "usbd_cdc_vcp.h"
+#include "usbd_composite.h"
 
 
 
@@ -42,7 +44,11 @@ void init(void) {
     USBD_Init(&USB_OTG_dev,
               USB_OTG_FS_CORE_ID,
               &USR_desc,
+#ifdef USB_AUDIO_SINK
+              &USBD_COMPOSITE_cb,
+#else
               &USBD_CDC_cb,
+#endif /* USB_AUDIO_SINK */
               &USR_cb);
 
     /*
@@ -52,6 +58,38 @@ void init(void) {
     setbuf(stdout, NULL);
 }
 
+/*! Number of polls of the hardware random generator before giving up */
+#define INIT_RNG_TRIES      (1000)
+
+
+/*! Get a seed from the hardware random generator
+
+    The generator needs the 48 MHz clock of the PLL, when it does not
+    deliver the SysTick counter is used instead.
+*/
+uint32_t init_random_seed(void) {
+
+    uint32_t lCount;
+    uint32_t lSeed = SysTick->VAL;
+
+    RCC_AHB2PeriphClockCmd(RCC_AHB2Periph_RNG, ENABLE);
+    RNG_Cmd(ENABLE);
+
+    for(lCount = 0; lCount < INIT_RNG_TRIES; lCount++) {
+
+        if(RNG_GetFlagStatus(RNG_FLAG_DRDY) == SET) {
+
+            lSeed = RNG_GetRandomNumber();
+            break;
+        }
+    }
+
+    RNG_Cmd(DISABLE);
+    RCC_AHB2PeriphClockCmd(RCC_AHB2Periph_RNG, DISABLE);
+
+    return lSeed;
+}
+
 void _init(void) {
 
 }
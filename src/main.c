@@ -67,6 +67,21 @@ static void ws2812_anim_task(void * inParameters) {
     }
 }
 
+#ifdef WS2812_ANIM_SEQ
+/*! Frame sequence task
+
+    This task reads frame sequences ahead for the ws2812 animation
+
+    \param[in]  inParameters    Unused
+*/
+static void ws2812_seq_task(void * inParameters) {
+
+    for(;;) {
+        ws2812_seq_loader_main();
+    }
+}
+#endif /* WS2812_ANIM_SEQ */
+
 /*! ESP8266 Receive Task
 
     This task handles asynchronous responses from the esp8266 module
@@ -187,7 +202,7 @@ static void init_task(void * inParameters) {
     ws2812_init();
 
     /* init animation */
-    ws2812_animation_init();
+    ws2812_animation_init(init_random_seed());
 
     if(!xTaskCreate(cpu_load_task, ( const char * )"cpu", configMINIMAL_STACK_SIZE, NULL, CPU_LOAD_TASK_PRIORITY, &xHandle)) {
         /* check how we can handle errors */
@@ -198,6 +213,13 @@ static void init_task(void * inParameters) {
         /* check how we can handle errors */
     }
 
+#ifdef WS2812_ANIM_SEQ
+    /* start frame sequence task */
+    if(!xTaskCreate(ws2812_seq_task, "ws2812_seq", configMINIMAL_STACK_SIZE * 4, NULL, WS2812_SEQ_TASK_PRIORITY, &xHandle)) {
+        /* check how we can handle errors */
+    }
+#endif /* WS2812_ANIM_SEQ */
+
     /* init esp8266 library */
     esp8266_init();
 
@@ -20,6 +20,7 @@
 
 #include "ws2812.h"
 #include "ws2812_anim.h"
+#include "ws2812_vm.h"        // for WS2812_VM_PROGRAM_MAX
 
 #include "esp8266.h"
 #include "esp8266_http_server.h"
@@ -69,18 +70,33 @@ void cpu_load_task(void * inParameters) {
     }
 }
 
+#ifdef WS2812_ANIM_SEQ
+/*! Frame sequence task, reads frames ahead for the animation */
+void ws2812_seq_task(void * inParameters) {
+
+    for(;;) {
+        ws2812_seq_loader_main();
+    }
+}
+#endif /* WS2812_ANIM_SEQ */
+
 void led_task(void * inParameters) {
 
     /* Initialize LEDs */
     ws2812_init();
 
     /* Initialize animation */
-    ws2812_animation_init();
+    ws2812_animation_init(init_random_seed());
+
+#ifdef WS2812_ANIM_SEQ
+    /* Frame sequences are loaded below the animation */
+    xTaskCreate(ws2812_seq_task, ( const char * )"seq", configMINIMAL_STACK_SIZE * 4, NULL, WS2812_SEQ_TASK_PRIORITY, NULL);
+#endif /* WS2812_ANIM_SEQ */
 
 #if 0
     /* power on test */
     {
-        static color_f lPanel[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
+        static color lPanel[WS2812_NR_ROWS * WS2812_NR_COLUMNS];
 
         size_t lColumnNum = ws2812_getLED_PanelNumberOfColumns();
         size_t lColumnCount;
@@ -854,13 +870,67 @@ typedef struct {
     /*! Palette */
     te_color_palettes   mPalette;
 
+    /*! Angle */
+    int16_t     mAngle;
+
+    /*! Rotation */
+    int16_t     mRotation;
+
+    /*! Transition time */
+    uint32_t    mTransitionTime;
+
+    /*! Outgoing animation during transition */
+    te_ws2812_transition_outgoing mOutgoing;
+
+    /*! Keyframe interpolation of the animation */
+    bool        mInterpolate;
+
+    /*! Working format of transitions and keyframes */
+    te_ws2812_precision mPrecision;
+
+    /*! Message of the text animation, UTF-8 */
+    char        mText[128];
+
+    /*! Scroll speed of the text animation in columns per second */
+    uint16_t    mTextSpeed;
+
+    /*! Program received for slot 0 */
+    uint8_t     mProgram[WS2812_VM_PROGRAM_MAX];
+
+    /*! Length of mProgram, 0 if none was received */
+    size_t      mProgramLen;
+
+    /*! Part of a GIF, hex encoded it fits the form */
+    uint8_t     mGif[2048];
+
+    /*! Length of mGif, 0 if none was received */
+    size_t      mGifLen;
+
+    /*! Offset of mGif in the GIF */
+    size_t      mGifOffset;
+
+    /*! Length of the whole GIF */
+    size_t      mGifTotal;
+
+#ifdef WS2812_ANIM_SEQ
+    /*! File of the frame sequence */
+    char        mSeqPath[WS2812_SEQ_PATH_MAX];
+#endif /* WS2812_ANIM_SEQ */
+
 } ts_myUserData;
 
 static ts_myUserData sUserData = {
     .mCounter = 0,
     .mSSIDLen = 0,
     .mPassLen = 0,
-    .mAnimationReceived = false
+    .mAnimationReceived = false,
+    .mTransitionTime = 1000,
+    .mOutgoing = WS2812_TRANSITION_OUTGOING_LIVE,
+    .mInterpolate = true,
+    .mPrecision = WS2812_PRECISION_8BIT,
+    .mColor = { .R = 255, .G = 255, .B = 255 },
+    .mText = "",
+    .mTextSpeed = 20
 };
 
 bool esp8266_http_test_web_content_get_status_ssid(void * inUserData, char * outBuffer, size_t inBufferSize, size_t * outBufferLen) {
@@ -934,6 +1004,17 @@ bool esp8266_http_test_web_content_get_cpu(void * inUserData, char * outBuffer,
     return true;
 }
 
+bool esp8266_http_test_web_content_get_anim_latency(void * inUserData, char * outBuffer, size_t inBufferSize, size_t * outBufferLen) {
+
+    ts_ws2812_anim_stats lStats;
+
+    ws2812_animation_get_stats(&lStats);
+
+    *outBufferLen = snprintf(outBuffer, inBufferSize, "%lu/%lu", lStats.mCommandLatency, lStats.mCommandLatencyMax);
+
+    return true;
+}
+
 bool esp8266_http_test_web_content_set_var(void * inUserData, const char * const inValue, size_t inValueLength) {
 
     char lBuffer[16];
@@ -1072,6 +1153,64 @@ bool esp8266_http_test_web_content_set_palette(void * inUserData, const char * c
     return true;
 }
 
+static bool esp8266_http_test_web_content_parse_int16(int16_t * outValue, const char * const inValue, size_t inValueLength) {
+
+    char lBuffer[8];
+    size_t lLen;
+
+    lLen = ((sizeof(lBuffer)-1) < inValueLength)? (sizeof(lBuffer)-1) : inValueLength;
+
+    memcpy(lBuffer, inValue, lLen);
+    lBuffer[lLen] = '\0';
+
+    *outValue = (int16_t)strtol(lBuffer, NULL, 10);
+
+    return true;
+}
+
+/*! Parse a decimal number up to inMax
+
+    \return false if the value is no number or above inMax, outValue is not changed then
+*/
+static bool esp8266_http_test_web_content_parse_uint32(uint32_t * outValue, uint32_t inMax, const char * const inValue, size_t inValueLength) {
+
+    char lBuffer[12];
+    char * lEnd;
+    unsigned long lValue;
+
+    /* longer values do not fit into 32 bit */
+    if(inValueLength == 0 || inValueLength > sizeof(lBuffer)-1) {
+        return false;
+    }
+
+    memcpy(lBuffer, inValue, inValueLength);
+    lBuffer[inValueLength] = '\0';
+
+    lValue = strtoul(lBuffer, &lEnd, 10);
+
+    if(*lEnd != '\0' || lBuffer[0] == '-' || lValue > inMax) {
+        return false;
+    }
+
+    *outValue = (uint32_t)lValue;
+
+    return true;
+}
+
+bool esp8266_http_test_web_content_set_angle(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+
+    return esp8266_http_test_web_content_parse_int16(&lUserData->mAngle, inValue, inValueLength);
+}
+
+bool esp8266_http_test_web_content_set_rotation(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+
+    return esp8266_http_test_web_content_parse_int16(&lUserData->mRotation, inValue, inValueLength);
+}
+
 bool esp8266_http_test_web_content_set_transition(void * inUserData, const char * const inValue, size_t inValueLength) {
 
     char lBuffer[12];
@@ -1089,6 +1228,8 @@ bool esp8266_http_test_web_content_set_transition(void * inUserData, const char
 
 bool esp8266_http_test_web_content_set_transition_time(void * inUserData, const char * const inValue, size_t inValueLength) {
 
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+
     char lBuffer[12];
     size_t lLen;
 
@@ -1099,6 +1240,188 @@ bool esp8266_http_test_web_content_set_transition_time(void * inUserData, const
 
     printf("%s(%d): %s\r\n", __func__, __LINE__, lBuffer);
 
+    lUserData->mTransitionTime = strtoul(lBuffer, NULL, 10);
+
+    return true;
+}
+
+bool esp8266_http_test_web_content_set_transition_outgoing(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+
+    if(inValueLength == 1 && inValue[0] >= '0' && inValue[0] <= '0' + WS2812_TRANSITION_OUTGOING_SNAPSHOT) {
+
+        lUserData->mOutgoing = (te_ws2812_transition_outgoing)(inValue[0] - '0');
+    }
+
+    return true;
+}
+
+bool esp8266_http_test_web_content_set_interpolation(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+
+    if(inValueLength == 1 && (inValue[0] == '0' || inValue[0] == '1')) {
+
+        lUserData->mInterpolate = (inValue[0] == '1');
+    }
+
+    return true;
+}
+
+bool esp8266_http_test_web_content_set_precision(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+
+    if(inValueLength == 1 && inValue[0] >= '0' && inValue[0] <= '0' + WS2812_PRECISION_DITHER) {
+
+        lUserData->mPrecision = (te_ws2812_precision)(inValue[0] - '0');
+    }
+
+    return true;
+}
+
+static size_t esp8266_http_test_web_content_parse_hex(uint8_t * outData, size_t inSize, const char * const inValue, size_t inValueLength) {
+
+    size_t lCount;
+    char lHex[3] = { '\0', '\0', '\0' };
+    char * lEnd;
+
+    if(inValueLength % 2 || inValueLength / 2 > inSize) {
+        return 0;
+    }
+
+    for(lCount = 0; lCount < inValueLength / 2; lCount++) {
+
+        lHex[0] = inValue[2 * lCount];
+        lHex[1] = inValue[2 * lCount + 1];
+
+        outData[lCount] = (uint8_t)strtoul(lHex, &lEnd, 16);
+
+        if(lEnd != &lHex[2]) {
+            return 0;
+        }
+    }
+
+    return inValueLength / 2;
+}
+
+bool esp8266_http_test_web_content_set_program(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+
+    lUserData->mProgramLen = esp8266_http_test_web_content_parse_hex(lUserData->mProgram, sizeof(lUserData->mProgram), inValue, inValueLength);
+
+    return true;
+}
+
+bool esp8266_http_test_web_content_set_gif(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+
+    lUserData->mGifLen = esp8266_http_test_web_content_parse_hex(lUserData->mGif, sizeof(lUserData->mGif), inValue, inValueLength);
+
+    return true;
+}
+
+bool esp8266_http_test_web_content_set_gif_offset(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+    uint32_t lOffset;
+
+    if(!esp8266_http_test_web_content_parse_uint32(&lOffset, WS2812_GIF_STORE_MAX, inValue, inValueLength)) {
+
+        printf("%s(%d): Invalid GIF offset\r\n", __FILE__, __LINE__);
+
+        /* ws2812_gif_store() refuses the part then */
+        lUserData->mGifOffset = WS2812_GIF_STORE_MAX + 1;
+        return false;
+    }
+
+    lUserData->mGifOffset = lOffset;
+
+    return true;
+}
+
+bool esp8266_http_test_web_content_set_gif_total(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+    uint32_t lTotal;
+
+    if(!esp8266_http_test_web_content_parse_uint32(&lTotal, WS2812_GIF_STORE_MAX, inValue, inValueLength)) {
+
+        printf("%s(%d): Invalid GIF length\r\n", __FILE__, __LINE__);
+
+        /* ws2812_gif_store() refuses the part then */
+        lUserData->mGifTotal = WS2812_GIF_STORE_MAX + 1;
+        return false;
+    }
+
+    lUserData->mGifTotal = lTotal;
+
+    return true;
+}
+
+#ifdef WS2812_ANIM_SEQ
+bool esp8266_http_test_web_content_set_seq_path(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+    size_t lLen;
+
+    lLen = ((sizeof(lUserData->mSeqPath)-1) < inValueLength)? (sizeof(lUserData->mSeqPath)-1) : inValueLength;
+
+    memcpy(lUserData->mSeqPath, inValue, lLen);
+    lUserData->mSeqPath[lLen] = '\0';
+
+    return true;
+}
+#endif /* WS2812_ANIM_SEQ */
+
+bool esp8266_http_test_web_content_set_text(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+    size_t lLen;
+
+    lLen = ((sizeof(lUserData->mText)-1) < inValueLength)? (sizeof(lUserData->mText)-1) : inValueLength;
+
+    memcpy(lUserData->mText, inValue, lLen);
+    lUserData->mText[lLen] = '\0';
+
+    return true;
+}
+
+bool esp8266_http_test_web_content_set_text_speed(void * inUserData, const char * const inValue, size_t inValueLength) {
+
+    ts_myUserData * lUserData = (ts_myUserData*)inUserData;
+    int16_t lSpeed;
+
+    esp8266_http_test_web_content_parse_int16(&lSpeed, inValue, inValueLength);
+
+    lUserData->mTextSpeed = (lSpeed > 0)? (uint16_t)lSpeed : 0;
+
+    return true;
+}
+
+bool esp8266_http_test_web_content_get_anim_cycles(void * inUserData, char * outBuffer, size_t inBufferSize, size_t * outBufferLen) {
+
+    ts_ws2812_anim_stats lStats;
+
+    ws2812_animation_get_stats(&lStats);
+
+    *outBufferLen = snprintf(outBuffer, inBufferSize, "%lu/%lu/%lu/%lu/%ld/%lu", lStats.mFrameCycles, lStats.mTransitionFrameCycles, lStats.mMorphFrameCycles, lStats.mKeyframeCycles,
+                             lStats.mBlitCyclesSaved, lStats.mAudioCycles);
+
+    return true;
+}
+
+bool esp8266_http_test_web_content_get_anim_leds(void * inUserData, char * outBuffer, size_t inBufferSize, size_t * outBufferLen) {
+
+    ts_ws2812_anim_stats lStats;
+
+    ws2812_animation_get_stats(&lStats);
+
+    *outBufferLen = snprintf(outBuffer, inBufferSize, "%lu/%lu", lStats.mDirtyLeds, lStats.mSentLeds);
+
     return true;
 }
 
@@ -1111,6 +1434,33 @@ void esp8266_http_test_web_content_start_parse(void * inUserData) {
     xSemaphoreTakeRecursive(lUserData->mMutex, portMAX_DELAY);
 }
 
+/*! Animation type of an animation form index, see the switch in esp8266_http_test_web_content_done_parse()
+
+    \return WS2812_ANIMATION_COUNT for unknown indices
+*/
+static te_ws2812_animations esp8266_http_test_web_content_animation(size_t inIndex) {
+
+    if(inIndex <= 7) {
+        /* constant color to rainbow are in enum order */
+        return (te_ws2812_animations)inIndex;
+    } else if(inIndex <= 11) {
+        return WS2812_ANIMATION_PARTICLES;
+    } else if(inIndex <= 15) {
+        return WS2812_ANIMATION_CELLS;
+    } else if(inIndex == 16) {
+        return WS2812_ANIMATION_PROGRAM;
+    } else if(inIndex <= 18) {
+        return WS2812_ANIMATION_GIF;
+    } else if(inIndex == 19) {
+        return WS2812_ANIMATION_SEQ;
+    } else if(inIndex <= 22) {
+        return WS2812_ANIMATION_AUDIO;
+    }
+
+    return WS2812_ANIMATION_COUNT;
+}
+
+
 void esp8266_http_test_web_content_done_parse(void * inUserData) {
 
     ts_myUserData * lUserData = (ts_myUserData*)inUserData;
@@ -1142,16 +1492,48 @@ void esp8266_http_test_web_content_done_parse(void * inUserData) {
         lUserData->mPassLen = 0;
     }
 
+    /* program upload */
+    if(lUserData->mProgramLen) {
+
+        if(ws2812_program_store(0, lUserData->mProgram, lUserData->mProgramLen)) {
+            printf("%s(%d): Program stored (%u bytes)\r\n", __FILE__, __LINE__, (unsigned)lUserData->mProgramLen);
+        } else {
+            printf("%s(%d): Invalid program\r\n", __FILE__, __LINE__);
+        }
+
+        lUserData->mProgramLen = 0;
+    }
+
+    /* GIF upload, one part per form */
+    if(lUserData->mGifLen) {
+
+        if(ws2812_gif_store(lUserData->mGifOffset, lUserData->mGif, lUserData->mGifLen, lUserData->mGifTotal)) {
+            printf("%s(%d): GIF part stored (%u of %u bytes)\r\n", __FILE__, __LINE__,
+                   (unsigned)(lUserData->mGifOffset + lUserData->mGifLen), (unsigned)lUserData->mGifTotal);
+        } else {
+            printf("%s(%d): Invalid GIF part\r\n", __FILE__, __LINE__);
+        }
+
+        lUserData->mGifLen = 0;
+    }
+
     /* animation form */
     if(lUserData->mAnimationReceived) {
 
+        ws2812_anim_transition(lUserData->mTransitionTime, lUserData->mOutgoing);
+        ws2812_anim_interpolation(esp8266_http_test_web_content_animation(lUserData->mAnimation), lUserData->mInterpolate);
+        ws2812_anim_precision(lUserData->mPrecision);
+
         switch(lUserData->mAnimation) {
             case 0:     /* constant color */
                 printf("%s(%d): Animation constant color\r\n", __FILE__, __LINE__);
                 ws2812_anim_const_color(lUserData->mColor.R, lUserData->mColor.G, lUserData->mColor.B);
                 break;
             case 1:     /* gradient */
-                printf("%s(%d): Animation gradient\r\n", __FILE__, __LINE__);
+                printf("%s(%d): Animation gradient (%d, %d)\r\n", __FILE__, __LINE__, lUserData->mAngle, lUserData->mRotation);
+                ws2812_anim_gradient(lUserData->mColor.R,  lUserData->mColor.G,  lUserData->mColor.B,
+                                     lUserData->mColor1.R, lUserData->mColor1.G, lUserData->mColor1.B,
+                                     lUserData->mAngle, lUserData->mRotation);
                 break;
             case 2:     /* palette */
                 printf("%s(%d): Animation palette (%d)\r\n", __FILE__, __LINE__, lUserData->mPalette);
@@ -1161,6 +1543,60 @@ void esp8266_http_test_web_content_done_parse(void * inUserData) {
                 printf("%s(%d): Animation fire (%d)\r\n", __FILE__, __LINE__, lUserData->mPalette);
                 ws2812_anim_fire(lUserData->mPalette);
                 break;
+            case 4:     /* text */
+                printf("%s(%d): Animation text \"%s\" (%u)\r\n", __FILE__, __LINE__, lUserData->mText, lUserData->mTextSpeed);
+                ws2812_anim_text(lUserData->mText,
+                                 lUserData->mColor.R,  lUserData->mColor.G,  lUserData->mColor.B,
+                                 lUserData->mColor1.R, lUserData->mColor1.G, lUserData->mColor1.B,
+                                 lUserData->mTextSpeed);
+                break;
+            case 5:     /* plasma */
+                printf("%s(%d): Animation plasma (%d)\r\n", __FILE__, __LINE__, lUserData->mPalette);
+                ws2812_anim_plasma(lUserData->mPalette);
+                break;
+            case 6:     /* clouds */
+                printf("%s(%d): Animation clouds (%d)\r\n", __FILE__, __LINE__, lUserData->mPalette);
+                ws2812_anim_clouds(lUserData->mPalette);
+                break;
+            case 7:     /* rainbow */
+                printf("%s(%d): Animation rainbow (%d)\r\n", __FILE__, __LINE__, lUserData->mRotation);
+                ws2812_anim_rainbow(lUserData->mRotation, WS2812_NR_COLUMNS, 255, 255);
+                break;
+            case 8:     /* fireworks */
+            case 9:     /* sparks */
+            case 10:    /* rain */
+            case 11:    /* confetti */
+                printf("%s(%d): Animation particles (%d, %d)\r\n", __FILE__, __LINE__, (int)(lUserData->mAnimation - 8), lUserData->mPalette);
+                ws2812_anim_particles((te_ws2812_particle_effects)(lUserData->mAnimation - 8), lUserData->mPalette);
+                break;
+            case 12:    /* life */
+            case 13:    /* sand */
+            case 14:    /* ripple */
+            case 15:    /* heat */
+                printf("%s(%d): Animation cells (%d, %d)\r\n", __FILE__, __LINE__, (int)(lUserData->mAnimation - 12), lUserData->mPalette);
+                ws2812_anim_cells((te_ws2812_cell_rules)(lUserData->mAnimation - 12), lUserData->mPalette);
+                break;
+            case 16:    /* program */
+                printf("%s(%d): Animation program (%d)\r\n", __FILE__, __LINE__, lUserData->mPalette);
+                ws2812_anim_program(0, lUserData->mPalette);
+                break;
+            case 17:    /* gif scaled */
+            case 18:    /* gif cropped */
+                printf("%s(%d): Animation gif (%d)\r\n", __FILE__, __LINE__, (int)(lUserData->mAnimation - 17));
+                ws2812_anim_gif((te_ws2812_gif_fit)(lUserData->mAnimation - 17));
+                break;
+#ifdef WS2812_ANIM_SEQ
+            case 19:    /* frame sequence */
+                printf("%s(%d): Animation sequence (%s)\r\n", __FILE__, __LINE__, lUserData->mSeqPath);
+                ws2812_anim_seq(lUserData->mSeqPath);
+                break;
+#endif /* WS2812_ANIM_SEQ */
+            case 20:    /* spectrum */
+            case 21:    /* vu meter */
+            case 22:    /* beat pulse */
+                printf("%s(%d): Animation audio (%d, %d)\r\n", __FILE__, __LINE__, (int)(lUserData->mAnimation - 20), lUserData->mPalette);
+                ws2812_anim_audio((te_ws2812_audio_view)(lUserData->mAnimation - 20), lUserData->mPalette);
+                break;
             default:    /* unkonwn animation */
                 printf("%s(%d): Unknown animation\r\n", __FILE__, __LINE__);
                 break;
@@ -1168,6 +1604,7 @@ void esp8266_http_test_web_content_done_parse(void * inUserData) {
 
         /* clear animation received */
         lUserData->mAnimationReceived = false;
+        lUserData->mRotation = 0;
     }
 
     xSemaphoreGiveRecursive(lUserData->mMutex);
@@ -1175,7 +1612,11 @@ void esp8266_http_test_web_content_done_parse(void * inUserData) {
 
 const ts_web_content_handlers g_WebContentHandler = {
 
-    .mHandlerCount = 13,
+#ifdef WS2812_ANIM_SEQ
+    .mHandlerCount = 28,
+#else
+    .mHandlerCount = 27,
+#endif /* WS2812_ANIM_SEQ */
     .mParsingStart = esp8266_http_test_web_content_start_parse,
     .mParsingDone  = esp8266_http_test_web_content_done_parse,
     .mUserData = (void*)&sUserData,
@@ -1244,7 +1685,84 @@ const ts_web_content_handlers g_WebContentHandler = {
             .mToken = "anpal",
             .mGet = NULL,
             .mSet = esp8266_http_test_web_content_set_palette,
-        }
+        },
+        {   /* 13 */
+            .mToken = "anlat",
+            .mGet = esp8266_http_test_web_content_get_anim_latency,
+            .mSet = NULL,
+        },
+        {   /* 14 */
+            .mToken = "angle",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_angle,
+        },
+        {   /* 15 */
+            .mToken = "anrot",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_rotation,
+        },
+        {   /* 16 */
+            .mToken = "trout",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_transition_outgoing,
+        },
+        {   /* 17 */
+            .mToken = "ancyc",
+            .mGet = esp8266_http_test_web_content_get_anim_cycles,
+            .mSet = NULL,
+        },
+        {   /* 18 */
+            .mToken = "anipol",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_interpolation,
+        },
+        {   /* 19 */
+            .mToken = "anled",
+            .mGet = esp8266_http_test_web_content_get_anim_leds,
+            .mSet = NULL,
+        },
+        {   /* 20 */
+            .mToken = "anres1",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_text,
+        },
+        {   /* 21 */
+            .mToken = "anspd",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_text_speed,
+        },
+        {   /* 22 */
+            .mToken = "anprec",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_precision,
+        },
+        {   /* 23 */
+            .mToken = "anprog",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_program,
+        },
+        {   /* 24 */
+            .mToken = "angiflen",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_gif_total,
+        },
+        {   /* 25 */
+            .mToken = "angifofs",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_gif_offset,
+        },
+        {   /* 26 */
+            .mToken = "angif",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_gif,
+        },
+#ifdef WS2812_ANIM_SEQ
+        {   /* 27 */
+            .mToken = "anseq",
+            .mGet = NULL,
+            .mSet = esp8266_http_test_web_content_set_seq_path,
+        },
+#endif /* WS2812_ANIM_SEQ */
     }
 };
 
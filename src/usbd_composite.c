@@ -0,0 +1,340 @@
+#ifdef USB_AUDIO_SINK
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "usbd_composite.h"
+#include "usbd_cdc_core.h"
+#include "usbd_audio_core.h"
+#include "usbd_audio_out_if.h"
+
+#include "ws2812_anim.h"
+
+
+/*! Descriptor type of an interface association */
+#define USBD_COMPOSITE_IAD_TYPE         (0x0B)
+
+/*! Length of an interface association descriptor */
+#define USBD_COMPOSITE_IAD_SIZE         (8)
+
+/*! Length of a configuration descriptor header */
+#define USBD_COMPOSITE_HEADER_SIZE      (9)
+
+/*! Interfaces of the CDC function, the audio interfaces follow */
+#define USBD_COMPOSITE_CDC_INTERFACES   (2)
+
+/*! Interfaces of the audio function */
+#define USBD_COMPOSITE_AUDIO_INTERFACES (2)
+
+/*! Length of the combined configuration descriptor */
+#define USBD_COMPOSITE_CONFIG_SIZE      (USBD_COMPOSITE_HEADER_SIZE + \
+                                         USBD_COMPOSITE_IAD_SIZE + USB_CDC_CONFIG_DESC_SIZ - USBD_COMPOSITE_HEADER_SIZE + \
+                                         USBD_COMPOSITE_IAD_SIZE + AUDIO_CONFIG_DESC_SIZE - USBD_COMPOSITE_HEADER_SIZE)
+
+
+/*! Packet buffer the audio class prepared the OUT endpoint with, usbd_audio_core.c */
+extern uint8_t * IsocOutWrPtr;
+
+
+/*! Combined configuration descriptor, built on the first request */
+__ALIGN_BEGIN static uint8_t sConfigDesc[USBD_COMPOSITE_CONFIG_SIZE] __ALIGN_END;
+
+/*! Length of sConfigDesc once built */
+static uint16_t sConfigLength;
+
+/*! State reported to the audio class */
+static uint8_t sAudioState = AUDIO_STATE_INACTIVE;
+
+
+/*! Append an interface association descriptor
+
+    \return the length of the descriptor
+*/
+static uint16_t usbd_composite_iad(uint8_t * outDesc, uint8_t inFirst, uint8_t inCount,
+                                   uint8_t inClass, uint8_t inSubClass, uint8_t inProtocol) {
+
+    outDesc[0] = USBD_COMPOSITE_IAD_SIZE;
+    outDesc[1] = USBD_COMPOSITE_IAD_TYPE;
+    outDesc[2] = inFirst;
+    outDesc[3] = inCount;
+    outDesc[4] = inClass;
+    outDesc[5] = inSubClass;
+    outDesc[6] = inProtocol;
+    outDesc[7] = 0;
+
+    return USBD_COMPOSITE_IAD_SIZE;
+}
+
+
+/*! Append the descriptors of a class without its configuration header
+
+    The interface numbers are moved by inOffset, and so are the interfaces
+    an audio control header refers to.
+
+    \return the length of the descriptors
+*/
+static uint16_t usbd_composite_append(uint8_t * outDesc, const uint8_t * inConfig, uint16_t inLength, uint8_t inOffset) {
+
+    uint16_t lIndex;
+    uint16_t lCount;
+    uint8_t lSubClass = 0;
+
+    for(lIndex = 0; lIndex < inLength - USBD_COMPOSITE_HEADER_SIZE; lIndex++) {
+        outDesc[lIndex] = inConfig[USBD_COMPOSITE_HEADER_SIZE + lIndex];
+    }
+
+    for(lIndex = 0; lIndex + 1 < inLength - USBD_COMPOSITE_HEADER_SIZE && outDesc[lIndex] > 0; lIndex += outDesc[lIndex]) {
+
+        if(outDesc[lIndex + 1] == USB_INTERFACE_DESCRIPTOR_TYPE) {
+
+            outDesc[lIndex + 2] += inOffset;
+            lSubClass = outDesc[lIndex + 6];
+
+        } else if(outDesc[lIndex + 1] == AUDIO_INTERFACE_DESCRIPTOR_TYPE &&
+                  outDesc[lIndex + 2] == AUDIO_CONTROL_HEADER &&
+                  lSubClass == AUDIO_SUBCLASS_AUDIOCONTROL) {
+
+            /* baInterfaceNr of every streaming interface */
+            for(lCount = 8; lCount < outDesc[lIndex]; lCount++) {
+                outDesc[lIndex + lCount] += inOffset;
+            }
+        }
+    }
+
+    return inLength - USBD_COMPOSITE_HEADER_SIZE;
+}
+
+
+static uint8_t * usbd_composite_GetCfgDesc(uint8_t speed, uint16_t * length) {
+
+    uint8_t * lCdc;
+    uint8_t * lAudio;
+    uint16_t lCdcLength;
+    uint16_t lAudioLength;
+    uint16_t lLength;
+
+    if(sConfigLength == 0) {
+
+        lCdc   = USBD_CDC_cb.GetConfigDescriptor(speed, &lCdcLength);
+        lAudio = AUDIO_cb.GetConfigDescriptor(speed, &lAudioLength);
+
+        /* the header of the CDC function with all interfaces */
+        for(lLength = 0; lLength < USBD_COMPOSITE_HEADER_SIZE; lLength++) {
+            sConfigDesc[lLength] = lCdc[lLength];
+        }
+        sConfigDesc[4] = USBD_COMPOSITE_CDC_INTERFACES + USBD_COMPOSITE_AUDIO_INTERFACES;
+
+        lLength += usbd_composite_iad(&sConfigDesc[lLength], 0, USBD_COMPOSITE_CDC_INTERFACES, 0x02, 0x02, 0x01);
+        lLength += usbd_composite_append(&sConfigDesc[lLength], lCdc, lCdcLength, 0);
+
+        lLength += usbd_composite_iad(&sConfigDesc[lLength], USBD_COMPOSITE_CDC_INTERFACES, USBD_COMPOSITE_AUDIO_INTERFACES,
+                                      USB_DEVICE_CLASS_AUDIO, AUDIO_SUBCLASS_AUDIOCONTROL, AUDIO_PROTOCOL_UNDEFINED);
+        lLength += usbd_composite_append(&sConfigDesc[lLength], lAudio, lAudioLength, USBD_COMPOSITE_CDC_INTERFACES);
+
+        sConfigDesc[2] = LOBYTE(lLength);
+        sConfigDesc[3] = HIBYTE(lLength);
+
+        sConfigLength = lLength;
+    }
+
+    *length = sConfigLength;
+
+    return sConfigDesc;
+}
+
+
+/*! Check if a request is for the audio function */
+static uint8_t usbd_composite_is_audio(USB_SETUP_REQ * req) {
+
+    switch(req->bmRequest & USB_REQ_RECIPIENT_MASK) {
+
+        case USB_REQ_RECIPIENT_INTERFACE:
+            return LOBYTE(req->wIndex) >= USBD_COMPOSITE_CDC_INTERFACES;
+
+        case USB_REQ_RECIPIENT_ENDPOINT:
+            return LOBYTE(req->wIndex) == AUDIO_OUT_EP;
+
+        default:
+            return 0;
+    }
+}
+
+
+static uint8_t usbd_composite_Init(void * pdev, uint8_t cfgidx) {
+
+    USBD_CDC_cb.Init(pdev, cfgidx);
+
+    return AUDIO_cb.Init(pdev, cfgidx);
+}
+
+
+static uint8_t usbd_composite_DeInit(void * pdev, uint8_t cfgidx) {
+
+    USBD_CDC_cb.DeInit(pdev, cfgidx);
+
+    return AUDIO_cb.DeInit(pdev, cfgidx);
+}
+
+
+static uint8_t usbd_composite_Setup(void * pdev, USB_SETUP_REQ * req) {
+
+    if(usbd_composite_is_audio(req)) {
+        return AUDIO_cb.Setup(pdev, req);
+    }
+
+    return USBD_CDC_cb.Setup(pdev, req);
+}
+
+
+static uint8_t usbd_composite_EP0_RxReady(void * pdev) {
+
+    /* both only act on the request they started */
+    USBD_CDC_cb.EP0_RxReady(pdev);
+
+    return AUDIO_cb.EP0_RxReady(pdev);
+}
+
+
+static uint8_t usbd_composite_DataIn(void * pdev, uint8_t epnum) {
+
+    return USBD_CDC_cb.DataIn(pdev, epnum);
+}
+
+
+static uint8_t usbd_composite_DataOut(void * pdev, uint8_t epnum) {
+
+    if(epnum == (AUDIO_OUT_EP & 0x7F)) {
+
+        /* the class only starts playing after 2 packets, the animation
+           gets every packet right away; 16 bit stereo */
+        ws2812_audio_feed((const int16_t*)IsocOutWrPtr,
+                          ((USB_OTG_CORE_HANDLE*)pdev)->dev.out_ep[epnum].xfer_count / 4, 2);
+
+        return AUDIO_cb.DataOut(pdev, epnum);
+    }
+
+    return USBD_CDC_cb.DataOut(pdev, epnum);
+}
+
+
+static uint8_t usbd_composite_SOF(void * pdev) {
+
+    USBD_CDC_cb.SOF(pdev);
+
+    return AUDIO_cb.SOF(pdev);
+}
+
+
+static uint8_t usbd_composite_IsoINIncomplete(void * pdev) {
+
+    return AUDIO_cb.IsoINIncomplete(pdev);
+}
+
+
+static uint8_t usbd_composite_IsoOUTIncomplete(void * pdev) {
+
+    return AUDIO_cb.IsoOUTIncomplete(pdev);
+}
+
+
+USBD_Class_cb_TypeDef USBD_COMPOSITE_cb = {
+    usbd_composite_Init,
+    usbd_composite_DeInit,
+    usbd_composite_Setup,
+    NULL,                           /* EP0_TxSent */
+    usbd_composite_EP0_RxReady,
+    usbd_composite_DataIn,
+    usbd_composite_DataOut,
+    usbd_composite_SOF,
+    usbd_composite_IsoINIncomplete,
+    usbd_composite_IsoOUTIncomplete,
+    usbd_composite_GetCfgDesc,
+#ifdef USE_USB_OTG_HS
+    usbd_composite_GetCfgDesc,
+#endif /* USE_USB_OTG_HS */
+};
+
+
+/* ------------------- audio output of the audio class -------------- */
+
+
+static uint8_t usbd_composite_audio_Init(uint32_t AudioFreq, uint32_t Volume, uint32_t options) {
+
+    sAudioState = AUDIO_STATE_ACTIVE;
+
+    return AUDIO_OK;
+}
+
+
+static uint8_t usbd_composite_audio_DeInit(uint32_t options) {
+
+    sAudioState = AUDIO_STATE_INACTIVE;
+
+    return AUDIO_OK;
+}
+
+
+static uint8_t usbd_composite_audio_AudioCmd(uint8_t * pbuf, uint32_t size, uint8_t cmd) {
+
+    /* the packets were fed on arrival already, see usbd_composite_DataOut() */
+    switch(cmd) {
+
+        case AUDIO_CMD_PLAY:
+            sAudioState = AUDIO_STATE_PLAYING;
+            break;
+
+        case AUDIO_CMD_PAUSE:
+            sAudioState = AUDIO_STATE_PAUSED;
+            break;
+
+        case AUDIO_CMD_STOP:
+            sAudioState = AUDIO_STATE_STOPPED;
+            break;
+
+        default:
+            return AUDIO_FAIL;
+    }
+
+    return AUDIO_OK;
+}
+
+
+static uint8_t usbd_composite_audio_VolumeCtl(uint8_t vol) {
+
+    return AUDIO_OK;
+}
+
+
+static uint8_t usbd_composite_audio_MuteCtl(uint8_t cmd) {
+
+    return AUDIO_OK;
+}
+
+
+static uint8_t usbd_composite_audio_PeriodicTC(uint8_t cmd) {
+
+    return AUDIO_OK;
+}
+
+
+static uint8_t usbd_composite_audio_GetState(void) {
+
+    return sAudioState;
+}
+
+
+/*! Audio output of the audio class, replaces usbd_audio_out_if.c of the codec boards */
+AUDIO_FOPS_TypeDef AUDIO_OUT_fops = {
+    usbd_composite_audio_Init,
+    usbd_composite_audio_DeInit,
+    usbd_composite_audio_AudioCmd,
+    usbd_composite_audio_VolumeCtl,
+    usbd_composite_audio_MuteCtl,
+    usbd_composite_audio_PeriodicTC,
+    usbd_composite_audio_GetState,
+};
+
+
+#endif /* USB_AUDIO_SINK */
+
+/* eof */
@@ -110,9 +110,15 @@ __ALIGN_BEGIN uint8_t USBD_DeviceDesc[USB_SIZ_DEVICE_DESC] __ALIGN_END =
     USB_DEVICE_DESCRIPTOR_TYPE, /*bDescriptorType*/
     0x00,                       /*bcdUSB */
     0x02,
+#ifdef USB_AUDIO_SINK
+    0xEF,                       /*bDeviceClass: miscellaneous, functions in interface associations*/
+    0x02,                       /*bDeviceSubClass: common class*/
+    0x01,                       /*bDeviceProtocol: interface association descriptors*/
+#else
     0x00,                       /*bDeviceClass*/
     0x00,                       /*bDeviceSubClass*/
     0x00,                       /*bDeviceProtocol*/
+#endif /* USB_AUDIO_SINK */
     USB_OTG_MAX_EP0_SIZE,      /*bMaxPacketSize*/
     LOBYTE(USBD_VID),           /*idVendor*/
     HIBYTE(USBD_VID),           /*idVendor*/